@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "AccountArchiveFolderTest.h"
+#import "AccountArchiveFolder.h"
+
+static NSString * const kAccountArchiveFolderTestAccountIdentifier = @"account-1";
+
+@interface AccountArchiveFolderTest ()
+@property (nonatomic, strong) NSString *folderPath;
+@property (nonatomic, strong) AccountArchiveFolder *archiveFolder;
+@end
+
+@implementation AccountArchiveFolderTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.folderPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    self.archiveFolder = [[AccountArchiveFolder alloc] initWithFolderPath:self.folderPath archiveDescription:@"tests"];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.folderPath error:nil];
+    [super tearDown];
+}
+
+- (void)waitForPendingWrites
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Written"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.5 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)testArchivesAreKeptPerAccount
+{
+    NSString *filePath = [self.archiveFolder filePathForAccountIdentifier:kAccountArchiveFolderTestAccountIdentifier archiveName:@"network/1"];
+    XCTAssertTrue([filePath hasPrefix:self.folderPath]);
+    XCTAssertEqualObjects(filePath.lastPathComponent, @"network%2F1.archive");
+    
+    [self.archiveFolder saveArchiveWithRootObject:@{@"version" : @1} toFilePath:filePath];
+    [self waitForPendingWrites];
+    
+    NSDictionary *archive = [NSKeyedUnarchiver unarchiveObjectWithData:[NSData dataWithContentsOfFile:filePath]];
+    XCTAssertEqualObjects(archive[@"version"], @1);
+}
+
+- (void)testSaveQueuedBeforeRemovalDoesNotRecreateTheAccountFolder
+{
+    NSString *filePath = [self.archiveFolder filePathForAccountIdentifier:kAccountArchiveFolderTestAccountIdentifier archiveName:@"repository"];
+    NSString *accountFolderPath = [filePath stringByDeletingLastPathComponent];
+    
+    [self.archiveFolder saveArchiveWithRootObject:@{@"version" : @1} toFilePath:filePath];
+    [self.archiveFolder removeArchivesForAccountIdentifier:kAccountArchiveFolderTestAccountIdentifier];
+    [self waitForPendingWrites];
+    
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:accountFolderPath]);
+}
+
+@end
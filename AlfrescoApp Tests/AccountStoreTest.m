@@ -0,0 +1,167 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "AccountStoreTest.h"
+#import "AccountStore.h"
+
+/**
+ * In-memory stand-in for the keychain, counting the reads and writes that reach it.
+ */
+@interface AccountStoreTestStorage : NSObject <AccountStoreStorage>
+@property (atomic, strong) NSData *data;
+@property (atomic, assign) NSUInteger numberOfReads;
+@property (atomic, assign) NSUInteger numberOfWrites;
+@end
+
+@implementation AccountStoreTestStorage
+
+- (NSData *)accountListDataWithError:(NSError *__autoreleasing *)error
+{
+    self.numberOfReads++;
+    return self.data;
+}
+
+- (BOOL)saveAccountListData:(NSData *)data error:(NSError *__autoreleasing *)error
+{
+    self.numberOfWrites++;
+    self.data = data;
+    return YES;
+}
+
+- (BOOL)deleteAccountListDataWithError:(NSError *__autoreleasing *)error
+{
+    self.numberOfWrites++;
+    self.data = nil;
+    return YES;
+}
+
+@end
+
+@interface AccountStoreTest ()
+@property (nonatomic, strong) AccountStoreTestStorage *storage;
+@property (nonatomic, strong) NSString *changeNotificationName;
+@end
+
+@implementation AccountStoreTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.storage = [AccountStoreTestStorage new];
+    self.storage.data = [NSKeyedArchiver archivedDataWithRootObject:@[@"account-1", @"account-2"]];
+    // Unique per test so stores from other tests don't see each other's writes
+    self.changeNotificationName = [NSString stringWithFormat:@"com.alfresco.test.accountstore.%@", [NSUUID UUID].UUIDString];
+}
+
+- (AccountStore *)createStore
+{
+    return [[AccountStore alloc] initWithStorage:self.storage changeNotificationName:self.changeNotificationName];
+}
+
+- (void)testAccountsAreDecodedOnce
+{
+    AccountStore *store = [self createStore];
+    
+    NSArray *expectedAccounts = @[@"account-1", @"account-2"];
+    XCTAssertEqualObjects([store accountsWithError:nil], expectedAccounts);
+    XCTAssertEqualObjects([store accountsWithError:nil], expectedAccounts);
+    XCTAssertEqual(self.storage.numberOfReads, 1);
+}
+
+- (void)testSavesAreCoalescedIntoOneWrite
+{
+    AccountStore *store = [self createStore];
+    store.writeCoalescingInterval = 60;
+    
+    for (NSUInteger index = 0; index < 10; index++)
+    {
+        [store saveAccounts:@[@"account-1", [NSString stringWithFormat:@"renamed-%lu", (unsigned long)index]]];
+    }
+    
+    NSArray *expectedAccounts = @[@"account-1", @"renamed-9"];
+    XCTAssertEqualObjects([store accountsWithError:nil], expectedAccounts);
+    XCTAssertEqual(self.storage.numberOfWrites, 0);
+    
+    XCTAssertTrue([store flushWithError:nil]);
+    XCTAssertEqual(self.storage.numberOfWrites, 1);
+    XCTAssertEqualObjects([NSKeyedUnarchiver unarchiveObjectWithData:self.storage.data], expectedAccounts);
+}
+
+- (void)testPendingSaveIsWrittenAfterCoalescingInterval
+{
+    AccountStore *store = [self createStore];
+    store.writeCoalescingInterval = 0.05;
+    [store saveAccounts:@[@"account-3"]];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Coalesced write"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.5 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertEqual(self.storage.numberOfWrites, 1);
+}
+
+- (void)testUnchangedListIsNotWritten
+{
+    AccountStore *store = [self createStore];
+    NSArray *accounts = [store accountsWithError:nil];
+    
+    [store saveAccounts:accounts];
+    [store flushWithError:nil];
+    
+    XCTAssertEqual(self.storage.numberOfWrites, 0);
+}
+
+- (void)testOtherStoreReloadsOnlyAfterAChange
+{
+    AccountStore *writingStore = [self createStore];
+    AccountStore *readingStore = [self createStore];
+    
+    [writingStore accountsWithError:nil];
+    [readingStore accountsWithError:nil];
+    [readingStore accountsWithError:nil];
+    XCTAssertEqual(self.storage.numberOfReads, 2);
+    
+    [writingStore saveAccounts:@[@"account-1"]];
+    [writingStore flushWithError:nil];
+    
+    NSArray *expectedAccounts = @[@"account-1"];
+    XCTAssertEqualObjects([readingStore accountsWithError:nil], expectedAccounts);
+    XCTAssertEqual(self.storage.numberOfReads, 3);
+    
+    // The writer's own change doesn't make it read the list back
+    XCTAssertEqualObjects([writingStore accountsWithError:nil], expectedAccounts);
+    XCTAssertEqual(self.storage.numberOfReads, 3);
+}
+
+- (void)testDeleteDropsPendingSave
+{
+    AccountStore *store = [self createStore];
+    store.writeCoalescingInterval = 60;
+    [store saveAccounts:@[@"account-3"]];
+    
+    XCTAssertTrue([store deleteAllAccountsWithError:nil]);
+    [store flushWithError:nil];
+    
+    XCTAssertNil(self.storage.data);
+    XCTAssertEqual([store accountsWithError:nil].count, 0);
+}
+
+@end
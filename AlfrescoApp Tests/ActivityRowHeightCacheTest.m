@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "ActivityRowHeightCacheTest.h"
+#import "ActivityRowHeightCache.h"
+#import "ActivityWrapper.h"
+#import "ActivityTableViewCell.h"
+
+static NSUInteger const kActivityRowHeightCacheTestActivityCount = 1000;
+static CGFloat const kActivityRowHeightCacheTestTableWidth = 320.0;
+
+@interface ActivityRowHeightCacheTest ()
+@property (nonatomic, strong) NSArray *activities;
+@end
+
+@implementation ActivityRowHeightCacheTest
+
+- (void)setUp
+{
+    [super setUp];
+    
+    NSArray *types = @[@"org.alfresco.documentlibrary.file-added", @"org.alfresco.documentlibrary.file-updated", @"org.alfresco.comments.comment-created", @"org.alfresco.site.user-joined"];
+    NSMutableArray *activities = [NSMutableArray arrayWithCapacity:kActivityRowHeightCacheTestActivityCount];
+    for (NSUInteger index = 0; index < kActivityRowHeightCacheTestActivityCount; index++)
+    {
+        // Titles of varying length so rows wrap onto different numbers of lines
+        NSString *title = [@"" stringByPaddingToLength:(index % 7) * 15 + 5 withString:@"Quarterly report " startingAtIndex:0];
+        NSDictionary *summary = @{@"title" : title, @"firstName" : @"Jane", @"lastName" : [NSString stringWithFormat:@"Doe %lu", (unsigned long)index], @"role" : @"SiteCollaborator"};
+        // Activity stream entries as the repository returns them
+        NSDictionary *properties = @{@"id" : [NSString stringWithFormat:@"%lu", (unsigned long)index],
+                                     @"activityType" : types[index % types.count],
+                                     @"postUserId" : @"jdoe",
+                                     @"postDate" : @"2020-01-01T12:00:00.000Z",
+                                     @"siteNetwork" : @"marketing",
+                                     @"activitySummary" : summary};
+        AlfrescoActivityEntry *entry = [[AlfrescoActivityEntry alloc] initWithProperties:properties];
+        [activities addObject:[[ActivityWrapper alloc] initWithActivityEntry:entry]];
+    }
+    self.activities = activities;
+}
+
+- (ActivityRowHeightCache *)createCache
+{
+    ActivityTableViewCell *prototypeCell = [[UINib nibWithNibName:@"ActivityTableViewCell" bundle:nil] instantiateWithOwner:nil options:nil].firstObject;
+    return [[ActivityRowHeightCache alloc] initWithPrototypeCell:prototypeCell];
+}
+
+/*
+ * The height a fresh cell, configured as the activities list configures it, reaches with Auto Layout.
+ */
+- (CGFloat)autoLayoutHeightOfActivity:(ActivityWrapper *)activity tableWidth:(CGFloat)tableWidth
+{
+    ActivityTableViewCell *cell = [[UINib nibWithNibName:@"ActivityTableViewCell" bundle:nil] instantiateWithOwner:nil options:nil].firstObject;
+    cell.accessoryType = activity.showsNodeDetails ? UITableViewCellAccessoryDisclosureIndicator : UITableViewCellAccessoryNone;
+    cell.detailsLabel.attributedText = activity.attributedDetailString;
+    cell.dateLabel.text = activity.dateString;
+    cell.bounds = CGRectMake(0, 0, tableWidth, CGRectGetHeight(cell.bounds));
+    [cell setNeedsLayout];
+    [cell layoutIfNeeded];
+    
+    return [cell.contentView systemLayoutSizeFittingSize:CGSizeMake(CGRectGetWidth(cell.contentView.bounds), 0)
+                           withHorizontalFittingPriority:UILayoutPriorityRequired
+                                 verticalFittingPriority:UILayoutPriorityFittingSizeLevel].height;
+}
+
+- (void)testTextKitHeightsMatchAutoLayout
+{
+    ActivityRowHeightCache *cache = [self createCache];
+    
+    // Every activity type, with titles from a few words to several lines, at a phone and a tablet width
+    for (NSNumber *index in @[@0, @5, @10, @15, @20, @27])
+    {
+        ActivityWrapper *activity = self.activities[index.unsignedIntegerValue];
+        for (NSNumber *tableWidth in @[@(kActivityRowHeightCacheTestTableWidth), @(kActivityRowHeightCacheTestTableWidth * 2)])
+        {
+            CGFloat width = tableWidth.doubleValue;
+            CGFloat cachedHeight = [cache heightForActivity:activity tableWidth:width contentSizeCategory:UIContentSizeCategoryLarge];
+            XCTAssertEqualWithAccuracy(cachedHeight, [self autoLayoutHeightOfActivity:activity tableWidth:width], 1.0, @"Activity %@ at width %.0f", index, width);
+        }
+    }
+}
+
+- (void)testMeasuredRowsNeedNoLayoutPass
+{
+    ActivityRowHeightCache *cache = [self createCache];
+    NSArray *activities = [self.activities subarrayWithRange:NSMakeRange(0, 50)];
+    
+    NSMutableArray *heights = [NSMutableArray array];
+    for (ActivityWrapper *activity in activities)
+    {
+        CGFloat height = [cache heightForActivity:activity tableWidth:kActivityRowHeightCacheTestTableWidth contentSizeCategory:UIContentSizeCategoryLarge];
+        XCTAssertGreaterThan(height, 0);
+        [heights addObject:@(height)];
+    }
+    
+    // At most one layout pass for each accessory type, however many rows
+    XCTAssertLessThanOrEqual(cache.numberOfLayoutPasses, 2);
+    XCTAssertEqual(cache.numberOfTextMeasurements, activities.count);
+    
+    NSUInteger layoutPasses = cache.numberOfLayoutPasses;
+    [activities enumerateObjectsUsingBlock:^(ActivityWrapper *activity, NSUInteger index, BOOL *stop) {
+        XCTAssertEqual([cache heightForActivity:activity tableWidth:kActivityRowHeightCacheTestTableWidth contentSizeCategory:UIContentSizeCategoryLarge], [heights[index] doubleValue]);
+    }];
+    XCTAssertEqual(cache.numberOfLayoutPasses, layoutPasses);
+    XCTAssertEqual(cache.numberOfTextMeasurements, activities.count);
+}
+
+- (void)testChangedInputsRemeasure
+{
+    ActivityRowHeightCache *cache = [self createCache];
+    ActivityWrapper *activity = self.activities[6];
+    
+    CGFloat narrowHeight = [cache heightForActivity:activity tableWidth:kActivityRowHeightCacheTestTableWidth contentSizeCategory:UIContentSizeCategoryLarge];
+    CGFloat wideHeight = [cache heightForActivity:activity tableWidth:kActivityRowHeightCacheTestTableWidth * 3 contentSizeCategory:UIContentSizeCategoryLarge];
+    [cache heightForActivity:activity tableWidth:kActivityRowHeightCacheTestTableWidth contentSizeCategory:UIContentSizeCategoryExtraLarge];
+    
+    XCTAssertEqual(cache.numberOfTextMeasurements, 3);
+    XCTAssertLessThan(wideHeight, narrowHeight);
+}
+
+- (void)testPrecomputedRowsAreNotMeasuredAgain
+{
+    ActivityRowHeightCache *cache = [self createCache];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Heights precomputed"];
+    
+    [cache precomputeHeightsForActivities:self.activities tableWidth:kActivityRowHeightCacheTestTableWidth contentSizeCategory:UIContentSizeCategoryLarge completionBlock:^{
+        XCTAssertTrue([NSThread isMainThread]);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    
+    NSUInteger layoutPasses = cache.numberOfLayoutPasses;
+    XCTAssertEqual(cache.numberOfTextMeasurements, self.activities.count);
+    for (ActivityWrapper *activity in self.activities)
+    {
+        [cache heightForActivity:activity tableWidth:kActivityRowHeightCacheTestTableWidth contentSizeCategory:UIContentSizeCategoryLarge];
+    }
+    XCTAssertEqual(cache.numberOfTextMeasurements, self.activities.count);
+    XCTAssertEqual(cache.numberOfLayoutPasses, layoutPasses);
+}
+
+- (void)testRemovedHeightsAreMeasuredAgain
+{
+    ActivityRowHeightCache *cache = [self createCache];
+    ActivityWrapper *activity = self.activities.firstObject;
+    
+    CGFloat height = [cache heightForActivity:activity tableWidth:kActivityRowHeightCacheTestTableWidth contentSizeCategory:UIContentSizeCategoryLarge];
+    NSUInteger layoutPasses = cache.numberOfLayoutPasses;
+    [cache removeAllHeights];
+    
+    XCTAssertEqual([cache heightForActivity:activity tableWidth:kActivityRowHeightCacheTestTableWidth contentSizeCategory:UIContentSizeCategoryLarge], height);
+    XCTAssertEqual(cache.numberOfTextMeasurements, 2);
+    XCTAssertEqual(cache.numberOfLayoutPasses, layoutPasses + 1);
+}
+
+#pragma mark - Performance
+
+- (void)testPerformanceFirstLayoutOfManyActivities
+{
+    [self measureBlock:^{
+        ActivityRowHeightCache *cache = [self createCache];
+        for (ActivityWrapper *activity in self.activities)
+        {
+            [cache heightForActivity:activity tableWidth:kActivityRowHeightCacheTestTableWidth contentSizeCategory:UIContentSizeCategoryLarge];
+        }
+    }];
+}
+
+@end
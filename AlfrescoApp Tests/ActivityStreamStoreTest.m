@@ -0,0 +1,232 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "ActivityStreamStoreTest.h"
+#import "ActivityStreamStore.h"
+
+static NSTimeInterval const kActivityStreamStoreTestLatency = 0.05;
+
+/**
+ * Stand-in for the activity stream service, serving pages of a stream held newest first after a simulated latency.
+ */
+@interface ActivityStreamStoreTestService : NSObject
+@property (nonatomic, strong) NSMutableArray *stream;
+@property (nonatomic, assign) NSUInteger numberOfRequests;
+@property (nonatomic, assign) NSUInteger numberOfEntriesServed;
+@end
+
+@implementation ActivityStreamStoreTestService
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.stream = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)postActivitiesWithIdentifiers:(NSRange)identifiers
+{
+    for (NSUInteger identifier = identifiers.location; identifier < NSMaxRange(identifiers); identifier++)
+    {
+        NSDate *postDate = [NSDate dateWithTimeIntervalSince1970:1500000000 + identifier * 60];
+        NSDictionary *properties = @{@"id" : [NSString stringWithFormat:@"%lu", (unsigned long)identifier],
+                                     @"activityType" : @"org.alfresco.documentlibrary.file-added",
+                                     @"postUserId" : @"jdoe",
+                                     @"postDate" : [[[NSISO8601DateFormatter alloc] init] stringFromDate:postDate],
+                                     @"siteNetwork" : @"marketing",
+                                     @"activitySummary" : @{@"title" : @"Report.docx", @"firstName" : @"Jane", @"lastName" : @"Doe"}};
+        [self.stream insertObject:[[AlfrescoActivityEntry alloc] initWithProperties:properties] atIndex:0];
+    }
+}
+
+- (ActivityStreamPageFetchBlock)fetchBlock
+{
+    return ^AlfrescoRequest *(AlfrescoListingContext *listingContext, AlfrescoPagingResultCompletionBlock completionBlock) {
+        self.numberOfRequests++;
+        NSUInteger start = MIN((NSUInteger)listingContext.skipCount, self.stream.count);
+        NSUInteger length = MIN((NSUInteger)listingContext.maxItems, self.stream.count - start);
+        NSArray *page = [self.stream subarrayWithRange:NSMakeRange(start, length)];
+        BOOL hasMoreItems = start + length < self.stream.count;
+        self.numberOfEntriesServed += page.count;
+        
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kActivityStreamStoreTestLatency * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            completionBlock([[AlfrescoPagingResult alloc] initWithArray:page hasMoreItems:hasMoreItems totalItems:(int)self.stream.count], nil);
+        });
+        return [AlfrescoRequest new];
+    };
+}
+
+@end
+
+@interface ActivityStreamStoreTest ()
+@property (nonatomic, strong) ActivityStreamStoreTestService *service;
+@property (nonatomic, strong) NSString *filePath;
+@end
+
+@implementation ActivityStreamStoreTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.service = [ActivityStreamStoreTestService new];
+    [self.service postActivitiesWithIdentifiers:NSMakeRange(0, 100)];
+    self.filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.archive", [NSUUID UUID].UUIDString]];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.filePath error:nil];
+    [super tearDown];
+}
+
+- (NSArray *)identifiersOfEntries:(NSArray *)entries
+{
+    return [entries valueForKey:@"identifier"];
+}
+
+- (void)fetchNewEntriesForStore:(ActivityStreamStore *)store completionBlock:(ActivityStreamStoreFetchCompletionBlock)completionBlock
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"New entries fetched"];
+    [store fetchNewEntriesUsingBlock:self.service.fetchBlock completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {
+        completionBlock(newEntries, entriesReplaced, error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testEmptyStoreIsFilledWithFirstPage
+{
+    ActivityStreamStore *store = [[ActivityStreamStore alloc] initWithFilePath:nil];
+    store.pageSize = 20;
+    
+    [self fetchNewEntriesForStore:store completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {
+        XCTAssertTrue(entriesReplaced);
+        XCTAssertEqual(newEntries.count, 20);
+    }];
+    
+    XCTAssertEqualObjects([self identifiersOfEntries:store.entries].firstObject, @"99");
+    XCTAssertTrue(store.hasOlderEntries);
+    XCTAssertEqual(self.service.numberOfRequests, 1);
+}
+
+- (void)testOnlyNewerEntriesAreFetched
+{
+    ActivityStreamStore *store = [[ActivityStreamStore alloc] initWithFilePath:nil];
+    store.pageSize = 20;
+    [self fetchNewEntriesForStore:store completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {}];
+    
+    [self.service postActivitiesWithIdentifiers:NSMakeRange(100, 3)];
+    self.service.numberOfRequests = 0;
+    [self fetchNewEntriesForStore:store completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {
+        XCTAssertFalse(entriesReplaced);
+        XCTAssertEqualObjects([self identifiersOfEntries:newEntries], (@[@"102", @"101", @"100"]));
+    }];
+    
+    XCTAssertEqual(self.service.numberOfRequests, 1);
+    XCTAssertEqual(store.entries.count, 23);
+    XCTAssertEqualObjects([self identifiersOfEntries:store.entries][3], @"99");
+}
+
+- (void)testStoreTooFarBehindIsReplaced
+{
+    ActivityStreamStore *store = [[ActivityStreamStore alloc] initWithFilePath:nil];
+    store.pageSize = 10;
+    [self fetchNewEntriesForStore:store completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {}];
+    
+    // More new activities than the store will page through looking for the ones it has
+    [self.service postActivitiesWithIdentifiers:NSMakeRange(100, 200)];
+    [self fetchNewEntriesForStore:store completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {
+        XCTAssertTrue(entriesReplaced);
+        XCTAssertEqualObjects(newEntries, store.entries);
+    }];
+    
+    XCTAssertEqualObjects([self identifiersOfEntries:store.entries].firstObject, @"299");
+    XCTAssertFalse([[self identifiersOfEntries:store.entries] containsObject:@"99"]);
+    XCTAssertTrue(store.hasOlderEntries);
+}
+
+- (void)testOlderPagesAreAppendedWithoutDuplicates
+{
+    ActivityStreamStore *store = [[ActivityStreamStore alloc] initWithFilePath:nil];
+    store.pageSize = 20;
+    [self fetchNewEntriesForStore:store completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {}];
+    
+    // The next page, overlapping the stored entries by one
+    NSArray *addedEntries = [store appendOlderEntries:[self.service.stream subarrayWithRange:NSMakeRange(19, 20)] hasMoreItems:YES];
+    
+    XCTAssertEqual(addedEntries.count, 19);
+    XCTAssertEqual(store.entries.count, 39);
+}
+
+- (void)testEntriesPersistBetweenLaunches
+{
+    ActivityStreamStore *store = [[ActivityStreamStore alloc] initWithFilePath:self.filePath];
+    [self fetchNewEntriesForStore:store completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {}];
+    [self waitForStoreToBeWritten];
+    
+    ActivityStreamStore *reopenedStore = [[ActivityStreamStore alloc] initWithFilePath:self.filePath];
+    XCTAssertEqualObjects([self identifiersOfEntries:reopenedStore.entries], [self identifiersOfEntries:store.entries]);
+    XCTAssertEqual(reopenedStore.hasOlderEntries, store.hasOlderEntries);
+}
+
+- (void)waitForStoreToBeWritten
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Store written"];
+    NSString *filePath = self.filePath;
+    [NSTimer scheduledTimerWithTimeInterval:0.05 repeats:YES block:^(NSTimer *timer) {
+        if ([[NSFileManager defaultManager] fileExistsAtPath:filePath])
+        {
+            [timer invalidate];
+            [expectation fulfill];
+        }
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+#pragma mark - Performance
+
+/*
+ * Time to first row from cold: a seeded store has its rows as soon as it is opened, an empty one after a page download.
+ */
+- (void)testPerformanceFirstRowsFromSeededStore
+{
+    ActivityStreamStore *seedingStore = [[ActivityStreamStore alloc] initWithFilePath:self.filePath];
+    [self fetchNewEntriesForStore:seedingStore completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {}];
+    [self waitForStoreToBeWritten];
+    
+    [self measureBlock:^{
+        ActivityStreamStore *store = [[ActivityStreamStore alloc] initWithFilePath:self.filePath];
+        XCTAssertGreaterThan(store.entries.count, 0);
+    }];
+}
+
+- (void)testPerformanceFirstRowsFromEmptyStore
+{
+    [self measureBlock:^{
+        ActivityStreamStore *store = [[ActivityStreamStore alloc] initWithFilePath:nil];
+        [self fetchNewEntriesForStore:store completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {
+            XCTAssertGreaterThan(newEntries.count, 0);
+        }];
+    }];
+}
+
+@end
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "AuthenticationProbeCacheTest.h"
+#import "AuthenticationProbeCache.h"
+
+static NSString * const kAuthenticationProbeCacheTestSuiteName = @"AuthenticationProbeCacheTest";
+static NSString * const kAuthenticationProbeCacheTestServer = @"https://repository.example.com:443/alfresco";
+
+@interface AuthenticationProbeCacheTest ()
+@property (nonatomic, strong) NSUserDefaults *userDefaults;
+@end
+
+@implementation AuthenticationProbeCacheTest
+
+- (void)setUp
+{
+    [super setUp];
+    [[NSUserDefaults standardUserDefaults] removePersistentDomainForName:kAuthenticationProbeCacheTestSuiteName];
+    self.userDefaults = [[NSUserDefaults alloc] initWithSuiteName:kAuthenticationProbeCacheTestSuiteName];
+}
+
+- (void)tearDown
+{
+    [[NSUserDefaults standardUserDefaults] removePersistentDomainForName:kAuthenticationProbeCacheTestSuiteName];
+    [super tearDown];
+}
+
+- (void)testUnprobedServerIsUnknown
+{
+    AuthenticationProbeCache *cache = [[AuthenticationProbeCache alloc] initWithUserDefaults:self.userDefaults];
+    
+    XCTAssertEqual([cache cachedResultForServerURLString:kAuthenticationProbeCacheTestServer], AuthenticationProbeResultUnknown);
+    XCTAssertEqual([cache cachedResultForServerURLString:nil], AuthenticationProbeResultUnknown);
+}
+
+- (void)testResultIsCachedPerServer
+{
+    AuthenticationProbeCache *cache = [[AuthenticationProbeCache alloc] initWithUserDefaults:self.userDefaults];
+    [cache cacheResult:AuthenticationProbeResultSAML forServerURLString:kAuthenticationProbeCacheTestServer];
+    [cache cacheResult:AuthenticationProbeResultBasic forServerURLString:@"http://other.example.com/alfresco"];
+    
+    XCTAssertEqual([cache cachedResultForServerURLString:kAuthenticationProbeCacheTestServer], AuthenticationProbeResultSAML);
+    XCTAssertEqual([cache cachedResultForServerURLString:[kAuthenticationProbeCacheTestServer.uppercaseString stringByAppendingString:@"/"]], AuthenticationProbeResultSAML);
+    XCTAssertEqual([cache cachedResultForServerURLString:@"http://other.example.com/alfresco"], AuthenticationProbeResultBasic);
+}
+
+- (void)testResultExpiresAfterTimeToLive
+{
+    AuthenticationProbeCache *cache = [[AuthenticationProbeCache alloc] initWithUserDefaults:self.userDefaults];
+    cache.timeToLive = 60;
+    [cache cacheResult:AuthenticationProbeResultBasic forServerURLString:kAuthenticationProbeCacheTestServer];
+    
+    XCTAssertEqual([cache cachedResultForServerURLString:kAuthenticationProbeCacheTestServer atDate:[NSDate dateWithTimeIntervalSinceNow:59]], AuthenticationProbeResultBasic);
+    XCTAssertEqual([cache cachedResultForServerURLString:kAuthenticationProbeCacheTestServer atDate:[NSDate dateWithTimeIntervalSinceNow:61]], AuthenticationProbeResultUnknown);
+}
+
+- (void)testInvalidatedResultIsUnknown
+{
+    AuthenticationProbeCache *cache = [[AuthenticationProbeCache alloc] initWithUserDefaults:self.userDefaults];
+    [cache cacheResult:AuthenticationProbeResultSAML forServerURLString:kAuthenticationProbeCacheTestServer];
+    [cache invalidateResultForServerURLString:kAuthenticationProbeCacheTestServer];
+    
+    XCTAssertEqual([cache cachedResultForServerURLString:kAuthenticationProbeCacheTestServer], AuthenticationProbeResultUnknown);
+}
+
+- (void)testResultsArePersisted
+{
+    AuthenticationProbeCache *cache = [[AuthenticationProbeCache alloc] initWithUserDefaults:self.userDefaults];
+    [cache cacheResult:AuthenticationProbeResultSAML forServerURLString:kAuthenticationProbeCacheTestServer];
+    
+    AuthenticationProbeCache *relaunchedCache = [[AuthenticationProbeCache alloc] initWithUserDefaults:self.userDefaults];
+    XCTAssertEqual([relaunchedCache cachedResultForServerURLString:kAuthenticationProbeCacheTestServer], AuthenticationProbeResultSAML);
+    
+    [relaunchedCache removeAllResults];
+    AuthenticationProbeCache *clearedCache = [[AuthenticationProbeCache alloc] initWithUserDefaults:self.userDefaults];
+    XCTAssertEqual([clearedCache cachedResultForServerURLString:kAuthenticationProbeCacheTestServer], AuthenticationProbeResultUnknown);
+}
+
+@end
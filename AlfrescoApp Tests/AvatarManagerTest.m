@@ -0,0 +1,248 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "AvatarManagerTest.h"
+#import "AvatarManager.h"
+
+static NSUInteger const kAvatarManagerTestBenchmarkUserCount = 100;
+
+/**
+ * Stand-in for the person service. Answers on a later main run loop turn, as the network would, and counts the calls.
+ */
+@interface AvatarManagerTestPersonService : NSObject <AvatarManagerPersonService>
+@property (nonatomic, strong) NSMutableDictionary *personLookupCounts;
+@property (nonatomic, assign) NSUInteger numberOfAvatarDownloads;
+@property (nonatomic, assign) NSUInteger numberOfDownloadsInFlight;
+@property (nonatomic, assign) NSUInteger maximumNumberOfDownloadsInFlight;
+@property (nonatomic, strong) NSSet *unknownIdentifiers;
+@property (nonatomic, strong) NSData *avatarData;
+@end
+
+@implementation AvatarManagerTestPersonService
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.personLookupCounts = [NSMutableDictionary dictionary];
+        UIGraphicsImageRendererFormat *format = [UIGraphicsImageRendererFormat preferredFormat];
+        format.scale = 1.0;
+        UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:CGSizeMake(120, 80) format:format];
+        self.avatarData = [renderer PNGDataWithActions:^(UIGraphicsImageRendererContext *rendererContext) {
+            [[UIColor orangeColor] setFill];
+            [rendererContext fillRect:CGRectMake(0, 0, 120, 80)];
+        }];
+    }
+    return self;
+}
+
+- (NSUInteger)lookupCountForIdentifier:(NSString *)identifier
+{
+    return [self.personLookupCounts[identifier] unsignedIntegerValue];
+}
+
+- (AlfrescoRequest *)retrievePersonWithIdentifier:(NSString *)identifier completionBlock:(AlfrescoPersonCompletionBlock)completionBlock
+{
+    self.personLookupCounts[identifier] = @([self lookupCountForIdentifier:identifier] + 1);
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if ([self.unknownIdentifiers containsObject:identifier])
+        {
+            completionBlock(nil, [NSError errorWithDomain:kAlfrescoErrorDomainName code:kAlfrescoErrorCodeUnknown userInfo:nil]);
+        }
+        else
+        {
+            completionBlock([AlfrescoPerson new], nil);
+        }
+    });
+    return [AlfrescoRequest new];
+}
+
+- (AlfrescoRequest *)retrieveAvatarForPerson:(AlfrescoPerson *)person completionBlock:(AlfrescoContentFileCompletionBlock)completionBlock
+{
+    self.numberOfAvatarDownloads++;
+    self.numberOfDownloadsInFlight++;
+    self.maximumNumberOfDownloadsInFlight = MAX(self.maximumNumberOfDownloadsInFlight, self.numberOfDownloadsInFlight);
+    
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.png", [NSUUID UUID].UUIDString]];
+    [self.avatarData writeToFile:path atomically:YES];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        self.numberOfDownloadsInFlight--;
+        completionBlock([[AlfrescoContentFile alloc] initWithUrl:[NSURL fileURLWithPath:path] mimeType:@"image/png"], nil);
+    });
+    return [AlfrescoRequest new];
+}
+
+@end
+
+@interface AvatarManagerTest ()
+@property (nonatomic, strong) AvatarManagerTestPersonService *personService;
+@property (nonatomic, strong) AvatarManager *avatarManager;
+@end
+
+@implementation AvatarManagerTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.personService = [AvatarManagerTestPersonService new];
+    self.avatarManager = [[AvatarManager alloc] initWithPersonService:self.personService cacheHelper:nil];
+}
+
+- (AvatarConfiguration *)configurationWithIdentifier:(NSString *)identifier
+{
+    return [AvatarConfiguration defaultConfigurationWithIdentifier:identifier session:nil];
+}
+
+- (void)testConcurrentRequestsShareOneDownload
+{
+    NSMutableArray *images = [NSMutableArray array];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"All callers answered"];
+    expectation.expectedFulfillmentCount = 3;
+    expectation.assertForOverFulfill = YES;
+    
+    for (NSUInteger caller = 0; caller < 3; caller++)
+    {
+        [self.avatarManager retrieveAvatarWithConfiguration:[self configurationWithIdentifier:@"alice"] completionBlock:^(UIImage *image, NSError *error) {
+            XCTAssertTrue([NSThread isMainThread]);
+            [images addObject:image];
+            [expectation fulfill];
+        }];
+    }
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertEqual([self.personService lookupCountForIdentifier:@"alice"], 1);
+    XCTAssertEqual(self.personService.numberOfAvatarDownloads, 1);
+    XCTAssertEqual(images[0], images[1]);
+    XCTAssertEqual(images[1], images[2]);
+    // Cropped to a square
+    XCTAssertTrue(CGSizeEqualToSize([images[0] size], CGSizeMake(80, 80)));
+}
+
+- (void)testManyUsersAreFetchedOnceWithinTheConcurrencyLimit
+{
+    self.avatarManager.maximumConcurrentRequests = 4;
+    NSUInteger userCount = 20;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"All callers answered"];
+    expectation.expectedFulfillmentCount = userCount * 2;
+    expectation.assertForOverFulfill = YES;
+    
+    for (NSUInteger pass = 0; pass < 2; pass++)
+    {
+        for (NSUInteger user = 0; user < userCount; user++)
+        {
+            [self.avatarManager retrieveAvatarWithConfiguration:[self configurationWithIdentifier:[NSString stringWithFormat:@"user-%lu", (unsigned long)user]] completionBlock:^(UIImage *image, NSError *error) {
+                XCTAssertNotNil(image);
+                [expectation fulfill];
+            }];
+        }
+    }
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertEqual(self.personService.personLookupCounts.count, userCount);
+    for (NSNumber *lookupCount in self.personService.personLookupCounts.allValues)
+    {
+        XCTAssertEqual(lookupCount.unsignedIntegerValue, 1);
+    }
+    XCTAssertEqual(self.personService.numberOfAvatarDownloads, userCount);
+    XCTAssertLessThanOrEqual(self.personService.maximumNumberOfDownloadsInFlight, 4);
+}
+
+- (void)testKnownPersonSkipsLookup
+{
+    AvatarConfiguration *configuration = [self configurationWithIdentifier:@"bob"];
+    configuration.person = [AlfrescoPerson new];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Avatar retrieved"];
+    
+    [self.avatarManager retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *image, NSError *error) {
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertEqual([self.personService lookupCountForIdentifier:@"bob"], 0);
+    XCTAssertEqual(self.personService.numberOfAvatarDownloads, 1);
+}
+
+- (void)testCachedAvatarIsReturnedSynchronously
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Avatar retrieved"];
+    [self.avatarManager retrieveAvatarWithConfiguration:[self configurationWithIdentifier:@"carol"] completionBlock:^(UIImage *image, NSError *error) {
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    __block UIImage *cachedImage = nil;
+    __block NSUInteger numberOfCalls = 0;
+    [self.avatarManager retrieveAvatarWithConfiguration:[self configurationWithIdentifier:@"carol"] completionBlock:^(UIImage *image, NSError *error) {
+        cachedImage = image;
+        numberOfCalls++;
+    }];
+    
+    XCTAssertEqual(numberOfCalls, 1);
+    XCTAssertEqual(cachedImage, [self.avatarManager cachedAvatarForIdentifier:@"carol"]);
+    XCTAssertEqual(self.personService.numberOfAvatarDownloads, 1);
+}
+
+- (void)testUnknownPersonGetsPlaceholderOnce
+{
+    self.personService.unknownIdentifiers = [NSSet setWithObject:@"nobody"];
+    AvatarConfiguration *configuration = [self configurationWithIdentifier:@"nobody"];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Placeholder delivered"];
+    expectation.assertForOverFulfill = YES;
+    
+    [self.avatarManager retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *image, NSError *error) {
+        XCTAssertEqual(image, configuration.placeholderImage);
+        XCTAssertNotNil(error);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertNil([self.avatarManager cachedAvatarForIdentifier:@"nobody"]);
+}
+
+#pragma mark - Performance
+
+- (void)testPerformanceResolvingAvatarsForManyUsers
+{
+    [self measureMetrics:@[XCTPerformanceMetric_WallClockTime] automaticallyStartMeasuring:NO forBlock:^{
+        AvatarManagerTestPersonService *personService = [AvatarManagerTestPersonService new];
+        AvatarManager *avatarManager = [[AvatarManager alloc] initWithPersonService:personService cacheHelper:nil];
+        XCTestExpectation *expectation = [self expectationWithDescription:@"All avatars resolved"];
+        expectation.expectedFulfillmentCount = kAvatarManagerTestBenchmarkUserCount;
+        
+        [self startMeasuring];
+        for (NSUInteger user = 0; user < kAvatarManagerTestBenchmarkUserCount; user++)
+        {
+            AvatarConfiguration *configuration = [self configurationWithIdentifier:[NSString stringWithFormat:@"user-%lu", (unsigned long)user]];
+            [avatarManager retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *image, NSError *error) {
+                XCTAssertNotNil(image);
+                [expectation fulfill];
+            }];
+        }
+        [self waitForExpectationsWithTimeout:30 handler:nil];
+        [self stopMeasuring];
+        
+        XCTAssertEqual(personService.numberOfAvatarDownloads, kAvatarManagerTestBenchmarkUserCount);
+    }];
+}
+
+@end
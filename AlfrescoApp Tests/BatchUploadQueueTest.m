@@ -0,0 +1,228 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import <ImageIO/ImageIO.h>
+#import "BatchUploadQueueTest.h"
+#import "BatchUploadQueue.h"
+#import "Utility.h"
+
+static NSTimeInterval const kBatchUploadQueueTestTimeout = 5;
+static NSUInteger const kBatchUploadQueueTestBenchmarkPhotoCount = 50;
+
+/**
+ * One create request made of the stub service. Cancelling it answers with the SDK's cancellation error, as the network layer does.
+ */
+@interface BatchUploadQueueTestRequest : AlfrescoRequest
+@property (nonatomic, copy) AlfrescoDocumentCompletionBlock completionBlock;
+@end
+
+@implementation BatchUploadQueueTestRequest
+
+- (void)cancel
+{
+    [super cancel];
+    AlfrescoDocumentCompletionBlock completionBlock = self.completionBlock;
+    self.completionBlock = nil;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        completionBlock(nil, [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeNetworkRequestCancelled]);
+    });
+}
+
+@end
+
+/**
+ * Stand-in for the document folder service. Holds every create request until the test answers or cancels it,
+ * unless told to answer each one on a later main run loop turn with a new document.
+ */
+@interface BatchUploadQueueTestDocumentFolderService : AlfrescoDocumentFolderService
+@property (nonatomic, strong) NSMutableArray<BatchUploadQueueTestRequest *> *requests;
+@property (nonatomic, assign) BOOL completesRequests;
+@end
+
+@implementation BatchUploadQueueTestDocumentFolderService
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.requests = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (AlfrescoRequest *)createDocumentWithName:(NSString *)documentName
+                             inParentFolder:(AlfrescoFolder *)folder
+                              contentStream:(AlfrescoContentStream *)file
+                                 properties:(NSDictionary *)properties
+                                    aspects:(NSArray *)aspects
+                            completionBlock:(AlfrescoDocumentCompletionBlock)completionBlock
+                              progressBlock:(AlfrescoProgressBlock)progressBlock
+{
+    BatchUploadQueueTestRequest *request = [BatchUploadQueueTestRequest new];
+    if (self.completesRequests)
+    {
+        // Reads the whole stream, as the network layer would
+        uint8_t buffer[16 * 1024];
+        NSInteger bytesRead = 0;
+        [file.inputStream open];
+        do
+        {
+            bytesRead = [file.inputStream read:buffer maxLength:sizeof(buffer)];
+        } while (bytesRead > 0);
+        [file.inputStream close];
+        
+        NSDictionary *documentProperties = @{kCMISPropertyObjectId : [@"workspace://SpacesStore/" stringByAppendingString:documentName],
+                                             kCMISPropertyName : documentName,
+                                             kCMISPropertyObjectTypeId : @"cmis:document"};
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionBlock([[AlfrescoDocument alloc] initWithProperties:documentProperties], nil);
+        });
+        return request;
+    }
+    request.completionBlock = completionBlock;
+    [self.requests addObject:request];
+    return request;
+}
+
+@end
+
+@interface BatchUploadQueueTest () <BatchUploadQueueDelegate>
+@property (nonatomic, strong) BatchUploadQueueTestDocumentFolderService *documentFolderService;
+@property (nonatomic, strong) BatchUploadQueue *uploadQueue;
+@property (nonatomic, strong) NSMutableArray<BatchUploadItem *> *failedItems;
+@property (nonatomic, strong) NSArray *finishedItems;
+@property (nonatomic, assign) NSUInteger numberOfFinishCalls;
+@end
+
+@implementation BatchUploadQueueTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.documentFolderService = [BatchUploadQueueTestDocumentFolderService new];
+    self.uploadQueue = [[BatchUploadQueue alloc] initWithDocumentFolderService:self.documentFolderService uploadFolder:nil];
+    self.uploadQueue.delegate = self;
+    self.failedItems = [NSMutableArray array];
+    self.numberOfFinishCalls = 0;
+}
+
+- (NSArray *)itemsWithCount:(NSUInteger)count
+{
+    NSMutableArray *items = [NSMutableArray array];
+    for (NSUInteger index = 0; index < count; index++)
+    {
+        NSString *documentName = [NSString stringWithFormat:@"photo-%lu.jpg", (unsigned long)index];
+        NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:documentName];
+        [items addObject:[[BatchUploadItem alloc] initWithDocumentName:documentName mimeType:@"image/jpeg" filePath:filePath]];
+    }
+    return items;
+}
+
+- (void)testCancelReportsItemsThatNeverStarted
+{
+    self.uploadQueue.maxConcurrentUploads = 1;
+    NSArray *items = [self itemsWithCount:3];
+    [self.uploadQueue uploadItems:items];
+    XCTAssertEqual(self.documentFolderService.requests.count, 1);
+    
+    [self.uploadQueue cancelAllUploads];
+    
+    // Pending items are reported straight away, while the active upload is still being cancelled
+    XCTAssertEqual(self.failedItems.count, 2);
+    XCTAssertEqual(self.numberOfFinishCalls, 0);
+    for (BatchUploadItem *item in self.failedItems)
+    {
+        XCTAssertEqual(item.error.code, kAlfrescoErrorCodeNetworkRequestCancelled);
+    }
+    
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"numberOfFinishCalls == 1"];
+    [self expectationForPredicate:predicate evaluatedWithObject:self handler:nil];
+    [self waitForExpectationsWithTimeout:kBatchUploadQueueTestTimeout handler:nil];
+    
+    XCTAssertEqual(self.failedItems.count, items.count);
+    XCTAssertEqualObjects(self.finishedItems, items);
+    XCTAssertFalse([self.uploadQueue isUploading]);
+}
+
+#pragma mark - Performance
+
+- (NSData *)photoData
+{
+    UIGraphicsImageRendererFormat *format = [UIGraphicsImageRendererFormat preferredFormat];
+    format.scale = 1.0;
+    UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:CGSizeMake(2000, 1500) format:format];
+    return [renderer JPEGDataWithCompressionQuality:0.9 actions:^(UIGraphicsImageRendererContext *rendererContext) {
+        [[UIColor blueColor] setFill];
+        [rendererContext fillRect:CGRectMake(0, 0, 1000, 1500)];
+        [[UIColor greenColor] setFill];
+        [rendererContext fillRect:CGRectMake(1000, 0, 1000, 1500)];
+    }];
+}
+
+- (void)testPerformanceMemoryUploadingManyPhotos
+{
+    if (@available(iOS 13.0, *))
+    {
+        NSData *photoData = [self photoData];
+        NSDictionary *metadata = @{(NSString *)kCGImagePropertyOrientation : @6,
+                                   (NSString *)kCGImagePropertyExifDictionary : @{(NSString *)kCGImagePropertyExifLensModel : @"Benchmark"}};
+        
+        [self measureWithMetrics:@[[XCTMemoryMetric new]] block:^{
+            BatchUploadQueueTestDocumentFolderService *documentFolderService = [BatchUploadQueueTestDocumentFolderService new];
+            documentFolderService.completesRequests = YES;
+            BatchUploadQueue *uploadQueue = [[BatchUploadQueue alloc] initWithDocumentFolderService:documentFolderService uploadFolder:nil];
+            uploadQueue.delegate = self;
+            self.numberOfFinishCalls = 0;
+            
+            NSArray *items = [self itemsWithCount:kBatchUploadQueueTestBenchmarkPhotoCount];
+            for (BatchUploadItem *item in items)
+            {
+                item.removeFileAfterUpload = YES;
+                item.contentPreparationBlock = ^BOOL(NSString *filePath) {
+                    return [Utility writeImageData:photoData metadata:metadata toFilePath:filePath];
+                };
+            }
+            
+            [self expectationForPredicate:[NSPredicate predicateWithFormat:@"numberOfFinishCalls == 1"] evaluatedWithObject:self handler:nil];
+            [uploadQueue uploadItems:items];
+            [self waitForExpectationsWithTimeout:60 handler:nil];
+            
+            for (BatchUploadItem *item in items)
+            {
+                XCTAssertNotNil(item.document);
+            }
+        }];
+    }
+}
+
+#pragma mark - BatchUploadQueueDelegate Methods
+
+- (void)batchUploadQueue:(BatchUploadQueue *)queue didFailToUploadItem:(BatchUploadItem *)item
+{
+    [self.failedItems addObject:item];
+}
+
+- (void)batchUploadQueue:(BatchUploadQueue *)queue didFinishUploadingItems:(NSArray *)items
+{
+    self.finishedItems = items;
+    self.numberOfFinishCalls++;
+}
+
+@end
@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "DocumentPreviewCacheTest.h"
+#import "DocumentPreviewCache.h"
+
+@interface DocumentPreviewCacheTest ()
+@property (nonatomic, strong) NSString *folderPath;
+@end
+
+@implementation DocumentPreviewCacheTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.folderPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    [[NSFileManager defaultManager] createDirectoryAtPath:self.folderPath withIntermediateDirectories:YES attributes:nil error:nil];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.folderPath error:nil];
+    [super tearDown];
+}
+
+- (void)writeFileWithName:(NSString *)fileName size:(NSUInteger)size
+{
+    NSString *filePath = [self.folderPath stringByAppendingPathComponent:fileName];
+    [[NSFileManager defaultManager] createFileAtPath:filePath contents:[NSMutableData dataWithLength:size] attributes:nil];
+}
+
+- (void)addFileWithName:(NSString *)fileName size:(NSUInteger)size nodeIdentifier:(NSString *)nodeIdentifier toCache:(DocumentPreviewCache *)cache
+{
+    [self writeFileWithName:fileName size:size];
+    [cache addFileWithName:fileName nodeIdentifier:nodeIdentifier];
+}
+
+- (BOOL)fileExistsWithName:(NSString *)fileName
+{
+    return [[NSFileManager defaultManager] fileExistsAtPath:[self.folderPath stringByAppendingPathComponent:fileName]];
+}
+
+- (NSArray *)fileNamesOnDisk
+{
+    NSPredicate *visibleFiles = [NSPredicate predicateWithFormat:@"NOT SELF BEGINSWITH '.'"];
+    return [[[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.folderPath error:nil] filteredArrayUsingPredicate:visibleFiles];
+}
+
+- (void)testLeastRecentlyUsedFilesAreEvictedFirst
+{
+    DocumentPreviewCache *cache = [[DocumentPreviewCache alloc] initWithFolderPath:self.folderPath maximumSize:300];
+    [self addFileWithName:@"a.pdf" size:100 nodeIdentifier:@"node-a" toCache:cache];
+    [self addFileWithName:@"b.pdf" size:100 nodeIdentifier:@"node-b" toCache:cache];
+    [self addFileWithName:@"c.pdf" size:100 nodeIdentifier:@"node-c" toCache:cache];
+    
+    XCTAssertTrue([cache containsFileWithName:@"a.pdf"]);
+    [self addFileWithName:@"d.pdf" size:100 nodeIdentifier:@"node-d" toCache:cache];
+    
+    NSArray *expectedOrder = @[@"c.pdf", @"a.pdf", @"d.pdf"];
+    XCTAssertEqualObjects([cache fileNamesInEvictionOrder], expectedOrder);
+    XCTAssertFalse([cache containsFileWithName:@"b.pdf"]);
+    XCTAssertFalse([self fileExistsWithName:@"b.pdf"]);
+    XCTAssertTrue([self fileExistsWithName:@"a.pdf"]);
+}
+
+- (void)testBudgetIsEnforced
+{
+    DocumentPreviewCache *cache = [[DocumentPreviewCache alloc] initWithFolderPath:self.folderPath maximumSize:1000];
+    for (NSUInteger fileNumber = 0; fileNumber < 20; fileNumber++)
+    {
+        NSString *fileName = [NSString stringWithFormat:@"%lu.pdf", (unsigned long)fileNumber];
+        [self addFileWithName:fileName size:100 nodeIdentifier:fileName toCache:cache];
+    }
+    XCTAssertEqual(cache.totalSize, 1000);
+    XCTAssertEqual([self fileNamesOnDisk].count, 10);
+    
+    cache.maximumSize = 250;
+    XCTAssertEqual(cache.totalSize, 200);
+    NSArray *expectedFileNames = @[@"18.pdf", @"19.pdf"];
+    XCTAssertEqualObjects([cache fileNamesInEvictionOrder], expectedFileNames);
+    
+    // A preview larger than the whole budget is still kept while it is the newest
+    [self addFileWithName:@"large.pdf" size:5000 nodeIdentifier:@"large" toCache:cache];
+    XCTAssertEqualObjects([cache fileNamesInEvictionOrder], @[@"large.pdf"]);
+    XCTAssertEqual([self fileNamesOnDisk].count, 1);
+}
+
+- (void)testEarlierVersionsOfANodeAreRemoved
+{
+    DocumentPreviewCache *cache = [[DocumentPreviewCache alloc] initWithFolderPath:self.folderPath maximumSize:10000];
+    [self addFileWithName:@"report_2020-01-01-10-00-00.pdf" size:100 nodeIdentifier:@"workspace://SpacesStore/report" toCache:cache];
+    [self addFileWithName:@"other_2020-01-01-10-00-00.pdf" size:100 nodeIdentifier:@"workspace://SpacesStore/other" toCache:cache];
+    [self addFileWithName:@"report_2020-02-01-10-00-00.pdf" size:150 nodeIdentifier:@"workspace://SpacesStore/report" toCache:cache];
+    
+    XCTAssertFalse([self fileExistsWithName:@"report_2020-01-01-10-00-00.pdf"]);
+    XCTAssertTrue([cache containsFileWithName:@"report_2020-02-01-10-00-00.pdf"]);
+    XCTAssertTrue([cache containsFileWithName:@"other_2020-01-01-10-00-00.pdf"]);
+    XCTAssertEqual(cache.totalSize, 250);
+}
+
+- (void)testPinnedFilesAreNotEvicted
+{
+    DocumentPreviewCache *cache = [[DocumentPreviewCache alloc] initWithFolderPath:self.folderPath maximumSize:200];
+    [self addFileWithName:@"open.pdf" size:100 nodeIdentifier:@"node-open" toCache:cache];
+    [cache pinFileWithName:@"open.pdf"];
+    // Previews opened in another window, and one still downloading
+    [cache pinFileWithName:@"open.pdf"];
+    [cache pinFileWithName:@"downloading.pdf"];
+    
+    [self addFileWithName:@"b.pdf" size:100 nodeIdentifier:@"node-b" toCache:cache];
+    [self addFileWithName:@"c.pdf" size:100 nodeIdentifier:@"node-c" toCache:cache];
+    [self addFileWithName:@"downloading.pdf" size:100 nodeIdentifier:@"node-downloading" toCache:cache];
+    [self addFileWithName:@"d.pdf" size:100 nodeIdentifier:@"node-d" toCache:cache];
+    
+    XCTAssertTrue([self fileExistsWithName:@"open.pdf"]);
+    XCTAssertTrue([self fileExistsWithName:@"downloading.pdf"]);
+    XCTAssertFalse([self fileExistsWithName:@"b.pdf"]);
+    XCTAssertFalse([self fileExistsWithName:@"c.pdf"]);
+    XCTAssertEqual(cache.totalSize, 300);
+    
+    // A newer version doesn't remove the one on screen
+    [self addFileWithName:@"open-2.pdf" size:100 nodeIdentifier:@"node-open" toCache:cache];
+    XCTAssertTrue([self fileExistsWithName:@"open.pdf"]);
+    
+    [cache unpinFileWithName:@"open.pdf"];
+    XCTAssertTrue([self fileExistsWithName:@"open.pdf"]);
+    
+    // Evicted as soon as the last preview showing it goes away
+    [cache unpinFileWithName:@"open.pdf"];
+    XCTAssertFalse([self fileExistsWithName:@"open.pdf"]);
+    XCTAssertTrue([self fileExistsWithName:@"downloading.pdf"]);
+    XCTAssertEqual(cache.totalSize, 200);
+}
+
+- (void)testIndexIsRestoredFromTheFolder
+{
+    [self writeFileWithName:@"existing.pdf" size:100];
+    [[NSFileManager defaultManager] createDirectoryAtPath:[self.folderPath stringByAppendingPathComponent:@"tmp"] withIntermediateDirectories:YES attributes:nil error:nil];
+    
+    DocumentPreviewCache *cache = [[DocumentPreviewCache alloc] initWithFolderPath:self.folderPath maximumSize:10000];
+    XCTAssertTrue([cache containsFileWithName:@"existing.pdf"]);
+    XCTAssertEqual(cache.totalSize, 100);
+    [self addFileWithName:@"report_1.pdf" size:100 nodeIdentifier:@"workspace://SpacesStore/report" toCache:cache];
+    
+    // Written when the app goes to the background
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIApplicationDidEnterBackgroundNotification object:nil];
+    [cache fileNamesInEvictionOrder];
+    
+    DocumentPreviewCache *relaunchedCache = [[DocumentPreviewCache alloc] initWithFolderPath:self.folderPath maximumSize:10000];
+    XCTAssertEqual(relaunchedCache.totalSize, 200);
+    [self addFileWithName:@"report_2.pdf" size:100 nodeIdentifier:@"workspace://SpacesStore/report" toCache:relaunchedCache];
+    XCTAssertFalse([self fileExistsWithName:@"report_1.pdf"]);
+}
+
+- (void)testConcurrentAccessKeepsIndexAndFolderInStep
+{
+    DocumentPreviewCache *cache = [[DocumentPreviewCache alloc] initWithFolderPath:self.folderPath maximumSize:5000];
+    
+    dispatch_apply(200, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+        NSString *fileName = [NSString stringWithFormat:@"%zu.pdf", iteration % 80];
+        NSString *nodeIdentifier = [NSString stringWithFormat:@"node-%zu", iteration % 80];
+        if (iteration % 3 == 0)
+        {
+            [cache containsFileWithName:fileName];
+        }
+        else
+        {
+            [self addFileWithName:fileName size:100 nodeIdentifier:nodeIdentifier toCache:cache];
+        }
+    });
+    
+    NSArray *indexedFileNames = [cache fileNamesInEvictionOrder];
+    XCTAssertLessThanOrEqual(cache.totalSize, 5000);
+    XCTAssertEqual(cache.totalSize, indexedFileNames.count * 100);
+    XCTAssertEqualObjects([NSSet setWithArray:indexedFileNames], [NSSet setWithArray:[self fileNamesOnDisk]]);
+}
+
+@end
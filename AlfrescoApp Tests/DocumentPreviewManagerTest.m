@@ -0,0 +1,249 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "DocumentPreviewManagerTest.h"
+#import "DocumentPreviewManager.h"
+
+static unsigned long long const kDocumentPreviewManagerTestLargeDocumentSize = 50 * 1024 * 1024;
+static unsigned long long const kDocumentPreviewManagerTestChunkSize = 64 * 1024;
+static NSTimeInterval const kDocumentPreviewManagerTestTransferDuration = 1.0;
+
+/**
+ * One content request made of the fake transport, driven by the test.
+ */
+@interface DocumentPreviewManagerTestTransfer : AlfrescoRequest
+@property (nonatomic, strong) AlfrescoDocument *document;
+@property (nonatomic, strong) NSOutputStream *outputStream;
+@property (nonatomic, copy) AlfrescoBOOLCompletionBlock completionBlock;
+@property (nonatomic, copy) AlfrescoProgressBlock progressBlock;
+@property (nonatomic, assign) BOOL wasCancelled;
+// Main thread time spent handing progress to the manager
+@property (nonatomic, assign) CFAbsoluteTime progressHandlingTime;
+@end
+
+@implementation DocumentPreviewManagerTestTransfer
+
+- (void)cancel
+{
+    [super cancel];
+    self.wasCancelled = YES;
+}
+
+- (void)streamBytes:(unsigned long long)bytesTotal over:(NSTimeInterval)duration
+{
+    NSUInteger chunkCount = (NSUInteger)(bytesTotal / kDocumentPreviewManagerTestChunkSize);
+    for (NSUInteger chunk = 1; chunk <= chunkCount; chunk++)
+    {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(duration * chunk / chunkCount * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+            self.progressBlock(chunk * kDocumentPreviewManagerTestChunkSize, bytesTotal);
+            self.progressHandlingTime += CFAbsoluteTimeGetCurrent() - start;
+            
+            if (chunk == chunkCount)
+            {
+                [self finish];
+            }
+        });
+    }
+}
+
+- (void)finish
+{
+    uint8_t content[] = "content";
+    [self.outputStream open];
+    [self.outputStream write:content maxLength:sizeof(content)];
+    [self.outputStream close];
+    self.completionBlock(YES, nil);
+}
+
+@end
+
+@interface DocumentPreviewManagerTestContentService : NSObject <DocumentPreviewManagerContentService>
+@property (nonatomic, strong) NSMutableArray<DocumentPreviewManagerTestTransfer *> *transfers;
+@end
+
+@implementation DocumentPreviewManagerTestContentService
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.transfers = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (AlfrescoRequest *)retrieveContentOfDocument:(AlfrescoDocument *)document outputStream:(NSOutputStream *)outputStream completionBlock:(AlfrescoBOOLCompletionBlock)completionBlock progressBlock:(AlfrescoProgressBlock)progressBlock
+{
+    DocumentPreviewManagerTestTransfer *transfer = [DocumentPreviewManagerTestTransfer new];
+    transfer.document = document;
+    transfer.outputStream = outputStream;
+    transfer.completionBlock = completionBlock;
+    transfer.progressBlock = progressBlock;
+    [self.transfers addObject:transfer];
+    return transfer;
+}
+
+- (NSArray *)transfersOfDocument:(AlfrescoDocument *)document
+{
+    return [self.transfers filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"document == %@", document]];
+}
+
+@end
+
+@interface DocumentPreviewManagerTest ()
+@property (nonatomic, strong) NSString *folderPath;
+@property (nonatomic, strong) DocumentPreviewManagerTestContentService *contentService;
+@property (nonatomic, strong) DocumentPreviewManager *previewManager;
+@end
+
+@implementation DocumentPreviewManagerTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.folderPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    self.contentService = [DocumentPreviewManagerTestContentService new];
+    self.previewManager = [[DocumentPreviewManager alloc] initWithFolderPath:self.folderPath contentService:self.contentService];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.folderPath error:nil];
+    [super tearDown];
+}
+
+- (AlfrescoDocument *)documentWithName:(NSString *)name
+{
+    NSDictionary *properties = @{kCMISPropertyObjectId : [@"workspace://SpacesStore/" stringByAppendingString:name],
+                                 kCMISPropertyName : name,
+                                 kCMISPropertyObjectTypeId : @"cmis:document"};
+    return [[AlfrescoDocument alloc] initWithProperties:properties];
+}
+
+- (NSUInteger)progressNotificationsDownloadingLargeDocumentWithMinimumInterval:(NSTimeInterval)minimumProgressInterval mainThreadTime:(CFAbsoluteTime *)mainThreadTime
+{
+    self.previewManager.minimumProgressInterval = minimumProgressInterval;
+    AlfrescoDocument *document = [self documentWithName:[NSString stringWithFormat:@"large-%f.pdf", minimumProgressInterval]];
+    
+    __block NSUInteger notificationCount = 0;
+    id observer = [[NSNotificationCenter defaultCenter] addObserverForName:kDocumentPreviewManagerProgressNotification object:document queue:nil usingBlock:^(NSNotification *notification) {
+        notificationCount++;
+    }];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Download completed"];
+    __block unsigned long long lastBytesTransferred = 0;
+    [self.previewManager downloadDocument:document session:nil priority:DocumentPreviewDownloadPriorityForeground progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+        lastBytesTransferred = bytesTransferred;
+    } completionBlock:^(NSString *filePath, NSError *error) {
+        XCTAssertNotNil(filePath);
+        [expectation fulfill];
+    }];
+    
+    DocumentPreviewManagerTestTransfer *transfer = self.contentService.transfers.lastObject;
+    [transfer streamBytes:kDocumentPreviewManagerTestLargeDocumentSize over:kDocumentPreviewManagerTestTransferDuration];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    [[NSNotificationCenter defaultCenter] removeObserver:observer];
+    
+    // Whatever is skipped, the final figure always arrives
+    XCTAssertEqual(lastBytesTransferred, kDocumentPreviewManagerTestLargeDocumentSize);
+    *mainThreadTime = transfer.progressHandlingTime;
+    return notificationCount;
+}
+
+- (void)testProgressOfLargeDownloadIsThrottled
+{
+    CFAbsoluteTime unthrottledTime = 0;
+    NSUInteger unthrottledCount = [self progressNotificationsDownloadingLargeDocumentWithMinimumInterval:0 mainThreadTime:&unthrottledTime];
+    CFAbsoluteTime throttledTime = 0;
+    NSUInteger throttledCount = [self progressNotificationsDownloadingLargeDocumentWithMinimumInterval:0.1 mainThreadTime:&throttledTime];
+    
+    XCTAssertEqual(unthrottledCount, kDocumentPreviewManagerTestLargeDocumentSize / kDocumentPreviewManagerTestChunkSize);
+    XCTAssertLessThan(throttledCount, unthrottledCount);
+    XCTAssertLessThanOrEqual(throttledCount, kDocumentPreviewManagerTestTransferDuration / 0.1 + 3);
+    XCTAssertLessThan(throttledTime, unthrottledTime);
+}
+
+- (void)testSubscribersShareOneDownload
+{
+    AlfrescoDocument *document = [self documentWithName:@"shared.pdf"];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Every subscriber completed"];
+    expectation.expectedFulfillmentCount = 3;
+    
+    for (NSUInteger subscriber = 0; subscriber < 3; subscriber++)
+    {
+        [self.previewManager downloadDocument:document session:nil priority:DocumentPreviewDownloadPriorityForeground progressBlock:nil completionBlock:^(NSString *filePath, NSError *error) {
+            XCTAssertEqualObjects(filePath, [self.previewManager filePathForDocument:document]);
+            [expectation fulfill];
+        }];
+    }
+    XCTAssertEqual(self.contentService.transfers.count, 1);
+    
+    [self.contentService.transfers.firstObject finish];
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertTrue([self.previewManager hasLocalContentOfDocument:document]);
+    XCTAssertFalse([self.previewManager isCurrentlyDownloadingDocument:document]);
+}
+
+- (void)testDownloadIsCancelledWhenLastSubscriberLeaves
+{
+    AlfrescoDocument *document = [self documentWithName:@"abandoned.pdf"];
+    AlfrescoRequest *firstRequest = [self.previewManager downloadDocument:document session:nil priority:DocumentPreviewDownloadPriorityForeground progressBlock:nil completionBlock:nil];
+    AlfrescoRequest *secondRequest = [self.previewManager downloadDocument:document session:nil priority:DocumentPreviewDownloadPriorityBackground progressBlock:nil completionBlock:nil];
+    DocumentPreviewManagerTestTransfer *transfer = self.contentService.transfers.firstObject;
+    
+    [firstRequest cancel];
+    XCTAssertFalse(transfer.wasCancelled);
+    XCTAssertTrue([self.previewManager isCurrentlyDownloadingDocument:document]);
+    
+    [self expectationForNotification:kDocumentPreviewManagerDocumentDownloadCancelledNotification object:document handler:nil];
+    [secondRequest cancel];
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertTrue(transfer.wasCancelled);
+    XCTAssertFalse([self.previewManager isCurrentlyDownloadingDocument:document]);
+}
+
+- (void)testForegroundDownloadTakesOverBackgroundSlot
+{
+    self.previewManager.maximumConcurrentDownloads = 1;
+    AlfrescoDocument *warmedDocument = [self documentWithName:@"next.pdf"];
+    AlfrescoDocument *displayedDocument = [self documentWithName:@"displayed.pdf"];
+    
+    [self.previewManager downloadDocument:warmedDocument session:nil priority:DocumentPreviewDownloadPriorityBackground progressBlock:nil completionBlock:nil];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Displayed document downloaded"];
+    [self.previewManager downloadDocument:displayedDocument session:nil priority:DocumentPreviewDownloadPriorityForeground progressBlock:nil completionBlock:^(NSString *filePath, NSError *error) {
+        [expectation fulfill];
+    }];
+    
+    DocumentPreviewManagerTestTransfer *suspendedTransfer = [self.contentService transfersOfDocument:warmedDocument].firstObject;
+    XCTAssertTrue(suspendedTransfer.wasCancelled);
+    XCTAssertEqual([self.contentService transfersOfDocument:displayedDocument].count, 1);
+    
+    [[self.contentService transfersOfDocument:displayedDocument].firstObject finish];
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    // The background download resumes once the slot is free
+    XCTAssertEqual([self.contentService transfersOfDocument:warmedDocument].count, 2);
+    XCTAssertTrue([self.previewManager isCurrentlyDownloadingDocument:warmedDocument]);
+}
+
+@end
@@ -0,0 +1,309 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "FavouriteManagerTest.h"
+#import "FavouriteManager.h"
+#import "FavouritesIndex.h"
+
+static NSUInteger const kFavouriteManagerTestBenchmarkFavouriteCount = 10000;
+
+/**
+ * Stand-in for the document folder service. Favourite changes are held until the test answers them.
+ */
+@interface FavouriteManagerTestService : NSObject <FavouriteManagerService>
+@property (nonatomic, strong) NSArray<AlfrescoNode *> *favoriteNodes;
+@property (nonatomic, strong) NSMutableArray<AlfrescoFavoritedCompletionBlock> *pendingChanges;
+@property (nonatomic, assign) NSUInteger numberOfListingRequests;
+@property (nonatomic, assign) NSUInteger numberOfMembershipRequests;
+@end
+
+@implementation FavouriteManagerTestService
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.favoriteNodes = @[];
+        self.pendingChanges = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (AlfrescoRequest *)addFavorite:(AlfrescoNode *)node completionBlock:(AlfrescoFavoritedCompletionBlock)completionBlock
+{
+    [self.pendingChanges addObject:[completionBlock copy]];
+    return [AlfrescoRequest new];
+}
+
+- (AlfrescoRequest *)removeFavorite:(AlfrescoNode *)node completionBlock:(AlfrescoFavoritedCompletionBlock)completionBlock
+{
+    [self.pendingChanges addObject:[completionBlock copy]];
+    return [AlfrescoRequest new];
+}
+
+- (AlfrescoRequest *)isFavorite:(AlfrescoNode *)node completionBlock:(AlfrescoFavoritedCompletionBlock)completionBlock
+{
+    self.numberOfMembershipRequests++;
+    completionBlock(YES, [self.favoriteNodes containsObject:node], nil);
+    return [AlfrescoRequest new];
+}
+
+- (AlfrescoRequest *)retrieveFavoriteNodesWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    self.numberOfListingRequests++;
+    NSUInteger skipCount = MIN((NSUInteger)listingContext.skipCount, self.favoriteNodes.count);
+    NSUInteger length = MIN((NSUInteger)listingContext.maxItems, self.favoriteNodes.count - skipCount);
+    NSArray *page = [self.favoriteNodes subarrayWithRange:NSMakeRange(skipCount, length)];
+    BOOL hasMoreItems = skipCount + length < self.favoriteNodes.count;
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        completionBlock([[AlfrescoPagingResult alloc] initWithArray:page hasMoreItems:hasMoreItems totalItems:(int)self.favoriteNodes.count], nil);
+    });
+    return [AlfrescoRequest new];
+}
+
+- (AlfrescoRequest *)retrieveFavoriteDocumentsWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    return [self retrieveFavoriteNodesWithListingContext:listingContext completionBlock:completionBlock];
+}
+
+- (AlfrescoRequest *)retrieveFavoriteFoldersWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    return [self retrieveFavoriteNodesWithListingContext:listingContext completionBlock:completionBlock];
+}
+
+- (void)clear
+{
+}
+
+- (void)answerPendingChangeSucceeding:(BOOL)succeeded
+{
+    AlfrescoFavoritedCompletionBlock completionBlock = self.pendingChanges.firstObject;
+    [self.pendingChanges removeObjectAtIndex:0];
+    NSError *error = succeeded ? nil : [NSError errorWithDomain:kAlfrescoErrorDomainName code:kAlfrescoErrorCodeUnknown userInfo:nil];
+    completionBlock(succeeded, succeeded, error);
+}
+
+@end
+
+@interface FavouriteManagerTest ()
+@property (nonatomic, strong) FavouriteManagerTestService *service;
+@property (nonatomic, strong) FavouritesIndex *index;
+@property (nonatomic, strong) FavouriteManager *favouriteManager;
+@end
+
+@implementation FavouriteManagerTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.service = [FavouriteManagerTestService new];
+    self.index = [[FavouritesIndex alloc] initWithFilePath:nil];
+    self.favouriteManager = [[FavouriteManager alloc] initWithService:self.service favouritesIndex:self.index];
+}
+
+- (AlfrescoNode *)nodeWithNumber:(NSUInteger)number
+{
+    NSString *identifier = [NSString stringWithFormat:@"workspace://SpacesStore/%lu;1.0", (unsigned long)number];
+    return [[AlfrescoDocument alloc] initWithProperties:@{kCMISPropertyObjectId : identifier,
+                                                          kCMISPropertyName : [NSString stringWithFormat:@"%lu.txt", (unsigned long)number],
+                                                          kCMISPropertyObjectTypeId : @"cmis:document"}];
+}
+
+- (NSArray *)nodesWithCount:(NSUInteger)count
+{
+    NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger number = 0; number < count; number++)
+    {
+        [nodes addObject:[self nodeWithNumber:number]];
+    }
+    return nodes;
+}
+
+- (void)refreshFavorites
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Favourites refreshed"];
+    [self.favouriteManager refreshFavoritesWithSession:nil completionBlock:^(BOOL succeeded, NSError *error) {
+        XCTAssertTrue(succeeded);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (BOOL)isFavorite:(AlfrescoNode *)node
+{
+    BOOL isFavorite = NO;
+    XCTAssertTrue([self.favouriteManager cachedFavoriteStatusOfNode:node isFavorite:&isFavorite]);
+    return isFavorite;
+}
+
+- (void)testRefreshAnswersMembershipWithoutRequests
+{
+    self.service.favoriteNodes = [self nodesWithCount:250];
+    [self refreshFavorites];
+    
+    XCTAssertEqual(self.service.numberOfListingRequests, 3);
+    XCTAssertTrue(self.index.isComplete);
+    
+    __block BOOL answeredSynchronously = NO;
+    [self.favouriteManager isNodeFavorite:[self nodeWithNumber:10] session:nil completionBlock:^(BOOL isFavorite, NSError *error) {
+        XCTAssertTrue(isFavorite);
+        answeredSynchronously = YES;
+    }];
+    XCTAssertTrue(answeredSynchronously);
+    XCTAssertFalse([self isFavorite:[self nodeWithNumber:300]]);
+    XCTAssertEqual(self.service.numberOfMembershipRequests, 0);
+}
+
+- (void)testOtherVersionsOfAFavouriteMatch
+{
+    [self.index replaceAllNodeIdentifiers:@[@"workspace://SpacesStore/1;1.0"]];
+    XCTAssertTrue([self.index containsNodeWithIdentifier:@"workspace://SpacesStore/1;2.0"]);
+    XCTAssertTrue([self.index containsNodeWithIdentifier:@"workspace://SpacesStore/1"]);
+}
+
+- (void)testAddingAFavouriteIsAppliedOptimistically
+{
+    [self refreshFavorites];
+    AlfrescoNode *node = [self nodeWithNumber:1];
+    
+    __block NSUInteger numberOfNotifications = 0;
+    id observer = [[NSNotificationCenter defaultCenter] addObserverForName:kFavouritesDidAddNodeNotification object:node queue:nil usingBlock:^(NSNotification *notification) {
+        numberOfNotifications++;
+    }];
+    __block BOOL completed = NO;
+    [self.favouriteManager addFavorite:node session:nil completionBlock:^(BOOL succeeded, NSError *error) {
+        XCTAssertTrue(succeeded);
+        completed = YES;
+    }];
+    
+    // Before the server has answered, the index already has the node but observers refetching the list are not told yet
+    XCTAssertTrue([self isFavorite:node]);
+    XCTAssertFalse(completed);
+    XCTAssertEqual(numberOfNotifications, 0);
+    
+    [self.service answerPendingChangeSucceeding:YES];
+    XCTAssertTrue(completed);
+    XCTAssertTrue([self isFavorite:node]);
+    XCTAssertEqual(numberOfNotifications, 1);
+    [[NSNotificationCenter defaultCenter] removeObserver:observer];
+}
+
+- (void)testRemovalIsAnnouncedOnceTheServerSucceeds
+{
+    self.service.favoriteNodes = [self nodesWithCount:2];
+    [self refreshFavorites];
+    AlfrescoNode *node = [self nodeWithNumber:1];
+    
+    __block NSUInteger numberOfNotifications = 0;
+    id observer = [[NSNotificationCenter defaultCenter] addObserverForName:kFavouritesDidRemoveNodeNotification object:node queue:nil usingBlock:^(NSNotification *notification) {
+        numberOfNotifications++;
+    }];
+    [self.favouriteManager removeFavorite:node session:nil completionBlock:nil];
+    XCTAssertFalse([self isFavorite:node]);
+    XCTAssertEqual(numberOfNotifications, 0);
+    
+    [self.service answerPendingChangeSucceeding:YES];
+    XCTAssertEqual(numberOfNotifications, 1);
+    [[NSNotificationCenter defaultCenter] removeObserver:observer];
+}
+
+- (void)testFailedAddIsRolledBack
+{
+    [self refreshFavorites];
+    AlfrescoNode *node = [self nodeWithNumber:1];
+    [self.favouriteManager addFavorite:node session:nil completionBlock:nil];
+    XCTAssertTrue([self isFavorite:node]);
+    
+    [self expectationForNotification:kFavouritesDidRemoveNodeNotification object:node handler:nil];
+    [self.service answerPendingChangeSucceeding:NO];
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertFalse([self isFavorite:node]);
+}
+
+- (void)testFailedRemoveIsRolledBack
+{
+    self.service.favoriteNodes = [self nodesWithCount:2];
+    [self refreshFavorites];
+    AlfrescoNode *node = [self nodeWithNumber:1];
+    
+    [self.favouriteManager removeFavorite:node session:nil completionBlock:nil];
+    XCTAssertFalse([self isFavorite:node]);
+    
+    [self expectationForNotification:kFavouritesDidAddNodeNotification object:node handler:nil];
+    [self.service answerPendingChangeSucceeding:NO];
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+    
+    XCTAssertTrue([self isFavorite:node]);
+}
+
+- (void)testChangesInFlightSurviveARefresh
+{
+    self.service.favoriteNodes = [self nodesWithCount:2];
+    AlfrescoNode *addedNode = [self nodeWithNumber:5];
+    [self.favouriteManager addFavorite:addedNode session:nil completionBlock:nil];
+    
+    [self refreshFavorites];
+    XCTAssertTrue([self isFavorite:addedNode]);
+    
+    [self.service answerPendingChangeSucceeding:YES];
+    XCTAssertTrue([self isFavorite:addedNode]);
+}
+
+- (void)testIndexIsPersisted
+{
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    FavouritesIndex *index = [[FavouritesIndex alloc] initWithFilePath:filePath];
+    [index replaceAllNodeIdentifiers:@[@"workspace://SpacesStore/1", @"workspace://SpacesStore/2"]];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Index written"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.5 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    
+    FavouritesIndex *reloadedIndex = [[FavouritesIndex alloc] initWithFilePath:filePath];
+    XCTAssertTrue(reloadedIndex.isComplete);
+    XCTAssertEqual(reloadedIndex.count, 2);
+    XCTAssertTrue([reloadedIndex containsNodeWithIdentifier:@"workspace://SpacesStore/2"]);
+    
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+}
+
+- (void)testPerformanceCheckingMembershipOfManyFavourites
+{
+    NSArray *nodes = [self nodesWithCount:kFavouriteManagerTestBenchmarkFavouriteCount];
+    [self.index replaceAllNodeIdentifiers:[nodes valueForKey:@"identifier"]];
+    
+    [self measureBlock:^{
+        NSUInteger favoriteCount = 0;
+        for (AlfrescoNode *node in nodes)
+        {
+            BOOL isFavorite = NO;
+            [self.favouriteManager cachedFavoriteStatusOfNode:node isFavorite:&isFavorite];
+            favoriteCount += isFavorite;
+        }
+        XCTAssertEqual(favoriteCount, kFavouriteManagerTestBenchmarkFavouriteCount);
+    }];
+    XCTAssertEqual(self.service.numberOfMembershipRequests, 0);
+}
+
+@end
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import <ImageIO/ImageIO.h>
+#import "ImageDecodingTest.h"
+#import "Utility.h"
+
+@implementation ImageDecodingTest
+
+- (UIImage *)imageWithScale:(CGFloat)scale
+{
+    UIGraphicsImageRendererFormat *format = [UIGraphicsImageRendererFormat preferredFormat];
+    format.scale = scale;
+    UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:CGSizeMake(20, 10) format:format];
+    return [renderer imageWithActions:^(UIGraphicsImageRendererContext *rendererContext) {
+        [[UIColor redColor] setFill];
+        [rendererContext fillRect:CGRectMake(0, 0, 20, 10)];
+    }];
+}
+
+- (void)testDecodedImageKeepsScaleAndSize
+{
+    UIImage *image = [self imageWithScale:3];
+    UIImage *decodedImage = [Utility decodedImage:image];
+    
+    XCTAssertEqual(decodedImage.scale, 3);
+    XCTAssertTrue(CGSizeEqualToSize(decodedImage.size, image.size));
+}
+
+- (void)testDecodedImageKeepsRenderingMode
+{
+    UIImage *templateImage = [[self imageWithScale:2] imageWithRenderingMode:UIImageRenderingModeAlwaysTemplate];
+    XCTAssertEqual([Utility decodedImage:templateImage].renderingMode, UIImageRenderingModeAlwaysTemplate);
+    
+    UIImage *originalImage = [[self imageWithScale:2] imageWithRenderingMode:UIImageRenderingModeAlwaysOriginal];
+    XCTAssertEqual([Utility decodedImage:originalImage].renderingMode, UIImageRenderingModeAlwaysOriginal);
+}
+
+- (void)testNoImageDecodesToNil
+{
+    XCTAssertNil([Utility decodedImage:nil]);
+}
+
+- (void)testWrittenImageKeepsExifGPSAndTIFFMetadata
+{
+    NSData *imageData = UIImageJPEGRepresentation([self imageWithScale:1], 0.9);
+    NSDictionary *metadata = @{(NSString *)kCGImagePropertyOrientation : @6,
+                               (NSString *)kCGImagePropertyExifDictionary : @{(NSString *)kCGImagePropertyExifDateTimeOriginal : @"2020:01:02 03:04:05",
+                                                                              (NSString *)kCGImagePropertyExifLensModel : @"Test Lens"},
+                               (NSString *)kCGImagePropertyGPSDictionary : @{(NSString *)kCGImagePropertyGPSLatitude : @51.5,
+                                                                             (NSString *)kCGImagePropertyGPSLatitudeRef : @"N",
+                                                                             (NSString *)kCGImagePropertyGPSLongitude : @0.12,
+                                                                             (NSString *)kCGImagePropertyGPSLongitudeRef : @"W"},
+                               (NSString *)kCGImagePropertyTIFFDictionary : @{(NSString *)kCGImagePropertyTIFFMake : @"Alfresco",
+                                                                              (NSString *)kCGImagePropertyTIFFModel : @"Test Camera"}};
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.jpg", [NSUUID UUID].UUIDString]];
+    
+    XCTAssertTrue([Utility writeImageData:imageData metadata:metadata toFilePath:filePath]);
+    
+    CGImageSourceRef imageSource = CGImageSourceCreateWithURL((__bridge CFURLRef)[NSURL fileURLWithPath:filePath], NULL);
+    NSDictionary *properties = CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(imageSource, 0, NULL));
+    CFRelease(imageSource);
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+    
+    XCTAssertEqualObjects(properties[(NSString *)kCGImagePropertyOrientation], @6);
+    NSDictionary *exif = properties[(NSString *)kCGImagePropertyExifDictionary];
+    XCTAssertEqualObjects(exif[(NSString *)kCGImagePropertyExifDateTimeOriginal], @"2020:01:02 03:04:05");
+    XCTAssertEqualObjects(exif[(NSString *)kCGImagePropertyExifLensModel], @"Test Lens");
+    NSDictionary *gps = properties[(NSString *)kCGImagePropertyGPSDictionary];
+    XCTAssertEqualWithAccuracy([gps[(NSString *)kCGImagePropertyGPSLatitude] doubleValue], 51.5, 0.0001);
+    XCTAssertEqualObjects(gps[(NSString *)kCGImagePropertyGPSLatitudeRef], @"N");
+    XCTAssertEqualWithAccuracy([gps[(NSString *)kCGImagePropertyGPSLongitude] doubleValue], 0.12, 0.0001);
+    XCTAssertEqualObjects(gps[(NSString *)kCGImagePropertyGPSLongitudeRef], @"W");
+    NSDictionary *tiff = properties[(NSString *)kCGImagePropertyTIFFDictionary];
+    XCTAssertEqualObjects(tiff[(NSString *)kCGImagePropertyTIFFMake], @"Alfresco");
+    XCTAssertEqualObjects(tiff[(NSString *)kCGImagePropertyTIFFModel], @"Test Camera");
+}
+
+@end
@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "LaunchPipelineTest.h"
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "LaunchPipeline.h"
+#import "AppDelegate.h"
+
+/**
+ * Simulated launch work, in milliseconds, modelled on the stages the app delegate runs.
+ */
+static useconds_t const kSimulatedAccountsStageDuration = 15;
+static useconds_t const kSimulatedUserInterfaceStageDuration = 25;
+static useconds_t const kSimulatedSecurityStageDuration = 5;
+static useconds_t const kSimulatedDownloadsMigrationDuration = 40;
+static useconds_t const kSimulatedCacheCleanupDuration = 60;
+static useconds_t const kSimulatedSyncMigrationDuration = 50;
+
+@implementation LaunchPipelineTest
+
+- (void (^)(void))blockRecordingName:(NSString *)name intoLog:(NSMutableArray *)log sleeping:(useconds_t)milliseconds
+{
+    return ^{
+        usleep(milliseconds * 1000);
+        @synchronized (log)
+        {
+            [log addObject:@{@"name" : name, @"mainThread" : @([NSThread isMainThread])}];
+        }
+    };
+}
+
+- (LaunchPipeline *)simulatedLaunchPipelineWithLog:(NSMutableArray *)log
+{
+    LaunchPipeline *pipeline = [[LaunchPipeline alloc] init];
+    [pipeline addStageWithName:@"Accounts" phase:LaunchStagePhaseCritical dependencies:nil block:[self blockRecordingName:@"Accounts" intoLog:log sleeping:kSimulatedAccountsStageDuration]];
+    [pipeline addStageWithName:@"UserInterface" phase:LaunchStagePhaseCritical dependencies:@[@"Accounts"] block:[self blockRecordingName:@"UserInterface" intoLog:log sleeping:kSimulatedUserInterfaceStageDuration]];
+    [pipeline addStageWithName:@"Security" phase:LaunchStagePhaseCritical dependencies:@[@"UserInterface"] block:[self blockRecordingName:@"Security" intoLog:log sleeping:kSimulatedSecurityStageDuration]];
+    [pipeline addStageWithName:@"DownloadsMigration" phase:LaunchStagePhaseBackground dependencies:nil block:[self blockRecordingName:@"DownloadsMigration" intoLog:log sleeping:kSimulatedDownloadsMigrationDuration]];
+    [pipeline addStageWithName:@"CacheCleanup" phase:LaunchStagePhaseBackground dependencies:nil block:[self blockRecordingName:@"CacheCleanup" intoLog:log sleeping:kSimulatedCacheCleanupDuration]];
+    [pipeline addStageWithName:@"SyncMigration" phase:LaunchStagePhaseDeferred dependencies:@[@"Accounts", @"DownloadsMigration"] block:[self blockRecordingName:@"SyncMigration" intoLog:log sleeping:kSimulatedSyncMigrationDuration]];
+    return pipeline;
+}
+
+- (NSUInteger)indexOfStage:(NSString *)name inLog:(NSArray *)log
+{
+    return [[log valueForKey:@"name"] indexOfObject:name];
+}
+
+- (void)testStagesRunInDependencyOrderOnTheirThreads
+{
+    NSMutableArray *log = [NSMutableArray array];
+    LaunchPipeline *pipeline = [self simulatedLaunchPipelineWithLog:log];
+    
+    XCTestExpectation *finishedExpectation = [self expectationWithDescription:@"Deferred stage finished"];
+    [pipeline addStageWithName:@"Login" phase:LaunchStagePhaseDeferred dependencies:@[@"Security", @"SyncMigration"] block:^{
+        [finishedExpectation fulfill];
+    }];
+    
+    [pipeline runCriticalStages];
+    NSArray *criticalStages = [log filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"mainThread == YES"]];
+    XCTAssertEqualObjects([criticalStages valueForKey:@"name"], (@[@"Accounts", @"UserInterface", @"Security"]));
+    XCTAssertEqual([self indexOfStage:@"SyncMigration" inLog:log], NSNotFound, @"Deferred stages should not run with the critical ones");
+    
+    [pipeline runDeferredStages];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    for (NSDictionary *entry in log)
+    {
+        BOOL isBackgroundStage = [@[@"DownloadsMigration", @"CacheCleanup"] containsObject:entry[@"name"]];
+        XCTAssertEqual([entry[@"mainThread"] boolValue], !isBackgroundStage, @"%@ ran on the wrong thread", entry[@"name"]);
+    }
+    XCTAssertGreaterThan([self indexOfStage:@"SyncMigration" inLog:log], [self indexOfStage:@"DownloadsMigration" inLog:log]);
+    XCTAssertEqual(pipeline.stageDurations.count, 7);
+}
+
+- (void)testCriticalPathOnlyWaitsForCriticalStages
+{
+    LaunchPipeline *pipeline = [self simulatedLaunchPipelineWithLog:[NSMutableArray array]];
+    [pipeline runCriticalStages];
+    
+    NSTimeInterval criticalWork = (kSimulatedAccountsStageDuration + kSimulatedUserInterfaceStageDuration + kSimulatedSecurityStageDuration) / 1000.0;
+    NSTimeInterval serialWork = criticalWork + (kSimulatedDownloadsMigrationDuration + kSimulatedCacheCleanupDuration + kSimulatedSyncMigrationDuration) / 1000.0;
+    XCTAssertGreaterThanOrEqual(pipeline.criticalPathDuration, criticalWork);
+    XCTAssertLessThan(pipeline.criticalPathDuration, serialWork);
+    
+    [pipeline waitUntilBackgroundStagesFinished];
+}
+
+#pragma mark - Performance
+
+/*
+ * Runs the app delegate's own critical stages, measured to the end of the critical path. The test host has already launched,
+ * so this excludes process start-up and works against warm caches.
+ */
+- (void)testCriticalPathPerformance
+{
+    AppDelegate *appDelegate = (AppDelegate *)[UIApplication sharedApplication].delegate;
+    
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        LaunchPipeline *pipeline = [[LaunchPipeline alloc] init];
+        [appDelegate addLaunchStagesToPipeline:pipeline safeMode:NO isFirstLaunch:NO launchOptions:nil];
+        [self startMeasuring];
+        [pipeline runCriticalStages];
+        [self stopMeasuring];
+        [pipeline waitUntilBackgroundStagesFinished];
+        
+        for (NSString *stageName in @[@"Accounts", @"LocalContent", @"UserInterface", @"Security"])
+        {
+            XCTAssertNotNil(pipeline.stageDurations[stageName], @"%@ didn't run on the critical path", stageName);
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,207 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "LocalSearchIndexTest.h"
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "LocalSearchIndex.h"
+
+static NSUInteger const kLocalSearchIndexTestDocumentCount = 100000;
+static NSString * const kLocalSearchIndexTestAccount = @"test-account";
+
+@implementation LocalSearchIndexTest
+
+- (LocalSearchIndexEntry *)entryWithIndex:(NSUInteger)index
+{
+    static NSArray *words = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        words = @[@"budget", @"contract", @"invoice", @"meeting", @"minutes", @"proposal", @"quarterly", @"report", @"roadmap", @"specification"];
+    });
+    
+    LocalSearchIndexEntry *entry = [LocalSearchIndexEntry new];
+    entry.identifier = [NSString stringWithFormat:@"workspace://SpacesStore/node-%lu", (unsigned long)index];
+    entry.scope = kLocalSearchIndexTestAccount;
+    entry.source = LocalSearchIndexSourceSynced;
+    entry.name = [NSString stringWithFormat:@"%@ %@ %lu.docx", words[index % words.count], words[(index / words.count) % words.count], (unsigned long)index];
+    entry.title = [NSString stringWithFormat:@"Project %lu", (unsigned long)(index % 500)];
+    entry.summary = [NSString stringWithFormat:@"Owned by team %lu", (unsigned long)(index % 37)];
+    entry.mimeType = @"application/vnd.openxmlformats-officedocument.wordprocessingml.document";
+    entry.path = [NSString stringWithFormat:@"Sites/site-%lu/documentLibrary", (unsigned long)(index % 50)];
+    return entry;
+}
+
+- (LocalSearchIndex *)indexWithDocumentCount:(NSUInteger)count
+{
+    NSMutableArray *entries = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger index = 0; index < count; index++)
+    {
+        [entries addObject:[self entryWithIndex:index]];
+    }
+    
+    LocalSearchIndex *index = [[LocalSearchIndex alloc] initWithFilePath:nil];
+    [index indexEntries:entries];
+    return index;
+}
+
+- (void)testTokensAreFoldedAndSplit
+{
+    NSArray *tokens = [LocalSearchIndex tokensFromString:@"Résumé_Final-v2 (Copy).PDF"];
+    XCTAssertEqualObjects(tokens, (@[@"resume", @"final", @"v2", @"copy", @"pdf"]));
+}
+
+- (void)testPrefixAndFuzzyMatching
+{
+    LocalSearchIndex *index = [self indexWithDocumentCount:1000];
+    
+    NSArray *prefixMatches = [index entriesMatchingQuery:@"quart rep" inScopes:@[kLocalSearchIndexTestAccount] limit:NSUIntegerMax];
+    XCTAssertEqual(prefixMatches.count, 20);
+    for (LocalSearchIndexEntry *entry in prefixMatches)
+    {
+        XCTAssertTrue([entry.name containsString:@"quarterly"] && [entry.name containsString:@"report"]);
+    }
+    
+    NSArray *fuzzyMatches = [index entriesMatchingQuery:@"specfication" inScopes:@[kLocalSearchIndexTestAccount] limit:NSUIntegerMax];
+    XCTAssertEqual(fuzzyMatches.count, 190, @"A misspelt word should still match");
+    
+    XCTAssertEqual([index entriesMatchingQuery:@"invoice" inScopes:@[kLocalSearchIndexDownloadsScope] limit:NSUIntegerMax].count, 0, @"Other scopes should not match");
+    XCTAssertEqual([index entriesMatchingQuery:@"invoice" inScopes:@[kLocalSearchIndexTestAccount] limit:5].count, 5);
+}
+
+- (void)testNameMatchesRankFirst
+{
+    LocalSearchIndex *index = [[LocalSearchIndex alloc] initWithFilePath:nil];
+    LocalSearchIndexEntry *summaryMatch = [self entryWithIndex:0];
+    summaryMatch.name = @"A.txt";
+    summaryMatch.summary = @"Agenda for the board";
+    LocalSearchIndexEntry *nameMatch = [self entryWithIndex:1];
+    nameMatch.name = @"Board agenda.txt";
+    [index indexEntries:@[summaryMatch, nameMatch]];
+    
+    NSArray *matches = [index entriesMatchingQuery:@"agenda" inScopes:@[kLocalSearchIndexTestAccount] limit:10];
+    XCTAssertEqualObjects([matches valueForKey:@"name"], (@[@"Board agenda.txt", @"A.txt"]));
+}
+
+- (void)testUpdatesAndRemovalsReplacePostings
+{
+    LocalSearchIndex *index = [[LocalSearchIndex alloc] initWithFilePath:nil];
+    LocalSearchIndexEntry *entry = [self entryWithIndex:0];
+    entry.name = @"Draft.txt";
+    [index indexEntries:@[entry]];
+    
+    LocalSearchIndexEntry *renamedEntry = [self entryWithIndex:0];
+    renamedEntry.name = @"Final.txt";
+    [index indexEntries:@[renamedEntry]];
+    
+    XCTAssertEqual(index.numberOfEntries, 1);
+    XCTAssertEqual([index entriesMatchingQuery:@"draft" inScopes:@[kLocalSearchIndexTestAccount] limit:10].count, 0);
+    XCTAssertEqual([index entriesMatchingQuery:@"final" inScopes:@[kLocalSearchIndexTestAccount] limit:10].count, 1);
+    
+    [index removeEntryWithIdentifier:renamedEntry.identifier scope:kLocalSearchIndexTestAccount];
+    XCTAssertEqual([index entriesMatchingQuery:@"final" inScopes:@[kLocalSearchIndexTestAccount] limit:10].count, 0);
+    XCTAssertEqual(index.numberOfEntries, 0);
+}
+
+- (void)testRemovalIsNotUndoneByEarlierContentIndexing
+{
+    NSString *contentPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    [@"Minutes of the steering committee" writeToFile:contentPath atomically:YES encoding:NSUTF8StringEncoding error:nil];
+    
+    LocalSearchIndex *index = [[LocalSearchIndex alloc] initWithFilePath:nil];
+    LocalSearchIndexEntry *entry = [self entryWithIndex:0];
+    entry.mimeType = @"text/plain";
+    
+    // The content is read in the background, so the removal is made while the entry is still being indexed
+    [index indexEntry:entry contentPath:contentPath];
+    [index removeEntryWithIdentifier:entry.identifier scope:kLocalSearchIndexTestAccount];
+    
+    XCTAssertEqual([index entriesMatchingQuery:@"steering" inScopes:@[kLocalSearchIndexTestAccount] limit:10].count, 0);
+    XCTAssertEqual(index.numberOfEntries, 0);
+    [[NSFileManager defaultManager] removeItemAtPath:contentPath error:nil];
+}
+
+- (void)testRemovedEntriesAreCompacted
+{
+    NSUInteger documentCount = 2000;
+    NSUInteger removedCount = 1500;
+    LocalSearchIndex *index = [self indexWithDocumentCount:documentCount];
+    for (NSUInteger entryIndex = 0; entryIndex < removedCount; entryIndex++)
+    {
+        [index removeEntryWithIdentifier:[self entryWithIndex:entryIndex].identifier scope:kLocalSearchIndexTestAccount];
+    }
+    
+    XCTAssertEqual(index.numberOfEntries, documentCount - removedCount);
+    XCTAssertLessThan([[index valueForKey:@"entries"] count], documentCount, @"Removed entries should not all be kept");
+    
+    // Renumbered entries are still found, and only those left
+    NSUInteger expectedCount = 0;
+    for (NSUInteger entryIndex = removedCount; entryIndex < documentCount; entryIndex++)
+    {
+        expectedCount += [[self entryWithIndex:entryIndex].name containsString:@"invoice"] ? 1 : 0;
+    }
+    NSArray *matches = [index entriesMatchingQuery:@"invoice" inScopes:@[kLocalSearchIndexTestAccount] limit:NSUIntegerMax];
+    XCTAssertEqual(matches.count, expectedCount);
+    for (LocalSearchIndexEntry *entry in matches)
+    {
+        XCTAssertGreaterThanOrEqual([entry.identifier.lastPathComponent stringByReplacingOccurrencesOfString:@"node-" withString:@""].integerValue, removedCount);
+    }
+}
+
+#pragma mark - Performance
+
+- (void)testIndexingLargeCollectionPerformance
+{
+    NSMutableArray *entries = [NSMutableArray arrayWithCapacity:kLocalSearchIndexTestDocumentCount];
+    for (NSUInteger index = 0; index < kLocalSearchIndexTestDocumentCount; index++)
+    {
+        [entries addObject:[self entryWithIndex:index]];
+    }
+    
+    [self measureBlock:^{
+        LocalSearchIndex *index = [[LocalSearchIndex alloc] initWithFilePath:nil];
+        [index indexEntries:entries];
+        XCTAssertEqual(index.numberOfEntries, kLocalSearchIndexTestDocumentCount);
+    }];
+}
+
+- (void)testPrefixQueryOverLargeCollectionPerformance
+{
+    LocalSearchIndex *index = [self indexWithDocumentCount:kLocalSearchIndexTestDocumentCount];
+    [index entriesMatchingQuery:@"warm up" inScopes:@[kLocalSearchIndexTestAccount] limit:50];
+    
+    [self measureBlock:^{
+        for (NSString *query in @[@"q", @"qua", @"quarterly rep", @"project 12", @"site-4 budget"])
+        {
+            [index entriesMatchingQuery:query inScopes:@[kLocalSearchIndexTestAccount] limit:50];
+        }
+    }];
+}
+
+- (void)testFuzzyQueryOverLargeCollectionPerformance
+{
+    LocalSearchIndex *index = [self indexWithDocumentCount:kLocalSearchIndexTestDocumentCount];
+    [index entriesMatchingQuery:@"warm up" inScopes:@[kLocalSearchIndexTestAccount] limit:50];
+    
+    [self measureBlock:^{
+        for (NSString *query in @[@"quartely", @"specfication", @"rodmap", @"contrcat"])
+        {
+            [index entriesMatchingQuery:query inScopes:@[kLocalSearchIndexTestAccount] limit:50];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "NodeCellViewModelBuilderTest.h"
+#import "NodeCellViewModelBuilder.h"
+
+static NSTimeInterval const kNodeCellViewModelBuilderTestTimeout = 5;
+
+@interface NodeCellViewModelBuilderTest ()
+@property (nonatomic, strong) NodeCellViewModelBuilder *builder;
+@property (nonatomic, strong) NSMutableArray<NodeCellViewModel *> *updatedViewModels;
+@end
+
+@implementation NodeCellViewModelBuilderTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.builder = [[NodeCellViewModelBuilder alloc] initWithSession:nil];
+    // Keeps the favourite lookups off the server
+    self.builder.nodesAreFavorites = YES;
+    self.updatedViewModels = [NSMutableArray array];
+    __weak typeof(self) weakSelf = self;
+    self.builder.viewModelsUpdatedBlock = ^(NSArray<NodeCellViewModel *> *viewModels) {
+        [weakSelf.updatedViewModels addObjectsFromArray:viewModels];
+    };
+}
+
+- (AlfrescoNode *)folderWithName:(NSString *)name
+{
+    NSDictionary *properties = @{kCMISPropertyObjectId : @"workspace://SpacesStore/folder",
+                                 kCMISPropertyName : name,
+                                 kCMISPropertyObjectTypeId : @"cmis:folder"};
+    return [[AlfrescoFolder alloc] initWithProperties:properties];
+}
+
+- (void)waitForBuiltViewModelOfNode:(AlfrescoNode *)node
+{
+    NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(NodeCellViewModelBuilderTest *test, NSDictionary *bindings) {
+        for (NodeCellViewModel *viewModel in test.updatedViewModels)
+        {
+            if (viewModel.node == node && !viewModel.isPlaceholder)
+            {
+                return YES;
+            }
+        }
+        return NO;
+    }];
+    [self expectationForPredicate:predicate evaluatedWithObject:self handler:nil];
+    [self waitForExpectationsWithTimeout:kNodeCellViewModelBuilderTestTimeout handler:nil];
+}
+
+- (void)testPlaceholderIsReplacedByBuiltViewModel
+{
+    AlfrescoNode *node = [self folderWithName:@"Reports"];
+    NodeCellViewModel *placeholder = [self.builder viewModelForNode:node];
+    XCTAssertTrue(placeholder.isPlaceholder);
+    
+    [self waitForBuiltViewModelOfNode:node];
+    
+    NodeCellViewModel *viewModel = [self.builder viewModelForNode:node];
+    XCTAssertNotEqual(viewModel, placeholder);
+    XCTAssertFalse(viewModel.isPlaceholder);
+    XCTAssertTrue(viewModel.isFavorite);
+    XCTAssertEqual(self.updatedViewModels.count, 1);
+}
+
+- (void)testNodeChangedDuringBuildIsBuiltAgain
+{
+    NSOperationQueue *buildQueue = [self.builder valueForKey:@"buildQueue"];
+    AlfrescoNode *originalNode = [self folderWithName:@"Reports"];
+    AlfrescoNode *renamedNode = [self folderWithName:@"Reports 2020"];
+    
+    // Hold the first build until the listing has moved on to the renamed node
+    buildQueue.suspended = YES;
+    [self.builder prepareViewModelsForNodes:@[originalNode]];
+    [self.builder prepareViewModelsForNodes:@[renamedNode]];
+    buildQueue.suspended = NO;
+    
+    [self waitForBuiltViewModelOfNode:renamedNode];
+    
+    NodeCellViewModel *viewModel = [self.builder viewModelForNode:renamedNode];
+    XCTAssertEqual(viewModel.node, renamedNode);
+    XCTAssertFalse(viewModel.isPlaceholder);
+    // The stale result for the original node is never handed out
+    XCTAssertEqual([self.updatedViewModels filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"node == %@", originalNode]].count, 0);
+}
+
+@end
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "NodeCollectionTest.h"
+#import "NodeCollection.h"
+
+static NSUInteger const kNodeCollectionTestFolderSize = 10000;
+static NSUInteger const kNodeCollectionTestPageSize = 50;
+
+/**
+ * Stand-in for AlfrescoNode exposing the properties the collection and diff read.
+ */
+@interface NodeCollectionTestNode : NSObject
+@property (nonatomic, strong) NSString *identifier;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSDate *modifiedAt;
+@end
+
+@implementation NodeCollectionTestNode
+
++ (instancetype)nodeWithIndex:(NSUInteger)index
+{
+    NodeCollectionTestNode *node = [self new];
+    node.identifier = [NSString stringWithFormat:@"workspace://SpacesStore/node-%lu;1.0", (unsigned long)index];
+    node.name = [NSString stringWithFormat:@"Document %lu.txt", (unsigned long)index];
+    node.modifiedAt = [NSDate dateWithTimeIntervalSince1970:index];
+    return node;
+}
+
+@end
+
+@implementation NodeCollectionTest
+
+- (NSArray *)nodesInRange:(NSRange)range
+{
+    NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:range.length];
+    for (NSUInteger index = range.location; index < NSMaxRange(range); index++)
+    {
+        [nodes addObject:[NodeCollectionTestNode nodeWithIndex:index]];
+    }
+    return nodes;
+}
+
+- (void)testIdentifierLookupFollowsMutations
+{
+    NodeCollection *collection = [[NodeCollection alloc] initWithArray:[self nodesInRange:NSMakeRange(0, 10)]];
+    
+    XCTAssertEqual([collection indexOfNodeWithIdentifier:@"workspace://SpacesStore/node-4;1.0"], 4);
+    XCTAssertEqual([collection indexOfNodeWithIdentifier:@"workspace://SpacesStore/node-4;1.3"], 4, @"The version label should be ignored");
+    
+    [collection insertObject:[NodeCollectionTestNode nodeWithIndex:99] atIndex:0];
+    XCTAssertEqual([collection indexOfNodeWithIdentifier:@"workspace://SpacesStore/node-4"], 5);
+    XCTAssertEqual([collection indexOfNodeWithIdentifier:@"workspace://SpacesStore/node-99"], 0);
+    
+    [collection removeObjectAtIndex:1];
+    XCTAssertEqual([collection indexOfNodeWithIdentifier:@"workspace://SpacesStore/node-0"], NSNotFound);
+    XCTAssertEqual([collection indexOfNodeWithIdentifier:@"workspace://SpacesStore/node-4"], 4);
+    
+    NodeCollectionTestNode *appendedNode = [NodeCollectionTestNode nodeWithIndex:100];
+    [collection addObject:appendedNode];
+    XCTAssertEqual([collection indexOfObject:appendedNode], collection.count - 1);
+}
+
+- (void)testChangesTransformOldNodesIntoNewNodes
+{
+    NSArray *oldNodes = [self nodesInRange:NSMakeRange(0, 6)];
+    NodeCollectionTestNode *renamedNode = [NodeCollectionTestNode nodeWithIndex:2];
+    renamedNode.name = @"Renamed.txt";
+    // delete 0, keep 1, rename 2, move 5 to the front, insert 10
+    NSArray *newNodes = @[oldNodes[5], oldNodes[1], renamedNode, oldNodes[3], oldNodes[4], [NodeCollectionTestNode nodeWithIndex:10]];
+    
+    NodeCollectionChanges *changes = [NodeCollectionChanges changesFromNodes:oldNodes toNodes:newNodes];
+    
+    XCTAssertEqual(changes.previousCount, 6);
+    XCTAssertEqualObjects(changes.deletedIndexPaths, @[[NSIndexPath indexPathForItem:0 inSection:0]]);
+    XCTAssertEqualObjects(changes.insertedIndexPaths, @[[NSIndexPath indexPathForItem:5 inSection:0]]);
+    XCTAssertEqualObjects(changes.reloadedIndexPaths, @[[NSIndexPath indexPathForItem:2 inSection:0]]);
+    XCTAssertEqual(changes.movedIndexPaths.count, 1);
+    XCTAssertEqualObjects(changes.movedIndexPaths.firstObject, (@[[NSIndexPath indexPathForItem:5 inSection:0], [NSIndexPath indexPathForItem:0 inSection:0]]));
+    
+    XCTAssertFalse([NodeCollectionChanges changesFromNodes:oldNodes toNodes:oldNodes].hasChanges);
+}
+
+- (void)testPagingThroughLargeFolderPerformance
+{
+    NSMutableArray *pages = [NSMutableArray array];
+    for (NSUInteger location = 0; location < kNodeCollectionTestFolderSize; location += kNodeCollectionTestPageSize)
+    {
+        [pages addObject:[self nodesInRange:NSMakeRange(location, kNodeCollectionTestPageSize)]];
+    }
+    
+    [self measureBlock:^{
+        NodeCollection *collection = [NodeCollection new];
+        for (NSArray *page in pages)
+        {
+            NodeCollectionChanges *changes = [NodeCollectionChanges changesAppendingNodeCount:page.count toNodeCount:collection.count];
+            [collection addObjectsFromArray:page];
+            XCTAssertEqual(changes.insertedIndexPaths.count, page.count);
+            
+            // Locate the newest node, as a notification handler would
+            NodeCollectionTestNode *lastNode = page.lastObject;
+            XCTAssertEqual([collection indexOfNodeWithIdentifier:lastNode.identifier], collection.count - 1);
+        }
+    }];
+}
+
+- (void)testRefreshingLargeFolderPerformance
+{
+    NSArray *oldNodes = [self nodesInRange:NSMakeRange(0, kNodeCollectionTestFolderSize)];
+    NSMutableArray *newNodes = [oldNodes mutableCopy];
+    [newNodes removeObjectsInRange:NSMakeRange(100, 100)];
+    [newNodes addObjectsFromArray:[self nodesInRange:NSMakeRange(kNodeCollectionTestFolderSize, 100)]];
+    [newNodes exchangeObjectAtIndex:10 withObjectAtIndex:5000];
+    
+    [self measureBlock:^{
+        NodeCollectionChanges *changes = [NodeCollectionChanges changesFromNodes:oldNodes toNodes:newNodes];
+        XCTAssertEqual(changes.deletedIndexPaths.count, 100);
+        XCTAssertEqual(changes.insertedIndexPaths.count, 100);
+    }];
+}
+
+@end
@@ -0,0 +1,245 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "NodePermissionsPrefetcherTest.h"
+#import "NodePermissionsPrefetcher.h"
+
+/**
+ * Stand-in for the document folder service. Permission requests are held until the test answers them.
+ */
+@interface NodePermissionsPrefetcherTestService : NSObject <NodePermissionsPrefetcherService>
+@property (nonatomic, strong) NSMutableArray<AlfrescoPermissionsCompletionBlock> *pendingRequests;
+@end
+
+@implementation NodePermissionsPrefetcherTestService
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.pendingRequests = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (AlfrescoRequest *)retrievePermissionsOfNode:(AlfrescoNode *)node completionBlock:(AlfrescoPermissionsCompletionBlock)completionBlock
+{
+    [self.pendingRequests addObject:[completionBlock copy]];
+    return [AlfrescoRequest new];
+}
+
+- (void)answerFirstPendingRequest
+{
+    AlfrescoPermissionsCompletionBlock completionBlock = self.pendingRequests.firstObject;
+    [self.pendingRequests removeObjectAtIndex:0];
+    completionBlock([AlfrescoPermissions new], nil);
+}
+
+@end
+
+/**
+ * Stand-in for a service that can look up the permissions of several nodes in one request.
+ */
+@interface NodePermissionsPrefetcherTestBatchService : NodePermissionsPrefetcherTestService
+@property (nonatomic, strong) NSMutableArray<NSArray<AlfrescoNode *> *> *requestedNodeGroups;
+@property (nonatomic, strong) NSMutableArray<NodePermissionsPrefetcherBatchCompletionBlock> *pendingBatchRequests;
+@end
+
+@implementation NodePermissionsPrefetcherTestBatchService
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.requestedNodeGroups = [NSMutableArray array];
+        self.pendingBatchRequests = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (AlfrescoRequest *)retrievePermissionsOfNodes:(NSArray<AlfrescoNode *> *)nodes completionBlock:(NodePermissionsPrefetcherBatchCompletionBlock)completionBlock
+{
+    [self.requestedNodeGroups addObject:nodes];
+    [self.pendingBatchRequests addObject:[completionBlock copy]];
+    return [AlfrescoRequest new];
+}
+
+- (void)answerFirstPendingBatchRequest
+{
+    NSArray *nodes = self.requestedNodeGroups[self.requestedNodeGroups.count - self.pendingBatchRequests.count];
+    NSMutableDictionary *permissionsByNodeIdentifier = [NSMutableDictionary dictionary];
+    for (AlfrescoNode *node in nodes)
+    {
+        permissionsByNodeIdentifier[node.identifier] = [AlfrescoPermissions new];
+    }
+    NodePermissionsPrefetcherBatchCompletionBlock completionBlock = self.pendingBatchRequests.firstObject;
+    [self.pendingBatchRequests removeObjectAtIndex:0];
+    completionBlock(permissionsByNodeIdentifier, nil);
+}
+
+@end
+
+/**
+ * Stand-in for the Realm manager, counting the write transactions that save permissions.
+ */
+@interface NodePermissionsPrefetcherTestRealmManager : NSObject <RealmManagerProtocol>
+@property (nonatomic, assign) NSUInteger numberOfPermissionWrites;
+@property (nonatomic, assign) NSUInteger numberOfPermissionsWritten;
+@end
+
+@implementation NodePermissionsPrefetcherTestRealmManager
+
+- (void)savePermissions:(AlfrescoPermissions *)permissions forNode:(AlfrescoNode *)node
+{
+    [self savePermissions:@[permissions] forNodes:@[node]];
+}
+
+- (void)savePermissions:(NSArray<AlfrescoPermissions *> *)permissions forNodes:(NSArray<AlfrescoNode *> *)nodes
+{
+    self.numberOfPermissionWrites++;
+    self.numberOfPermissionsWritten += permissions.count;
+}
+
+- (void)deleteRealmWithName:(NSString *)realmName {}
+- (RLMRealm *)realmForCurrentThread { return nil; }
+- (void)deleteRealmObject:(RLMObject *)objectToDelete inRealm:(RLMRealm *)realm {}
+- (void)deleteRealmObjects:(NSArray *)objectsToDelete inRealm:(RLMRealm *)realm {}
+- (void)changeDefaultConfigurationForAccount:(UserAccount *)account completionBlock:(void (^)(void))completionBlock {}
+- (void)restoreDefaultConfigurationForAccount:(UserAccount *)account {}
+- (void)resetDefaultRealmConfiguration {}
+- (void)resolvedObstacleForDocument:(AlfrescoDocument *)document inRealm:(RLMRealm *)realm {}
+
+@end
+
+@interface NodePermissionsPrefetcherTest ()
+@property (nonatomic, strong) NodePermissionsPrefetcherTestService *service;
+@property (nonatomic, strong) NodePermissionsPrefetcherTestRealmManager *realmManager;
+@property (nonatomic, strong) NodePermissionsPrefetcher *prefetcher;
+@end
+
+@implementation NodePermissionsPrefetcherTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.service = [NodePermissionsPrefetcherTestService new];
+    self.realmManager = [NodePermissionsPrefetcherTestRealmManager new];
+    self.prefetcher = [[NodePermissionsPrefetcher alloc] initWithRealmManager:self.realmManager service:self.service];
+}
+
+- (NSArray *)nodesWithCount:(NSUInteger)count
+{
+    NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger number = 0; number < count; number++)
+    {
+        NSDictionary *properties = @{kCMISPropertyObjectId : [NSString stringWithFormat:@"workspace://SpacesStore/%lu;1.0", (unsigned long)number],
+                                     kCMISPropertyName : [NSString stringWithFormat:@"%lu.txt", (unsigned long)number],
+                                     kCMISPropertyObjectTypeId : @"cmis:document"};
+        [nodes addObject:[[AlfrescoDocument alloc] initWithProperties:properties]];
+    }
+    return nodes;
+}
+
+- (void)testPermissionsAreDeliveredAsEachNodeResolves
+{
+    NSArray *nodes = [self nodesWithCount:20];
+    NSMutableArray *deliveredIdentifiers = [NSMutableArray array];
+    __block NSDictionary *completedPermissions = nil;
+    
+    [self.prefetcher prefetchPermissionsForNodes:nodes session:nil permissionsBlock:^(NSString *syncIdentifier, AlfrescoPermissions *permissions) {
+        [deliveredIdentifiers addObject:syncIdentifier];
+    } completionBlock:^(NSDictionary *permissionsBySyncIdentifier) {
+        completedPermissions = permissionsBySyncIdentifier;
+    }];
+    
+    // Only as many requests as the limit allows are in flight
+    XCTAssertEqual(self.service.pendingRequests.count, self.prefetcher.maxConcurrentRequests);
+    
+    [self.service answerFirstPendingRequest];
+    XCTAssertEqual(deliveredIdentifiers.count, 1);
+    XCTAssertNil(completedPermissions);
+    XCTAssertEqual(self.realmManager.numberOfPermissionWrites, 0);
+    
+    while (self.service.pendingRequests.count > 0)
+    {
+        XCTAssertLessThanOrEqual(self.service.pendingRequests.count, self.prefetcher.maxConcurrentRequests);
+        [self.service answerFirstPendingRequest];
+    }
+    XCTAssertEqual(deliveredIdentifiers.count, nodes.count);
+    XCTAssertEqual(completedPermissions.count, nodes.count);
+    XCTAssertEqual(self.realmManager.numberOfPermissionWrites, 1);
+    XCTAssertEqual(self.realmManager.numberOfPermissionsWritten, nodes.count);
+}
+
+- (void)testBatchedServiceIsSentGroupsOfNodes
+{
+    NodePermissionsPrefetcherTestBatchService *batchService = [NodePermissionsPrefetcherTestBatchService new];
+    NodePermissionsPrefetcher *prefetcher = [[NodePermissionsPrefetcher alloc] initWithRealmManager:self.realmManager service:batchService];
+    prefetcher.maxConcurrentRequests = 2;
+    prefetcher.maxNodesPerRequest = 10;
+    NSArray *nodes = [self nodesWithCount:45];
+    __block NSDictionary *completedPermissions = nil;
+    
+    [prefetcher prefetchPermissionsForNodes:nodes session:nil permissionsBlock:nil completionBlock:^(NSDictionary *permissionsBySyncIdentifier) {
+        completedPermissions = permissionsBySyncIdentifier;
+    }];
+    
+    XCTAssertEqual(batchService.pendingBatchRequests.count, 2);
+    while (batchService.pendingBatchRequests.count > 0)
+    {
+        [batchService answerFirstPendingBatchRequest];
+    }
+    
+    XCTAssertEqual(batchService.pendingRequests.count, 0);
+    NSMutableArray *groupSizes = [NSMutableArray array];
+    for (NSArray *group in batchService.requestedNodeGroups)
+    {
+        [groupSizes addObject:@(group.count)];
+    }
+    XCTAssertEqualObjects(groupSizes, (@[@10, @10, @10, @10, @5]));
+    XCTAssertEqual(completedPermissions.count, nodes.count);
+    XCTAssertEqual(self.realmManager.numberOfPermissionWrites, 1);
+}
+
+- (void)testCachedPermissionsAreDeliveredWithoutRequests
+{
+    NSArray *nodes = [self nodesWithCount:3];
+    [self.prefetcher prefetchPermissionsForNodes:nodes session:nil permissionsBlock:nil completionBlock:nil];
+    while (self.service.pendingRequests.count > 0)
+    {
+        [self.service answerFirstPendingRequest];
+    }
+    
+    __block NSUInteger numberOfDeliveries = 0;
+    __block BOOL completed = NO;
+    [self.prefetcher prefetchPermissionsForNodes:nodes session:nil permissionsBlock:^(NSString *syncIdentifier, AlfrescoPermissions *permissions) {
+        numberOfDeliveries++;
+    } completionBlock:^(NSDictionary *permissionsBySyncIdentifier) {
+        completed = YES;
+    }];
+    
+    XCTAssertEqual(self.service.pendingRequests.count, 0);
+    XCTAssertEqual(numberOfDeliveries, nodes.count);
+    XCTAssertTrue(completed);
+    XCTAssertEqual(self.realmManager.numberOfPermissionWrites, 1);
+}
+
+@end
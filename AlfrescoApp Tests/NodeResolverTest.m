@@ -0,0 +1,288 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "NodeResolverTest.h"
+#import "NodeResolver.h"
+
+static NSTimeInterval const kNodeResolverTestLatency = 0.2;
+
+/**
+ * Stand-in for the document folder service, answering every request after a fixed latency and counting them.
+ */
+@interface NodeResolverTestService : NSObject <NodeResolverService>
+@property (nonatomic, assign) NSUInteger numberOfNodeRequests;
+@property (nonatomic, assign) NSUInteger numberOfPermissionsRequests;
+@property (nonatomic, assign) NSUInteger numberOfRequestsInFlight;
+@property (nonatomic, assign) NSUInteger maximumNumberOfRequestsInFlight;
+// Refuses permission requests for nodes that only carry an identifier
+@property (nonatomic, assign) BOOL requiresCompleteNodeForPermissions;
+@end
+
+@implementation NodeResolverTestService
+
+- (void)respondAfterLatency:(void (^)(void))response
+{
+    self.numberOfRequestsInFlight++;
+    self.maximumNumberOfRequestsInFlight = MAX(self.maximumNumberOfRequestsInFlight, self.numberOfRequestsInFlight);
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kNodeResolverTestLatency * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        self.numberOfRequestsInFlight--;
+        response();
+    });
+}
+
+- (AlfrescoRequest *)retrieveNodeWithIdentifier:(NSString *)identifier completionBlock:(AlfrescoNodeCompletionBlock)completionBlock
+{
+    self.numberOfNodeRequests++;
+    [self respondAfterLatency:^{
+        NSDictionary *properties = @{kCMISPropertyObjectId : identifier,
+                                     kCMISPropertyName : @"report.txt",
+                                     kCMISPropertyObjectTypeId : @"cmis:document",
+                                     kCMISPropertyContentStreamMediaType : @"text/plain"};
+        completionBlock([[AlfrescoDocument alloc] initWithProperties:properties], nil);
+    }];
+    return [AlfrescoRequest new];
+}
+
+- (AlfrescoRequest *)retrievePermissionsOfNode:(AlfrescoNode *)node completionBlock:(AlfrescoPermissionsCompletionBlock)completionBlock
+{
+    self.numberOfPermissionsRequests++;
+    BOOL refused = self.requiresCompleteNodeForPermissions && !node.name;
+    [self respondAfterLatency:^{
+        if (refused)
+        {
+            completionBlock(nil, [NSError errorWithDomain:kAlfrescoErrorDomainName code:kAlfrescoErrorCodeUnknown userInfo:nil]);
+        }
+        else
+        {
+            completionBlock([AlfrescoPermissions new], nil);
+        }
+    }];
+    return [AlfrescoRequest new];
+}
+
+@end
+
+/**
+ * Repository information reporting an identifier chosen by the test.
+ */
+@interface NodeResolverTestRepositoryInfo : AlfrescoRepositoryInfo
+@property (nonatomic, strong) NSString *repositoryIdentifier;
+@end
+
+@implementation NodeResolverTestRepositoryInfo
+
+- (NSString *)identifier
+{
+    return self.repositoryIdentifier;
+}
+
+@end
+
+/**
+ * Carries just what the resolver uses to tell accounts apart.
+ */
+@interface NodeResolverTestSession : NSObject
+@property (nonatomic, strong) NSString *personIdentifier;
+@property (nonatomic, strong) AlfrescoRepositoryInfo *repositoryInfo;
+@end
+
+@implementation NodeResolverTestSession
+@end
+
+@interface NodeResolverTest ()
+@property (nonatomic, strong) NodeResolverTestService *service;
+@property (nonatomic, strong) NodeResolver *resolver;
+@end
+
+@implementation NodeResolverTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.service = [NodeResolverTestService new];
+    self.resolver = [[NodeResolver alloc] initWithService:self.service];
+}
+
+- (id<AlfrescoSession>)sessionForPerson:(NSString *)personIdentifier repository:(NSString *)repositoryIdentifier
+{
+    NodeResolverTestRepositoryInfo *repositoryInfo = [NodeResolverTestRepositoryInfo new];
+    repositoryInfo.repositoryIdentifier = repositoryIdentifier;
+    NodeResolverTestSession *session = [NodeResolverTestSession new];
+    session.personIdentifier = personIdentifier;
+    session.repositoryInfo = repositoryInfo;
+    return (id<AlfrescoSession>)session;
+}
+
+- (void)resolveIdentifier:(NSString *)identifier
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Node resolved"];
+    
+    [self.resolver resolveNodeWithIdentifier:identifier session:nil completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+        XCTAssertEqualObjects(node.identifier, identifier);
+        XCTAssertNotNil(permissions);
+        [expectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testNodeAndPermissionsAreRetrievedConcurrently
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Node resolved"];
+    [self.resolver resolveNodeWithIdentifier:@"workspace://SpacesStore/1" session:nil completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+        [expectation fulfill];
+    }];
+    
+    // Both lookups are sent before either answers
+    XCTAssertEqual(self.service.numberOfRequestsInFlight, 2);
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(self.service.numberOfNodeRequests, 1);
+    XCTAssertEqual(self.service.numberOfPermissionsRequests, 1);
+    XCTAssertEqual(self.service.maximumNumberOfRequestsInFlight, 2);
+}
+
+- (void)testConcurrentRequestsForOneIdentifierAreShared
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Every caller answered"];
+    expectation.expectedFulfillmentCount = 3;
+    expectation.assertForOverFulfill = YES;
+    
+    for (NSUInteger caller = 0; caller < 3; caller++)
+    {
+        [self.resolver resolveNodeWithIdentifier:@"workspace://SpacesStore/1" session:nil completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+            XCTAssertNotNil(node);
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertEqual(self.service.numberOfNodeRequests, 1);
+    XCTAssertEqual(self.service.numberOfPermissionsRequests, 1);
+}
+
+- (void)testResolvedNodesAreReusedUntilTheyExpire
+{
+    [self resolveIdentifier:@"workspace://SpacesStore/1"];
+    
+    __block BOOL resolvedSynchronously = NO;
+    [self.resolver resolveNodeWithIdentifier:@"workspace://SpacesStore/1" session:nil completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+        resolvedSynchronously = (node != nil);
+    }];
+    XCTAssertTrue(resolvedSynchronously);
+    XCTAssertEqual(self.service.numberOfNodeRequests, 1);
+    
+    [self.resolver clearCache];
+    self.resolver.timeToLive = 0;
+    [self resolveIdentifier:@"workspace://SpacesStore/1"];
+    [self resolveIdentifier:@"workspace://SpacesStore/1"];
+    XCTAssertEqual(self.service.numberOfNodeRequests, 3);
+}
+
+- (void)testWarmedNodesOpenWithoutWaiting
+{
+    self.resolver.maximumConcurrentWarmingRequests = 2;
+    NSArray *identifiers = @[@"workspace://SpacesStore/1", @"workspace://SpacesStore/2", @"workspace://SpacesStore/3"];
+    [self.resolver warmNodesWithIdentifiers:identifiers session:nil];
+    
+    // Two identifiers at a time, two lookups each
+    XCTAssertEqual(self.service.numberOfRequestsInFlight, 4);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Warming finished"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kNodeResolverTestLatency * 3 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    for (NSString *identifier in identifiers)
+    {
+        __block BOOL resolvedSynchronously = NO;
+        [self.resolver resolveNodeWithIdentifier:identifier session:nil completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+            resolvedSynchronously = (node != nil);
+        }];
+        XCTAssertTrue(resolvedSynchronously);
+    }
+    XCTAssertEqual(self.service.numberOfNodeRequests, identifiers.count);
+    XCTAssertLessThanOrEqual(self.service.maximumNumberOfRequestsInFlight, 4);
+}
+
+- (void)testPermissionsFallBackToResolvedNode
+{
+    self.service.requiresCompleteNodeForPermissions = YES;
+    
+    [self resolveIdentifier:@"workspace://SpacesStore/1"];
+    
+    XCTAssertEqual(self.service.numberOfNodeRequests, 1);
+    XCTAssertEqual(self.service.numberOfPermissionsRequests, 2);
+}
+
+- (void)testLookupsOfAPreviousAccountAreAnsweredWithAnError
+{
+    id<AlfrescoSession> previousSession = [self sessionForPerson:@"alice" repository:@"repository"];
+    id<AlfrescoSession> currentSession = [self sessionForPerson:@"bob" repository:@"repository"];
+    
+    __block NSUInteger numberOfPreviousAccountAnswers = 0;
+    __block NSError *previousAccountError = nil;
+    [self.resolver resolveNodeWithIdentifier:@"workspace://SpacesStore/1" session:previousSession completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+        XCTAssertNil(node);
+        numberOfPreviousAccountAnswers++;
+        previousAccountError = error;
+    }];
+    
+    // Another account logs in while the lookups are in flight
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Current account resolved"];
+    [self.resolver resolveNodeWithIdentifier:@"workspace://SpacesStore/2" session:currentSession completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+        [expectation fulfill];
+    }];
+    XCTAssertEqual(numberOfPreviousAccountAnswers, 1);
+    XCTAssertEqual(previousAccountError.code, kAlfrescoErrorCodeNetworkRequestCancelled);
+    
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    // The previous account's lookups finishing late don't answer anyone again
+    XCTAssertEqual(numberOfPreviousAccountAnswers, 1);
+    
+    // Nothing the previous account looked up was cached for the current one
+    NSUInteger numberOfNodeRequests = self.service.numberOfNodeRequests;
+    [self resolveIdentifier:@"workspace://SpacesStore/1"];
+    XCTAssertEqual(self.service.numberOfNodeRequests, numberOfNodeRequests + 1);
+}
+
+- (void)testRefreshedSessionForTheSameAccountKeepsLookups
+{
+    id<AlfrescoSession> previousSession = [self sessionForPerson:@"alice" repository:@"repository"];
+    id<AlfrescoSession> refreshedSession = [self sessionForPerson:@"alice" repository:@"repository"];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Lookup made before the refresh answered"];
+    [self.resolver resolveNodeWithIdentifier:@"workspace://SpacesStore/1" session:previousSession completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+        XCTAssertNotNil(node);
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self.resolver warmNodesWithIdentifiers:@[] session:refreshedSession];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    __block BOOL resolvedSynchronously = NO;
+    [self.resolver resolveNodeWithIdentifier:@"workspace://SpacesStore/1" session:refreshedSession completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+        resolvedSynchronously = (node != nil);
+    }];
+    XCTAssertTrue(resolvedSynchronously);
+    XCTAssertEqual(self.service.numberOfNodeRequests, 1);
+}
+
+@end
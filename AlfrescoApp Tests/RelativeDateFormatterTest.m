@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "RelativeDateFormatterTest.h"
+#import "RelativeDateFormatter.h"
+#import "Utility.h"
+
+static NSUInteger const kRelativeDateFormatterTestRowCount = 1000;
+
+@implementation RelativeDateFormatterTest
+
+- (void)testDatesInTheSameBucketShareFormattedString
+{
+    RelativeDateFormatter *formatter = [RelativeDateFormatter sharedFormatter];
+    NSDate *now = [NSDate date];
+    
+    NSString *first = [formatter relativeTimeFromDate:[now dateByAddingTimeInterval:-(5 * 60)] relativeToDate:now];
+    NSString *second = [formatter relativeTimeFromDate:[now dateByAddingTimeInterval:-(5 * 60 + 20)] relativeToDate:now];
+    
+    XCTAssertEqualObjects(first, second, @"Dates within the same minute bucket should format identically");
+    XCTAssertTrue(first == second, @"The formatted string for a bucket should be cached");
+}
+
+- (void)testBucketsMatchDisplayedUnits
+{
+    RelativeDateFormatter *formatter = [RelativeDateFormatter sharedFormatter];
+    NSDate *now = [NSDate date];
+    
+    NSString *justNow = [formatter relativeTimeFromDate:now relativeToDate:now];
+    XCTAssertEqualObjects(justNow, NSLocalizedString(@"relative.date.just-now", @"Just now"));
+    
+    NSString *threeHoursAgo = [formatter relativeTimeFromDate:[now dateByAddingTimeInterval:-(3 * 60 * 60)] relativeToDate:now];
+    XCTAssertEqualObjects(threeHoursAgo, ([NSString stringWithFormat:NSLocalizedString(@"relative.date.past.n-hours", @"Date string"), 3]));
+    
+    NSString *twoDaysAhead = [formatter relativeTimeFromDate:[now dateByAddingTimeInterval:(2 * 24 * 60 * 60)] relativeToDate:now];
+    XCTAssertEqualObjects(twoDaysAhead, ([NSString stringWithFormat:NSLocalizedString(@"relative.date.future.n-days", @"Date string"), 2]));
+    
+    XCTAssertNotEqualObjects(threeHoursAgo, [formatter relativeTimeFromDate:[now dateByAddingTimeInterval:(3 * 60 * 60)] relativeToDate:now], @"Past and future dates must not share a bucket");
+    XCTAssertEqualObjects([formatter relativeTimeFromDate:nil], @"");
+}
+
+- (void)testCellConfigurationPerformance
+{
+    NSDate *now = [NSDate date];
+    NSMutableArray *dates = [NSMutableArray arrayWithCapacity:kRelativeDateFormatterTestRowCount];
+    for (NSUInteger row = 0; row < kRelativeDateFormatterTestRowCount; row++)
+    {
+        // Spread the rows from a few seconds to a few years in the past
+        [dates addObject:[now dateByAddingTimeInterval:-(pow(row + 1, 2.5) * 2)]];
+    }
+    
+    UITableViewCell *cell = [[UITableViewCell alloc] initWithStyle:UITableViewCellStyleSubtitle reuseIdentifier:nil];
+    
+    [self measureBlock:^{
+        for (NSDate *date in dates)
+        {
+            cell.detailTextLabel.text = [NSString stringWithFormat:@"%@ • %@", relativeTimeFromDate(date), stringForLongFileSize(1024)];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,278 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "SearchQueryEngineTest.h"
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "Constants.h"
+#import "SearchQueryEngine.h"
+#import "LatencyHistogram.h"
+
+static int const kSearchQueryEngineTestPageSize = 10;
+
+@interface SearchQueryEngineTestItem : NSObject
+@property (nonatomic, strong) NSString *name;
+// Only set for people, whose user name isn't shown
+@property (nonatomic, strong) NSString *fullName;
+@end
+
+@implementation SearchQueryEngineTestItem
+@end
+
+/**
+ * Stands in for the search service, answering from a fixed catalogue of names after a delay.
+ */
+@interface SearchQueryEngineTestBackend : NSObject <SearchQueryEngineBackend>
+@property (nonatomic, strong) NSArray<NSString *> *catalogue;
+@property (nonatomic, assign) NSTimeInterval responseDelay;
+// "keywords@skipCount" for every request received
+@property (nonatomic, strong) NSMutableArray<NSString *> *requestLog;
+@property (nonatomic, strong) NSMutableArray<AlfrescoRequest *> *requests;
+@end
+
+@implementation SearchQueryEngineTestBackend
+
+- (instancetype)initWithCatalogue:(NSArray<NSString *> *)catalogue
+{
+    self = [super init];
+    if (self)
+    {
+        self.catalogue = catalogue;
+        self.responseDelay = 0.05;
+        self.requestLog = [NSMutableArray array];
+        self.requests = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (AlfrescoRequest *)searchWithKeywords:(NSString *)keywords type:(SearchViewControllerDataSourceType)type options:(AlfrescoKeywordSearchOptions *)options listingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    [self.requestLog addObject:[NSString stringWithFormat:@"%@@%d", keywords, listingContext.skipCount]];
+    AlfrescoRequest *request = [AlfrescoRequest new];
+    [self.requests addObject:request];
+    
+    NSMutableArray *matches = [NSMutableArray array];
+    for (NSString *name in self.catalogue)
+    {
+        if ([name rangeOfString:keywords options:NSCaseInsensitiveSearch].location != NSNotFound)
+        {
+            SearchQueryEngineTestItem *item = [SearchQueryEngineTestItem new];
+            if (type == SearchViewControllerDataSourceTypeSearchUsers)
+            {
+                item.fullName = [NSString stringWithFormat:@"Person %lu", (unsigned long)matches.count];
+            }
+            else
+            {
+                item.name = name;
+            }
+            [matches addObject:item];
+        }
+    }
+    
+    NSUInteger start = MIN((NSUInteger)listingContext.skipCount, matches.count);
+    NSUInteger length = MIN((NSUInteger)listingContext.maxItems, matches.count - start);
+    NSArray *page = [matches subarrayWithRange:NSMakeRange(start, length)];
+    AlfrescoPagingResult *pagingResult = [[AlfrescoPagingResult alloc] initWithArray:page hasMoreItems:(start + length < matches.count) totalItems:(int)matches.count];
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.responseDelay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        if (request.isCancelled)
+        {
+            completionBlock(nil, [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeNetworkRequestCancelled]);
+        }
+        else
+        {
+            completionBlock(pagingResult, nil);
+        }
+    });
+    
+    return request;
+}
+
+@end
+
+@implementation SearchQueryEngineTest
+
+- (NSArray *)catalogue
+{
+    NSMutableArray *catalogue = [NSMutableArray arrayWithArray:@[@"Repair log.txt", @"Repair invoice.pdf", @"Reply to customer.eml", @"Repository guide.pdf", @"Repo migration.docx", @"Budget.xlsx"]];
+    for (NSUInteger index = 0; index < 25; index++)
+    {
+        [catalogue addObject:[NSString stringWithFormat:@"Quarterly report %lu.docx", (unsigned long)index]];
+    }
+    return catalogue;
+}
+
+- (SearchQueryEngine *)engineWithBackend:(SearchQueryEngineTestBackend *)backend
+{
+    SearchQueryEngine *engine = [[SearchQueryEngine alloc] initWithBackend:backend cacheCapacity:20];
+    engine.debounceInterval = 0.2;
+    return engine;
+}
+
+- (AlfrescoKeywordSearchOptions *)options
+{
+    return [[AlfrescoKeywordSearchOptions alloc] initWithExactMatch:NO includeContent:NO];
+}
+
+- (AlfrescoListingContext *)firstPage
+{
+    return [[AlfrescoListingContext alloc] initWithMaxItems:kSearchQueryEngineTestPageSize skipCount:0];
+}
+
+- (void)waitForInterval:(NSTimeInterval)interval
+{
+    [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:interval]];
+}
+
+/*
+ * Replays typed queries against the engine at a fixed interval, as the search bar would, collecting every delivery.
+ */
+- (NSArray<NSString *> *)replayQueries:(NSArray<NSString *> *)queries interval:(NSTimeInterval)interval debounce:(BOOL)debounce engine:(SearchQueryEngine *)engine
+{
+    NSMutableArray *deliveredQueries = [NSMutableArray array];
+    for (NSUInteger index = 0; index < queries.count; index++)
+    {
+        NSString *query = queries[index];
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(index * interval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            [engine searchFor:query type:SearchViewControllerDataSourceTypeSearchFiles options:[self options] listingContext:[self firstPage] debounce:debounce completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+                [deliveredQueries addObject:query];
+            }];
+        });
+    }
+    
+    [self waitForInterval:queries.count * interval + engine.debounceInterval + 0.5];
+    return deliveredQueries;
+}
+
+- (void)testTypingIsDebouncedIntoOneRequest
+{
+    SearchQueryEngineTestBackend *backend = [[SearchQueryEngineTestBackend alloc] initWithCatalogue:[self catalogue]];
+    SearchQueryEngine *engine = [self engineWithBackend:backend];
+    engine.prefetchesNextPage = NO;
+    
+    NSArray *deliveredQueries = [self replayQueries:@[@"r", @"re", @"rep", @"repo"] interval:0.05 debounce:YES engine:engine];
+    
+    XCTAssertEqualObjects(backend.requestLog, @[@"repo@0"]);
+    XCTAssertEqualObjects(deliveredQueries, @[@"repo"]);
+    XCTAssertEqual(engine.queryLatencyHistogram.count, 1);
+    XCTAssertGreaterThanOrEqual([engine.queryLatencyHistogram latencyAtPercentile:50], engine.debounceInterval);
+}
+
+- (void)testSupersededQueryIsCancelledAndIgnored
+{
+    SearchQueryEngineTestBackend *backend = [[SearchQueryEngineTestBackend alloc] initWithCatalogue:[self catalogue]];
+    backend.responseDelay = 0.2;
+    SearchQueryEngine *engine = [self engineWithBackend:backend];
+    
+    NSArray *deliveredQueries = [self replayQueries:@[@"budget", @"repair"] interval:0.05 debounce:NO engine:engine];
+    
+    XCTAssertEqualObjects(backend.requestLog, (@[@"budget@0", @"repair@0"]));
+    XCTAssertTrue(backend.requests.firstObject.isCancelled);
+    XCTAssertFalse(backend.requests.lastObject.isCancelled);
+    XCTAssertEqualObjects(deliveredQueries, @[@"repair"], @"Results of the superseded query should be dropped");
+}
+
+- (void)testRefinementsAndRepeatsAreServedFromCache
+{
+    SearchQueryEngineTestBackend *backend = [[SearchQueryEngineTestBackend alloc] initWithCatalogue:[self catalogue]];
+    SearchQueryEngine *engine = [self engineWithBackend:backend];
+    [self replayQueries:@[@"rep"] interval:0 debounce:NO engine:engine];
+    XCTAssertEqualObjects(backend.requestLog, (@[@"rep@0", @"rep@10"]));
+    
+    // "rep" matched more than a page, so refining it has to go to the server
+    [self replayQueries:@[@"repai"] interval:0 debounce:NO engine:engine];
+    XCTAssertEqualObjects(backend.requestLog, (@[@"rep@0", @"rep@10", @"repai@0"]));
+    
+    __block NSArray *refinedNames = nil;
+    [engine searchFor:@"repair lo" type:SearchViewControllerDataSourceTypeSearchFiles options:[self options] listingContext:[self firstPage] debounce:NO completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+        refinedNames = [pagingResult.objects valueForKey:@"name"];
+    }];
+    XCTAssertEqualObjects(refinedNames, @[@"Repair log.txt"], @"A refinement of a complete result should be filtered locally");
+    
+    __block BOOL deliveredFromCache = NO;
+    [engine searchFor:@"REP" type:SearchViewControllerDataSourceTypeSearchFiles options:[self options] listingContext:[self firstPage] debounce:NO completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+        deliveredFromCache = (pagingResult.objects.count == kSearchQueryEngineTestPageSize);
+    }];
+    XCTAssertTrue(deliveredFromCache);
+    XCTAssertEqual(engine.numberOfCachedResponses, 2);
+    XCTAssertEqual(backend.requestLog.count, 3);
+}
+
+- (void)testPeopleSearchesAreNotRefinedLocally
+{
+    // The server matches people on their user names, which aren't part of the results
+    SearchQueryEngineTestBackend *backend = [[SearchQueryEngineTestBackend alloc] initWithCatalogue:@[@"jsmith", @"jsanders"]];
+    SearchQueryEngine *engine = [self engineWithBackend:backend];
+    
+    __block NSUInteger numberOfPeople = 0;
+    for (NSString *keywords in @[@"js", @"jsmi"])
+    {
+        XCTestExpectation *expectation = [self expectationWithDescription:keywords];
+        [engine searchFor:keywords type:SearchViewControllerDataSourceTypeSearchUsers options:[self options] listingContext:[self firstPage] debounce:NO completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+            numberOfPeople = pagingResult.objects.count;
+            [expectation fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:2 handler:nil];
+    }
+    
+    XCTAssertEqualObjects(backend.requestLog, (@[@"js@0", @"jsmi@0"]));
+    XCTAssertEqual(numberOfPeople, 1, @"A person matching on user name only should still be found");
+}
+
+- (void)testNextPageIsPrefetched
+{
+    SearchQueryEngineTestBackend *backend = [[SearchQueryEngineTestBackend alloc] initWithCatalogue:[self catalogue]];
+    SearchQueryEngine *engine = [self engineWithBackend:backend];
+    [self replayQueries:@[@"quarterly"] interval:0 debounce:NO engine:engine];
+    XCTAssertEqualObjects(backend.requestLog, (@[@"quarterly@0", @"quarterly@10"]));
+    
+    __block AlfrescoPagingResult *secondPage = nil;
+    AlfrescoListingContext *secondPageContext = [[AlfrescoListingContext alloc] initWithMaxItems:kSearchQueryEngineTestPageSize skipCount:kSearchQueryEngineTestPageSize];
+    [engine retrieveResultsWithListingContext:secondPageContext completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+        secondPage = pagingResult;
+    }];
+    XCTAssertEqual(secondPage.objects.count, kSearchQueryEngineTestPageSize, @"The prefetched page should be delivered straight away");
+    XCTAssertTrue(secondPage.hasMoreItems);
+    
+    [self waitForInterval:0.3];
+    XCTAssertEqualObjects(backend.requestLog, (@[@"quarterly@0", @"quarterly@10", @"quarterly@20"]));
+}
+
+- (void)testPageRequestedWhilePrefetchingWaitsForPrefetch
+{
+    SearchQueryEngineTestBackend *backend = [[SearchQueryEngineTestBackend alloc] initWithCatalogue:[self catalogue]];
+    SearchQueryEngine *engine = [self engineWithBackend:backend];
+    
+    __block BOOL firstPageDelivered = NO;
+    __block AlfrescoPagingResult *secondPage = nil;
+    [engine searchFor:@"quarterly" type:SearchViewControllerDataSourceTypeSearchFiles options:[self options] listingContext:[self firstPage] debounce:NO completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+        firstPageDelivered = YES;
+        AlfrescoListingContext *secondPageContext = [[AlfrescoListingContext alloc] initWithMaxItems:kSearchQueryEngineTestPageSize skipCount:kSearchQueryEngineTestPageSize];
+        [engine retrieveResultsWithListingContext:secondPageContext completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+            secondPage = pagingResult;
+        }];
+    }];
+    
+    [self waitForInterval:0.5];
+    XCTAssertTrue(firstPageDelivered);
+    XCTAssertEqual(secondPage.objects.count, kSearchQueryEngineTestPageSize);
+    XCTAssertEqual([backend.requestLog indexesOfObjectsPassingTest:^BOOL(NSString *entry, NSUInteger index, BOOL *stop) {
+        return [entry isEqualToString:@"quarterly@10"];
+    }].count, 1, @"The second page should only be requested once");
+}
+
+@end
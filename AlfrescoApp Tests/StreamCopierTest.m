@@ -0,0 +1,234 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "StreamCopierTest.h"
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "StreamCopier.h"
+
+static NSTimeInterval const kStreamCopierTestTimeout = 60;
+
+/**
+ * Output stream that accepts at most a fixed number of bytes per write, to exercise partial write handling.
+ */
+@interface PartialWriteOutputStream : NSOutputStream
+@property (nonatomic, strong) NSMutableData *writtenData;
+@property (nonatomic, assign) NSUInteger maximumBytesPerWrite;
+@property (nonatomic, assign) NSStreamStatus status;
+@end
+
+@implementation PartialWriteOutputStream
+
+- (void)open
+{
+    self.writtenData = [NSMutableData data];
+    self.status = NSStreamStatusOpen;
+}
+
+- (void)close
+{
+    self.status = NSStreamStatusClosed;
+}
+
+- (NSStreamStatus)streamStatus
+{
+    return self.status;
+}
+
+- (NSError *)streamError
+{
+    return nil;
+}
+
+- (BOOL)hasSpaceAvailable
+{
+    return YES;
+}
+
+- (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)length
+{
+    NSUInteger bytesToWrite = MIN(length, self.maximumBytesPerWrite);
+    [self.writtenData appendBytes:buffer length:bytesToWrite];
+    return bytesToWrite;
+}
+
+@end
+
+@implementation StreamCopierTest
+
+- (NSData *)randomDataOfLength:(NSUInteger)length
+{
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    arc4random_buf(data.mutableBytes, length);
+    return data;
+}
+
+- (NSString *)temporaryFileWithData:(NSData *)data
+{
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [data writeToFile:filePath atomically:YES];
+    return filePath;
+}
+
+- (void)testCopyHandlesPartialWrites
+{
+    NSData *sourceData = [self randomDataOfLength:300 * 1024 + 17];
+    PartialWriteOutputStream *outputStream = [PartialWriteOutputStream new];
+    outputStream.maximumBytesPerWrite = 1000;
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Copy completed"];
+    [[StreamCopier sharedCopier] copyInputStream:[NSInputStream inputStreamWithData:sourceData] toOutputStream:outputStream expectedLength:sourceData.length progressBlock:nil completionBlock:^(BOOL succeeded, unsigned long long bytesCopied, NSError *error) {
+        XCTAssertTrue(succeeded, @"Copy failed: %@", error);
+        XCTAssertEqual(bytesCopied, sourceData.length);
+        XCTAssertEqualObjects(outputStream.writtenData, sourceData);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:kStreamCopierTestTimeout handler:nil];
+}
+
+- (void)testCopyReportsProgressOnMainThread
+{
+    NSData *sourceData = [self randomDataOfLength:1024 * 1024];
+    NSOutputStream *outputStream = [NSOutputStream outputStreamToMemory];
+    __block unsigned long long lastReportedBytes = 0;
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Copy completed"];
+    [[StreamCopier sharedCopier] copyInputStream:[NSInputStream inputStreamWithData:sourceData] toOutputStream:outputStream expectedLength:sourceData.length progressBlock:^(unsigned long long bytesCopied, unsigned long long bytesTotal) {
+        XCTAssertTrue([NSThread isMainThread]);
+        XCTAssertGreaterThanOrEqual(bytesCopied, lastReportedBytes);
+        lastReportedBytes = bytesCopied;
+    } completionBlock:^(BOOL succeeded, unsigned long long bytesCopied, NSError *error) {
+        XCTAssertTrue(succeeded);
+        XCTAssertEqual(lastReportedBytes, sourceData.length);
+        XCTAssertEqualObjects([outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey], sourceData);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:kStreamCopierTestTimeout handler:nil];
+}
+
+- (void)testCopyCanBeCancelled
+{
+    NSData *sourceData = [self randomDataOfLength:8 * 1024 * 1024];
+    StreamCopier *copier = [[StreamCopier alloc] initWithBufferSize:1024 maximumPooledBuffers:1];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Copy cancelled"];
+    StreamCopyRequest *request = [copier copyInputStream:[NSInputStream inputStreamWithData:sourceData] toOutputStream:[NSOutputStream outputStreamToMemory] expectedLength:sourceData.length progressBlock:nil completionBlock:^(BOOL succeeded, unsigned long long bytesCopied, NSError *error) {
+        XCTAssertFalse(succeeded);
+        XCTAssertEqual(error.code, kAlfrescoErrorCodeNetworkRequestCancelled);
+        XCTAssertLessThan(bytesCopied, sourceData.length);
+        [expectation fulfill];
+    }];
+    [request cancel];
+    [self waitForExpectationsWithTimeout:kStreamCopierTestTimeout handler:nil];
+}
+
+- (void)testSynchronousCopyFinishesBeforeReturning
+{
+    NSData *sourceData = [self randomDataOfLength:200 * 1024];
+    NSOutputStream *outputStream = [NSOutputStream outputStreamToMemory];
+    
+    NSError *error = nil;
+    BOOL succeeded = [[StreamCopier sharedCopier] copyInputStream:[NSInputStream inputStreamWithData:sourceData] toOutputStream:outputStream error:&error];
+    
+    XCTAssertTrue(succeeded, @"Copy failed: %@", error);
+    XCTAssertEqualObjects([outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey], sourceData);
+}
+
+- (void)testFailedFileCopyKeepsDestination
+{
+    NSData *existingData = [self randomDataOfLength:1024];
+    NSString *destinationPath = [self temporaryFileWithData:existingData];
+    NSString *missingSourcePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Copy failed"];
+    [[StreamCopier sharedCopier] copyFileAtPath:missingSourcePath toPath:destinationPath progressBlock:nil completionBlock:^(BOOL succeeded, unsigned long long bytesCopied, NSError *error) {
+        XCTAssertFalse(succeeded);
+        XCTAssertNotNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:kStreamCopierTestTimeout handler:nil];
+    
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:destinationPath], existingData);
+    [[NSFileManager defaultManager] removeItemAtPath:destinationPath error:nil];
+}
+
+- (void)testFileDestinationMovesContentIntoPlaceOnlyOnSuccess
+{
+    NSString *folderPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtPath:folderPath withIntermediateDirectories:YES attributes:nil error:nil];
+    NSString *filePath = [folderPath stringByAppendingPathComponent:@"content"];
+    NSString *partialFilePath = [folderPath stringByAppendingPathComponent:@"content.partial"];
+    NSData *oldData = [self randomDataOfLength:512];
+    [oldData writeToFile:filePath atomically:YES];
+    uint8_t bytes[] = "received";
+    
+    // A failed transfer deletes what it received and leaves the existing file alone
+    StreamCopyFileDestination *failedDestination = [[StreamCopyFileDestination alloc] initWithFilePath:filePath partialFilePath:partialFilePath];
+    [failedDestination.outputStream open];
+    [failedDestination.outputStream write:bytes maxLength:sizeof(bytes)];
+    XCTAssertFalse([failedDestination finishWithSuccess:NO error:nil]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:partialFilePath]);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:filePath], oldData);
+    
+    StreamCopyFileDestination *destination = [[StreamCopyFileDestination alloc] initWithFilePath:filePath partialFilePath:partialFilePath];
+    [destination.outputStream open];
+    [destination.outputStream write:bytes maxLength:sizeof(bytes)];
+    NSError *error = nil;
+    XCTAssertTrue([destination finishWithSuccess:YES error:&error], @"Finishing failed: %@", error);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:partialFilePath]);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:filePath], [NSData dataWithBytes:bytes length:sizeof(bytes)]);
+    
+    [[NSFileManager defaultManager] removeItemAtPath:folderPath error:nil];
+}
+
+#pragma mark - Throughput
+
+- (void)measureFileCopyOfLength:(NSUInteger)length
+{
+    NSString *sourcePath = [self temporaryFileWithData:[self randomDataOfLength:length]];
+    NSString *destinationPath = [sourcePath stringByAppendingPathExtension:@"copy"];
+    
+    [self measureBlock:^{
+        XCTestExpectation *expectation = [self expectationWithDescription:@"File copied"];
+        [[StreamCopier sharedCopier] copyFileAtPath:sourcePath toPath:destinationPath progressBlock:nil completionBlock:^(BOOL succeeded, unsigned long long bytesCopied, NSError *error) {
+            XCTAssertTrue(succeeded);
+            XCTAssertEqual(bytesCopied, length);
+            [expectation fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:kStreamCopierTestTimeout handler:nil];
+    }];
+    
+    [[NSFileManager defaultManager] removeItemAtPath:sourcePath error:nil];
+    [[NSFileManager defaultManager] removeItemAtPath:destinationPath error:nil];
+}
+
+- (void)testThroughput1MB
+{
+    [self measureFileCopyOfLength:1024 * 1024];
+}
+
+- (void)testThroughput16MB
+{
+    [self measureFileCopyOfLength:16 * 1024 * 1024];
+}
+
+- (void)testThroughput128MB
+{
+    [self measureFileCopyOfLength:128 * 1024 * 1024];
+}
+
+@end
@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "SyncProgressEventBusTest.h"
+#import "SyncProgressEventBus.h"
+#import "SyncNodeStatus.h"
+
+static NSUInteger const kSyncProgressEventBusTestNodeCount = 500;
+static NSUInteger const kSyncProgressEventBusTestVisibleNodeCount = 12;
+static NSUInteger const kSyncProgressEventBusTestTicksPerNode = 50;
+
+@interface SyncProgressTestObserver : NSObject <SyncProgressObserver>
+@property (nonatomic, assign) NSUInteger deliveryCount;
+@property (nonatomic, strong) NSMutableArray<SyncProgressEvent *> *receivedEvents;
+@end
+
+@implementation SyncProgressTestObserver
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.receivedEvents = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)didReceiveSyncProgressEvents:(NSArray<SyncProgressEvent *> *)events
+{
+    self.deliveryCount++;
+    [self.receivedEvents addObjectsFromArray:events];
+}
+
+@end
+
+@implementation SyncProgressEventBusTest
+
+- (void)testChangesAreCoalescedPerNode
+{
+    SyncProgressEventBus *eventBus = [SyncProgressEventBus sharedBus];
+    [eventBus deliverPendingEvents];
+    
+    SyncNodeStatus *nodeStatus = [[SyncNodeStatus alloc] initWithNodeId:[[NSUUID UUID] UUIDString]];
+    SyncProgressTestObserver *observer = [SyncProgressTestObserver new];
+    [eventBus addObserver:observer forNodeId:nodeStatus.nodeId];
+    
+    nodeStatus.status = SyncStatusLoading;
+    for (unsigned long long bytes = 1; bytes <= 100; bytes++)
+    {
+        nodeStatus.bytesTransfered = bytes * 1024;
+    }
+    [eventBus deliverPendingEvents];
+    
+    XCTAssertEqual(observer.deliveryCount, 1, @"All changes made within a frame should be delivered once");
+    XCTAssertEqual(observer.receivedEvents.count, 1);
+    SyncProgressEvent *event = observer.receivedEvents.firstObject;
+    XCTAssertEqual(event.nodeStatus, nodeStatus);
+    XCTAssertEqualObjects(event.changedProperties, ([NSSet setWithObjects:kSyncStatus, kSyncBytesTransfered, nil]));
+    
+    [eventBus removeObserver:observer];
+}
+
+- (void)testObserversOnlyReceiveTheirNode
+{
+    SyncProgressEventBus *eventBus = [SyncProgressEventBus sharedBus];
+    [eventBus deliverPendingEvents];
+    
+    SyncNodeStatus *observedStatus = [[SyncNodeStatus alloc] initWithNodeId:[[NSUUID UUID] UUIDString]];
+    SyncNodeStatus *otherStatus = [[SyncNodeStatus alloc] initWithNodeId:[[NSUUID UUID] UUIDString]];
+    SyncProgressTestObserver *nodeObserver = [SyncProgressTestObserver new];
+    SyncProgressTestObserver *allNodesObserver = [SyncProgressTestObserver new];
+    [eventBus addObserver:nodeObserver forNodeId:observedStatus.nodeId];
+    [eventBus addObserverForAllNodes:allNodesObserver];
+    
+    otherStatus.status = SyncStatusLoading;
+    [eventBus deliverPendingEvents];
+    XCTAssertEqual(nodeObserver.deliveryCount, 0);
+    
+    observedStatus.status = SyncStatusLoading;
+    otherStatus.status = SyncStatusSuccessful;
+    [eventBus deliverPendingEvents];
+    XCTAssertEqual(nodeObserver.deliveryCount, 1);
+    XCTAssertEqual(nodeObserver.receivedEvents.firstObject.nodeStatus, observedStatus);
+    XCTAssertEqual(allNodesObserver.deliveryCount, 2, @"Observers of all nodes should receive a single batch per frame");
+    XCTAssertEqual(allNodesObserver.receivedEvents.count, 3);
+    
+    [eventBus removeObserver:nodeObserver];
+    [eventBus removeObserver:allNodesObserver];
+}
+
+/**
+ * Simulates a 500 file sync reporting progress from a background queue while a screen of cells observes a few of the nodes,
+ * and measures the main thread time spent delivering the updates.
+ */
+- (void)testSyntheticSyncMainThreadPerformance
+{
+    SyncProgressEventBus *eventBus = [SyncProgressEventBus sharedBus];
+    [eventBus deliverPendingEvents];
+    
+    NSMutableArray<SyncNodeStatus *> *nodeStatuses = [NSMutableArray arrayWithCapacity:kSyncProgressEventBusTestNodeCount];
+    for (NSUInteger index = 0; index < kSyncProgressEventBusTestNodeCount; index++)
+    {
+        SyncNodeStatus *nodeStatus = [[SyncNodeStatus alloc] initWithNodeId:[[NSUUID UUID] UUIDString]];
+        nodeStatus.totalBytesToTransfer = kSyncProgressEventBusTestTicksPerNode * 1024;
+        [nodeStatuses addObject:nodeStatus];
+    }
+    
+    NSMutableArray *observers = [NSMutableArray array];
+    for (NSUInteger index = 0; index < kSyncProgressEventBusTestVisibleNodeCount; index++)
+    {
+        SyncProgressTestObserver *observer = [SyncProgressTestObserver new];
+        [eventBus addObserver:observer forNodeId:nodeStatuses[index].nodeId];
+        [observers addObject:observer];
+    }
+    [eventBus deliverPendingEvents];
+    
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        dispatch_apply(kSyncProgressEventBusTestNodeCount, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t index) {
+            SyncNodeStatus *nodeStatus = nodeStatuses[index];
+            nodeStatus.status = SyncStatusLoading;
+            for (unsigned long long tick = 1; tick <= kSyncProgressEventBusTestTicksPerNode; tick++)
+            {
+                nodeStatus.bytesTransfered = tick * 1024;
+            }
+            nodeStatus.status = SyncStatusSuccessful;
+        });
+        
+        [self startMeasuring];
+        [eventBus deliverPendingEvents];
+        [self stopMeasuring];
+    }];
+    
+    for (SyncProgressTestObserver *observer in observers)
+    {
+        XCTAssertEqual(observer.receivedEvents.count, observer.deliveryCount, @"Each delivery should carry a single event for the observed node");
+        [eventBus removeObserver:observer];
+    }
+}
+
+@end
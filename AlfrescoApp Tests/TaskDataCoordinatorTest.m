@@ -0,0 +1,379 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "TaskDataCoordinatorTest.h"
+#import "TaskDataCoordinator.h"
+#import "TaskGroupItem.h"
+#import "NodeCollection.h"
+
+static NSTimeInterval const kTaskDataCoordinatorTestLatency = 0.3;
+static NSString * const kTaskDataCoordinatorTestUsername = @"alice";
+
+/**
+ * Stand-in for AlfrescoWorkflowTask and AlfrescoWorkflowProcess exposing the properties the groups filter and sort on
+ * and the cells show.
+ */
+@interface TaskDataCoordinatorTestTask : NSObject
+@property (nonatomic, strong) NSString *identifier;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSString *summary;
+@property (nonatomic, strong) NSNumber *priority;
+@property (nonatomic, strong) NSDate *dueAt;
+@property (nonatomic, strong) NSString *processDefinitionIdentifier;
+@property (nonatomic, strong) NSString *initiatorUsername;
+@end
+
+@implementation TaskDataCoordinatorTestTask
+
++ (instancetype)taskWithIndex:(NSUInteger)index
+{
+    TaskDataCoordinatorTestTask *task = [self new];
+    task.identifier = [NSString stringWithFormat:@"activiti$%lu", (unsigned long)index];
+    task.name = @"Adhoc Task";
+    task.summary = [NSString stringWithFormat:@"Task %lu", (unsigned long)index];
+    task.priority = @2;
+    task.dueAt = [NSDate dateWithTimeIntervalSince1970:86400 * index];
+    task.processDefinitionIdentifier = @"activitiAdhoc:1:4";
+    task.initiatorUsername = kTaskDataCoordinatorTestUsername;
+    return task;
+}
+
+- (instancetype)copyWithSummary:(NSString *)summary
+{
+    TaskDataCoordinatorTestTask *task = [TaskDataCoordinatorTestTask new];
+    task.identifier = self.identifier;
+    task.name = self.name;
+    task.summary = summary;
+    task.priority = self.priority;
+    task.dueAt = self.dueAt;
+    task.processDefinitionIdentifier = self.processDefinitionIdentifier;
+    task.initiatorUsername = self.initiatorUsername;
+    return task;
+}
+
+@end
+
+/**
+ * Answers both feeds from arrays after a fixed latency, counting the requests made.
+ */
+@interface TaskDataCoordinatorTestService : NSObject <TaskDataCoordinatorService>
+@property (nonatomic, assign) NSTimeInterval latency;
+@property (nonatomic, strong) NSArray *tasks;
+@property (nonatomic, strong) NSArray *processes;
+@property (nonatomic, strong) NSError *processesError;
+@property (nonatomic, assign) NSUInteger numberOfTaskRequests;
+@property (nonatomic, assign) NSUInteger numberOfProcessRequests;
+@end
+
+@implementation TaskDataCoordinatorTestService
+
+- (AlfrescoRequest *)answerWithItems:(NSArray *)items error:(NSError *)error listingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    NSUInteger start = MIN((NSUInteger)listingContext.skipCount, items.count);
+    NSUInteger length = MIN((NSUInteger)listingContext.maxItems, items.count - start);
+    NSArray *page = [items subarrayWithRange:NSMakeRange(start, length)];
+    BOOL hasMoreItems = (start + length < items.count);
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.latency * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        if (error)
+        {
+            completionBlock(nil, error);
+        }
+        else
+        {
+            completionBlock([[AlfrescoPagingResult alloc] initWithArray:page hasMoreItems:hasMoreItems totalItems:(int)items.count], nil);
+        }
+    });
+    return [AlfrescoRequest new];
+}
+
+- (AlfrescoRequest *)retrieveTasksWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    self.numberOfTaskRequests++;
+    return [self answerWithItems:self.tasks error:nil listingContext:listingContext completionBlock:completionBlock];
+}
+
+- (AlfrescoRequest *)retrieveProcessesWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    self.numberOfProcessRequests++;
+    return [self answerWithItems:self.processes error:self.processesError listingContext:listingContext completionBlock:completionBlock];
+}
+
+@end
+
+@interface TaskDataCoordinatorTest ()
+@property (nonatomic, strong) TaskDataCoordinatorTestService *service;
+@property (nonatomic, strong) NSString *filePath;
+@end
+
+@implementation TaskDataCoordinatorTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.service = [TaskDataCoordinatorTestService new];
+    self.service.latency = kTaskDataCoordinatorTestLatency;
+    self.service.tasks = [self tasksInRange:NSMakeRange(0, 10)];
+    self.service.processes = [self tasksInRange:NSMakeRange(100, 5)];
+    self.filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.filePath error:nil];
+    [super tearDown];
+}
+
+- (NSArray *)tasksInRange:(NSRange)range
+{
+    NSMutableArray *tasks = [NSMutableArray arrayWithCapacity:range.length];
+    for (NSUInteger index = range.location; index < NSMaxRange(range); index++)
+    {
+        [tasks addObject:[TaskDataCoordinatorTestTask taskWithIndex:index]];
+    }
+    return tasks;
+}
+
+- (AlfrescoWorkflowTask *)workflowTaskWithIdentifier:(NSString *)identifier
+{
+    NSDictionary *entry = @{@"id" : identifier,
+                            @"processId" : @"1",
+                            @"processDefinitionId" : @"activitiAdhoc:1:4",
+                            @"name" : @"Adhoc Task",
+                            @"description" : [NSString stringWithFormat:@"Task %@", identifier],
+                            @"priority" : @2,
+                            @"startedAt" : @"2020-01-01T10:00:00.000+0000"};
+    return [[AlfrescoWorkflowTask alloc] initWithProperties:@{@"entry" : entry}];
+}
+
+- (AlfrescoWorkflowProcess *)workflowProcessWithIdentifier:(NSString *)identifier
+{
+    NSDictionary *entry = @{@"id" : identifier,
+                            @"processDefinitionId" : @"activitiAdhoc:1:4",
+                            @"processDefinitionKey" : @"activitiAdhoc",
+                            @"startUserId" : kTaskDataCoordinatorTestUsername,
+                            @"startedAt" : @"2020-01-01T10:00:00.000+0000"};
+    return [[AlfrescoWorkflowProcess alloc] initWithProperties:@{@"entry" : entry}];
+}
+
+- (TaskDataCoordinator *)coordinatorWithFilePath:(NSString *)filePath pageSize:(int)pageSize
+{
+    NSPredicate *supportedTasksPredicate = [NSPredicate predicateWithFormat:@"processDefinitionIdentifier CONTAINS %@", @"activiti"];
+    NSPredicate *initiatorPredicate = [NSPredicate predicateWithFormat:@"initiatorUsername like %@", kTaskDataCoordinatorTestUsername];
+    TaskGroupItem *myTasks = [[TaskGroupItem alloc] initWithTitle:@"My Tasks" filteringPredicate:supportedTasksPredicate];
+    TaskGroupItem *tasksIStarted = [[TaskGroupItem alloc] initWithTitle:@"Tasks I Started" filteringPredicate:[NSCompoundPredicate andPredicateWithSubpredicates:@[supportedTasksPredicate, initiatorPredicate]]];
+    AlfrescoListingContext *listingContext = [[AlfrescoListingContext alloc] initWithMaxItems:pageSize skipCount:0];
+    
+    return [[TaskDataCoordinator alloc] initWithService:self.service myTasks:myTasks tasksIStarted:tasksIStarted listingContext:listingContext filePath:filePath];
+}
+
+- (void)refreshCoordinator:(TaskDataCoordinator *)coordinator completionBlock:(TaskDataCoordinatorCompletionBlock)completionBlock
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Refreshed"];
+    expectation.assertForOverFulfill = YES;
+    [coordinator refreshWithCompletionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+        if (completionBlock)
+        {
+            completionBlock(changes, error);
+        }
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)waitForInterval:(NSTimeInterval)interval
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Waited"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:interval + 2 handler:nil];
+}
+
+#pragma mark - Refreshing
+
+- (void)testBothFeedsAreFetchedConcurrentlyWithOneUpdate
+{
+    TaskDataCoordinator *coordinator = [self coordinatorWithFilePath:nil pageSize:50];
+    __block NSUInteger numberOfUpdates = 0;
+    
+    NSDate *start = [NSDate date];
+    [self refreshCoordinator:coordinator completionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+        numberOfUpdates++;
+        XCTAssertEqual(changes.insertedIndexPaths.count, 10);
+    }];
+    NSTimeInterval refreshTime = -[start timeIntervalSinceNow];
+    
+    // Fetched one after the other, the feeds would take twice the latency
+    XCTAssertLessThan(refreshTime, kTaskDataCoordinatorTestLatency * 1.6);
+    [self waitForInterval:kTaskDataCoordinatorTestLatency];
+    XCTAssertEqual(numberOfUpdates, 1);
+    XCTAssertEqual(self.service.numberOfTaskRequests, 1);
+    XCTAssertEqual(self.service.numberOfProcessRequests, 1);
+    XCTAssertEqual([coordinator taskGroupItemForFilter:TaskDataCoordinatorFilterMyTasks].numberOfTasksAfterFiltering, 10);
+    XCTAssertEqual([coordinator taskGroupItemForFilter:TaskDataCoordinatorFilterTasksIStarted].numberOfTasksAfterFiltering, 5);
+}
+
+- (void)testRefreshesRequestedDuringARefreshShareTheNextOne
+{
+    TaskDataCoordinator *coordinator = [self coordinatorWithFilePath:nil pageSize:50];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Every caller answered"];
+    expectation.expectedFulfillmentCount = 3;
+    expectation.assertForOverFulfill = YES;
+    NSMutableArray *changesByCaller = [NSMutableArray array];
+    
+    for (NSUInteger caller = 0; caller < 3; caller++)
+    {
+        [coordinator refreshWithCompletionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+            XCTAssertNotNil(changes);
+            [changesByCaller addObject:changes];
+            [expectation fulfill];
+        }];
+        
+        // The feeds change while the first refresh is running
+        self.service.tasks = [self tasksInRange:NSMakeRange(0, 12)];
+    }
+    XCTAssertTrue(coordinator.isRefreshing);
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    
+    XCTAssertFalse(coordinator.isRefreshing);
+    XCTAssertEqual(self.service.numberOfTaskRequests, 2);
+    XCTAssertEqual(self.service.numberOfProcessRequests, 2);
+    XCTAssertEqual([coordinator taskGroupItemForFilter:TaskDataCoordinatorFilterMyTasks].numberOfTasksAfterFiltering, 12, @"Callers that joined should see what changed during the first refresh");
+    XCTAssertNotEqual(changesByCaller[0], changesByCaller[1]);
+    XCTAssertEqual(changesByCaller[1], changesByCaller[2]);
+}
+
+- (void)testRefreshReplacesTasksMatchedByIdentifier
+{
+    TaskDataCoordinator *coordinator = [self coordinatorWithFilePath:nil pageSize:50];
+    [self refreshCoordinator:coordinator completionBlock:nil];
+    
+    // One task completed, one renamed and one new, each returned as a new object
+    NSMutableArray *tasks = [NSMutableArray array];
+    for (TaskDataCoordinatorTestTask *task in self.service.tasks)
+    {
+        [tasks addObject:[task copyWithSummary:task.summary]];
+    }
+    [tasks removeObjectAtIndex:2];
+    tasks[5] = [tasks[5] copyWithSummary:@"Renamed"];
+    [tasks addObject:[TaskDataCoordinatorTestTask taskWithIndex:50]];
+    self.service.tasks = tasks;
+    
+    [self refreshCoordinator:coordinator completionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+        XCTAssertEqual(changes.previousCount, 10);
+        XCTAssertEqualObjects(changes.deletedIndexPaths, @[[NSIndexPath indexPathForItem:2 inSection:0]]);
+        XCTAssertEqualObjects(changes.insertedIndexPaths, @[[NSIndexPath indexPathForItem:9 inSection:0]]);
+        XCTAssertEqualObjects(changes.reloadedIndexPaths, @[[NSIndexPath indexPathForItem:6 inSection:0]]);
+        XCTAssertEqual(changes.movedIndexPaths.count, 0);
+    }];
+    XCTAssertEqual(coordinator.taskGroupItem.numberOfTasksAfterFiltering, 10);
+}
+
+- (void)testRefreshFetchesAsManyTasksAsAreLoaded
+{
+    self.service.tasks = [self tasksInRange:NSMakeRange(0, 25)];
+    TaskDataCoordinator *coordinator = [self coordinatorWithFilePath:nil pageSize:10];
+    [self refreshCoordinator:coordinator completionBlock:nil];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Page loaded"];
+    [coordinator loadMoreWithCompletionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+        XCTAssertEqual(changes.insertedIndexPaths.count, 10);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(coordinator.taskGroupItem.numberOfTasksBeforeFiltering, 20);
+    
+    [self refreshCoordinator:coordinator completionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+        XCTAssertFalse(changes.hasChanges);
+    }];
+    XCTAssertEqual(coordinator.taskGroupItem.numberOfTasksBeforeFiltering, 20);
+    XCTAssertTrue(coordinator.taskGroupItem.hasMoreItems);
+}
+
+- (void)testFailedFeedKeepsItsTasks
+{
+    TaskDataCoordinator *coordinator = [self coordinatorWithFilePath:nil pageSize:50];
+    [self refreshCoordinator:coordinator completionBlock:nil];
+    
+    self.service.processesError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil];
+    [self refreshCoordinator:coordinator completionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+        XCTAssertNotNil(changes, @"The feed shown succeeded");
+        XCTAssertNil(error);
+    }];
+    
+    coordinator.filter = TaskDataCoordinatorFilterTasksIStarted;
+    XCTAssertEqual(coordinator.taskGroupItem.numberOfTasksAfterFiltering, 5);
+    [self refreshCoordinator:coordinator completionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+        XCTAssertNil(changes);
+        XCTAssertNotNil(error);
+    }];
+    XCTAssertEqual(coordinator.taskGroupItem.numberOfTasksAfterFiltering, 5);
+}
+
+#pragma mark - Switching and Storing
+
+- (void)testSwitchingFiltersAfterFirstLoadNeedsNoRequest
+{
+    TaskDataCoordinator *coordinator = [self coordinatorWithFilePath:nil pageSize:50];
+    XCTAssertFalse(coordinator.hasLoadedTasks);
+    [self refreshCoordinator:coordinator completionBlock:nil];
+    
+    coordinator.filter = TaskDataCoordinatorFilterTasksIStarted;
+    XCTAssertTrue(coordinator.hasLoadedTasks);
+    XCTAssertEqualObjects(coordinator.taskGroupItem.title, @"Tasks I Started");
+    XCTAssertEqual(coordinator.taskGroupItem.numberOfTasksAfterFiltering, 5);
+    
+    coordinator.filter = TaskDataCoordinatorFilterMyTasks;
+    XCTAssertEqual(coordinator.taskGroupItem.numberOfTasksAfterFiltering, 10);
+    XCTAssertEqual(self.service.numberOfTaskRequests, 1);
+    XCTAssertEqual(self.service.numberOfProcessRequests, 1);
+}
+
+- (void)testStoredTasksAreShownStraightAway
+{
+    // The stored tasks are read with secure coding, so they are the SDK's own classes rather than stand-ins
+    self.service.tasks = @[[self workflowTaskWithIdentifier:@"1"], [self workflowTaskWithIdentifier:@"2"]];
+    self.service.processes = @[[self workflowProcessWithIdentifier:@"100"]];
+    TaskGroupItem *(^unfilteredTaskGroupItem)(NSString *) = ^TaskGroupItem *(NSString *title) {
+        return [[TaskGroupItem alloc] initWithTitle:title filteringPredicate:[NSPredicate predicateWithValue:YES]];
+    };
+    TaskDataCoordinator *(^storingCoordinator)(void) = ^TaskDataCoordinator *{
+        return [[TaskDataCoordinator alloc] initWithService:self.service myTasks:unfilteredTaskGroupItem(@"My Tasks") tasksIStarted:unfilteredTaskGroupItem(@"Tasks I Started") listingContext:nil filePath:self.filePath];
+    };
+    
+    TaskDataCoordinator *coordinator = storingCoordinator();
+    [self refreshCoordinator:coordinator completionBlock:nil];
+    [self waitForInterval:0.5];
+    
+    TaskDataCoordinator *reopenedCoordinator = storingCoordinator();
+    XCTAssertTrue(reopenedCoordinator.hasLoadedTasks);
+    NSArray *storedTasks = reopenedCoordinator.taskGroupItem.tasksAfterFiltering;
+    XCTAssertEqual(storedTasks.count, 2);
+    XCTAssertTrue([storedTasks.firstObject isKindOfClass:[AlfrescoWorkflowTask class]]);
+    XCTAssertEqualObjects([NSSet setWithArray:[storedTasks valueForKey:@"identifier"]], [NSSet setWithArray:[self.service.tasks valueForKey:@"identifier"]]);
+    
+    NSArray *storedProcesses = [reopenedCoordinator taskGroupItemForFilter:TaskDataCoordinatorFilterTasksIStarted].tasksAfterFiltering;
+    XCTAssertEqual(storedProcesses.count, 1);
+    XCTAssertTrue([storedProcesses.firstObject isKindOfClass:[AlfrescoWorkflowProcess class]]);
+    XCTAssertEqualObjects([storedProcesses.firstObject identifier], [self.service.processes.firstObject identifier]);
+    XCTAssertEqual(self.service.numberOfTaskRequests, 1);
+}
+
+@end
@@ -0,0 +1,215 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "TaskGroupItemTest.h"
+#import "TaskGroupItem.h"
+
+static NSUInteger const kTaskGroupItemTestPageCount = 50;
+static NSUInteger const kTaskGroupItemTestPageSize = 100;
+
+/**
+ * Stand-in for AlfrescoWorkflowTask exposing the properties the group filters and sorts on.
+ */
+@interface TaskGroupItemTestTask : NSObject
+@property (nonatomic, strong) NSString *identifier;
+@property (nonatomic, strong) NSString *processDefinitionIdentifier;
+@property (nonatomic, strong) NSNumber *priority;
+@property (nonatomic, strong) NSDate *dueAt;
+@end
+
+@implementation TaskGroupItemTestTask
+
++ (instancetype)taskWithIdentifier:(NSString *)identifier priority:(NSInteger)priority dueAt:(NSDate *)dueAt
+{
+    TaskGroupItemTestTask *task = [self new];
+    task.identifier = identifier;
+    task.processDefinitionIdentifier = @"activitiAdhoc:1:4";
+    task.priority = @(priority);
+    task.dueAt = dueAt;
+    return task;
+}
+
+@end
+
+@implementation TaskGroupItemTest
+
+- (NSPredicate *)supportedTasksPredicate
+{
+    return [NSPredicate predicateWithFormat:@"processDefinitionIdentifier CONTAINS %@ AND NOT (processDefinitionIdentifier CONTAINS[c] 'pooled')", @"activiti"];
+}
+
+/*
+ * Pages of tasks in no particular order, with repeated priorities and due dates and some pooled tasks that are filtered out.
+ */
+- (NSArray *)pagesOfTasks
+{
+    srand48(49);
+    NSMutableArray *pages = [NSMutableArray arrayWithCapacity:kTaskGroupItemTestPageCount];
+    for (NSUInteger pageIndex = 0; pageIndex < kTaskGroupItemTestPageCount; pageIndex++)
+    {
+        NSMutableArray *page = [NSMutableArray arrayWithCapacity:kTaskGroupItemTestPageSize];
+        for (NSUInteger taskIndex = 0; taskIndex < kTaskGroupItemTestPageSize; taskIndex++)
+        {
+            NSString *identifier = [NSString stringWithFormat:@"activiti$%lu", (unsigned long)(pageIndex * kTaskGroupItemTestPageSize + taskIndex)];
+            NSDate *dueAt = [NSDate dateWithTimeIntervalSince1970:86400 * (lrand48() % 30)];
+            TaskGroupItemTestTask *task = [TaskGroupItemTestTask taskWithIdentifier:identifier priority:1 + lrand48() % 3 dueAt:dueAt];
+            if (lrand48() % 10 == 0)
+            {
+                task.processDefinitionIdentifier = @"activitiReviewPooled:1:8";
+            }
+            [page addObject:task];
+        }
+        [pages addObject:page];
+    }
+    return pages;
+}
+
+/*
+ * How the group filtered and sorted tasks before merging pages: the whole list, every page.
+ */
+- (NSArray *)fullySortedTasks:(NSArray *)tasks predicate:(NSPredicate *)predicate
+{
+    NSArray *filteredTasks = [tasks filteredArrayUsingPredicate:predicate];
+    NSSortDescriptor *prioritySortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"priority" ascending:YES];
+    NSSortDescriptor *dueDateSortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"dueAt" ascending:NO comparator:^NSComparisonResult(NSDate *obj1, NSDate *obj2) {
+        return [obj2 compare:obj1];
+    }];
+    return [filteredTasks sortedArrayUsingDescriptors:@[prioritySortDescriptor, dueDateSortDescriptor]];
+}
+
+- (NSArray *)sortKeysOfTasks:(NSArray *)tasks
+{
+    NSMutableArray *sortKeys = [NSMutableArray arrayWithCapacity:tasks.count];
+    for (TaskGroupItemTestTask *task in tasks)
+    {
+        [sortKeys addObject:[NSString stringWithFormat:@"%@|%.0f", task.priority, task.dueAt.timeIntervalSince1970]];
+    }
+    return sortKeys;
+}
+
+#pragma mark - Ordering
+
+- (void)testMergedPagesMatchFullSort
+{
+    NSPredicate *predicate = [self supportedTasksPredicate];
+    TaskGroupItem *group = [[TaskGroupItem alloc] initWithTitle:@"Tasks" filteringPredicate:predicate];
+    NSMutableArray *allTasks = [NSMutableArray array];
+    
+    for (NSArray *page in [self pagesOfTasks])
+    {
+        [group addAndApplyFilteringToTasks:page];
+        [allTasks addObjectsFromArray:page];
+        
+        NSArray *expectedTasks = [self fullySortedTasks:allTasks predicate:predicate];
+        XCTAssertEqualObjects([self sortKeysOfTasks:group.tasksAfterFiltering], [self sortKeysOfTasks:expectedTasks]);
+        XCTAssertEqualObjects([NSSet setWithArray:group.tasksAfterFiltering], [NSSet setWithArray:expectedTasks]);
+    }
+    XCTAssertEqual(group.numberOfTasksBeforeFiltering, kTaskGroupItemTestPageCount * kTaskGroupItemTestPageSize);
+}
+
+- (void)testTasksWithEqualKeysKeepArrivalOrder
+{
+    NSDate *dueAt = [NSDate dateWithTimeIntervalSince1970:0];
+    TaskGroupItemTestTask *firstTask = [TaskGroupItemTestTask taskWithIdentifier:@"activiti$1" priority:2 dueAt:dueAt];
+    TaskGroupItemTestTask *secondTask = [TaskGroupItemTestTask taskWithIdentifier:@"activiti$2" priority:2 dueAt:dueAt];
+    TaskGroupItemTestTask *urgentTask = [TaskGroupItemTestTask taskWithIdentifier:@"activiti$3" priority:1 dueAt:dueAt];
+    TaskGroupItem *group = [[TaskGroupItem alloc] initWithTitle:@"Tasks" filteringPredicate:[self supportedTasksPredicate]];
+    
+    [group addAndApplyFilteringToTasks:@[firstTask]];
+    [group addAndApplyFilteringToTasks:@[urgentTask, secondTask]];
+    
+    XCTAssertEqualObjects(group.tasksAfterFiltering, (@[urgentTask, firstTask, secondTask]));
+}
+
+- (void)testTasksWithoutDueDateSortLast
+{
+    TaskGroupItemTestTask *undatedTask = [TaskGroupItemTestTask taskWithIdentifier:@"activiti$1" priority:2 dueAt:nil];
+    TaskGroupItemTestTask *laterTask = [TaskGroupItemTestTask taskWithIdentifier:@"activiti$2" priority:2 dueAt:[NSDate dateWithTimeIntervalSince1970:200]];
+    TaskGroupItemTestTask *earlierTask = [TaskGroupItemTestTask taskWithIdentifier:@"activiti$3" priority:2 dueAt:[NSDate dateWithTimeIntervalSince1970:100]];
+    TaskGroupItem *group = [[TaskGroupItem alloc] initWithTitle:@"Tasks" filteringPredicate:[self supportedTasksPredicate]];
+    
+    [group addAndApplyFilteringToTasks:@[undatedTask, laterTask]];
+    [group addAndApplyFilteringToTasks:@[earlierTask]];
+    
+    XCTAssertEqualObjects(group.tasksAfterFiltering, (@[earlierTask, laterTask, undatedTask]));
+}
+
+#pragma mark - Removal
+
+- (void)testRemovingTasksMatchesByIdentifierAndKeepsOrder
+{
+    TaskGroupItem *group = [[TaskGroupItem alloc] initWithTitle:@"Tasks" filteringPredicate:[self supportedTasksPredicate]];
+    TaskGroupItemTestTask *filteredOutTask = [TaskGroupItemTestTask taskWithIdentifier:@"activiti$pooled" priority:1 dueAt:nil];
+    filteredOutTask.processDefinitionIdentifier = @"activitiReviewPooled:1:8";
+    NSArray *page = [[self pagesOfTasks].firstObject arrayByAddingObject:filteredOutTask];
+    [group addAndApplyFilteringToTasks:page];
+    NSArray *sortedTasks = [group.tasksAfterFiltering copy];
+    
+    // Copies of the tasks, as returned by a later request
+    TaskGroupItemTestTask *removedTask = sortedTasks[3];
+    TaskGroupItemTestTask *removedTaskCopy = [TaskGroupItemTestTask taskWithIdentifier:removedTask.identifier priority:removedTask.priority.integerValue dueAt:removedTask.dueAt];
+    [group removeTasks:@[removedTaskCopy, filteredOutTask]];
+    
+    NSMutableArray *expectedTasks = [sortedTasks mutableCopy];
+    [expectedTasks removeObject:removedTask];
+    XCTAssertEqualObjects(group.tasksAfterFiltering, expectedTasks);
+    XCTAssertEqual(group.numberOfTasksBeforeFiltering, page.count - 2);
+    
+    [group addAndApplyFilteringToTasks:@[removedTaskCopy]];
+    XCTAssertEqualObjects([self sortKeysOfTasks:group.tasksAfterFiltering], [self sortKeysOfTasks:sortedTasks]);
+}
+
+#pragma mark - Performance
+
+/*
+ * Cumulative cost of paging through every task, merging each page into the sorted tasks.
+ */
+- (void)testPerformancePagingMergesEachPage
+{
+    NSArray *pages = [self pagesOfTasks];
+    NSPredicate *predicate = [self supportedTasksPredicate];
+    
+    [self measureBlock:^{
+        TaskGroupItem *group = [[TaskGroupItem alloc] initWithTitle:@"Tasks" filteringPredicate:predicate];
+        for (NSArray *page in pages)
+        {
+            [group addAndApplyFilteringToTasks:page];
+        }
+    }];
+}
+
+/*
+ * The same paging, filtering and sorting every task received so far each time, for comparison.
+ */
+- (void)testPerformancePagingResortsAllTasks
+{
+    NSArray *pages = [self pagesOfTasks];
+    NSPredicate *predicate = [self supportedTasksPredicate];
+    
+    [self measureBlock:^{
+        NSMutableArray *allTasks = [NSMutableArray array];
+        for (NSArray *page in pages)
+        {
+            [allTasks addObjectsFromArray:page];
+            [self fullySortedTasks:allTasks predicate:predicate];
+        }
+    }];
+}
+
+@end
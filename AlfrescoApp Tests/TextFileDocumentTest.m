@@ -0,0 +1,278 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <AlfrescoSDK-iOS/AlfrescoSDK.h>
+#import "TextFileDocumentTest.h"
+#import "TextFileDocument.h"
+
+static NSUInteger const kTextFileDocumentTestSmallFileSize = 1024 * 1024;
+static NSUInteger const kTextFileDocumentTestLargeFileSize = 16 * 1024 * 1024;
+
+@interface TextFileDocumentTest ()
+@property (nonatomic, strong) NSString *folderPath;
+@end
+
+@implementation TextFileDocumentTest
+
+- (void)setUp
+{
+    [super setUp];
+    self.folderPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    [[NSFileManager defaultManager] createDirectoryAtPath:self.folderPath withIntermediateDirectories:YES attributes:nil error:nil];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.folderPath error:nil];
+    [super tearDown];
+}
+
+- (NSString *)writeFileWithName:(NSString *)fileName data:(NSData *)data
+{
+    NSString *filePath = [self.folderPath stringByAppendingPathComponent:fileName];
+    [data writeToFile:filePath atomically:YES];
+    return filePath;
+}
+
+- (NSString *)writeLogFileWithName:(NSString *)fileName size:(NSUInteger)size
+{
+    NSMutableString *text = [NSMutableString stringWithCapacity:size];
+    NSUInteger line = 0;
+    while (text.length < size)
+    {
+        [text appendFormat:@"2020-01-01 00:00:%02lu,line %lu,Ünïcödé value ✓\n", (unsigned long)(line % 60), (unsigned long)line];
+        line++;
+    }
+    return [self writeFileWithName:fileName data:[text dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+- (NSData *)dataWithByteOrderMark:(const uint8_t *)mark length:(NSUInteger)length text:(NSString *)text encoding:(NSStringEncoding)encoding
+{
+    NSMutableData *data = [NSMutableData dataWithBytes:mark length:length];
+    [data appendData:[text dataUsingEncoding:encoding]];
+    return data;
+}
+
+#pragma mark - Edits
+
+- (void)testEditsProduceExpectedText
+{
+    NSString *filePath = [self writeFileWithName:@"edits.txt" data:[@"The quick brown fox" dataUsingEncoding:NSUTF8StringEncoding]];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    XCTAssertFalse(document.isModified);
+    XCTAssertEqual(document.firstModifiedIndex, NSNotFound);
+    
+    [document replaceCharactersInRange:NSMakeRange(4, 5) withString:@"slow"];
+    [document replaceCharactersInRange:NSMakeRange(document.length, 0) withString:@" jumps"];
+    [document replaceCharactersInRange:NSMakeRange(0, 4) withString:@""];
+    
+    XCTAssertEqualObjects(document.text, @"slow brown fox jumps");
+    XCTAssertEqual(document.length, document.text.length);
+    XCTAssertEqual(document.firstModifiedIndex, 0);
+    XCTAssertTrue(document.isModified);
+}
+
+- (void)testTypingThenDeletingLeavesDocumentUnmodified
+{
+    NSString *filePath = [self writeFileWithName:@"typing.txt" data:[@"Hello world" dataUsingEncoding:NSUTF8StringEncoding]];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    
+    NSUInteger insertionIndex = 5;
+    for (NSString *character in @[@",", @" ", @"t", @"h", @"e"])
+    {
+        [document replaceCharactersInRange:NSMakeRange(insertionIndex++, 0) withString:character];
+    }
+    XCTAssertEqualObjects(document.text, @"Hello, the world");
+    XCTAssertTrue(document.isModified);
+    
+    [document replaceCharactersInRange:NSMakeRange(5, 5) withString:@""];
+    XCTAssertEqualObjects(document.text, @"Hello world");
+    XCTAssertEqual(document.firstModifiedIndex, 5);
+    XCTAssertFalse(document.isModified, @"Putting back what was there should not count as a change");
+}
+
+- (void)testSynchronisingReplacesOnlyTheDifference
+{
+    NSString *filePath = [self writeFileWithName:@"sync.txt" data:[@"alpha beta gamma" dataUsingEncoding:NSUTF8StringEncoding]];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    
+    [document synchroniseWithText:@"alpha BETA gamma"];
+    XCTAssertEqualObjects(document.text, @"alpha BETA gamma");
+    XCTAssertEqual(document.firstModifiedIndex, 6);
+    
+    [document synchroniseWithText:@"alpha beta gamma"];
+    XCTAssertFalse(document.isModified);
+}
+
+#pragma mark - Encodings
+
+- (void)testEncodingIsDetectedFromByteOrderMarkOrPrefix
+{
+    static const uint8_t utf16Mark[] = {0xFF, 0xFE};
+    NSUInteger byteOrderMarkLength = 0;
+    
+    NSData *utf16Data = [self dataWithByteOrderMark:utf16Mark length:sizeof(utf16Mark) text:@"text" encoding:NSUTF16LittleEndianStringEncoding];
+    XCTAssertEqual([TextFileDocument encodingOfData:utf16Data byteOrderMarkLength:&byteOrderMarkLength], NSUTF16LittleEndianStringEncoding);
+    XCTAssertEqual(byteOrderMarkLength, 2);
+    
+    XCTAssertEqual([TextFileDocument encodingOfData:[@"naïve" dataUsingEncoding:NSUTF8StringEncoding] byteOrderMarkLength:&byteOrderMarkLength], NSUTF8StringEncoding);
+    XCTAssertEqual(byteOrderMarkLength, 0);
+    
+    XCTAssertEqual([TextFileDocument encodingOfData:[@"naïve" dataUsingEncoding:NSWindowsCP1252StringEncoding] byteOrderMarkLength:NULL], NSWindowsCP1252StringEncoding);
+}
+
+- (void)testPrefixEndingMidCharacterIsStillUTF8
+{
+    // Each "é" is two bytes, so the detection prefix ends half way through one
+    NSMutableString *text = [NSMutableString stringWithString:@"a"];
+    while (text.length < 40000)
+    {
+        [text appendString:@"é"];
+    }
+    NSString *filePath = [self writeFileWithName:@"prefix.txt" data:[text dataUsingEncoding:NSUTF8StringEncoding]];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    
+    XCTAssertEqual(document.encoding, NSUTF8StringEncoding);
+    XCTAssertEqualObjects(document.text, text);
+}
+
+#pragma mark - Saving
+
+- (void)testSavingMultibyteUTF8
+{
+    NSString *filePath = [self writeFileWithName:@"utf8.txt" data:[@"Grüße aus 東京 👋 und mehr" dataUsingEncoding:NSUTF8StringEncoding]];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    
+    NSRange cityRange = [document.text rangeOfString:@"東京"];
+    [document replaceCharactersInRange:cityRange withString:@"大阪"];
+    XCTAssertTrue([document saveToFile:filePath error:nil]);
+    
+    NSString *savedText = [NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil];
+    XCTAssertEqualObjects(savedText, @"Grüße aus 大阪 👋 und mehr");
+    XCTAssertFalse(document.isModified);
+}
+
+- (void)testSavingEditInsideSurrogatePairRewritesWholeCharacter
+{
+    NSString *filePath = [self writeFileWithName:@"emoji.txt" data:[@"ab👋cd" dataUsingEncoding:NSUTF8StringEncoding]];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    
+    // Swap the low surrogate of 👋 (U+1F44B) for that of 👍 (U+1F44D)
+    [document replaceCharactersInRange:NSMakeRange(3, 1) withString:[NSString stringWithFormat:@"%C", (unichar)0xDC4D]];
+    XCTAssertTrue([document saveToFile:filePath error:nil]);
+    
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil], @"ab👍cd");
+}
+
+- (void)testSavingUTF16KeepsByteOrderMarkAndEncoding
+{
+    static const uint8_t utf16Mark[] = {0xFF, 0xFE};
+    NSData *data = [self dataWithByteOrderMark:utf16Mark length:sizeof(utf16Mark) text:@"first line\nsecond line\n" encoding:NSUTF16LittleEndianStringEncoding];
+    NSString *filePath = [self writeFileWithName:@"utf16.txt" data:data];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    XCTAssertEqualObjects(document.text, @"first line\nsecond line\n");
+    
+    [document replaceCharactersInRange:NSMakeRange(11, 6) withString:@"2nd"];
+    XCTAssertTrue([document saveToFile:filePath error:nil]);
+    
+    NSData *expectedData = [self dataWithByteOrderMark:utf16Mark length:sizeof(utf16Mark) text:@"first line\n2nd line\n" encoding:NSUTF16LittleEndianStringEncoding];
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:filePath], expectedData);
+    XCTAssertEqual(document.bytesWrittenByLastSave, [@"2nd line\n" lengthOfBytesUsingEncoding:NSUTF16LittleEndianStringEncoding]);
+}
+
+- (void)testSavingUnrepresentableEditSwitchesToUTF8
+{
+    NSString *filePath = [self writeFileWithName:@"latin.txt" data:[@"café" dataUsingEncoding:NSWindowsCP1252StringEncoding]];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    XCTAssertEqual(document.encoding, NSWindowsCP1252StringEncoding);
+    
+    [document replaceCharactersInRange:NSMakeRange(document.length, 0) withString:@" ☕"];
+    XCTAssertTrue([document saveToFile:filePath error:nil]);
+    
+    XCTAssertEqual(document.encoding, NSUTF8StringEncoding);
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil], @"café ☕");
+}
+
+- (void)testSavingNearEndOfLargeFileWritesOnlyTheTail
+{
+    NSString *filePath = [self writeLogFileWithName:@"large.log" size:kTextFileDocumentTestSmallFileSize];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    NSString *expectedText = [document.text stringByAppendingString:@"appended line\n"];
+    
+    [document replaceCharactersInRange:NSMakeRange(document.length, 0) withString:@"appended line\n"];
+    XCTAssertTrue([document saveToFile:filePath error:nil]);
+    
+    XCTAssertEqual(document.bytesWrittenByLastSave, [@"appended line\n" lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil], expectedText);
+}
+
+- (void)testSavingToAnotherFileRewritesAllOfIt
+{
+    NSString *filePath = [self writeFileWithName:@"source.txt" data:[@"source text" dataUsingEncoding:NSUTF8StringEncoding]];
+    NSString *otherFilePath = [self writeFileWithName:@"other.txt" data:[@"something much longer than the source" dataUsingEncoding:NSUTF8StringEncoding]];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    
+    [document replaceCharactersInRange:NSMakeRange(6, 5) withString:@"words"];
+    XCTAssertTrue([document saveToFile:otherFilePath error:nil]);
+    
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:otherFilePath encoding:NSUTF8StringEncoding error:nil], @"source words");
+}
+
+#pragma mark - Performance
+
+- (void)measureOpeningFileOfSize:(NSUInteger)size
+{
+    NSString *filePath = [self writeLogFileWithName:@"open.log" size:size];
+    [self measureBlock:^{
+        TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+        XCTAssertGreaterThan(document.length, 0);
+    }];
+}
+
+- (void)measureSavingEditToFileOfSize:(NSUInteger)size
+{
+    NSString *filePath = [self writeLogFileWithName:@"save.log" size:size];
+    TextFileDocument *document = [[TextFileDocument alloc] initWithContentsOfFile:filePath error:nil];
+    [self measureBlock:^{
+        // An edit three quarters of the way through, as when appending to a log near its end
+        [document replaceCharactersInRange:NSMakeRange(document.length * 3 / 4, 0) withString:@"edited,"];
+        XCTAssertTrue([document saveToFile:filePath error:nil]);
+    }];
+}
+
+- (void)testOpeningSmallFilePerformance
+{
+    [self measureOpeningFileOfSize:kTextFileDocumentTestSmallFileSize];
+}
+
+- (void)testOpeningLargeFilePerformance
+{
+    [self measureOpeningFileOfSize:kTextFileDocumentTestLargeFileSize];
+}
+
+- (void)testSavingSmallFilePerformance
+{
+    [self measureSavingEditToFileOfSize:kTextFileDocumentTestSmallFileSize];
+}
+
+- (void)testSavingLargeFilePerformance
+{
+    [self measureSavingEditToFileOfSize:kTextFileDocumentTestLargeFileSize];
+}
+
+@end
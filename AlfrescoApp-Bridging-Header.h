@@ -15,3 +15,4 @@
 #import "KeychainUtils.h"
 #import "AccountManager.h"
 #import "Notifier.h"
+#import "BatchUploadQueue.h"
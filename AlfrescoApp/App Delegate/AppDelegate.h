@@ -20,6 +20,8 @@
 #import "MainMenuConfigurationViewController.h"
 #import "AccountsViewController.h"
 
+@class LaunchPipeline;
+
 @interface AppDelegate : UIResponder <UIApplicationDelegate, UITabBarControllerDelegate>
 
 @property (strong, nonatomic) UIWindow *window;
@@ -27,4 +29,9 @@
 
 - (void)updateAppFirstLaunchFlag;
 
+/*
+ * Adds the app's launch stages to the pipeline. Used when launching, and by tests measuring the launch's critical path.
+ */
+- (void)addLaunchStagesToPipeline:(LaunchPipeline *)pipeline safeMode:(BOOL)safeMode isFirstLaunch:(BOOL)isFirstLaunch launchOptions:(NSDictionary *)launchOptions;
+
 @end
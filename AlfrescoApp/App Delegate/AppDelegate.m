@@ -40,6 +40,9 @@
 #import "RealmSyncManager+CoreDataMigration.h"
 #import "RealmSyncCore.h"
 #import "AppConfigurationManager.h"
+#import "FileTypeIconCatalog.h"
+#import "LaunchPipeline.h"
+#import "ConnectivityManager.h"
 #import "AlfrescoApp-Swift.h"
 
 
@@ -52,11 +55,11 @@ static NSString * const kMDMMissingRequiredKeysKey = @"MDMMissingKeysKey";
 @interface AppDelegate() <AccountPickerPresentationDelegate>
 
 @property (nonatomic, strong) UIViewController *appRootViewController;
-@property (nonatomic, strong) CoreDataCacheHelper *cacheHelper;
 @property (nonatomic, strong) id<AlfrescoSession> session;
 @property (nonatomic, strong, readwrite) MainMenuConfigurationViewController *mainMenuViewController;
 @property (nonatomic, strong) MDMUserDefaultsConfigurationHelper *appleConfigurationHelper;
 @property (nonatomic, strong) MDMUserDefaultsConfigurationHelper *mobileIronConfigurationHelper;
+@property (nonatomic, strong) LaunchPipeline *launchPipeline;
 @end
 
 @implementation AppDelegate
@@ -83,6 +86,9 @@ static NSString * const kMDMMissingRequiredKeysKey = @"MDMMissingKeysKey";
      *
      */
     
+    // Decode the file type icons and resolve their MIME types before the first list is shown
+    [FileTypeIconCatalog preloadCatalog];
+    
     self.window = [[UIWindow alloc] initWithFrame:[[UIScreen mainScreen] bounds]];
     /**
      * Note: CFBundleVersion is updated for AdHoc builds by calling the tools/set_build_number.sh script (configured in the build pre-action).
@@ -96,111 +102,13 @@ static NSString * const kMDMMissingRequiredKeysKey = @"MDMMissingKeysKey";
     }
     
     BOOL safeMode = [[[PreferenceManager sharedManager] settingsPreferenceForIdentifier:kSettingsBundlePreferenceSafeModeKey] boolValue];
-    
-    if (!safeMode)
-    {
-        // Migrate any old accounts if required
-        [MigrationAssistant runMigrationAssistant];
-    }
-    
-    AccountManager *accountManager = [AccountManager sharedManager];
-    accountManager.realmManager = [RealmManager sharedManager];
-    accountManager.appConfigurationManager = [AppConfigurationManager sharedManager];
-    accountManager.analyticsManager = [AnalyticsManager sharedManager];
-    
     BOOL isFirstLaunch = [self isAppFirstLaunch];
-    if (isFirstLaunch)
-    {
-        if (!safeMode)
-        {
-            [[AccountManager sharedManager] removeAllAccounts];
-            [SecurityManager reset];
-        }
-        [self updateAppFirstLaunchFlag];
-    }
     
-    [MigrationAssistant runDownloadsMigration];
-    
-    if([[RealmSyncManager sharedManager] isCoreDataMigrationNeeded])
-    {
-        [[RealmSyncManager sharedManager] initiateMigrationProcess];
-    }
-    
-    if ([[RealmSyncCore sharedSyncCore] isContentMigrationNeeded])
-    {
-        [[RealmSyncCore sharedSyncCore] initiateContentMigrationProcessForAccounts:[AccountManager sharedManager].allAccounts];
-    }
-
-    // Setup the app and build it's UI
-    self.window.rootViewController = [self buildMainAppUIWithSession:nil displayingMainMenu:isFirstLaunch];
-    self.window.tintColor = [UIColor appTintColor];
-    
-    [[SecurityManager sharedManager] setup];
-    
-    // Clean up cache
-    self.cacheHelper = [[CoreDataCacheHelper alloc] init];
-    [self.cacheHelper removeAllCachedDataOlderThanNumberOfDays:@(kNumberOfDaysToKeepCachedData)];
-    
-    // Register the delegate for session updates
-    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionReceivedNotification object:nil];
-    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionRefreshedNotification object:nil];
-    
-    if ([[PreferenceManager sharedManager] shouldUsePasscodeLock] == NO)
-    {
-        // Make the window visible
-        [self.window makeKeyAndVisible];
-    }
-    
-    if (!safeMode)
-    {
-        // If there is a selected Account, attempt login
-        AccountManager *accountManager = [AccountManager sharedManager];
-        [accountManager removeCloudAccounts];
-        if (accountManager.selectedAccount)
-        {
-            // Delay to allow the UI to update - reachability check can block the main thread
-            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
-                [[LoginManager sharedManager] attemptLoginToAccount:accountManager.selectedAccount networkId:accountManager.selectedAccount.selectedNetworkId completionBlock:^(BOOL successful, id<AlfrescoSession> alfrescoSession, NSError *error) {
-                    if (!successful)
-                    {
-                        if (UserAccountTypeAIMS != accountManager.selectedAccount.accountType) {
-                            if (accountManager.selectedAccount.password.length > 0)
-                            {
-                                displayErrorMessage([ErrorDescriptions descriptionForError:error]);
-                            }
-                            else
-                            {
-                                // Missing details - possibly first launch of an MDM-configured account
-                                if ([accountManager.selectedAccount.username length] == 0)
-                                {
-                                    displayWarningMessageWithTitle(NSLocalizedString(@"accountdetails.fields.accountSettings", @"Enter user name and password"), NSLocalizedString(@"accountdetails.header.authentication", "Account Details"));
-                                }
-                                else
-                                {
-                                    displayWarningMessageWithTitle(NSLocalizedString(@"accountdetails.fields.confirmPassword", @"Confirm password"), NSLocalizedString(@"accountdetails.header.authentication", "Account Details"));
-                                }
-                            }
-                        }
-                    } else {
-                        // TODO: assess whether to handle this for all calls
-                        [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoSessionReceivedNotification object:alfrescoSession userInfo:nil];
-                    }
-                    
-                    if ([launchOptions objectForKey:UIApplicationLaunchOptionsURLKey])
-                    {
-                        NSURL *url = [launchOptions objectForKey:UIApplicationLaunchOptionsURLKey];
-                        [[FileHandlerManager sharedManager] handleURL:url sourceApplication:nil annotation:nil session:alfrescoSession];
-                        self.mainMenuViewController.autoselectDefaultMenuOption = NO;
-                    }
-                    
-                    [self performSelector:@selector(showSunsetAppView) withObject: nil afterDelay:1.0];
-                }];
-            });
-        } else {
-            // user is not logged in
-            [self showSunsetAppView];
-        }
-    }
+    // Only what the first screen needs runs before it is shown; see addLaunchStagesToPipeline:
+    self.launchPipeline = [[LaunchPipeline alloc] init];
+    [self addLaunchStagesToPipeline:self.launchPipeline safeMode:safeMode isFirstLaunch:isFirstLaunch launchOptions:launchOptions];
+    [self.launchPipeline runCriticalStages];
+    [self.launchPipeline runDeferredStagesAfterFirstFrame];
     
     if (safeMode)
     {
@@ -265,8 +173,167 @@ static NSString * const kMDMMissingRequiredKeysKey = @"MDMMissingKeysKey";
     return supportedOrientations;
 }
 
+#pragma mark - Launch Stages
+
+- (void)addLaunchStagesToPipeline:(LaunchPipeline *)pipeline safeMode:(BOOL)safeMode isFirstLaunch:(BOOL)isFirstLaunch launchOptions:(NSDictionary *)launchOptions
+{
+    static NSString * const kLaunchStageAccounts = @"Accounts";
+    static NSString * const kLaunchStageLocalContent = @"LocalContent";
+    static NSString * const kLaunchStageUserInterface = @"UserInterface";
+    static NSString * const kLaunchStageSecurity = @"Security";
+    static NSString * const kLaunchStageDownloadsMigration = @"DownloadsMigration";
+    static NSString * const kLaunchStageCacheCleanup = @"CacheCleanup";
+    static NSString * const kLaunchStageSyncMigration = @"SyncMigration";
+    static NSString * const kLaunchStageContentMigration = @"ContentMigration";
+    static NSString * const kLaunchStageLogin = @"Login";
+    
+    // Critical: the accounts and the UI built from them
+    [pipeline addStageWithName:kLaunchStageAccounts phase:LaunchStagePhaseCritical dependencies:nil block:^{
+        if (!safeMode)
+        {
+            // Migrate any old accounts if required
+            [MigrationAssistant runMigrationAssistant];
+        }
+        
+        AccountManager *accountManager = [AccountManager sharedManager];
+        accountManager.realmManager = [RealmManager sharedManager];
+        accountManager.appConfigurationManager = [AppConfigurationManager sharedManager];
+        accountManager.analyticsManager = [AnalyticsManager sharedManager];
+        
+        if (isFirstLaunch)
+        {
+            if (!safeMode)
+            {
+                [[AccountManager sharedManager] removeAllAccounts];
+                [SecurityManager reset];
+            }
+            [self updateAppFirstLaunchFlag];
+        }
+    }];
+    
+    // The selected account's synced content and last-known configuration come from local stores, so they are shown before it authenticates
+    [pipeline addStageWithName:kLaunchStageLocalContent phase:LaunchStagePhaseCritical dependencies:@[kLaunchStageAccounts] block:^{
+        if (!safeMode)
+        {
+            [[RealmSyncManager sharedManager] restoreLocalStateForAccount:[AccountManager sharedManager].selectedAccount];
+        }
+    }];
+    
+    [pipeline addStageWithName:kLaunchStageUserInterface phase:LaunchStagePhaseCritical dependencies:@[kLaunchStageLocalContent] block:^{
+        // Setup the app and build it's UI
+        self.window.rootViewController = [self buildMainAppUIWithSession:nil displayingMainMenu:isFirstLaunch];
+        self.window.tintColor = [UIColor appTintColor];
+    }];
+    
+    [pipeline addStageWithName:kLaunchStageSecurity phase:LaunchStagePhaseCritical dependencies:@[kLaunchStageUserInterface] block:^{
+        [[SecurityManager sharedManager] setup];
+        
+        // Register the delegate for session updates, once however many times the stage runs
+        [[NSNotificationCenter defaultCenter] removeObserver:self name:kAlfrescoSessionReceivedNotification object:nil];
+        [[NSNotificationCenter defaultCenter] removeObserver:self name:kAlfrescoSessionRefreshedNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionReceivedNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionRefreshedNotification object:nil];
+        
+        if ([[PreferenceManager sharedManager] shouldUsePasscodeLock] == NO)
+        {
+            // Make the window visible
+            [self.window makeKeyAndVisible];
+        }
+    }];
+    
+    // Background: file system and cache housekeeping nothing on the first screen waits for
+    [pipeline addStageWithName:kLaunchStageDownloadsMigration phase:LaunchStagePhaseBackground dependencies:nil block:^{
+        [MigrationAssistant runDownloadsMigration];
+    }];
+    
+    [pipeline addStageWithName:kLaunchStageCacheCleanup phase:LaunchStagePhaseBackground dependencies:nil block:^{
+        CoreDataCacheHelper *cacheHelper = [[CoreDataCacheHelper alloc] init];
+        NSManagedObjectContext *backgroundContext = [cacheHelper createBackgroundManagedObjectContext];
+        [backgroundContext performBlockAndWait:^{
+            [cacheHelper removeAllCachedDataOlderThanNumberOfDays:@(kNumberOfDaysToKeepCachedData) inManagedObjectContext:backgroundContext];
+        }];
+    }];
+    
+    // Deferred: checking for sync content to migrate fetches from Core Data for every account, and login waits for the migrations
+    [pipeline addStageWithName:kLaunchStageSyncMigration phase:LaunchStagePhaseDeferred dependencies:@[kLaunchStageAccounts, kLaunchStageDownloadsMigration] block:^{
+        if([[RealmSyncManager sharedManager] isCoreDataMigrationNeeded])
+        {
+            [[RealmSyncManager sharedManager] initiateMigrationProcess];
+        }
+    }];
+    
+    [pipeline addStageWithName:kLaunchStageContentMigration phase:LaunchStagePhaseDeferred dependencies:@[kLaunchStageSyncMigration] block:^{
+        if ([[RealmSyncCore sharedSyncCore] isContentMigrationNeeded])
+        {
+            [[RealmSyncCore sharedSyncCore] initiateContentMigrationProcessForAccounts:[AccountManager sharedManager].allAccounts];
+        }
+    }];
+    
+    [pipeline addStageWithName:kLaunchStageLogin phase:LaunchStagePhaseDeferred dependencies:@[kLaunchStageSecurity, kLaunchStageContentMigration] block:^{
+        if (!safeMode)
+        {
+            [self loginToSelectedAccountWithLaunchOptions:launchOptions];
+        }
+    }];
+}
+
 #pragma mark - Private Functions
 
+- (void)loginToSelectedAccountWithLaunchOptions:(NSDictionary *)launchOptions
+{
+    // If there is a selected Account, attempt login
+    AccountManager *accountManager = [AccountManager sharedManager];
+    [accountManager removeCloudAccounts];
+    if (accountManager.selectedAccount)
+    {
+        // Runs after the first frame, as the reachability check can block the main thread.
+        // The local content is already on screen, so the login happens without a blocking HUD.
+        [[LoginManager sharedManager] attemptBackgroundLoginToAccount:accountManager.selectedAccount networkId:accountManager.selectedAccount.selectedNetworkId completionBlock:^(BOOL successful, id<AlfrescoSession> alfrescoSession, NSError *error) {
+            if (!successful)
+            {
+                if (![[ConnectivityManager sharedManager] hasInternetConnection])
+                {
+                    // Offline: keep working from local content, LoginManager logs in again once the connection is back
+                    AlfrescoLogDebug(@"Launch login deferred until the network is reachable: %@", error.localizedDescription);
+                }
+                else if (UserAccountTypeAIMS != accountManager.selectedAccount.accountType) {
+                    if (accountManager.selectedAccount.password.length > 0)
+                    {
+                        displayErrorMessage([ErrorDescriptions descriptionForError:error]);
+                    }
+                    else
+                    {
+                        // Missing details - possibly first launch of an MDM-configured account
+                        if ([accountManager.selectedAccount.username length] == 0)
+                        {
+                            displayWarningMessageWithTitle(NSLocalizedString(@"accountdetails.fields.accountSettings", @"Enter user name and password"), NSLocalizedString(@"accountdetails.header.authentication", "Account Details"));
+                        }
+                        else
+                        {
+                            displayWarningMessageWithTitle(NSLocalizedString(@"accountdetails.fields.confirmPassword", @"Confirm password"), NSLocalizedString(@"accountdetails.header.authentication", "Account Details"));
+                        }
+                    }
+                }
+            } else {
+                // TODO: assess whether to handle this for all calls
+                [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoSessionReceivedNotification object:alfrescoSession userInfo:nil];
+            }
+            
+            if ([launchOptions objectForKey:UIApplicationLaunchOptionsURLKey])
+            {
+                NSURL *url = [launchOptions objectForKey:UIApplicationLaunchOptionsURLKey];
+                [[FileHandlerManager sharedManager] handleURL:url sourceApplication:nil annotation:nil session:alfrescoSession];
+                self.mainMenuViewController.autoselectDefaultMenuOption = NO;
+            }
+            
+            [self performSelector:@selector(showSunsetAppView) withObject: nil afterDelay:1.0];
+        }];
+    } else {
+        // user is not logged in
+        [self showSunsetAppView];
+    }
+}
+
 - (UIViewController *)buildMainAppUIWithSession:(id<AlfrescoSession>)session displayingMainMenu:(BOOL)displayMainMenu
 {
     RootRevealViewController *rootRevealViewController = nil;
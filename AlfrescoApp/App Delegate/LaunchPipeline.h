@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+typedef NS_ENUM(NSInteger, LaunchStagePhase)
+{
+    // Runs on the main thread before the first frame; keep these to what the first screen needs
+    LaunchStagePhaseCritical = 0,
+    // Runs concurrently on a background queue as soon as its dependencies have finished
+    LaunchStagePhaseBackground,
+    // Runs on the main thread once the first frame has been committed
+    LaunchStagePhaseDeferred
+};
+
+/**
+ * Orders the work done at app launch into critical, background and deferred stages with explicit dependencies.
+ *
+ * Each stage is timed and marked with an os_signpost interval (subsystem "org.alfresco.app", category "Launch") so it
+ * shows up in Instruments; a summary is logged at debug level once every stage has finished.
+ */
+@interface LaunchPipeline : NSObject
+
+// Name of each finished stage mapped to its duration in seconds
+@property (nonatomic, strong, readonly) NSDictionary<NSString *, NSNumber *> *stageDurations;
+// Seconds from the pipeline being created to the critical stages finishing
+@property (nonatomic, assign, readonly) NSTimeInterval criticalPathDuration;
+
+/*
+ * Stages must be added before the pipeline is run, after the stages they depend on. A critical stage may only depend
+ * on other critical stages.
+ */
+- (void)addStageWithName:(NSString *)name phase:(LaunchStagePhase)phase dependencies:(NSArray<NSString *> *)dependencies block:(void (^)(void))block;
+
+/*
+ * Runs the critical stages in order on the main thread and starts the background stages. Returns once the critical
+ * stages have finished.
+ */
+- (void)runCriticalStages;
+
+/*
+ * Schedules the deferred stages to run after the next frame has been committed.
+ */
+- (void)runDeferredStagesAfterFirstFrame;
+
+/*
+ * Schedules the deferred stages on the main queue straight away.
+ */
+- (void)runDeferredStages;
+
+/*
+ * Blocks until every background stage has finished. Intended for tests and benchmarks.
+ */
+- (void)waitUntilBackgroundStagesFinished;
+
+@end
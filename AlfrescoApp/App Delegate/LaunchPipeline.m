@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "LaunchPipeline.h"
+#import <os/signpost.h>
+#import <QuartzCore/QuartzCore.h>
+
+@interface LaunchPipeline ()
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSOperation *> *operationsByName;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *phasesByName;
+@property (nonatomic, strong) NSMutableArray<NSString *> *stageNames;
+@property (nonatomic, strong) NSOperationQueue *backgroundQueue;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *durations;
+@property (nonatomic, assign) CFTimeInterval creationTime;
+@property (nonatomic, assign, readwrite) NSTimeInterval criticalPathDuration;
+@property (nonatomic, assign) BOOL hasScheduledDeferredStages;
+@property (nonatomic, strong) os_log_t signpostLog;
+
+@end
+
+@implementation LaunchPipeline
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.operationsByName = [NSMutableDictionary dictionary];
+        self.phasesByName = [NSMutableDictionary dictionary];
+        self.stageNames = [NSMutableArray array];
+        self.durations = [NSMutableDictionary dictionary];
+        self.backgroundQueue = [[NSOperationQueue alloc] init];
+        self.backgroundQueue.name = @"org.alfresco.launch";
+        self.backgroundQueue.qualityOfService = NSQualityOfServiceUserInitiated;
+        self.creationTime = CACurrentMediaTime();
+        self.signpostLog = os_log_create("org.alfresco.app", "Launch");
+    }
+    return self;
+}
+
+#pragma mark - Public Methods
+
+- (NSDictionary<NSString *, NSNumber *> *)stageDurations
+{
+    @synchronized (self.durations)
+    {
+        return [self.durations copy];
+    }
+}
+
+- (void)addStageWithName:(NSString *)name phase:(LaunchStagePhase)phase dependencies:(NSArray<NSString *> *)dependencies block:(void (^)(void))block
+{
+    NSAssert(!self.operationsByName[name], @"Launch stage %@ has already been added", name);
+    
+    __weak typeof(self) weakSelf = self;
+    NSBlockOperation *operation = [NSBlockOperation blockOperationWithBlock:^{
+        [weakSelf performStageWithName:name block:block];
+    }];
+    operation.name = name;
+    
+    for (NSString *dependencyName in dependencies)
+    {
+        NSOperation *dependency = self.operationsByName[dependencyName];
+        NSAssert(dependency, @"Launch stage %@ depends on %@, which has not been added", name, dependencyName);
+        NSAssert(phase != LaunchStagePhaseCritical || self.phasesByName[dependencyName].integerValue == LaunchStagePhaseCritical, @"Critical launch stage %@ can't wait for non-critical stage %@", name, dependencyName);
+        if (dependency)
+        {
+            [operation addDependency:dependency];
+        }
+    }
+    
+    self.operationsByName[name] = operation;
+    self.phasesByName[name] = @(phase);
+    [self.stageNames addObject:name];
+}
+
+- (void)runCriticalStages
+{
+    // Background stages start straight away and wait on their own dependencies, critical or not
+    [self.backgroundQueue addOperations:[self operationsInPhase:LaunchStagePhaseBackground] waitUntilFinished:NO];
+    
+    for (NSOperation *operation in [self operationsInPhase:LaunchStagePhaseCritical])
+    {
+        [operation start];
+    }
+    
+    self.criticalPathDuration = CACurrentMediaTime() - self.creationTime;
+    AlfrescoLogDebug(@"Launch critical path finished after %.0fms", self.criticalPathDuration * 1000);
+}
+
+- (void)runDeferredStagesAfterFirstFrame
+{
+    // Core Animation commits the frame from a before-waiting run loop observer; this one is ordered after it
+    __weak typeof(self) weakSelf = self;
+    CFRunLoopObserverRef observer = CFRunLoopObserverCreateWithHandler(kCFAllocatorDefault, kCFRunLoopBeforeWaiting, false, LONG_MAX, ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+        [weakSelf runDeferredStages];
+    });
+    CFRunLoopAddObserver(CFRunLoopGetMain(), observer, kCFRunLoopCommonModes);
+    CFRelease(observer);
+}
+
+- (void)runDeferredStages
+{
+    if (self.hasScheduledDeferredStages)
+    {
+        return;
+    }
+    self.hasScheduledDeferredStages = YES;
+    
+    NSArray *deferredOperations = [self operationsInPhase:LaunchStagePhaseDeferred];
+    NSBlockOperation *summaryOperation = [NSBlockOperation blockOperationWithBlock:^{
+        [self logSummary];
+    }];
+    for (NSOperation *operation in self.operationsByName.allValues)
+    {
+        [summaryOperation addDependency:operation];
+    }
+    
+    [[NSOperationQueue mainQueue] addOperations:[deferredOperations arrayByAddingObject:summaryOperation] waitUntilFinished:NO];
+}
+
+- (void)waitUntilBackgroundStagesFinished
+{
+    [self.backgroundQueue waitUntilAllOperationsAreFinished];
+}
+
+#pragma mark - Private Methods
+
+- (NSArray<NSOperation *> *)operationsInPhase:(LaunchStagePhase)phase
+{
+    NSMutableArray *operations = [NSMutableArray array];
+    for (NSString *name in self.stageNames)
+    {
+        if (self.phasesByName[name].integerValue == phase)
+        {
+            [operations addObject:self.operationsByName[name]];
+        }
+    }
+    return operations;
+}
+
+- (void)performStageWithName:(NSString *)name block:(void (^)(void))block
+{
+    os_signpost_id_t signpostID = os_signpost_id_generate(self.signpostLog);
+    os_signpost_interval_begin(self.signpostLog, signpostID, "LaunchStage", "%{public}@", name);
+    CFTimeInterval startTime = CACurrentMediaTime();
+    
+    block();
+    
+    CFTimeInterval duration = CACurrentMediaTime() - startTime;
+    os_signpost_interval_end(self.signpostLog, signpostID, "LaunchStage", "%{public}@", name);
+    
+    @synchronized (self.durations)
+    {
+        self.durations[name] = @(duration);
+    }
+}
+
+- (void)logSummary
+{
+    NSDictionary *durations = self.stageDurations;
+    NSMutableArray *stageSummaries = [NSMutableArray arrayWithCapacity:self.stageNames.count];
+    for (NSString *name in self.stageNames)
+    {
+        [stageSummaries addObject:[NSString stringWithFormat:@"%@ %.0fms", name, [durations[name] doubleValue] * 1000]];
+    }
+    
+    AlfrescoLogDebug(@"Launch finished after %.0fms (critical path %.0fms): %@", (CACurrentMediaTime() - self.creationTime) * 1000, self.criticalPathDuration * 1000, [stageSummaries componentsJoinedByString:@", "]);
+}
+
+@end
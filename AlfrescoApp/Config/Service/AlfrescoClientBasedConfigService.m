@@ -28,6 +28,7 @@
 #import "AlfrescoViewConfigHelper.h"
 #import "AlfrescoFormConfigHelper.h"
 #import "AlfrescoConfigEvaluator.h"
+#import "StreamCopier.h"
 
 /**
  * Configuration service implementation
@@ -219,9 +220,16 @@
                                     self.isUsingCacheData = NO;
                                     
                                     NSString *temporaryFileConfigPath = [configDestinationFolderPath stringByAppendingPathComponent:kAlfrescoConfigServiceTemporaryFileName];
-                                    NSOutputStream *outputStream = [NSOutputStream outputStreamToFileAtPath:temporaryFileConfigPath append:NO];
+                                    StreamCopyFileDestination *destination = [[StreamCopyFileDestination alloc] initWithFilePath:temporaryFileConfigPath];
                                     
-                                    AlfrescoRequest *contentRequest = [docFolderService retrieveContentOfDocument:(AlfrescoDocument *)configNode outputStream:outputStream completionBlock:^(BOOL succeeded, NSError *downloadError) {
+                                    AlfrescoRequest *contentRequest = [docFolderService retrieveContentOfDocument:(AlfrescoDocument *)configNode outputStream:destination.outputStream completionBlock:^(BOOL succeeded, NSError *downloadError) {
+                                        NSError *moveError = nil;
+                                        if (![destination finishWithSuccess:succeeded error:&moveError] && succeeded)
+                                        {
+                                            succeeded = NO;
+                                            downloadError = moveError;
+                                        }
+                                        
                                         if (succeeded)
                                         {
                                             // TODO: pull all *.strings files from the server's Messages folder and create a bundle from them
@@ -149,6 +149,7 @@ extern NSString * const kAlfrescoDocumentDeletedOnServerNotification;
 extern NSString * const kAlfrescoNodeAddedOnServerNotification;
 extern NSString * const kAlfrescoEnableMainMenuAutoItemSelection;
 extern NSString * const kAlfrescoShowAccountPickerNotification;
+extern NSString * const kAlfrescoRelativeDatesNeedRefreshNotification;
 // parameter keys used in the dictionary of notification object
 extern NSString * const kAlfrescoDocumentUpdatedFromDocumentParameterKey;
 extern NSString * const kAlfrescoDocumentUpdatedFilenameParameterKey;
@@ -193,7 +194,6 @@ extern NSString * const kSyncPreference;
 extern NSString * const kSyncOnCellular;
 
 // Sync notification constants
-extern NSString * const kSyncStatusChangeNotification;
 extern NSString * const kSyncObstaclesNotification;
 extern NSString * const kFavoritesListUpdatedNotification;
 extern NSString * const kSyncProgressViewVisiblityChangeNotification;
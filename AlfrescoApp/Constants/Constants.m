@@ -108,6 +108,7 @@ NSString * const kAlfrescoWorkflowTaskListDidChangeNotification = @"AlfrescoWork
 NSString * const kAlfrescoDocumentEditedNotification = @"AlfrescoDocumentEditedNotification";
 NSString * const kAlfrescoEnableMainMenuAutoItemSelection = @"AlfrescoEnableMainMenuAutoItemSelection";
 NSString * const kAlfrescoShowAccountPickerNotification = @"AlfrescoShowAccountPickerNotification";
+NSString * const kAlfrescoRelativeDatesNeedRefreshNotification = @"AlfrescoRelativeDatesNeedRefreshNotification";
 
 // Saveback
 NSString * const kAlfrescoSaveBackLocalComplete = @"AlfrescoSaveBackLocalComplete";
@@ -143,7 +144,6 @@ NSString * const kSyncPreference = @"SyncNodes";
 NSString * const kSyncOnCellular = @"SyncOnCellular";
 
 // Sync Notification constants
-NSString * const kSyncStatusChangeNotification = @"kSyncStatusChangeNotification";
 NSString * const kSyncObstaclesNotification = @"kSyncObstaclesNotification";
 NSString * const kFavoritesListUpdatedNotification = @"kFavoritesListUpdatedNotification";
 NSString * const kSyncProgressViewVisiblityChangeNotification = @"kSyncProgressViewVisiblityChangeNotification";
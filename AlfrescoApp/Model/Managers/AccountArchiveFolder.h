@@ -0,0 +1,46 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+/**
+ * A folder holding a keyed archive per account and network, such as the stored activities, favourites or tasks of each
+ * account. Saving and removing run on one serial queue, so a save queued before an account is removed can't bring its
+ * folder back once it has gone.
+ */
+@interface AccountArchiveFolder : NSObject
+
+@property (nonatomic, strong, readonly) NSString *folderPath;
+
+/*
+ * The description names what is archived in log messages, e.g. "activities".
+ */
+- (instancetype)initWithFolderPath:(NSString *)folderPath archiveDescription:(NSString *)archiveDescription;
+
+- (NSString *)filePathForAccountIdentifier:(NSString *)accountIdentifier archiveName:(NSString *)archiveName;
+
+/*
+ * Archives the object in the background, replacing the file at the path.
+ */
+- (void)saveArchiveWithRootObject:(id)rootObject toFilePath:(NSString *)filePath;
+
+/*
+ * Removes the archives of the account once the saves already queued have been written.
+ */
+- (void)removeArchivesForAccountIdentifier:(NSString *)accountIdentifier;
+- (void)removeAllArchives;
+
+@end
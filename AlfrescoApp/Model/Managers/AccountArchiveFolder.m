@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "AccountArchiveFolder.h"
+
+@interface AccountArchiveFolder ()
+@property (nonatomic, strong, readwrite) NSString *folderPath;
+@property (nonatomic, strong) NSString *archiveDescription;
+@property (nonatomic, strong) dispatch_queue_t fileQueue;
+@end
+
+@implementation AccountArchiveFolder
+
+- (instancetype)initWithFolderPath:(NSString *)folderPath archiveDescription:(NSString *)archiveDescription
+{
+    self = [super init];
+    if (self)
+    {
+        self.folderPath = folderPath;
+        self.archiveDescription = archiveDescription;
+        NSString *queueLabel = [NSString stringWithFormat:@"com.alfresco.app.accountarchivefolder.%@", archiveDescription];
+        self.fileQueue = dispatch_queue_create(queueLabel.UTF8String, DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+#pragma mark - Public Functions
+
+- (NSString *)filePathForAccountIdentifier:(NSString *)accountIdentifier archiveName:(NSString *)archiveName
+{
+    NSString *fileName = [[archiveName stringByAddingPercentEncodingWithAllowedCharacters:[NSCharacterSet alphanumericCharacterSet]] stringByAppendingPathExtension:@"archive"];
+    return [[self folderPathForAccountIdentifier:accountIdentifier] stringByAppendingPathComponent:fileName];
+}
+
+- (void)saveArchiveWithRootObject:(id)rootObject toFilePath:(NSString *)filePath
+{
+    dispatch_async(self.fileQueue, ^{
+        NSData *data = [NSKeyedArchiver archivedDataWithRootObject:rootObject];
+        NSString *folderPath = [filePath stringByDeletingLastPathComponent];
+        if (![[AlfrescoFileManager sharedManager] fileExistsAtPath:folderPath])
+        {
+            [[AlfrescoFileManager sharedManager] createDirectoryAtPath:folderPath withIntermediateDirectories:YES attributes:nil error:nil];
+        }
+        
+        NSError *error = nil;
+        [[AlfrescoFileManager sharedManager] createFileAtPath:filePath contents:data error:&error];
+        if (error)
+        {
+            AlfrescoLogError(@"Unable to save the stored %@: %@", self.archiveDescription, error.localizedDescription);
+        }
+    });
+}
+
+- (void)removeArchivesForAccountIdentifier:(NSString *)accountIdentifier
+{
+    if (!accountIdentifier)
+    {
+        return;
+    }
+    [self removeItemAtPath:[self folderPathForAccountIdentifier:accountIdentifier]];
+}
+
+- (void)removeAllArchives
+{
+    [self removeItemAtPath:self.folderPath];
+}
+
+#pragma mark - Private Functions
+
+- (NSString *)folderPathForAccountIdentifier:(NSString *)accountIdentifier
+{
+    NSString *folderName = [accountIdentifier stringByAddingPercentEncodingWithAllowedCharacters:[NSCharacterSet alphanumericCharacterSet]];
+    return [self.folderPath stringByAppendingPathComponent:folderName];
+}
+
+- (void)removeItemAtPath:(NSString *)path
+{
+    dispatch_async(self.fileQueue, ^{
+        if ([[AlfrescoFileManager sharedManager] fileExistsAtPath:path])
+        {
+            NSError *error = nil;
+            [[AlfrescoFileManager sharedManager] removeItemAtPath:path error:&error];
+            if (error)
+            {
+                AlfrescoLogError(@"Unable to remove the stored %@: %@", self.archiveDescription, error.localizedDescription);
+            }
+        }
+    });
+}
+
+@end
@@ -18,17 +18,22 @@
  
 #import "AccountManager.h"
 #import "KeychainUtils.h"
+#import "AccountStore.h"
 #import "RequestHandler.h"
 #import "Constants.h"
 #import "AccountCertificate.h"
 #import "AlfrescoProfileConfig.h"
 #import "RealmSyncManager.h"
+#import "ActivityStreamStore.h"
+#import "TaskDataCoordinator.h"
+#import "FavouritesIndex.h"
 
 static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
 
 @interface AccountManager ()
 @property (nonatomic, strong, readwrite) NSMutableArray *accountsFromKeychain;
 @property (nonatomic, strong, readwrite) UserAccount *selectedAccount;
+@property (nonatomic, strong) AccountStore *accountStore;
 @end
 
 @implementation AccountManager
@@ -51,7 +56,12 @@ static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
     self = [super init];
     if (self)
     {
+        self.accountStore = [AccountStore sharedStore];
+        
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(profileChanged:) name:kAlfrescoConfigProfileDidChangeNotification object:nil];
+        // Saves are coalesced, so write any pending one before the app can be suspended
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flushAccountsToKeychain:) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flushAccountsToKeychain:) name:UIApplicationWillTerminateNotification object:nil];
         
         BOOL isMigrationNeededResult = [[NSUserDefaults standardUserDefaults] boolForKey:kHasAccountMigrationOccured];
         if(!isMigrationNeededResult)
@@ -124,6 +134,7 @@ static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
     
     [self.accountsFromKeychain removeObject:account];
     [self saveAccountsToKeychain];
+    [self removeStoredDataForAccountIdentifier:account.accountIdentifier];
     [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoAccountRemovedNotification object:account];
 
     if (self.accountsFromKeychain.count == 0)
@@ -152,6 +163,7 @@ static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
         if (account.accountType == UserAccountTypeCloud)
         {
             [[RealmSyncManager sharedManager] cleanUpAccount:account cancelOperationsType:CancelOperationsNone];
+            [self removeStoredDataForAccountIdentifier:account.accountIdentifier];
             [self.accountsFromKeychain removeObject:account];
         }
     }
@@ -168,8 +180,9 @@ static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
 
     [self.accountsFromKeychain removeAllObjects];
     self.selectedAccount = nil;
+    [self removeStoredDataForAccountIdentifier:nil];
     NSError *deleteError = nil;
-    [KeychainUtils deleteSavedAccountsForListIdentifier:kKeychainAccountListIdentifier error:&deleteError];
+    [self.accountStore deleteAllAccountsWithError:&deleteError];
     
     if (deleteError)
     {
@@ -188,13 +201,8 @@ static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
 
 - (void)saveAccountsToKeychain
 {
-    NSError *saveError = nil;
-    [KeychainUtils updateSavedAccounts:self.accountsFromKeychain forListIdentifier:kKeychainAccountListIdentifier error:&saveError];
-    
-    if (saveError && saveError.code != -25300)
-    {
-        AlfrescoLogDebug(@"Error saving to keychain. Error: %@", saveError.localizedDescription);
-    }
+    // Only written to the keychain if the list changed, and once for a burst of saves
+    [self.accountStore saveAccounts:self.accountsFromKeychain];
 }
 
 - (void)selectAccount:(UserAccount *)selectedAccount selectNetwork:(NSString *)networkIdentifier alfrescoSession:(id<AlfrescoSession>)alfrescoSession
@@ -266,8 +274,7 @@ static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
 {
     NSError *keychainRetrieveError = nil;
     
-    NSArray *savedAccounts = [KeychainUtils savedAccountsForListIdentifier:kKeychainAccountListIdentifier
-                                                                     error:&keychainRetrieveError];
+    NSArray *savedAccounts = [self.accountStore accountsWithError:&keychainRetrieveError];
     
     self.accountsFromKeychain = [savedAccounts mutableCopy];
     
@@ -343,6 +350,17 @@ static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
 
 #pragma mark - Notification Methods
 
+- (void)flushAccountsToKeychain:(NSNotification *)notification
+{
+    NSError *saveError = nil;
+    [self.accountStore flushWithError:&saveError];
+    
+    if (saveError)
+    {
+        AlfrescoLogDebug(@"Error saving to keychain. Error: %@", saveError.localizedDescription);
+    }
+}
+
 - (void)profileChanged:(NSNotification *)notification
 {
     AlfrescoProfileConfig *profile = notification.object;
@@ -425,6 +443,25 @@ static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
 
 #pragma mark - Private Functions
 
+/*
+ * Removes the activities, favourites and tasks kept on disk for an account, or for every account when the identifier is nil.
+ */
+- (void)removeStoredDataForAccountIdentifier:(NSString *)accountIdentifier
+{
+    if (accountIdentifier)
+    {
+        [ActivityStreamStore removeStoresForAccountIdentifier:accountIdentifier];
+        [FavouritesIndex removeIndexesForAccountIdentifier:accountIdentifier];
+        [TaskDataCoordinator removeStoresForAccountIdentifier:accountIdentifier];
+    }
+    else
+    {
+        [ActivityStreamStore removeAllStores];
+        [FavouritesIndex removeAllIndexes];
+        [TaskDataCoordinator removeAllStores];
+    }
+}
+
 - (RequestHandler *)updateAccountStatusForAccount:(UserAccount *)account completionBlock:(void (^)(BOOL successful, NSError *error))completionBlock
 {
     NSString *accountStatusUrl = [kAlfrescoCloudAPIAccountStatusUrl stringByReplacingOccurrencesOfString:kAlfrescoCloudAPIAccountID withString:account.cloudAccountId];
@@ -482,6 +519,7 @@ static NSString * const kKeychainAccountListIdentifier = @"AccountListNew";
     {
         self.accountsFromKeychain = [savedAccounts mutableCopy];
         [self saveAccountsToKeychain];
+        [self.accountStore flushWithError:nil];
         self.accountsFromKeychain = nil;
         [[NSUserDefaults standardUserDefaults] setBool:YES forKey:kHasAccountMigrationOccured];
     }
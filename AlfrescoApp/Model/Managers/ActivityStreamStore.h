@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+typedef AlfrescoRequest * (^ActivityStreamPageFetchBlock)(AlfrescoListingContext *listingContext, AlfrescoPagingResultCompletionBlock completionBlock);
+typedef void (^ActivityStreamStoreFetchCompletionBlock)(NSArray *newEntries, BOOL entriesReplaced, NSError *error);
+
+/**
+ * The most recent entries of one activity stream, either an account's or one of its sites', kept on disk so they can be
+ * shown straight away, including when offline.
+ *
+ * The stored entries are always the head of the stream, newest first, without gaps: newer entries are fetched page by
+ * page until the newest stored entry is reached, and if that takes too long the stored entries are replaced instead.
+ * Must be used from the main thread; files are written on a private queue.
+ */
+@interface ActivityStreamStore : NSObject
+
+@property (nonatomic, strong, readonly) NSString *filePath;
+/// Newest first
+@property (nonatomic, strong, readonly) NSArray *entries;
+/// Whether the stream continues beyond the oldest stored entry
+@property (nonatomic, assign, readonly) BOOL hasOlderEntries;
+/// Defaults to 500. The oldest entries are dropped beyond this.
+@property (nonatomic, assign) NSUInteger maximumNumberOfEntries;
+/// Number of entries requested per page when fetching newer entries. Defaults to 25.
+@property (nonatomic, assign) int pageSize;
+
++ (NSString *)filePathForAccountIdentifier:(NSString *)accountIdentifier networkIdentifier:(NSString *)networkIdentifier siteShortName:(NSString *)siteShortName;
++ (void)removeStoresForAccountIdentifier:(NSString *)accountIdentifier;
++ (void)removeAllStores;
+
+/*
+ * Creates a store persisted at the given path, loading the entries from it if the file exists. A nil path keeps the
+ * entries in memory only.
+ */
+- (instancetype)initWithFilePath:(NSString *)filePath;
+
+/*
+ * Fetches the entries newer than the newest stored one using the fetch block, which retrieves one page of the stream.
+ * The completion block gets the entries added to the head of the store, newest first, or, if the stored entries had to be
+ * replaced because they no longer joined up with the head of the stream, every entry now stored.
+ */
+- (void)fetchNewEntriesUsingBlock:(ActivityStreamPageFetchBlock)fetchBlock completionBlock:(ActivityStreamStoreFetchCompletionBlock)completionBlock;
+
+/*
+ * Adds a page following the oldest stored entry, returning the entries not already stored.
+ */
+- (NSArray *)appendOlderEntries:(NSArray *)entries hasMoreItems:(BOOL)hasMoreItems;
+
+- (void)removeAllEntries;
+
+@end
@@ -0,0 +1,242 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+ 
+#import "ActivityStreamStore.h"
+#import "AccountArchiveFolder.h"
+
+static NSUInteger const kActivityStreamStoreDefaultMaximumNumberOfEntries = 500;
+static int const kActivityStreamStoreDefaultPageSize = 25;
+// Pages fetched looking for the newest stored entry before giving up and replacing the stored entries
+static NSUInteger const kActivityStreamStoreMaximumHeadPages = 4;
+static NSInteger const kActivityStreamStoreVersion = 1;
+
+static NSString * const kActivityStreamStoreVersionKey = @"version";
+static NSString * const kActivityStreamStoreEntriesKey = @"entries";
+static NSString * const kActivityStreamStoreHasOlderEntriesKey = @"hasOlderEntries";
+static NSString * const kActivityStreamStoreRepositoryStreamName = @"repository";
+static NSString * const kActivityStreamStoreSiteStreamPrefix = @"site-";
+
+@interface ActivityStreamStore ()
+
+@property (nonatomic, strong, readwrite) NSString *filePath;
+@property (nonatomic, strong, readwrite) NSArray *entries;
+@property (nonatomic, assign, readwrite) BOOL hasOlderEntries;
+@property (nonatomic, strong) NSMutableSet *entryIdentifiers;
+
+@end
+
+@implementation ActivityStreamStore
+
++ (AccountArchiveFolder *)archiveFolder
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[AccountArchiveFolder alloc] initWithFolderPath:[[AlfrescoFileManager sharedManager] activitiesFolderPath] archiveDescription:@"activities"];
+    });
+    return sharedObject;
+}
+
++ (NSString *)filePathForAccountIdentifier:(NSString *)accountIdentifier networkIdentifier:(NSString *)networkIdentifier siteShortName:(NSString *)siteShortName
+{
+    NSString *streamName = siteShortName ? [kActivityStreamStoreSiteStreamPrefix stringByAppendingString:siteShortName] : kActivityStreamStoreRepositoryStreamName;
+    if (networkIdentifier)
+    {
+        streamName = [NSString stringWithFormat:@"%@-%@", networkIdentifier, streamName];
+    }
+    
+    return [[self archiveFolder] filePathForAccountIdentifier:accountIdentifier archiveName:streamName];
+}
+
++ (void)removeStoresForAccountIdentifier:(NSString *)accountIdentifier
+{
+    [[self archiveFolder] removeArchivesForAccountIdentifier:accountIdentifier];
+}
+
++ (void)removeAllStores
+{
+    [[self archiveFolder] removeAllArchives];
+}
+
+- (instancetype)initWithFilePath:(NSString *)filePath
+{
+    self = [super init];
+    if (self)
+    {
+        self.filePath = filePath;
+        self.entries = @[];
+        self.entryIdentifiers = [NSMutableSet set];
+        self.maximumNumberOfEntries = kActivityStreamStoreDefaultMaximumNumberOfEntries;
+        self.pageSize = kActivityStreamStoreDefaultPageSize;
+        
+        // Read synchronously, as the point is to have something to show the moment the stream is opened
+        if (filePath)
+        {
+            [self loadEntries];
+        }
+    }
+    return self;
+}
+
+#pragma mark - Public Functions
+
+- (void)fetchNewEntriesUsingBlock:(ActivityStreamPageFetchBlock)fetchBlock completionBlock:(ActivityStreamStoreFetchCompletionBlock)completionBlock
+{
+    [self fetchPageWithSkipCount:0 pageNumber:1 newEntries:[NSMutableArray array] fetchBlock:fetchBlock completionBlock:completionBlock];
+}
+
+- (NSArray *)appendOlderEntries:(NSArray *)entries hasMoreItems:(BOOL)hasMoreItems
+{
+    NSMutableArray *addedEntries = [NSMutableArray arrayWithCapacity:entries.count];
+    for (AlfrescoActivityEntry *entry in entries)
+    {
+        if (entry.identifier && ![self.entryIdentifiers containsObject:entry.identifier])
+        {
+            [addedEntries addObject:entry];
+        }
+    }
+    
+    [self setEntries:[self.entries arrayByAddingObjectsFromArray:addedEntries] hasOlderEntries:hasMoreItems];
+    [self saveEntries];
+    
+    return addedEntries;
+}
+
+- (void)removeAllEntries
+{
+    [self setEntries:@[] hasOlderEntries:NO];
+    [self saveEntries];
+}
+
+#pragma mark - Private Functions
+
+- (void)fetchPageWithSkipCount:(int)skipCount pageNumber:(NSUInteger)pageNumber newEntries:(NSMutableArray *)newEntries fetchBlock:(ActivityStreamPageFetchBlock)fetchBlock completionBlock:(ActivityStreamStoreFetchCompletionBlock)completionBlock
+{
+    AlfrescoActivityEntry *newestStoredEntry = self.entries.firstObject;
+    AlfrescoListingContext *listingContext = [[AlfrescoListingContext alloc] initWithMaxItems:self.pageSize skipCount:skipCount];
+    
+    fetchBlock(listingContext, ^(AlfrescoPagingResult *pagingResult, NSError *error) {
+        if (!pagingResult)
+        {
+            completionBlock(nil, NO, error);
+            return;
+        }
+        
+        BOOL reachedStoredEntries = NO;
+        for (AlfrescoActivityEntry *entry in pagingResult.objects)
+        {
+            BOOL isStored = [self.entryIdentifiers containsObject:entry.identifier];
+            BOOL isOlder = newestStoredEntry && [entry.createdAt compare:newestStoredEntry.createdAt] == NSOrderedAscending;
+            if (isStored || isOlder)
+            {
+                reachedStoredEntries = YES;
+                break;
+            }
+            [newEntries addObject:entry];
+        }
+        
+        if (reachedStoredEntries)
+        {
+            [self setEntries:[newEntries arrayByAddingObjectsFromArray:self.entries] hasOlderEntries:self.hasOlderEntries];
+            [self saveEntries];
+            completionBlock(newEntries, NO, nil);
+        }
+        else if (!newestStoredEntry)
+        {
+            // Nothing was stored; the first page is enough to show
+            [self setEntries:newEntries hasOlderEntries:pagingResult.hasMoreItems];
+            [self saveEntries];
+            completionBlock(self.entries, YES, nil);
+        }
+        else if (pagingResult.hasMoreItems && pageNumber < kActivityStreamStoreMaximumHeadPages && pagingResult.objects.count > 0)
+        {
+            [self fetchPageWithSkipCount:skipCount + (int)pagingResult.objects.count pageNumber:pageNumber + 1 newEntries:newEntries fetchBlock:fetchBlock completionBlock:completionBlock];
+        }
+        else
+        {
+            // The stored entries are too far behind, or no longer in the stream, so start again from the head
+            [self setEntries:newEntries hasOlderEntries:pagingResult.hasMoreItems];
+            [self saveEntries];
+            completionBlock(self.entries, YES, nil);
+        }
+    });
+}
+
+- (void)setEntries:(NSArray *)entries hasOlderEntries:(BOOL)hasOlderEntries
+{
+    // The oldest entries are dropped, so the stream still continues beyond the stored ones
+    BOOL droppedEntries = entries.count > self.maximumNumberOfEntries;
+    if (droppedEntries)
+    {
+        entries = [entries subarrayWithRange:NSMakeRange(0, self.maximumNumberOfEntries)];
+    }
+    
+    self.entries = entries;
+    self.hasOlderEntries = hasOlderEntries || droppedEntries;
+    [self.entryIdentifiers removeAllObjects];
+    for (AlfrescoActivityEntry *entry in entries)
+    {
+        if (entry.identifier)
+        {
+            [self.entryIdentifiers addObject:entry.identifier];
+        }
+    }
+}
+
+#pragma mark - Persistence
+
+- (void)loadEntries
+{
+    NSData *data = [[AlfrescoFileManager sharedManager] dataWithContentsOfURL:[NSURL fileURLWithPath:self.filePath]];
+    if (!data)
+    {
+        return;
+    }
+    
+    NSDictionary *archive = nil;
+    @try
+    {
+        archive = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+    }
+    @catch (NSException *exception)
+    {
+        AlfrescoLogError(@"Unable to read the stored activities: %@", exception.reason);
+    }
+    
+    if (![archive isKindOfClass:[NSDictionary class]] || [archive[kActivityStreamStoreVersionKey] integerValue] != kActivityStreamStoreVersion)
+    {
+        return;
+    }
+    
+    [self setEntries:archive[kActivityStreamStoreEntriesKey] hasOlderEntries:[archive[kActivityStreamStoreHasOlderEntriesKey] boolValue]];
+}
+
+- (void)saveEntries
+{
+    if (!self.filePath)
+    {
+        return;
+    }
+    
+    NSDictionary *archive = @{kActivityStreamStoreVersionKey : @(kActivityStreamStoreVersion),
+                              kActivityStreamStoreEntriesKey : self.entries,
+                              kActivityStreamStoreHasOlderEntriesKey : @(self.hasOlderEntries)};
+    [[[self class] archiveFolder] saveArchiveWithRootObject:archive toFilePath:self.filePath];
+}
+
+@end
@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+typedef NS_ENUM(NSInteger, AuthenticationProbeResult)
+{
+    AuthenticationProbeResultUnknown = 0,
+    AuthenticationProbeResultBasic,
+    AuthenticationProbeResultSAML
+};
+
+/**
+ * Remembers, per server, whether the last SAML probe found SAML enabled, so repeat logins can skip the probe round trip.
+ * Results are persisted in the user defaults and expire after timeToLive seconds.
+ * Only the authentication type is stored; the SAML info and ticket stay with the account in the keychain.
+ */
+@interface AuthenticationProbeCache : NSObject
+
+/// Seconds a probe result stays valid. Defaults to 24 hours.
+@property (nonatomic, assign) NSTimeInterval timeToLive;
+
++ (AuthenticationProbeCache *)sharedCache;
+- (instancetype)initWithUserDefaults:(NSUserDefaults *)userDefaults;
+
+- (AuthenticationProbeResult)cachedResultForServerURLString:(NSString *)urlString;
+- (AuthenticationProbeResult)cachedResultForServerURLString:(NSString *)urlString atDate:(NSDate *)date;
+- (void)cacheResult:(AuthenticationProbeResult)result forServerURLString:(NSString *)urlString;
+
+/*
+ * Called when authenticating with the cached type failed, so the next login probes the server again.
+ */
+- (void)invalidateResultForServerURLString:(NSString *)urlString;
+- (void)removeAllResults;
+
+@end
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "AuthenticationProbeCache.h"
+
+static NSString * const kAuthenticationProbeCacheDefaultsKey = @"AuthenticationProbeCache";
+static NSString * const kAuthenticationProbeResultKey = @"result";
+static NSString * const kAuthenticationProbeDateKey = @"date";
+static NSTimeInterval const kDefaultAuthenticationProbeTimeToLive = 24 * 60 * 60;
+
+@interface AuthenticationProbeCache ()
+@property (nonatomic, strong) NSUserDefaults *userDefaults;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSDictionary *> *results;
+@end
+
+@implementation AuthenticationProbeCache
+
++ (AuthenticationProbeCache *)sharedCache
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[self alloc] initWithUserDefaults:[NSUserDefaults standardUserDefaults]];
+    });
+    return sharedObject;
+}
+
+- (instancetype)initWithUserDefaults:(NSUserDefaults *)userDefaults
+{
+    self = [super init];
+    if (self)
+    {
+        self.userDefaults = userDefaults;
+        self.timeToLive = kDefaultAuthenticationProbeTimeToLive;
+        
+        NSDictionary *persistedResults = [userDefaults dictionaryForKey:kAuthenticationProbeCacheDefaultsKey];
+        self.results = persistedResults ? [persistedResults mutableCopy] : [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma mark - Public Methods
+
+- (AuthenticationProbeResult)cachedResultForServerURLString:(NSString *)urlString
+{
+    return [self cachedResultForServerURLString:urlString atDate:[NSDate date]];
+}
+
+- (AuthenticationProbeResult)cachedResultForServerURLString:(NSString *)urlString atDate:(NSDate *)date
+{
+    NSString *key = [self keyForServerURLString:urlString];
+    if (!key)
+    {
+        return AuthenticationProbeResultUnknown;
+    }
+    
+    @synchronized(self)
+    {
+        NSDictionary *entry = self.results[key];
+        NSDate *probeDate = entry[kAuthenticationProbeDateKey];
+        
+        if (!probeDate || [date timeIntervalSinceDate:probeDate] >= self.timeToLive || [date timeIntervalSinceDate:probeDate] < 0)
+        {
+            return AuthenticationProbeResultUnknown;
+        }
+        
+        return [entry[kAuthenticationProbeResultKey] integerValue];
+    }
+}
+
+- (void)cacheResult:(AuthenticationProbeResult)result forServerURLString:(NSString *)urlString
+{
+    NSString *key = [self keyForServerURLString:urlString];
+    if (!key)
+    {
+        return;
+    }
+    
+    if (result == AuthenticationProbeResultUnknown)
+    {
+        [self invalidateResultForServerURLString:urlString];
+        return;
+    }
+    
+    @synchronized(self)
+    {
+        self.results[key] = @{kAuthenticationProbeResultKey : @(result),
+                              kAuthenticationProbeDateKey : [NSDate date]};
+        [self persistResults];
+    }
+}
+
+- (void)invalidateResultForServerURLString:(NSString *)urlString
+{
+    NSString *key = [self keyForServerURLString:urlString];
+    if (!key)
+    {
+        return;
+    }
+    
+    @synchronized(self)
+    {
+        if (self.results[key])
+        {
+            [self.results removeObjectForKey:key];
+            [self persistResults];
+        }
+    }
+}
+
+- (void)removeAllResults
+{
+    @synchronized(self)
+    {
+        [self.results removeAllObjects];
+        [self.userDefaults removeObjectForKey:kAuthenticationProbeCacheDefaultsKey];
+    }
+}
+
+#pragma mark - Private Methods
+
+- (NSString *)keyForServerURLString:(NSString *)urlString
+{
+    NSString *key = [urlString.lowercaseString stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"/"]];
+    return key.length ? key : nil;
+}
+
+- (void)persistResults
+{
+    [self.userDefaults setObject:[self.results copy] forKey:kAuthenticationProbeCacheDefaultsKey];
+}
+
+@end
@@ -16,22 +16,56 @@
  *  limitations under the License.
  ******************************************************************************/
 
+@class CoreDataCacheHelper;
+
+/**
+ * Looks up people and their avatars. The manager uses the repository's person service by default; tests use a stub.
+ */
+@protocol AvatarManagerPersonService <NSObject>
+
+- (AlfrescoRequest *)retrievePersonWithIdentifier:(NSString *)identifier completionBlock:(AlfrescoPersonCompletionBlock)completionBlock;
+- (AlfrescoRequest *)retrieveAvatarForPerson:(AlfrescoPerson *)person completionBlock:(AlfrescoContentFileCompletionBlock)completionBlock;
+
+@end
+
 @interface AvatarConfiguration : NSObject
 
 @property (nonatomic, strong) NSString *identifier;
 @property (nonatomic, strong) id<AlfrescoSession> session;
 @property (nonatomic, strong) UIImage *placeholderImage;
 @property (nonatomic, assign) BOOL ignoreCache;
+/// The person, when the caller already has it, saving a lookup by identifier
+@property (nonatomic, strong) AlfrescoPerson *person;
 
 + (AvatarConfiguration *)defaultConfiguration;
 + (AvatarConfiguration *)defaultConfigurationWithIdentifier: (NSString *)identifier session:(id<AlfrescoSession>)session;
 
 @end
 
-
+/**
+ * Retrieves, crops and caches user avatars.
+ *
+ * Requests made during one run loop turn are gathered into a single batch, concurrent requests for the same identifier
+ * share one download, and people already looked up are reused. Cropping, encoding and persisting happen once per
+ * download, off the main thread. Every call's completion block is called exactly once, on the main thread: synchronously
+ * for a cached avatar, otherwise with the downloaded avatar or, failing that, the configuration's placeholder image.
+ * Callers wanting to show something while an avatar downloads should use cachedAvatarForIdentifier: or the placeholder.
+ * All methods must be called on the main thread.
+ */
 @interface AvatarManager : NSObject
 
+// Number of avatar downloads in flight at once. Defaults to 6.
+@property (nonatomic, assign) NSUInteger maximumConcurrentRequests;
+
 + (AvatarManager *)sharedManager;
+
+/*
+ * A nil person service uses the person service of each configuration's session. A nil cache helper keeps avatars in
+ * memory only.
+ */
+- (instancetype)initWithPersonService:(id<AvatarManagerPersonService>)personService cacheHelper:(CoreDataCacheHelper *)cacheHelper;
+
+- (UIImage *)cachedAvatarForIdentifier:(NSString *)identifier;
 - (void)retrieveAvatarWithConfiguration:(AvatarConfiguration *)configuration completionBlock:(ImageCompletionBlock)completionBlock;
 - (void)deleteAvatarForIdentifier:(NSString *)identifier;
 
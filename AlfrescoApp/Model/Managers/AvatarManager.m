@@ -19,6 +19,17 @@
 #import "AvatarManager.h"
 #import "CoreDataCacheHelper.h"
 
+static NSUInteger const kAvatarManagerDefaultMaximumConcurrentRequests = 6;
+static NSUInteger const kMaximumDecodedAvatarsInMemory = 300;
+static NSUInteger const kMaximumPeopleInMemory = 300;
+
+// The SDK's person service already implements the methods the manager needs
+@interface AlfrescoPersonService (AvatarManager) <AvatarManagerPersonService>
+@end
+
+@implementation AlfrescoPersonService (AvatarManager)
+@end
+
 @implementation AvatarConfiguration
 
 + (AvatarConfiguration *)defaultConfiguration
@@ -45,11 +56,19 @@
 
 @interface AvatarManager ()
 
-@property (nonatomic, strong) NSMutableDictionary *avatars;
-@property (nonatomic, strong) NSMutableDictionary *requestedUsernamesAndCompletionBlocks;
 @property (nonatomic, strong) id<AlfrescoSession> session;
-@property (nonatomic, strong) AlfrescoPersonService *personService;
+@property (nonatomic, strong) id<AvatarManagerPersonService> personService;
+@property (nonatomic, assign) BOOL usesSessionPersonService;
 @property (nonatomic, strong) CoreDataCacheHelper *coreDataCacheHelper;
+@property (nonatomic, strong) NSManagedObjectContext *backgroundManagedObjectContext;
+@property (nonatomic, strong) NSCache *decodedAvatars;
+@property (nonatomic, strong) NSCache *people;
+// Identifier to the completion blocks waiting on its download
+@property (nonatomic, strong) NSMutableDictionary *requestedUsernamesAndCompletionBlocks;
+@property (nonatomic, strong) NSMutableOrderedSet *queuedIdentifiers;
+@property (nonatomic, assign) BOOL batchScheduled;
+@property (nonatomic, assign) NSUInteger numberOfActiveRequests;
+@property (nonatomic, strong) dispatch_queue_t processingQueue;
 
 @end
 
@@ -67,18 +86,36 @@
 
 - (instancetype)init
 {
-    self = [super init];
+    self = [self initWithPersonService:nil cacheHelper:[[CoreDataCacheHelper alloc] init]];
     if (self)
     {
-        self.avatars = [NSMutableDictionary dictionary];
-        self.requestedUsernamesAndCompletionBlocks = [NSMutableDictionary dictionary];
-        self.coreDataCacheHelper = [[CoreDataCacheHelper alloc] init];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionReceivedNotification object:nil];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionRefreshedNotification object:nil];
     }
     return self;
 }
 
+- (instancetype)initWithPersonService:(id<AvatarManagerPersonService>)personService cacheHelper:(CoreDataCacheHelper *)cacheHelper
+{
+    self = [super init];
+    if (self)
+    {
+        self.personService = personService;
+        self.usesSessionPersonService = (personService == nil);
+        self.coreDataCacheHelper = cacheHelper;
+        self.backgroundManagedObjectContext = [cacheHelper createBackgroundManagedObjectContext];
+        self.decodedAvatars = [[NSCache alloc] init];
+        self.decodedAvatars.countLimit = kMaximumDecodedAvatarsInMemory;
+        self.people = [[NSCache alloc] init];
+        self.people.countLimit = kMaximumPeopleInMemory;
+        self.requestedUsernamesAndCompletionBlocks = [NSMutableDictionary dictionary];
+        self.queuedIdentifiers = [NSMutableOrderedSet orderedSet];
+        self.maximumConcurrentRequests = kAvatarManagerDefaultMaximumConcurrentRequests;
+        self.processingQueue = dispatch_queue_create("com.alfresco.app.avatarprocessing", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
 // should never get here. Added for completeness
 - (void)dealloc
 {
@@ -90,154 +127,241 @@
 - (void)sessionReceived:(NSNotification *)notification
 {
     id <AlfrescoSession> session = notification.object;
-    self.session = session;
+    [self updateSession:session];
+}
+
+- (void)updateSession:(id<AlfrescoSession>)session
+{
+    if (!session || [self.session isEqual:session])
+    {
+        return;
+    }
     
-    self.personService = [[AlfrescoPersonService alloc] initWithSession:self.session];
+    self.session = session;
     
-    [self clearOldAvatarRequests];
+    if (self.usesSessionPersonService)
+    {
+        self.personService = [[AlfrescoPersonService alloc] initWithSession:session];
+        // People looked up belong to the previous server. Downloads in flight still complete their callers.
+        [self.people removeAllObjects];
+    }
 }
 
 #pragma mark - Public Functions
 
-- (UIImage *)avatarForIdentifier:(NSString *)identifier
+- (UIImage *)cachedAvatarForIdentifier:(NSString *)identifier
 {
-    AvatarImageCache *retrievedImageCacheObject = [self.coreDataCacheHelper retrieveAvatarForIdentifier:identifier inManagedObjectContext:nil];
-    return [retrievedImageCacheObject avatarImage];
+    if (!identifier)
+    {
+        return nil;
+    }
+    
+    UIImage *avatarImage = [self.decodedAvatars objectForKey:identifier];
+    if (!avatarImage && self.coreDataCacheHelper)
+    {
+        AvatarImageCache *retrievedImageCacheObject = [self.coreDataCacheHelper retrieveAvatarForIdentifier:identifier inManagedObjectContext:nil];
+        avatarImage = [Utility decodedImage:[retrievedImageCacheObject avatarImage]];
+        if (avatarImage)
+        {
+            [self.decodedAvatars setObject:avatarImage forKey:identifier];
+        }
+    }
+    return avatarImage;
 }
 
 - (void)retrieveAvatarWithConfiguration:(AvatarConfiguration *)configuration completionBlock:(ImageCompletionBlock)completionBlock
 {
-    if (![self.session isEqual:configuration.session])
+    [self updateSession:configuration.session];
+    
+    NSString *identifier = configuration.identifier;
+    if (identifier == nil)
     {
-        self.session = configuration.session;
-        self.personService = [[AlfrescoPersonService alloc] initWithSession:configuration.session];
+        completionBlock(configuration.placeholderImage, nil);
+        return;
     }
-
-    if (configuration.identifier == nil)
+    
+    UIImage *cachedAvatar = [self cachedAvatarForIdentifier:identifier];
+    if (cachedAvatar && !configuration.ignoreCache)
     {
-        completionBlock(configuration.placeholderImage, nil);
+        completionBlock(cachedAvatar, nil);
+        return;
+    }
+    
+    if (configuration.person)
+    {
+        [self.people setObject:configuration.person forKey:identifier];
+    }
+    
+    // Should the download fail, the caller gets the best image available to it
+    UIImage *fallbackImage = cachedAvatar ?: configuration.placeholderImage;
+    ImageCompletionBlock copiedBlock = [completionBlock copy];
+    ImageCompletionBlock resolvingBlock = ^(UIImage *avatarImage, NSError *error) {
+        copiedBlock(avatarImage ?: fallbackImage, error);
+    };
+    
+    // Join a download already queued or in flight for this identifier
+    NSMutableArray *blocks = self.requestedUsernamesAndCompletionBlocks[identifier];
+    if (blocks)
+    {
+        [blocks addObject:[resolvingBlock copy]];
         return;
     }
+    
+    self.requestedUsernamesAndCompletionBlocks[identifier] = [NSMutableArray arrayWithObject:[resolvingBlock copy]];
+    [self.queuedIdentifiers addObject:identifier];
+    [self scheduleBatch];
+}
 
-    UIImage *avatarImage = [self avatarForIdentifier: configuration.identifier];
+- (void)deleteAvatarForIdentifier:(NSString *)identifier
+{
+    if (!identifier)
+    {
+        return;
+    }
     
-    if (avatarImage)
+    [self.decodedAvatars removeObjectForKey:identifier];
+    
+    if (self.coreDataCacheHelper)
     {
-        completionBlock(avatarImage, nil);
-        
-        if (configuration.ignoreCache)
-        {
-            [self deleteAvatarForIdentifier:configuration.identifier];
-        }
-        else
-        {
-            return;
-        }
+        AvatarImageCache *avatarToDelete = [self.coreDataCacheHelper retrieveAvatarForIdentifier:identifier inManagedObjectContext:nil];
+        [self.coreDataCacheHelper deleteRecordForManagedObject:avatarToDelete inManagedObjectContext:nil];
     }
-    else
+}
+
+#pragma mark - Batching
+
+- (void)scheduleBatch
+{
+    if (self.batchScheduled)
     {
-        completionBlock(configuration.placeholderImage, nil);
+        return;
     }
     
-    ImageCompletionBlock copiedBlock = [completionBlock copy];
-    completionBlock(configuration.placeholderImage, nil);
+    // Everything requested during this run loop turn, e.g. while a table lays out its visible cells, is started together
+    self.batchScheduled = YES;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        self.batchScheduled = NO;
+        [self startQueuedRequests];
+    });
+}
+
+- (void)startQueuedRequests
+{
+    while (self.queuedIdentifiers.count > 0 && self.numberOfActiveRequests < self.maximumConcurrentRequests)
+    {
+        NSString *identifier = self.queuedIdentifiers.firstObject;
+        [self.queuedIdentifiers removeObjectAtIndex:0];
+        [self downloadAvatarForIdentifier:identifier];
+    }
+}
+
+- (void)downloadAvatarForIdentifier:(NSString *)identifier
+{
+    self.numberOfActiveRequests++;
     
-    if ([[self.requestedUsernamesAndCompletionBlocks allKeys] containsObject:configuration.identifier] && configuration.ignoreCache == NO)
+    id<AvatarManagerPersonService> personService = self.personService;
+    if (!personService)
     {
-        [self addCompletionBlock:copiedBlock forKey:configuration.identifier];
+        [self finishRequestForIdentifier:identifier avatarImage:nil error:nil];
         return;
     }
     
-    [self addCompletionBlock:copiedBlock forKey:configuration.identifier];
+    AlfrescoPerson *knownPerson = [self.people objectForKey:identifier];
+    if (knownPerson)
+    {
+        [self downloadAvatarForPerson:knownPerson identifier:identifier personService:personService];
+        return;
+    }
     
-    [self.personService retrievePersonWithIdentifier:configuration.identifier completionBlock:^(AlfrescoPerson *person, NSError *identifierError) {
+    [personService retrievePersonWithIdentifier:identifier completionBlock:^(AlfrescoPerson *person, NSError *identifierError) {
         if (person)
         {
-            [self.personService retrieveAvatarForPerson:person completionBlock:^(AlfrescoContentFile *contentFile, NSError *contentError) {
-                if (contentFile)
-                {
-                    NSManagedObjectContext *childManagedObjectContext = [self.coreDataCacheHelper createChildManagedObjectContext];
-                    AvatarImageCache *imageCache = [self.coreDataCacheHelper createAvatarObjectInManagedObjectContext:childManagedObjectContext];
-                    imageCache.identifier = configuration.identifier;
-                    
-                    // Crop the avatar
-                    UIImage *uncroppedAvatar = [UIImage imageWithContentsOfFile:contentFile.fileUrl.path];
-                    UIImage *croppedAvatar = [Utility cropImageIntoSquare:uncroppedAvatar];
-                    
-                    imageCache.avatarImageData = UIImagePNGRepresentation(croppedAvatar);
-                    imageCache.dateAdded = [NSDate date];
-                    [self.coreDataCacheHelper saveContextForManagedObjectContext:childManagedObjectContext];
-                    
-                    // remove the temp file
-                    NSError *removalError = nil;
-                    [[AlfrescoFileManager sharedManager] removeItemAtPath:contentFile.fileUrl.path error:&removalError];
-                    
-                    if (removalError)
-                    {
-                        AlfrescoLogError(@"Error removing file at path %@", contentFile.fileUrl.path);
-                    }
-                    
-                    [self runAllCompletionBlocksForIdentifier:configuration.identifier avatarImage:[imageCache avatarImage] error:contentError];
-                }
-                else
-                {
-                    [self runAllCompletionBlocksForIdentifier:configuration.identifier avatarImage:configuration.placeholderImage error:contentError];
-                }
-            }];
+            [self.people setObject:person forKey:identifier];
+            [self downloadAvatarForPerson:person identifier:identifier personService:personService];
         }
         else
         {
-            [self runAllCompletionBlocksForIdentifier:configuration.identifier avatarImage:configuration.placeholderImage error:identifierError];
+            [self finishRequestForIdentifier:identifier avatarImage:nil error:identifierError];
         }
     }];
 }
 
-- (void)deleteAvatarForIdentifier:(NSString *)identifier
+- (void)downloadAvatarForPerson:(AlfrescoPerson *)person identifier:(NSString *)identifier personService:(id<AvatarManagerPersonService>)personService
 {
-    AvatarImageCache *avatarToDelete = [self.coreDataCacheHelper retrieveAvatarForIdentifier:identifier inManagedObjectContext:nil];
-    [self.coreDataCacheHelper deleteRecordForManagedObject:avatarToDelete inManagedObjectContext:nil];
+    [personService retrieveAvatarForPerson:person completionBlock:^(AlfrescoContentFile *contentFile, NSError *contentError) {
+        if (contentFile)
+        {
+            dispatch_async(self.processingQueue, ^{
+                UIImage *avatarImage = [self processAvatarAtPath:contentFile.fileUrl.path identifier:identifier];
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    [self finishRequestForIdentifier:identifier avatarImage:avatarImage error:contentError];
+                });
+            });
+        }
+        else
+        {
+            [self finishRequestForIdentifier:identifier avatarImage:nil error:contentError];
+        }
+    }];
 }
 
-#pragma mark - Private Functions
-
-- (void)addCompletionBlock:(ImageCompletionBlock)completionBlock forKey:(NSString *)personIdentifier
+- (void)finishRequestForIdentifier:(NSString *)identifier avatarImage:(UIImage *)avatarImage error:(NSError *)error
 {
-    AlfrescoContentFileCompletionBlock retainedBlock = [completionBlock copy];
-    if ([[self.requestedUsernamesAndCompletionBlocks allKeys] containsObject:personIdentifier])
+    self.numberOfActiveRequests--;
+    
+    if (avatarImage)
     {
-        NSMutableArray *blocks = [self.requestedUsernamesAndCompletionBlocks objectForKey:personIdentifier];
-        [blocks addObject:retainedBlock];
+        [self.decodedAvatars setObject:avatarImage forKey:identifier];
     }
-    else
+    
+    NSArray *blocks = self.requestedUsernamesAndCompletionBlocks[identifier];
+    [self.requestedUsernamesAndCompletionBlocks removeObjectForKey:identifier];
+    for (ImageCompletionBlock block in blocks)
     {
-        NSMutableArray *blocks = [NSMutableArray arrayWithObject:retainedBlock];
-        [self.requestedUsernamesAndCompletionBlocks setObject:blocks forKey:personIdentifier];
+        block(avatarImage, error);
     }
+    
+    [self startQueuedRequests];
 }
 
-- (void)runAllCompletionBlocksForIdentifier:(NSString *)personIdentifier avatarImage:(UIImage *)avatarImage error:(NSError *)error
-{
-    NSArray *blocks = [self.requestedUsernamesAndCompletionBlocks objectForKey:personIdentifier];
-    [blocks enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
-        ImageCompletionBlock currentBlock = (ImageCompletionBlock)obj;
-        currentBlock(avatarImage, nil);
-    }];
-    [self removeAllCompletionBlocksForPersonIdentifier:personIdentifier];
-}
-
-- (void)removeAllCompletionBlocksForPersonIdentifier:(NSString *)personIdentifier
-{
-    [self.requestedUsernamesAndCompletionBlocks removeObjectForKey:personIdentifier];
-}
+#pragma mark - Processing
 
-- (void)clearOldAvatarRequests
+/*
+ * Called on the processing queue. Crops, decodes and stores the downloaded avatar, then removes the downloaded file.
+ */
+- (UIImage *)processAvatarAtPath:(NSString *)path identifier:(NSString *)identifier
 {
-    [[self.requestedUsernamesAndCompletionBlocks allKeys] enumerateObjectsUsingBlock:^(NSString *key, NSUInteger idx, BOOL *stop) {
-        if (![key isEqualToString:self.session.personIdentifier])
-        {
-            [self.requestedUsernamesAndCompletionBlocks removeObjectForKey:key];
-        }
-    }];
+    UIImage *uncroppedAvatar = [UIImage imageWithContentsOfFile:path];
+    UIImage *croppedAvatar = [Utility decodedImage:[Utility cropImageIntoSquare:uncroppedAvatar]];
+    
+    if (croppedAvatar && self.backgroundManagedObjectContext)
+    {
+        NSData *avatarImageData = UIImagePNGRepresentation(croppedAvatar);
+        NSManagedObjectContext *backgroundContext = self.backgroundManagedObjectContext;
+        [backgroundContext performBlockAndWait:^{
+            AvatarImageCache *imageCache = [self.coreDataCacheHelper retrieveAvatarForIdentifier:identifier inManagedObjectContext:backgroundContext];
+            if (!imageCache)
+            {
+                imageCache = [self.coreDataCacheHelper createAvatarObjectInManagedObjectContext:backgroundContext];
+                imageCache.identifier = identifier;
+            }
+            imageCache.avatarImageData = avatarImageData;
+            imageCache.dateAdded = [NSDate date];
+            [self.coreDataCacheHelper saveContextForManagedObjectContext:backgroundContext];
+            [backgroundContext reset];
+        }];
+    }
+    
+    // remove the temp file
+    NSError *removalError = nil;
+    [[AlfrescoFileManager sharedManager] removeItemAtPath:path error:&removalError];
+    
+    if (removalError)
+    {
+        AlfrescoLogError(@"Error removing file at path %@", path);
+    }
+    
+    return croppedAvatar;
 }
 
 @end
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+@class BatchUploadQueue;
+
+typedef BOOL (^BatchUploadContentPreparationBlock)(NSString *filePath);
+
+@interface BatchUploadItem : NSObject
+
+@property (nonatomic, strong, readonly) NSString *documentName;
+@property (nonatomic, strong, readonly) NSString *mimeType;
+@property (nonatomic, strong, readonly) NSString *filePath;
+@property (nonatomic, strong) id context;
+// Invoked on a background queue before the first attempt, allowing the content to be written to filePath lazily
+@property (nonatomic, copy) BatchUploadContentPreparationBlock contentPreparationBlock;
+@property (nonatomic, assign) BOOL removeFileAfterUpload;
+@property (nonatomic, strong, readonly) AlfrescoDocument *document;
+@property (nonatomic, strong, readonly) NSError *error;
+@property (nonatomic, assign, readonly) NSUInteger numberOfAttempts;
+@property (nonatomic, assign, readonly) float progress;
+
+- (instancetype)initWithDocumentName:(NSString *)documentName mimeType:(NSString *)mimeType filePath:(NSString *)filePath;
+
+@end
+
+@protocol BatchUploadQueueDelegate <NSObject>
+
+@optional
+- (void)batchUploadQueue:(BatchUploadQueue *)queue item:(BatchUploadItem *)item didUpdateProgress:(float)progress;
+- (void)batchUploadQueue:(BatchUploadQueue *)queue didUpdateTotalProgress:(float)progress;
+- (void)batchUploadQueue:(BatchUploadQueue *)queue didUploadItem:(BatchUploadItem *)item;
+- (void)batchUploadQueue:(BatchUploadQueue *)queue didFailToUploadItem:(BatchUploadItem *)item;
+- (void)batchUploadQueue:(BatchUploadQueue *)queue didFinishUploadingItems:(NSArray *)items;
+
+@end
+
+/**
+ * Uploads a batch of files into a folder with a bounded number of concurrent requests.
+ * Failed uploads are retried with an exponential backoff. All delegate callbacks are delivered on the main thread.
+ * didUploadItem: and didFailToUploadItem: are called as each item completes, which with concurrent uploads need not be
+ * the order the items were submitted in; only the items passed to didFinishUploadingItems: keep that order.
+ */
+@interface BatchUploadQueue : NSObject
+
+@property (nonatomic, weak) id<BatchUploadQueueDelegate> delegate;
+@property (nonatomic, assign) NSUInteger maxConcurrentUploads;
+@property (nonatomic, assign) NSUInteger maxRetryAttempts;
+@property (nonatomic, assign) NSTimeInterval retryBaseDelay;
+
+- (instancetype)initWithDocumentFolderService:(AlfrescoDocumentFolderService *)documentFolderService uploadFolder:(AlfrescoFolder *)uploadFolder;
+- (void)uploadItems:(NSArray *)items;
+- (void)cancelAllUploads;
+- (BOOL)isUploading;
+
+@end
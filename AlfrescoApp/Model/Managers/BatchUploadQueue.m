@@ -0,0 +1,375 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+ 
+#import "BatchUploadQueue.h"
+
+static NSUInteger const kDefaultMaxConcurrentUploads = 3;
+static NSUInteger const kDefaultMaxRetryAttempts = 2;
+static NSTimeInterval const kDefaultRetryBaseDelay = 1.0;
+// Allowance for the server's clock when deciding whether a clashing document came from an earlier attempt
+static NSTimeInterval const kMaximumServerClockSkew = 300.0;
+
+@interface BatchUploadItem ()
+@property (nonatomic, strong, readwrite) AlfrescoDocument *document;
+@property (nonatomic, strong, readwrite) NSError *error;
+@property (nonatomic, assign, readwrite) NSUInteger numberOfAttempts;
+@property (nonatomic, assign, readwrite) float progress;
+@property (nonatomic, assign) BOOL contentPrepared;
+@property (nonatomic, assign) CFAbsoluteTime startTime;
+@property (nonatomic, strong) NSDate *firstAttemptDate;
+@end
+
+@implementation BatchUploadItem
+
+- (instancetype)initWithDocumentName:(NSString *)documentName mimeType:(NSString *)mimeType filePath:(NSString *)filePath
+{
+    self = [super init];
+    if (self)
+    {
+        _documentName = documentName;
+        _mimeType = mimeType;
+        _filePath = filePath;
+    }
+    return self;
+}
+
+@end
+
+@interface BatchUploadQueue ()
+@property (nonatomic, strong) AlfrescoDocumentFolderService *documentFolderService;
+@property (nonatomic, strong) AlfrescoFolder *uploadFolder;
+@property (nonatomic, strong) NSArray *items;
+@property (nonatomic, strong) NSMutableArray *pendingItems;
+@property (nonatomic, strong) NSMapTable *requestsInProgress;
+@property (nonatomic, assign) NSUInteger numberOfActiveUploads;
+@property (nonatomic, assign) NSUInteger numberOfCompletedItems;
+@property (nonatomic, strong) dispatch_queue_t preparationQueue;
+@property (nonatomic, assign) BOOL cancelled;
+@end
+
+@implementation BatchUploadQueue
+
+- (instancetype)initWithDocumentFolderService:(AlfrescoDocumentFolderService *)documentFolderService uploadFolder:(AlfrescoFolder *)uploadFolder
+{
+    self = [super init];
+    if (self)
+    {
+        self.documentFolderService = documentFolderService;
+        self.uploadFolder = uploadFolder;
+        self.maxConcurrentUploads = kDefaultMaxConcurrentUploads;
+        self.maxRetryAttempts = kDefaultMaxRetryAttempts;
+        self.retryBaseDelay = kDefaultRetryBaseDelay;
+        self.requestsInProgress = [NSMapTable strongToStrongObjectsMapTable];
+        self.preparationQueue = dispatch_queue_create("com.alfresco.app.batchupload.preparation", DISPATCH_QUEUE_CONCURRENT);
+    }
+    return self;
+}
+
+#pragma mark - Public Methods
+
+- (void)uploadItems:(NSArray *)items
+{
+    NSAssert([NSThread isMainThread], @"Batch uploads must be started from the main thread");
+    
+    self.items = [items copy];
+    self.pendingItems = [items mutableCopy];
+    self.numberOfActiveUploads = 0;
+    self.numberOfCompletedItems = 0;
+    self.cancelled = NO;
+    
+    if (items.count == 0)
+    {
+        [self finishBatch];
+        return;
+    }
+    
+    [self startPendingUploads];
+}
+
+- (void)cancelAllUploads
+{
+    self.cancelled = YES;
+    
+    // Items that never started are reported as failed, but not counted as completed uploads
+    NSError *cancelledError = [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeNetworkRequestCancelled];
+    NSArray *cancelledItems = [self.pendingItems copy];
+    [self.pendingItems removeAllObjects];
+    for (BatchUploadItem *item in cancelledItems)
+    {
+        item.error = cancelledError;
+        if ([self.delegate respondsToSelector:@selector(batchUploadQueue:didFailToUploadItem:)])
+        {
+            [self.delegate batchUploadQueue:self didFailToUploadItem:item];
+        }
+        [self notifyProgressForItem:item];
+    }
+    
+    // Active uploads complete through their own completion blocks once cancelled
+    for (AlfrescoRequest *request in self.requestsInProgress.objectEnumerator.allObjects)
+    {
+        [request cancel];
+    }
+    
+    if (self.numberOfActiveUploads == 0 && self.items.count > 0)
+    {
+        [self finishBatch];
+    }
+}
+
+- (BOOL)isUploading
+{
+    return self.numberOfActiveUploads > 0 || self.pendingItems.count > 0;
+}
+
+#pragma mark - Private Methods
+
+- (void)startPendingUploads
+{
+    while (!self.cancelled && self.numberOfActiveUploads < self.maxConcurrentUploads && self.pendingItems.count > 0)
+    {
+        BatchUploadItem *item = self.pendingItems.firstObject;
+        [self.pendingItems removeObjectAtIndex:0];
+        self.numberOfActiveUploads++;
+        [self prepareAndUploadItem:item];
+    }
+}
+
+- (void)prepareAndUploadItem:(BatchUploadItem *)item
+{
+    if (item.contentPrepared || !item.contentPreparationBlock)
+    {
+        [self uploadItem:item];
+        return;
+    }
+    
+    dispatch_async(self.preparationQueue, ^{
+        BOOL prepared = item.contentPreparationBlock(item.filePath);
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (prepared)
+            {
+                item.contentPrepared = YES;
+                [self uploadItem:item];
+            }
+            else
+            {
+                item.error = [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeDocumentFolder];
+                [self completeItem:item];
+            }
+        });
+    });
+}
+
+- (void)uploadItem:(BatchUploadItem *)item
+{
+    if (self.cancelled)
+    {
+        item.error = [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeNetworkRequestCancelled];
+        [self completeItem:item];
+        return;
+    }
+    
+    item.numberOfAttempts++;
+    item.progress = 0.0f;
+    item.startTime = CFAbsoluteTimeGetCurrent();
+    if (!item.firstAttemptDate)
+    {
+        item.firstAttemptDate = [NSDate date];
+    }
+    
+    __weak typeof(self) weakSelf = self;
+    AlfrescoRequest *request = [self.documentFolderService createDocumentWithName:item.documentName inParentFolder:self.uploadFolder contentStream:[self contentStreamForItem:item] properties:nil aspects:nil completionBlock:^(AlfrescoDocument *document, NSError *error) {
+        [weakSelf.requestsInProgress removeObjectForKey:item];
+        
+        if (document)
+        {
+            item.document = document;
+            item.error = nil;
+            item.progress = 1.0f;
+            AlfrescoLogDebug(@"Uploaded %@ in %.0f ms (attempt %lu)", item.documentName, (CFAbsoluteTimeGetCurrent() - item.startTime) * 1000, (unsigned long)item.numberOfAttempts);
+            [weakSelf completeItem:item];
+        }
+        else if (error.code == kAlfrescoErrorCodeDocumentFolderNodeAlreadyExists && item.numberOfAttempts > 1)
+        {
+            // An earlier attempt may have created the document before its response was lost
+            [weakSelf uploadItem:item intoDocumentCreatedByEarlierAttemptAfterError:error];
+        }
+        else if ([weakSelf shouldRetryItem:item afterError:error])
+        {
+            NSTimeInterval delay = weakSelf.retryBaseDelay * pow(2, item.numberOfAttempts - 1);
+            AlfrescoLogDebug(@"Retrying upload of %@ in %.1f seconds: %@", item.documentName, delay, error.localizedDescription);
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+                [weakSelf uploadItem:item];
+            });
+        }
+        else
+        {
+            item.error = error ?: [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeUnknown];
+            [weakSelf completeItem:item];
+        }
+    } progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+        item.progress = (bytesTotal == 0) ? 1.0f : (float)bytesTransferred / (float)bytesTotal;
+        [weakSelf notifyProgressForItem:item];
+    }];
+    
+    if (request)
+    {
+        [self.requestsInProgress setObject:request forKey:item];
+    }
+}
+
+/*
+ * Uploads the item's content into the document with its name, as long as that document was created since the item's first attempt.
+ * Otherwise the name belongs to someone else's document, and the item fails with the original error.
+ */
+- (void)uploadItem:(BatchUploadItem *)item intoDocumentCreatedByEarlierAttemptAfterError:(NSError *)alreadyExistsError
+{
+    __weak typeof(self) weakSelf = self;
+    AlfrescoRequest *request = [self.documentFolderService retrieveNodeWithFolderPath:item.documentName relativeToFolder:self.uploadFolder completionBlock:^(AlfrescoNode *node, NSError *error) {
+        [weakSelf.requestsInProgress removeObjectForKey:item];
+        
+        NSDate *earliestCreationDate = [item.firstAttemptDate dateByAddingTimeInterval:-kMaximumServerClockSkew];
+        if (weakSelf.cancelled || !node.isDocument || [node.createdAt compare:earliestCreationDate] == NSOrderedAscending)
+        {
+            item.error = weakSelf.cancelled ? [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeNetworkRequestCancelled] : alreadyExistsError;
+            [weakSelf completeItem:item];
+            return;
+        }
+        
+        AlfrescoLogDebug(@"Reusing %@, created by an earlier attempt to upload it", item.documentName);
+        AlfrescoRequest *updateRequest = [weakSelf.documentFolderService updateContentOfDocument:(AlfrescoDocument *)node contentStream:[weakSelf contentStreamForItem:item] completionBlock:^(AlfrescoDocument *document, NSError *updateError) {
+            [weakSelf.requestsInProgress removeObjectForKey:item];
+            
+            item.document = document;
+            item.error = document ? nil : (updateError ?: [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeUnknown]);
+            if (document)
+            {
+                item.progress = 1.0f;
+            }
+            [weakSelf completeItem:item];
+        } progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+            item.progress = (bytesTotal == 0) ? 1.0f : (float)bytesTransferred / (float)bytesTotal;
+            [weakSelf notifyProgressForItem:item];
+        }];
+        
+        if (updateRequest)
+        {
+            [weakSelf.requestsInProgress setObject:updateRequest forKey:item];
+        }
+    }];
+    
+    if (request)
+    {
+        [self.requestsInProgress setObject:request forKey:item];
+    }
+}
+
+- (AlfrescoContentStream *)contentStreamForItem:(BatchUploadItem *)item
+{
+    NSDictionary *fileAttributes = [[AlfrescoFileManager sharedManager] attributesOfItemAtPath:item.filePath error:nil];
+    unsigned long long fileLength = [fileAttributes[kAlfrescoFileSize] unsignedLongLongValue];
+    NSInputStream *readStream = [[AlfrescoFileManager sharedManager] inputStreamWithFilePath:item.filePath];
+    return [[AlfrescoContentStream alloc] initWithStream:readStream mimeType:item.mimeType length:fileLength];
+}
+
+- (BOOL)shouldRetryItem:(BatchUploadItem *)item afterError:(NSError *)error
+{
+    if (self.cancelled || item.numberOfAttempts > self.maxRetryAttempts)
+    {
+        return NO;
+    }
+    
+    // Name clashes and cancellations will not go away by trying again
+    switch (error.code)
+    {
+        case kAlfrescoErrorCodeDocumentFolder:
+        case kAlfrescoErrorCodeDocumentFolderNodeAlreadyExists:
+        case kAlfrescoErrorCodeNetworkRequestCancelled:
+        case kAlfrescoErrorCodeUnauthorisedAccess:
+            return NO;
+            
+        default:
+            return YES;
+    }
+}
+
+- (void)completeItem:(BatchUploadItem *)item
+{
+    self.numberOfActiveUploads--;
+    self.numberOfCompletedItems++;
+    
+    if (item.document)
+    {
+        if ([self.delegate respondsToSelector:@selector(batchUploadQueue:didUploadItem:)])
+        {
+            [self.delegate batchUploadQueue:self didUploadItem:item];
+        }
+    }
+    else if ([self.delegate respondsToSelector:@selector(batchUploadQueue:didFailToUploadItem:)])
+    {
+        [self.delegate batchUploadQueue:self didFailToUploadItem:item];
+    }
+    
+    if (item.removeFileAfterUpload && item.contentPrepared)
+    {
+        NSError *deleteError = nil;
+        [[AlfrescoFileManager sharedManager] removeItemAtPath:item.filePath error:&deleteError];
+        if (deleteError)
+        {
+            AlfrescoLogError(@"Error deleting file after upload: %@", [ErrorDescriptions descriptionForError:deleteError]);
+        }
+    }
+    
+    [self notifyProgressForItem:item];
+    
+    if (self.numberOfCompletedItems == self.items.count || (self.cancelled && self.numberOfActiveUploads == 0))
+    {
+        [self finishBatch];
+    }
+    else
+    {
+        [self startPendingUploads];
+    }
+}
+
+- (void)notifyProgressForItem:(BatchUploadItem *)item
+{
+    if ([self.delegate respondsToSelector:@selector(batchUploadQueue:item:didUpdateProgress:)])
+    {
+        [self.delegate batchUploadQueue:self item:item didUpdateProgress:item.progress];
+    }
+    
+    if ([self.delegate respondsToSelector:@selector(batchUploadQueue:didUpdateTotalProgress:)])
+    {
+        float totalProgress = 0.0f;
+        for (BatchUploadItem *batchItem in self.items)
+        {
+            totalProgress += (batchItem.document || batchItem.error) ? 1.0f : batchItem.progress;
+        }
+        [self.delegate batchUploadQueue:self didUpdateTotalProgress:(totalProgress / self.items.count)];
+    }
+}
+
+- (void)finishBatch
+{
+    if ([self.delegate respondsToSelector:@selector(batchUploadQueue:didFinishUploadingItems:)])
+    {
+        [self.delegate batchUploadQueue:self didFinishUploadingItems:self.items];
+    }
+}
+
+@end
@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+/**
+ * Keeps the previewed documents in a folder within a byte budget, evicting the least recently used files first.
+ * Which files are held, their sizes and when they were last used are indexed in memory, so lookups don't touch the file system.
+ * All methods may be called from any thread.
+ */
+@interface DocumentPreviewCache : NSObject
+
+/// The number of bytes the cached files may take up. Lowering it evicts files straight away.
+@property (nonatomic, assign) unsigned long long maximumSize;
+/// The number of bytes taken up by the cached files
+@property (nonatomic, assign, readonly) unsigned long long totalSize;
+
+/*
+ * Creates a cache for the files in the folder. Files already in the folder are indexed in the background.
+ */
+- (instancetype)initWithFolderPath:(NSString *)folderPath maximumSize:(unsigned long long)maximumSize;
+
+/*
+ * Returns YES if the file is held by the cache, and marks it as the most recently used.
+ */
+- (BOOL)containsFileWithName:(NSString *)fileName;
+
+/*
+ * Adds a file that has been moved into the folder. Other versions of the node are removed unless pinned, then the least
+ * recently used files are evicted until the cache is within its budget. The file being added is never evicted.
+ */
+- (void)addFileWithName:(NSString *)fileName nodeIdentifier:(NSString *)nodeIdentifier;
+
+/*
+ * Keeps the file from being evicted, e.g. while it is being previewed. The file need not be cached yet. Pins are counted,
+ * so each call must be balanced by a call to unpinFileWithName:.
+ */
+- (void)pinFileWithName:(NSString *)fileName;
+
+/*
+ * Releases a pin. Once a file has no pins left it may be evicted again, straight away if the cache is over its budget.
+ */
+- (void)unpinFileWithName:(NSString *)fileName;
+
+/*
+ * Removes the file from the index and the folder.
+ */
+- (void)removeFileWithName:(NSString *)fileName;
+
+/*
+ * Removes every cached file.
+ */
+- (void)removeAllFiles;
+
+/*
+ * The names of the cached files, least recently used first.
+ */
+- (NSArray<NSString *> *)fileNamesInEvictionOrder;
+
+@end
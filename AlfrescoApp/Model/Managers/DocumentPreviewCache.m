@@ -0,0 +1,408 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "DocumentPreviewCache.h"
+
+static NSString * const kDocumentPreviewCacheIndexFileName = @".DocumentPreviewCacheIndex";
+static NSString * const kDocumentPreviewCacheVersionKey = @"version";
+static NSString * const kDocumentPreviewCacheEntriesKey = @"entries";
+static NSInteger const kDocumentPreviewCacheVersion = 1;
+static NSTimeInterval const kDocumentPreviewCacheSaveDelay = 2.0;
+
+@interface DocumentPreviewCacheEntry : NSObject <NSSecureCoding>
+@property (nonatomic, strong) NSString *fileName;
+@property (nonatomic, strong) NSString *nodeIdentifier;
+@property (nonatomic, assign) unsigned long long size;
+@property (nonatomic, strong) NSDate *lastAccessDate;
+@end
+
+@implementation DocumentPreviewCacheEntry
+
++ (BOOL)supportsSecureCoding
+{
+    return YES;
+}
+
+- (instancetype)initWithCoder:(NSCoder *)aDecoder
+{
+    self = [super init];
+    if (self)
+    {
+        self.fileName = [aDecoder decodeObjectOfClass:[NSString class] forKey:@"fileName"];
+        self.nodeIdentifier = [aDecoder decodeObjectOfClass:[NSString class] forKey:@"nodeIdentifier"];
+        self.size = [[aDecoder decodeObjectOfClass:[NSNumber class] forKey:@"size"] unsignedLongLongValue];
+        self.lastAccessDate = [aDecoder decodeObjectOfClass:[NSDate class] forKey:@"lastAccessDate"];
+    }
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)aCoder
+{
+    [aCoder encodeObject:self.fileName forKey:@"fileName"];
+    [aCoder encodeObject:self.nodeIdentifier forKey:@"nodeIdentifier"];
+    [aCoder encodeObject:@(self.size) forKey:@"size"];
+    [aCoder encodeObject:self.lastAccessDate forKey:@"lastAccessDate"];
+}
+
+@end
+
+@interface DocumentPreviewCache ()
+@property (nonatomic, strong) NSString *folderPath;
+@property (nonatomic, strong) NSString *indexFilePath;
+@property (nonatomic, strong) dispatch_queue_t indexQueue;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, DocumentPreviewCacheEntry *> *entriesByFileName;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSString *> *fileNamesByNodeIdentifier;
+// Least recently used first
+@property (nonatomic, strong) NSMutableOrderedSet<NSString *> *fileNamesByAccess;
+// Files of the previews on screen, which must stay on disk whatever the budget
+@property (nonatomic, strong) NSCountedSet<NSString *> *pinnedFileNames;
+@property (nonatomic, assign) unsigned long long indexedSize;
+@property (nonatomic, assign) unsigned long long sizeLimit;
+@property (nonatomic, assign) NSUInteger saveGeneration;
+@end
+
+@implementation DocumentPreviewCache
+
+- (instancetype)initWithFolderPath:(NSString *)folderPath maximumSize:(unsigned long long)maximumSize
+{
+    self = [super init];
+    if (self)
+    {
+        self.folderPath = folderPath;
+        self.indexFilePath = [folderPath stringByAppendingPathComponent:kDocumentPreviewCacheIndexFileName];
+        self.sizeLimit = maximumSize;
+        self.indexQueue = dispatch_queue_create("com.alfresco.documentpreviewcache", DISPATCH_QUEUE_SERIAL);
+        self.entriesByFileName = [NSMutableDictionary dictionary];
+        self.fileNamesByNodeIdentifier = [NSMutableDictionary dictionary];
+        self.fileNamesByAccess = [NSMutableOrderedSet orderedSet];
+        self.pinnedFileNames = [NSCountedSet set];
+        
+        dispatch_async(self.indexQueue, ^{
+            [self loadIndex];
+            [self evictFilesKeepingFileWithName:nil];
+        });
+        
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationDidEnterBackground:) name:UIApplicationDidEnterBackgroundNotification object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark - Public Methods
+
+- (unsigned long long)maximumSize
+{
+    __block unsigned long long maximumSize = 0;
+    dispatch_sync(self.indexQueue, ^{
+        maximumSize = self.sizeLimit;
+    });
+    return maximumSize;
+}
+
+- (void)setMaximumSize:(unsigned long long)maximumSize
+{
+    dispatch_sync(self.indexQueue, ^{
+        self.sizeLimit = maximumSize;
+        [self evictFilesKeepingFileWithName:nil];
+    });
+}
+
+- (unsigned long long)totalSize
+{
+    __block unsigned long long totalSize = 0;
+    dispatch_sync(self.indexQueue, ^{
+        totalSize = self.indexedSize;
+    });
+    return totalSize;
+}
+
+- (BOOL)containsFileWithName:(NSString *)fileName
+{
+    if (!fileName)
+    {
+        return NO;
+    }
+    
+    __block BOOL containsFile = NO;
+    dispatch_sync(self.indexQueue, ^{
+        DocumentPreviewCacheEntry *entry = self.entriesByFileName[fileName];
+        if (entry)
+        {
+            containsFile = YES;
+            entry.lastAccessDate = [NSDate date];
+            [self.fileNamesByAccess removeObject:fileName];
+            [self.fileNamesByAccess addObject:fileName];
+            [self scheduleSave];
+        }
+    });
+    return containsFile;
+}
+
+- (void)addFileWithName:(NSString *)fileName nodeIdentifier:(NSString *)nodeIdentifier
+{
+    if (!fileName)
+    {
+        return;
+    }
+    
+    dispatch_sync(self.indexQueue, ^{
+        NSDictionary *attributes = [[AlfrescoFileManager sharedManager] attributesOfItemAtPath:[self.folderPath stringByAppendingPathComponent:fileName] error:nil];
+        if (!attributes)
+        {
+            AlfrescoLogError(@"Unable to add %@ to the document preview cache as it does not exist", fileName);
+            return;
+        }
+        
+        DocumentPreviewCacheEntry *entry = [DocumentPreviewCacheEntry new];
+        entry.fileName = fileName;
+        entry.nodeIdentifier = nodeIdentifier;
+        entry.size = [attributes[kAlfrescoFileSize] unsignedLongLongValue];
+        entry.lastAccessDate = [NSDate date];
+        
+        // Once a node is modified its earlier previews can't be opened again; one still on screen is left to be evicted later
+        NSString *supersededFileName = nodeIdentifier ? self.fileNamesByNodeIdentifier[nodeIdentifier] : nil;
+        if (supersededFileName && ![supersededFileName isEqualToString:fileName] && ![self.pinnedFileNames containsObject:supersededFileName])
+        {
+            [self removeEntryWithFileName:supersededFileName deletingFile:YES];
+        }
+        
+        [self removeEntryWithFileName:fileName deletingFile:NO];
+        [self indexEntry:entry];
+        [self evictFilesKeepingFileWithName:fileName];
+        [self scheduleSave];
+    });
+}
+
+- (void)pinFileWithName:(NSString *)fileName
+{
+    if (!fileName)
+    {
+        return;
+    }
+    
+    dispatch_sync(self.indexQueue, ^{
+        [self.pinnedFileNames addObject:fileName];
+    });
+}
+
+- (void)unpinFileWithName:(NSString *)fileName
+{
+    if (!fileName)
+    {
+        return;
+    }
+    
+    dispatch_sync(self.indexQueue, ^{
+        [self.pinnedFileNames removeObject:fileName];
+        if (![self.pinnedFileNames containsObject:fileName])
+        {
+            [self evictFilesKeepingFileWithName:nil];
+        }
+    });
+}
+
+- (void)removeFileWithName:(NSString *)fileName
+{
+    if (!fileName)
+    {
+        return;
+    }
+    
+    dispatch_sync(self.indexQueue, ^{
+        [self removeEntryWithFileName:fileName deletingFile:YES];
+        [self scheduleSave];
+    });
+}
+
+- (void)removeAllFiles
+{
+    dispatch_sync(self.indexQueue, ^{
+        for (NSString *fileName in self.entriesByFileName.allKeys)
+        {
+            [self removeEntryWithFileName:fileName deletingFile:YES];
+        }
+        [self scheduleSave];
+    });
+}
+
+- (NSArray<NSString *> *)fileNamesInEvictionOrder
+{
+    __block NSArray *fileNames = nil;
+    dispatch_sync(self.indexQueue, ^{
+        fileNames = self.fileNamesByAccess.array;
+    });
+    return fileNames;
+}
+
+#pragma mark - Index (index queue only)
+
+- (void)indexEntry:(DocumentPreviewCacheEntry *)entry
+{
+    self.entriesByFileName[entry.fileName] = entry;
+    if (entry.nodeIdentifier)
+    {
+        self.fileNamesByNodeIdentifier[entry.nodeIdentifier] = entry.fileName;
+    }
+    [self.fileNamesByAccess addObject:entry.fileName];
+    self.indexedSize += entry.size;
+}
+
+- (void)removeEntryWithFileName:(NSString *)fileName deletingFile:(BOOL)deleteFile
+{
+    DocumentPreviewCacheEntry *entry = self.entriesByFileName[fileName];
+    if (!entry)
+    {
+        return;
+    }
+    
+    [self.entriesByFileName removeObjectForKey:fileName];
+    if (entry.nodeIdentifier && [self.fileNamesByNodeIdentifier[entry.nodeIdentifier] isEqualToString:fileName])
+    {
+        [self.fileNamesByNodeIdentifier removeObjectForKey:entry.nodeIdentifier];
+    }
+    [self.fileNamesByAccess removeObject:fileName];
+    self.indexedSize -= entry.size;
+    
+    if (deleteFile)
+    {
+        NSString *filePath = [self.folderPath stringByAppendingPathComponent:fileName];
+        NSError *removalError = nil;
+        if (![[AlfrescoFileManager sharedManager] removeItemAtPath:filePath error:&removalError])
+        {
+            AlfrescoLogError(@"Unable to remove the cached preview at path: %@", filePath);
+        }
+    }
+}
+
+- (void)evictFilesKeepingFileWithName:(NSString *)keptFileName
+{
+    NSUInteger evictionIndex = 0;
+    while (self.indexedSize > self.sizeLimit && evictionIndex < self.fileNamesByAccess.count)
+    {
+        NSString *fileName = self.fileNamesByAccess[evictionIndex];
+        if ([fileName isEqualToString:keptFileName] || [self.pinnedFileNames containsObject:fileName])
+        {
+            evictionIndex++;
+            continue;
+        }
+        
+        AlfrescoLogDebug(@"Evicting %@ from the document preview cache", fileName);
+        [self removeEntryWithFileName:fileName deletingFile:YES];
+        [self scheduleSave];
+    }
+}
+
+- (void)loadIndex
+{
+    NSMutableDictionary *storedEntries = [NSMutableDictionary dictionary];
+    NSData *data = [[AlfrescoFileManager sharedManager] dataWithContentsOfURL:[NSURL fileURLWithPath:self.indexFilePath]];
+    if (data)
+    {
+        NSDictionary *archive = nil;
+        @try
+        {
+            NSSet *classes = [NSSet setWithObjects:[NSDictionary class], [NSArray class], [NSNumber class], [NSString class], [DocumentPreviewCacheEntry class], nil];
+            archive = [NSKeyedUnarchiver unarchivedObjectOfClasses:classes fromData:data error:nil];
+        }
+        @catch (NSException *exception)
+        {
+            AlfrescoLogError(@"Unable to read the document preview cache index: %@", exception.reason);
+        }
+        
+        if ([archive[kDocumentPreviewCacheVersionKey] integerValue] == kDocumentPreviewCacheVersion)
+        {
+            for (DocumentPreviewCacheEntry *entry in archive[kDocumentPreviewCacheEntriesKey])
+            {
+                storedEntries[entry.fileName] = entry;
+            }
+        }
+    }
+    
+    // The folder is the source of truth - it is emptied when the app's data is cleared, and previews from before the index existed are adopted
+    AlfrescoFileManager *fileManager = [AlfrescoFileManager sharedManager];
+    NSMutableArray *entries = [NSMutableArray array];
+    for (NSString *fileName in [fileManager contentsOfDirectoryAtPath:self.folderPath error:nil])
+    {
+        BOOL isDirectory = NO;
+        NSString *filePath = [self.folderPath stringByAppendingPathComponent:fileName];
+        if ([fileName hasPrefix:@"."] || ![fileManager fileExistsAtPath:filePath isDirectory:&isDirectory] || isDirectory)
+        {
+            continue;
+        }
+        
+        NSDictionary *attributes = [fileManager attributesOfItemAtPath:filePath error:nil];
+        DocumentPreviewCacheEntry *entry = storedEntries[fileName];
+        if (!entry)
+        {
+            entry = [DocumentPreviewCacheEntry new];
+            entry.fileName = fileName;
+            entry.lastAccessDate = attributes[kAlfrescoFileLastModification] ?: [NSDate distantPast];
+        }
+        entry.size = [attributes[kAlfrescoFileSize] unsignedLongLongValue];
+        [entries addObject:entry];
+    }
+    
+    [entries sortUsingDescriptors:@[[NSSortDescriptor sortDescriptorWithKey:@"lastAccessDate" ascending:YES]]];
+    for (DocumentPreviewCacheEntry *entry in entries)
+    {
+        [self indexEntry:entry];
+    }
+}
+
+- (void)scheduleSave
+{
+    // Every preview opened touches the index, so writes are coalesced
+    NSUInteger saveGeneration = ++self.saveGeneration;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kDocumentPreviewCacheSaveDelay * NSEC_PER_SEC)), self.indexQueue, ^{
+        if (saveGeneration == self.saveGeneration)
+        {
+            [self saveIndex];
+        }
+    });
+}
+
+- (void)saveIndex
+{
+    NSDictionary *archive = @{kDocumentPreviewCacheVersionKey : @(kDocumentPreviewCacheVersion),
+                              kDocumentPreviewCacheEntriesKey : self.entriesByFileName.allValues};
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:archive requiringSecureCoding:YES error:nil];
+    
+    NSError *error = nil;
+    [[AlfrescoFileManager sharedManager] createFileAtPath:self.indexFilePath contents:data error:&error];
+    if (error)
+    {
+        AlfrescoLogError(@"Unable to save the document preview cache index: %@", error.localizedDescription);
+    }
+}
+
+- (void)applicationDidEnterBackground:(NSNotification *)notification
+{
+    dispatch_async(self.indexQueue, ^{
+        if (self.saveGeneration > 0)
+        {
+            self.saveGeneration++;
+            [self saveIndex];
+        }
+    });
+}
+
+@end
@@ -17,11 +17,40 @@
  ******************************************************************************/
   
 typedef void (^DocumentPreviewManagerFileSavedBlock)(NSString *filePath);
+typedef void (^DocumentPreviewManagerDownloadCompletionBlock)(NSString *filePath, NSError *error);
+
+typedef NS_ENUM(NSUInteger, DocumentPreviewDownloadPriority)
+{
+    DocumentPreviewDownloadPriorityBackground = 0,
+    DocumentPreviewDownloadPriorityForeground
+};
+
+/**
+ * The source of document content. The SDK's document folder service conforms to this protocol.
+ */
+@protocol DocumentPreviewManagerContentService <NSObject>
+- (AlfrescoRequest *)retrieveContentOfDocument:(AlfrescoDocument *)document
+                                  outputStream:(NSOutputStream *)outputStream
+                               completionBlock:(AlfrescoBOOLCompletionBlock)completionBlock
+                                 progressBlock:(AlfrescoProgressBlock)progressBlock;
+@end
 
 @interface DocumentPreviewManager : NSObject
 
+/// The number of bytes previewed documents may take up before the least recently used are removed
+@property (nonatomic, assign) unsigned long long maximumCacheSize;
+/// The shortest time between two progress updates of a download. Defaults to a tenth of a second.
+@property (nonatomic, assign) NSTimeInterval minimumProgressInterval;
+/// The number of documents downloaded at once. Defaults to 2.
+@property (nonatomic, assign) NSUInteger maximumConcurrentDownloads;
+
 + (DocumentPreviewManager *)sharedManager;
 
+/*
+ * Creates a manager caching documents in the given folder. If no content service is given, one is created from the session of each download.
+ */
+- (instancetype)initWithFolderPath:(NSString *)folderPath contentService:(id<DocumentPreviewManagerContentService>)contentService;
+
 /*
  * This method returns true if the document passed in is currently being downloaded
  */
@@ -49,4 +78,29 @@ typedef void (^DocumentPreviewManagerFileSavedBlock)(NSString *filePath);
  */
 - (AlfrescoRequest *)downloadDocument:(AlfrescoDocument *)document session:(id<AlfrescoSession>)session;
 
+/*
+ * This method subscribes to the download of the document, starting it if it is not already in progress. Every caller asking for the same
+ * document shares one download, and is given throttled progress updates. Cancelling the returned request only unsubscribes the caller;
+ * the download itself is cancelled when its last subscriber goes away. Foreground downloads are started ahead of background ones, taking
+ * over a background download's slot if needed. The displaced download goes back to the front of the queue and starts again from the
+ * beginning once a slot is free; content fetched before it was displaced is discarded. Returns nil, having called the completion block, if the document is already cached.
+ */
+- (AlfrescoRequest *)downloadDocument:(AlfrescoDocument *)document
+                              session:(id<AlfrescoSession>)session
+                             priority:(DocumentPreviewDownloadPriority)priority
+                        progressBlock:(AlfrescoProgressBlock)progressBlock
+                      completionBlock:(DocumentPreviewManagerDownloadCompletionBlock)completionBlock;
+
+/*
+ * Keeps the cached content of the document from being evicted while it is displayed, including content still being downloaded.
+ * Each call must be balanced by a call to endDisplayingDocument: with the same document.
+ */
+- (void)beginDisplayingDocument:(AlfrescoDocument *)document;
+- (void)endDisplayingDocument:(AlfrescoDocument *)document;
+
+/*
+ * This method removes every cached document
+ */
+- (void)removeAllCachedDocuments;
+
 @end
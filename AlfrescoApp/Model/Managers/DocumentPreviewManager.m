@@ -17,14 +17,90 @@
  ******************************************************************************/
  
 #import "DocumentPreviewManager.h"
+#import "DocumentPreviewCache.h"
+#import "AlfrescoNode+Utilities.h"
+#import "StreamCopier.h"
 
 static NSString * const kTempFileFolderNamePath = @"tmp";
+static unsigned long long const kDefaultMaximumCacheSize = 200 * 1024 * 1024;
+static NSTimeInterval const kDefaultMinimumProgressInterval = 0.1;
+static NSUInteger const kDefaultMaximumConcurrentDownloads = 2;
+
+@interface AlfrescoDocumentFolderService (DocumentPreviewManager) <DocumentPreviewManagerContentService>
+@end
+
+@implementation AlfrescoDocumentFolderService (DocumentPreviewManager)
+@end
+
+/**
+ * One caller's interest in a download. Cancelling it unsubscribes the caller.
+ */
+@interface DocumentPreviewDownloadRequest : AlfrescoRequest
+@property (nonatomic, assign) DocumentPreviewDownloadPriority priority;
+@property (nonatomic, copy) AlfrescoProgressBlock progressBlock;
+@property (nonatomic, copy) DocumentPreviewManagerDownloadCompletionBlock completionBlock;
+@property (nonatomic, copy) void (^cancellationHandler)(DocumentPreviewDownloadRequest *request);
+@end
+
+@implementation DocumentPreviewDownloadRequest
+
+- (void)cancel
+{
+    [super cancel];
+    
+    void (^cancellationHandler)(DocumentPreviewDownloadRequest *) = self.cancellationHandler;
+    self.cancellationHandler = nil;
+    if (cancellationHandler)
+    {
+        cancellationHandler(self);
+    }
+}
+
+@end
+
+/**
+ * The download of one document, shared by everyone who subscribed to it.
+ */
+@interface DocumentPreviewDownload : NSObject
+@property (nonatomic, strong) AlfrescoDocument *document;
+@property (nonatomic, strong) NSString *documentIdentifier;
+@property (nonatomic, strong) id<AlfrescoSession> session;
+@property (nonatomic, strong) NSMutableArray<DocumentPreviewDownloadRequest *> *subscribers;
+@property (nonatomic, strong) AlfrescoRequest *request;
+// Receives the content in the temporary folder until the transfer succeeds
+@property (nonatomic, strong) StreamCopyFileDestination *destination;
+// Incremented whenever the transfer is stopped, so callbacks from a stopped transfer are ignored
+@property (nonatomic, assign) NSUInteger transferGeneration;
+@property (nonatomic, assign) unsigned long long bytesTransferred;
+@property (nonatomic, assign) unsigned long long bytesTotal;
+@property (nonatomic, assign) CFAbsoluteTime lastProgressDeliveryTime;
+@property (nonatomic, assign) BOOL hasUndeliveredProgress;
+@property (nonatomic, assign) BOOL progressDeliveryScheduled;
+@end
+
+@implementation DocumentPreviewDownload
+
+- (DocumentPreviewDownloadPriority)priority
+{
+    DocumentPreviewDownloadPriority priority = DocumentPreviewDownloadPriorityBackground;
+    for (DocumentPreviewDownloadRequest *subscriber in self.subscribers)
+    {
+        priority = MAX(priority, subscriber.priority);
+    }
+    return priority;
+}
+
+@end
 
 @interface DocumentPreviewManager ()
 
 @property (nonatomic, strong) NSString *tmpDownloadFolderPath;
 @property (nonatomic, strong) NSString *downloadFolderPath;
-@property (nonatomic, strong) NSMutableArray *downloadDocumentIdentifiers;
+@property (nonatomic, strong) id<DocumentPreviewManagerContentService> contentService;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, DocumentPreviewDownload *> *downloadsByIdentifier;
+@property (nonatomic, strong) NSMutableArray<DocumentPreviewDownload *> *pendingDownloads;
+@property (nonatomic, strong) NSMutableArray<DocumentPreviewDownload *> *activeDownloads;
+@property (nonatomic, strong) DocumentPreviewCache *previewCache;
 
 @end
 
@@ -41,28 +117,48 @@ static NSString * const kTempFileFolderNamePath = @"tmp";
 }
 
 - (instancetype)init
+{
+    return [self initWithFolderPath:[[AlfrescoFileManager sharedManager] documentPreviewDocumentFolderPath] contentService:nil];
+}
+
+- (instancetype)initWithFolderPath:(NSString *)folderPath contentService:(id<DocumentPreviewManagerContentService>)contentService
 {
     self = [super init];
     if (self)
     {
-        [self setupTempDownloadFolder];
-        [self setupDownloadFolder];
-        self.downloadDocumentIdentifiers = [NSMutableArray array];
+        self.downloadFolderPath = folderPath;
+        self.tmpDownloadFolderPath = [folderPath stringByAppendingPathComponent:kTempFileFolderNamePath];
+        [self setupDownloadFolders];
+        self.contentService = contentService;
+        self.minimumProgressInterval = kDefaultMinimumProgressInterval;
+        self.maximumConcurrentDownloads = kDefaultMaximumConcurrentDownloads;
+        self.downloadsByIdentifier = [NSMutableDictionary dictionary];
+        self.pendingDownloads = [NSMutableArray array];
+        self.activeDownloads = [NSMutableArray array];
+        self.previewCache = [[DocumentPreviewCache alloc] initWithFolderPath:folderPath maximumSize:kDefaultMaximumCacheSize];
     }
     return self;
 }
 
+- (unsigned long long)maximumCacheSize
+{
+    return self.previewCache.maximumSize;
+}
+
+- (void)setMaximumCacheSize:(unsigned long long)maximumCacheSize
+{
+    self.previewCache.maximumSize = maximumCacheSize;
+}
+
 - (BOOL)isCurrentlyDownloadingDocument:(AlfrescoDocument *)document
 {
     NSString *documentIdentifier = [self documentIdentifierForDocument:document];
-    return [self.downloadDocumentIdentifiers containsObject:documentIdentifier];
+    return self.downloadsByIdentifier[documentIdentifier] != nil;
 }
 
 - (BOOL)hasLocalContentOfDocument:(AlfrescoDocument *)document
 {
-    NSString *fileLocation = [self filePathForDocument:document];
-    BOOL hasContentLocally = [[AlfrescoFileManager sharedManager] fileExistsAtPath:fileLocation];
-    return hasContentLocally;
+    return [self.previewCache containsFileWithName:[self documentIdentifierForDocument:document]];
 }
 
 - (NSString *)filePathForDocument:(AlfrescoDocument *)document
@@ -77,7 +173,21 @@ static NSString * const kTempFileFolderNamePath = @"tmp";
 
 - (AlfrescoRequest *)downloadDocument:(AlfrescoDocument *)document session:(id<AlfrescoSession>)session
 {
-    AlfrescoRequest *request = nil;
+    return [self downloadDocument:document session:session priority:DocumentPreviewDownloadPriorityForeground progressBlock:nil completionBlock:nil];
+}
+
+- (AlfrescoRequest *)downloadDocument:(AlfrescoDocument *)document
+                              session:(id<AlfrescoSession>)session
+                             priority:(DocumentPreviewDownloadPriority)priority
+                        progressBlock:(AlfrescoProgressBlock)progressBlock
+                      completionBlock:(DocumentPreviewManagerDownloadCompletionBlock)completionBlock
+{
+    if (!document)
+    {
+        AlfrescoLogError(@"Download operation attempted with nil AlfrescoDocument object");
+        return nil;
+    }
+    
     NSString *documentIdentifier = [self documentIdentifierForDocument:document];
     
     if ([self hasLocalContentOfDocument:document])
@@ -87,40 +197,68 @@ static NSString * const kTempFileFolderNamePath = @"tmp";
         [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerDocumentDownloadCompletedNotification
                                                             object:document
                                                           userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : documentIdentifier}];
-    }
-    else
-    {
-        if (![self.downloadDocumentIdentifiers containsObject:documentIdentifier])
+        if (completionBlock)
         {
-            [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerWillStartDownloadNotification
-                                                                object:document
-                                                              userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : documentIdentifier}];
-            
-            NSString *downloadLocation = [self.downloadFolderPath stringByAppendingPathComponent:filenameAppendedWithDateModified(document.name, document)];
-            
-            request = [self downloadDocument:document toPath:downloadLocation session:session completionBlock:^(NSString *filePath) {
-                [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerDocumentDownloadCompletedNotification
-                                                                    object:document
-                                                                  userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : documentIdentifier}];
-            } progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
-                [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerProgressNotification
-                                                                    object:document
-                                                                  userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : documentIdentifier,
-                                                                             kDocumentPreviewManagerProgressBytesRecievedNotificationKey : @(bytesTransferred),
-                                                                             kDocumentPreviewManagerProgressBytesTotalNotificationKey : @(bytesTotal)}];
-            }];
+            completionBlock([self filePathForDocument:document], nil);
         }
+        return nil;
     }
     
-    return request;
+    DocumentPreviewDownload *download = self.downloadsByIdentifier[documentIdentifier];
+    if (!download)
+    {
+        download = [DocumentPreviewDownload new];
+        download.document = document;
+        download.documentIdentifier = documentIdentifier;
+        download.session = session;
+        download.subscribers = [NSMutableArray array];
+        self.downloadsByIdentifier[documentIdentifier] = download;
+        [self.pendingDownloads addObject:download];
+        
+        [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerWillStartDownloadNotification
+                                                            object:document
+                                                          userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : documentIdentifier}];
+    }
+    
+    DocumentPreviewDownloadRequest *subscriber = [DocumentPreviewDownloadRequest new];
+    subscriber.priority = priority;
+    subscriber.progressBlock = progressBlock;
+    subscriber.completionBlock = completionBlock;
+    
+    __weak typeof(self) weakSelf = self;
+    __weak DocumentPreviewDownload *weakDownload = download;
+    subscriber.cancellationHandler = ^(DocumentPreviewDownloadRequest *request) {
+        [weakSelf unsubscribe:request fromDownload:weakDownload];
+    };
+    [download.subscribers addObject:subscriber];
+    
+    [self startPendingDownloads];
+    
+    return subscriber;
+}
+
+- (void)beginDisplayingDocument:(AlfrescoDocument *)document
+{
+    [self.previewCache pinFileWithName:[self documentIdentifierForDocument:document]];
+}
+
+- (void)endDisplayingDocument:(AlfrescoDocument *)document
+{
+    [self.previewCache unpinFileWithName:[self documentIdentifierForDocument:document]];
+}
+
+- (void)removeAllCachedDocuments
+{
+    [self.previewCache removeAllFiles];
 }
 
 #pragma mark - Private Functions
 
-- (void)setupTempDownloadFolder
+- (void)setupDownloadFolders
 {
+    // MOBILE-3310 & MOBILE-3311
+    // If the temporary path has been deleted (clearing all data in the app), we need to recreate the destination folders.
     AlfrescoFileManager *fileManager = [AlfrescoFileManager sharedManager];
-    self.tmpDownloadFolderPath = [[fileManager documentPreviewDocumentFolderPath] stringByAppendingPathComponent:kTempFileFolderNamePath];
     if (![fileManager fileExistsAtPath:self.tmpDownloadFolderPath])
     {
         NSError *creationError = nil;
@@ -133,81 +271,216 @@ static NSString * const kTempFileFolderNamePath = @"tmp";
     }
 }
 
-- (void)setupDownloadFolder
+- (DocumentPreviewDownload *)nextPendingDownload
 {
-    self.downloadFolderPath = [[AlfrescoFileManager sharedManager] documentPreviewDocumentFolderPath];
+    for (DocumentPreviewDownload *download in self.pendingDownloads)
+    {
+        if (download.priority == DocumentPreviewDownloadPriorityForeground)
+        {
+            return download;
+        }
+    }
+    return self.pendingDownloads.firstObject;
 }
 
-- (AlfrescoRequest *)downloadDocument:(AlfrescoDocument *)document toPath:(NSString *)downloadPath session:(id<AlfrescoSession>)session completionBlock:(DocumentPreviewManagerFileSavedBlock)completionBlock progressBlock:(AlfrescoProgressBlock)progressBlock
+- (void)startPendingDownloads
 {
-    if (!document)
+    DocumentPreviewDownload *download = nil;
+    while ((download = [self nextPendingDownload]))
     {
-        AlfrescoLogError(@"Download operation attempted with nil AlfrescoDocument object");
-        return nil;
+        if (self.activeDownloads.count >= self.maximumConcurrentDownloads)
+        {
+            // The document being looked at shouldn't wait behind ones fetched ahead of time
+            DocumentPreviewDownload *backgroundDownload = nil;
+            if (download.priority == DocumentPreviewDownloadPriorityForeground)
+            {
+                NSUInteger backgroundIndex = [self.activeDownloads indexOfObjectPassingTest:^BOOL(DocumentPreviewDownload *activeDownload, NSUInteger index, BOOL *stop) {
+                    return activeDownload.priority == DocumentPreviewDownloadPriorityBackground;
+                }];
+                backgroundDownload = (backgroundIndex != NSNotFound) ? self.activeDownloads[backgroundIndex] : nil;
+            }
+            
+            if (!backgroundDownload)
+            {
+                break;
+            }
+            [self suspendDownload:backgroundDownload];
+        }
+        
+        [self startDownload:download];
     }
+}
+
+- (void)startDownload:(DocumentPreviewDownload *)download
+{
+    [self.pendingDownloads removeObject:download];
+    [self.activeDownloads addObject:download];
+    [self setupDownloadFolders];
     
-    // MOBILE-3310 & MOBILE-3311
-    // If the temporary path has been deleted (clearing all data in the app), we need to recreate the destination folders.
-    [self setupDownloadFolder];
-    [self setupTempDownloadFolder];
-    
-    NSString *temporaryDownloadLocation = [self.tmpDownloadFolderPath stringByAppendingPathComponent:filenameAppendedWithDateModified(document.name, document)];
+    NSUInteger transferGeneration = ++download.transferGeneration;
+    NSString *temporaryDownloadLocation = [self.tmpDownloadFolderPath stringByAppendingPathComponent:download.documentIdentifier];
+    NSString *downloadPath = [self.downloadFolderPath stringByAppendingPathComponent:download.documentIdentifier];
+    download.destination = [[StreamCopyFileDestination alloc] initWithFilePath:downloadPath partialFilePath:temporaryDownloadLocation];
+    id<DocumentPreviewManagerContentService> contentService = self.contentService ?: [[AlfrescoDocumentFolderService alloc] initWithSession:download.session];
     
-    AlfrescoRequest *request = nil;
-    if (completionBlock != NULL)
-    {
-        if ([[AlfrescoFileManager sharedManager] fileExistsAtPath:downloadPath])
+    __weak typeof(self) weakSelf = self;
+    download.request = [contentService retrieveContentOfDocument:download.document outputStream:download.destination.outputStream completionBlock:^(BOOL succeeded, NSError *error) {
+        if (transferGeneration == download.transferGeneration)
         {
-            progressBlock(1, 1);
-            completionBlock(downloadPath);
+            [weakSelf finishDownload:download succeeded:succeeded error:error];
         }
-        else
+    } progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+        if (transferGeneration == download.transferGeneration)
         {
-            NSString *documentIdentifier = downloadPath.lastPathComponent;
-            
-            if (![self.downloadDocumentIdentifiers containsObject:documentIdentifier])
+            [weakSelf download:download didTransferBytes:bytesTransferred bytesTotal:bytesTotal];
+        }
+    }];
+}
+
+- (void)stopTransferOfDownload:(DocumentPreviewDownload *)download
+{
+    download.transferGeneration++;
+    [download.request cancel];
+    download.request = nil;
+    download.hasUndeliveredProgress = NO;
+    [self.activeDownloads removeObject:download];
+}
+
+- (void)suspendDownload:(DocumentPreviewDownload *)download
+{
+    AlfrescoLogDebug(@"Suspending download of %@ for a foreground download", download.documentIdentifier);
+    // The content service can't fetch a byte range, so the transfer is restarted from the beginning when a slot frees up
+    [self stopTransferOfDownload:download];
+    [self.pendingDownloads insertObject:download atIndex:0];
+}
+
+- (void)unsubscribe:(DocumentPreviewDownloadRequest *)subscriber fromDownload:(DocumentPreviewDownload *)download
+{
+    if (!download)
+    {
+        return;
+    }
+    
+    [download.subscribers removeObject:subscriber];
+    if (download.subscribers.count > 0)
+    {
+        return;
+    }
+    
+    [self stopTransferOfDownload:download];
+    [self.pendingDownloads removeObject:download];
+    [self.downloadsByIdentifier removeObjectForKey:download.documentIdentifier];
+    [[AlfrescoFileManager sharedManager] removeItemAtPath:[self.tmpDownloadFolderPath stringByAppendingPathComponent:download.documentIdentifier] error:nil];
+    
+    [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerDocumentDownloadCancelledNotification
+                                                        object:download.document
+                                                      userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : download.documentIdentifier}];
+    
+    [self startPendingDownloads];
+}
+
+- (void)download:(DocumentPreviewDownload *)download didTransferBytes:(unsigned long long)bytesTransferred bytesTotal:(unsigned long long)bytesTotal
+{
+    download.bytesTransferred = bytesTransferred;
+    download.bytesTotal = bytesTotal;
+    download.hasUndeliveredProgress = YES;
+    
+    // Content arrives in small chunks, far more often than a progress bar can usefully be redrawn
+    NSTimeInterval timeSinceLastDelivery = CFAbsoluteTimeGetCurrent() - download.lastProgressDeliveryTime;
+    if (timeSinceLastDelivery >= self.minimumProgressInterval)
+    {
+        [self deliverProgressOfDownload:download];
+    }
+    else if (!download.progressDeliveryScheduled)
+    {
+        download.progressDeliveryScheduled = YES;
+        NSUInteger transferGeneration = download.transferGeneration;
+        
+        __weak typeof(self) weakSelf = self;
+        NSTimeInterval delay = self.minimumProgressInterval - timeSinceLastDelivery;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            download.progressDeliveryScheduled = NO;
+            if (transferGeneration == download.transferGeneration && download.hasUndeliveredProgress)
             {
-                [self.downloadDocumentIdentifiers addObject:documentIdentifier];
-                NSOutputStream *outputStream = [[AlfrescoFileManager sharedManager] outputStreamToFileAtPath:temporaryDownloadLocation append:NO];
-                AlfrescoDocumentFolderService *documentService = [[AlfrescoDocumentFolderService alloc] initWithSession:session];
-                
-                __weak typeof(self) weakSelf = self;
-                request = [documentService retrieveContentOfDocument:document outputStream:outputStream completionBlock:^(BOOL succeeded, NSError *error) {
-                    [weakSelf.downloadDocumentIdentifiers removeObject:documentIdentifier];
-                    if (succeeded)
-                    {
-                        // move out of temp location
-                        AlfrescoFileManager *fileManager = [AlfrescoFileManager sharedManager];
-                        
-                        NSError *movingError = nil;
-                        [fileManager moveItemAtPath:temporaryDownloadLocation toPath:downloadPath error:&movingError];
-                        
-                        if (movingError)
-                        {
-                            AlfrescoLogError(@"Unable to move from path %@ to %@", temporaryDownloadLocation, downloadPath);
-                        }
-                        
-                        completionBlock(downloadPath);
-                    }
-                    else
-                    {
-                        [[AlfrescoFileManager sharedManager] removeItemAtPath:downloadPath error:nil];
-                        [Notifier notifyWithAlfrescoError:error];
-                        
-                        if (error.code == kAlfrescoErrorCodeNetworkRequestCancelled)
-                        {
-                            [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerDocumentDownloadCancelledNotification
-                                                                                object:document
-                                                                              userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : documentIdentifier}];
-                        }
-                    }
-                } progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
-                    progressBlock(bytesTransferred, bytesTotal);
-                }];
+                [weakSelf deliverProgressOfDownload:download];
             }
+        });
+    }
+}
+
+- (void)deliverProgressOfDownload:(DocumentPreviewDownload *)download
+{
+    download.lastProgressDeliveryTime = CFAbsoluteTimeGetCurrent();
+    download.hasUndeliveredProgress = NO;
+    
+    for (DocumentPreviewDownloadRequest *subscriber in download.subscribers.copy)
+    {
+        if (subscriber.progressBlock)
+        {
+            subscriber.progressBlock(download.bytesTransferred, download.bytesTotal);
         }
     }
-    return request;
+    
+    [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerProgressNotification
+                                                        object:download.document
+                                                      userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : download.documentIdentifier,
+                                                                 kDocumentPreviewManagerProgressBytesRecievedNotificationKey : @(download.bytesTransferred),
+                                                                 kDocumentPreviewManagerProgressBytesTotalNotificationKey : @(download.bytesTotal)}];
+}
+
+- (void)finishDownload:(DocumentPreviewDownload *)download succeeded:(BOOL)succeeded error:(NSError *)error
+{
+    if (download.hasUndeliveredProgress)
+    {
+        [self deliverProgressOfDownload:download];
+    }
+    
+    download.transferGeneration++;
+    download.request = nil;
+    [self.activeDownloads removeObject:download];
+    [self.downloadsByIdentifier removeObjectForKey:download.documentIdentifier];
+    
+    NSString *documentIdentifier = download.documentIdentifier;
+    NSString *downloadPath = download.destination.filePath;
+    
+    // Moves the content out of the temporary folder, or deletes what was received of it
+    BOOL movedIntoPlace = [download.destination finishWithSuccess:succeeded error:nil];
+    download.destination = nil;
+    
+    if (succeeded)
+    {
+        if (movedIntoPlace)
+        {
+            [self.previewCache addFileWithName:documentIdentifier nodeIdentifier:[download.document nodeRefWithoutVersionID]];
+        }
+        
+        [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerDocumentDownloadCompletedNotification
+                                                            object:download.document
+                                                          userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : documentIdentifier}];
+    }
+    else
+    {
+        [Notifier notifyWithAlfrescoError:error];
+        
+        if (error.code == kAlfrescoErrorCodeNetworkRequestCancelled)
+        {
+            [[NSNotificationCenter defaultCenter] postNotificationName:kDocumentPreviewManagerDocumentDownloadCancelledNotification
+                                                                object:download.document
+                                                              userInfo:@{kDocumentPreviewManagerDocumentIdentifierNotificationKey : documentIdentifier}];
+        }
+    }
+    
+    for (DocumentPreviewDownloadRequest *subscriber in download.subscribers.copy)
+    {
+        subscriber.cancellationHandler = nil;
+        if (subscriber.completionBlock)
+        {
+            subscriber.completionBlock(succeeded ? downloadPath : nil, error);
+        }
+    }
+    [download.subscribers removeAllObjects];
+    
+    [self startPendingDownloads];
 }
 
 @end
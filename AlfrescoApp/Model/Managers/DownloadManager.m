@@ -18,8 +18,8 @@
  
 #import "DownloadManager.h"
 #import "UniversalDevice.h"
-
-static NSUInteger const kStreamCopyBufferSize = 16 * 1024;
+#import "StreamCopier.h"
+#import "LocalSearchIndex.h"
 
 @interface DownloadManager ()
 @property (nonatomic, strong) id<AlfrescoSession> alfrescoSession;
@@ -204,45 +204,42 @@ static NSUInteger const kStreamCopyBufferSize = 16 * 1024;
         if (![self isDownloadedDocument:absolutePath.lastPathComponent])
         {
             // No existing file of the same name, so we're ok to use the original
-            NSString *filePath;
-            NSError *error = nil;
-            
-            filePath = [self moveFileToDownloadsFolderFromAbsolutePath:absolutePath overwriteExisting:YES error:&error];
-            if (filePath != nil)
-            {
-                // Always display the filename
-                displayInformationMessage([NSString stringWithFormat:NSLocalizedString(@"download.success-as.message", @"Download succeeded"), filePath.lastPathComponent]);
-            }
-            else
-            {
-                displayErrorMessage([NSString stringWithFormat:NSLocalizedString(@"error.filefolder.content.failedtodownload", @"Failed to download the file"), error.localizedDescription]);
-            }
-            
-            if (completionBlock != NULL)
-            {
-                completionBlock(filePath);
-            }
-        }
-        else
-        {
-            void (^moveDocumentBlock)(BOOL) = ^(BOOL overwrite){
-                NSError *blockError = nil;
-                NSString *blockFilePath = [self moveFileToDownloadsFolderFromAbsolutePath:absolutePath overwriteExisting:overwrite error:&blockError];
-                
-                if (blockFilePath != nil)
+            [self moveFileToDownloadsFolderFromAbsolutePath:absolutePath overwriteExisting:YES completionBlock:^(NSString *filePath, NSError *error) {
+                if (filePath != nil)
                 {
                     // Always display the filename
-                    displayInformationMessage([NSString stringWithFormat:NSLocalizedString(@"download.success-as.message", @"Download succeeded"), blockFilePath.lastPathComponent]);
+                    displayInformationMessage([NSString stringWithFormat:NSLocalizedString(@"download.success-as.message", @"Download succeeded"), filePath.lastPathComponent]);
                 }
                 else
                 {
-                    displayErrorMessage([NSString stringWithFormat:NSLocalizedString(@"error.filefolder.content.failedtodownload", @"Failed to download the file"), blockError.localizedDescription]);
+                    displayErrorMessage([NSString stringWithFormat:NSLocalizedString(@"error.filefolder.content.failedtodownload", @"Failed to download the file"), error.localizedDescription]);
                 }
                 
                 if (completionBlock != NULL)
                 {
-                    completionBlock(blockFilePath);
+                    completionBlock(filePath);
                 }
+            }];
+        }
+        else
+        {
+            void (^moveDocumentBlock)(BOOL) = ^(BOOL overwrite){
+                [self moveFileToDownloadsFolderFromAbsolutePath:absolutePath overwriteExisting:overwrite completionBlock:^(NSString *blockFilePath, NSError *blockError) {
+                    if (blockFilePath != nil)
+                    {
+                        // Always display the filename
+                        displayInformationMessage([NSString stringWithFormat:NSLocalizedString(@"download.success-as.message", @"Download succeeded"), blockFilePath.lastPathComponent]);
+                    }
+                    else
+                    {
+                        displayErrorMessage([NSString stringWithFormat:NSLocalizedString(@"error.filefolder.content.failedtodownload", @"Failed to download the file"), blockError.localizedDescription]);
+                    }
+                    
+                    if (completionBlock != NULL)
+                    {
+                        completionBlock(blockFilePath);
+                    }
+                }];
             };
             
             UIAlertController *alertController = [UIAlertController alertControllerWithTitle:nil
@@ -298,6 +295,9 @@ static NSUInteger const kStreamCopyBufferSize = 16 * 1024;
         NSString *localDocumentExistingNodePath = [[self.fileManager downloadsInfoContentPath] stringByAppendingPathComponent:documentLocalName];
         NSString *localDocumentNewNodePath = [[self.fileManager downloadsInfoContentPath] stringByAppendingPathComponent:newName];
         [self.fileManager moveItemAtPath:localDocumentExistingNodePath toPath:localDocumentNewNodePath error:&error];
+        
+        [[LocalSearchIndex sharedIndex] removeEntryWithIdentifier:documentLocalName scope:kLocalSearchIndexDownloadsScope];
+        [self indexDownloadedDocument:[self infoForDocument:newName] documentName:newName];
     }
 }
 
@@ -349,6 +349,7 @@ static NSUInteger const kStreamCopyBufferSize = 16 * 1024;
     }
     else
     {
+        [[LocalSearchIndex sharedIndex] removeAllEntriesInScope:kLocalSearchIndexDownloadsScope];
         [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoDeletedLocalDocumentsFolderNotification object:nil];
         [self informLocalFilesEnumerator];
     }
@@ -380,6 +381,7 @@ static NSUInteger const kStreamCopyBufferSize = 16 * 1024;
     NSError *error = nil;
     
     [self.fileManager removeItemAtPath:downloadInfoPath error:&error];
+    [[LocalSearchIndex sharedIndex] removeEntryWithIdentifier:documentName.lastPathComponent scope:kLocalSearchIndexDownloadsScope];
     
     return error == nil;
 }
@@ -436,10 +438,17 @@ static NSUInteger const kStreamCopyBufferSize = 16 * 1024;
         downloadDestinationPath = [[downloadDestinationPath stringByDeletingLastPathComponent] stringByAppendingPathComponent:safeFilename];
     }
     
-    NSOutputStream *outputStream = [[AlfrescoFileManager sharedManager] outputStreamToFileAtPath:downloadDestinationPath append:NO];
+    StreamCopyFileDestination *destination = [[StreamCopyFileDestination alloc] initWithFilePath:downloadDestinationPath];
     AlfrescoDocumentFolderService *documentService = [[AlfrescoDocumentFolderService alloc] initWithSession:self.alfrescoSession];
     
-    return [documentService retrieveContentOfDocument:document outputStream:outputStream completionBlock:^(BOOL succeeded, NSError *error) {
+    return [documentService retrieveContentOfDocument:document outputStream:destination.outputStream completionBlock:^(BOOL succeeded, NSError *error) {
+        NSError *moveError = nil;
+        if (![destination finishWithSuccess:succeeded error:&moveError] && succeeded)
+        {
+            succeeded = NO;
+            error = moveError;
+        }
+        
         if (succeeded)
         {
             // Note: we're assuming that there will be no problem saving the metadata if the content saves successfully
@@ -478,58 +487,38 @@ static NSUInteger const kStreamCopyBufferSize = 16 * 1024;
     return [self.fileManager copyItemAtPath:filePath toPath:downloadPath error:error];
 }
 
-- (NSString *)moveFileToDownloadsFolderFromAbsolutePath:(NSString *)absolutePath overwriteExisting:(BOOL)overwrite error:(NSError **)error
+- (void)moveFileToDownloadsFolderFromAbsolutePath:(NSString *)absolutePath overwriteExisting:(BOOL)overwrite completionBlock:(void (^)(NSString *filePath, NSError *error))completionBlock
 {
-    BOOL moveSucceeded = NO;
-    NSString *destinationFilename = (overwrite ? absolutePath.lastPathComponent : [self safeFilenameBySuffixing:absolutePath.lastPathComponent error:error]);
-    NSString *destinationFilePath = nil;
-    if (destinationFilename != nil)
+    NSError *error = nil;
+    NSString *destinationFilename = (overwrite ? absolutePath.lastPathComponent : [self safeFilenameBySuffixing:absolutePath.lastPathComponent error:&error]);
+    if (destinationFilename == nil)
     {
-        NSString *downloadPath = [[self.fileManager downloadsContentFolderPath] stringByAppendingPathComponent:destinationFilename];
-        NSOutputStream *outputStream = [[AlfrescoFileManager sharedManager] outputStreamToFileAtPath:downloadPath append:NO];
-        
-        if (outputStream)
-        {
-            [outputStream open];
-            if ([outputStream hasSpaceAvailable])
-            {
-                NSInputStream *inputStream = [NSInputStream inputStreamWithFileAtPath:absolutePath];
-                if (inputStream)
-                {
-                    // Assume success unless an error occurs during copying...
-                    moveSucceeded = YES;
-                    [inputStream open];
-                    
-                    while ([inputStream hasBytesAvailable])
-                    {
-                        uint8_t buffer[kStreamCopyBufferSize];
-                        [inputStream read:buffer maxLength:kStreamCopyBufferSize];
-                        if ([outputStream write:(const uint8_t*)(&buffer) maxLength:kStreamCopyBufferSize] == -1)
-                        {
-                            moveSucceeded = NO;
-                            break;
-                        }
-                    }
-                    [inputStream close];
-                }
-            }
-            [outputStream close];
-        }
-      
-        if (moveSucceeded)
+        completionBlock(nil, error);
+        return;
+    }
+    
+    NSString *downloadPath = [[self.fileManager downloadsContentFolderPath] stringByAppendingPathComponent:destinationFilename];
+    [[StreamCopier sharedCopier] copyFileAtPath:absolutePath toPath:downloadPath progressBlock:nil completionBlock:^(BOOL succeeded, unsigned long long bytesCopied, NSError *copyError) {
+        if (succeeded)
         {
             // Note: if overwriting then make sure any existing saved documentInfo is removed
             if (overwrite)
             {
                 [self saveDocumentInfo:nil forDocument:destinationFilename error:nil];
             }
-            destinationFilePath = [[self.fileManager downloadsContentFolderPath] stringByAppendingPathComponent:destinationFilename];
-            [Notifier postDocumentDownloadedNotificationWithUserInfo:@{kAlfrescoDocumentDownloadedIdentifierKey : destinationFilePath}];
+            else
+            {
+                [self indexDownloadedDocument:nil documentName:destinationFilename];
+            }
+            [Notifier postDocumentDownloadedNotificationWithUserInfo:@{kAlfrescoDocumentDownloadedIdentifierKey : downloadPath}];
             [self informLocalFilesEnumerator];
+            completionBlock(downloadPath, nil);
         }
-    }
-    
-    return destinationFilePath;
+        else
+        {
+            completionBlock(nil, copyError);
+        }
+    }];
 }
 
 - (BOOL)saveDocumentInfo:(AlfrescoDocument *)document forDocument:(NSString *)documentName error:(NSError **)error
@@ -546,10 +535,20 @@ static NSUInteger const kStreamCopyBufferSize = 16 * 1024;
         // Remove any old info file for the documentName - we don't want to return stale info
         [self.fileManager removeItemAtPath:downloadInfoPath error:error];
     }
+    [self indexDownloadedDocument:document documentName:documentName];
     
     return (error == NULL || *error == nil);
 }
 
+- (void)indexDownloadedDocument:(AlfrescoDocument *)document documentName:(NSString *)documentName
+{
+    NSString *fileName = documentName.lastPathComponent;
+    LocalSearchIndexEntry *entry = [LocalSearchIndexEntry entryWithNode:document identifier:fileName scope:kLocalSearchIndexDownloadsScope source:LocalSearchIndexSourceDownloaded path:nil];
+    entry.name = entry.name ?: fileName;
+    NSString *contentPath = [[self.fileManager downloadsContentFolderPath] stringByAppendingPathComponent:fileName];
+    [[LocalSearchIndex sharedIndex] indexEntry:entry contentPath:contentPath];
+}
+
 // Returns just the filenames of downloaded documents
 - (NSArray *)downloadedDocumentNames
 {
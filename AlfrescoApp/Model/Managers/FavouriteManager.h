@@ -15,13 +15,55 @@
  *  See the License for the specific language governing permissions and
  *  limitations under the License.
  ******************************************************************************/
-  
+
+@class FavouritesIndex;
+
+/**
+ * The favourite calls of the SDK's document folder service, which conforms to this protocol.
+ */
+@protocol FavouriteManagerService <NSObject>
+- (AlfrescoRequest *)addFavorite:(AlfrescoNode *)node completionBlock:(AlfrescoFavoritedCompletionBlock)completionBlock;
+- (AlfrescoRequest *)removeFavorite:(AlfrescoNode *)node completionBlock:(AlfrescoFavoritedCompletionBlock)completionBlock;
+- (AlfrescoRequest *)isFavorite:(AlfrescoNode *)node completionBlock:(AlfrescoFavoritedCompletionBlock)completionBlock;
+- (AlfrescoRequest *)retrieveFavoriteNodesWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock;
+- (AlfrescoRequest *)retrieveFavoriteDocumentsWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock;
+- (AlfrescoRequest *)retrieveFavoriteFoldersWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock;
+- (void)clear;
+@end
+
 @interface FavouriteManager : NSObject
 
+/// The favourites of the selected account, once loaded
+@property (nonatomic, strong, readonly) FavouritesIndex *favouritesIndex;
+
 + (FavouriteManager *)sharedManager;
+
+/*
+ * Creates a manager using the given service and index. If they are nil, they are created for each session and selected account.
+ */
+- (instancetype)initWithService:(id<FavouriteManagerService>)service favouritesIndex:(FavouritesIndex *)favouritesIndex;
+
+/*
+ * Adding and removing favourites are applied to the index straight away and notified once the request succeeds. If it fails they are rolled back.
+ */
 - (AlfrescoRequest *)addFavorite:(AlfrescoNode *)node session:(id<AlfrescoSession>)session completionBlock:(void (^)(BOOL succeeded, NSError *error))completionBlock;
 - (AlfrescoRequest *)removeFavorite:(AlfrescoNode *)node session:(id<AlfrescoSession>)session completionBlock:(void (^)(BOOL succeeded, NSError *error))completionBlock;
+
+/*
+ * Answered from the index, synchronously and without a request, once all favourites have been retrieved.
+ */
 - (AlfrescoRequest *)isNodeFavorite:(AlfrescoNode *)node session:(id<AlfrescoSession>)session completionBlock:(void (^)(BOOL isFavorite, NSError *error))completionBlock;
+
+/*
+ * Returns YES if the favourite status of the node is known locally, setting isFavorite.
+ */
+- (BOOL)cachedFavoriteStatusOfNode:(AlfrescoNode *)node isFavorite:(BOOL *)isFavorite;
+
+/*
+ * Retrieves every favourite, replacing the contents of the index.
+ */
+- (void)refreshFavoritesWithSession:(id<AlfrescoSession>)session completionBlock:(void (^)(BOOL succeeded, NSError *error))completionBlock;
+
 - (void)topLevelFavoriteNodesWithSession:(id<AlfrescoSession>)session filter:(NSString *)filter listingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock;
 
 @end
@@ -17,11 +17,30 @@
  ******************************************************************************/
  
 #import "FavouriteManager.h"
+#import "FavouritesIndex.h"
+#import "AccountManager.h"
+#import "AlfrescoNode+Utilities.h"
+
+static int const kFavouritesRefreshPageSize = 100;
+
+@interface AlfrescoDocumentFolderService (FavouriteManager) <FavouriteManagerService>
+@end
+
+@implementation AlfrescoDocumentFolderService (FavouriteManager)
+@end
 
 @interface FavouriteManager ()
 
 @property (nonatomic, strong, readwrite) id<AlfrescoSession> session;
-@property (nonatomic, strong, readwrite) AlfrescoDocumentFolderService *documentFolderService;
+@property (nonatomic, strong, readwrite) id<FavouriteManagerService> documentFolderService;
+@property (nonatomic, strong, readwrite) FavouritesIndex *favouritesIndex;
+@property (nonatomic, assign) BOOL usesSessionService;
+@property (nonatomic, assign) BOOL usesAccountIndex;
+// Favourites added (YES) or removed (NO) whose requests haven't finished, keyed by node identifier without version
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *pendingChanges;
+// Set while all favourites are being retrieved into refreshingIndex
+@property (nonatomic, strong) NSMutableArray *refreshCompletionBlocks;
+@property (nonatomic, strong) FavouritesIndex *refreshingIndex;
 
 @end
 
@@ -40,10 +59,21 @@
 }
 
 - (id)init
+{
+    return [self initWithService:nil favouritesIndex:nil];
+}
+
+- (instancetype)initWithService:(id<FavouriteManagerService>)service favouritesIndex:(FavouritesIndex *)favouritesIndex
 {
     self = [super init];
     if (self)
     {
+        self.documentFolderService = service;
+        self.usesSessionService = (service == nil);
+        self.favouritesIndex = favouritesIndex;
+        self.usesAccountIndex = (favouritesIndex == nil);
+        self.pendingChanges = [NSMutableDictionary dictionary];
+        
         [[NSNotificationCenter defaultCenter] addObserver:self
                                                  selector:@selector(sessionReceived:)
                                                      name:kAlfrescoSessionReceivedNotification
@@ -67,28 +97,115 @@
 - (void)sessionReceived:(NSNotification *)notification
 {
     id<AlfrescoSession> session = notification.object;
+    self.session = session;
     [self createServicesWithSession:session];
+    [self loadFavouritesIndexForSelectedAccount];
+    
+    // One listing of every favourite stands in for a request per node shown
+    [self refreshFavoritesWithSession:session completionBlock:nil];
 }
 
 - (void)createServicesWithSession:(id<AlfrescoSession>)session
 {
-    self.documentFolderService = [[AlfrescoDocumentFolderService alloc] initWithSession:session];
+    if (self.usesSessionService)
+    {
+        self.documentFolderService = session ? [[AlfrescoDocumentFolderService alloc] initWithSession:session] : nil;
+    }
 }
 
-#pragma mark - Public Functions
-
-- (AlfrescoRequest *)addFavorite:(AlfrescoNode *)node session:(id<AlfrescoSession>)session completionBlock:(void (^)(BOOL succeeded, NSError *error))completionBlock
+- (void)useSessionIfNeeded:(id<AlfrescoSession>)session
 {
     if (!self.session)
     {
         self.session = session;
         [self createServicesWithSession:session];
+        [self loadFavouritesIndexForSelectedAccount];
+    }
+}
+
+- (void)loadFavouritesIndexForSelectedAccount
+{
+    if (!self.usesAccountIndex)
+    {
+        return;
     }
     
+    UserAccount *account = [AccountManager sharedManager].selectedAccount;
+    NSString *filePath = account ? [FavouritesIndex filePathForAccountIdentifier:account.accountIdentifier networkIdentifier:account.selectedNetworkId] : nil;
+    if (![self.favouritesIndex.filePath isEqualToString:filePath])
+    {
+        self.favouritesIndex = filePath ? [[FavouritesIndex alloc] initWithFilePath:filePath] : nil;
+        [self.pendingChanges removeAllObjects];
+    }
+}
+
+- (void)applyPendingChangesToIndex:(FavouritesIndex *)index
+{
+    [self.pendingChanges enumerateKeysAndObjectsUsingBlock:^(NSString *identifier, NSNumber *isFavorite, BOOL *stop) {
+        if (isFavorite.boolValue)
+        {
+            [index addNodeIdentifier:identifier];
+        }
+        else
+        {
+            [index removeNodeIdentifier:identifier];
+        }
+    }];
+}
+
+- (void)retrieveFavoriteIdentifiersWithSkipCount:(int)skipCount identifiers:(NSMutableArray *)identifiers completionBlock:(void (^)(NSArray *identifiers, NSError *error))completionBlock
+{
+    AlfrescoListingContext *listingContext = [[AlfrescoListingContext alloc] initWithMaxItems:kFavouritesRefreshPageSize skipCount:skipCount];
+    [self.documentFolderService retrieveFavoriteNodesWithListingContext:listingContext completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+        if (!pagingResult)
+        {
+            completionBlock(nil, error);
+            return;
+        }
+        
+        for (AlfrescoNode *node in pagingResult.objects)
+        {
+            [identifiers addObject:node.identifier];
+        }
+        
+        if (pagingResult.hasMoreItems && pagingResult.objects.count > 0)
+        {
+            [self retrieveFavoriteIdentifiersWithSkipCount:skipCount + (int)pagingResult.objects.count identifiers:identifiers completionBlock:completionBlock];
+        }
+        else
+        {
+            completionBlock(identifiers, nil);
+        }
+    }];
+}
+
+#pragma mark - Public Functions
+
+- (AlfrescoRequest *)addFavorite:(AlfrescoNode *)node session:(id<AlfrescoSession>)session completionBlock:(void (^)(BOOL succeeded, NSError *error))completionBlock
+{
+    [self useSessionIfNeeded:session];
+    
+    FavouritesIndex *index = self.favouritesIndex;
+    NSString *identifier = [node nodeRefWithoutVersionID];
+    BOOL wasIndexed = [index containsNode:node];
+    
+    if (identifier)
+    {
+        [index addNodeIdentifier:identifier];
+        self.pendingChanges[identifier] = @YES;
+    }
+    
+    // Observers refetch the favourites list, so they are only told once the server has the change
     return [self.documentFolderService addFavorite:node completionBlock:^(BOOL succeeded, BOOL isFavorited, NSError *error) {
+        if (identifier)
+        {
+            [self.pendingChanges removeObjectForKey:identifier];
+        }
+        
         if (succeeded)
         {
             [[NSNotificationCenter defaultCenter] postNotificationName:kFavouritesDidAddNodeNotification object:node];
+            
             if (completionBlock != NULL)
             {
                 completionBlock(isFavorited, error);
@@ -96,6 +213,13 @@
         }
         else
         {
+            if (!wasIndexed)
+            {
+                [index removeNodeIdentifier:identifier];
+            }
+            // Cells configured while the request was in flight showed the optimistic state
+            [[NSNotificationCenter defaultCenter] postNotificationName:kFavouritesDidRemoveNodeNotification object:node];
+            
             if (completionBlock != NULL)
             {
                 completionBlock(NO, error);
@@ -106,61 +230,172 @@
 
 - (AlfrescoRequest *)removeFavorite:(AlfrescoNode *)node session:(id<AlfrescoSession>)session completionBlock:(void (^)(BOOL succeeded, NSError *error))completionBlock
 {
-    if (!self.session)
+    [self useSessionIfNeeded:session];
+    
+    FavouritesIndex *index = self.favouritesIndex;
+    NSString *identifier = [node nodeRefWithoutVersionID];
+    BOOL wasIndexed = [index containsNode:node];
+    
+    if (identifier)
     {
-        self.session = session;
-        [self createServicesWithSession:session];
+        [index removeNodeIdentifier:identifier];
+        self.pendingChanges[identifier] = @NO;
     }
     
     return [self.documentFolderService removeFavorite:node completionBlock:^(BOOL succeeded, BOOL isFavorited, NSError *error) {
+        if (identifier)
+        {
+            [self.pendingChanges removeObjectForKey:identifier];
+        }
+        
         if (succeeded)
         {
             [[NSNotificationCenter defaultCenter] postNotificationName:kFavouritesDidRemoveNodeNotification object:node];
-            if (completionBlock != NULL)
-            {
-                completionBlock(succeeded, error);
-            }
         }
         else
         {
-            if (completionBlock != NULL)
+            if (wasIndexed)
             {
-                completionBlock(succeeded, error);
+                [index addNodeIdentifier:identifier];
             }
+            [[NSNotificationCenter defaultCenter] postNotificationName:kFavouritesDidAddNodeNotification object:node];
+        }
+        
+        if (completionBlock != NULL)
+        {
+            completionBlock(succeeded, error);
         }
     }];
 }
 
 - (AlfrescoRequest *)isNodeFavorite:(AlfrescoNode *)node session:(id<AlfrescoSession>)session completionBlock:(void (^)(BOOL isFavorite, NSError *error))completionBlock
 {
-    if (!self.session)
+    [self useSessionIfNeeded:session];
+    
+    BOOL isFavorite = NO;
+    if ([self cachedFavoriteStatusOfNode:node isFavorite:&isFavorite])
     {
-        self.session = session;
-        [self createServicesWithSession:session];
+        completionBlock(isFavorite, nil);
+        return nil;
     }
     
+    FavouritesIndex *index = self.favouritesIndex;
     return [self.documentFolderService isFavorite:node completionBlock:^(BOOL succeeded, BOOL isFavorited, NSError *error) {
+        if (succeeded && isFavorited)
+        {
+            [index addNodeIdentifier:node.identifier];
+        }
         completionBlock(isFavorited, error);
     }];
 }
 
+- (BOOL)cachedFavoriteStatusOfNode:(AlfrescoNode *)node isFavorite:(BOOL *)isFavorite
+{
+    FavouritesIndex *index = self.favouritesIndex;
+    BOOL isIndexed = [index containsNode:node];
+    if (!isIndexed && !index.isComplete)
+    {
+        return NO;
+    }
+    
+    if (isFavorite)
+    {
+        *isFavorite = isIndexed;
+    }
+    return YES;
+}
+
+- (void)refreshFavoritesWithSession:(id<AlfrescoSession>)session completionBlock:(void (^)(BOOL succeeded, NSError *error))completionBlock
+{
+    [self useSessionIfNeeded:session];
+    
+    FavouritesIndex *index = self.favouritesIndex;
+    // A refresh started for another account's index can't answer for this one
+    if (self.refreshCompletionBlocks && self.refreshingIndex == index)
+    {
+        if (completionBlock)
+        {
+            [self.refreshCompletionBlocks addObject:[completionBlock copy]];
+        }
+        return;
+    }
+    
+    if (!self.documentFolderService)
+    {
+        if (completionBlock)
+        {
+            completionBlock(NO, nil);
+        }
+        return;
+    }
+    
+    NSMutableArray *refreshCompletionBlocks = [NSMutableArray array];
+    if (completionBlock)
+    {
+        [refreshCompletionBlocks addObject:[completionBlock copy]];
+    }
+    self.refreshCompletionBlocks = refreshCompletionBlocks;
+    self.refreshingIndex = index;
+    
+    [self retrieveFavoriteIdentifiersWithSkipCount:0 identifiers:[NSMutableArray array] completionBlock:^(NSArray *identifiers, NSError *error) {
+        if (identifiers)
+        {
+            [index replaceAllNodeIdentifiers:identifiers];
+            // Requests still in flight were made after the listing was read
+            [self applyPendingChangesToIndex:index];
+        }
+        else
+        {
+            AlfrescoLogError(@"Unable to retrieve favourites: %@", error.localizedDescription);
+        }
+        
+        if (self.refreshCompletionBlocks == refreshCompletionBlocks)
+        {
+            self.refreshCompletionBlocks = nil;
+            self.refreshingIndex = nil;
+        }
+        for (void (^refreshCompletionBlock)(BOOL, NSError *) in refreshCompletionBlocks)
+        {
+            refreshCompletionBlock(identifiers != nil, error);
+        }
+    }];
+}
+
 - (void)topLevelFavoriteNodesWithSession:(id<AlfrescoSession>)session filter:(NSString *)filter listingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
 {
+    [self useSessionIfNeeded:session];
+    
+    BOOL isFirstPage = (listingContext.skipCount == 0);
+    BOOL isAllFavorites = [filter isEqualToString:kAlfrescoConfigViewParameterFavoritesFiltersAll];
+    FavouritesIndex *index = self.favouritesIndex;
+    
     void (^retrieveCompletionBlock)(AlfrescoPagingResult *, NSError *) = ^void(AlfrescoPagingResult *pagingResult, NSError *error) {
+        if (pagingResult)
+        {
+            NSArray *identifiers = [pagingResult.objects valueForKey:@"identifier"];
+            if (isAllFavorites && isFirstPage && !pagingResult.hasMoreItems)
+            {
+                [index replaceAllNodeIdentifiers:identifiers];
+                [self applyPendingChangesToIndex:index];
+            }
+            else
+            {
+                [index addNodeIdentifiers:identifiers];
+            }
+        }
+        
         if(completionBlock)
         {
             completionBlock(pagingResult, error);
         }
     };
     
-    if (!self.session)
+    // Only refreshing the list needs to bypass the service's cache, not loading further pages
+    if (isFirstPage)
     {
-        self.session = session;
-        [self createServicesWithSession:session];
+        [self.documentFolderService clear];
     }
     
-    [self.documentFolderService clear];
-    
     if ([filter isEqualToString:kAlfrescoConfigViewParameterFavoritesFiltersFiles])
     {
         [self.documentFolderService retrieveFavoriteDocumentsWithListingContext:listingContext completionBlock:retrieveCompletionBlock];
@@ -169,7 +404,7 @@
     {
         [self.documentFolderService retrieveFavoriteFoldersWithListingContext:listingContext completionBlock:retrieveCompletionBlock];
     }
-    else if ([filter isEqualToString:kAlfrescoConfigViewParameterFavoritesFiltersAll])
+    else if (isAllFavorites)
     {
         [self.documentFolderService retrieveFavoriteNodesWithListingContext:listingContext completionBlock:retrieveCompletionBlock];
     }
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+/**
+ * The favourites of one account, kept on disk so whether a node is a favourite can be answered at once without a request.
+ * Nodes are held by their identifier without the version, so every version of a document matches.
+ * Must be used from the main thread; files are written on a private queue.
+ */
+@interface FavouritesIndex : NSObject
+
+@property (nonatomic, strong, readonly) NSString *filePath;
+/// Whether every favourite has been retrieved, so a node missing from the index is known not to be a favourite
+@property (nonatomic, assign, readonly) BOOL isComplete;
+@property (nonatomic, assign, readonly) NSUInteger count;
+
++ (NSString *)filePathForAccountIdentifier:(NSString *)accountIdentifier networkIdentifier:(NSString *)networkIdentifier;
++ (void)removeIndexesForAccountIdentifier:(NSString *)accountIdentifier;
++ (void)removeAllIndexes;
+
+/*
+ * Creates an index persisted at the given path, loading it from the file if it exists. A nil path keeps the index in memory only.
+ */
+- (instancetype)initWithFilePath:(NSString *)filePath;
+
+- (BOOL)containsNode:(AlfrescoNode *)node;
+- (BOOL)containsNodeWithIdentifier:(NSString *)identifier;
+
+/*
+ * Replaces the index with the full set of favourites, marking it complete.
+ */
+- (void)replaceAllNodeIdentifiers:(NSArray<NSString *> *)identifiers;
+
+- (void)addNodeIdentifier:(NSString *)identifier;
+- (void)addNodeIdentifiers:(NSArray<NSString *> *)identifiers;
+- (void)removeNodeIdentifier:(NSString *)identifier;
+
+@end
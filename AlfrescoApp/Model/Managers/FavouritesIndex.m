@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "FavouritesIndex.h"
+#import "AccountArchiveFolder.h"
+#import "AlfrescoNode+Utilities.h"
+
+static NSInteger const kFavouritesIndexVersion = 1;
+
+static NSString * const kFavouritesIndexVersionKey = @"version";
+static NSString * const kFavouritesIndexIdentifiersKey = @"identifiers";
+static NSString * const kFavouritesIndexCompleteKey = @"complete";
+static NSString * const kFavouritesIndexRepositoryName = @"repository";
+
+@interface FavouritesIndex ()
+
+@property (nonatomic, strong, readwrite) NSString *filePath;
+@property (nonatomic, assign, readwrite) BOOL isComplete;
+@property (nonatomic, strong) NSMutableSet<NSString *> *identifiers;
+
+@end
+
+@implementation FavouritesIndex
+
++ (AccountArchiveFolder *)archiveFolder
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[AccountArchiveFolder alloc] initWithFolderPath:[[AlfrescoFileManager sharedManager] favouritesFolderPath] archiveDescription:@"favourites"];
+    });
+    return sharedObject;
+}
+
++ (NSString *)filePathForAccountIdentifier:(NSString *)accountIdentifier networkIdentifier:(NSString *)networkIdentifier
+{
+    return [[self archiveFolder] filePathForAccountIdentifier:accountIdentifier archiveName:networkIdentifier ?: kFavouritesIndexRepositoryName];
+}
+
++ (void)removeIndexesForAccountIdentifier:(NSString *)accountIdentifier
+{
+    [[self archiveFolder] removeArchivesForAccountIdentifier:accountIdentifier];
+}
+
++ (void)removeAllIndexes
+{
+    [[self archiveFolder] removeAllArchives];
+}
+
+- (instancetype)initWithFilePath:(NSString *)filePath
+{
+    self = [super init];
+    if (self)
+    {
+        self.filePath = filePath;
+        self.identifiers = [NSMutableSet set];
+        
+        if (filePath)
+        {
+            [self loadIndex];
+        }
+    }
+    return self;
+}
+
+#pragma mark - Public Functions
+
+- (NSUInteger)count
+{
+    return self.identifiers.count;
+}
+
+- (BOOL)containsNode:(AlfrescoNode *)node
+{
+    return [self.identifiers containsObject:[node nodeRefWithoutVersionID]];
+}
+
+- (BOOL)containsNodeWithIdentifier:(NSString *)identifier
+{
+    return [self.identifiers containsObject:[AlfrescoNode nodeRefWithoutVersionIDFromIdentifier:identifier]];
+}
+
+- (void)replaceAllNodeIdentifiers:(NSArray<NSString *> *)identifiers
+{
+    [self.identifiers removeAllObjects];
+    for (NSString *identifier in identifiers)
+    {
+        [self.identifiers addObject:[AlfrescoNode nodeRefWithoutVersionIDFromIdentifier:identifier]];
+    }
+    self.isComplete = YES;
+    [self saveIndex];
+}
+
+- (void)addNodeIdentifier:(NSString *)identifier
+{
+    if (identifier)
+    {
+        [self.identifiers addObject:[AlfrescoNode nodeRefWithoutVersionIDFromIdentifier:identifier]];
+        [self saveIndex];
+    }
+}
+
+- (void)addNodeIdentifiers:(NSArray<NSString *> *)identifiers
+{
+    NSUInteger previousCount = self.identifiers.count;
+    for (NSString *identifier in identifiers)
+    {
+        [self.identifiers addObject:[AlfrescoNode nodeRefWithoutVersionIDFromIdentifier:identifier]];
+    }
+    
+    if (self.identifiers.count != previousCount)
+    {
+        [self saveIndex];
+    }
+}
+
+- (void)removeNodeIdentifier:(NSString *)identifier
+{
+    if (identifier)
+    {
+        [self.identifiers removeObject:[AlfrescoNode nodeRefWithoutVersionIDFromIdentifier:identifier]];
+        [self saveIndex];
+    }
+}
+
+#pragma mark - Persistence
+
+- (void)loadIndex
+{
+    NSData *data = [[AlfrescoFileManager sharedManager] dataWithContentsOfURL:[NSURL fileURLWithPath:self.filePath]];
+    if (!data)
+    {
+        return;
+    }
+    
+    NSDictionary *archive = nil;
+    @try
+    {
+        NSSet *classes = [NSSet setWithObjects:[NSDictionary class], [NSArray class], [NSNumber class], [NSString class], nil];
+        archive = [NSKeyedUnarchiver unarchivedObjectOfClasses:classes fromData:data error:nil];
+    }
+    @catch (NSException *exception)
+    {
+        AlfrescoLogError(@"Unable to read the stored favourites: %@", exception.reason);
+    }
+    
+    if (![archive isKindOfClass:[NSDictionary class]] || [archive[kFavouritesIndexVersionKey] integerValue] != kFavouritesIndexVersion)
+    {
+        return;
+    }
+    
+    [self.identifiers addObjectsFromArray:archive[kFavouritesIndexIdentifiersKey]];
+    self.isComplete = [archive[kFavouritesIndexCompleteKey] boolValue];
+}
+
+- (void)saveIndex
+{
+    if (!self.filePath)
+    {
+        return;
+    }
+    
+    NSDictionary *archive = @{kFavouritesIndexVersionKey : @(kFavouritesIndexVersion),
+                              kFavouritesIndexIdentifiersKey : self.identifiers.allObjects,
+                              kFavouritesIndexCompleteKey : @(self.isComplete)};
+    [[[self class] archiveFolder] saveArchiveWithRootObject:archive toFilePath:self.filePath];
+}
+
+@end
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+@class RealmSyncNodeInfo;
+
+typedef NS_ENUM(NSInteger, LocalSearchIndexSource)
+{
+    LocalSearchIndexSourceSynced = 0,
+    LocalSearchIndexSourceDownloaded
+};
+
+// Scope of entries for downloaded documents, which are shared by all accounts. Synced entries are scoped by account identifier.
+extern NSString * const kLocalSearchIndexDownloadsScope;
+
+/**
+ * The searchable metadata of one synced or downloaded document or folder.
+ */
+@interface LocalSearchIndexEntry : NSObject <NSSecureCoding>
+
+// Sync node info identifier for synced entries, downloaded file name for downloaded ones
+@property (nonatomic, strong) NSString *identifier;
+@property (nonatomic, strong) NSString *scope;
+@property (nonatomic, assign) LocalSearchIndexSource source;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSString *title;
+@property (nonatomic, strong) NSString *summary;
+@property (nonatomic, strong) NSString *mimeType;
+@property (nonatomic, strong) NSString *path;
+// Tokens extracted from the document's text content, if any
+@property (nonatomic, strong) NSArray<NSString *> *contentTokens;
+
++ (instancetype)entryWithNode:(AlfrescoNode *)node identifier:(NSString *)identifier scope:(NSString *)scope source:(LocalSearchIndexSource)source path:(NSString *)path;
++ (instancetype)entryWithSyncNodeInfo:(RealmSyncNodeInfo *)nodeInfo node:(AlfrescoNode *)node scope:(NSString *)scope;
+
+@end
+
+/**
+ * On-device inverted index over the metadata of synced and downloaded content, so it can be searched while offline.
+ *
+ * The sync and download pipelines keep it up to date as nodes are stored and removed. Query tokens match indexed
+ * tokens by prefix, falling back to a small edit distance for longer tokens that match nothing. Updates are applied
+ * on a private queue and persisted shortly afterwards; all methods may be called from any thread.
+ */
+@interface LocalSearchIndex : NSObject
+
+@property (nonatomic, assign, readonly) NSUInteger numberOfEntries;
+
++ (LocalSearchIndex *)sharedIndex;
+
+/*
+ * Creates an index persisted at the given path, loading it if the file exists. A nil path keeps the index in memory only.
+ */
+- (instancetype)initWithFilePath:(NSString *)filePath;
+
+/*
+ * Adds or replaces the entry. If a content path is given and the content is text, its words are indexed too.
+ */
+- (void)indexEntry:(LocalSearchIndexEntry *)entry contentPath:(NSString *)contentPath;
+- (void)indexEntries:(NSArray<LocalSearchIndexEntry *> *)entries;
+- (void)removeEntryWithIdentifier:(NSString *)identifier scope:(NSString *)scope;
+- (void)removeAllEntriesInScope:(NSString *)scope;
+
+/*
+ * Returns up to limit entries in the given scopes matching every word of the query, entries matching on their
+ * name first. Waits for any pending updates to be applied.
+ */
+- (NSArray<LocalSearchIndexEntry *> *)entriesMatchingQuery:(NSString *)query inScopes:(NSArray<NSString *> *)scopes limit:(NSUInteger)limit;
+
+/*
+ * As above, off the calling thread; the completion block is called on the main thread.
+ */
+- (void)searchWithQuery:(NSString *)query inScopes:(NSArray<NSString *> *)scopes limit:(NSUInteger)limit completionBlock:(void (^)(NSArray<LocalSearchIndexEntry *> *entries))completionBlock;
+
+/*
+ * Replaces the contents of the index with the currently synced and downloaded content.
+ */
+- (void)rebuildFromLocalContent;
+
++ (NSArray<NSString *> *)tokensFromString:(NSString *)string;
+
+@end
@@ -0,0 +1,805 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "LocalSearchIndex.h"
+#import "DownloadManager.h"
+#import "AccountManager.h"
+#import "RealmSyncCore.h"
+#import "AlfrescoFileManager+Extensions.h"
+
+NSString * const kLocalSearchIndexDownloadsScope = @"downloads";
+
+static NSString * const kLocalSearchIndexFileName = @"LocalSearchIndex.archive";
+static NSInteger const kLocalSearchIndexVersion = 1;
+static NSString * const kLocalSearchIndexVersionKey = @"version";
+static NSString * const kLocalSearchIndexEntriesKey = @"entries";
+
+static NSTimeInterval const kLocalSearchIndexSaveDelay = 5.0;
+static NSUInteger const kMinimumTokenLengthForFuzzyMatch = 4;
+static NSUInteger const kMinimumTokenLengthForTwoEdits = 8;
+static NSUInteger const kMaximumContentBytes = 512 * 1024;
+static NSUInteger const kMaximumContentTokens = 2000;
+static NSUInteger const kMinimumRemovedEntriesForCompaction = 1024;
+
+/**
+ * Levenshtein distance between the two strings, giving up as soon as it must exceed maxDistance.
+ */
+static NSUInteger LocalSearchBoundedEditDistance(NSString *first, NSString *second, NSUInteger maxDistance)
+{
+    NSUInteger firstLength = first.length;
+    NSUInteger secondLength = second.length;
+    NSUInteger lengthDifference = (firstLength > secondLength) ? firstLength - secondLength : secondLength - firstLength;
+    if (lengthDifference > maxDistance)
+    {
+        return maxDistance + 1;
+    }
+    
+    unichar firstCharacters[firstLength];
+    unichar secondCharacters[secondLength];
+    [first getCharacters:firstCharacters range:NSMakeRange(0, firstLength)];
+    [second getCharacters:secondCharacters range:NSMakeRange(0, secondLength)];
+    
+    NSUInteger previousRow[secondLength + 1];
+    NSUInteger currentRow[secondLength + 1];
+    for (NSUInteger column = 0; column <= secondLength; column++)
+    {
+        previousRow[column] = column;
+    }
+    
+    for (NSUInteger row = 1; row <= firstLength; row++)
+    {
+        currentRow[0] = row;
+        NSUInteger rowMinimum = row;
+        for (NSUInteger column = 1; column <= secondLength; column++)
+        {
+            NSUInteger substitutionCost = (firstCharacters[row - 1] == secondCharacters[column - 1]) ? 0 : 1;
+            NSUInteger distance = MIN(MIN(previousRow[column] + 1, currentRow[column - 1] + 1), previousRow[column - 1] + substitutionCost);
+            currentRow[column] = distance;
+            rowMinimum = MIN(rowMinimum, distance);
+        }
+        if (rowMinimum > maxDistance)
+        {
+            return maxDistance + 1;
+        }
+        memcpy(previousRow, currentRow, sizeof(previousRow));
+    }
+    
+    return previousRow[secondLength];
+}
+
+#pragma mark - LocalSearchIndexEntry
+
+@interface LocalSearchIndexEntry ()
+
+// Not persisted; derived when the entry is added to an index
+@property (nonatomic, strong) NSArray<NSString *> *nameTokens;
+@property (nonatomic, strong) NSArray<NSString *> *tokens;
+
+- (NSString *)indexKey;
+
+@end
+
+@implementation LocalSearchIndexEntry
+
++ (instancetype)entryWithNode:(AlfrescoNode *)node identifier:(NSString *)identifier scope:(NSString *)scope source:(LocalSearchIndexSource)source path:(NSString *)path
+{
+    LocalSearchIndexEntry *entry = [self new];
+    entry.identifier = identifier;
+    entry.scope = scope;
+    entry.source = source;
+    entry.name = node.name;
+    entry.title = node.title;
+    entry.summary = node.summary;
+    entry.path = path;
+    if (node.isDocument)
+    {
+        entry.mimeType = ((AlfrescoDocument *)node).contentMimeType;
+    }
+    return entry;
+}
+
++ (instancetype)entryWithSyncNodeInfo:(RealmSyncNodeInfo *)nodeInfo node:(AlfrescoNode *)node scope:(NSString *)scope
+{
+    NSMutableArray *folderNames = [NSMutableArray array];
+    for (RealmSyncNodeInfo *parent = nodeInfo.parentNode; parent; parent = parent.parentNode)
+    {
+        [folderNames insertObject:parent.title ?: @"" atIndex:0];
+    }
+    return [self entryWithNode:node identifier:nodeInfo.syncNodeInfoId scope:scope source:LocalSearchIndexSourceSynced path:[folderNames componentsJoinedByString:@"/"]];
+}
+
++ (BOOL)supportsSecureCoding
+{
+    return YES;
+}
+
+- (instancetype)initWithCoder:(NSCoder *)aDecoder
+{
+    self = [super init];
+    if (self)
+    {
+        self.identifier = [aDecoder decodeObjectOfClass:[NSString class] forKey:@"identifier"];
+        self.scope = [aDecoder decodeObjectOfClass:[NSString class] forKey:@"scope"];
+        self.source = [aDecoder decodeIntegerForKey:@"source"];
+        self.name = [aDecoder decodeObjectOfClass:[NSString class] forKey:@"name"];
+        self.title = [aDecoder decodeObjectOfClass:[NSString class] forKey:@"title"];
+        self.summary = [aDecoder decodeObjectOfClass:[NSString class] forKey:@"summary"];
+        self.mimeType = [aDecoder decodeObjectOfClass:[NSString class] forKey:@"mimeType"];
+        self.path = [aDecoder decodeObjectOfClass:[NSString class] forKey:@"path"];
+        self.contentTokens = [aDecoder decodeObjectOfClasses:[NSSet setWithObjects:[NSArray class], [NSString class], nil] forKey:@"contentTokens"];
+    }
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)aCoder
+{
+    [aCoder encodeObject:self.identifier forKey:@"identifier"];
+    [aCoder encodeObject:self.scope forKey:@"scope"];
+    [aCoder encodeInteger:self.source forKey:@"source"];
+    [aCoder encodeObject:self.name forKey:@"name"];
+    [aCoder encodeObject:self.title forKey:@"title"];
+    [aCoder encodeObject:self.summary forKey:@"summary"];
+    [aCoder encodeObject:self.mimeType forKey:@"mimeType"];
+    [aCoder encodeObject:self.path forKey:@"path"];
+    [aCoder encodeObject:self.contentTokens forKey:@"contentTokens"];
+}
+
+- (NSString *)indexKey
+{
+    return [NSString stringWithFormat:@"%@/%@", self.scope ?: kLocalSearchIndexDownloadsScope, self.identifier];
+}
+
+@end
+
+#pragma mark - LocalSearchIndex
+
+@interface LocalSearchIndex ()
+
+@property (nonatomic, strong) NSString *filePath;
+@property (nonatomic, strong) dispatch_queue_t indexQueue;
+// Every update passes through this queue on its way to the index queue, so updates are applied in the order they were made
+@property (nonatomic, strong) dispatch_queue_t contentQueue;
+// Entries by document number; removed entries leave an NSNull behind until the entries are compacted
+@property (nonatomic, strong) NSMutableArray *entries;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *documentNumbersByKey;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableIndexSet *> *postings;
+@property (nonatomic, strong) NSArray<NSString *> *sortedVocabulary;
+@property (nonatomic, assign) BOOL isVocabularyStale;
+@property (nonatomic, assign) NSUInteger saveGeneration;
+
+@end
+
+@implementation LocalSearchIndex
+
++ (LocalSearchIndex *)sharedIndex
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        NSString *filePath = [[[AlfrescoFileManager sharedManager] searchIndexFolderPath] stringByAppendingPathComponent:kLocalSearchIndexFileName];
+        LocalSearchIndex *index = [[self alloc] initWithFilePath:filePath];
+        [index rebuildFromLocalContentIfEmpty];
+        sharedObject = index;
+    });
+    return sharedObject;
+}
+
+- (instancetype)initWithFilePath:(NSString *)filePath
+{
+    self = [super init];
+    if (self)
+    {
+        self.filePath = filePath;
+        self.indexQueue = dispatch_queue_create("com.alfresco.localsearchindex", DISPATCH_QUEUE_SERIAL);
+        self.contentQueue = dispatch_queue_create("com.alfresco.localsearchindex.content", DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(self.contentQueue, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+        self.entries = [NSMutableArray array];
+        self.documentNumbersByKey = [NSMutableDictionary dictionary];
+        self.postings = [NSMutableDictionary dictionary];
+        
+        if (filePath)
+        {
+            dispatch_async(self.indexQueue, ^{
+                [self loadIndex];
+            });
+            [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationDidEnterBackground:) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark - Public Methods
+
+- (NSUInteger)numberOfEntries
+{
+    __block NSUInteger numberOfEntries = 0;
+    [self waitForPendingUpdates];
+    dispatch_sync(self.indexQueue, ^{
+        numberOfEntries = self.documentNumbersByKey.count;
+    });
+    return numberOfEntries;
+}
+
+- (void)indexEntry:(LocalSearchIndexEntry *)entry contentPath:(NSString *)contentPath
+{
+    if (!entry.identifier)
+    {
+        return;
+    }
+    
+    BOOL readsContent = contentPath && [self isTextMimeType:entry.mimeType];
+    dispatch_async(self.contentQueue, ^{
+        // Reading content can be slow, so it is kept off the queue that searches wait on
+        if (readsContent)
+        {
+            entry.contentTokens = [self contentTokensForFileAtPath:contentPath];
+        }
+        
+        dispatch_async(self.indexQueue, ^{
+            [self addEntry:entry];
+            [self compactEntriesIfNeeded];
+            [self scheduleSave];
+        });
+    });
+}
+
+- (void)indexEntries:(NSArray<LocalSearchIndexEntry *> *)entries
+{
+    if (entries.count == 0)
+    {
+        return;
+    }
+    
+    [self performUpdate:^{
+        for (LocalSearchIndexEntry *entry in entries)
+        {
+            [self addEntry:entry];
+        }
+        [self compactEntriesIfNeeded];
+        [self scheduleSave];
+    }];
+}
+
+- (void)removeEntryWithIdentifier:(NSString *)identifier scope:(NSString *)scope
+{
+    if (!identifier)
+    {
+        return;
+    }
+    
+    NSString *key = [NSString stringWithFormat:@"%@/%@", scope ?: kLocalSearchIndexDownloadsScope, identifier];
+    [self performUpdate:^{
+        [self removeEntryWithKey:key];
+        [self compactEntriesIfNeeded];
+        [self scheduleSave];
+    }];
+}
+
+- (void)removeAllEntriesInScope:(NSString *)scope
+{
+    NSString *keyPrefix = [(scope ?: kLocalSearchIndexDownloadsScope) stringByAppendingString:@"/"];
+    [self performUpdate:^{
+        for (NSString *key in self.documentNumbersByKey.allKeys)
+        {
+            if ([key hasPrefix:keyPrefix])
+            {
+                [self removeEntryWithKey:key];
+            }
+        }
+        [self compactEntriesIfNeeded];
+        [self scheduleSave];
+    }];
+}
+
+- (NSArray<LocalSearchIndexEntry *> *)entriesMatchingQuery:(NSString *)query inScopes:(NSArray<NSString *> *)scopes limit:(NSUInteger)limit
+{
+    __block NSArray *matchingEntries = nil;
+    [self waitForPendingUpdates];
+    dispatch_sync(self.indexQueue, ^{
+        matchingEntries = [self searchQuery:query inScopes:[NSSet setWithArray:scopes] limit:limit];
+    });
+    return matchingEntries;
+}
+
+- (void)searchWithQuery:(NSString *)query inScopes:(NSArray<NSString *> *)scopes limit:(NSUInteger)limit completionBlock:(void (^)(NSArray<LocalSearchIndexEntry *> *entries))completionBlock
+{
+    NSSet *scopeSet = [NSSet setWithArray:scopes];
+    dispatch_async(self.indexQueue, ^{
+        NSArray *matchingEntries = [self searchQuery:query inScopes:scopeSet limit:limit];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionBlock(matchingEntries);
+        });
+    });
+}
+
+- (void)rebuildFromLocalContent
+{
+    dispatch_async(self.contentQueue, ^{
+        NSMutableArray *entries = [NSMutableArray array];
+        [entries addObjectsFromArray:[self entriesForDownloadedDocuments]];
+        for (UserAccount *account in [[AccountManager sharedManager] allAccounts])
+        {
+            [entries addObjectsFromArray:[self entriesForSyncedNodesOfAccountWithIdentifier:account.accountIdentifier]];
+        }
+        
+        dispatch_async(self.indexQueue, ^{
+            [self removeAllEntries];
+            for (LocalSearchIndexEntry *entry in entries)
+            {
+                [self addEntry:entry];
+            }
+            [self scheduleSave];
+            AlfrescoLogDebug(@"Rebuilt local search index with %lu entries", (unsigned long)entries.count);
+        });
+    });
+}
+
+- (void)rebuildFromLocalContentIfEmpty
+{
+    // Content stored before the index existed, or a discarded index file, is picked up once the saved index has loaded
+    dispatch_async(self.indexQueue, ^{
+        if (self.documentNumbersByKey.count == 0)
+        {
+            [self rebuildFromLocalContent];
+        }
+    });
+}
+
++ (NSArray<NSString *> *)tokensFromString:(NSString *)string
+{
+    if (string.length == 0)
+    {
+        return @[];
+    }
+    
+    static NSCharacterSet *separators = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        separators = [[NSCharacterSet alphanumericCharacterSet] invertedSet];
+    });
+    
+    NSString *foldedString = [string stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch locale:nil];
+    NSMutableArray *tokens = [NSMutableArray array];
+    for (NSString *component in [foldedString componentsSeparatedByCharactersInSet:separators])
+    {
+        if (component.length > 0)
+        {
+            [tokens addObject:component];
+        }
+    }
+    return tokens;
+}
+
+#pragma mark - Update Ordering
+
+/*
+ * Applies the update on the index queue once every earlier update, including content being read and rebuilds being
+ * gathered, has been applied. A removal can't then be overtaken by an earlier request to index the same entry.
+ */
+- (void)performUpdate:(dispatch_block_t)update
+{
+    dispatch_async(self.contentQueue, ^{
+        dispatch_async(self.indexQueue, update);
+    });
+}
+
+- (void)waitForPendingUpdates
+{
+    // Anything still on the content queue reaches the index queue before this returns
+    dispatch_sync(self.contentQueue, ^{});
+}
+
+#pragma mark - Private Methods (index queue only)
+
+- (void)addEntry:(LocalSearchIndexEntry *)entry
+{
+    NSString *key = [entry indexKey];
+    [self removeEntryWithKey:key];
+    
+    entry.nameTokens = [LocalSearchIndex tokensFromString:entry.name];
+    NSMutableOrderedSet *tokens = [NSMutableOrderedSet orderedSetWithArray:entry.nameTokens];
+    [tokens addObjectsFromArray:[LocalSearchIndex tokensFromString:entry.title]];
+    [tokens addObjectsFromArray:[LocalSearchIndex tokensFromString:entry.summary]];
+    [tokens addObjectsFromArray:[LocalSearchIndex tokensFromString:entry.mimeType]];
+    [tokens addObjectsFromArray:[LocalSearchIndex tokensFromString:entry.path]];
+    [tokens addObjectsFromArray:entry.contentTokens ?: @[]];
+    entry.tokens = tokens.array;
+    
+    NSUInteger documentNumber = self.entries.count;
+    [self.entries addObject:entry];
+    self.documentNumbersByKey[key] = @(documentNumber);
+    
+    for (NSString *token in entry.tokens)
+    {
+        NSMutableIndexSet *documentNumbers = self.postings[token];
+        if (!documentNumbers)
+        {
+            documentNumbers = [NSMutableIndexSet indexSet];
+            self.postings[token] = documentNumbers;
+            self.isVocabularyStale = YES;
+        }
+        [documentNumbers addIndex:documentNumber];
+    }
+}
+
+- (void)removeEntryWithKey:(NSString *)key
+{
+    NSNumber *documentNumber = self.documentNumbersByKey[key];
+    if (!documentNumber)
+    {
+        return;
+    }
+    
+    NSUInteger index = documentNumber.unsignedIntegerValue;
+    LocalSearchIndexEntry *entry = self.entries[index];
+    for (NSString *token in entry.tokens)
+    {
+        NSMutableIndexSet *documentNumbers = self.postings[token];
+        [documentNumbers removeIndex:index];
+        if (documentNumbers.count == 0)
+        {
+            [self.postings removeObjectForKey:token];
+            self.isVocabularyStale = YES;
+        }
+    }
+    
+    self.entries[index] = [NSNull null];
+    [self.documentNumbersByKey removeObjectForKey:key];
+}
+
+/*
+ * Renumbers the entries once removed ones make up most of them, so removals and renames don't grow the entries
+ * array without bound. The tokens, and so the vocabulary, are unchanged.
+ */
+- (void)compactEntriesIfNeeded
+{
+    NSUInteger numberOfRemovedEntries = self.entries.count - self.documentNumbersByKey.count;
+    if (numberOfRemovedEntries < kMinimumRemovedEntriesForCompaction || numberOfRemovedEntries < self.documentNumbersByKey.count)
+    {
+        return;
+    }
+    
+    NSMutableArray *entries = [NSMutableArray arrayWithCapacity:self.documentNumbersByKey.count];
+    [self.postings removeAllObjects];
+    for (LocalSearchIndexEntry *entry in self.entries)
+    {
+        if ([entry isKindOfClass:[NSNull class]])
+        {
+            continue;
+        }
+        
+        NSUInteger documentNumber = entries.count;
+        [entries addObject:entry];
+        self.documentNumbersByKey[[entry indexKey]] = @(documentNumber);
+        for (NSString *token in entry.tokens)
+        {
+            NSMutableIndexSet *documentNumbers = self.postings[token];
+            if (!documentNumbers)
+            {
+                documentNumbers = [NSMutableIndexSet indexSet];
+                self.postings[token] = documentNumbers;
+            }
+            [documentNumbers addIndex:documentNumber];
+        }
+    }
+    self.entries = entries;
+}
+
+- (void)removeAllEntries
+{
+    [self.entries removeAllObjects];
+    [self.documentNumbersByKey removeAllObjects];
+    [self.postings removeAllObjects];
+    self.sortedVocabulary = nil;
+    self.isVocabularyStale = YES;
+}
+
+- (NSArray *)searchQuery:(NSString *)query inScopes:(NSSet *)scopes limit:(NSUInteger)limit
+{
+    NSArray *queryTokens = [[NSOrderedSet orderedSetWithArray:[LocalSearchIndex tokensFromString:query]] array];
+    if (queryTokens.count == 0 || limit == 0)
+    {
+        return @[];
+    }
+    
+    // Every query token has to match
+    NSIndexSet *matchingDocuments = nil;
+    for (NSString *queryToken in queryTokens)
+    {
+        NSIndexSet *tokenDocuments = [self documentNumbersMatchingToken:queryToken];
+        if (!matchingDocuments)
+        {
+            matchingDocuments = tokenDocuments;
+        }
+        else
+        {
+            NSIndexSet *smaller = (tokenDocuments.count < matchingDocuments.count) ? tokenDocuments : matchingDocuments;
+            NSIndexSet *larger = (smaller == tokenDocuments) ? matchingDocuments : tokenDocuments;
+            matchingDocuments = [smaller indexesPassingTest:^BOOL(NSUInteger index, BOOL *stop) {
+                return [larger containsIndex:index];
+            }];
+        }
+        
+        if (matchingDocuments.count == 0)
+        {
+            return @[];
+        }
+    }
+    
+    // Entries whose name matches every query token rank first
+    NSMutableArray *nameMatches = [NSMutableArray array];
+    NSMutableArray *otherMatches = [NSMutableArray array];
+    [matchingDocuments enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        LocalSearchIndexEntry *entry = self.entries[index];
+        if (![scopes containsObject:entry.scope ?: kLocalSearchIndexDownloadsScope])
+        {
+            return;
+        }
+        
+        BOOL matchesName = YES;
+        for (NSString *queryToken in queryTokens)
+        {
+            BOOL matchesToken = NO;
+            for (NSString *nameToken in entry.nameTokens)
+            {
+                if ([nameToken hasPrefix:queryToken])
+                {
+                    matchesToken = YES;
+                    break;
+                }
+            }
+            if (!matchesToken)
+            {
+                matchesName = NO;
+                break;
+            }
+        }
+        [(matchesName ? nameMatches : otherMatches) addObject:entry];
+    }];
+    
+    NSComparator byName = ^NSComparisonResult(LocalSearchIndexEntry *first, LocalSearchIndexEntry *second) {
+        return [first.name caseInsensitiveCompare:second.name];
+    };
+    NSMutableArray *results = [NSMutableArray arrayWithCapacity:MIN(limit, nameMatches.count + otherMatches.count)];
+    for (NSMutableArray *matches in @[nameMatches, otherMatches])
+    {
+        if (results.count >= limit)
+        {
+            break;
+        }
+        [matches sortUsingComparator:byName];
+        [results addObjectsFromArray:[matches subarrayWithRange:NSMakeRange(0, MIN(matches.count, limit - results.count))]];
+    }
+    return results;
+}
+
+- (NSIndexSet *)documentNumbersMatchingToken:(NSString *)queryToken
+{
+    NSArray *vocabulary = [self vocabulary];
+    NSMutableIndexSet *documentNumbers = [NSMutableIndexSet indexSet];
+    
+    for (NSUInteger index = [self vocabulary:vocabulary insertionIndexOfToken:queryToken]; index < vocabulary.count; index++)
+    {
+        NSString *token = vocabulary[index];
+        if (![token hasPrefix:queryToken])
+        {
+            break;
+        }
+        [documentNumbers addIndexes:self.postings[token]];
+    }
+    
+    if (documentNumbers.count == 0 && queryToken.length >= kMinimumTokenLengthForFuzzyMatch)
+    {
+        // Allow for a typo, but only among tokens sharing the first character to keep the scan small
+        NSUInteger maxDistance = (queryToken.length >= kMinimumTokenLengthForTwoEdits) ? 2 : 1;
+        NSString *firstCharacter = [queryToken substringToIndex:1];
+        for (NSUInteger index = [self vocabulary:vocabulary insertionIndexOfToken:firstCharacter]; index < vocabulary.count; index++)
+        {
+            NSString *token = vocabulary[index];
+            if (![token hasPrefix:firstCharacter])
+            {
+                break;
+            }
+            if (LocalSearchBoundedEditDistance(queryToken, token, maxDistance) <= maxDistance)
+            {
+                [documentNumbers addIndexes:self.postings[token]];
+            }
+        }
+    }
+    
+    return documentNumbers;
+}
+
+- (NSArray *)vocabulary
+{
+    if (self.isVocabularyStale || !self.sortedVocabulary)
+    {
+        self.sortedVocabulary = [self.postings.allKeys sortedArrayUsingSelector:@selector(compare:)];
+        self.isVocabularyStale = NO;
+    }
+    return self.sortedVocabulary;
+}
+
+- (NSUInteger)vocabulary:(NSArray *)vocabulary insertionIndexOfToken:(NSString *)token
+{
+    return [vocabulary indexOfObject:token inSortedRange:NSMakeRange(0, vocabulary.count) options:NSBinarySearchingInsertionIndex | NSBinarySearchingFirstEqual usingComparator:^NSComparisonResult(NSString *first, NSString *second) {
+        return [first compare:second];
+    }];
+}
+
+#pragma mark - Persistence (index queue only)
+
+- (void)loadIndex
+{
+    NSData *data = [[AlfrescoFileManager sharedManager] dataWithContentsOfURL:[NSURL fileURLWithPath:self.filePath]];
+    if (!data)
+    {
+        return;
+    }
+    
+    NSDictionary *archive = nil;
+    @try
+    {
+        NSSet *classes = [NSSet setWithObjects:[NSDictionary class], [NSArray class], [NSNumber class], [NSString class], [LocalSearchIndexEntry class], nil];
+        archive = [NSKeyedUnarchiver unarchivedObjectOfClasses:classes fromData:data error:nil];
+    }
+    @catch (NSException *exception)
+    {
+        AlfrescoLogError(@"Unable to read the local search index: %@", exception.reason);
+    }
+    
+    if ([archive[kLocalSearchIndexVersionKey] integerValue] != kLocalSearchIndexVersion)
+    {
+        return;
+    }
+    
+    for (LocalSearchIndexEntry *entry in archive[kLocalSearchIndexEntriesKey])
+    {
+        [self addEntry:entry];
+    }
+}
+
+- (void)scheduleSave
+{
+    if (!self.filePath)
+    {
+        return;
+    }
+    
+    // Bursts of updates, such as a folder being synced, are written once
+    NSUInteger saveGeneration = ++self.saveGeneration;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kLocalSearchIndexSaveDelay * NSEC_PER_SEC)), self.indexQueue, ^{
+        if (saveGeneration == self.saveGeneration)
+        {
+            [self saveIndex];
+        }
+    });
+}
+
+- (void)saveIndex
+{
+    NSMutableArray *entries = [NSMutableArray arrayWithCapacity:self.documentNumbersByKey.count];
+    for (NSNumber *documentNumber in self.documentNumbersByKey.allValues)
+    {
+        [entries addObject:self.entries[documentNumber.unsignedIntegerValue]];
+    }
+    
+    NSDictionary *archive = @{kLocalSearchIndexVersionKey : @(kLocalSearchIndexVersion), kLocalSearchIndexEntriesKey : entries};
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:archive requiringSecureCoding:YES error:nil];
+    
+    NSError *error = nil;
+    [[AlfrescoFileManager sharedManager] createFileAtPath:self.filePath contents:data error:&error];
+    if (error)
+    {
+        AlfrescoLogError(@"Unable to save the local search index: %@", error.localizedDescription);
+    }
+}
+
+- (void)applicationDidEnterBackground:(NSNotification *)notification
+{
+    dispatch_async(self.indexQueue, ^{
+        if (self.saveGeneration > 0)
+        {
+            self.saveGeneration++;
+            [self saveIndex];
+        }
+    });
+}
+
+#pragma mark - Content (content queue only)
+
+- (BOOL)isTextMimeType:(NSString *)mimeType
+{
+    return [mimeType hasPrefix:@"text/"];
+}
+
+- (NSArray *)contentTokensForFileAtPath:(NSString *)contentPath
+{
+    NSData *data = [[AlfrescoFileManager sharedManager] dataWithContentsOfURL:[NSURL fileURLWithPath:contentPath]];
+    if (data.length > kMaximumContentBytes)
+    {
+        data = [data subdataWithRange:NSMakeRange(0, kMaximumContentBytes)];
+    }
+    
+    NSString *text = data ? [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] : nil;
+    if (!text && data)
+    {
+        text = [[NSString alloc] initWithData:data encoding:NSISOLatin1StringEncoding];
+    }
+    
+    NSOrderedSet *tokens = [NSOrderedSet orderedSetWithArray:[LocalSearchIndex tokensFromString:text]];
+    return (tokens.count > kMaximumContentTokens) ? [tokens.array subarrayWithRange:NSMakeRange(0, kMaximumContentTokens)] : tokens.array;
+}
+
+- (NSArray *)entriesForDownloadedDocuments
+{
+    NSMutableArray *entries = [NSMutableArray array];
+    DownloadManager *downloadManager = [DownloadManager sharedManager];
+    for (NSString *documentPath in [downloadManager downloadedDocumentPaths])
+    {
+        NSString *documentName = documentPath.lastPathComponent;
+        AlfrescoDocument *document = [downloadManager infoForDocument:documentName];
+        LocalSearchIndexEntry *entry = [LocalSearchIndexEntry entryWithNode:document identifier:documentName scope:kLocalSearchIndexDownloadsScope source:LocalSearchIndexSourceDownloaded path:nil];
+        entry.name = entry.name ?: documentName;
+        if ([self isTextMimeType:entry.mimeType])
+        {
+            entry.contentTokens = [self contentTokensForFileAtPath:documentPath];
+        }
+        [entries addObject:entry];
+    }
+    return entries;
+}
+
+- (NSArray *)entriesForSyncedNodesOfAccountWithIdentifier:(NSString *)accountIdentifier
+{
+    RealmSyncCore *syncCore = [RealmSyncCore sharedSyncCore];
+    NSString *realmPath = [syncCore configForName:accountIdentifier].fileURL.path;
+    if (![[NSFileManager defaultManager] fileExistsAtPath:realmPath])
+    {
+        return @[];
+    }
+    
+    NSMutableArray *entries = [NSMutableArray array];
+    @autoreleasepool
+    {
+        RLMRealm *realm = [syncCore realmWithIdentifier:accountIdentifier];
+        for (RealmSyncNodeInfo *nodeInfo in [syncCore allSyncNodesInRealm:realm])
+        {
+            AlfrescoNode *node = nodeInfo.alfrescoNode;
+            if (!node)
+            {
+                continue;
+            }
+            
+            LocalSearchIndexEntry *entry = [LocalSearchIndexEntry entryWithSyncNodeInfo:nodeInfo node:node scope:accountIdentifier];
+            if (nodeInfo.syncContentPath && [self isTextMimeType:entry.mimeType])
+            {
+                entry.contentTokens = [self contentTokensForFileAtPath:nodeInfo.syncContentPath];
+            }
+            [entries addObject:entry];
+        }
+    }
+    return entries;
+}
+
+@end
@@ -30,6 +30,13 @@
 - (void)attemptLoginToAccount:(UserAccount *)account
                     networkId:(NSString *)networkId
               completionBlock:(LoginAuthenticationCompletionBlock)loginCompletionBlock;
+/*
+ * Logs in without covering the window with a progress HUD, for when the account's local content is already on screen.
+ * Prompts that need the user, such as the SAML web view or the login form, are still presented.
+ */
+- (void)attemptBackgroundLoginToAccount:(UserAccount *)account
+                              networkId:(NSString *)networkId
+                        completionBlock:(LoginAuthenticationCompletionBlock)loginCompletionBlock;
 - (void)authenticateOnPremiseAccount:(UserAccount *)account
                             password:(NSString *)password
                      completionBlock:(LoginAuthenticationCompletionBlock)completionBlock;
@@ -37,6 +37,7 @@
 @property (nonatomic, strong) AlfrescoSAMLUILoginViewController *samlLoginController;
 @property (nonatomic, assign) BOOL didCancelLogin;
 @property (nonatomic, assign) BOOL completionBlockCalledFromLoginViewController;
+@property (nonatomic, assign) BOOL authenticatingInBackground;
 
 @end
 
@@ -83,6 +84,23 @@
                           completionBlock:loginCompletionBlock];
 }
 
+- (void)attemptBackgroundLoginToAccount:(UserAccount *)account
+                              networkId:(NSString *)networkId
+                        completionBlock:(LoginAuthenticationCompletionBlock)loginCompletionBlock
+{
+    self.authenticatingInBackground = YES;
+    
+    __weak typeof(self) weakSelf = self;
+    [self attemptLoginToAccount:account networkId:networkId completionBlock:^(BOOL successful, id<AlfrescoSession> alfrescoSession, NSError *error) {
+        weakSelf.authenticatingInBackground = NO;
+        
+        if (loginCompletionBlock)
+        {
+            loginCompletionBlock(successful, alfrescoSession, error);
+        }
+    }];
+}
+
 - (void)authenticateCloudAccount:(UserAccount *)account
                        networkId:(NSString *)networkId
             navigationController:(UINavigationController *)navigationController
@@ -299,6 +317,11 @@ navigationController:(UINavigationController *)navigationController
 }
 
 - (void)willBeginVisualAuthenticationProgress {
+    if (self.authenticatingInBackground)
+    {
+        return;
+    }
+    
     AppDelegate *delegate = (AppDelegate *)[[UIApplication sharedApplication] delegate];
     [self showHUDOnView:delegate.window];
 }
@@ -22,6 +22,7 @@
 #import "ConnectivityManager.h"
 #import "AccountManager.h"
 #import "Utilities.h"
+#import "AuthenticationProbeCache.h"
 
 
 @interface LoginManagerCore()
@@ -114,9 +115,9 @@
             NSString *urlString = [Utilities serverURLAddressStringFromAccount:account];
             
             __weak typeof(self) weakSelf = self;
-            [AlfrescoSAMLAuthHelper
-             checkIfSAMLIsEnabledForServerWithUrlString:urlString
-             completionBlock:^(AlfrescoSAMLData *samlData, NSError *error) {
+            [self checkIfSAMLIsEnabledForAccount:account
+                                 serverUrlString:urlString
+                                 completionBlock:^(AlfrescoSAMLData *samlData, NSError *error) {
                 __strong typeof(self) strongSelf = weakSelf;
                 
                 if ([strongSelf.delegate respondsToSelector:@selector(willEndVisualAuthenticationProgress)]) {
@@ -206,6 +207,7 @@
                                     error.code != kAlfrescoErrorCodeNoNetworkConnection &&
                                     error.code != kAlfrescoErrorCodeNetworkRequestCancelled)
                                 {
+                                    [[AuthenticationProbeCache sharedCache] invalidateResultForServerURLString:urlString];
                                     if ([weakSelf.delegate respondsToSelector:@selector(displayLoginViewControllerWithAccount:username:)])
                                     {
                                         [weakSelf.delegate displayLoginViewControllerWithAccount:account
@@ -259,6 +261,7 @@
                             if (error && error.code != kAlfrescoErrorCodeNoNetworkConnection &&
                                 error.code != kAlfrescoErrorCodeNetworkRequestCancelled)
                             {
+                                [[AuthenticationProbeCache sharedCache] invalidateResultForServerURLString:urlString];
                                 if ([weakSelf.delegate respondsToSelector:@selector(displayLoginViewControllerWithAccount:username:)])
                                 {
                                     [weakSelf.delegate displayLoginViewControllerWithAccount:account
@@ -289,6 +292,7 @@
                                 if (error)
                                 {
                                     account.samlData.samlTicket = nil;
+                                    [[AuthenticationProbeCache sharedCache] invalidateResultForServerURLString:urlString];
                                     showSAMLWebViewAndAuthenticate();
                                 }
                                 else
@@ -354,6 +358,34 @@
 
 #pragma mark - SAML Authentication Methods
 
+- (void)checkIfSAMLIsEnabledForAccount:(UserAccount *)account
+                       serverUrlString:(NSString *)urlString
+                       completionBlock:(AlfrescoSAMLAuthCompletionBlock)completionBlock
+{
+    AuthenticationProbeCache *probeCache = [AuthenticationProbeCache sharedCache];
+    AuthenticationProbeResult cachedResult = [probeCache cachedResultForServerURLString:urlString];
+    
+    // A cached SAML result can only be replayed with the SAML info saved with the account
+    if (cachedResult == AuthenticationProbeResultBasic || (cachedResult == AuthenticationProbeResultSAML && account.samlData))
+    {
+        AlfrescoSAMLData *samlData = (cachedResult == AuthenticationProbeResultSAML) ? account.samlData : nil;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionBlock(samlData, nil);
+        });
+        return;
+    }
+    
+    [AlfrescoSAMLAuthHelper checkIfSAMLIsEnabledForServerWithUrlString:urlString completionBlock:^(AlfrescoSAMLData *samlData, NSError *error) {
+        // A failed probe says nothing about the server, so it is not cached
+        if (!error)
+        {
+            [probeCache cacheResult:([samlData isSamlEnabled] ? AuthenticationProbeResultSAML : AuthenticationProbeResultBasic) forServerURLString:urlString];
+        }
+        
+        completionBlock(samlData, error);
+    }];
+}
+
 - (void)showSAMLWebViewForAccount:(UserAccount *)account
              navigationController:(UINavigationController *)navigationController
                   completionBlock:(AlfrescoSAMLAuthCompletionBlock)completionBlock
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "RealmManagerProtocol.h"
+
+typedef void (^NodePermissionsPrefetcherPermissionsBlock)(NSString *syncIdentifier, AlfrescoPermissions *permissions);
+typedef void (^NodePermissionsPrefetcherBatchCompletionBlock)(NSDictionary<NSString *, AlfrescoPermissions *> *permissionsByNodeIdentifier, NSError *error);
+
+/**
+ * The permission lookup of the SDK's document folder service, which conforms to this protocol.
+ */
+@protocol NodePermissionsPrefetcherService <NSObject>
+- (AlfrescoRequest *)retrievePermissionsOfNode:(AlfrescoNode *)node completionBlock:(AlfrescoPermissionsCompletionBlock)completionBlock;
+
+@optional
+/*
+ * Retrieves the permissions of several nodes in one request, keyed by node identifier.
+ * Services that implement it are sent up to maxNodesPerRequest nodes at a time instead of one request per node.
+ */
+- (AlfrescoRequest *)retrievePermissionsOfNodes:(NSArray<AlfrescoNode *> *)nodes completionBlock:(NodePermissionsPrefetcherBatchCompletionBlock)completionBlock;
+@end
+
+/**
+ * Retrieves the permissions of many nodes at once, for example the children of a folder listing.
+ * Results are kept in a shared in-memory cache for timeToLive seconds and identical requests already in flight are shared.
+ * Requests are queued in the order the nodes were asked for and at most maxConcurrentRequests of them run at a time.
+ * The SDK's document folder service can only look up one node per request; a service with a batched lookup is sent whole groups of nodes.
+ * Each prefetch call persists the permissions it retrieved to Realm in a single write transaction.
+ * Must be used from the main thread.
+ */
+@interface NodePermissionsPrefetcher : NSObject
+
+/// Seconds a retrieved permission stays valid in the cache. Defaults to 5 minutes.
+@property (nonatomic, assign) NSTimeInterval timeToLive;
+/// Permission requests allowed in flight at once, shared by every prefetch call. Defaults to 4.
+@property (nonatomic, assign) NSUInteger maxConcurrentRequests;
+/// Nodes sent in one request to a service with a batched lookup. Defaults to 50.
+@property (nonatomic, assign) NSUInteger maxNodesPerRequest;
+
++ (NodePermissionsPrefetcher *)sharedPrefetcher;
+- (instancetype)initWithRealmManager:(id<RealmManagerProtocol>)realmManager;
+
+/*
+ * A nil service uses the document folder service of each call's session.
+ */
+- (instancetype)initWithRealmManager:(id<RealmManagerProtocol>)realmManager service:(id<NodePermissionsPrefetcherService>)service;
+
+- (AlfrescoPermissions *)cachedPermissionsForNode:(AlfrescoNode *)node;
+
+/*
+ * The permissions block is called for each node as soon as its permissions are known, cached ones straight away.
+ * The completion block is called once every node has been resolved and the results persisted, with the permissions keyed
+ * by sync identifier. Nodes whose permissions could not be retrieved are missing from the dictionary.
+ */
+- (void)prefetchPermissionsForNodes:(NSArray<AlfrescoNode *> *)nodes
+                            session:(id<AlfrescoSession>)session
+                   permissionsBlock:(NodePermissionsPrefetcherPermissionsBlock)permissionsBlock
+                    completionBlock:(void (^)(NSDictionary<NSString *, AlfrescoPermissions *> *permissionsBySyncIdentifier))completionBlock;
+
+- (void)clearCache;
+
+@end
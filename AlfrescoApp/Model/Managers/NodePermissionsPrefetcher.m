@@ -0,0 +1,312 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "NodePermissionsPrefetcher.h"
+#import "RealmManager.h"
+#import "ConnectivityManager.h"
+
+static NSTimeInterval const kDefaultPermissionsTimeToLive = 5 * 60;
+static NSUInteger const kDefaultMaxConcurrentPermissionRequests = 4;
+static NSUInteger const kDefaultMaxNodesPerPermissionRequest = 50;
+
+@interface AlfrescoDocumentFolderService (NodePermissionsPrefetcher) <NodePermissionsPrefetcherService>
+@end
+
+@implementation AlfrescoDocumentFolderService (NodePermissionsPrefetcher)
+@end
+
+@interface NodePermissionsCacheEntry : NSObject
+@property (nonatomic, strong) AlfrescoPermissions *permissions;
+@property (nonatomic, strong) NSDate *expiryDate;
+@end
+
+@implementation NodePermissionsCacheEntry
+@end
+
+@interface NodePermissionsPrefetchBatch : NSObject
+@property (nonatomic, strong) NSMutableDictionary *permissionsBySyncIdentifier;
+@property (nonatomic, strong) NSMutableArray *retrievedNodes;
+@property (nonatomic, strong) NSMutableArray *retrievedPermissions;
+@property (nonatomic, assign) NSUInteger remainingRequestCount;
+@property (nonatomic, copy) NodePermissionsPrefetcherPermissionsBlock permissionsBlock;
+@property (nonatomic, copy) void (^completionBlock)(NSDictionary *permissionsBySyncIdentifier);
+@end
+
+@implementation NodePermissionsPrefetchBatch
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.permissionsBySyncIdentifier = [NSMutableDictionary dictionary];
+        self.retrievedNodes = [NSMutableArray array];
+        self.retrievedPermissions = [NSMutableArray array];
+    }
+    return self;
+}
+
+@end
+
+@interface NodePermissionsPrefetcher ()
+@property (nonatomic, strong) id<RealmManagerProtocol> realmManager;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NodePermissionsCacheEntry *> *cache;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray<NodePermissionsPrefetchBatch *> *> *waitingBatchesBySyncIdentifier;
+@property (nonatomic, strong) NSMutableArray<AlfrescoNode *> *pendingNodes;
+@property (nonatomic, assign) NSUInteger activeRequestCount;
+@property (nonatomic, strong) id<AlfrescoSession> session;
+@property (nonatomic, strong) id<NodePermissionsPrefetcherService> documentService;
+@property (nonatomic, assign) BOOL usesSessionService;
+@end
+
+@implementation NodePermissionsPrefetcher
+
++ (NodePermissionsPrefetcher *)sharedPrefetcher
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[self alloc] initWithRealmManager:[RealmManager sharedManager]];
+    });
+    return sharedObject;
+}
+
+- (instancetype)initWithRealmManager:(id<RealmManagerProtocol>)realmManager
+{
+    return [self initWithRealmManager:realmManager service:nil];
+}
+
+- (instancetype)initWithRealmManager:(id<RealmManagerProtocol>)realmManager service:(id<NodePermissionsPrefetcherService>)service
+{
+    self = [super init];
+    if (self)
+    {
+        self.realmManager = realmManager;
+        self.documentService = service;
+        self.usesSessionService = (service == nil);
+        self.timeToLive = kDefaultPermissionsTimeToLive;
+        self.maxConcurrentRequests = kDefaultMaxConcurrentPermissionRequests;
+        self.maxNodesPerRequest = kDefaultMaxNodesPerPermissionRequest;
+        self.cache = [NSMutableDictionary dictionary];
+        self.waitingBatchesBySyncIdentifier = [NSMutableDictionary dictionary];
+        self.pendingNodes = [NSMutableArray array];
+        
+        // Permissions belong to the user, so they can't be reused once another account logs in
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionReceivedNotification object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark - Public Methods
+
+- (AlfrescoPermissions *)cachedPermissionsForNode:(AlfrescoNode *)node
+{
+    if (!node)
+    {
+        return nil;
+    }
+    return [self cachedPermissionsForSyncIdentifier:[[RealmSyncCore sharedSyncCore] syncIdentifierForNode:node]];
+}
+
+- (void)prefetchPermissionsForNodes:(NSArray<AlfrescoNode *> *)nodes
+                            session:(id<AlfrescoSession>)session
+                   permissionsBlock:(NodePermissionsPrefetcherPermissionsBlock)permissionsBlock
+                    completionBlock:(void (^)(NSDictionary<NSString *, AlfrescoPermissions *> *permissionsBySyncIdentifier))completionBlock
+{
+    if (self.usesSessionService && session && session != self.session)
+    {
+        self.session = session;
+        self.documentService = [[AlfrescoDocumentFolderService alloc] initWithSession:session];
+    }
+    
+    NodePermissionsPrefetchBatch *batch = [NodePermissionsPrefetchBatch new];
+    batch.permissionsBlock = permissionsBlock;
+    batch.completionBlock = completionBlock;
+    
+    for (AlfrescoNode *node in nodes)
+    {
+        NSString *syncIdentifier = [[RealmSyncCore sharedSyncCore] syncIdentifierForNode:node];
+        if (!syncIdentifier || batch.permissionsBySyncIdentifier[syncIdentifier])
+        {
+            continue;
+        }
+        
+        AlfrescoPermissions *cachedPermissions = [self cachedPermissionsForSyncIdentifier:syncIdentifier];
+        if (cachedPermissions)
+        {
+            batch.permissionsBySyncIdentifier[syncIdentifier] = cachedPermissions;
+            if (permissionsBlock != NULL)
+            {
+                permissionsBlock(syncIdentifier, cachedPermissions);
+            }
+            continue;
+        }
+        
+        NSMutableArray *waitingBatches = self.waitingBatchesBySyncIdentifier[syncIdentifier];
+        if ([waitingBatches containsObject:batch])
+        {
+            continue;
+        }
+        
+        if (!waitingBatches)
+        {
+            waitingBatches = [NSMutableArray array];
+            self.waitingBatchesBySyncIdentifier[syncIdentifier] = waitingBatches;
+            [self.pendingNodes addObject:node];
+        }
+        [waitingBatches addObject:batch];
+        batch.remainingRequestCount++;
+    }
+    
+    if (batch.remainingRequestCount == 0)
+    {
+        [self finishBatch:batch];
+    }
+    else
+    {
+        [self startPendingRequests];
+    }
+}
+
+- (void)clearCache
+{
+    [self.cache removeAllObjects];
+}
+
+#pragma mark - Private Methods
+
+- (AlfrescoPermissions *)cachedPermissionsForSyncIdentifier:(NSString *)syncIdentifier
+{
+    NodePermissionsCacheEntry *entry = self.cache[syncIdentifier];
+    if (entry && [entry.expiryDate timeIntervalSinceNow] <= 0)
+    {
+        [self.cache removeObjectForKey:syncIdentifier];
+        entry = nil;
+    }
+    return entry.permissions;
+}
+
+- (void)startPendingRequests
+{
+    BOOL isReachable = !self.usesSessionService || [[ConnectivityManager sharedManager] hasInternetConnection];
+    if (!self.documentService || !isReachable)
+    {
+        NSArray *unreachableNodes = [self.pendingNodes copy];
+        [self.pendingNodes removeAllObjects];
+        for (AlfrescoNode *node in unreachableNodes)
+        {
+            [self didRetrievePermissions:nil forNode:node];
+        }
+        return;
+    }
+    
+    BOOL canBatch = [self.documentService respondsToSelector:@selector(retrievePermissionsOfNodes:completionBlock:)];
+    while (self.activeRequestCount < self.maxConcurrentRequests && self.pendingNodes.count > 0)
+    {
+        NSUInteger nodeCount = canBatch ? MIN(MAX(self.maxNodesPerRequest, 1), self.pendingNodes.count) : 1;
+        NSArray *nodes = [self.pendingNodes subarrayWithRange:NSMakeRange(0, nodeCount)];
+        [self.pendingNodes removeObjectsInRange:NSMakeRange(0, nodeCount)];
+        self.activeRequestCount++;
+        
+        if (canBatch)
+        {
+            [self.documentService retrievePermissionsOfNodes:nodes completionBlock:^(NSDictionary<NSString *, AlfrescoPermissions *> *permissionsByNodeIdentifier, NSError *error) {
+                self.activeRequestCount--;
+                for (AlfrescoNode *node in nodes)
+                {
+                    [self didRetrievePermissions:permissionsByNodeIdentifier[node.identifier] forNode:node];
+                }
+                [self startPendingRequests];
+            }];
+        }
+        else
+        {
+            AlfrescoNode *node = nodes.firstObject;
+            [self.documentService retrievePermissionsOfNode:node completionBlock:^(AlfrescoPermissions *permissions, NSError *error) {
+                self.activeRequestCount--;
+                [self didRetrievePermissions:permissions forNode:node];
+                [self startPendingRequests];
+            }];
+        }
+    }
+}
+
+- (void)didRetrievePermissions:(AlfrescoPermissions *)permissions forNode:(AlfrescoNode *)node
+{
+    NSString *syncIdentifier = [[RealmSyncCore sharedSyncCore] syncIdentifierForNode:node];
+    if (permissions)
+    {
+        NodePermissionsCacheEntry *entry = [NodePermissionsCacheEntry new];
+        entry.permissions = permissions;
+        entry.expiryDate = [NSDate dateWithTimeIntervalSinceNow:self.timeToLive];
+        self.cache[syncIdentifier] = entry;
+    }
+    
+    NSArray *waitingBatches = self.waitingBatchesBySyncIdentifier[syncIdentifier];
+    [self.waitingBatchesBySyncIdentifier removeObjectForKey:syncIdentifier];
+    
+    [waitingBatches enumerateObjectsUsingBlock:^(NodePermissionsPrefetchBatch *batch, NSUInteger index, BOOL *stop) {
+        if (permissions)
+        {
+            batch.permissionsBySyncIdentifier[syncIdentifier] = permissions;
+            if (batch.permissionsBlock != NULL)
+            {
+                batch.permissionsBlock(syncIdentifier, permissions);
+            }
+            // Only the batch that asked first persists the result
+            if (index == 0)
+            {
+                [batch.retrievedNodes addObject:node];
+                [batch.retrievedPermissions addObject:permissions];
+            }
+        }
+        
+        batch.remainingRequestCount--;
+        if (batch.remainingRequestCount == 0)
+        {
+            [self finishBatch:batch];
+        }
+    }];
+}
+
+- (void)finishBatch:(NodePermissionsPrefetchBatch *)batch
+{
+    if (batch.retrievedNodes.count > 0)
+    {
+        [self.realmManager savePermissions:batch.retrievedPermissions forNodes:batch.retrievedNodes];
+    }
+    
+    if (batch.completionBlock != NULL)
+    {
+        batch.completionBlock(batch.permissionsBySyncIdentifier);
+    }
+}
+
+#pragma mark - Notification Handlers
+
+- (void)sessionReceived:(NSNotification *)notification
+{
+    [self clearCache];
+}
+
+@end
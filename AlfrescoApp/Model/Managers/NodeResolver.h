@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+typedef void (^NodeResolverCompletionBlock)(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error);
+
+/**
+ * Looks up nodes and their permissions. The resolver uses the repository's document folder service by default; tests
+ * use a stub.
+ */
+@protocol NodeResolverService <NSObject>
+
+- (AlfrescoRequest *)retrieveNodeWithIdentifier:(NSString *)identifier completionBlock:(AlfrescoNodeCompletionBlock)completionBlock;
+- (AlfrescoRequest *)retrievePermissionsOfNode:(AlfrescoNode *)node completionBlock:(AlfrescoPermissionsCompletionBlock)completionBlock;
+
+@end
+
+/**
+ * Resolves node identifiers, such as those of activities, into nodes and their permissions.
+ *
+ * Only the identifier is needed to ask for permissions, so the node and its permissions are requested at the same time.
+ * Results are shared by every caller for timeToLive seconds, and a request already in flight for an identifier is joined
+ * rather than repeated. Warming resolves a few identifiers speculatively, e.g. those of the rows on screen, so that
+ * opening one of them is immediate. When the session changes to another account or repository, nothing resolved for the
+ * previous one is reused, and callers still waiting on its lookups are answered with a cancellation error.
+ * Must be used from the main thread; completion blocks are called on the main thread.
+ */
+@interface NodeResolver : NSObject
+
+/// Seconds a resolved node stays valid. Defaults to 5 minutes.
+@property (nonatomic, assign) NSTimeInterval timeToLive;
+/// Maximum number of identifiers being warmed at the same time. Defaults to 3.
+@property (nonatomic, assign) NSUInteger maximumConcurrentWarmingRequests;
+
++ (NodeResolver *)sharedResolver;
+
+/*
+ * A nil service uses the document folder service of each call's session.
+ */
+- (instancetype)initWithService:(id<NodeResolverService>)service;
+
+- (void)resolveNodeWithIdentifier:(NSString *)identifier session:(id<AlfrescoSession>)session completionBlock:(NodeResolverCompletionBlock)completionBlock;
+
+/*
+ * Replaces any identifiers still waiting to be warmed with these ones.
+ */
+- (void)warmNodesWithIdentifiers:(NSArray<NSString *> *)identifiers session:(id<AlfrescoSession>)session;
+
+- (void)clearCache;
+
+@end
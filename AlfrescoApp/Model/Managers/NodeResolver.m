@@ -0,0 +1,293 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+ 
+#import "NodeResolver.h"
+
+static NSTimeInterval const kDefaultNodeResolverTimeToLive = 5 * 60;
+static NSUInteger const kDefaultMaximumConcurrentWarmingRequests = 3;
+static NSUInteger const kMaximumResolvedNodesInMemory = 200;
+
+// The SDK's document folder service already implements the methods the resolver needs
+@interface AlfrescoDocumentFolderService (NodeResolver) <NodeResolverService>
+@end
+
+@implementation AlfrescoDocumentFolderService (NodeResolver)
+@end
+
+@interface NodeResolverCacheEntry : NSObject
+@property (nonatomic, strong) AlfrescoNode *node;
+@property (nonatomic, strong) AlfrescoPermissions *permissions;
+@property (nonatomic, strong) NSDate *expiryDate;
+@end
+
+@implementation NodeResolverCacheEntry
+@end
+
+@interface NodeResolver ()
+@property (nonatomic, strong) id<NodeResolverService> service;
+@property (nonatomic, assign) BOOL usesSessionService;
+@property (nonatomic, strong) id<AlfrescoSession> session;
+// Changes with the account, so that lookups made for a previous one can be told apart when they finish
+@property (nonatomic, assign) NSUInteger sessionGeneration;
+@property (nonatomic, strong) NSCache *cache;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray *> *completionBlocksByIdentifier;
+@property (nonatomic, strong) NSMutableOrderedSet<NSString *> *identifiersToWarm;
+@property (nonatomic, assign) NSUInteger activeWarmingRequestCount;
+@end
+
+@implementation NodeResolver
+
++ (NodeResolver *)sharedResolver
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[self alloc] initWithService:nil];
+    });
+    return sharedObject;
+}
+
+- (instancetype)initWithService:(id<NodeResolverService>)service
+{
+    self = [super init];
+    if (self)
+    {
+        self.service = service;
+        self.usesSessionService = (service == nil);
+        self.timeToLive = kDefaultNodeResolverTimeToLive;
+        self.maximumConcurrentWarmingRequests = kDefaultMaximumConcurrentWarmingRequests;
+        self.cache = [[NSCache alloc] init];
+        self.cache.countLimit = kMaximumResolvedNodesInMemory;
+        self.completionBlocksByIdentifier = [NSMutableDictionary dictionary];
+        self.identifiersToWarm = [NSMutableOrderedSet orderedSet];
+        
+        // Permissions belong to the user, so they can't be reused once another account logs in
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionReceivedNotification object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark - Public Methods
+
+- (void)resolveNodeWithIdentifier:(NSString *)identifier session:(id<AlfrescoSession>)session completionBlock:(NodeResolverCompletionBlock)completionBlock
+{
+    [self updateSession:session];
+    
+    if (!identifier)
+    {
+        completionBlock(nil, nil, nil);
+        return;
+    }
+    
+    NodeResolverCacheEntry *entry = [self cachedEntryForIdentifier:identifier];
+    if (entry)
+    {
+        completionBlock(entry.node, entry.permissions, nil);
+        return;
+    }
+    
+    // A tap on a row being warmed doesn't need to wait for its turn
+    [self.identifiersToWarm removeObject:identifier];
+    [self resolveIdentifier:identifier completionBlock:completionBlock];
+}
+
+- (void)warmNodesWithIdentifiers:(NSArray<NSString *> *)identifiers session:(id<AlfrescoSession>)session
+{
+    [self updateSession:session];
+    
+    [self.identifiersToWarm removeAllObjects];
+    for (NSString *identifier in identifiers)
+    {
+        if (![self cachedEntryForIdentifier:identifier] && !self.completionBlocksByIdentifier[identifier])
+        {
+            [self.identifiersToWarm addObject:identifier];
+        }
+    }
+    [self startWarmingRequests];
+}
+
+- (void)clearCache
+{
+    [self.cache removeAllObjects];
+    [self.identifiersToWarm removeAllObjects];
+}
+
+#pragma mark - Private Methods
+
+- (void)sessionReceived:(NSNotification *)notification
+{
+    [self updateSession:notification.object];
+}
+
+- (void)updateSession:(id<AlfrescoSession>)session
+{
+    if (!session || [self.session isEqual:session])
+    {
+        return;
+    }
+    
+    // A refreshed session for the same account keeps what has been resolved and what is still in flight
+    BOOL accountChanged = self.session && ![self session:self.session belongsToSameAccountAsSession:session];
+    self.session = session;
+    
+    if (self.usesSessionService)
+    {
+        self.service = [[AlfrescoDocumentFolderService alloc] initWithSession:session];
+    }
+    
+    if (accountChanged)
+    {
+        self.sessionGeneration++;
+        [self clearCache];
+        
+        // Callers waiting on the previous account's lookups are told they won't be answered
+        NSDictionary<NSString *, NSMutableArray *> *pendingCompletionBlocks = [self.completionBlocksByIdentifier copy];
+        [self.completionBlocksByIdentifier removeAllObjects];
+        NSError *cancelledError = [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeNetworkRequestCancelled];
+        for (NSArray *completionBlocks in pendingCompletionBlocks.allValues)
+        {
+            for (NodeResolverCompletionBlock completionBlock in completionBlocks)
+            {
+                completionBlock(nil, nil, cancelledError);
+            }
+        }
+    }
+}
+
+- (BOOL)session:(id<AlfrescoSession>)session belongsToSameAccountAsSession:(id<AlfrescoSession>)otherSession
+{
+    return [session.personIdentifier isEqualToString:otherSession.personIdentifier] && [session.repositoryInfo.identifier isEqualToString:otherSession.repositoryInfo.identifier];
+}
+
+- (NodeResolverCacheEntry *)cachedEntryForIdentifier:(NSString *)identifier
+{
+    NodeResolverCacheEntry *entry = [self.cache objectForKey:identifier];
+    if (entry && [entry.expiryDate timeIntervalSinceNow] <= 0)
+    {
+        [self.cache removeObjectForKey:identifier];
+        entry = nil;
+    }
+    return entry;
+}
+
+- (void)startWarmingRequests
+{
+    while (self.identifiersToWarm.count > 0 && self.activeWarmingRequestCount < self.maximumConcurrentWarmingRequests)
+    {
+        NSString *identifier = self.identifiersToWarm.firstObject;
+        [self.identifiersToWarm removeObjectAtIndex:0];
+        
+        self.activeWarmingRequestCount++;
+        [self resolveIdentifier:identifier completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+            self.activeWarmingRequestCount--;
+            [self startWarmingRequests];
+        }];
+    }
+}
+
+- (void)resolveIdentifier:(NSString *)identifier completionBlock:(NodeResolverCompletionBlock)completionBlock
+{
+    NSMutableArray *completionBlocks = self.completionBlocksByIdentifier[identifier];
+    if (completionBlocks)
+    {
+        [completionBlocks addObject:[completionBlock copy]];
+        return;
+    }
+    self.completionBlocksByIdentifier[identifier] = [NSMutableArray arrayWithObject:[completionBlock copy]];
+    
+    id<NodeResolverService> service = self.service;
+    NSUInteger sessionGeneration = self.sessionGeneration;
+    if (!service)
+    {
+        [self finishResolvingIdentifier:identifier sessionGeneration:sessionGeneration node:nil permissions:nil error:nil];
+        return;
+    }
+    
+    __block AlfrescoNode *resolvedNode = nil;
+    __block AlfrescoPermissions *resolvedPermissions = nil;
+    __block NSError *nodeError = nil;
+    __block NSUInteger remainingRequestCount = 2;
+    
+    void (^requestFinished)(void) = ^{
+        if (--remainingRequestCount > 0)
+        {
+            return;
+        }
+        
+        if (resolvedNode && !resolvedPermissions)
+        {
+            // Fall back to asking with the node itself
+            [service retrievePermissionsOfNode:resolvedNode completionBlock:^(AlfrescoPermissions *permissions, NSError *permissionsError) {
+                [self finishResolvingIdentifier:identifier sessionGeneration:sessionGeneration node:resolvedNode permissions:permissions error:permissionsError];
+            }];
+        }
+        else
+        {
+            [self finishResolvingIdentifier:identifier sessionGeneration:sessionGeneration node:resolvedNode permissions:resolvedPermissions error:nodeError];
+        }
+    };
+    
+    [service retrieveNodeWithIdentifier:identifier completionBlock:^(AlfrescoNode *node, NSError *error) {
+        resolvedNode = node;
+        nodeError = error;
+        requestFinished();
+    }];
+    
+    // Permissions are looked up by identifier, so a node holding only the identifier is enough to ask for them
+    AlfrescoNode *identifierOnlyNode = [[AlfrescoNode alloc] initWithProperties:@{kCMISPropertyObjectId : identifier}];
+    [service retrievePermissionsOfNode:identifierOnlyNode completionBlock:^(AlfrescoPermissions *permissions, NSError *error) {
+        resolvedPermissions = permissions;
+        requestFinished();
+    }];
+}
+
+- (void)finishResolvingIdentifier:(NSString *)identifier sessionGeneration:(NSUInteger)sessionGeneration node:(AlfrescoNode *)node permissions:(AlfrescoPermissions *)permissions error:(NSError *)error
+{
+    if (sessionGeneration != self.sessionGeneration)
+    {
+        return;
+    }
+    
+    if (node && permissions)
+    {
+        NodeResolverCacheEntry *entry = [NodeResolverCacheEntry new];
+        entry.node = node;
+        entry.permissions = permissions;
+        entry.expiryDate = [NSDate dateWithTimeIntervalSinceNow:self.timeToLive];
+        [self.cache setObject:entry forKey:identifier];
+    }
+    else
+    {
+        node = nil;
+        permissions = nil;
+    }
+    
+    NSArray *completionBlocks = self.completionBlocksByIdentifier[identifier];
+    [self.completionBlocksByIdentifier removeObjectForKey:identifier];
+    for (NodeResolverCompletionBlock completionBlock in completionBlocks)
+    {
+        completionBlock(node, permissions, error);
+    }
+}
+
+@end
@@ -22,6 +22,7 @@
 #import "AlfrescoNode+Sync.h"
 #import "AccountManager.h"
 #import "RealmSyncManager+CoreDataMigration.h"
+#import "LocalSearchIndex.h"
 
 @interface RealmManager()
 @property (nonatomic, strong) RLMRealm *mainThreadRealm;
@@ -97,6 +98,7 @@
     }
     
     _mainThreadRealm = nil;
+    [[LocalSearchIndex sharedIndex] removeAllEntriesInScope:realmName];
 }
 
 - (RLMRealm *)realmForCurrentThread
@@ -120,6 +122,17 @@
     [self createMainThreadRealmWithCompletionBlock:completionBlock];
 }
 
+- (void)restoreDefaultConfigurationForAccount:(UserAccount *)account
+{
+    [RLMRealmConfiguration setDefaultConfiguration:[[RealmSyncCore sharedSyncCore] configForName:account.accountIdentifier]];
+    
+    // Opened synchronously so views built straight after read the account's realm rather than the default one
+    if ([NSThread isMainThread])
+    {
+        self.mainThreadRealm = [[RealmSyncCore sharedSyncCore] realmWithIdentifier:account.accountIdentifier];
+    }
+}
+
 - (void)resetDefaultRealmConfiguration
 {
     RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
@@ -142,10 +155,36 @@
     }
 }
 
+- (void)savePermissions:(NSArray<AlfrescoPermissions *> *)permissions forNodes:(NSArray<AlfrescoNode *> *)nodes
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSMutableArray *nodeInfos = [NSMutableArray arrayWithCapacity:nodes.count];
+    NSMutableArray *nodeInfoPermissions = [NSMutableArray arrayWithCapacity:nodes.count];
+    
+    [nodes enumerateObjectsUsingBlock:^(AlfrescoNode *node, NSUInteger index, BOOL *stop) {
+        RealmSyncNodeInfo *nodeInfo = [[RealmSyncCore sharedSyncCore] syncNodeInfoForObject:node ifNotExistsCreateNew:NO inRealm:realm];
+        if(nodeInfo && !nodeInfo.invalidated)
+        {
+            [nodeInfos addObject:nodeInfo];
+            [nodeInfoPermissions addObject:permissions[index]];
+        }
+    }];
+    
+    if(nodeInfos.count > 0)
+    {
+        [realm beginWriteTransaction];
+        [nodeInfos enumerateObjectsUsingBlock:^(RealmSyncNodeInfo *nodeInfo, NSUInteger index, BOOL *stop) {
+            nodeInfo.permissions = [NSKeyedArchiver archivedDataWithRootObject:nodeInfoPermissions[index]];
+        }];
+        [realm commitWriteTransaction];
+    }
+}
+
 - (void)deleteRealmObject:(RLMObject *)objectToDelete inRealm:(RLMRealm *)realm
 {
     if(objectToDelete)
     {
+        [self removeSearchIndexEntriesForObjects:@[objectToDelete] inRealm:realm];
         [realm beginWriteTransaction];
         [realm deleteObject:objectToDelete];
         [realm commitWriteTransaction];
@@ -154,6 +193,7 @@
 
 - (void)deleteRealmObjects:(NSArray *)objectsToDelete inRealm:(RLMRealm *)realm
 {
+    [self removeSearchIndexEntriesForObjects:objectsToDelete inRealm:realm];
     [realm beginWriteTransaction];
     for(RLMObject *object in objectsToDelete)
     {
@@ -173,6 +213,18 @@
     [realm commitWriteTransaction];
 }
 
+- (void)removeSearchIndexEntriesForObjects:(id<NSFastEnumeration>)objects inRealm:(RLMRealm *)realm
+{
+    NSString *accountIdentifier = [[RealmSyncCore sharedSyncCore] accountIdentifierForRealm:realm];
+    for (RLMObject *object in objects)
+    {
+        if ([object isKindOfClass:[RealmSyncNodeInfo class]] && !object.isInvalidated)
+        {
+            [[LocalSearchIndex sharedIndex] removeEntryWithIdentifier:((RealmSyncNodeInfo *)object).syncNodeInfoId scope:accountIdentifier];
+        }
+    }
+}
+
 - (void)resolvedObstacleForDocument:(AlfrescoDocument *)document inRealm:(RLMRealm *)realm
 {
     // once sync problem is resolved (document synced or saved) set its isUnfavoritedHasLocalChanges flag to NO so node is deleted later
@@ -26,11 +26,13 @@
 - (RLMRealm *)realmForCurrentThread;
 
 - (void)savePermissions:(AlfrescoPermissions *)permissions forNode:(AlfrescoNode *)node;
+- (void)savePermissions:(NSArray<AlfrescoPermissions *> *)permissions forNodes:(NSArray<AlfrescoNode *> *)nodes;
 
 - (void)deleteRealmObject:(RLMObject *)objectToDelete inRealm:(RLMRealm *)realm;
 - (void)deleteRealmObjects:(NSArray *)objectsToDelete inRealm:(RLMRealm *)realm;
 
 - (void)changeDefaultConfigurationForAccount:(UserAccount *)account completionBlock:(void (^)(void))completionBlock;
+- (void)restoreDefaultConfigurationForAccount:(UserAccount *)account;
 - (void)resetDefaultRealmConfiguration;
 
 - (void)resolvedObstacleForDocument:(AlfrescoDocument *)document inRealm:(RLMRealm *)realm;
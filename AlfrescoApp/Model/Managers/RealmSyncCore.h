@@ -34,6 +34,7 @@ typedef NS_ENUM(NSUInteger, NodesType) {
 
 - (RLMRealm *)realmWithIdentifier:(NSString *)identifier;
 - (RLMRealmConfiguration *)configForName:(NSString *)name;
+- (NSString *)accountIdentifierForRealm:(RLMRealm *)realm;
 
 - (RLMResults *)allSyncNodesInRealm:(RLMRealm *)realm;
 - (RLMResults *)topLevelSyncNodesInRealm:(RLMRealm *)realm;
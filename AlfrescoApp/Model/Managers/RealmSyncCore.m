@@ -20,6 +20,7 @@
 #import "AlfrescoFileManager+Extensions.h"
 #import "SyncConstants.h"
 #import "AlfrescoNode+Utilities.h"
+#import "LocalSearchIndex.h"
 
 @implementation RealmSyncCore
 
@@ -51,6 +52,12 @@
     return realm;
 }
 
+- (NSString *)accountIdentifierForRealm:(RLMRealm *)realm
+{
+    // Account realms are named after the account identifier, see configForName:
+    return realm.configuration.fileURL.lastPathComponent.stringByDeletingPathExtension;
+}
+
 - (RLMRealmConfiguration *)configForName:(NSString *)name
 {
     RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
@@ -254,6 +261,13 @@
         syncNodeInfo.syncContentPath = syncContentPath;
     }
     [realm commitWriteTransaction];
+    
+    AlfrescoNode *indexedNode = node ?: syncNodeInfo.alfrescoNode;
+    if (indexedNode)
+    {
+        LocalSearchIndexEntry *entry = [LocalSearchIndexEntry entryWithSyncNodeInfo:syncNodeInfo node:indexedNode scope:[self accountIdentifierForRealm:realm]];
+        [[LocalSearchIndex sharedIndex] indexEntry:entry contentPath:syncNodeInfo.syncContentPath];
+    }
 }
 
 - (void)didUploadNode:(AlfrescoNode *)node fromPath:(NSString *)tempPath toFolder:(AlfrescoFolder *)folder forAccountIdentifier:(NSString *)accountIdentifier
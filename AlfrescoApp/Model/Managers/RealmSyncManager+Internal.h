@@ -19,8 +19,9 @@
 #import "RealmSyncManager.h"
 #import "AccountManager.h"
 #import "ConnectivityManager.h"
+#import "SyncProgressEventBus.h"
 
-@interface RealmSyncManager()
+@interface RealmSyncManager() <SyncProgressObserver>
 
 @property (nonatomic, strong) AlfrescoFileManager *fileManager;
 @property (nonatomic, strong) AlfrescoDocumentFolderService *documentFolderService;
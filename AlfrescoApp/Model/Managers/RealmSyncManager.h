@@ -82,6 +82,10 @@ typedef NS_ENUM(NSInteger, DeleteRule)
 - (void)deleteRealmForAccount:(UserAccount *)account;
 - (void)disableSyncForAccount:(UserAccount*)account fromViewController:(UIViewController *)presentingViewController cancelBlock:(void (^)(void))cancelBlock completionBlock:(void (^)(void))completionBlock;
 - (void)enableSyncForAccount:(UserAccount *)account;
+/*
+ * Points sync at the account's local realm without waiting for a session, so synced content is available while logging in or offline.
+ */
+- (void)restoreLocalStateForAccount:(UserAccount *)account;
 - (void)cleanUpAccount:(UserAccount *)account cancelOperationsType:(CancelOperationsType)cancelType;
 
 /**
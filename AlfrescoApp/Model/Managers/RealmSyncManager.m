@@ -58,7 +58,7 @@
         
         _unsyncCompletionBlocks = [NSMutableDictionary new];
         
-        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(statusChanged:) name:kSyncStatusChangeNotification object:nil];
+        [[SyncProgressEventBus sharedBus] addObserverForAllNodes:self];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(selectedProfileDidChange:) name:kAlfrescoConfigProfileDidChangeNotification object:nil];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionReceivedNotification object:nil];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionReceived:) name:kAlfrescoSessionRefreshedNotification object:nil];
@@ -209,6 +209,16 @@
     [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoAccountUpdatedNotification object:account];
 }
 
+- (void)restoreLocalStateForAccount:(UserAccount *)account
+{
+    if (account)
+    {
+        // The session, sync queue and refresh are set up once the account has authenticated, see sessionReceived:
+        [[RealmManager sharedManager] restoreDefaultConfigurationForAccount:account];
+        self.selectedAccountSyncIdentifier = account.accountIdentifier;
+    }
+}
+
 #pragma mark - Sync operations
 - (void)deleteNodeFromSync:(AlfrescoNode *)node deleteRule:(DeleteRule)deleteRule withCompletionBlock:(void (^)(BOOL savedLocally))completionBlock
 {
@@ -960,66 +970,74 @@
     }
 }
 
-- (void)statusChanged:(NSNotification *)notification
+#pragma mark - SyncProgressObserver
+
+- (void)didReceiveSyncProgressEvents:(NSArray<SyncProgressEvent *> *)events
 {
-    NSDictionary *info = notification.userInfo;
-    RLMRealm *realm = [[RealmManager sharedManager] realmForCurrentThread];
+    RLMRealm *realm = nil;
     UserAccount *selectedAccount = [AccountManager sharedManager].selectedAccount;
+    SyncOperationQueue *syncOpQ = self.syncQueues[selectedAccount.accountIdentifier];
     
-    SyncNodeStatus *nodeStatus = notification.object;
-    NSString *propertyChanged = [info objectForKey:kSyncStatusPropertyChangedKey];
-    
+    for (SyncProgressEvent *event in events)
+    {
+        // Only status changes affect the parent folders; progress ticks don't need the persistence layer
+        if ([event.changedProperties containsObject:kSyncStatus])
+        {
+            realm = realm ?: [[RealmManager sharedManager] realmForCurrentThread];
+            [self statusChangedForNodeStatus:event.nodeStatus inRealm:realm syncOperationQueue:syncOpQ];
+        }
+    }
+}
+
+- (void)statusChangedForNodeStatus:(SyncNodeStatus *)nodeStatus inRealm:(RLMRealm *)realm syncOperationQueue:(SyncOperationQueue *)syncOpQ
+{
     RealmSyncNodeInfo *nodeInfo = [[RealmSyncCore sharedSyncCore] syncNodeInfoForId:nodeStatus.nodeId inRealm:realm];
     RealmSyncNodeInfo *parentNodeInfo = nodeInfo.parentNode;
-    SyncOperationQueue *syncOpQ = self.syncQueues[selectedAccount.accountIdentifier];
-    if ([propertyChanged isEqualToString:kSyncStatus])
+    if (parentNodeInfo)
     {
-        if (parentNodeInfo)
+        NSString *parentNodeId = parentNodeInfo.syncNodeInfoId;
+        SyncNodeStatus *parentNodeStatus = [syncOpQ syncNodeStatusObjectForNodeWithId:parentNodeId];
+        RLMLinkingObjects *subNodes = parentNodeInfo.nodes;
+        
+        SyncStatus syncStatus = SyncStatusSuccessful;
+        for (RealmSyncNodeInfo *subNodeInfo in subNodes)
         {
-            NSString *parentNodeId = parentNodeInfo.syncNodeInfoId;
-            SyncNodeStatus *parentNodeStatus = [syncOpQ syncNodeStatusObjectForNodeWithId:parentNodeId];
-            RLMLinkingObjects *subNodes = parentNodeInfo.nodes;
+            SyncNodeStatus *subNodeStatus = [syncOpQ syncNodeStatusObjectForNodeWithId:subNodeInfo.syncNodeInfoId];
             
-            SyncStatus syncStatus = SyncStatusSuccessful;
-            for (RealmSyncNodeInfo *subNodeInfo in subNodes)
+            if (subNodeStatus.status == SyncStatusLoading)
             {
-                SyncNodeStatus *subNodeStatus = [syncOpQ syncNodeStatusObjectForNodeWithId:subNodeInfo.syncNodeInfoId];
-                
-                if (subNodeStatus.status == SyncStatusLoading)
-                {
-                    syncStatus = SyncStatusLoading;
-                    break;
-                }
-                else if (subNodeStatus.status == SyncStatusFailed)
-                {
-                    syncStatus = SyncStatusFailed;
-                    break;
-                }
-                else if (subNodeStatus.status == SyncStatusOffline)
-                {
-                    syncStatus = SyncStatusOffline;
-                    parentNodeStatus.activityType = SyncActivityTypeUpload;
-                    break;
-                }
-                else if (subNodeStatus.status == SyncStatusWaiting)
-                {
-                    syncStatus = SyncStatusWaiting;
-                }
+                syncStatus = SyncStatusLoading;
+                break;
+            }
+            else if (subNodeStatus.status == SyncStatusFailed)
+            {
+                syncStatus = SyncStatusFailed;
+                break;
             }
-            parentNodeStatus.status = syncStatus;
-            //compute the size based on child nodes
-            unsigned long long totalParentSize = 0;
-            for (RealmSyncNodeInfo *subNodeInfo in subNodes)
+            else if (subNodeStatus.status == SyncStatusOffline)
             {
-                SyncNodeStatus *subNodeStatus = [syncOpQ syncNodeStatusObjectForNodeWithId:subNodeInfo.syncNodeInfoId];
-                totalParentSize += subNodeStatus.totalSize;
+                syncStatus = SyncStatusOffline;
+                parentNodeStatus.activityType = SyncActivityTypeUpload;
+                break;
+            }
+            else if (subNodeStatus.status == SyncStatusWaiting)
+            {
+                syncStatus = SyncStatusWaiting;
             }
-            parentNodeStatus.totalSize = totalParentSize;
         }
-        else if((nodeInfo.isTopLevelSyncNode) && (nodeInfo.isFolder) && (nodeStatus.status == SyncStatusSuccessful))
+        parentNodeStatus.status = syncStatus;
+        //compute the size based on child nodes
+        unsigned long long totalParentSize = 0;
+        for (RealmSyncNodeInfo *subNodeInfo in subNodes)
         {
-            [syncOpQ resetSyncProgressInformationForNode:nodeInfo.alfrescoNode];
+            SyncNodeStatus *subNodeStatus = [syncOpQ syncNodeStatusObjectForNodeWithId:subNodeInfo.syncNodeInfoId];
+            totalParentSize += subNodeStatus.totalSize;
         }
+        parentNodeStatus.totalSize = totalParentSize;
+    }
+    else if((nodeInfo.isTopLevelSyncNode) && (nodeInfo.isFolder) && (nodeStatus.status == SyncStatusSuccessful))
+    {
+        [syncOpQ resetSyncProgressInformationForNode:nodeInfo.alfrescoNode];
     }
 }
 
@@ -26,6 +26,7 @@
 #import "AccountManager.h"
 #import "CoreDataCacheHelper.h"
 #import "DownloadManager.h"
+#import "DocumentPreviewManager.h"
 #import "TouchIDManager.h"
 
 #define BLANK_SCREEN_TAG 234
@@ -67,6 +68,8 @@
 
 - (void)addObservers
 {
+    // Setup can run more than once, e.g. when the launch stages are measured, and each notification should only be handled once
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationDidEnterBackgroundNotification:) name:UIApplicationDidEnterBackgroundNotification object:nil];
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationWillEnterForegroundNotification:) name:UIApplicationWillEnterForegroundNotification object:nil];
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(firstPaidAccountAdded:) name:kAlfrescoFirstPaidAccountAddedNotification object:nil];
@@ -189,6 +192,8 @@
     [cacheHelper removeAllDocumentPreviewImageDataInManagedObjectContext:nil];
     // Remove downloads
     [[DownloadManager sharedManager] removeAllDownloads];
+    // Remove previewed documents
+    [[DocumentPreviewManager sharedManager] removeAllCachedDocuments];
     // Remove all contents of the temp folder
     [[AlfrescoFileManager sharedManager] clearTemporaryDirectory];
     
@@ -1518,87 +1518,6 @@
     }
 }
 
-#pragma mark - Status Changed Notification Handling
-
-- (void)statusChanged:(NSNotification *)notification
-{
-    NSDictionary *info = notification.userInfo;
-    NSManagedObjectContext *privateManagedObjectContext = [self.syncCoreDataHelper createChildManagedObjectContext];
-    
-    SyncNodeStatus *nodeStatus = notification.object;
-    NSString *propertyChanged = [info objectForKey:kSyncStatusPropertyChangedKey];
-    
-    // update total size for parent folder
-    if ([propertyChanged isEqualToString:kSyncTotalSize])
-    {
-        SyncNodeInfo *nodeInfo = [self.syncCoreDataHelper nodeInfoForObjectWithNodeId:nodeStatus.nodeId inAccountWithId:self.selectedAccountIdentifier inManagedObjectContext:privateManagedObjectContext];
-        
-        SyncNodeInfo *parentNodeInfo = nodeInfo.parentNode;
-        if (parentNodeInfo)
-        {
-            AlfrescoNode *parentNode = [NSKeyedUnarchiver unarchiveObjectWithData:parentNodeInfo.node];
-            SyncNodeStatus *parentNodeStatus = [self syncStatusForNodeWithId:[self.syncHelper syncIdentifierForNode:parentNode]];
-            
-            NSDictionary *change = [info objectForKey:kSyncStatusChangeKey];
-            parentNodeStatus.totalSize += nodeStatus.totalSize - [[change valueForKey:NSKeyValueChangeOldKey] longLongValue];
-        }
-        else
-        {
-            // if parent folder is nil - update total size for account
-            SyncNodeStatus *accountSyncStatus = [self.syncHelper syncNodeStatusObjectForNodeWithId:self.selectedAccountIdentifier inSyncNodesStatus:self.syncNodesStatus];
-            if (nodeStatus != accountSyncStatus)
-            {
-                NSDictionary *change = [info objectForKey:kSyncStatusChangeKey];
-                accountSyncStatus.totalSize += nodeStatus.totalSize - [[change valueForKey:NSKeyValueChangeOldKey] longLongValue];
-            }
-        }
-    }
-    // update sync status for folder depending on its child nodes statuses
-    else if ([propertyChanged isEqualToString:kSyncStatus])
-    {
-        SyncNodeInfo *nodeInfo = [self.syncCoreDataHelper nodeInfoForObjectWithNodeId:nodeStatus.nodeId inAccountWithId:self.selectedAccountIdentifier inManagedObjectContext:privateManagedObjectContext];
-        SyncNodeInfo *parentNodeInfo = nodeInfo.parentNode;
-        
-        if (parentNodeInfo)
-        {
-            NSString *parentNodeId = parentNodeInfo.syncNodeInfoId;
-            SyncNodeStatus *parentNodeStatus = [self.syncHelper syncNodeStatusObjectForNodeWithId:parentNodeId inSyncNodesStatus:self.syncNodesStatus];
-            NSSet *subNodes = parentNodeInfo.nodes;
-            
-            SyncStatus syncStatus = SyncStatusSuccessful;
-            for (SyncNodeInfo *subNodeInfo in subNodes)
-            {
-                SyncNodeStatus *subNodeStatus = [self.syncHelper syncNodeStatusObjectForNodeWithId:subNodeInfo.syncNodeInfoId inSyncNodesStatus:self.syncNodesStatus];
-                
-                if (subNodeStatus.status == SyncStatusLoading)
-                {
-                    syncStatus = SyncStatusLoading;
-                    break;
-                }
-                else if (subNodeStatus.status == SyncStatusFailed)
-                {
-                    syncStatus = SyncStatusFailed;
-                    break;
-                }
-                else if (subNodeStatus.status == SyncStatusOffline)
-                {
-                    syncStatus = SyncStatusOffline;
-                    parentNodeStatus.activityType = SyncActivityTypeUpload;
-                    break;
-                }
-                else if (subNodeStatus.status == SyncStatusWaiting)
-                {
-                    syncStatus = SyncStatusWaiting;
-                }
-            }
-            parentNodeStatus.status = syncStatus;
-        }
-    }
-    
-    [privateManagedObjectContext reset];
-    privateManagedObjectContext = nil;
-}
-
 #pragma mark - Sync Progress Information Methods
 
 - (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context
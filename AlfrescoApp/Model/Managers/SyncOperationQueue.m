@@ -27,6 +27,7 @@
 #import "AlfrescoNode+Networking.h"
 #import "RealmSyncManager.h"
 #import "AlfrescoNode+Utilities.h"
+#import "StreamCopier.h"
 
 @interface SyncOperationQueue()
 
@@ -208,13 +209,19 @@
     nodeStatus.totalSize = [document contentLength];
     
     NSString *destinationPath = [[self syncContentDirectoryPathForAccountWithId:self.account.accountIdentifier] stringByAppendingPathComponent:syncNameForNode];
-    NSOutputStream *outputStream = [[AlfrescoFileManager sharedManager] outputStreamToFileAtPath:destinationPath append:NO];
+    // The synced copy is only replaced once the new content has arrived in full
+    StreamCopyFileDestination *destination = [[StreamCopyFileDestination alloc] initWithFilePath:destinationPath];
     
     SyncOperation *downloadOperation = [[SyncOperation alloc] initWithDocumentFolderService:self.documentFolderService
-                                                                           downloadDocument:document outputStream:outputStream
+                                                                           downloadDocument:document outputStream:destination.outputStream
                                                                     downloadCompletionBlock:^(BOOL succeeded, NSError *error) {
                                                                         
-                                                                        [outputStream close];
+                                                                        NSError *moveError = nil;
+                                                                        if (![destination finishWithSuccess:succeeded error:&moveError] && succeeded)
+                                                                        {
+                                                                            succeeded = NO;
+                                                                            error = moveError;
+                                                                        }
                                                                         RLMRealm *backgroundRealm = [[RealmManager sharedManager] realmForCurrentThread];
                                                                         [backgroundRealm refresh];
                                                                         RealmSyncNodeInfo *syncNodeInfo = [[RealmSyncCore sharedSyncCore] syncNodeInfoForObject:document ifNotExistsCreateNew:NO inRealm:backgroundRealm];
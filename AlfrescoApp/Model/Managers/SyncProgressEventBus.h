@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+@class SyncNodeStatus;
+
+/**
+ * The coalesced changes of a single node status since the last delivery.
+ */
+@interface SyncProgressEvent : NSObject
+@property (nonatomic, strong, readonly) SyncNodeStatus *nodeStatus;
+@property (nonatomic, strong, readonly) NSSet<NSString *> *changedProperties;
+@end
+
+@protocol SyncProgressObserver <NSObject>
+/**
+ * Called on the main thread at most once per display frame.
+ * Observers registered for a node id receive only the event for that node; observers registered for all nodes receive every event of the frame.
+ */
+- (void)didReceiveSyncProgressEvents:(NSArray<SyncProgressEvent *> *)events;
+@end
+
+/**
+ * Routes SyncNodeStatus changes to the observers interested in a particular node.
+ * Changes can be published from any thread. They are merged per node and delivered in one batch on the next display refresh, so a
+ * node whose bytes transferred change hundreds of times a second still costs its observers a single callback per frame.
+ * Observers must be added and removed on the main thread and are held weakly.
+ */
+@interface SyncProgressEventBus : NSObject
+
++ (SyncProgressEventBus *)sharedBus;
+
+- (void)addObserver:(id<SyncProgressObserver>)observer forNodeId:(NSString *)nodeId;
+- (void)addObserverForAllNodes:(id<SyncProgressObserver>)observer;
+- (void)removeObserver:(id<SyncProgressObserver>)observer forNodeId:(NSString *)nodeId;
+- (void)removeObserver:(id<SyncProgressObserver>)observer;
+
+- (void)publishChangeOfProperty:(NSString *)property forNodeStatus:(SyncNodeStatus *)nodeStatus;
+
+/// Delivers anything pending immediately instead of waiting for the next frame. Must be called on the main thread.
+- (void)deliverPendingEvents;
+
+@end
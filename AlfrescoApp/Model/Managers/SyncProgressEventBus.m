@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "SyncProgressEventBus.h"
+#import "SyncNodeStatus.h"
+
+@interface SyncProgressEvent ()
+@property (nonatomic, strong, readwrite) SyncNodeStatus *nodeStatus;
+@property (nonatomic, strong) NSMutableSet<NSString *> *pendingProperties;
+@end
+
+@implementation SyncProgressEvent
+
+- (instancetype)initWithNodeStatus:(SyncNodeStatus *)nodeStatus
+{
+    self = [super init];
+    if (self)
+    {
+        self.nodeStatus = nodeStatus;
+        self.pendingProperties = [NSMutableSet set];
+    }
+    return self;
+}
+
+- (NSSet<NSString *> *)changedProperties
+{
+    return self.pendingProperties;
+}
+
+@end
+
+@interface SyncProgressEventBus ()
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSHashTable *> *observersByNodeId;
+@property (nonatomic, strong) NSHashTable *allNodesObservers;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, SyncProgressEvent *> *pendingEvents;
+@property (nonatomic, strong) NSMutableArray<NSString *> *pendingNodeIds;
+@property (nonatomic, assign) BOOL isDeliveryScheduled;
+@property (nonatomic, strong) CADisplayLink *displayLink;
+@end
+
+@implementation SyncProgressEventBus
+
++ (SyncProgressEventBus *)sharedBus
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[self alloc] init];
+    });
+    return sharedObject;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.observersByNodeId = [NSMutableDictionary dictionary];
+        self.allNodesObservers = [NSHashTable weakObjectsHashTable];
+        self.pendingEvents = [NSMutableDictionary dictionary];
+        self.pendingNodeIds = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_displayLink invalidate];
+}
+
+#pragma mark - Observers
+
+- (void)addObserver:(id<SyncProgressObserver>)observer forNodeId:(NSString *)nodeId
+{
+    if (!observer || !nodeId)
+    {
+        return;
+    }
+    
+    NSHashTable *observers = self.observersByNodeId[nodeId];
+    if (!observers)
+    {
+        observers = [NSHashTable weakObjectsHashTable];
+        self.observersByNodeId[nodeId] = observers;
+    }
+    [observers addObject:observer];
+}
+
+- (void)addObserverForAllNodes:(id<SyncProgressObserver>)observer
+{
+    if (observer)
+    {
+        [self.allNodesObservers addObject:observer];
+    }
+}
+
+- (void)removeObserver:(id<SyncProgressObserver>)observer forNodeId:(NSString *)nodeId
+{
+    if (!observer || !nodeId)
+    {
+        return;
+    }
+    
+    NSHashTable *observers = self.observersByNodeId[nodeId];
+    [observers removeObject:observer];
+    if (observers.allObjects.count == 0)
+    {
+        [self.observersByNodeId removeObjectForKey:nodeId];
+    }
+}
+
+- (void)removeObserver:(id<SyncProgressObserver>)observer
+{
+    if (!observer)
+    {
+        return;
+    }
+    
+    [self.allNodesObservers removeObject:observer];
+    for (NSString *nodeId in self.observersByNodeId.allKeys)
+    {
+        [self removeObserver:observer forNodeId:nodeId];
+    }
+}
+
+#pragma mark - Publishing
+
+- (void)publishChangeOfProperty:(NSString *)property forNodeStatus:(SyncNodeStatus *)nodeStatus
+{
+    NSString *nodeId = nodeStatus.nodeId;
+    if (!nodeId || !property)
+    {
+        return;
+    }
+    
+    BOOL shouldScheduleDelivery = NO;
+    @synchronized(self.pendingEvents)
+    {
+        SyncProgressEvent *event = self.pendingEvents[nodeId];
+        if (!event)
+        {
+            event = [[SyncProgressEvent alloc] initWithNodeStatus:nodeStatus];
+            self.pendingEvents[nodeId] = event;
+            [self.pendingNodeIds addObject:nodeId];
+        }
+        event.nodeStatus = nodeStatus;
+        [event.pendingProperties addObject:property];
+        
+        if (!self.isDeliveryScheduled)
+        {
+            self.isDeliveryScheduled = YES;
+            shouldScheduleDelivery = YES;
+        }
+    }
+    
+    if (shouldScheduleDelivery)
+    {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self resumeDisplayLink];
+        });
+    }
+}
+
+#pragma mark - Delivery
+
+- (void)resumeDisplayLink
+{
+    if (!self.displayLink)
+    {
+        self.displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(displayLinkFired:)];
+        [self.displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+    }
+    self.displayLink.paused = NO;
+}
+
+- (void)displayLinkFired:(CADisplayLink *)displayLink
+{
+    [self deliverPendingEvents];
+}
+
+- (void)deliverPendingEvents
+{
+    NSMutableArray<SyncProgressEvent *> *events = nil;
+    @synchronized(self.pendingEvents)
+    {
+        events = [NSMutableArray arrayWithCapacity:self.pendingNodeIds.count];
+        for (NSString *nodeId in self.pendingNodeIds)
+        {
+            [events addObject:self.pendingEvents[nodeId]];
+        }
+        [self.pendingEvents removeAllObjects];
+        [self.pendingNodeIds removeAllObjects];
+        self.isDeliveryScheduled = NO;
+    }
+    
+    // Nothing new arrived during the last frame, so stop ticking until the next change is published
+    self.displayLink.paused = YES;
+    
+    if (events.count == 0)
+    {
+        return;
+    }
+    
+    for (SyncProgressEvent *event in events)
+    {
+        NSString *nodeId = event.nodeStatus.nodeId;
+        NSArray *observers = self.observersByNodeId[nodeId].allObjects;
+        if (observers.count > 0)
+        {
+            NSArray *nodeEvents = @[event];
+            for (id<SyncProgressObserver> observer in observers)
+            {
+                [observer didReceiveSyncProgressEvents:nodeEvents];
+            }
+        }
+        else
+        {
+            // Every observer of this node has been deallocated
+            [self.observersByNodeId removeObjectForKey:nodeId];
+        }
+    }
+    
+    for (id<SyncProgressObserver> observer in self.allNodesObservers.allObjects)
+    {
+        [observer didReceiveSyncProgressEvents:events];
+    }
+}
+
+@end
@@ -37,6 +37,14 @@
  */
 - (UIImage *)thumbnailForDocument:(AlfrescoDocument *)document renditionType:(NSString *)renditionType;
 
+/*
+ * Returns the cached doc lib image for the given document, already decoded for display. Both the document identifier and modified date are matched.
+ *
+ * Safe to call from any thread; the store is read through a private context and decoded images are kept in memory.
+ * If the image is not cached, nil will be returned.
+ */
+- (UIImage *)decodedThumbnailForDocument:(AlfrescoDocument *)document;
+
 /*
  * Retrieves the image for the given document. If it is currently cached, the completion block is called, otherwise a network request
  * to the server is made. Multiple calls to this function for the same document will not result in multiple network requests. Instead,
@@ -21,6 +21,7 @@
 #import "CoreDataCacheHelper.h"
 
 static NSTimeInterval const kMinimumDelayBetweenRequestsOnCloud = 0.5;
+static NSUInteger const kMaximumDecodedThumbnailsInMemory = 200;
 
 typedef NS_ENUM(NSUInteger, RenditionType)
 {
@@ -34,6 +35,8 @@ typedef NS_ENUM(NSUInteger, RenditionType)
 @property (nonatomic, strong, readwrite) __block NSMutableDictionary *requestedThumbnailCompletionBlocks;
 @property (nonatomic, strong) CoreDataCacheHelper *coreDataCacheHelper;
 @property (nonatomic, strong) NSOperationQueue *operationQueue;
+@property (nonatomic, strong) NSCache *decodedThumbnails;
+@property (nonatomic, strong) NSManagedObjectContext *backgroundManagedObjectContext;
 
 @end
 
@@ -58,6 +61,9 @@ typedef NS_ENUM(NSUInteger, RenditionType)
         self.coreDataCacheHelper = [[CoreDataCacheHelper alloc] init];
         self.operationQueue = [[NSOperationQueue alloc] init];
         self.operationQueue.maxConcurrentOperationCount = 1;
+        self.decodedThumbnails = [[NSCache alloc] init];
+        self.decodedThumbnails.countLimit = kMaximumDecodedThumbnailsInMemory;
+        self.backgroundManagedObjectContext = [self.coreDataCacheHelper createBackgroundManagedObjectContext];
     }
     return self;
 }
@@ -136,8 +142,40 @@ typedef NS_ENUM(NSUInteger, RenditionType)
     }
 }
 
+- (UIImage *)decodedThumbnailForDocument:(AlfrescoDocument *)document
+{
+    NSString *key = [self decodedThumbnailKeyForDocument:document];
+    UIImage *decodedImage = [self.decodedThumbnails objectForKey:key];
+    if (decodedImage)
+    {
+        return decodedImage;
+    }
+    
+    __block NSData *imageData = nil;
+    NSManagedObjectContext *backgroundContext = self.backgroundManagedObjectContext;
+    [backgroundContext performBlockAndWait:^{
+        DocLibImageCache *retrievedImageCacheObject = [self.coreDataCacheHelper retrieveDocLibForDocument:document inManagedObjectContext:backgroundContext];
+        imageData = retrievedImageCacheObject.docLibImageData;
+        // Keep the context from holding on to every image it has ever fetched
+        [backgroundContext reset];
+    }];
+    
+    decodedImage = [Utility decodedImage:(imageData ? [UIImage imageWithData:imageData] : nil)];
+    if (decodedImage)
+    {
+        [self.decodedThumbnails setObject:decodedImage forKey:key];
+    }
+    
+    return decodedImage;
+}
+
 #pragma mark - Private Functions
 
+- (NSString *)decodedThumbnailKeyForDocument:(AlfrescoDocument *)document
+{
+    return [NSString stringWithFormat:@"%@-%f", document.identifier, document.modifiedAt.timeIntervalSince1970];
+}
+
 - (void)addCompletionBlock:(ImageCompletionBlock)completionBlock forKey:(NSString *)key
 {
     NSMutableArray *completionBlocksForRequest = [self.requestedThumbnailCompletionBlocks objectForKey:key];
@@ -17,8 +17,6 @@
  ******************************************************************************/
   
 extern NSString * const kSyncStatusNodeIdKey;
-extern NSString * const kSyncStatusPropertyChangedKey;
-extern NSString * const kSyncStatusChangeKey;
 extern NSString * const kSyncLocalModificationDate;
 
 extern NSString * const kSyncStatus;
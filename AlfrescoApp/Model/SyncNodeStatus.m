@@ -17,10 +17,9 @@
  ******************************************************************************/
  
 #import "SyncNodeStatus.h"
+#import "SyncProgressEventBus.h"
 
 NSString * const kSyncStatusNodeIdKey = @"nodeId";
-NSString * const kSyncStatusPropertyChangedKey = @"propertyChanged";
-NSString * const kSyncStatusChangeKey = @"change";
 
 NSString * const kSyncStatus = @"status";
 NSString * const kSyncActivityType = @"activityType";
@@ -43,7 +42,7 @@ NSString * const kSyncLocalModificationDate = @"localModificationDate";
         [self addObserver:self forKeyPath:kSyncStatus options:NSKeyValueObservingOptionNew context:nil];
         [self addObserver:self forKeyPath:kSyncActivityType options:NSKeyValueObservingOptionNew context:nil];
         [self addObserver:self forKeyPath:kSyncBytesTransfered options:NSKeyValueObservingOptionNew context:nil];
-        [self addObserver:self forKeyPath:kSyncTotalSize options:NSKeyValueObservingOptionNew | NSKeyValueObservingOptionOld context:nil];
+        [self addObserver:self forKeyPath:kSyncTotalSize options:NSKeyValueObservingOptionNew context:nil];
         [self addObserver:self forKeyPath:kSyncLocalModificationDate options:NSKeyValueObservingOptionNew context:nil];
     }
     return self;
@@ -51,43 +50,7 @@ NSString * const kSyncLocalModificationDate = @"localModificationDate";
 
 - (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context
 {
-    if ([keyPath isEqualToString:kSyncStatus])
-    {
-        [self sendNotificationForPropertyChange:kSyncStatus change:nil];
-    }
-    else if ([keyPath isEqualToString:kSyncActivityType])
-    {
-        [self sendNotificationForPropertyChange:kSyncActivityType change:nil];
-    }
-    else if ([keyPath isEqualToString:kSyncBytesTransfered])
-    {
-        [self sendNotificationForPropertyChange:kSyncBytesTransfered change:nil];
-    }
-    else if ([keyPath isEqualToString:kSyncTotalSize])
-    {
-        [self sendNotificationForPropertyChange:kSyncTotalSize change:change];
-    }
-    else if ([keyPath isEqualToString:kSyncLocalModificationDate])
-    {
-        [self sendNotificationForPropertyChange:kSyncLocalModificationDate change:nil];
-    }
-}
-
-- (void)sendNotificationForPropertyChange:(NSString *)property change:(NSDictionary *)change
-{
-    NSDictionary *info = nil;
-    if (change)
-    {
-        info = @{kSyncStatusNodeIdKey : self.nodeId, kSyncStatusPropertyChangedKey : property, kSyncStatusChangeKey : change};
-    }
-    else
-    {
-        info = @{kSyncStatusNodeIdKey : self.nodeId, kSyncStatusPropertyChangedKey : property};
-    }
-    
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [[NSNotificationCenter defaultCenter] postNotificationName:kSyncStatusChangeNotification object:self userInfo:info];
-    });
+    [[SyncProgressEventBus sharedBus] publishChangeOfProperty:keyPath forNodeStatus:self];
 }
 
 - (void)dealloc
@@ -24,7 +24,7 @@
 #import "NavigationViewController.h"
 #import "MainMenuViewController.h"
 #import "AccountManager.h"
-#import "KeychainUtils.h"
+#import "AccountStore.h"
 #import "UserAccountWrapper.h"
 #import "PersonProfileViewController.h"
 #import "SearchResultsTableViewController.h"
@@ -70,7 +70,7 @@ static NSString * const kParamTypePath = @"path";
         if (numberOfAccountsSetup > 1)
         {
             NSError *keychainError = nil;
-            NSArray *savedAccounts = [KeychainUtils savedAccountsForListIdentifier:kAccountsListIdentifier error:&keychainError];
+            NSArray *savedAccounts = [[AccountStore sharedStore] accountsWithError:&keychainError];
             
             if (keychainError)
             {
@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Where an AccountStore reads and writes the archived account list.
+ */
+@protocol AccountStoreStorage <NSObject>
+- (NSData *)accountListDataWithError:(NSError *__autoreleasing *)error;
+- (BOOL)saveAccountListData:(NSData *)data error:(NSError *__autoreleasing *)error;
+- (BOOL)deleteAccountListDataWithError:(NSError *__autoreleasing *)error;
+@end
+
+/**
+ * The saved account list, decoded once and kept in memory.
+ * Saves update the cache straight away and are written to the keychain once per writeCoalescingInterval, and only when the archived list actually changed.
+ * Every write publishes a new generation number as the state of a Darwin notification, so other processes sharing the keychain group,
+ * such as the extensions, only decode the list again after another process changed it.
+ * Thread safe.
+ */
+@interface AccountStore : NSObject
+
+/// Seconds saves are held back so that a burst of changes results in a single keychain write. Defaults to 0.25 seconds.
+@property (nonatomic, assign) NSTimeInterval writeCoalescingInterval;
+
++ (AccountStore *)sharedStore;
+- (instancetype)initWithListIdentifier:(NSString *)listIdentifier group:(NSString *)groupID;
+- (instancetype)initWithStorage:(id<AccountStoreStorage>)storage changeNotificationName:(NSString *)changeNotificationName;
+
+/*
+ * The accounts in the cache, decoding the list from the keychain only on first use or after another process saved it.
+ */
+- (NSArray *)accountsWithError:(NSError *__autoreleasing *)error;
+- (void)saveAccounts:(NSArray *)accounts;
+
+/*
+ * Writes any pending save right away, for example before the app is suspended or an extension finishes.
+ */
+- (BOOL)flushWithError:(NSError *__autoreleasing *)error;
+- (BOOL)deleteAllAccountsWithError:(NSError *__autoreleasing *)error;
+
+@end
@@ -0,0 +1,304 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "AccountStore.h"
+#import "KeychainUtils.h"
+#import "SharedConstants.h"
+#import <notify.h>
+
+static NSString * const kAccountStoreListIdentifier = @"AccountListNew";
+static NSTimeInterval const kDefaultWriteCoalescingInterval = 0.25;
+
+@interface KeychainAccountStoreStorage : NSObject <AccountStoreStorage>
+@property (nonatomic, strong) NSString *listIdentifier;
+@property (nonatomic, strong) NSString *groupID;
+@end
+
+@implementation KeychainAccountStoreStorage
+
+- (NSData *)accountListDataWithError:(NSError *__autoreleasing *)error
+{
+    return [KeychainUtils accountListDataForListIdentifier:self.listIdentifier inGroup:self.groupID error:error];
+}
+
+- (BOOL)saveAccountListData:(NSData *)data error:(NSError *__autoreleasing *)error
+{
+    return [KeychainUtils updateAccountListData:data forListIdentifier:self.listIdentifier inGroup:self.groupID error:error];
+}
+
+- (BOOL)deleteAccountListDataWithError:(NSError *__autoreleasing *)error
+{
+    return [KeychainUtils deleteSavedAccountsForListIdentifier:self.listIdentifier inGroup:self.groupID error:error];
+}
+
+@end
+
+@interface AccountStore ()
+@property (nonatomic, strong) id<AccountStoreStorage> storage;
+@property (nonatomic, strong) dispatch_queue_t storeQueue;
+@property (nonatomic, strong) NSArray *cachedAccounts;
+// The archive last read from or written to the storage, to skip writes that change nothing
+@property (nonatomic, strong) NSData *persistedData;
+@property (nonatomic, strong) NSData *pendingData;
+@property (nonatomic, assign) BOOL writeScheduled;
+@property (nonatomic, strong) NSString *changeNotificationName;
+@property (nonatomic, assign) int changeNotificationToken;
+@property (nonatomic, assign) uint64_t lastSeenGeneration;
+@end
+
+@implementation AccountStore
+
++ (AccountStore *)sharedStore
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[self alloc] initWithListIdentifier:kAccountStoreListIdentifier group:kSharedAppGroupIdentifier];
+    });
+    return sharedObject;
+}
+
+- (instancetype)initWithListIdentifier:(NSString *)listIdentifier group:(NSString *)groupID
+{
+    KeychainAccountStoreStorage *storage = [KeychainAccountStoreStorage new];
+    storage.listIdentifier = listIdentifier;
+    storage.groupID = groupID;
+    
+    NSString *changeNotificationName = [NSString stringWithFormat:@"%@.%@.changed", groupID.length ? groupID : [NSBundle mainBundle].bundleIdentifier, listIdentifier];
+    return [self initWithStorage:storage changeNotificationName:changeNotificationName];
+}
+
+- (instancetype)initWithStorage:(id<AccountStoreStorage>)storage changeNotificationName:(NSString *)changeNotificationName
+{
+    self = [super init];
+    if (self)
+    {
+        self.storage = storage;
+        self.storeQueue = dispatch_queue_create("com.alfresco.accountstore", DISPATCH_QUEUE_SERIAL);
+        self.writeCoalescingInterval = kDefaultWriteCoalescingInterval;
+        self.changeNotificationName = changeNotificationName;
+        
+        int token = NOTIFY_TOKEN_INVALID;
+        if (notify_register_check(changeNotificationName.UTF8String, &token) != NOTIFY_STATUS_OK)
+        {
+            token = NOTIFY_TOKEN_INVALID;
+        }
+        self.changeNotificationToken = token;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_changeNotificationToken != NOTIFY_TOKEN_INVALID)
+    {
+        notify_cancel(_changeNotificationToken);
+    }
+}
+
+#pragma mark - Public Methods
+
+- (NSArray *)accountsWithError:(NSError *__autoreleasing *)error
+{
+    __block NSArray *accounts = nil;
+    __block NSError *readError = nil;
+    
+    dispatch_sync(self.storeQueue, ^{
+        // An unwritten save is newer than anything in the storage
+        BOOL changedElsewhere = [self consumeExternalChange] && !self.pendingData;
+        
+        if (!self.cachedAccounts || changedElsewhere)
+        {
+            [self reloadAccountsWithError:&readError];
+        }
+        accounts = self.cachedAccounts;
+    });
+    
+    if (error && readError)
+    {
+        *error = readError;
+    }
+    return accounts;
+}
+
+- (void)saveAccounts:(NSArray *)accounts
+{
+    if (!accounts)
+    {
+        return;
+    }
+    
+    NSArray *accountsSnapshot = [accounts copy];
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:accountsSnapshot];
+    
+    dispatch_async(self.storeQueue, ^{
+        self.cachedAccounts = accountsSnapshot;
+        
+        if ([data isEqualToData:self.persistedData])
+        {
+            self.pendingData = nil;
+            return;
+        }
+        
+        self.pendingData = data;
+        if (!self.writeScheduled)
+        {
+            self.writeScheduled = YES;
+            
+            __weak typeof(self) weakSelf = self;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.writeCoalescingInterval * NSEC_PER_SEC)), self.storeQueue, ^{
+                [weakSelf writePendingDataWithError:nil];
+            });
+        }
+    });
+}
+
+- (BOOL)flushWithError:(NSError *__autoreleasing *)error
+{
+    __block BOOL success = YES;
+    __block NSError *writeError = nil;
+    
+    dispatch_sync(self.storeQueue, ^{
+        success = [self writePendingDataWithError:&writeError];
+    });
+    
+    if (error && writeError)
+    {
+        *error = writeError;
+    }
+    return success;
+}
+
+- (BOOL)deleteAllAccountsWithError:(NSError *__autoreleasing *)error
+{
+    __block BOOL success = YES;
+    __block NSError *deleteError = nil;
+    
+    dispatch_sync(self.storeQueue, ^{
+        self.pendingData = nil;
+        self.persistedData = nil;
+        self.cachedAccounts = @[];
+        
+        success = [self.storage deleteAccountListDataWithError:&deleteError];
+        [self signalChange];
+    });
+    
+    if (error && deleteError)
+    {
+        *error = deleteError;
+    }
+    return success;
+}
+
+#pragma mark - Private Methods
+
+// The following must be called on the store queue
+
+- (void)reloadAccountsWithError:(NSError *__autoreleasing *)error
+{
+    NSError *readError = nil;
+    NSData *data = [self.storage accountListDataWithError:&readError];
+    
+    if (data)
+    {
+        self.cachedAccounts = [NSKeyedUnarchiver unarchiveObjectWithData:data] ?: @[];
+        self.persistedData = data;
+    }
+    else if (!readError || readError.code == errSecItemNotFound)
+    {
+        // Nothing saved yet
+        self.cachedAccounts = @[];
+        self.persistedData = nil;
+    }
+    
+    if (error)
+    {
+        *error = readError;
+    }
+}
+
+- (BOOL)writePendingDataWithError:(NSError *__autoreleasing *)error
+{
+    self.writeScheduled = NO;
+    
+    NSData *data = self.pendingData;
+    if (!data)
+    {
+        return YES;
+    }
+    
+    NSError *writeError = nil;
+    BOOL success = [self.storage saveAccountListData:data error:&writeError];
+    if (success)
+    {
+        self.persistedData = data;
+        self.pendingData = nil;
+        [self signalChange];
+    }
+    else
+    {
+        // Kept pending, the next save or flush tries again
+        AlfrescoLogError(@"Error saving accounts to the keychain. Error: %@", writeError.localizedDescription);
+    }
+    
+    if (error)
+    {
+        *error = writeError;
+    }
+    return success;
+}
+
+- (void)signalChange
+{
+    if (self.changeNotificationToken == NOTIFY_TOKEN_INVALID)
+    {
+        return;
+    }
+    
+    uint64_t generation = ((uint64_t)arc4random() << 32) | arc4random();
+    self.lastSeenGeneration = generation;
+    notify_set_state(self.changeNotificationToken, generation);
+    notify_post(self.changeNotificationName.UTF8String);
+}
+
+- (BOOL)consumeExternalChange
+{
+    if (self.changeNotificationToken == NOTIFY_TOKEN_INVALID)
+    {
+        // Without the signal there is no telling, so always read again
+        return YES;
+    }
+    
+    // Reading the state is a quick call to notifyd, much cheaper than reading and decoding the list from the keychain.
+    // Our own writes leave the generation we last saw.
+    uint64_t generation = 0;
+    if (notify_get_state(self.changeNotificationToken, &generation) != NOTIFY_STATUS_OK)
+    {
+        return YES;
+    }
+    
+    if (generation == self.lastSeenGeneration)
+    {
+        return NO;
+    }
+    
+    self.lastSeenGeneration = generation;
+    return YES;
+}
+
+@end
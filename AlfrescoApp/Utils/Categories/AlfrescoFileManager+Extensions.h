@@ -37,6 +37,18 @@ extern NSString * const kSyncFolder;
 // configuration
 - (NSString *)defaultConfigurationFolderPath;
 
+// search
+- (NSString *)searchIndexFolderPath;
+
+// activities
+- (NSString *)activitiesFolderPath;
+
+// favourites
+- (NSString *)favouritesFolderPath;
+
+// tasks
+- (NSString *)tasksFolderPath;
+
 // clear
 - (void)clearTemporaryDirectory;
 
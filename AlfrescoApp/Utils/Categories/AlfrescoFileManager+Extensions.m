@@ -48,6 +48,18 @@ static NSString * const kFileProviderFolder = @"FileProvider";
 // configuration
 static NSString * const kConfigurationFolder = @"Configuration";
 
+// search
+static NSString * const kSearchIndexFolder = @"SearchIndex";
+
+// activities
+static NSString * const kActivitiesFolder = @"Activities";
+
+// favourites
+static NSString * const kFavouritesFolder = @"Favourites";
+
+// tasks
+static NSString * const kTasksFolder = @"Tasks";
+
 @implementation AlfrescoFileManager (Extensions)
 
 - (NSString *)documentPreviewDocumentFolderPath
@@ -116,6 +128,38 @@ static NSString * const kConfigurationFolder = @"Configuration";
     return configurationPathString;
 }
 
+- (NSString *)searchIndexFolderPath
+{
+    NSString *searchIndexPathString = [[self documentsDirectory] stringByAppendingPathComponent:kSearchIndexFolder];
+    [self createFolderAtPathIfItDoesNotExist:searchIndexPathString];
+    
+    return searchIndexPathString;
+}
+
+- (NSString *)activitiesFolderPath
+{
+    NSString *activitiesPathString = [[self documentsDirectory] stringByAppendingPathComponent:kActivitiesFolder];
+    [self createFolderAtPathIfItDoesNotExist:activitiesPathString];
+    
+    return activitiesPathString;
+}
+
+- (NSString *)favouritesFolderPath
+{
+    NSString *favouritesPathString = [[self documentsDirectory] stringByAppendingPathComponent:kFavouritesFolder];
+    [self createFolderAtPathIfItDoesNotExist:favouritesPathString];
+    
+    return favouritesPathString;
+}
+
+- (NSString *)tasksFolderPath
+{
+    NSString *tasksPathString = [[self documentsDirectory] stringByAppendingPathComponent:kTasksFolder];
+    [self createFolderAtPathIfItDoesNotExist:tasksPathString];
+    
+    return tasksPathString;
+}
+
 - (void)clearTemporaryDirectory
 {
     NSError *tmpError = nil;
@@ -35,6 +35,7 @@
 - (DocumentPreviewImageCache *)retrieveDocumentPreviewForDocument:(AlfrescoDocument *)document inManagedObjectContext:(NSManagedObjectContext *)managedObjectContext;
 
 - (void)removeAllCachedDataOlderThanNumberOfDays:(NSNumber *)numberOfDays;
+- (void)removeAllCachedDataOlderThanNumberOfDays:(NSNumber *)numberOfDays inManagedObjectContext:(NSManagedObjectContext *)managedObjectContext;
 - (void)removeAllAvatarDataInManagedObjectContext:(NSManagedObjectContext *)managedObjectContext;
 - (void)removeAllDocLibImageDataInManagedObjectContext:(NSManagedObjectContext *)managedObjectContext;
 - (void)removeAllDocumentPreviewImageDataInManagedObjectContext:(NSManagedObjectContext *)managedObjectContext;
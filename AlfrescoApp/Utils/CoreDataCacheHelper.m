@@ -169,6 +169,11 @@ static NSString * const kAlfrescoAppDataModel = @"AlfrescoCache";
 }
 
 - (void)removeAllCachedDataOlderThanNumberOfDays:(NSNumber *)numberOfDays
+{
+    [self removeAllCachedDataOlderThanNumberOfDays:numberOfDays inManagedObjectContext:self.managedObjectContext];
+}
+
+- (void)removeAllCachedDataOlderThanNumberOfDays:(NSNumber *)numberOfDays inManagedObjectContext:(NSManagedObjectContext *)managedObjectContext
 {
     NSCalendar *calender = [NSCalendar currentCalendar];
     
@@ -180,9 +185,9 @@ static NSString * const kAlfrescoAppDataModel = @"AlfrescoCache";
     
     NSPredicate *predicate = [NSPredicate predicateWithFormat:@"dateAdded < %@", cutOffDate];
     
-    [self deleteRecordsWithPredicate:predicate inTable:NSStringFromClass([AvatarImageCache class]) inManagedObjectContext:self.managedObjectContext];
-    [self deleteRecordsWithPredicate:predicate inTable:NSStringFromClass([DocLibImageCache class]) inManagedObjectContext:self.managedObjectContext];
-    [self deleteRecordsWithPredicate:predicate inTable:NSStringFromClass([DocumentPreviewImageCache class]) inManagedObjectContext:self.managedObjectContext];
+    [self deleteRecordsWithPredicate:predicate inTable:NSStringFromClass([AvatarImageCache class]) inManagedObjectContext:managedObjectContext];
+    [self deleteRecordsWithPredicate:predicate inTable:NSStringFromClass([DocLibImageCache class]) inManagedObjectContext:managedObjectContext];
+    [self deleteRecordsWithPredicate:predicate inTable:NSStringFromClass([DocumentPreviewImageCache class]) inManagedObjectContext:managedObjectContext];
 }
 
 - (void)removeAllAvatarDataInManagedObjectContext:(NSManagedObjectContext *)managedContext
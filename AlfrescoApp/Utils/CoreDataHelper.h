@@ -30,5 +30,6 @@
 
 - (void)saveContextForManagedObjectContext:(NSManagedObjectContext *)managedContext;
 - (NSManagedObjectContext *)createChildManagedObjectContext;
+- (NSManagedObjectContext *)createBackgroundManagedObjectContext;
 
 @end
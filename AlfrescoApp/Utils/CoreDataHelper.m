@@ -65,6 +65,16 @@
     return privateContext;
 }
 
+/**
+ * Unlike a child context, fetches in this context go straight to the store and never wait on the main queue.
+ */
+- (NSManagedObjectContext *)createBackgroundManagedObjectContext
+{
+    NSManagedObjectContext *privateContext = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
+    privateContext.persistentStoreCoordinator = self.managedObjectContext.persistentStoreCoordinator;
+    return privateContext;
+}
+
 #pragma mark - Delete Records Methods
 
 - (void)deleteRecordsWithPredicate:(NSPredicate *)predicate inTable:(NSString *)table inManagedObjectContext:(NSManagedObjectContext *)managedContext
@@ -0,0 +1,35 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+/**
+ * Thread-safe lookup of MIME types and thumbnail placeholder icons by file extension.
+ * The icon mapping plists are read once, every icon is decoded up front and the MIME type of each mapped extension is resolved
+ * ahead of time, so cells can ask for an icon or MIME type without hitting UTType or image name resolution.
+ */
+@interface FileTypeIconCatalog : NSObject
+
++ (FileTypeIconCatalog *)sharedCatalog;
+
+/// Builds the catalog on a background queue so the first lookup doesn't pay for it.
++ (void)preloadCatalog;
+
+- (UIImage *)smallImageForFileExtension:(NSString *)extension;
+- (UIImage *)largeImageForFileExtension:(NSString *)extension;
+- (NSString *)mimeTypeForFileExtension:(NSString *)extension;
+
+@end
@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "FileTypeIconCatalog.h"
+#import <MobileCoreServices/MobileCoreServices.h>
+
+static NSString * const kDefaultSmallImageName = @"small_document.png";
+static NSString * const kDefaultLargeImageName = @"large_document.png";
+static NSString * const kDefaultMimeType = @"application/octet-stream";
+
+@interface FileTypeIconCatalog ()
+@property (nonatomic, strong) NSDictionary *smallImagesByExtension;
+@property (nonatomic, strong) NSDictionary *largeImagesByExtension;
+@property (nonatomic, strong) UIImage *defaultSmallImage;
+@property (nonatomic, strong) UIImage *defaultLargeImage;
+@property (nonatomic, strong) NSDictionary *mappedMimeTypesByExtension;
+@property (nonatomic, strong) NSMutableDictionary *resolvedMimeTypesByExtension;
+@end
+
+@implementation FileTypeIconCatalog
+
++ (FileTypeIconCatalog *)sharedCatalog
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[self alloc] init];
+    });
+    return sharedObject;
+}
+
++ (void)preloadCatalog
+{
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
+        [self sharedCatalog];
+    });
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        NSMutableDictionary *decodedImagesByName = [NSMutableDictionary dictionary];
+        
+        self.defaultSmallImage = [self decodedImageNamed:kDefaultSmallImageName cache:decodedImagesByName];
+        self.defaultLargeImage = [self decodedImageNamed:kDefaultLargeImageName cache:decodedImagesByName];
+        self.smallImagesByExtension = [self imagesByExtensionFromMappingPlist:kSmallThumbnailImageMappingPlist cache:decodedImagesByName];
+        self.largeImagesByExtension = [self imagesByExtensionFromMappingPlist:kLargeThumbnailImageMappingPlist cache:decodedImagesByName];
+        
+        NSMutableSet *mappedExtensions = [NSMutableSet setWithArray:self.smallImagesByExtension.allKeys];
+        [mappedExtensions addObjectsFromArray:self.largeImagesByExtension.allKeys];
+        NSMutableDictionary *mimeTypesByExtension = [NSMutableDictionary dictionaryWithCapacity:mappedExtensions.count];
+        for (NSString *extension in mappedExtensions)
+        {
+            mimeTypesByExtension[extension] = [self resolveMimeTypeForFileExtension:extension];
+        }
+        self.mappedMimeTypesByExtension = mimeTypesByExtension;
+        self.resolvedMimeTypesByExtension = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma mark - Public Methods
+
+- (UIImage *)smallImageForFileExtension:(NSString *)extension
+{
+    return [self imageForFileExtension:extension inImages:self.smallImagesByExtension] ?: self.defaultSmallImage;
+}
+
+- (UIImage *)largeImageForFileExtension:(NSString *)extension
+{
+    return [self imageForFileExtension:extension inImages:self.largeImagesByExtension] ?: self.defaultLargeImage;
+}
+
+- (NSString *)mimeTypeForFileExtension:(NSString *)extension
+{
+    if (extension.length == 0)
+    {
+        return kDefaultMimeType;
+    }
+    
+    NSString *mimeType = self.mappedMimeTypesByExtension[extension];
+    if (mimeType)
+    {
+        return mimeType;
+    }
+    
+    @synchronized(self.resolvedMimeTypesByExtension)
+    {
+        mimeType = self.resolvedMimeTypesByExtension[extension];
+        if (!mimeType)
+        {
+            mimeType = [self resolveMimeTypeForFileExtension:extension];
+            self.resolvedMimeTypesByExtension[extension] = mimeType;
+        }
+    }
+    return mimeType;
+}
+
+#pragma mark - Private Methods
+
+- (UIImage *)imageForFileExtension:(NSString *)extension inImages:(NSDictionary *)imagesByExtension
+{
+    if (extension.length == 0)
+    {
+        return nil;
+    }
+    
+    // The mapping keys are lower case, so only lower case the extension when the exact match misses
+    return imagesByExtension[extension] ?: imagesByExtension[extension.lowercaseString];
+}
+
+- (NSDictionary *)imagesByExtensionFromMappingPlist:(NSString *)plistName cache:(NSMutableDictionary *)decodedImagesByName
+{
+    NSString *plistPath = [[NSBundle mainBundle] pathForResource:plistName ofType:@"plist"];
+    NSDictionary *imageNamesByExtension = [NSDictionary dictionaryWithContentsOfFile:plistPath];
+    NSMutableDictionary *imagesByExtension = [NSMutableDictionary dictionaryWithCapacity:imageNamesByExtension.count];
+    
+    [imageNamesByExtension enumerateKeysAndObjectsUsingBlock:^(NSString *extension, NSString *imageName, BOOL *stop) {
+        UIImage *image = [self decodedImageNamed:imageName cache:decodedImagesByName];
+        if (image)
+        {
+            imagesByExtension[extension.lowercaseString] = image;
+        }
+    }];
+    
+    return imagesByExtension;
+}
+
+/**
+ * Returns the named image already drawn into a bitmap, so it is not decoded again on the main thread the first time a cell displays it.
+ * Each image name is only loaded once across both mappings.
+ */
+- (UIImage *)decodedImageNamed:(NSString *)imageName cache:(NSMutableDictionary *)decodedImagesByName
+{
+    UIImage *decodedImage = decodedImagesByName[imageName];
+    if (decodedImage)
+    {
+        return decodedImage;
+    }
+    
+    decodedImage = [Utility decodedImage:[UIImage imageNamed:imageName]];
+    if (decodedImage)
+    {
+        decodedImagesByName[imageName] = decodedImage;
+    }
+    return decodedImage;
+}
+
+- (NSString *)resolveMimeTypeForFileExtension:(NSString *)extension
+{
+    CFStringRef pathExtension = (__bridge CFStringRef)extension;
+    CFStringRef type = UTTypeCreatePreferredIdentifierForTag(kUTTagClassFilenameExtension, pathExtension, NULL);
+    NSString *mimeType = (__bridge_transfer NSString *)UTTypeCopyPreferredTagWithClass(type, kUTTagClassMIMEType);
+    if (NULL != type)
+    {
+        CFRelease(type);
+    }
+    
+    if (mimeType.length == 0)
+    {
+        mimeType = kDefaultMimeType;
+    }
+    
+    /**
+     * Force the mimetype to audio/mp4 it iOS determined it should be audio/x-m4a
+     * Otherwise the repo applies both audio and exif aspects to the node
+     */
+    if ([mimeType isEqualToString:@"audio/x-m4a"])
+    {
+        mimeType = @"audio/mp4";
+    }
+    
+    return mimeType;
+}
+
+@end
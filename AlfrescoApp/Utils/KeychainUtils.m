@@ -33,11 +33,16 @@ static NSString *kKeychainItemServiceName = @"Alfresco";
 }
 
 + (NSArray *)savedAccountsForListIdentifier:(NSString *)listIdentifier inGroup:(NSString *)groupID error:(NSError *__autoreleasing *)error {
+    NSData *data = [self accountListDataForListIdentifier:listIdentifier inGroup:groupID error:error];
+    return data ? [NSKeyedUnarchiver unarchiveObjectWithData:data] : nil;
+}
+
++ (NSData *)accountListDataForListIdentifier:(NSString *)listIdentifier inGroup:(NSString *)groupID error:(NSError *__autoreleasing *)error
+{
 #ifndef DEBUG
     SEC_IS_BEING_DEBUGGED_RETURN_NIL();
 #endif
     
-    NSArray *accountsArray = nil;
     NSMutableDictionary *query = [NSMutableDictionary dictionaryWithDictionary:
                                   @{(__bridge id)kSecClass : (__bridge id)kSecClassGenericPassword,
                                     (__bridge id)kSecAttrGeneric : (id)listIdentifier,
@@ -54,26 +59,20 @@ static NSString *kKeychainItemServiceName = @"Alfresco";
     
     if (status == noErr)
     {
-        if (data)
+        if (!data && error)
         {
-            accountsArray = [NSKeyedUnarchiver unarchiveObjectWithData:data];
-        }
-        else
-        {
-            if (error)
-            {
-                *error = [NSError errorWithDomain:@"Error retrieving accounts. No Data found." code:-1 userInfo:nil];
-            }
+            *error = [NSError errorWithDomain:@"Error retrieving accounts. No Data found." code:-1 userInfo:nil];
         }
     }
     else
     {
+        data = nil;
         if (error)
         {
             *error = [NSError errorWithDomain:@"Error retrieving accounts" code:status userInfo:nil];
         }
     }
-    return accountsArray;
+    return data;
 }
 
 + (BOOL)updateSavedAccounts:(NSArray *)accounts forListIdentifier:(NSString *)listIdentifier error:(NSError *__autoreleasing *)updateError
@@ -86,51 +85,52 @@ static NSString *kKeychainItemServiceName = @"Alfresco";
 
 + (BOOL)updateSavedAccounts:(NSArray *)accounts forListIdentifier:(NSString *)listIdentifier inGroup:(NSString *)groupID error:(NSError *__autoreleasing *)updateError
 {
-    BOOL updateSucceeded = YES;
-    if (accounts)
+    if (!accounts)
     {
-        NSData *accountsArrayData = [NSKeyedArchiver archivedDataWithRootObject:accounts];
-        NSMutableDictionary *searchDictionary = [NSMutableDictionary dictionaryWithDictionary:
-                                                 @{(__bridge id)kSecClass : (__bridge id)kSecClassGenericPassword,
-                                                   (__bridge id)kSecAttrGeneric : (id)listIdentifier
-                                                   }];
-        
-        if (groupID.length)
+        if (updateError)
         {
-            [searchDictionary setObject:groupID forKey:(__bridge id)kSecAttrAccessGroup];
+            *updateError = [NSError errorWithDomain:@"Nil account array" code:-1 userInfo:nil];
         }
-        
-        NSDictionary *updateDictionary = @{(__bridge id)kSecValueData : (id)accountsArrayData};
-        
-        NSArray *accountsList = [self savedAccountsForListIdentifier:listIdentifier error:updateError];
-        OSStatus status = noErr;
-        
-        // if no accounts in the keychain, add to the keychain, else, update
-        if (!accountsList)
-        {
-            NSMutableDictionary *createDictionary = [NSMutableDictionary dictionary];
-            [createDictionary addEntriesFromDictionary:searchDictionary];
-            [createDictionary addEntriesFromDictionary:updateDictionary];
-            status = SecItemAdd((__bridge CFDictionaryRef)createDictionary, NULL);
-        }
-        else
-        {
-            status = SecItemUpdate((__bridge CFDictionaryRef)searchDictionary, (__bridge CFDictionaryRef)updateDictionary);
-            updateSucceeded = NO;
-        }
-        
-        if (updateError && status != noErr)
+        return NO;
+    }
+    
+    NSData *accountsArrayData = [NSKeyedArchiver archivedDataWithRootObject:accounts];
+    return [self updateAccountListData:accountsArrayData forListIdentifier:listIdentifier inGroup:groupID error:updateError];
+}
+
++ (BOOL)updateAccountListData:(NSData *)data forListIdentifier:(NSString *)listIdentifier inGroup:(NSString *)groupID error:(NSError *__autoreleasing *)updateError
+{
+    NSMutableDictionary *searchDictionary = [NSMutableDictionary dictionaryWithDictionary:
+                                             @{(__bridge id)kSecClass : (__bridge id)kSecClassGenericPassword,
+                                               (__bridge id)kSecAttrGeneric : (id)listIdentifier
+                                               }];
+    
+    if (groupID.length)
+    {
+        [searchDictionary setObject:groupID forKey:(__bridge id)kSecAttrAccessGroup];
+    }
+    
+    NSDictionary *updateDictionary = @{(__bridge id)kSecValueData : (id)data};
+    
+    // Update in place, only adding the item the first time, rather than reading the whole list back to find out whether it exists
+    OSStatus status = SecItemUpdate((__bridge CFDictionaryRef)searchDictionary, (__bridge CFDictionaryRef)updateDictionary);
+    if (status == errSecItemNotFound)
+    {
+        NSMutableDictionary *createDictionary = [NSMutableDictionary dictionary];
+        [createDictionary addEntriesFromDictionary:searchDictionary];
+        [createDictionary addEntriesFromDictionary:updateDictionary];
+        status = SecItemAdd((__bridge CFDictionaryRef)createDictionary, NULL);
+    }
+    
+    if (status != noErr)
+    {
+        if (updateError)
         {
             *updateError = [NSError errorWithDomain:@"Error updating the accounts" code:status userInfo:nil];
-            updateSucceeded = NO;
         }
+        return NO;
     }
-    else if (updateError)
-    {
-        *updateError = [NSError errorWithDomain:@"Nil account array" code:-1 userInfo:nil];
-        updateSucceeded = NO;
-    }
-    return updateSucceeded;
+    return YES;
 }
 
 + (BOOL)updateSavedAccount:(UserAccount *)account forListIdentifier:(NSString *)listIdentifier error:(NSError *__autoreleasing *)updateError
@@ -0,0 +1,47 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+/**
+ * Counts durations into fixed buckets so the latency distribution of an operation can be logged and inspected.
+ *
+ * Not thread safe; record and read from one thread, normally the main thread.
+ */
+@interface LatencyHistogram : NSObject
+
+@property (nonatomic, strong, readonly) NSString *name;
+@property (nonatomic, assign, readonly) NSUInteger count;
+// Upper bounds of the buckets, in seconds and ascending. A final bucket holds anything slower.
+@property (nonatomic, strong, readonly) NSArray<NSNumber *> *bucketBoundaries;
+
+/*
+ * Uses buckets from 10ms to 5s.
+ */
+- (instancetype)initWithName:(NSString *)name;
+- (instancetype)initWithName:(NSString *)name bucketBoundaries:(NSArray<NSNumber *> *)bucketBoundaries;
+
+- (void)recordLatency:(NSTimeInterval)latency;
+- (NSUInteger)countInBucketAtIndex:(NSUInteger)bucketIndex;
+
+/*
+ * Upper bound of the bucket holding the given percentile (0 - 100), or the largest recorded latency for the final bucket.
+ */
+- (NSTimeInterval)latencyAtPercentile:(double)percentile;
+- (NSString *)summary;
+- (void)reset;
+
+@end
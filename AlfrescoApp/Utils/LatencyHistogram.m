@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "LatencyHistogram.h"
+
+@interface LatencyHistogram ()
+
+@property (nonatomic, strong, readwrite) NSString *name;
+@property (nonatomic, assign, readwrite) NSUInteger count;
+@property (nonatomic, strong, readwrite) NSArray<NSNumber *> *bucketBoundaries;
+@property (nonatomic, assign) NSUInteger *bucketCounts;
+@property (nonatomic, assign) NSTimeInterval totalLatency;
+@property (nonatomic, assign) NSTimeInterval maximumLatency;
+
+@end
+
+@implementation LatencyHistogram
+
+- (instancetype)initWithName:(NSString *)name
+{
+    return [self initWithName:name bucketBoundaries:@[@0.01, @0.025, @0.05, @0.1, @0.25, @0.5, @1, @2, @5]];
+}
+
+- (instancetype)initWithName:(NSString *)name bucketBoundaries:(NSArray<NSNumber *> *)bucketBoundaries
+{
+    self = [super init];
+    if (self)
+    {
+        self.name = name;
+        self.bucketBoundaries = [bucketBoundaries sortedArrayUsingSelector:@selector(compare:)];
+        self.bucketCounts = calloc(self.bucketBoundaries.count + 1, sizeof(NSUInteger));
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_bucketCounts);
+}
+
+- (void)recordLatency:(NSTimeInterval)latency
+{
+    NSUInteger bucketIndex = 0;
+    while (bucketIndex < self.bucketBoundaries.count && latency > self.bucketBoundaries[bucketIndex].doubleValue)
+    {
+        bucketIndex++;
+    }
+    
+    self.bucketCounts[bucketIndex]++;
+    self.count++;
+    self.totalLatency += latency;
+    self.maximumLatency = MAX(self.maximumLatency, latency);
+}
+
+- (NSUInteger)countInBucketAtIndex:(NSUInteger)bucketIndex
+{
+    return (bucketIndex <= self.bucketBoundaries.count) ? self.bucketCounts[bucketIndex] : 0;
+}
+
+- (NSTimeInterval)latencyAtPercentile:(double)percentile
+{
+    if (self.count == 0)
+    {
+        return 0;
+    }
+    
+    NSUInteger rank = (NSUInteger)ceil(self.count * MIN(MAX(percentile, 0), 100) / 100.0);
+    NSUInteger cumulativeCount = 0;
+    for (NSUInteger bucketIndex = 0; bucketIndex < self.bucketBoundaries.count; bucketIndex++)
+    {
+        cumulativeCount += self.bucketCounts[bucketIndex];
+        if (cumulativeCount >= MAX(rank, 1))
+        {
+            return MIN(self.bucketBoundaries[bucketIndex].doubleValue, self.maximumLatency);
+        }
+    }
+    return self.maximumLatency;
+}
+
+- (NSString *)summary
+{
+    if (self.count == 0)
+    {
+        return [NSString stringWithFormat:@"%@: no samples", self.name];
+    }
+    
+    NSMutableArray *buckets = [NSMutableArray array];
+    for (NSUInteger bucketIndex = 0; bucketIndex <= self.bucketBoundaries.count; bucketIndex++)
+    {
+        if (self.bucketCounts[bucketIndex] == 0)
+        {
+            continue;
+        }
+        NSString *bound = (bucketIndex < self.bucketBoundaries.count) ? [NSString stringWithFormat:@"<=%.0fms", self.bucketBoundaries[bucketIndex].doubleValue * 1000] : @">";
+        [buckets addObject:[NSString stringWithFormat:@"%@: %lu", bound, (unsigned long)self.bucketCounts[bucketIndex]]];
+    }
+    
+    return [NSString stringWithFormat:@"%@: %lu samples, mean %.0fms, p50 %.0fms, p90 %.0fms, max %.0fms [%@]",
+            self.name, (unsigned long)self.count, self.totalLatency / self.count * 1000,
+            [self latencyAtPercentile:50] * 1000, [self latencyAtPercentile:90] * 1000, self.maximumLatency * 1000,
+            [buckets componentsJoinedByString:@", "]];
+}
+
+- (void)reset
+{
+    memset(self.bucketCounts, 0, (self.bucketBoundaries.count + 1) * sizeof(NSUInteger));
+    self.count = 0;
+    self.totalLatency = 0;
+    self.maximumLatency = 0;
+}
+
+@end
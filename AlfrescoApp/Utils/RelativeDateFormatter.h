@@ -0,0 +1,30 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+/**
+ * Formats dates relative to now ("5 minutes ago", "2 days ago", ...).
+ * Dates are bucketed by the unit and count that will be displayed and the localized string for each bucket is only built once.
+ * While the app is active a single timer posts kAlfrescoRelativeDatesNeedRefreshNotification every minute so visible lists can refresh.
+ */
+@interface RelativeDateFormatter : NSObject
+
++ (RelativeDateFormatter *)sharedFormatter;
+- (NSString *)relativeTimeFromDate:(NSDate *)date;
+- (NSString *)relativeTimeFromDate:(NSDate *)date relativeToDate:(NSDate *)now;
+
+@end
@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "RelativeDateFormatter.h"
+
+static NSTimeInterval const kRelativeDateRefreshInterval = 60;
+static NSUInteger const kRelativeDateCacheCountLimit = 512;
+
+typedef NS_ENUM(NSUInteger, RelativeDateUnit)
+{
+    RelativeDateUnitJustNow = 0,
+    RelativeDateUnitSeconds,
+    RelativeDateUnitOneMinute,
+    RelativeDateUnitMinutes,
+    RelativeDateUnitOneHour,
+    RelativeDateUnitHours,
+    RelativeDateUnitOneDay,
+    RelativeDateUnitDays,
+    RelativeDateUnitOneWeek,
+    RelativeDateUnitWeeks,
+    RelativeDateUnitOneMonth,
+    RelativeDateUnitMonths,
+    RelativeDateUnitOneYear,
+    RelativeDateUnitYears
+};
+
+@interface RelativeDateFormatter ()
+@property (nonatomic, strong) NSCache *formattedStrings;
+@property (nonatomic, strong) NSTimer *refreshTimer;
+@end
+
+@implementation RelativeDateFormatter
+
++ (RelativeDateFormatter *)sharedFormatter
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[self alloc] init];
+    });
+    return sharedObject;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.formattedStrings = [[NSCache alloc] init];
+        self.formattedStrings.countLimit = kRelativeDateCacheCountLimit;
+        
+        NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+        [notificationCenter addObserver:self selector:@selector(applicationDidBecomeActive:) name:UIApplicationDidBecomeActiveNotification object:nil];
+        [notificationCenter addObserver:self selector:@selector(applicationWillResignActive:) name:UIApplicationWillResignActiveNotification object:nil];
+        [notificationCenter addObserver:self selector:@selector(localeDidChange:) name:NSCurrentLocaleDidChangeNotification object:nil];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if ([UIApplication sharedApplication].applicationState == UIApplicationStateActive)
+            {
+                [self startRefreshTimer];
+            }
+        });
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    [_refreshTimer invalidate];
+}
+
+#pragma mark - Public Methods
+
+- (NSString *)relativeTimeFromDate:(NSDate *)date
+{
+    return [self relativeTimeFromDate:date relativeToDate:[NSDate date]];
+}
+
+- (NSString *)relativeTimeFromDate:(NSDate *)date relativeToDate:(NSDate *)now
+{
+    if (nil == date)
+    {
+        return @"";
+    }
+    
+    NSTimeInterval interval = [date timeIntervalSinceDate:now];
+    BOOL isFuture = interval > 0;
+    NSTimeInterval seconds_ago = fabs(interval);
+    
+    RelativeDateUnit unit;
+    NSInteger count = 0;
+    
+    double minutes_ago = round(seconds_ago / 60);
+    double hours_ago = round(minutes_ago / 60);
+    double days_ago = round(hours_ago / 24);
+    double weeks_ago = round(days_ago / 7);
+    double months_ago = round(days_ago / 30);
+    double years_ago = round(days_ago / 365);
+    
+    if (seconds_ago < 2)
+    {
+        unit = RelativeDateUnitJustNow;
+    }
+    else if (seconds_ago < 60)
+    {
+        unit = RelativeDateUnitSeconds;
+        count = seconds_ago;
+    }
+    else if (minutes_ago == 1)
+    {
+        unit = RelativeDateUnitOneMinute;
+    }
+    else if (minutes_ago < 60)
+    {
+        unit = RelativeDateUnitMinutes;
+        count = minutes_ago;
+    }
+    else if (hours_ago == 1)
+    {
+        unit = RelativeDateUnitOneHour;
+    }
+    else if (hours_ago < 24)
+    {
+        unit = RelativeDateUnitHours;
+        count = hours_ago;
+    }
+    else if (days_ago == 1)
+    {
+        unit = RelativeDateUnitOneDay;
+    }
+    else if (days_ago < 7)
+    {
+        unit = RelativeDateUnitDays;
+        count = days_ago;
+    }
+    else if (weeks_ago == 1)
+    {
+        unit = RelativeDateUnitOneWeek;
+    }
+    else if (days_ago < 30)
+    {
+        unit = RelativeDateUnitWeeks;
+        count = weeks_ago;
+    }
+    else if (months_ago == 1)
+    {
+        unit = RelativeDateUnitOneMonth;
+    }
+    else if (days_ago < 365)
+    {
+        unit = RelativeDateUnitMonths;
+        count = months_ago;
+    }
+    else if (years_ago == 1)
+    {
+        unit = RelativeDateUnitOneYear;
+    }
+    else
+    {
+        unit = RelativeDateUnitYears;
+        count = years_ago;
+    }
+    
+    // The bucket key packs direction, unit and count into a single number
+    NSNumber *bucketKey = @((count << 5) | (unit << 1) | (isFuture ? 1 : 0));
+    NSString *formattedString = [self.formattedStrings objectForKey:bucketKey];
+    if (!formattedString)
+    {
+        formattedString = [self localizedStringForUnit:unit count:count isFuture:isFuture];
+        [self.formattedStrings setObject:formattedString forKey:bucketKey];
+    }
+    return formattedString;
+}
+
+#pragma mark - Private Methods
+
+- (NSString *)localizedStringForUnit:(RelativeDateUnit)unit count:(NSInteger)count isFuture:(BOOL)isFuture
+{
+    if (unit == RelativeDateUnitJustNow)
+    {
+        return NSLocalizedString(@"relative.date.just-now", @"Just now");
+    }
+    
+    NSArray *unitKeys = @[@"", @"n-seconds", @"one-minute", @"n-minutes", @"one-hour", @"n-hours", @"one-day", @"n-days", @"one-week", @"n-weeks", @"one-month", @"n-months", @"one-year", @"n-years"];
+    NSString *dateKey = [NSString stringWithFormat:@"relative.date.%@.%@", isFuture ? @"future" : @"past", unitKeys[unit]];
+    return [NSString stringWithFormat:NSLocalizedString(dateKey, @"Date string"), count];
+}
+
+- (void)startRefreshTimer
+{
+    if (!self.refreshTimer)
+    {
+        self.refreshTimer = [NSTimer scheduledTimerWithTimeInterval:kRelativeDateRefreshInterval target:self selector:@selector(refreshTimerFired:) userInfo:nil repeats:YES];
+        self.refreshTimer.tolerance = kRelativeDateRefreshInterval / 10;
+    }
+}
+
+- (void)stopRefreshTimer
+{
+    [self.refreshTimer invalidate];
+    self.refreshTimer = nil;
+}
+
+- (void)refreshTimerFired:(NSTimer *)timer
+{
+    [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoRelativeDatesNeedRefreshNotification object:self];
+}
+
+#pragma mark - Notification Handlers
+
+- (void)applicationDidBecomeActive:(NSNotification *)notification
+{
+    [self startRefreshTimer];
+    // Catch up on anything that went stale while inactive
+    [self refreshTimerFired:nil];
+}
+
+- (void)applicationWillResignActive:(NSNotification *)notification
+{
+    [self stopRefreshTimer];
+}
+
+- (void)localeDidChange:(NSNotification *)notification
+{
+    [self.formattedStrings removeAllObjects];
+}
+
+@end
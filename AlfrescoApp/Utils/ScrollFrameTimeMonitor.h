@@ -0,0 +1,38 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+/**
+ * Measures frame times while a scroll view is scrolling, so cell configuration cost shows up as dropped frames in the logs.
+ *
+ * Start it when dragging begins and stop it once scrolling comes to rest; a summary is logged at debug level on stop.
+ */
+@interface ScrollFrameTimeMonitor : NSObject
+
+@property (nonatomic, strong, readonly) NSString *name;
+@property (nonatomic, assign, readonly) BOOL isMonitoring;
+// Statistics for the current, or most recent, scroll
+@property (nonatomic, assign, readonly) NSUInteger frameCount;
+@property (nonatomic, assign, readonly) NSUInteger droppedFrameCount;
+@property (nonatomic, assign, readonly) CFTimeInterval averageFrameDuration;
+@property (nonatomic, assign, readonly) CFTimeInterval longestFrameDuration;
+
+- (instancetype)initWithName:(NSString *)name;
+- (void)startMonitoring;
+- (void)stopMonitoring;
+
+@end
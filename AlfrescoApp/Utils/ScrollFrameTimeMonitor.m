@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "ScrollFrameTimeMonitor.h"
+
+// A frame this much longer than the display's refresh interval counts as dropped
+static CFTimeInterval const kDroppedFrameThreshold = 1.5;
+
+@interface ScrollFrameTimeMonitor ()
+
+@property (nonatomic, strong, readwrite) NSString *name;
+@property (nonatomic, assign, readwrite) NSUInteger frameCount;
+@property (nonatomic, assign, readwrite) NSUInteger droppedFrameCount;
+@property (nonatomic, assign, readwrite) CFTimeInterval longestFrameDuration;
+@property (nonatomic, assign) CFTimeInterval totalFrameDuration;
+@property (nonatomic, assign) CFTimeInterval previousTimestamp;
+@property (nonatomic, strong) CADisplayLink *displayLink;
+
+@end
+
+@implementation ScrollFrameTimeMonitor
+
+- (instancetype)initWithName:(NSString *)name
+{
+    self = [super init];
+    if (self)
+    {
+        self.name = name;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_displayLink invalidate];
+}
+
+#pragma mark - Public Methods
+
+- (BOOL)isMonitoring
+{
+    return self.displayLink != nil;
+}
+
+- (CFTimeInterval)averageFrameDuration
+{
+    return (self.frameCount > 0) ? self.totalFrameDuration / self.frameCount : 0;
+}
+
+- (void)startMonitoring
+{
+    if (self.isMonitoring)
+    {
+        return;
+    }
+    
+    self.frameCount = 0;
+    self.droppedFrameCount = 0;
+    self.longestFrameDuration = 0;
+    self.totalFrameDuration = 0;
+    self.previousTimestamp = 0;
+    
+    // The display link retains its target, so it is invalidated in stopMonitoring
+    self.displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(displayLinkFired:)];
+    [self.displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+}
+
+- (void)stopMonitoring
+{
+    if (!self.isMonitoring)
+    {
+        return;
+    }
+    
+    [self.displayLink invalidate];
+    self.displayLink = nil;
+    
+    if (self.frameCount > 0)
+    {
+        AlfrescoLogDebug(@"Scrolling %@: %lu frames, %lu dropped, average %.1fms, longest %.1fms", self.name, (unsigned long)self.frameCount, (unsigned long)self.droppedFrameCount, self.averageFrameDuration * 1000, self.longestFrameDuration * 1000);
+    }
+}
+
+#pragma mark - Private Methods
+
+- (void)displayLinkFired:(CADisplayLink *)displayLink
+{
+    if (self.previousTimestamp > 0)
+    {
+        CFTimeInterval frameDuration = displayLink.timestamp - self.previousTimestamp;
+        CFTimeInterval refreshInterval = displayLink.targetTimestamp - displayLink.timestamp;
+        
+        self.frameCount++;
+        self.totalFrameDuration += frameDuration;
+        self.longestFrameDuration = MAX(self.longestFrameDuration, frameDuration);
+        
+        if (refreshInterval > 0 && frameDuration > refreshInterval * kDroppedFrameThreshold)
+        {
+            self.droppedFrameCount += (NSUInteger)round(frameDuration / refreshInterval) - 1;
+        }
+    }
+    self.previousTimestamp = displayLink.timestamp;
+}
+
+@end
@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+typedef void (^StreamCopyProgressBlock)(unsigned long long bytesCopied, unsigned long long bytesTotal);
+typedef void (^StreamCopyCompletionBlock)(BOOL succeeded, unsigned long long bytesCopied, NSError *error);
+
+/**
+ * Handle to an in-flight copy, used for cancellation.
+ */
+@interface StreamCopyRequest : NSObject
+
+@property (atomic, assign, readonly, getter=isCancelled) BOOL cancelled;
+
+- (void)cancel;
+
+@end
+
+/**
+ * A file being written through an output stream, by the copier or by another writer such as the SDK's retrieveContentOfDocument:outputStream:.
+ * Bytes go to a partial file, which finishing moves over the destination when the write succeeded and deletes otherwise,
+ * so a failed or cancelled transfer never leaves a truncated file at the destination.
+ */
+@interface StreamCopyFileDestination : NSObject
+
+@property (nonatomic, strong, readonly) NSString *filePath;
+@property (nonatomic, strong, readonly) NSString *partialFilePath;
+@property (nonatomic, strong, readonly) NSOutputStream *outputStream;
+
+/*
+ * The partial file is written in the temporary directory.
+ */
+- (instancetype)initWithFilePath:(NSString *)filePath;
+- (instancetype)initWithFilePath:(NSString *)filePath partialFilePath:(NSString *)partialFilePath;
+
+/*
+ * Closes the output stream, then moves the partial file into place if succeeded is YES, or deletes it.
+ * Returns NO if the write failed or the partial file could not be moved.
+ */
+- (BOOL)finishWithSuccess:(BOOL)succeeded error:(NSError **)error;
+
+@end
+
+/**
+ * Copies an input stream into an output stream using a small pool of reusable buffers.
+ * Asynchronous copies run one at a time on a serial background queue, so large copies don't compete with each other for the disk.
+ * Partial writes are retried until every byte read has been written. Progress and completion blocks are called on the main thread.
+ */
+@interface StreamCopier : NSObject
+
+@property (nonatomic, assign, readonly) NSUInteger bufferSize;
+
++ (StreamCopier *)sharedCopier;
+- (instancetype)initWithBufferSize:(NSUInteger)bufferSize maximumPooledBuffers:(NSUInteger)maximumPooledBuffers;
+
+/*
+ * Copies on the calling thread and returns once the input stream is exhausted or a read or write fails.
+ */
+- (BOOL)copyInputStream:(NSInputStream *)inputStream toOutputStream:(NSOutputStream *)outputStream error:(NSError **)error;
+
+- (StreamCopyRequest *)copyInputStream:(NSInputStream *)inputStream
+                        toOutputStream:(NSOutputStream *)outputStream
+                        expectedLength:(unsigned long long)expectedLength
+                         progressBlock:(StreamCopyProgressBlock)progressBlock
+                       completionBlock:(StreamCopyCompletionBlock)completionBlock;
+
+/*
+ * The destination is only replaced once the whole file has been copied. A failed or cancelled copy leaves it untouched.
+ */
+- (StreamCopyRequest *)copyFileAtPath:(NSString *)sourcePath
+                               toPath:(NSString *)destinationPath
+                        progressBlock:(StreamCopyProgressBlock)progressBlock
+                      completionBlock:(StreamCopyCompletionBlock)completionBlock;
+
+@end
@@ -0,0 +1,321 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+ 
+#import "StreamCopier.h"
+
+static NSUInteger const kDefaultStreamCopyBufferSize = 64 * 1024;
+static NSUInteger const kDefaultMaximumPooledBuffers = 4;
+static NSTimeInterval const kProgressReportingInterval = 0.1;
+
+@interface StreamCopyRequest ()
+@property (atomic, assign, readwrite, getter=isCancelled) BOOL cancelled;
+@end
+
+@implementation StreamCopyRequest
+
+- (void)cancel
+{
+    self.cancelled = YES;
+}
+
+@end
+
+@interface StreamCopyFileDestination ()
+@property (nonatomic, strong, readwrite) NSString *filePath;
+@property (nonatomic, strong, readwrite) NSString *partialFilePath;
+@property (nonatomic, strong, readwrite) NSOutputStream *outputStream;
+@end
+
+@implementation StreamCopyFileDestination
+
+- (instancetype)initWithFilePath:(NSString *)filePath
+{
+    NSString *partialFilePath = [[[AlfrescoFileManager sharedManager] temporaryDirectory] stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    return [self initWithFilePath:filePath partialFilePath:partialFilePath];
+}
+
+- (instancetype)initWithFilePath:(NSString *)filePath partialFilePath:(NSString *)partialFilePath
+{
+    self = [super init];
+    if (self)
+    {
+        self.filePath = filePath;
+        self.partialFilePath = partialFilePath;
+        self.outputStream = [[AlfrescoFileManager sharedManager] outputStreamToFileAtPath:partialFilePath append:NO];
+    }
+    return self;
+}
+
+- (BOOL)finishWithSuccess:(BOOL)succeeded error:(NSError **)error
+{
+    [self.outputStream close];
+    AlfrescoFileManager *fileManager = [AlfrescoFileManager sharedManager];
+    
+    if (succeeded)
+    {
+        if ([fileManager fileExistsAtPath:self.filePath])
+        {
+            [fileManager removeItemAtPath:self.filePath error:nil];
+        }
+        
+        succeeded = [fileManager moveItemAtPath:self.partialFilePath toPath:self.filePath error:error];
+        if (!succeeded)
+        {
+            AlfrescoLogError(@"Unable to move from path %@ to %@", self.partialFilePath, self.filePath);
+        }
+    }
+    
+    if (!succeeded)
+    {
+        [fileManager removeItemAtPath:self.partialFilePath error:nil];
+    }
+    return succeeded;
+}
+
+@end
+
+@interface StreamCopier ()
+@property (nonatomic, assign, readwrite) NSUInteger bufferSize;
+@property (nonatomic, assign) NSUInteger maximumPooledBuffers;
+@property (nonatomic, strong) NSMutableArray *bufferPool;
+@property (nonatomic, strong) dispatch_queue_t copyQueue;
+@end
+
+@implementation StreamCopier
+
++ (StreamCopier *)sharedCopier
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[self alloc] initWithBufferSize:kDefaultStreamCopyBufferSize maximumPooledBuffers:kDefaultMaximumPooledBuffers];
+    });
+    return sharedObject;
+}
+
+- (instancetype)initWithBufferSize:(NSUInteger)bufferSize maximumPooledBuffers:(NSUInteger)maximumPooledBuffers
+{
+    self = [super init];
+    if (self)
+    {
+        self.bufferSize = bufferSize;
+        self.maximumPooledBuffers = maximumPooledBuffers;
+        self.bufferPool = [NSMutableArray array];
+        self.copyQueue = dispatch_queue_create("com.alfresco.app.streamcopier", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+#pragma mark - Public Methods
+
+- (BOOL)copyInputStream:(NSInputStream *)inputStream toOutputStream:(NSOutputStream *)outputStream error:(NSError **)error
+{
+    NSError *copyError = nil;
+    if (!inputStream || !outputStream)
+    {
+        copyError = [self nilStreamError];
+    }
+    else
+    {
+        unsigned long long bytesCopied = 0;
+        copyError = [self copyInputStream:inputStream toOutputStream:outputStream expectedLength:0 request:nil bytesCopied:&bytesCopied progressBlock:nil];
+    }
+    
+    if (copyError && error)
+    {
+        *error = copyError;
+    }
+    return copyError == nil;
+}
+
+- (StreamCopyRequest *)copyInputStream:(NSInputStream *)inputStream
+                        toOutputStream:(NSOutputStream *)outputStream
+                        expectedLength:(unsigned long long)expectedLength
+                         progressBlock:(StreamCopyProgressBlock)progressBlock
+                       completionBlock:(StreamCopyCompletionBlock)completionBlock
+{
+    return [self copyInputStream:inputStream toOutputStream:outputStream destination:nil expectedLength:expectedLength progressBlock:progressBlock completionBlock:completionBlock];
+}
+
+- (StreamCopyRequest *)copyFileAtPath:(NSString *)sourcePath
+                               toPath:(NSString *)destinationPath
+                        progressBlock:(StreamCopyProgressBlock)progressBlock
+                      completionBlock:(StreamCopyCompletionBlock)completionBlock
+{
+    AlfrescoFileManager *fileManager = [AlfrescoFileManager sharedManager];
+    NSDictionary *sourceAttributes = [fileManager attributesOfItemAtPath:sourcePath error:nil];
+    unsigned long long expectedLength = [(NSNumber *)sourceAttributes[kAlfrescoFileSize] unsignedLongLongValue];
+    
+    NSInputStream *inputStream = [fileManager inputStreamWithFilePath:sourcePath];
+    StreamCopyFileDestination *destination = [[StreamCopyFileDestination alloc] initWithFilePath:destinationPath];
+    
+    return [self copyInputStream:inputStream toOutputStream:destination.outputStream destination:destination expectedLength:expectedLength progressBlock:progressBlock completionBlock:completionBlock];
+}
+
+#pragma mark - Private Methods
+
+- (NSError *)nilStreamError
+{
+    return [NSError errorWithDomain:@"Provided a nil input or output stream" code:-1 userInfo:nil];
+}
+
+- (StreamCopyRequest *)copyInputStream:(NSInputStream *)inputStream
+                        toOutputStream:(NSOutputStream *)outputStream
+                           destination:(StreamCopyFileDestination *)destination
+                        expectedLength:(unsigned long long)expectedLength
+                         progressBlock:(StreamCopyProgressBlock)progressBlock
+                       completionBlock:(StreamCopyCompletionBlock)completionBlock
+{
+    StreamCopyRequest *request = [StreamCopyRequest new];
+    
+    if (!inputStream || !outputStream)
+    {
+        [destination finishWithSuccess:NO error:nil];
+        NSError *error = [self nilStreamError];
+        if (completionBlock != NULL)
+        {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completionBlock(NO, 0, error);
+            });
+        }
+        return request;
+    }
+    
+    dispatch_async(self.copyQueue, ^{
+        unsigned long long bytesCopied = 0;
+        NSError *error = [self copyInputStream:inputStream toOutputStream:outputStream expectedLength:expectedLength request:request bytesCopied:&bytesCopied progressBlock:progressBlock];
+        
+        // Nothing is left behind when the copy fails or is cancelled
+        NSError *finishError = nil;
+        if (destination && ![destination finishWithSuccess:(error == nil) error:&finishError] && !error)
+        {
+            error = finishError ?: [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeUnknown];
+        }
+        
+        if (completionBlock != NULL)
+        {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completionBlock(error == nil, bytesCopied, error);
+            });
+        }
+    });
+    
+    return request;
+}
+
+- (NSError *)copyInputStream:(NSInputStream *)inputStream
+              toOutputStream:(NSOutputStream *)outputStream
+              expectedLength:(unsigned long long)expectedLength
+                     request:(StreamCopyRequest *)request
+                 bytesCopied:(unsigned long long *)bytesCopied
+               progressBlock:(StreamCopyProgressBlock)progressBlock
+{
+    NSError *error = nil;
+    NSMutableData *bufferData = [self dequeueBuffer];
+    uint8_t *buffer = bufferData.mutableBytes;
+    CFAbsoluteTime lastProgressTime = 0;
+    
+    [inputStream open];
+    [outputStream open];
+    
+    while (!error)
+    {
+        if (request.isCancelled)
+        {
+            error = [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeNetworkRequestCancelled];
+            break;
+        }
+        
+        NSInteger bytesRead = [inputStream read:buffer maxLength:self.bufferSize];
+        if (bytesRead < 0)
+        {
+            error = inputStream.streamError ?: [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeUnknown];
+            break;
+        }
+        else if (bytesRead == 0)
+        {
+            // End of the input stream
+            break;
+        }
+        
+        // The output stream may accept fewer bytes than offered, so keep writing the remainder
+        NSInteger bytesWritten = 0;
+        while (bytesWritten < bytesRead)
+        {
+            NSInteger result = [outputStream write:buffer + bytesWritten maxLength:bytesRead - bytesWritten];
+            if (result <= 0)
+            {
+                error = outputStream.streamError ?: [AlfrescoErrors alfrescoErrorWithAlfrescoErrorCode:kAlfrescoErrorCodeUnknown];
+                break;
+            }
+            bytesWritten += result;
+        }
+        *bytesCopied += bytesWritten;
+        
+        CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+        if (progressBlock != NULL && (now - lastProgressTime) >= kProgressReportingInterval)
+        {
+            lastProgressTime = now;
+            unsigned long long progressBytes = *bytesCopied;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                progressBlock(progressBytes, expectedLength);
+            });
+        }
+    }
+    
+    [inputStream close];
+    [outputStream close];
+    [self enqueueBuffer:bufferData];
+    
+    if (!error && progressBlock != NULL)
+    {
+        unsigned long long progressBytes = *bytesCopied;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            progressBlock(progressBytes, expectedLength);
+        });
+    }
+    
+    return error;
+}
+
+- (NSMutableData *)dequeueBuffer
+{
+    @synchronized(self.bufferPool)
+    {
+        NSMutableData *buffer = self.bufferPool.lastObject;
+        if (buffer)
+        {
+            [self.bufferPool removeLastObject];
+            return buffer;
+        }
+    }
+    return [NSMutableData dataWithLength:self.bufferSize];
+}
+
+- (void)enqueueBuffer:(NSMutableData *)buffer
+{
+    @synchronized(self.bufferPool)
+    {
+        if (self.bufferPool.count < self.maximumPooledBuffers)
+        {
+            [self.bufferPool addObject:buffer];
+        }
+    }
+}
+
+@end
@@ -85,6 +85,8 @@ NSDictionary *dictionaryOfVariableBindingsWithArray(NSArray *views);
 + (TaskPriority *)taskPriorityForPriority:(NSNumber *)priority;
 + (NSString *)displayNameForProcessDefinition:(NSString *)task;
 + (UIImage *)cropImageIntoSquare:(UIImage *)originalImage;
+// Returns the image already drawn into a bitmap, so it isn't decoded on the main thread the first time it is displayed
++ (UIImage *)decodedImage:(UIImage *)image;
 + (void)createBorderedButton:(UIButton *)button label:(NSString *)label color:(UIColor *)color;
 + (NSArray *)localisationsThatRequireTwoRowsInActionView;
 + (NSString *)helpURLLocaleIdentifierForAppLocale;
@@ -92,6 +94,7 @@ NSDictionary *dictionaryOfVariableBindingsWithArray(NSArray *views);
 - (NSString *)accountIdentifierForAccount:(UserAccount *)userAccount;
 + (void)showLocalizedAlertWithTitle:(NSString *)title message:(NSString *)message;
 + (NSData *)dataFromImage:(UIImage *)image metadata:(NSDictionary *)metadata mimetype:(NSString *)mimetype;
++ (BOOL)writeImageData:(NSData *)imageData metadata:(NSDictionary *)metadata toFilePath:(NSString *)filePath;
 + (NSDictionary *)metadataByAddingGPSToMetadata:(NSDictionary *)metadata;
 + (NSDictionary *)metadataByAddingOrientation:(NSInteger)orientation toMetadata:(NSDictionary *)metadata;
 + (NSDateFormatter *)dateFormatter;
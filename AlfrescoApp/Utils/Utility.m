@@ -27,10 +27,11 @@
 #import "UniversalDevice.h"
 #import "ContainerViewController.h"
 #import "LocationManager.h"
+#import "StreamCopier.h"
+#import "RelativeDateFormatter.h"
+#import "FileTypeIconCatalog.h"
 
 
-static NSDictionary *smallIconMappings;
-static NSDictionary *largeIconMappings;
 static NSDateFormatter *dateFormatter;
 static CGFloat const kZoomAnimationSpeed = 0.2f;
 static NSDictionary *helpURLLocaleIdentifiers;
@@ -117,42 +118,12 @@ UIView *activeView(void)
 
 UIImage *smallImageForType(NSString *type)
 {
-    type = [type lowercaseString];
-    
-    if (!smallIconMappings)
-    {
-        NSString *plistPath = [[NSBundle mainBundle] pathForResource:kSmallThumbnailImageMappingPlist ofType:@"plist"];
-        smallIconMappings = [NSDictionary dictionaryWithContentsOfFile:plistPath];
-    }
-    
-    NSString *imageName = [smallIconMappings objectForKey:type];
-    
-    if (!imageName)
-    {
-        imageName = @"small_document.png";
-    }
-    
-    return [UIImage imageNamed:imageName];
+    return [[FileTypeIconCatalog sharedCatalog] smallImageForFileExtension:type];
 }
 
 UIImage *largeImageForType(NSString *type)
 {
-    type = [type lowercaseString];
-    
-    if (!largeIconMappings)
-    {
-        NSString *plistPath = [[NSBundle mainBundle] pathForResource:kLargeThumbnailImageMappingPlist ofType:@"plist"];
-        largeIconMappings = [NSDictionary dictionaryWithContentsOfFile:plistPath];
-    }
-    
-    NSString *imageName = [largeIconMappings objectForKey:type];
-    
-    if (!imageName)
-    {
-        imageName = @"large_document.png";
-    }
-    
-    return [UIImage imageNamed:imageName];
+    return [[FileTypeIconCatalog sharedCatalog] largeImageForFileExtension:type];
 }
 
 /*
@@ -171,89 +142,7 @@ UIImage *resizeImage(UIImage *image, CGSize size)
 
 NSString *relativeTimeFromDate(NSDate *date)
 {
-    if (nil == date)
-    {
-		return @"";
-	}
-
-    NSDate *today = [NSDate date];
-    NSDate *earliest = [today earlierDate:date];
-    BOOL isTodayEarlierDate = (today == earliest);
-    NSDate *latest = isTodayEarlierDate ? date : today;
-
-    NSString *(^relativeDateString)(NSString *key, NSInteger param) = ^NSString *(NSString *key, NSInteger param) {
-        NSString *dateKey = [NSString stringWithFormat:@"relative.date.%@.%@", isTodayEarlierDate ? @"future" : @"past", key];
-        return [NSString stringWithFormat:NSLocalizedString(dateKey, @"Date string"), param];
-    };
-
-    NSTimeInterval seconds_ago = [latest timeIntervalSinceDate:earliest];
-    
-    if (seconds_ago < 2)
-    {
-        return NSLocalizedString(@"relative.date.just-now", @"Just now");
-    }
-
-    double minutes_ago = round(seconds_ago / 60);
-    if (seconds_ago < 60)
-    {
-        return relativeDateString(@"n-seconds", seconds_ago);
-    }
-    if (minutes_ago == 1)
-    {
-        return relativeDateString(@"one-minute", 0);
-    }
-
-    double hours_ago = round(minutes_ago / 60);
-    if (minutes_ago < 60)
-    {
-        return relativeDateString(@"n-minutes", minutes_ago);
-    }
-    if (hours_ago == 1)
-    {
-        return relativeDateString(@"one-hour", 0);
-    }
-
-    double days_ago = round(hours_ago / 24);
-    if (hours_ago < 24)
-    {
-        return relativeDateString(@"n-hours", hours_ago);
-    }
-    if (days_ago == 1)
-    {
-        return relativeDateString(@"one-day", 0);
-    }
-
-    double weeks_ago = round(days_ago / 7);
-    if (days_ago < 7)
-    {
-        return relativeDateString(@"n-days", days_ago);
-    }
-    if (weeks_ago == 1)
-    {
-        return relativeDateString(@"one-week", 0);
-    }
- 
-    double months_ago = round(days_ago / 30);
-    if (days_ago < 30)
-    {
-        return relativeDateString(@"n-weeks", weeks_ago);
-    }
-    if (months_ago == 1)
-    {
-        return relativeDateString(@"one-month", 0);
-    }
-    
-    double years_ago = round(days_ago / 365);
-    if (days_ago < 365)
-    {
-        return relativeDateString(@"n-months", months_ago);
-    }
-    if (years_ago == 1)
-    {
-        return relativeDateString(@"one-year", 0);
-    }
-    
-    return relativeDateString(@"n-years", years_ago);
+    return [[RelativeDateFormatter sharedFormatter] relativeTimeFromDate:date];
 }
 
 NSString *relativeDateFromDate(NSDate *date)
@@ -538,35 +427,12 @@ NSString *filenameAppendedWithDateModified(NSString *filenameOrPath, AlfrescoNod
 
 + (void)writeInputStream:(NSInputStream *)inputStream toOutputStream:(NSOutputStream *)outputStream completionBlock:(void (^)(BOOL succeeded, NSError *error))completionBlock
 {
-    if (!inputStream || !outputStream)
-    {
-        NSError *error = [NSError errorWithDomain:@"Provided a nil input or output stream" code:-1 userInfo:nil];
-        if (completionBlock != NULL)
-        {
-            completionBlock(NO, error);
-        }
-        return;
-    }
-    
-    [inputStream open];
-    [outputStream open];
-    
-    NSUInteger bufferReadSize = 64 * 1024;
-    while ([inputStream hasBytesAvailable])
-    {
-        NSInteger nRead;
-        uint8_t buffer[bufferReadSize];
-        nRead = [inputStream read:buffer maxLength:bufferReadSize];
-        
-        [outputStream write:buffer maxLength:nRead];
-    }
-    
-    [inputStream close];
-    [outputStream close];
-    
+    // Copies on the calling thread, so the completion block has been called by the time this returns
+    NSError *error = nil;
+    BOOL succeeded = [[StreamCopier sharedCopier] copyInputStream:inputStream toOutputStream:outputStream error:&error];
     if (completionBlock != NULL)
     {
-        completionBlock(YES, nil);
+        completionBlock(succeeded, error);
     }
 }
 
@@ -590,33 +456,7 @@ NSString *filenameAppendedWithDateModified(NSString *filenameOrPath, AlfrescoNod
 // TODO: break up Utility in smaller functional pieces (FileUtility, UIUtility and so on) and get rid of the clone.
 + (NSString *)mimeTypeForFileExtension:(NSString *)extension
 {
-    CFStringRef pathExtension = (__bridge_retained CFStringRef)extension;
-    CFStringRef type = UTTypeCreatePreferredIdentifierForTag(kUTTagClassFilenameExtension, pathExtension, NULL);
-    NSString *mimeType = (__bridge_transfer NSString *)UTTypeCopyPreferredTagWithClass(type, kUTTagClassMIMEType);
-    if (NULL != type)
-    {
-        CFRelease(type);
-    }
-    if (NULL != pathExtension)
-    {
-        CFRelease(pathExtension);
-    }
-    
-    if (mimeType.length == 0)
-    {
-        mimeType = @"application/octet-stream";
-    }
-
-    /**
-     * Force the mimetype to audio/mp4 it iOS determined it should be audio/x-m4a
-     * Otherwise the repo applies both audio and exif aspects to the node
-     */
-    if ([mimeType isEqualToString:@"audio/x-m4a"])
-    {
-        mimeType = @"audio/mp4";
-    }
-
-    return mimeType;
+    return [[FileTypeIconCatalog sharedCatalog] mimeTypeForFileExtension:extension];
 }
 
 + (NSString *)fileExtensionFromMimeType:(NSString *)mimeType
@@ -748,6 +588,24 @@ NSString *filenameAppendedWithDateModified(NSString *filenameOrPath, AlfrescoNod
     return croppedImage;
 }
 
++ (UIImage *)decodedImage:(UIImage *)image
+{
+    if (!image)
+    {
+        return nil;
+    }
+    
+    UIGraphicsImageRendererFormat *format = [UIGraphicsImageRendererFormat preferredFormat];
+    format.scale = image.scale;
+    UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:image.size format:format];
+    UIImage *decodedImage = [renderer imageWithActions:^(UIGraphicsImageRendererContext *rendererContext) {
+        [image drawAtPoint:CGPointZero];
+    }];
+    
+    // Redrawing loses what the asset catalog says about the image, such as icons rendered as templates
+    return [decodedImage imageWithRenderingMode:image.renderingMode];
+}
+
 + (void)createBorderedButton:(UIButton *)button label:(NSString *)label color:(UIColor *)color
 {
     // Colour-matched rounded border
@@ -872,6 +730,94 @@ NSString *filenameAppendedWithDateModified(NSString *filenameOrPath, AlfrescoNod
     return imageData;
 }
 
+/**
+ * Writes already encoded image data to disk, merging the given metadata into the existing properties.
+ * The image pixels are copied as-is, so no decode / re-encode cycle takes place.
+ */
++ (BOOL)writeImageData:(NSData *)imageData metadata:(NSDictionary *)metadata toFilePath:(NSString *)filePath
+{
+    CGImageSourceRef imageSource = CGImageSourceCreateWithData((__bridge CFDataRef)imageData, NULL);
+    if (imageSource == NULL)
+    {
+        AlfrescoLogError(@"Failed to create image source");
+        return NO;
+    }
+    
+    BOOL succeeded = NO;
+    NSURL *fileURL = [NSURL fileURLWithPath:filePath];
+    CGImageDestinationRef imageFileDestination = CGImageDestinationCreateWithURL((__bridge CFURLRef)fileURL, CGImageSourceGetType(imageSource), 1, NULL);
+    
+    if (imageFileDestination == NULL)
+    {
+        AlfrescoLogError(@"Failed to create image destination");
+    }
+    else
+    {
+        CGMutableImageMetadataRef imageMetadata = CGImageMetadataCreateMutable();
+        NSMutableDictionary *options = [NSMutableDictionary dictionaryWithObject:@YES forKey:(NSString *)kCGImageDestinationMergeMetadata];
+        // Every property in these dictionaries has to reach the file, so one that cannot be mapped rules out the lossless copy
+        NSSet *requiredDictionaryKeys = [NSSet setWithObjects:(NSString *)kCGImagePropertyExifDictionary, (NSString *)kCGImagePropertyGPSDictionary, (NSString *)kCGImagePropertyTIFFDictionary, nil];
+        __block BOOL requiredPropertiesMapped = YES;
+        
+        [metadata enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+            if ([key isEqualToString:(NSString *)kCGImagePropertyOrientation])
+            {
+                options[(NSString *)kCGImageDestinationOrientation] = value;
+            }
+            else if ([value isKindOfClass:[NSDictionary class]])
+            {
+                [(NSDictionary *)value enumerateKeysAndObjectsUsingBlock:^(NSString *propertyKey, id propertyValue, BOOL *innerStop) {
+                    BOOL mapped = CGImageMetadataSetValueMatchingImageProperty(imageMetadata, (__bridge CFStringRef)key, (__bridge CFStringRef)propertyKey, (__bridge CFTypeRef)propertyValue);
+                    if (!mapped && [requiredDictionaryKeys containsObject:key])
+                    {
+                        AlfrescoLogDebug(@"Unable to map image property %@ %@", key, propertyKey);
+                        requiredPropertiesMapped = NO;
+                    }
+                }];
+            }
+        }];
+        options[(NSString *)kCGImageDestinationMetadata] = (__bridge id)imageMetadata;
+        
+        if (requiredPropertiesMapped)
+        {
+            CFErrorRef error = NULL;
+            succeeded = CGImageDestinationCopyImageSource(imageFileDestination, imageSource, (__bridge CFDictionaryRef)options, &error);
+            if (succeeded == NO)
+            {
+                AlfrescoLogWarning(@"Lossless metadata copy failed: %@", (__bridge NSError *)error);
+            }
+            if (error)
+            {
+                CFRelease(error);
+            }
+        }
+        
+        if (succeeded == NO)
+        {
+            // Fall back to adding the image with the full metadata dictionary when a lossless copy would drop properties or is unsupported
+            CGImageDestinationRef fallbackDestination = CGImageDestinationCreateWithURL((__bridge CFURLRef)fileURL, CGImageSourceGetType(imageSource), 1, NULL);
+            if (fallbackDestination != NULL)
+            {
+                CGImageDestinationAddImageFromSource(fallbackDestination, imageSource, 0, (__bridge CFDictionaryRef)metadata);
+                succeeded = CGImageDestinationFinalize(fallbackDestination);
+                CFRelease(fallbackDestination);
+            }
+        }
+        
+        if (succeeded == NO)
+        {
+            AlfrescoLogError(@"Failed to write image data to %@", filePath);
+        }
+        
+        CFRelease(imageMetadata);
+        CFRelease(imageFileDestination);
+    }
+    
+    CFRelease(imageSource);
+    
+    return succeeded;
+}
+
 + (NSDictionary *)metadataByAddingGPSToMetadata:(NSDictionary *)metadata
 {
     NSMutableDictionary *returnedMetadata = [metadata mutableCopy];
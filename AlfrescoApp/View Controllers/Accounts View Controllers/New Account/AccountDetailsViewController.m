@@ -30,6 +30,7 @@
 #import "PinViewController.h"
 #import "SecurityManager.h"
 #import "TouchIDManager.h"
+#import "AuthenticationProbeCache.h"
 
 @interface AccountDetailsViewController () <AccountDataSourceDelegate, AccountFlowDelegate>
 
@@ -410,6 +411,11 @@
     [AlfrescoSAMLAuthHelper checkIfSAMLIsEnabledForServerWithUrlString:urlString completionBlock:^(AlfrescoSAMLData *samlData, NSError *error) {
         [self hideHUD];
         
+        if (!error)
+        {
+            [[AuthenticationProbeCache sharedCache] cacheResult:([samlData isSamlEnabled] ? AuthenticationProbeResultSAML : AuthenticationProbeResultBasic) forServerURLString:urlString];
+        }
+        
         if (error || [samlData isSamlEnabled] == NO)
         {
             [self goToEnterCredentialsScreen];
@@ -19,6 +19,9 @@
 #import "ActivitiesViewController.h"
 #import "ActivityWrapper.h"
 #import "ActivityTableViewCell.h"
+#import "ActivityRowHeightCache.h"
+#import "ActivityStreamStore.h"
+#import "NodeResolver.h"
 #import "AttributedLabelCell.h"
 #import "DocumentPreviewViewController.h"
 #import "MetaDataViewController.h"
@@ -45,10 +48,11 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
 
 @interface ActivitiesViewController ()
 @property (nonatomic, strong) AlfrescoActivityStreamService *activityService;
-@property (nonatomic, strong) AlfrescoDocumentFolderService *documentFolderService;
 @property (nonatomic, strong) AlfrescoPersonService *personService;
 @property (nonatomic, strong) AlfrescoSiteService *siteService;
 @property (nonatomic, strong) ActivityTableViewCell *prototypeCell;
+@property (nonatomic, strong) ActivityRowHeightCache *rowHeightCache;
+@property (nonatomic, strong) ActivityStreamStore *activityStore;
 @property (nonatomic, strong) NSMutableArray *tableSectionHeaders;
 @property (nonatomic, assign) ActivitiesViewControllerType controllerType;
 @property (nonatomic, strong) NSString *siteShortName;
@@ -63,6 +67,7 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
     if (self)
     {
         [self createAlfrescoServicesWithSession:session];
+        self.displaysRelativeDates = YES;
     }
     return self;
 }
@@ -109,6 +114,18 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
     [[AnalyticsManager sharedManager] trackScreenWithName:kAnalyticsViewMenuActivities];
 }
 
+- (void)traitCollectionDidChange:(UITraitCollection *)previousTraitCollection
+{
+    [super traitCollectionDidChange:previousTraitCollection];
+    
+    if (![self.traitCollection.preferredContentSizeCategory isEqualToString:previousTraitCollection.preferredContentSizeCategory])
+    {
+        // Rows measured for the previous text size won't be asked for again
+        [self.rowHeightCache removeAllHeights];
+        [self.tableView reloadData];
+    }
+}
+
 #pragma mark - Property getters & setters
 
 - (ActivityTableViewCell *)prototypeCell
@@ -121,6 +138,16 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
     return _prototypeCell;
 }
 
+- (ActivityRowHeightCache *)rowHeightCache
+{
+    if (!_rowHeightCache)
+    {
+        _rowHeightCache = [[ActivityRowHeightCache alloc] initWithPrototypeCell:self.prototypeCell];
+    }
+    
+    return _rowHeightCache;
+}
+
 
 #pragma mark - UITableView Data source
 
@@ -149,16 +176,14 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
 
 - (CGFloat)tableView:(UITableView *)tableView heightForRowAtIndexPath:(NSIndexPath *)indexPath
 {
-    [self configureCell:self.prototypeCell forIndexPath:indexPath forOffscreenUse:YES];
-    [self.prototypeCell layoutIfNeeded];
-    CGSize size = [self.prototypeCell.contentView systemLayoutSizeFittingSize:UILayoutFittingCompressedSize];
-    return size.height;
+    ActivityWrapper *activityWrapper = self.tableViewData[indexPath.section][indexPath.row];
+    return [self.rowHeightCache heightForActivity:activityWrapper tableWidth:CGRectGetWidth(tableView.bounds) contentSizeCategory:self.traitCollection.preferredContentSizeCategory];
 }
 
 - (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath
 {
     ActivityTableViewCell *activityCell = [self.tableView dequeueReusableCellWithIdentifier:kActivityCellIdentifier];
-    [self configureCell:activityCell forIndexPath:indexPath forOffscreenUse:NO];
+    [self configureCell:activityCell forIndexPath:indexPath];
     return activityCell;
 }
 
@@ -183,7 +208,10 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
         int skipCount = self.defaultListingContext.skipCount + totalTableViewItemsCount;
         AlfrescoListingContext *moreListingContext = [[AlfrescoListingContext alloc] initWithMaxItems:maxItems skipCount:skipCount];
         
-        if (self.moreItemsAvailable)
+        // Site activities shown from the store before the site has been retrieved can't be paged yet
+        BOOL canRetrieveMoreItems = self.controllerType != ActivitiesViewControllerTypeSite || self.site;
+        
+        if (self.moreItemsAvailable && canRetrieveMoreItems)
         {
             // Show more items are loading ...
             UIActivityIndicatorView *spinner = [[UIActivityIndicatorView alloc] initWithActivityIndicatorStyle:UIActivityIndicatorViewStyleGray];
@@ -191,9 +219,16 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
             self.tableView.tableFooterView = spinner;
             
             void (^handleMoreActivities)(AlfrescoPagingResult *, NSError *) = ^(AlfrescoPagingResult *pagingResult, NSError *pagingError) {
+                if (pagingResult)
+                {
+                    // Entries the stream has moved along since the previous page are already shown
+                    NSArray *addedActivities = [self.activityStore appendOlderEntries:pagingResult.objects hasMoreItems:pagingResult.hasMoreItems];
+                    pagingResult = [[AlfrescoPagingResult alloc] initWithArray:addedActivities hasMoreItems:pagingResult.hasMoreItems totalItems:pagingResult.totalItems];
+                }
                 NSMutableArray *activityData = [self constructTableGroups:pagingResult];
                 // This method needs pagingResult for the hasMoreItems flag, but will use activityData in preference to pagingResult.objects
                 [self addMoreToTableViewWithPagingResult:pagingResult data:activityData error:pagingError];
+                [self precomputeRowHeights];
                 self.tableView.tableFooterView = nil;
                 
                 [self selectIndexPathForAlfrescoNodeInDetailView];
@@ -221,6 +256,21 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
     }
 }
 
+#pragma mark - UIScrollViewDelegate
+
+- (void)scrollViewDidEndDragging:(UIScrollView *)scrollView willDecelerate:(BOOL)decelerate
+{
+    if (!decelerate)
+    {
+        [self warmNodesForVisibleActivities];
+    }
+}
+
+- (void)scrollViewDidEndDecelerating:(UIScrollView *)scrollView
+{
+    [self warmNodesForVisibleActivities];
+}
+
 #pragma mark - UITableView delegate
 
 - (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath
@@ -260,7 +310,6 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
 - (void)createAlfrescoServicesWithSession:(id<AlfrescoSession>)session
 {
     self.activityService = [[AlfrescoActivityStreamService alloc] initWithSession:session];
-    self.documentFolderService = [[AlfrescoDocumentFolderService alloc] initWithSession:session];
     self.personService = [[AlfrescoPersonService alloc] initWithSession:session];
     self.siteService = [[AlfrescoSiteService alloc] initWithSession:session];
 }
@@ -269,67 +318,171 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
 {
     self.tableViewData = nil;
     self.tableSectionHeaders = nil;
+    
+    [self updateActivityStore];
+    // Stored activities are shown straight away, and only newer ones are then fetched
+    BOOL isShowingStoredActivities = [self displayStoredActivities];
 
     if ([ConnectivityManager sharedManager].hasInternetConnection && self.session)
     {
-        // Define an activites handling block
-        void (^handleActivitesBlock)(AlfrescoPagingResult *pagingResult, NSError *pagingError) = ^(AlfrescoPagingResult *pagingResult, NSError *pagingError) {
-            if (pagingError || [pagingResult.objects count] == 0)
-            {
-                [self.tableView reloadData];
-                
-                if (pagingError)
-                {
-                    [Notifier notifyWithAlfrescoError:pagingError];
-                }
-            }
-            else
-            {
-                self.tableView.dataSource = self;
-                self.tableView.delegate = self;
-                self.tableView.allowsSelection = YES;
-                [self reloadTableViewWithPagingResult:pagingResult data:[self constructTableGroups:pagingResult] error:nil];
-                
-                // Introduce delay for tableview to settle before cell is selected
-                [self performSelector:@selector(selectIndexPathForAlfrescoNodeInDetailView) withObject:nil afterDelay:0.2];
-            }
-            [self hidePullToRefreshView];
-            [self hideHUD];
-        };
+        if (!isShowingStoredActivities)
+        {
+            [self showHUD];
+        }
         
         // Load activities depending on the controller type
         switch (self.controllerType)
         {
             case ActivitiesViewControllerTypeRepository:
             {
-                [self showHUD];
-                [self.activityService retrieveActivityStreamWithListingContext:self.defaultListingContext completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-                    handleActivitesBlock(pagingResult, error);
+                [self fetchNewActivitiesUsingBlock:^AlfrescoRequest *(AlfrescoListingContext *listingContext, AlfrescoPagingResultCompletionBlock completionBlock) {
+                    return [self.activityService retrieveActivityStreamWithListingContext:listingContext completionBlock:completionBlock];
                 }];
             }
             break;
                 
             case ActivitiesViewControllerTypeSite:
             {
-                [self showHUD];
-                [self.siteService retrieveSiteWithShortName:self.siteShortName completionBlock:^(AlfrescoSite *site, NSError *siteError) {
-                    if (siteError)
-                    {
-                        [Notifier notifyWithAlfrescoError:siteError];
-                        [self hideHUD];
-                    }
-                    else
-                    {
-                        self.site = site;
-                        [self.activityService retrieveActivityStreamForSite:site listingContext:self.defaultListingContext completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *activitiesError) {
-                            handleActivitesBlock(pagingResult, activitiesError);
-                        }];
-                    }
-                }];
+                ActivityStreamPageFetchBlock fetchSiteActivities = ^AlfrescoRequest *(AlfrescoListingContext *listingContext, AlfrescoPagingResultCompletionBlock completionBlock) {
+                    return [self.activityService retrieveActivityStreamForSite:self.site listingContext:listingContext completionBlock:completionBlock];
+                };
+                
+                if (self.site)
+                {
+                    [self fetchNewActivitiesUsingBlock:fetchSiteActivities];
+                }
+                else
+                {
+                    [self.siteService retrieveSiteWithShortName:self.siteShortName completionBlock:^(AlfrescoSite *site, NSError *siteError) {
+                        if (siteError)
+                        {
+                            [Notifier notifyWithAlfrescoError:siteError];
+                            [self hidePullToRefreshView];
+                            [self hideHUD];
+                        }
+                        else
+                        {
+                            self.site = site;
+                            [self fetchNewActivitiesUsingBlock:fetchSiteActivities];
+                        }
+                    }];
+                }
             }
             break;
         }
     }
+    else
+    {
+        [self hidePullToRefreshView];
+    }
+}
+
+- (void)updateActivityStore
+{
+    UserAccount *account = [AccountManager sharedManager].selectedAccount;
+    NSString *siteShortName = (self.controllerType == ActivitiesViewControllerTypeSite) ? self.siteShortName : nil;
+    NSString *filePath = account ? [ActivityStreamStore filePathForAccountIdentifier:account.accountIdentifier networkIdentifier:account.selectedNetworkId siteShortName:siteShortName] : nil;
+    
+    if (!self.activityStore || ![self.activityStore.filePath isEqualToString:filePath])
+    {
+        self.activityStore = [[ActivityStreamStore alloc] initWithFilePath:filePath];
+        self.activityStore.pageSize = self.defaultListingContext.maxItems;
+    }
+}
+
+/*
+ * Returns whether there were any stored activities to show.
+ */
+- (BOOL)displayStoredActivities
+{
+    NSArray *storedActivities = self.activityStore.entries;
+    if (storedActivities.count == 0)
+    {
+        return NO;
+    }
+    
+    self.tableViewData = nil;
+    self.tableSectionHeaders = nil;
+    self.tableView.dataSource = self;
+    self.tableView.delegate = self;
+    self.tableView.allowsSelection = YES;
+    
+    AlfrescoPagingResult *pagingResult = [[AlfrescoPagingResult alloc] initWithArray:storedActivities hasMoreItems:self.activityStore.hasOlderEntries totalItems:-1];
+    [self reloadTableViewWithPagingResult:pagingResult data:[self constructTableGroups:pagingResult] error:nil];
+    [self precomputeRowHeights];
+    [self warmNodesForVisibleActivities];
+    
+    // Introduce delay for tableview to settle before cell is selected
+    [self performSelector:@selector(selectIndexPathForAlfrescoNodeInDetailView) withObject:nil afterDelay:0.2];
+    
+    return YES;
+}
+
+- (void)fetchNewActivitiesUsingBlock:(ActivityStreamPageFetchBlock)fetchBlock
+{
+    ActivityStreamStore *activityStore = self.activityStore;
+    [activityStore fetchNewEntriesUsingBlock:fetchBlock completionBlock:^(NSArray *newEntries, BOOL entriesReplaced, NSError *error) {
+        // Ignore a fetch for a store no longer shown, e.g. after switching accounts
+        if (activityStore != self.activityStore)
+        {
+            return;
+        }
+        
+        if (error)
+        {
+            if (self.tableViewData.count == 0)
+            {
+                [self.tableView reloadData];
+            }
+            [Notifier notifyWithAlfrescoError:error];
+        }
+        else if (entriesReplaced)
+        {
+            if (![self displayStoredActivities])
+            {
+                [self.tableView reloadData];
+            }
+        }
+        else if (newEntries.count > 0)
+        {
+            [self insertNewerActivities:newEntries];
+        }
+        
+        [self hidePullToRefreshView];
+        [self hideHUD];
+    }];
+}
+
+/*
+ * Adds activities newer than any shown to the top of their sections, keeping the existing rows and their state.
+ */
+- (void)insertNewerActivities:(NSArray *)activities
+{
+    NSCalendar *calendar = [NSCalendar currentCalendar];
+    NSDateComponents *todayComponents = [calendar components:NSCalendarUnitYear | NSCalendarUnitMonth | NSCalendarUnitDay fromDate:[NSDate date]];
+    NSDate *today = [calendar dateFromComponents:todayComponents];
+    
+    // Newest first, so the oldest is inserted first and ends up below the others
+    for (AlfrescoActivityEntry *activity in activities.reverseObjectEnumerator)
+    {
+        ActivityWrapper *activityWrapper = [[ActivityWrapper alloc] initWithActivityEntry:activity];
+        NSString *sectionHeader = [self groupHeaderForActivity:activity relativeToDate:today];
+        NSUInteger index = [self.tableSectionHeaders indexOfObject:sectionHeader];
+        
+        if (index == NSNotFound)
+        {
+            [self.tableSectionHeaders insertObject:sectionHeader atIndex:0];
+            [self.tableViewData insertObject:[NSMutableArray arrayWithObject:activityWrapper] atIndex:0];
+        }
+        else
+        {
+            [self.tableViewData[index] insertObject:activityWrapper atIndex:0];
+        }
+    }
+    
+    [self.tableView reloadData];
+    [self precomputeRowHeights];
+    [self warmNodesForVisibleActivities];
 }
 
 /**
@@ -403,91 +556,97 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
     }
 }
 
-- (void)configureCell:(ActivityTableViewCell *)cell forIndexPath:(NSIndexPath *)indexPath forOffscreenUse:(BOOL)offscreenUse
+/*
+ * Measures the rows the table hasn't asked about yet in the background, so scrolling and paging reach measured rows.
+ */
+- (void)precomputeRowHeights
+{
+    NSArray *activities = [self.tableViewData valueForKeyPath:@"@unionOfArrays.self"];
+    [self.rowHeightCache precomputeHeightsForActivities:activities tableWidth:CGRectGetWidth(self.tableView.bounds) contentSizeCategory:self.traitCollection.preferredContentSizeCategory completionBlock:nil];
+}
+
+- (void)configureCell:(ActivityTableViewCell *)cell forIndexPath:(NSIndexPath *)indexPath
 {
     ActivityWrapper *activityWrapper = self.tableViewData[indexPath.section][indexPath.row];
     cell.detailsLabel.attributedText = activityWrapper.attributedDetailString;
     cell.dateLabel.text = activityWrapper.dateString;
     
-    /**
-     * Offscreen use flag indicates this configuration is for a prototype cell,
-     * so there's no need to perform any processing that doesn't affect cell height.
-     */
-    if (!offscreenUse)
+    if (activityWrapper.showsNodeDetails)
     {
-        if (activityWrapper.nodeIdentifier && !activityWrapper.isDeleteActivity)
-        {
-            cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
-            cell.selectionStyle = UITableViewCellSelectionStyleDefault;
-        }
-        else
-        {
-            cell.accessoryType = UITableViewCellAccessoryNone;
-            cell.selectionStyle = UITableViewCellSelectionStyleNone;
-        }
+        cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
+        cell.selectionStyle = UITableViewCellSelectionStyleDefault;
+    }
+    else
+    {
+        cell.accessoryType = UITableViewCellAccessoryNone;
+        cell.selectionStyle = UITableViewCellSelectionStyleNone;
+    }
 
-        BOOL isActivityDocumentOrFolder = activityWrapper.isDocument || activityWrapper.isFolder;
-        cell.activityImageIsAvatar = !isActivityDocumentOrFolder;
-        
-        if (activityWrapper.activityImage)
-        {
-            // We already have an image for this activity
-            [cell.activityImage setImage:activityWrapper.activityImage withFade:NO];
-        }
-        else
+    BOOL isActivityDocumentOrFolder = activityWrapper.isDocument || activityWrapper.isFolder;
+    cell.activityImageIsAvatar = !isActivityDocumentOrFolder;
+    
+    if (activityWrapper.activityImage)
+    {
+        // We already have an image for this activity
+        [cell.activityImage setImage:activityWrapper.activityImage withFade:NO];
+    }
+    else
+    {
+        if (isActivityDocumentOrFolder)
         {
-            if (isActivityDocumentOrFolder)
+            if (activityWrapper.isDocument)
             {
-                if (activityWrapper.isDocument)
+                UIImage *cachedThumbnail = [[ThumbnailManager sharedManager] thumbnailForDocumentIdentifier:activityWrapper.nodeIdentifier renditionType:kRenditionImageDocLib];
+                if (cachedThumbnail)
                 {
-                    UIImage *cachedThumbnail = [[ThumbnailManager sharedManager] thumbnailForDocumentIdentifier:activityWrapper.nodeIdentifier renditionType:kRenditionImageDocLib];
-                    if (cachedThumbnail)
-                    {
-                        activityWrapper.activityImage = cachedThumbnail;
-                        [cell.activityImage setImage:activityWrapper.activityImage withFade:NO];
-                    }
-                    else
-                    {
-                        activityWrapper.activityImage = smallImageForType([activityWrapper.nodeName pathExtension]);
-                        [cell.activityImage setImage:activityWrapper.activityImage withFade:NO];
-                        
-                        [self retrieveNodeForActivity:activityWrapper completionBlock:^(BOOL success, NSError *error) {
-                            if (success)
-                            {
-                                [[ThumbnailManager sharedManager] retrieveImageForDocument:(AlfrescoDocument *)activityWrapper.node renditionType:kRenditionImageDocLib session:self.session completionBlock:^(UIImage *image, NSError *error) {
-                                    if (image)
-                                    {
-                                        ActivityTableViewCell *thumbnailCell = (ActivityTableViewCell *)[self.tableView cellForRowAtIndexPath:indexPath];
-                                        if (thumbnailCell)
-                                        {
-                                            activityWrapper.activityImage = image;
-                                            [thumbnailCell.activityImage setImage:image withFade:YES];
-                                        }
-                                    }
-                                }];
-                            }
-                        }];
-                    }
+                    activityWrapper.activityImage = cachedThumbnail;
+                    [cell.activityImage setImage:activityWrapper.activityImage withFade:NO];
                 }
                 else
                 {
-                    activityWrapper.activityImage = smallImageForType(@"folder");
+                    activityWrapper.activityImage = smallImageForType([activityWrapper.nodeName pathExtension]);
+                    [cell.activityImage setImage:activityWrapper.activityImage withFade:NO];
+                    
+                    [self retrieveNodeForActivity:activityWrapper completionBlock:^(BOOL success, NSError *error) {
+                        if (success)
+                        {
+                            [[ThumbnailManager sharedManager] retrieveImageForDocument:(AlfrescoDocument *)activityWrapper.node renditionType:kRenditionImageDocLib session:self.session completionBlock:^(UIImage *image, NSError *error) {
+                                if (image)
+                                {
+                                    ActivityTableViewCell *thumbnailCell = (ActivityTableViewCell *)[self.tableView cellForRowAtIndexPath:indexPath];
+                                    if (thumbnailCell)
+                                    {
+                                        activityWrapper.activityImage = image;
+                                        [thumbnailCell.activityImage setImage:image withFade:YES];
+                                    }
+                                }
+                            }];
+                        }
+                    }];
                 }
             }
-            else if (activityWrapper.avatarUserName)
+            else
             {
-                AvatarConfiguration *configuration = [AvatarConfiguration defaultConfigurationWithIdentifier:activityWrapper.avatarUserName session:self.session];
-                [[AvatarManager sharedManager] retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *avatarImage, NSError *avatarError) {
-                        ActivityTableViewCell *avatarCell = (ActivityTableViewCell *)[self.tableView cellForRowAtIndexPath:indexPath];
-                        if (avatarCell)
-                        {
-                            activityWrapper.activityImage = avatarImage;
-                            avatarCell.activityImage.image = activityWrapper.activityImage;
-                        }
-                }];
+                activityWrapper.activityImage = smallImageForType(@"folder");
             }
+        }
+        else if (activityWrapper.avatarUserName)
+        {
+            AvatarConfiguration *configuration = [AvatarConfiguration defaultConfigurationWithIdentifier:activityWrapper.avatarUserName session:self.session];
+            [cell.activityImage setImage:configuration.placeholderImage withFade:NO];
+            [[AvatarManager sharedManager] retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *avatarImage, NSError *avatarError) {
+                activityWrapper.activityImage = avatarImage;
+                ActivityTableViewCell *avatarCell = (ActivityTableViewCell *)[self.tableView cellForRowAtIndexPath:indexPath];
+                if (avatarCell)
+                {
+                    avatarCell.activityImage.image = activityWrapper.activityImage;
+                }
+            }];
+        }
 
-            // We'll always have *something* by the time the code gets here
+        // Cached avatars arrive synchronously, others replace the placeholder when they do
+        if (activityWrapper.activityImage)
+        {
             [cell.activityImage setImage:activityWrapper.activityImage withFade:NO];
         }
     }
@@ -527,26 +686,41 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
         return completionBlock(NO, nil);
     }
     
-    [self.documentFolderService retrieveNodeWithIdentifier:activityWrapper.nodeIdentifier completionBlock:^(AlfrescoNode *node, NSError *nodeError) {
-        if (nodeError)
+    [[NodeResolver sharedResolver] resolveNodeWithIdentifier:activityWrapper.nodeIdentifier session:self.session completionBlock:^(AlfrescoNode *node, AlfrescoPermissions *permissions, NSError *error) {
+        if (!node)
         {
-            return completionBlock(NO, nodeError);
+            return completionBlock(NO, error);
         }
         
-        [self.documentFolderService retrievePermissionsOfNode:node completionBlock:^(AlfrescoPermissions *permissions, NSError *permissionsError) {
-            if (permissionsError)
-            {
-                return completionBlock(NO, permissionsError);
-            }
-            
-            activityWrapper.node = node;
-            activityWrapper.nodePermissions = permissions;
-            
-            completionBlock(YES, nil);
-        }];
+        activityWrapper.node = node;
+        activityWrapper.nodePermissions = permissions;
+        
+        completionBlock(YES, nil);
     }];
 }
 
+/*
+ * Resolves the nodes of the activities on screen ahead of them being tapped.
+ */
+- (void)warmNodesForVisibleActivities
+{
+    if (!self.session || ![ConnectivityManager sharedManager].hasInternetConnection)
+    {
+        return;
+    }
+    
+    NSMutableArray *nodeIdentifiers = [NSMutableArray array];
+    for (NSIndexPath *indexPath in self.tableView.indexPathsForVisibleRows)
+    {
+        ActivityWrapper *activityWrapper = self.tableViewData[indexPath.section][indexPath.row];
+        if (activityWrapper.showsNodeDetails && !activityWrapper.node)
+        {
+            [nodeIdentifiers addObject:activityWrapper.nodeIdentifier];
+        }
+    }
+    [[NodeResolver sharedResolver] warmNodesWithIdentifiers:nodeIdentifiers session:self.session];
+}
+
 #pragma mark - Session received notification handler
 
 - (void)sessionReceived:(NSNotification *)notification
@@ -554,6 +728,12 @@ typedef NS_ENUM(NSUInteger, ActivitiesViewControllerType)
     id<AlfrescoSession> session = notification.object;
     self.session = session;
     
+    if ([notification.name isEqualToString:kAlfrescoSessionReceivedNotification])
+    {
+        // Activity identifiers are only unique within one repository, so another account's rows can't reuse the heights
+        [self.rowHeightCache removeAllHeights];
+    }
+    
     [self createAlfrescoServicesWithSession:session];
     if ([self shouldRefresh] && [notification.name isEqualToString:kAlfrescoSessionReceivedNotification])
     {
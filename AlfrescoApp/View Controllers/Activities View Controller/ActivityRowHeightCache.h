@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+@class ActivityWrapper;
+@class ActivityTableViewCell;
+
+/**
+ * Row heights for the activities list, keyed by activity identifier, content size category and table width.
+ *
+ * The prototype cell is laid out with Auto Layout once per table width, content size category and accessory type
+ * to find the width of the details label and the height around it. Each activity's height is then found by measuring
+ * its details text with TextKit, so measured rows need no layout pass at all.
+ * Must be used from the main thread; precomputing measures on a background queue.
+ */
+@interface ActivityRowHeightCache : NSObject
+
+/// Auto Layout passes made on the prototype cell
+@property (nonatomic, assign, readonly) NSUInteger numberOfLayoutPasses;
+/// Activities measured with TextKit, on the main thread or in the background
+@property (nonatomic, assign, readonly) NSUInteger numberOfTextMeasurements;
+
+- (instancetype)initWithPrototypeCell:(ActivityTableViewCell *)prototypeCell;
+
+- (CGFloat)heightForActivity:(ActivityWrapper *)activity tableWidth:(CGFloat)tableWidth contentSizeCategory:(UIContentSizeCategory)contentSizeCategory;
+
+/*
+ * Measures the activities not yet measured off the main thread. The optional completion block is called on the main thread.
+ */
+- (void)precomputeHeightsForActivities:(NSArray *)activities tableWidth:(CGFloat)tableWidth contentSizeCategory:(UIContentSizeCategory)contentSizeCategory completionBlock:(void (^)(void))completionBlock;
+
+/*
+ * Forgets every measured height, e.g. when the text size or the account changes. Measurements still running in the
+ * background are discarded.
+ */
+- (void)removeAllHeights;
+
+@end
@@ -0,0 +1,224 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+ 
+#import "ActivityRowHeightCache.h"
+#import "ActivityWrapper.h"
+#import "ActivityTableViewCell.h"
+
+static NSUInteger const kMaximumCachedRowHeights = 5000;
+
+/**
+ * What a layout pass on the prototype cell tells us about rows with a given width, content size category and accessory.
+ */
+@interface ActivityRowLayoutMetrics : NSObject
+@property (nonatomic, assign) CGFloat detailsWidth;
+@property (nonatomic, strong) UIFont *detailsFont;
+// Height of the row other than its details text
+@property (nonatomic, assign) CGFloat fixedHeight;
+@end
+
+@implementation ActivityRowLayoutMetrics
+@end
+
+@interface ActivityRowHeightCache ()
+@property (nonatomic, strong) ActivityTableViewCell *prototypeCell;
+@property (nonatomic, strong) NSCache *rowHeights;
+@property (nonatomic, strong) NSMutableDictionary *layoutMetrics;
+@property (nonatomic, strong) dispatch_queue_t measurementQueue;
+// Incremented by removeAllHeights, so precomputed heights started before it are not stored. Guarded by rowHeights.
+@property (nonatomic, assign) NSUInteger generation;
+@property (nonatomic, assign, readwrite) NSUInteger numberOfLayoutPasses;
+@end
+
+@implementation ActivityRowHeightCache
+{
+    // Incremented from the main thread and the measurement queue, so only accessed under a lock
+    NSUInteger _numberOfTextMeasurements;
+}
+
+- (instancetype)initWithPrototypeCell:(ActivityTableViewCell *)prototypeCell
+{
+    self = [super init];
+    if (self)
+    {
+        self.prototypeCell = prototypeCell;
+        self.rowHeights = [[NSCache alloc] init];
+        self.rowHeights.countLimit = kMaximumCachedRowHeights;
+        self.layoutMetrics = [NSMutableDictionary dictionary];
+        self.measurementQueue = dispatch_queue_create("com.alfresco.app.activityrowheights", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+#pragma mark - Public Functions
+
+- (CGFloat)heightForActivity:(ActivityWrapper *)activity tableWidth:(CGFloat)tableWidth contentSizeCategory:(UIContentSizeCategory)contentSizeCategory
+{
+    NSString *key = [self keyForActivity:activity tableWidth:tableWidth contentSizeCategory:contentSizeCategory];
+    NSNumber *cachedHeight = key ? [self.rowHeights objectForKey:key] : nil;
+    if (cachedHeight)
+    {
+        return cachedHeight.doubleValue;
+    }
+    
+    ActivityRowLayoutMetrics *metrics = [self layoutMetricsForActivity:activity tableWidth:tableWidth contentSizeCategory:contentSizeCategory];
+    CGFloat height = [self heightOfActivity:activity withMetrics:metrics];
+    if (key)
+    {
+        [self.rowHeights setObject:@(height) forKey:key];
+    }
+    return height;
+}
+
+- (void)precomputeHeightsForActivities:(NSArray *)activities tableWidth:(CGFloat)tableWidth contentSizeCategory:(UIContentSizeCategory)contentSizeCategory completionBlock:(void (^)(void))completionBlock
+{
+    // Layout metrics need the prototype cell, so they are found here; only the text measurement moves off the main thread
+    NSMutableArray *unmeasuredActivities = [NSMutableArray array];
+    NSMutableArray *unmeasuredMetrics = [NSMutableArray array];
+    NSMutableArray *unmeasuredKeys = [NSMutableArray array];
+    for (ActivityWrapper *activity in activities)
+    {
+        NSString *key = [self keyForActivity:activity tableWidth:tableWidth contentSizeCategory:contentSizeCategory];
+        if (key && ![self.rowHeights objectForKey:key])
+        {
+            [unmeasuredActivities addObject:activity];
+            [unmeasuredMetrics addObject:[self layoutMetricsForActivity:activity tableWidth:tableWidth contentSizeCategory:contentSizeCategory]];
+            [unmeasuredKeys addObject:key];
+        }
+    }
+    
+    NSUInteger generation = self.generation;
+    dispatch_async(self.measurementQueue, ^{
+        [unmeasuredActivities enumerateObjectsUsingBlock:^(ActivityWrapper *activity, NSUInteger index, BOOL *stop) {
+            CGFloat height = [self heightOfActivity:activity withMetrics:unmeasuredMetrics[index]];
+            @synchronized (self.rowHeights)
+            {
+                if (generation != self.generation)
+                {
+                    *stop = YES;
+                    return;
+                }
+                [self.rowHeights setObject:@(height) forKey:unmeasuredKeys[index]];
+            }
+        }];
+        
+        if (completionBlock)
+        {
+            dispatch_async(dispatch_get_main_queue(), completionBlock);
+        }
+    });
+}
+
+- (NSUInteger)numberOfTextMeasurements
+{
+    @synchronized (self)
+    {
+        return _numberOfTextMeasurements;
+    }
+}
+
+- (void)removeAllHeights
+{
+    @synchronized (self.rowHeights)
+    {
+        self.generation++;
+        [self.rowHeights removeAllObjects];
+    }
+    [self.layoutMetrics removeAllObjects];
+}
+
+#pragma mark - Private Functions
+
+- (NSString *)keyForActivity:(ActivityWrapper *)activity tableWidth:(CGFloat)tableWidth contentSizeCategory:(UIContentSizeCategory)contentSizeCategory
+{
+    NSString *identifier = activity.activityIdentifier;
+    if (!identifier)
+    {
+        return nil;
+    }
+    return [NSString stringWithFormat:@"%@|%@|%.1f", identifier, contentSizeCategory, tableWidth];
+}
+
+- (ActivityRowLayoutMetrics *)layoutMetricsForActivity:(ActivityWrapper *)activity tableWidth:(CGFloat)tableWidth contentSizeCategory:(UIContentSizeCategory)contentSizeCategory
+{
+    BOOL showsDisclosureIndicator = activity.showsNodeDetails;
+    NSString *key = [NSString stringWithFormat:@"%@|%.1f|%d", contentSizeCategory, tableWidth, showsDisclosureIndicator];
+    ActivityRowLayoutMetrics *metrics = self.layoutMetrics[key];
+    if (metrics)
+    {
+        return metrics;
+    }
+    
+    ActivityTableViewCell *cell = self.prototypeCell;
+    cell.accessoryType = showsDisclosureIndicator ? UITableViewCellAccessoryDisclosureIndicator : UITableViewCellAccessoryNone;
+    cell.bounds = CGRectMake(0, 0, tableWidth, CGRectGetHeight(cell.bounds));
+    cell.detailsLabel.attributedText = [[NSAttributedString alloc] initWithString:@"A"];
+    cell.dateLabel.text = @"A";
+    [cell setNeedsLayout];
+    [cell layoutIfNeeded];
+    CGFloat fittingHeight = [cell.contentView systemLayoutSizeFittingSize:UILayoutFittingCompressedSize].height;
+    self.numberOfLayoutPasses++;
+    
+    metrics = [ActivityRowLayoutMetrics new];
+    metrics.detailsWidth = CGRectGetWidth(cell.detailsLabel.frame);
+    metrics.detailsFont = cell.detailsLabel.font;
+    metrics.fixedHeight = fittingHeight - [self heightOfText:cell.detailsLabel.attributedText font:metrics.detailsFont width:metrics.detailsWidth];
+    self.layoutMetrics[key] = metrics;
+    
+    return metrics;
+}
+
+- (CGFloat)heightOfActivity:(ActivityWrapper *)activity withMetrics:(ActivityRowLayoutMetrics *)metrics
+{
+    @synchronized (self)
+    {
+        _numberOfTextMeasurements++;
+    }
+    return metrics.fixedHeight + [self heightOfText:activity.attributedDetailString font:metrics.detailsFont width:metrics.detailsWidth];
+}
+
+/*
+ * TextKit objects are created per call, so this is safe on any thread.
+ */
+- (CGFloat)heightOfText:(NSAttributedString *)text font:(UIFont *)font width:(CGFloat)width
+{
+    if (text.length == 0)
+    {
+        return 0;
+    }
+    
+    // The label supplies the font wherever the text doesn't specify one
+    NSTextStorage *textStorage = [[NSTextStorage alloc] initWithAttributedString:text];
+    [text enumerateAttribute:NSFontAttributeName inRange:NSMakeRange(0, text.length) options:0 usingBlock:^(id value, NSRange range, BOOL *stop) {
+        if (!value)
+        {
+            [textStorage addAttribute:NSFontAttributeName value:font range:range];
+        }
+    }];
+    
+    NSLayoutManager *layoutManager = [[NSLayoutManager alloc] init];
+    NSTextContainer *textContainer = [[NSTextContainer alloc] initWithSize:CGSizeMake(width, CGFLOAT_MAX)];
+    textContainer.lineFragmentPadding = 0;
+    [layoutManager addTextContainer:textContainer];
+    [textStorage addLayoutManager:layoutManager];
+    [layoutManager ensureLayoutForTextContainer:textContainer];
+    
+    return ceil([layoutManager usedRectForTextContainer:textContainer].size.height);
+}
+
+@end
@@ -20,11 +20,14 @@
 
 - (id)initWithActivityEntry:(AlfrescoActivityEntry *)activityEntry;
 
+- (NSString *)activityIdentifier;
 - (NSString *)nodeIdentifier;
 - (NSString *)nodeName;
 - (BOOL)isDocument;
 - (BOOL)isFolder;
 - (BOOL)isDeleteActivity;
+// Whether selecting the activity shows its node
+- (BOOL)showsNodeDetails;
 
 @property (nonatomic, strong, readonly) NSString *avatarUserName;
 @property (nonatomic, strong) UIImage *activityImage;
@@ -52,7 +52,6 @@ static NSString * const kActivitySummaryCustom1 = @"custom1";
 
 @property (nonatomic, strong, readwrite) NSString *avatarUserName;
 @property (nonatomic, strong, readwrite) NSAttributedString *attributedDetailString;
-@property (nonatomic, strong, readwrite) NSString *dateString;
 
 @end
 
@@ -87,6 +86,11 @@ static NSString * const kActivitySummaryCustom1 = @"custom1";
     return self;
 }
 
+- (NSString *)activityIdentifier
+{
+    return self.activityEntry.identifier;
+}
+
 - (NSString *)nodeIdentifier
 {
     return self.activityEntry.nodeIdentifier;
@@ -112,6 +116,17 @@ static NSString * const kActivitySummaryCustom1 = @"custom1";
     return self.activityEntry.isDeleted;
 }
 
+- (BOOL)showsNodeDetails
+{
+    return self.nodeIdentifier && !self.isDeleteActivity;
+}
+
+- (NSString *)dateString
+{
+    // Not cached here; the shared formatter already caches per date bucket and the string must track the current time
+    return relativeTimeFromDate(self.activityEntry.createdAt);
+}
+
 - (NSString *)description
 {
     if (self.activityEntry)
@@ -220,7 +235,6 @@ static NSString * const kActivitySummaryCustom1 = @"custom1";
     NSArray *detailTokenValues = @[self.title, self.fullName, self.custom0, self.custom1, self.siteTitle, self.secondFullName];
     
     self.attributedDetailString = [self attributedStringForTemplate:NSLocalizedStringFromTable(self.activityEntry.type, @"Activities", @"Activity template string") withReplacements:detailTokenValues];
-    self.dateString = relativeTimeFromDate(self.activityEntry.createdAt);
 }
 
 - (NSString *)fullNameFromFirstName:(NSString *)firstName lastName:(NSString *)lastName
@@ -54,6 +54,7 @@ static CGFloat const kMaxCommentTextViewHeight = 100.0f;
         self.node = node;
         self.permissions = permissions;
         self.delegate = delegate;
+        self.displaysRelativeDates = YES;
         [self createAlfrescoServicesWithSession:session];
     }
     return self;
@@ -252,6 +253,7 @@ static CGFloat const kMaxCommentTextViewHeight = 100.0f;
     }
     
     AvatarConfiguration *configuration = [AvatarConfiguration defaultConfigurationWithIdentifier:currentComment.createdBy session:self.session];
+    cell.avatarImageView.image = configuration.placeholderImage;
     [[AvatarManager sharedManager] retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *avatarImage, NSError *avatarError) {
         [cell.avatarImageView setImage:avatarImage withFade:YES];
     }];
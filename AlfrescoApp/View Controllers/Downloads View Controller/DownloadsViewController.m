@@ -47,6 +47,7 @@ static NSString * const kDownloadInProgressExtension = @"-download";
     self = [super initWithNibName:kDownloadsInterface andSession:nil];
     if (self)
     {
+        self.displaysRelativeDates = YES;
         [[NSNotificationCenter defaultCenter] addObserver:self
                                                  selector:@selector(documentDownloadStarted:)
                                                      name:kDocumentPreviewManagerWillStartLocalDocumentDownloadNotification
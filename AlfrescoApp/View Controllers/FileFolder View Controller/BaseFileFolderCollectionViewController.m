@@ -24,11 +24,18 @@
 #import "UIView+Orientation.h"
 #import "AlfrescoApp-Swift.h"
 #import "AccountManager.h"
+#import "NodeCollection.h"
+#import "ScrollFrameTimeMonitor.h"
+#import "SearchQueryEngine.h"
 
 
 static const CGSize kUploadPopoverPreferedSize = {320, 640};
 @interface BaseFileFolderCollectionViewController() <MultiplePhotosUploadDelegate, CameraDelegate>
 
+@property (nonatomic, strong) ScrollFrameTimeMonitor *scrollFrameTimeMonitor;
+@property (nonatomic, strong) SearchQueryEngine *searchQueryEngine;
+@property (nonatomic, weak) id<AlfrescoSession> searchQueryEngineSession;
+
 @end
 
 @implementation BaseFileFolderCollectionViewController
@@ -50,6 +57,10 @@ static const CGSize kUploadPopoverPreferedSize = {320, 640};
     UINib *cellNib = [UINib nibWithNibName:NSStringFromClass([FileFolderCollectionViewCell class]) bundle:nil];
     [self.collectionView registerNib:cellNib forCellWithReuseIdentifier:[FileFolderCollectionViewCell cellIdentifier]];
     
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(relativeDatesNeedRefresh:) name:kAlfrescoRelativeDatesNeedRefreshNotification object:nil];
+    
+    self.scrollFrameTimeMonitor = [[ScrollFrameTimeMonitor alloc] initWithName:NSStringFromClass([self class])];
+    
     self.collectionView.delegate = self;
     self.listLayout = [[BaseCollectionViewFlowLayout alloc] initWithNumberOfColumns:1 itemHeight:kCellHeight shouldSwipeToDelete:YES hasHeader:self.shouldIncludeSearchBar];
     self.listLayout.dataSourceInfoDelegate = self.inUseDataSource;
@@ -90,6 +101,12 @@ static const CGSize kUploadPopoverPreferedSize = {320, 640};
     }
 }
 
+- (void)viewDidDisappear:(BOOL)animated
+{
+    [super viewDidDisappear:animated];
+    [self.scrollFrameTimeMonitor stopMonitoring];
+}
+
 #pragma mark - Custom getters and setters
 
 - (UIImagePickerController *)imagePickerController
@@ -135,6 +152,26 @@ static const CGSize kUploadPopoverPreferedSize = {320, 640};
     }
 }
 
+#pragma mark - UIScrollViewDelegate methods
+
+- (void)scrollViewWillBeginDragging:(UIScrollView *)scrollView
+{
+    [self.scrollFrameTimeMonitor startMonitoring];
+}
+
+- (void)scrollViewDidEndDragging:(UIScrollView *)scrollView willDecelerate:(BOOL)decelerate
+{
+    if (!decelerate)
+    {
+        [self.scrollFrameTimeMonitor stopMonitoring];
+    }
+}
+
+- (void)scrollViewDidEndDecelerating:(UIScrollView *)scrollView
+{
+    [self.scrollFrameTimeMonitor stopMonitoring];
+}
+
 #pragma mark - UISearchBarDelegate Functions
 
 - (void)searchBarSearchButtonClicked:(UISearchBar *)searchBar
@@ -183,7 +220,19 @@ static const CGSize kUploadPopoverPreferedSize = {320, 640};
 - (void)searchString:(NSString *)stringToSearch isFromSearchBar:(BOOL)isFromSearchBar searchOptions:(AlfrescoKeywordSearchOptions *)options
 {
     [self showHUD];
-    self.searchDataSource = [[SearchCollectionViewDataSource alloc] initWithSearchString:stringToSearch searchOptions:options emptyMessage:@"No search results" session:self.session delegate:self listingContext:nil];
+    
+    // One engine serves every search from this screen, so a new search cancels the one in flight and repeats are cached
+    if (!self.searchQueryEngine)
+    {
+        self.searchQueryEngine = [[SearchQueryEngine alloc] initWithSession:self.session];
+    }
+    else if (self.searchQueryEngineSession != self.session)
+    {
+        [self.searchQueryEngine updateSession:self.session];
+    }
+    self.searchQueryEngineSession = self.session;
+    
+    self.searchDataSource = [[SearchCollectionViewDataSource alloc] initWithSearchString:stringToSearch searchOptions:options searchEngine:self.searchQueryEngine emptyMessage:@"No search results" session:self.session delegate:self listingContext:nil];
     self.isOnSearchResults = isFromSearchBar;
     
 }
@@ -352,6 +401,22 @@ static const CGSize kUploadPopoverPreferedSize = {320, 640};
 }
 
 #pragma mark - Internal methods
+- (void)relativeDatesNeedRefresh:(NSNotification *)notification
+{
+    if (self.view.window == nil)
+    {
+        return;
+    }
+    
+    for (UICollectionViewCell *cell in self.collectionView.visibleCells)
+    {
+        if ([cell isKindOfClass:[FileFolderCollectionViewCell class]])
+        {
+            [(FileFolderCollectionViewCell *)cell refreshNodeDetails];
+        }
+    }
+}
+
 - (void)deleteNode:(AlfrescoNode *)nodeToDelete completionBlock:(void (^)(BOOL success))completionBlock
 {
     [self.inUseDataSource deleteNode:nodeToDelete completionBlock:^(BOOL success) {
@@ -439,8 +504,7 @@ static const CGSize kUploadPopoverPreferedSize = {320, 640};
 
 - (void)selectIndexPathForAlfrescoNodeInDetailView
 {
-    NSArray *collectionViewNodeIdentifiers = [self.inUseDataSource nodeIdentifiersOfCurrentCollection];
-    NSIndexPath *indexPath = [self indexPathForNodeWithIdentifier:[UniversalDevice detailViewItemIdentifier] inNodeIdentifiers:collectionViewNodeIdentifiers];
+    NSIndexPath *indexPath = [self.inUseDataSource indexPathForNodeWithIdentifier:[UniversalDevice detailViewItemIdentifier]];
     
     [self.collectionView selectItemAtIndexPath:indexPath animated:YES scrollPosition:UICollectionViewScrollPositionNone];
 }
@@ -608,8 +672,41 @@ static const CGSize kUploadPopoverPreferedSize = {320, 640};
 
 - (void)dataSourceUpdated
 {
-    [self hidePullToRefreshView];
     [self reloadCollectionView];
+    [self didUpdateDataSource];
+}
+
+- (void)dataSource:(RepositoryCollectionViewDataSource *)dataSource updatedWithChanges:(NodeCollectionChanges *)changes
+{
+    // Batch updates are only valid against what the collection view currently shows, otherwise fall back to a full reload
+    BOOL canApplyChanges = (self.collectionView.dataSource == dataSource) && self.collectionView.window && (self.collectionView.numberOfSections > 0) && ([self.collectionView numberOfItemsInSection:0] == changes.previousCount);
+    
+    if (!canApplyChanges)
+    {
+        [self dataSourceUpdated];
+        return;
+    }
+    
+    if (changes.hasChanges)
+    {
+        [self.collectionView performBatchUpdates:^{
+            [self.collectionView deleteItemsAtIndexPaths:changes.deletedIndexPaths];
+            [self.collectionView insertItemsAtIndexPaths:changes.insertedIndexPaths];
+            [self.collectionView reloadItemsAtIndexPaths:changes.reloadedIndexPaths];
+            for (NSArray *move in changes.movedIndexPaths)
+            {
+                [self.collectionView moveItemAtIndexPath:move.firstObject toIndexPath:move.lastObject];
+            }
+        } completion:^(BOOL finished) {
+            [self updateEmptyView];
+        }];
+    }
+    [self didUpdateDataSource];
+}
+
+- (void)didUpdateDataSource
+{
+    [self hidePullToRefreshView];
     [self selectIndexPathForAlfrescoNodeInDetailView];
     [self updateUIUsingFolderPermissionsWithAnimation:NO];
     self.isLoadingAnotherPage = NO;
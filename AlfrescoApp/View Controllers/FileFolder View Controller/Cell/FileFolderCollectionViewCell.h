@@ -21,6 +21,7 @@
 #import "CollectionViewProtocols.h"
 
 @class SyncNodeStatus;
+@class NodeCellViewModel;
 
 @interface FileFolderCollectionViewCell : UICollectionViewCell
 
@@ -46,6 +47,9 @@
 - (void)registerForNotifications;
 - (void)removeNotifications;
 - (void)updateCellInfoWithNode:(AlfrescoNode *)node nodeStatus:(SyncNodeStatus *)nodeStatus;
+- (void)updateCellWithViewModel:(NodeCellViewModel *)viewModel smallThumbnail:(BOOL)smallThumbnail;
+- (void)stopObservingSyncProgress;
+- (void)refreshNodeDetails;
 - (void)updateStatusIconsIsFavoriteNode:(BOOL)isFavorite isSyncNode:(BOOL)isSyncNode isTopLevelSyncNode:(BOOL)isTopLevelSyncNode animate:(BOOL)animate;
 
 - (void) showDeleteAction:(BOOL)showDelete animated:(BOOL)animated;
@@ -20,6 +20,9 @@
 #import "SyncNodeStatus.h"
 #import "BaseLayoutAttributes.h"
 #import "RealmSyncManager.h"
+#import "RealmSyncCore.h"
+#import "SyncProgressEventBus.h"
+#import "NodeCellViewModel.h"
 
 static NSString * const kAlfrescoNodeCellIdentifier = @"CollectionViewCellIdentifier";
 
@@ -33,9 +36,11 @@ static CGFloat const kStatusIconsAnimationDuration = 0.2f;
 static CGFloat const kStatusViewVerticalDisplacementOverImage = -40.0f;
 static CGFloat const kStatusViewVerticalDisplacementSideImage = 5.0f;
 
-@interface FileFolderCollectionViewCell ()
+@interface FileFolderCollectionViewCell () <SyncProgressObserver>
 
 @property (nonatomic, strong) SyncNodeStatus *nodeStatus;
+@property (nonatomic, strong) NSString *syncProgressNodeId;
+@property (nonatomic, assign) BOOL isRegisteredForNotifications;
 @property (nonatomic, assign) BOOL isFavorite;
 @property (nonatomic, assign) BOOL isSyncNode;
 @property (nonatomic, assign) BOOL isTopLevelSyncNode;
@@ -103,6 +108,9 @@ static CGFloat const kStatusViewVerticalDisplacementSideImage = 5.0f;
     self.deleteButton.titleLabel.numberOfLines = 1;
     self.deleteButton.titleLabel.adjustsFontSizeToFitWidth = YES;
     self.deleteButton.accessibilityIdentifier = kCollectionViewCellDeleteButtonIdentifier;
+    
+    // Registered once for the lifetime of the cell rather than on every dequeue
+    [self registerForNotifications];
 }
 
 - (void)setBounds:(CGRect)bounds
@@ -113,10 +121,13 @@ static CGFloat const kStatusViewVerticalDisplacementSideImage = 5.0f;
 
 - (void)registerForNotifications
 {
-    [[NSNotificationCenter defaultCenter] addObserver:self
-                                             selector:@selector(statusChanged:)
-                                                 name:kSyncStatusChangeNotification
-                                               object:nil];
+    [self observeSyncProgressForNode:self.node];
+    if (self.isRegisteredForNotifications)
+    {
+        return;
+    }
+    self.isRegisteredForNotifications = YES;
+    
     [[NSNotificationCenter defaultCenter] addObserver:self
                                              selector:@selector(didAddNodeToFavorites:)
                                                  name:kFavouritesDidAddNodeNotification
@@ -138,6 +149,27 @@ static CGFloat const kStatusViewVerticalDisplacementSideImage = 5.0f;
 - (void)removeNotifications
 {
     [[NSNotificationCenter defaultCenter] removeObserver:self];
+    self.isRegisteredForNotifications = NO;
+    [self stopObservingSyncProgress];
+}
+
+- (void)stopObservingSyncProgress
+{
+    [self observeSyncProgressForNode:nil];
+}
+
+- (void)observeSyncProgressForNode:(AlfrescoNode *)node
+{
+    NSString *nodeId = node ? [[RealmSyncCore sharedSyncCore] syncIdentifierForNode:node] : nil;
+    if ([nodeId isEqualToString:self.syncProgressNodeId])
+    {
+        return;
+    }
+    
+    SyncProgressEventBus *eventBus = [SyncProgressEventBus sharedBus];
+    [eventBus removeObserver:self forNodeId:self.syncProgressNodeId];
+    [eventBus addObserver:self forNodeId:nodeId];
+    self.syncProgressNodeId = nodeId;
 }
 
 - (void)layoutSubviews
@@ -159,11 +191,36 @@ static CGFloat const kStatusViewVerticalDisplacementSideImage = 5.0f;
 {
     self.node = node;
     self.nodeStatus = nodeStatus;
+    [self observeSyncProgressForNode:node];
     self.filename.text = node.name;
     [self updateNodeDetails:nodeStatus];
 }
 
+- (void)updateCellWithViewModel:(NodeCellViewModel *)viewModel smallThumbnail:(BOOL)smallThumbnail
+{
+    [self updateCellInfoWithNode:viewModel.node nodeStatus:viewModel.nodeStatus];
+    [self applyStatusIconsIsFavoriteNode:viewModel.isFavorite isSyncNode:viewModel.isSyncNode isTopLevelSyncNode:viewModel.isTopLevelSyncNode animate:NO];
+    [self updateCellWithNodeStatus:viewModel.nodeStatus propertyChanged:kSyncStatus];
+    [self.image setImage:[viewModel imageForSmallThumbnail:smallThumbnail] withFade:NO];
+}
+
+- (void)refreshNodeDetails
+{
+    if (self.node)
+    {
+        [self updateNodeDetails:self.nodeStatus];
+    }
+}
+
 - (void)updateStatusIconsIsFavoriteNode:(BOOL)isFavorite isSyncNode:(BOOL)isSyncNode isTopLevelSyncNode:(BOOL)isTopLevelSyncNode animate:(BOOL)animate
+{
+    [self applyStatusIconsIsFavoriteNode:isFavorite isSyncNode:isSyncNode isTopLevelSyncNode:isTopLevelSyncNode animate:animate];
+    
+    self.nodeStatus = [[RealmSyncManager sharedManager] syncStatusForNodeWithId:self.node.identifier];
+    [self updateCellWithNodeStatus:self.nodeStatus propertyChanged:kSyncStatus];
+}
+
+- (void)applyStatusIconsIsFavoriteNode:(BOOL)isFavorite isSyncNode:(BOOL)isSyncNode isTopLevelSyncNode:(BOOL)isTopLevelSyncNode animate:(BOOL)animate
 {
     self.isSyncNode = isSyncNode;
     self.isFavorite = isFavorite;
@@ -253,9 +310,6 @@ static CGFloat const kStatusViewVerticalDisplacementSideImage = 5.0f;
     {
         updateStatusIcons();
     }
-    
-    self.nodeStatus = [[RealmSyncManager sharedManager] syncStatusForNodeWithId:self.node.identifier];
-    [self updateCellWithNodeStatus:self.nodeStatus propertyChanged:kSyncStatus];
 }
 
 + (NSString *)cellIdentifier
@@ -397,39 +451,39 @@ static CGFloat const kStatusViewVerticalDisplacementSideImage = 5.0f;
 
 #pragma mark - Notification Methods
 
-- (void)statusChanged:(NSNotification *)notification
+- (void)didReceiveSyncProgressEvents:(NSArray<SyncProgressEvent *> *)events
 {
-    NSDictionary *info = notification.userInfo;
-    if ([self.node.identifier hasPrefix:[info objectForKey:kSyncStatusNodeIdKey]])
+    for (SyncProgressEvent *event in events)
     {
-        SyncNodeStatus *nodeStatus = notification.object;
+        SyncNodeStatus *nodeStatus = event.nodeStatus;
+        if (![self.node.identifier hasPrefix:nodeStatus.nodeId])
+        {
+            continue;
+        }
+        
         self.nodeStatus = nodeStatus;
-        NSString *propertyChanged = [info objectForKey:kSyncStatusPropertyChangedKey];
+        NSSet *changedProperties = event.changedProperties;
         
-        // Avoid interogating persistence layers while performing progress updates and update the UI every 100 KB
-        if (![kSyncBytesTransfered isEqualToString:propertyChanged]) {
+        // Avoid interogating persistence layers while performing progress updates
+        BOOL isProgressUpdateOnly = (changedProperties.count == 1 && [changedProperties containsObject:kSyncBytesTransfered]);
+        if (!isProgressUpdateOnly)
+        {
             self.isTopLevelSyncNode = [self.node isTopLevelSyncNode];
-        } else {
-            if (nodeStatus.bytesTransfered % (100 * 1024)) {
-                return;
-            }
         }
         
-        dispatch_async(dispatch_get_main_queue(), ^{
-            if ([self.node.identifier hasPrefix:nodeStatus.nodeId])
-            {
-                if (!self.isSyncNode && nodeStatus.status != SyncStatusRemoved)
-                {
-                    [self updateStatusIconsIsFavoriteNode:self.isFavorite isSyncNode:NO isTopLevelSyncNode:self.isTopLevelSyncNode animate:YES];
-                }
-                if (nodeStatus.status == SyncStatusRemoved)
-                {
-                    self.nodeStatus = nil;
-                    [self updateStatusIconsIsFavoriteNode:self.isFavorite isSyncNode:NO isTopLevelSyncNode:NO animate:YES];
-                }
-                [self updateCellWithNodeStatus:nodeStatus propertyChanged:propertyChanged];
-            }
-        });
+        if (!self.isSyncNode && nodeStatus.status != SyncStatusRemoved)
+        {
+            [self updateStatusIconsIsFavoriteNode:self.isFavorite isSyncNode:NO isTopLevelSyncNode:self.isTopLevelSyncNode animate:YES];
+        }
+        if (nodeStatus.status == SyncStatusRemoved)
+        {
+            self.nodeStatus = nil;
+            [self updateStatusIconsIsFavoriteNode:self.isFavorite isSyncNode:NO isTopLevelSyncNode:NO animate:YES];
+        }
+        for (NSString *propertyChanged in changedProperties)
+        {
+            [self updateCellWithNodeStatus:nodeStatus propertyChanged:propertyChanged];
+        }
     }
 }
 
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+@class SyncNodeStatus;
+
+/**
+ * Everything a FileFolderCollectionViewCell displays for a node, resolved ahead of time so binding a cell does no lookups of its own.
+ */
+@interface NodeCellViewModel : NSObject
+
+@property (nonatomic, strong, readonly) AlfrescoNode *node;
+@property (nonatomic, strong, readonly) UIImage *smallImage;
+@property (nonatomic, strong, readonly) UIImage *largeImage;
+@property (nonatomic, strong) UIImage *thumbnail;
+@property (nonatomic, assign) BOOL hasRequestedThumbnail;
+@property (nonatomic, strong) SyncNodeStatus *nodeStatus;
+@property (nonatomic, assign) BOOL isFavorite;
+@property (nonatomic, assign) BOOL isSyncNode;
+@property (nonatomic, assign) BOOL isTopLevelSyncNode;
+// YES until the sync and thumbnail state has been resolved in the background
+@property (nonatomic, assign) BOOL isPlaceholder;
+
+- (instancetype)initWithNode:(AlfrescoNode *)node;
+
+/*
+ * Returns YES if the view model still describes the given node, i.e. it has not been renamed or modified since.
+ */
+- (BOOL)isCurrentForNode:(AlfrescoNode *)node;
+
+/*
+ * The thumbnail, if there is one, otherwise the file type icon for the requested size.
+ */
+- (UIImage *)imageForSmallThumbnail:(BOOL)smallThumbnail;
+
+@end
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "NodeCellViewModel.h"
+#import "FileTypeIconCatalog.h"
+
+static NSString * const kFolderIconType = @"folder";
+
+@interface NodeCellViewModel ()
+
+@property (nonatomic, strong, readwrite) AlfrescoNode *node;
+@property (nonatomic, strong, readwrite) UIImage *smallImage;
+@property (nonatomic, strong, readwrite) UIImage *largeImage;
+
+@end
+
+@implementation NodeCellViewModel
+
+- (instancetype)initWithNode:(AlfrescoNode *)node
+{
+    self = [super init];
+    if (self)
+    {
+        self.node = node;
+        self.isPlaceholder = YES;
+        
+        FileTypeIconCatalog *catalog = [FileTypeIconCatalog sharedCatalog];
+        NSString *iconType = node.isFolder ? kFolderIconType : node.name.pathExtension;
+        self.smallImage = [catalog smallImageForFileExtension:iconType];
+        self.largeImage = [catalog largeImageForFileExtension:iconType];
+    }
+    return self;
+}
+
+- (BOOL)isCurrentForNode:(AlfrescoNode *)node
+{
+    if (node == self.node)
+    {
+        return YES;
+    }
+    
+    BOOL sameName = (node.name == self.node.name) || [node.name isEqualToString:self.node.name];
+    BOOL sameModificationDate = (node.modifiedAt == self.node.modifiedAt) || [node.modifiedAt isEqualToDate:self.node.modifiedAt];
+    return [node.identifier isEqualToString:self.node.identifier] && sameName && sameModificationDate;
+}
+
+- (UIImage *)imageForSmallThumbnail:(BOOL)smallThumbnail
+{
+    if (self.thumbnail)
+    {
+        return self.thumbnail;
+    }
+    return smallThumbnail ? self.smallImage : self.largeImage;
+}
+
+@end
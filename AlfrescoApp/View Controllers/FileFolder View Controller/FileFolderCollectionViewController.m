@@ -541,7 +541,7 @@ static CGFloat const kSearchBarAnimationDuration = 0.2f;
     if([cell isKindOfClass:[FileFolderCollectionViewCell class]])
     {
         FileFolderCollectionViewCell *nodeCell = (FileFolderCollectionViewCell *)cell;
-        [nodeCell removeNotifications];
+        [nodeCell stopObservingSyncProgress];
     }
 }
 
@@ -38,6 +38,7 @@
 @property (nonatomic, strong, readonly) MBProgressHUD *progressHUD;
 @property (nonatomic, assign) BOOL allowsPullToRefresh;
 @property (nonatomic, assign) BOOL isDisplayingSearch;
+@property (nonatomic, assign) BOOL displaysRelativeDates;
 
 - (id)initWithSession:(id<AlfrescoSession>)session;
 - (id)initWithNibName:(NSString *)nibName andSession:(id<AlfrescoSession>)session;
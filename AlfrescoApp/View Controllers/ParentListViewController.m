@@ -51,6 +51,10 @@
                                                  selector:@selector(sessionReceived:)
                                                      name:kAlfrescoSessionRefreshedNotification
                                                    object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(relativeDatesNeedRefresh:)
+                                                     name:kAlfrescoRelativeDatesNeedRefreshNotification
+                                                   object:nil];
     }
     return self;
 }
@@ -358,6 +362,18 @@
     }
 }
 
+- (void)relativeDatesNeedRefresh:(NSNotification *)notification
+{
+    if (self.displaysRelativeDates && self.isViewLoaded && self.view.window && !self.tableView.isEditing)
+    {
+        NSArray *visibleIndexPaths = self.tableView.indexPathsForVisibleRows;
+        if (visibleIndexPaths.count > 0)
+        {
+            [self.tableView reloadRowsAtIndexPaths:visibleIndexPaths withRowAnimation:UITableViewRowAnimationNone];
+        }
+    }
+}
+
 #pragma mark - UIRefreshControl Functions
 
 - (void)refreshTableView:(UIRefreshControl *)refreshControl
@@ -158,6 +158,8 @@ static NSInteger const kSearchResultsIndex = 0;
         
         AvatarConfiguration *configuration = [AvatarConfiguration defaultConfigurationWithIdentifier:person.identifier session:self.session];
         configuration.ignoreCache = YES;
+        configuration.person = person;
+        cell.avatarImageView.image = [[AvatarManager sharedManager] cachedAvatarForIdentifier:person.identifier] ?: configuration.placeholderImage;
         [[AvatarManager sharedManager] retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *image, NSError *error) {
             cell.avatarImageView.image = image;
         }];
@@ -288,6 +288,8 @@ typedef NS_ENUM(NSUInteger, ContactInformationType)
     
     /// Request the avatar
     AvatarConfiguration *configuration = [AvatarConfiguration defaultConfigurationWithIdentifier:self.username session:self.session];
+    configuration.person = person;
+    self.avatarImageView.image = configuration.placeholderImage;
     [[AvatarManager sharedManager] retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *avatarImage, NSError *avatarError) {
         [self.avatarImageView setImage:avatarImage withFade:YES];
     }];
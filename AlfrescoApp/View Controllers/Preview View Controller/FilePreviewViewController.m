@@ -51,6 +51,8 @@ static CGFloat sDownloadProgressHeight;
 @property (nonatomic, strong) FullScreenAnimationController *animationController;
 // Used for the file path initialiser
 @property (nonatomic, strong) NSString *filePathForFileToLoad;
+// The document whose cached content is kept while it is on screen
+@property (nonatomic, strong) AlfrescoDocument *displayedCachedDocument;
 
 // IBOutlets
 @property (nonatomic, weak) IBOutlet ThumbnailImageView *previewThumbnailImageView;
@@ -77,7 +79,6 @@ static CGFloat sDownloadProgressHeight;
 
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(editingDocumentCompleted:) name:kAlfrescoDocumentEditedNotification object:nil];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(downloadStarting:) name:kDocumentPreviewManagerWillStartDownloadNotification object:nil];
-        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(downloadProgress:) name:kDocumentPreviewManagerProgressNotification object:nil];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(downloadComplete:) name:kDocumentPreviewManagerDocumentDownloadCompletedNotification object:nil];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(fileLocallyUpdated:) name:kAlfrescoSaveBackLocalComplete object:nil];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(sessionRefreshed:) name:kAlfrescoSessionRefreshedNotification object:nil];
@@ -110,6 +111,12 @@ static CGFloat sDownloadProgressHeight;
 - (void)dealloc
 {
     [[NSNotificationCenter defaultCenter] removeObserver:self];
+    // Stops the download unless something else is still waiting for it
+    [self.downloadRequest cancel];
+    if (self.displayedCachedDocument)
+    {
+        [[DocumentPreviewManager sharedManager] endDisplayingDocument:self.displayedCachedDocument];
+    }
 }
 
 - (void)viewDidLoad
@@ -164,6 +171,7 @@ static CGFloat sDownloadProgressHeight;
 - (void)refreshViewController
 {
     self.downloadProgressView.progress = 0.0f;
+    [self updateDisplayedCachedDocument:(self.filePathForFileToLoad ? nil : self.document)];
     
     if (self.filePathForFileToLoad)
     {
@@ -183,12 +191,37 @@ static CGFloat sDownloadProgressHeight;
             self.previewThumbnailImageView.alpha = 1.0f;
             self.previewThumbnailImageView.hidden = NO;
         }
-        else
-        {
-            // Request the document download
-            self.downloadRequest = [[DocumentPreviewManager sharedManager] downloadDocument:self.document session:self.session];
-        }
+        
+        // Request the document download, or join the one already in progress
+        [self startDownload];
+    }
+}
+
+- (void)updateDisplayedCachedDocument:(AlfrescoDocument *)document
+{
+    // Begin with the new document first, so content shared by both is never left unpinned
+    DocumentPreviewManager *previewManager = [DocumentPreviewManager sharedManager];
+    if (document)
+    {
+        [previewManager beginDisplayingDocument:document];
+    }
+    if (self.displayedCachedDocument)
+    {
+        [previewManager endDisplayingDocument:self.displayedCachedDocument];
     }
+    self.displayedCachedDocument = document;
+}
+
+- (void)startDownload
+{
+    // Subscribe before letting go of any earlier request, so a download of the same document carries on
+    AlfrescoRequest *previousRequest = self.downloadRequest;
+    
+    __weak typeof(self) weakSelf = self;
+    self.downloadRequest = [[DocumentPreviewManager sharedManager] downloadDocument:self.document session:self.session priority:DocumentPreviewDownloadPriorityForeground progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+        [weakSelf updateDownloadProgressWithBytesTransferred:bytesTransferred bytesTotal:bytesTotal];
+    } completionBlock:nil];
+    [previousRequest cancel];
 }
 
 - (void)handleThumbnailSingleTap:(UIGestureRecognizer *)gesture
@@ -196,7 +229,7 @@ static CGFloat sDownloadProgressHeight;
     [self.previewThumbnailImageView removeGestureRecognizer:gesture];
     
     // Restart the document download
-    self.downloadRequest = [[DocumentPreviewManager sharedManager] downloadDocument:self.document session:self.session];
+    [self startDownload];
 }
 
 - (void)dismiss:(UIBarButtonItem *)sender
@@ -442,23 +475,14 @@ static CGFloat sDownloadProgressHeight;
     }
 }
 
-- (void)downloadProgress:(NSNotification *)notification
+- (void)updateDownloadProgressWithBytesTransferred:(unsigned long long)bytesTransferred bytesTotal:(unsigned long long)bytesTotal
 {
-    NSString *displayedDocumentIdentifier = [[DocumentPreviewManager sharedManager] documentIdentifierForDocument:self.document];
-    NSString *notificationDocumentIdentifier = notification.userInfo[kDocumentPreviewManagerDocumentIdentifierNotificationKey];
-    
-    if ([displayedDocumentIdentifier isEqualToString:notificationDocumentIdentifier])
+    if (self.downloadProgressContainer.hidden)
     {
-        if (self.downloadProgressContainer.hidden)
-        {
-            [self showProgressViewAnimated:YES];
-        }
-        
-        unsigned long long bytesTransferred = [notification.userInfo[kDocumentPreviewManagerProgressBytesRecievedNotificationKey] unsignedLongLongValue];
-        unsigned long long bytesTotal = [notification.userInfo[kDocumentPreviewManagerProgressBytesTotalNotificationKey] unsignedLongLongValue];
-        
-        [self.downloadProgressView setProgress:(float)bytesTransferred/(float)bytesTotal];
+        [self showProgressViewAnimated:YES];
     }
+    
+    [self.downloadProgressView setProgress:(float)bytesTransferred/(float)bytesTotal];
 }
 
 - (void)downloadComplete:(NSNotification *)notification
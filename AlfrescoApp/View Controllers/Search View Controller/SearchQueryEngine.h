@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+@class LatencyHistogram;
+
+/**
+ * Performs a single search request. The engine uses the repository services by default; tests replay against a stub.
+ */
+@protocol SearchQueryEngineBackend <NSObject>
+
+- (AlfrescoRequest *)searchWithKeywords:(NSString *)keywords type:(SearchViewControllerDataSourceType)type options:(AlfrescoKeywordSearchOptions *)options listingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock;
+
+@end
+
+/**
+ * Runs keyword searches for files, folders, people and sites on behalf of one search screen.
+ *
+ * Starting a query supersedes the previous one: its pending debounce is dropped, its requests are cancelled and any
+ * late results are ignored. Pages are kept in a small LRU cache, a file or folder query refining a cached complete result
+ * (e.g. "repo" after "rep") is answered by filtering that result, and the page following the one just shown is prefetched.
+ * All methods must be called on the main thread; completion blocks are called on the main thread.
+ */
+@interface SearchQueryEngine : NSObject
+
+// Delay after the last keystroke before a debounced query is sent. Defaults to 0.3s.
+@property (nonatomic, assign) NSTimeInterval debounceInterval;
+@property (nonatomic, assign) BOOL prefetchesNextPage;
+// Time from starting a query, including any debounce, to its results being delivered
+@property (nonatomic, strong, readonly) LatencyHistogram *queryLatencyHistogram;
+// Round trip time of requests made to the backend
+@property (nonatomic, strong, readonly) LatencyHistogram *requestLatencyHistogram;
+@property (nonatomic, assign, readonly) NSUInteger numberOfCachedResponses;
+
+- (instancetype)initWithSession:(id<AlfrescoSession>)session;
+- (instancetype)initWithBackend:(id<SearchQueryEngineBackend>)backend cacheCapacity:(NSUInteger)cacheCapacity;
+
+/*
+ * Cached results belong to the previous session's user, so they are dropped.
+ */
+- (void)updateSession:(id<AlfrescoSession>)session;
+
+/*
+ * Starts a new query for the first page described by the listing context, superseding any current query.
+ */
+- (void)searchFor:(NSString *)keywords type:(SearchViewControllerDataSourceType)type options:(AlfrescoKeywordSearchOptions *)options listingContext:(AlfrescoListingContext *)listingContext debounce:(BOOL)debounce completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock;
+
+/*
+ * Retrieves a further page of the current query, using the prefetched page when available.
+ */
+- (void)retrieveResultsWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock;
+
+- (void)cancel;
+- (void)clearCache;
+
+@end
@@ -0,0 +1,478 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "SearchQueryEngine.h"
+#import "LatencyHistogram.h"
+
+static NSTimeInterval const kSearchQueryEngineDefaultDebounceInterval = 0.3;
+static NSUInteger const kSearchQueryEngineDefaultCacheCapacity = 40;
+static NSTimeInterval const kSearchQueryEngineCacheLifetime = 120.0;
+
+#pragma mark - Service backend
+
+/**
+ * Sends searches to the repository services of a session.
+ */
+@interface SearchQueryServiceBackend : NSObject <SearchQueryEngineBackend>
+
+@property (nonatomic, strong) AlfrescoSearchService *searchService;
+@property (nonatomic, strong) AlfrescoPersonService *personService;
+@property (nonatomic, strong) AlfrescoSiteService *siteService;
+
+- (instancetype)initWithSession:(id<AlfrescoSession>)session;
+
+@end
+
+@implementation SearchQueryServiceBackend
+
+- (instancetype)initWithSession:(id<AlfrescoSession>)session
+{
+    self = [super init];
+    if (self)
+    {
+        self.searchService = [[AlfrescoSearchService alloc] initWithSession:session];
+        self.personService = [[AlfrescoPersonService alloc] initWithSession:session];
+        self.siteService = [[AlfrescoSiteService alloc] initWithSession:session];
+    }
+    return self;
+}
+
+- (AlfrescoRequest *)searchWithKeywords:(NSString *)keywords type:(SearchViewControllerDataSourceType)type options:(AlfrescoKeywordSearchOptions *)options listingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    AlfrescoRequest *request = nil;
+    
+    switch (type)
+    {
+        case SearchViewControllerDataSourceTypeSearchUsers:
+        {
+            request = [self.personService searchWithKeywords:keywords listingContext:listingContext completionBlock:completionBlock];
+        }
+            break;
+            
+        case SearchViewControllerDataSourceTypeSearchSites:
+        {
+            request = [self.siteService searchWithKeywords:keywords listingContext:listingContext completionBlock:completionBlock];
+        }
+            break;
+            
+        default:
+        {
+            request = [self.searchService searchWithKeywords:keywords options:options listingContext:listingContext completionBlock:completionBlock];
+        }
+            break;
+    }
+    
+    return request;
+}
+
+@end
+
+#pragma mark - Cache entry
+
+@interface SearchQueryCacheEntry : NSObject
+
+@property (nonatomic, strong) NSString *signature;
+@property (nonatomic, strong) NSString *keywords;
+@property (nonatomic, assign) int skipCount;
+@property (nonatomic, strong) AlfrescoPagingResult *pagingResult;
+@property (nonatomic, strong) NSDate *creationDate;
+
+@end
+
+@implementation SearchQueryCacheEntry
+@end
+
+#pragma mark - Engine
+
+@interface SearchQueryEngine ()
+
+@property (nonatomic, strong) id<SearchQueryEngineBackend> backend;
+@property (nonatomic, assign) NSUInteger cacheCapacity;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, SearchQueryCacheEntry *> *cache;
+// Cache keys, least recently used first
+@property (nonatomic, strong) NSMutableArray<NSString *> *cacheKeys;
+@property (nonatomic, strong, readwrite) LatencyHistogram *queryLatencyHistogram;
+@property (nonatomic, strong, readwrite) LatencyHistogram *requestLatencyHistogram;
+@property (nonatomic, assign, readwrite) NSUInteger numberOfCachedResponses;
+// Incremented by every new query; work started for an older generation is stale
+@property (nonatomic, assign) NSUInteger queryGeneration;
+@property (nonatomic, strong) NSString *keywords;
+@property (nonatomic, assign) SearchViewControllerDataSourceType type;
+@property (nonatomic, strong) AlfrescoKeywordSearchOptions *options;
+@property (nonatomic, strong) AlfrescoRequest *currentRequest;
+@property (nonatomic, strong) AlfrescoRequest *prefetchRequest;
+@property (nonatomic, strong) NSString *prefetchKey;
+@property (nonatomic, strong) NSMutableArray<AlfrescoPagingResultCompletionBlock> *prefetchCompletionBlocks;
+
+@end
+
+@implementation SearchQueryEngine
+
+- (instancetype)initWithSession:(id<AlfrescoSession>)session
+{
+    return [self initWithBackend:[[SearchQueryServiceBackend alloc] initWithSession:session] cacheCapacity:kSearchQueryEngineDefaultCacheCapacity];
+}
+
+- (instancetype)initWithBackend:(id<SearchQueryEngineBackend>)backend cacheCapacity:(NSUInteger)cacheCapacity
+{
+    self = [super init];
+    if (self)
+    {
+        self.backend = backend;
+        self.cacheCapacity = cacheCapacity;
+        self.cache = [NSMutableDictionary dictionary];
+        self.cacheKeys = [NSMutableArray array];
+        self.debounceInterval = kSearchQueryEngineDefaultDebounceInterval;
+        self.prefetchesNextPage = YES;
+        self.queryLatencyHistogram = [[LatencyHistogram alloc] initWithName:@"Search query latency"];
+        self.requestLatencyHistogram = [[LatencyHistogram alloc] initWithName:@"Search request latency"];
+        self.prefetchCompletionBlocks = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_currentRequest cancel];
+    [_prefetchRequest cancel];
+    
+    if (_queryLatencyHistogram.count > 0)
+    {
+        AlfrescoLogDebug(@"%@; %lu served from cache", [_queryLatencyHistogram summary], (unsigned long)_numberOfCachedResponses);
+        AlfrescoLogDebug(@"%@", [_requestLatencyHistogram summary]);
+    }
+}
+
+#pragma mark - Public Methods
+
+- (void)updateSession:(id<AlfrescoSession>)session
+{
+    if ([self.backend isKindOfClass:[SearchQueryServiceBackend class]])
+    {
+        self.backend = [[SearchQueryServiceBackend alloc] initWithSession:session];
+    }
+    [self clearCache];
+}
+
+- (void)searchFor:(NSString *)keywords type:(SearchViewControllerDataSourceType)type options:(AlfrescoKeywordSearchOptions *)options listingContext:(AlfrescoListingContext *)listingContext debounce:(BOOL)debounce completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    [self cancel];
+    
+    self.keywords = keywords;
+    self.type = type;
+    self.options = options;
+    
+    NSUInteger generation = self.queryGeneration;
+    NSDate *startDate = [NSDate date];
+    
+    if (debounce && self.debounceInterval > 0)
+    {
+        __weak typeof(self) weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.debounceInterval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            [weakSelf retrievePageWithListingContext:listingContext generation:generation startDate:startDate completionBlock:completionBlock];
+        });
+    }
+    else
+    {
+        [self retrievePageWithListingContext:listingContext generation:generation startDate:startDate completionBlock:completionBlock];
+    }
+}
+
+- (void)retrieveResultsWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    [self retrievePageWithListingContext:listingContext generation:self.queryGeneration startDate:[NSDate date] completionBlock:completionBlock];
+}
+
+- (void)cancel
+{
+    self.queryGeneration++;
+    
+    [self.currentRequest cancel];
+    self.currentRequest = nil;
+    [self.prefetchRequest cancel];
+    self.prefetchRequest = nil;
+    self.prefetchKey = nil;
+    [self.prefetchCompletionBlocks removeAllObjects];
+}
+
+- (void)clearCache
+{
+    [self.cache removeAllObjects];
+    [self.cacheKeys removeAllObjects];
+}
+
+#pragma mark - Private Methods
+
+- (void)retrievePageWithListingContext:(AlfrescoListingContext *)listingContext generation:(NSUInteger)generation startDate:(NSDate *)startDate completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    if (generation != self.queryGeneration)
+    {
+        // Superseded while waiting for the debounce interval
+        return;
+    }
+    
+    NSString *signature = [self signatureForType:self.type options:self.options listingContext:listingContext];
+    NSString *key = [self cacheKeyForSignature:signature keywords:self.keywords skipCount:listingContext.skipCount];
+    
+    AlfrescoPagingResult *pagingResult = [self cachedPagingResultForKey:key];
+    if (!pagingResult && listingContext.skipCount == 0)
+    {
+        pagingResult = [self refinedPagingResultForSignature:signature keywords:self.keywords];
+        if (pagingResult)
+        {
+            [self storePagingResult:pagingResult forKey:key signature:signature keywords:self.keywords skipCount:0];
+        }
+    }
+    
+    if (pagingResult)
+    {
+        self.numberOfCachedResponses++;
+        [self.queryLatencyHistogram recordLatency:-startDate.timeIntervalSinceNow];
+        [self prefetchPageFollowingListingContext:listingContext pagingResult:pagingResult generation:generation];
+        completionBlock(pagingResult, nil);
+        return;
+    }
+    
+    __weak typeof(self) weakSelf = self;
+    AlfrescoPagingResultCompletionBlock deliveryBlock = ^(AlfrescoPagingResult *result, NSError *error) {
+        [weakSelf.queryLatencyHistogram recordLatency:-startDate.timeIntervalSinceNow];
+        // Start the prefetch first, so a request for the next page made on delivery joins it
+        [weakSelf prefetchPageFollowingListingContext:listingContext pagingResult:result generation:generation];
+        completionBlock(result, error);
+    };
+    
+    if ([key isEqualToString:self.prefetchKey])
+    {
+        [self.prefetchCompletionBlocks addObject:deliveryBlock];
+        return;
+    }
+    
+    NSDate *requestDate = [NSDate date];
+    self.currentRequest = [self.backend searchWithKeywords:self.keywords type:self.type options:self.options listingContext:listingContext completionBlock:^(AlfrescoPagingResult *result, NSError *error) {
+        if (generation != weakSelf.queryGeneration)
+        {
+            // Results of a superseded query may still arrive if the request could not be cancelled in time
+            return;
+        }
+        
+        weakSelf.currentRequest = nil;
+        [weakSelf.requestLatencyHistogram recordLatency:-requestDate.timeIntervalSinceNow];
+        if (result)
+        {
+            [weakSelf storePagingResult:result forKey:key signature:signature keywords:weakSelf.keywords skipCount:listingContext.skipCount];
+        }
+        deliveryBlock(result, error);
+    }];
+}
+
+- (void)prefetchPageFollowingListingContext:(AlfrescoListingContext *)listingContext pagingResult:(AlfrescoPagingResult *)pagingResult generation:(NSUInteger)generation
+{
+    if (!self.prefetchesNextPage || !pagingResult.hasMoreItems || generation != self.queryGeneration)
+    {
+        return;
+    }
+    
+    AlfrescoListingContext *nextListingContext = [[AlfrescoListingContext alloc] initWithMaxItems:listingContext.maxItems
+                                                                                        skipCount:listingContext.skipCount + (int)pagingResult.objects.count
+                                                                                     sortProperty:listingContext.sortProperty
+                                                                                    sortAscending:listingContext.sortAscending];
+    
+    NSString *signature = [self signatureForType:self.type options:self.options listingContext:nextListingContext];
+    NSString *key = [self cacheKeyForSignature:signature keywords:self.keywords skipCount:nextListingContext.skipCount];
+    if (self.cache[key] || [key isEqualToString:self.prefetchKey])
+    {
+        return;
+    }
+    
+    [self.prefetchRequest cancel];
+    [self.prefetchCompletionBlocks removeAllObjects];
+    self.prefetchKey = key;
+    
+    __weak typeof(self) weakSelf = self;
+    NSDate *requestDate = [NSDate date];
+    self.prefetchRequest = [self.backend searchWithKeywords:self.keywords type:self.type options:self.options listingContext:nextListingContext completionBlock:^(AlfrescoPagingResult *result, NSError *error) {
+        if (generation != weakSelf.queryGeneration || ![key isEqualToString:weakSelf.prefetchKey])
+        {
+            return;
+        }
+        
+        NSArray *completionBlocks = [weakSelf.prefetchCompletionBlocks copy];
+        [weakSelf.prefetchCompletionBlocks removeAllObjects];
+        weakSelf.prefetchRequest = nil;
+        weakSelf.prefetchKey = nil;
+        
+        [weakSelf.requestLatencyHistogram recordLatency:-requestDate.timeIntervalSinceNow];
+        if (result)
+        {
+            [weakSelf storePagingResult:result forKey:key signature:signature keywords:weakSelf.keywords skipCount:nextListingContext.skipCount];
+        }
+        
+        for (AlfrescoPagingResultCompletionBlock completionBlock in completionBlocks)
+        {
+            completionBlock(result, error);
+        }
+    }];
+}
+
+#pragma mark - Cache
+
+- (NSString *)signatureForType:(SearchViewControllerDataSourceType)type options:(AlfrescoKeywordSearchOptions *)options listingContext:(AlfrescoListingContext *)listingContext
+{
+    return [NSString stringWithFormat:@"%ld|%@|%d|%d|%@|%d|%d|%@|%d", (long)type, options.typeName, options.exactMatch, options.includeContent, options.folder.identifier, options.includeDescendants, listingContext.maxItems, listingContext.sortProperty, listingContext.sortAscending];
+}
+
+- (NSString *)cacheKeyForSignature:(NSString *)signature keywords:(NSString *)keywords skipCount:(int)skipCount
+{
+    return [NSString stringWithFormat:@"%@|%d|%@", signature, skipCount, keywords.lowercaseString];
+}
+
+- (AlfrescoPagingResult *)cachedPagingResultForKey:(NSString *)key
+{
+    SearchQueryCacheEntry *entry = self.cache[key];
+    if (!entry)
+    {
+        return nil;
+    }
+    
+    [self.cacheKeys removeObject:key];
+    if (-entry.creationDate.timeIntervalSinceNow > kSearchQueryEngineCacheLifetime)
+    {
+        [self.cache removeObjectForKey:key];
+        return nil;
+    }
+    
+    [self.cacheKeys addObject:key];
+    return entry.pagingResult;
+}
+
+- (void)storePagingResult:(AlfrescoPagingResult *)pagingResult forKey:(NSString *)key signature:(NSString *)signature keywords:(NSString *)keywords skipCount:(int)skipCount
+{
+    if (self.cacheCapacity == 0)
+    {
+        return;
+    }
+    
+    SearchQueryCacheEntry *entry = [SearchQueryCacheEntry new];
+    entry.signature = signature;
+    entry.keywords = keywords.lowercaseString;
+    entry.skipCount = skipCount;
+    entry.pagingResult = pagingResult;
+    entry.creationDate = [NSDate date];
+    
+    [self.cacheKeys removeObject:key];
+    [self.cacheKeys addObject:key];
+    self.cache[key] = entry;
+    
+    while (self.cacheKeys.count > self.cacheCapacity)
+    {
+        [self.cache removeObjectForKey:self.cacheKeys.firstObject];
+        [self.cacheKeys removeObjectAtIndex:0];
+    }
+}
+
+/*
+ * A query extending the keywords of a cached query that returned everything it matched can only match a subset of
+ * those results, so it is answered by filtering them. Content matches can't be checked locally, so content searches
+ * always go to the server. So do people and site searches, which the server also matches on fields such as user names,
+ * emails and short names that aren't all shown.
+ */
+- (AlfrescoPagingResult *)refinedPagingResultForSignature:(NSString *)signature keywords:(NSString *)keywords
+{
+    BOOL isNodeSearch = (self.type == SearchViewControllerDataSourceTypeSearchFiles || self.type == SearchViewControllerDataSourceTypeSearchFolders);
+    if (!isNodeSearch || self.options.includeContent || self.options.exactMatch)
+    {
+        return nil;
+    }
+    
+    NSString *lowercaseKeywords = keywords.lowercaseString;
+    SearchQueryCacheEntry *bestEntry = nil;
+    for (SearchQueryCacheEntry *entry in self.cache.allValues)
+    {
+        if (entry.skipCount == 0 && !entry.pagingResult.hasMoreItems && [entry.signature isEqualToString:signature]
+            && entry.keywords.length < lowercaseKeywords.length && [lowercaseKeywords hasPrefix:entry.keywords]
+            && -entry.creationDate.timeIntervalSinceNow <= kSearchQueryEngineCacheLifetime
+            && entry.keywords.length > bestEntry.keywords.length)
+        {
+            bestEntry = entry;
+        }
+    }
+    
+    if (!bestEntry)
+    {
+        return nil;
+    }
+    
+    NSArray *words = [lowercaseKeywords componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    NSMutableArray *matchingObjects = [NSMutableArray array];
+    for (id object in bestEntry.pagingResult.objects)
+    {
+        if ([self object:object matchesWords:words])
+        {
+            [matchingObjects addObject:object];
+        }
+    }
+    
+    return [[AlfrescoPagingResult alloc] initWithArray:matchingObjects hasMoreItems:NO totalItems:(int)matchingObjects.count];
+}
+
+- (BOOL)object:(id)object matchesWords:(NSArray *)words
+{
+    static NSArray *searchedKeys = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        searchedKeys = @[@"name", @"title"];
+    });
+    
+    NSMutableArray *values = [NSMutableArray array];
+    for (NSString *key in searchedKeys)
+    {
+        if ([object respondsToSelector:NSSelectorFromString(key)])
+        {
+            id value = [object valueForKey:key];
+            if ([value isKindOfClass:[NSString class]])
+            {
+                [values addObject:value];
+            }
+        }
+    }
+    
+    for (NSString *word in words)
+    {
+        if (word.length == 0)
+        {
+            continue;
+        }
+        
+        BOOL matchesWord = NO;
+        for (NSString *value in values)
+        {
+            if ([value rangeOfString:word options:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch].location != NSNotFound)
+            {
+                matchesWord = YES;
+                break;
+            }
+        }
+        if (!matchesWord)
+        {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+@end
@@ -32,6 +32,7 @@
 
 - (void)loadViewWithKeyword:(NSString *)keyword;
 - (void)search:(NSString *)searchString listingContext:(AlfrescoListingContext *)listingContext;
+- (void)searchAsYouType:(NSString *)searchString listingContext:(AlfrescoListingContext *)listingContext;
 - (void)clearDataSource;
 
 @end
@@ -336,6 +336,18 @@ static CGFloat const kCellHeight = 73.0f;
     }
 }
 
+- (void)searchAsYouType:(NSString *)searchString listingContext:(AlfrescoListingContext *)listingContext
+{
+    if (self.dataSource == nil)
+    {
+        [self search:searchString listingContext:listingContext];
+    }
+    else
+    {
+        [self.dataSource searchKeywordAsYouType:searchString];
+    }
+}
+
 - (void)clearDataSource
 {
     [self.dataSource clearDataSource];
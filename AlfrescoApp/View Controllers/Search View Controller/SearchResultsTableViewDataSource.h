@@ -36,6 +36,8 @@
 
 - (void)retrieveNextItems:(AlfrescoListingContext *)moreListingContext;
 - (void)searchKeyword:(NSString *)keyword session:(id<AlfrescoSession>)session listingContext:(AlfrescoListingContext *)listingContext;
+// Debounced search for text as it is typed; superseded searches are cancelled
+- (void)searchKeywordAsYouType:(NSString *)keyword;
 - (void)clearDataSource;
 
 + (AlfrescoKeywordSearchOptions *)searchOptionsForSearchType:(SearchViewControllerDataSourceType)searchType;
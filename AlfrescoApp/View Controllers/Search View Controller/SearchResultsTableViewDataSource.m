@@ -24,14 +24,13 @@
 #import "ThumbnailManager.h"
 #import "PersonCell.h"
 #import "AvatarManager.h"
+#import "SearchQueryEngine.h"
 
 @interface SearchResultsTableViewDataSource ()
 
 @property (nonatomic) SearchViewControllerDataSourceType dataSourceType;
 @property (nonatomic, strong) NSString *searchString;
-@property (nonatomic, strong) AlfrescoSearchService *searchService;
-@property (nonatomic, strong) AlfrescoPersonService *personService;
-@property (nonatomic, strong) AlfrescoSiteService *siteService;
+@property (nonatomic, strong) SearchQueryEngine *searchEngine;
 
 @end
 
@@ -87,50 +86,7 @@
 
 - (void)retrieveNextItems:(AlfrescoListingContext *)moreListingContext
 {
-    __weak typeof(self) weakSelf = self;
-    
-    void (^completionBlock)(AlfrescoPagingResult *, NSError *) = ^void(AlfrescoPagingResult *pagingResult, NSError *error){
-        if(pagingResult)
-        {
-            if (self.searchResultsArray == nil)
-            {
-                self.searchResultsArray = [NSMutableArray array];
-            }
-            [self.searchResultsArray addObjectsFromArray:pagingResult.objects];
-            
-            self.moreItemsAvailable = pagingResult.hasMoreItems;
-            [weakSelf.delegate dataSourceUpdated];
-        }
-        else
-        {
-            [weakSelf displayError:error];
-        }
-    };
-
-    switch (self.dataSourceType)
-    {
-        case SearchViewControllerDataSourceTypeSearchFiles:
-        case SearchViewControllerDataSourceTypeSearchFolders:
-        {
-            [self.searchService searchWithKeywords:self.searchString options:[SearchResultsTableViewDataSource searchOptionsForSearchType:self.dataSourceType] listingContext:moreListingContext completionBlock:completionBlock];
-        }
-            break;
-            
-        case SearchViewControllerDataSourceTypeSearchUsers:
-        {
-            [self.personService searchWithKeywords:self.searchString listingContext:moreListingContext completionBlock:completionBlock];
-        }
-            break;
-            
-        case SearchViewControllerDataSourceTypeSearchSites:
-        {
-            [self.siteService searchWithKeywords:self.searchString listingContext:moreListingContext completionBlock:completionBlock];
-        }
-            break;
-            
-        default:
-            break;
-    }
+    [self.searchEngine retrieveResultsWithListingContext:moreListingContext completionBlock:[self completionBlockReplacingResults:NO]];
 }
 
 - (void)searchKeyword:(NSString *)keyword session:(id<AlfrescoSession>)session listingContext:(AlfrescoListingContext *)listingContext
@@ -149,8 +105,16 @@
     [self reloadDataSource];
 }
 
+- (void)searchKeywordAsYouType:(NSString *)keyword
+{
+    // Keep showing the previous results until those for the new keyword arrive
+    self.searchString = keyword;
+    [self.searchEngine searchFor:self.searchString type:self.dataSourceType options:[SearchResultsTableViewDataSource searchOptionsForSearchType:self.dataSourceType] listingContext:self.defaultListingContext debounce:YES completionBlock:[self completionBlockReplacingResults:YES]];
+}
+
 - (void)clearDataSource
 {
+    [self.searchEngine cancel];
     [self.searchResultsArray removeAllObjects];
     [self.delegate dataSourceUpdated];
 }
@@ -189,7 +153,30 @@
     [self.searchResultsArray removeAllObjects];
     [self.delegate dataSourceUpdated];
     
-    [self retrieveNextItems:self.defaultListingContext];
+    [self.searchEngine searchFor:self.searchString type:self.dataSourceType options:[SearchResultsTableViewDataSource searchOptionsForSearchType:self.dataSourceType] listingContext:self.defaultListingContext debounce:NO completionBlock:[self completionBlockReplacingResults:YES]];
+}
+
+- (AlfrescoPagingResultCompletionBlock)completionBlockReplacingResults:(BOOL)replacesResults
+{
+    __weak typeof(self) weakSelf = self;
+    
+    return ^(AlfrescoPagingResult *pagingResult, NSError *error) {
+        if (pagingResult)
+        {
+            if (weakSelf.searchResultsArray == nil || replacesResults)
+            {
+                weakSelf.searchResultsArray = [NSMutableArray array];
+            }
+            [weakSelf.searchResultsArray addObjectsFromArray:pagingResult.objects];
+            
+            weakSelf.moreItemsAvailable = pagingResult.hasMoreItems;
+            [weakSelf.delegate dataSourceUpdated];
+        }
+        else
+        {
+            [weakSelf displayError:error];
+        }
+    };
 }
 
 - (void)displayError:(NSError *)error
@@ -230,29 +217,13 @@
 
 - (void)initializeServices
 {
-    switch (self.dataSourceType)
+    if (self.searchEngine)
     {
-        case SearchViewControllerDataSourceTypeSearchFiles:
-        case SearchViewControllerDataSourceTypeSearchFolders:
-        {
-            self.searchService = [[AlfrescoSearchService alloc] initWithSession:self.session];
-        }
-            break;
-            
-        case SearchViewControllerDataSourceTypeSearchUsers:
-        {
-            self.personService = [[AlfrescoPersonService alloc] initWithSession:self.session];
-        }
-            break;
-            
-        case SearchViewControllerDataSourceTypeSearchSites:
-        {
-            self.siteService = [[AlfrescoSiteService alloc] initWithSession:self.session];
-        }
-            break;
-            
-        default:
-            break;
+        [self.searchEngine updateSession:self.session];
+    }
+    else
+    {
+        self.searchEngine = [[SearchQueryEngine alloc] initWithSession:self.session];
     }
 }
 
@@ -362,6 +333,8 @@
             
             AvatarConfiguration *configuration = [AvatarConfiguration defaultConfigurationWithIdentifier:currentPerson.identifier session:self.session];
             configuration.ignoreCache = YES;
+            configuration.person = currentPerson;
+            properCell.avatarImageView.image = [[AvatarManager sharedManager] cachedAvatarForIdentifier:currentPerson.identifier] ?: configuration.placeholderImage;
             [[AvatarManager sharedManager] retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *image, NSError *error) {
                 properCell.avatarImageView.image = image;
             }];
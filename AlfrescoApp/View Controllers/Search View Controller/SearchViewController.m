@@ -33,6 +33,7 @@
 static CGFloat const kHeaderHeight = 40.0f;
 static CGFloat const kCellHeightSearchScope = 64.0f;
 static CGFloat const kCellHeightPreviousSearches = 44.0f;
+static NSUInteger const kMinimumSearchAsYouTypeLength = 3;
 
 @interface SearchViewController () < UISearchResultsUpdating, UISearchBarDelegate, UISearchControllerDelegate>
 
@@ -488,8 +489,16 @@ static CGFloat const kCellHeightPreviousSearches = 44.0f;
 
 - (void)updateSearchResultsForSearchController:(UISearchController *)searchController
 {
-    /* handling of search is done in the delegate method from the search bar because this method is called for every caracter that the user types;
-    see searchBarSearchButtonClicked method for implementation */
+    /* this method is called for every character that the user types, so results are only previewed here; the search engine debounces the
+    typing and cancels superseded requests. The search is saved and tracked in searchBarSearchButtonClicked */
+    NSString *strippedString = [searchController.searchBar.text stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    
+    if (strippedString.length >= kMinimumSearchAsYouTypeLength && [searchController.searchResultsController isKindOfClass:[SearchResultsTableViewController class]])
+    {
+        SearchResultsTableViewController *resultsController = (SearchResultsTableViewController *)searchController.searchResultsController;
+        resultsController.tableView.contentInsetAdjustmentBehavior = UIScrollViewContentInsetAdjustmentNever;
+        [resultsController searchAsYouType:strippedString listingContext:self.listingContext];
+    }
 }
 
 - (void)searchBarSearchButtonClicked:(UISearchBar *)searchBar
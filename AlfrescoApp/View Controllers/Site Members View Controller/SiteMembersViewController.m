@@ -118,6 +118,8 @@ static CGFloat const kEstimatedCellHeight = 60.0f;
     PersonCell *cell = (PersonCell *)[tableView dequeueReusableCellWithIdentifier:NSStringFromClass([PersonCell class]) forIndexPath:indexPath];
     
     AvatarConfiguration *configuration = [AvatarConfiguration defaultConfigurationWithIdentifier:person.identifier session:self.session];
+    configuration.person = person;
+    cell.avatarImageView.image = configuration.placeholderImage;
     [[AvatarManager sharedManager] retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *avatarImage, NSError *avatarError) {
         [cell.avatarImageView setImage:avatarImage withFade:YES];
     }];
@@ -30,6 +30,7 @@
 #import "PreferenceManager.h"
 #import "SiteMembersViewController.h"
 #import "UISearchBar+Paste.h"
+#import "StreamCopier.h"
 
 static CGFloat const kSearchBarSpeed = 0.3f;
 
@@ -60,6 +61,7 @@ static CGFloat kSearchCellHeight = 60.0f;
     {
         [self createAlfrescoServicesWithSession:session];
         self.title = NSLocalizedString(@"sites.title", @"Sites Title");
+        self.displaysRelativeDates = YES;
     }
     return self;
 }
@@ -354,10 +356,17 @@ static CGFloat kSearchCellHeight = 60.0f;
         
         AlfrescoNode *selectedNode = [self.searchResults objectAtIndex:indexPath.row];
         NSString *downloadDestinationPath = [[[AlfrescoFileManager sharedManager] temporaryDirectory] stringByAppendingPathComponent:selectedNode.name];
-        NSOutputStream *outputStream = [[AlfrescoFileManager sharedManager] outputStreamToFileAtPath:downloadDestinationPath append:NO];
+        StreamCopyFileDestination *destination = [[StreamCopyFileDestination alloc] initWithFilePath:downloadDestinationPath];
         
         [self.documentService retrievePermissionsOfNode:selectedNode completionBlock:^(AlfrescoPermissions *permissions, NSError *error) {
-            [self.documentService retrieveContentOfDocument:(AlfrescoDocument *)selectedNode outputStream:outputStream completionBlock:^(BOOL succeeded, NSError *error) {
+            [self.documentService retrieveContentOfDocument:(AlfrescoDocument *)selectedNode outputStream:destination.outputStream completionBlock:^(BOOL succeeded, NSError *error) {
+                NSError *moveError = nil;
+                if (![destination finishWithSuccess:succeeded error:&moveError] && succeeded)
+                {
+                    succeeded = NO;
+                    error = moveError;
+                }
+                
                 [self hideHUD];
                 if (succeeded)
                 {
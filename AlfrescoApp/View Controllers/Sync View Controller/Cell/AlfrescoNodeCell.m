@@ -19,6 +19,8 @@
 #import "AlfrescoNodeCell.h"
 #import "SyncNodeStatus.h"
 #import "RealmSyncManager.h"
+#import "RealmSyncCore.h"
+#import "SyncProgressEventBus.h"
 #import "AlfrescoNode+Sync.h"
 #import "FavouriteManager.h"
 
@@ -33,10 +35,11 @@ static CGFloat const kSyncIconRightSpace = 8.0f;
 
 static CGFloat const kStatusIconsAnimationDuration = 0.2f;
 
-@interface AlfrescoNodeCell()
+@interface AlfrescoNodeCell () <SyncProgressObserver>
 
 @property (nonatomic, strong) AlfrescoNode *node;
 @property (nonatomic, strong) SyncNodeStatus *nodeStatus;
+@property (nonatomic, strong) NSString *syncProgressNodeId;
 @property (nonatomic, assign) BOOL isFavorite;
 @property (nonatomic, assign) BOOL isTopLevelNode;
 @property (nonatomic, assign) BOOL isSyncNode;
@@ -76,10 +79,7 @@ static CGFloat const kStatusIconsAnimationDuration = 0.2f;
 
 - (void)registerForNotifications
 {
-    [[NSNotificationCenter defaultCenter] addObserver:self
-                                             selector:@selector(statusChanged:)
-                                                 name:kSyncStatusChangeNotification
-                                               object:nil];
+    [self observeSyncProgressForNode:self.node];
     [[NSNotificationCenter defaultCenter] addObserver:self
                                              selector:@selector(didAddNodeToFavorites:)
                                                  name:kFavouritesDidAddNodeNotification
@@ -101,12 +101,28 @@ static CGFloat const kStatusIconsAnimationDuration = 0.2f;
 - (void)removeNotifications
 {
     [[NSNotificationCenter defaultCenter] removeObserver:self];
+    [self observeSyncProgressForNode:nil];
+}
+
+- (void)observeSyncProgressForNode:(AlfrescoNode *)node
+{
+    NSString *nodeId = node ? [[RealmSyncCore sharedSyncCore] syncIdentifierForNode:node] : nil;
+    if ([nodeId isEqualToString:self.syncProgressNodeId])
+    {
+        return;
+    }
+    
+    SyncProgressEventBus *eventBus = [SyncProgressEventBus sharedBus];
+    [eventBus removeObserver:self forNodeId:self.syncProgressNodeId];
+    [eventBus addObserver:self forNodeId:nodeId];
+    self.syncProgressNodeId = nodeId;
 }
 
 - (void)updateCellInfoWithNode:(AlfrescoNode *)node nodeStatus:(SyncNodeStatus *)nodeStatus
 {
     self.node = node;
     self.nodeStatus = nodeStatus;
+    [self observeSyncProgressForNode:node];
     self.filename.text = node.name;
     [self updateNodeDetails:nodeStatus];
 }
@@ -235,26 +251,30 @@ static CGFloat const kStatusIconsAnimationDuration = 0.2f;
 
 #pragma mark - Notification Methods
 
-- (void)statusChanged:(NSNotification *)notification
+- (void)didReceiveSyncProgressEvents:(NSArray<SyncProgressEvent *> *)events
 {
-    NSDictionary *info = notification.userInfo;
-    if ([self.node.identifier hasPrefix:[info objectForKey:kSyncStatusNodeIdKey]])
+    for (SyncProgressEvent *event in events)
     {
-        SyncNodeStatus *nodeStatus = notification.object;
+        SyncNodeStatus *nodeStatus = event.nodeStatus;
+        if (![self.node.identifier hasPrefix:nodeStatus.nodeId])
+        {
+            continue;
+        }
+        
         self.nodeStatus = nodeStatus;
-        NSString *propertyChanged = [info objectForKey:kSyncStatusPropertyChangedKey];
-        dispatch_async(dispatch_get_main_queue(), ^{
-            if (!self.isSyncNode && nodeStatus.status != SyncStatusRemoved)
-            {
-                [self updateStatusIconsIsSyncNode:YES isFavoriteNode:self.isFavorite animate:YES];
-            }
-            if (nodeStatus.status == SyncStatusRemoved)
-            {
-                self.nodeStatus = nil;
-                [self updateStatusIconsIsSyncNode:NO isFavoriteNode:self.isFavorite animate:YES];
-            }
+        if (!self.isSyncNode && nodeStatus.status != SyncStatusRemoved)
+        {
+            [self updateStatusIconsIsSyncNode:YES isFavoriteNode:self.isFavorite animate:YES];
+        }
+        if (nodeStatus.status == SyncStatusRemoved)
+        {
+            self.nodeStatus = nil;
+            [self updateStatusIconsIsSyncNode:NO isFavoriteNode:self.isFavorite animate:YES];
+        }
+        for (NSString *propertyChanged in event.changedProperties)
+        {
             [self updateCellWithNodeStatus:nodeStatus propertyChanged:propertyChanged];
-        });
+        }
     }
 }
 
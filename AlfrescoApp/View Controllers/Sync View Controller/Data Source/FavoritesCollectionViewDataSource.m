@@ -37,6 +37,7 @@
     }
     
     self.filter = filter ? filter : kAlfrescoConfigViewParameterFavoritesFiltersAll;
+    self.viewModelBuilder.nodesAreFavorites = YES;
     self.shouldAllowMultiselect = NO;
     self.screenTitle = NSLocalizedString(@"favourites.title", @"Favorites Title");
     self.emptyMessage = NSLocalizedString(@"favourites.empty", @"No Favorites");
@@ -84,6 +85,7 @@
             {
                 self.dataSourceCollection = [NSMutableArray array];
             }
+            [self.viewModelBuilder prepareViewModelsForNodes:pagingResult.objects];
             [self.dataSourceCollection addObjectsFromArray:pagingResult.objects];
             
             self.moreItemsAvailable = pagingResult.hasMoreItems;
@@ -96,16 +98,6 @@
     }];
 }
 
-#pragma mark - Private Methods
-
-- (void)updateFavoriteStatusIconForNodeCell:(FileFolderCollectionViewCell *)nodeCell node:(AlfrescoNode *)node
-{
-    BOOL isSyncOn = [node isNodeInSyncList];
-    BOOL isTopLevelNode = [node isTopLevelSyncNode];
-
-    [nodeCell updateStatusIconsIsFavoriteNode:YES isSyncNode:isSyncOn isTopLevelSyncNode:isTopLevelNode animate:NO];
-}
-
 #pragma mark - Notifications Handlers
 
 - (void)didAddNodeToFavorites:(NSNotification *)notification
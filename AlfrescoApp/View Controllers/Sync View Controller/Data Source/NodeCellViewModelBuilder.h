@@ -0,0 +1,54 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "NodeCellViewModel.h"
+
+typedef void (^NodeCellViewModelsUpdatedBlock)(NSArray<NodeCellViewModel *> *viewModels);
+
+/**
+ * Builds cell view models for a listing off the main thread, as each page of nodes arrives.
+ *
+ * Sync state and cached thumbnails are resolved on a background queue; sync progress and favourite state are
+ * attached once per node on the main thread. All methods must be called on the main thread.
+ */
+@interface NodeCellViewModelBuilder : NSObject
+
+@property (nonatomic, strong) id<AlfrescoSession> session;
+// When set, every node is shown as a favourite without asking the server
+@property (nonatomic, assign) BOOL nodesAreFavorites;
+// Called on the main thread with view models that have been built or updated since they were last handed out
+@property (nonatomic, copy) NodeCellViewModelsUpdatedBlock viewModelsUpdatedBlock;
+
+- (instancetype)initWithSession:(id<AlfrescoSession>)session;
+
+/*
+ * Returns the view model for the node. If it has not been built yet, a placeholder is returned and the node
+ * is queued for building, with the result reported through viewModelsUpdatedBlock.
+ */
+- (NodeCellViewModel *)viewModelForNode:(AlfrescoNode *)node;
+
+/*
+ * Starts building view models for any of the given nodes that do not already have a current one.
+ * A node whose previous build is still running is built again once that build finishes.
+ */
+- (void)prepareViewModelsForNodes:(NSArray *)nodes;
+
+- (void)invalidateViewModelForNode:(AlfrescoNode *)node;
+- (void)invalidateAllViewModels;
+
+@end
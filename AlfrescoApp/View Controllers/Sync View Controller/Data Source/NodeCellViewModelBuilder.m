@@ -0,0 +1,304 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "NodeCellViewModelBuilder.h"
+#import "ThumbnailManager.h"
+#import "FavouriteManager.h"
+#import "RealmSyncManager.h"
+#import "RealmSyncCore.h"
+#import "RealmManager.h"
+
+@interface NodeCellViewModelBuilder ()
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NodeCellViewModel *> *viewModelsByIdentifier;
+@property (nonatomic, strong) NSMutableSet<NSString *> *identifiersBeingBuilt;
+// Nodes asked for again while their previous build was running, built once it has finished
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AlfrescoNode *> *nodesToRebuildByIdentifier;
+@property (nonatomic, strong) NSMutableArray *nodesAwaitingBuild;
+@property (nonatomic, strong) NSOperationQueue *buildQueue;
+
+@end
+
+@implementation NodeCellViewModelBuilder
+
+- (instancetype)initWithSession:(id<AlfrescoSession>)session
+{
+    self = [super init];
+    if (self)
+    {
+        self.session = session;
+        self.viewModelsByIdentifier = [NSMutableDictionary dictionary];
+        self.identifiersBeingBuilt = [NSMutableSet set];
+        self.nodesToRebuildByIdentifier = [NSMutableDictionary dictionary];
+        self.nodesAwaitingBuild = [NSMutableArray array];
+        self.buildQueue = [[NSOperationQueue alloc] init];
+        self.buildQueue.name = @"com.alfresco.nodecellviewmodelbuilder";
+        self.buildQueue.maxConcurrentOperationCount = 1;
+        self.buildQueue.qualityOfService = NSQualityOfServiceUserInitiated;
+        
+        [self registerForNotifications];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    [self.buildQueue cancelAllOperations];
+}
+
+- (void)registerForNotifications
+{
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(didAddNodeToFavorites:) name:kFavouritesDidAddNodeNotification object:nil];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(didRemoveNodeFromFavorites:) name:kFavouritesDidRemoveNodeNotification object:nil];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(topLevelSyncNodesChanged:) name:kTopLevelSyncDidAddNodeNotification object:nil];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(topLevelSyncNodesChanged:) name:kTopLevelSyncDidRemoveNodeNotification object:nil];
+}
+
+#pragma mark - Public Methods
+
+- (NodeCellViewModel *)viewModelForNode:(AlfrescoNode *)node
+{
+    NodeCellViewModel *viewModel = self.viewModelsByIdentifier[node.identifier];
+    if (viewModel && [viewModel isCurrentForNode:node])
+    {
+        return viewModel;
+    }
+    
+    viewModel = [[NodeCellViewModel alloc] initWithNode:node];
+    viewModel.isFavorite = self.nodesAreFavorites;
+    self.viewModelsByIdentifier[node.identifier] = viewModel;
+    
+    // Cells for a whole screen are dequeued in one pass, so build their nodes together
+    if (self.nodesAwaitingBuild.count == 0)
+    {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            NSArray *nodes = [self.nodesAwaitingBuild copy];
+            [self.nodesAwaitingBuild removeAllObjects];
+            [self prepareViewModelsForNodes:nodes];
+        });
+    }
+    [self.nodesAwaitingBuild addObject:node];
+    
+    return viewModel;
+}
+
+- (void)prepareViewModelsForNodes:(NSArray *)nodes
+{
+    NSMutableArray *nodesToBuild = [NSMutableArray arrayWithCapacity:nodes.count];
+    for (AlfrescoNode *node in nodes)
+    {
+        NodeCellViewModel *viewModel = self.viewModelsByIdentifier[node.identifier];
+        BOOL isBeingBuilt = [self.identifiersBeingBuilt containsObject:node.identifier];
+        if ((viewModel && ![viewModel isCurrentForNode:node]) || (!viewModel && isBeingBuilt))
+        {
+            // Records which version of the node the listing has, so a build still running for another one is not used
+            NodeCellViewModel *placeholder = [[NodeCellViewModel alloc] initWithNode:node];
+            placeholder.isFavorite = viewModel ? viewModel.isFavorite : self.nodesAreFavorites;
+            self.viewModelsByIdentifier[node.identifier] = placeholder;
+            viewModel = placeholder;
+        }
+        
+        BOOL isBuilt = viewModel && !viewModel.isPlaceholder && [viewModel isCurrentForNode:node];
+        if (isBuilt)
+        {
+            continue;
+        }
+        
+        if (isBeingBuilt)
+        {
+            // The running build may have read the node or its sync state before it changed
+            self.nodesToRebuildByIdentifier[node.identifier] = node;
+        }
+        else
+        {
+            [self.identifiersBeingBuilt addObject:node.identifier];
+            [nodesToBuild addObject:node];
+        }
+    }
+    
+    if (nodesToBuild.count == 0)
+    {
+        return;
+    }
+    
+    BOOL nodesAreFavorites = self.nodesAreFavorites;
+    __weak typeof(self) weakSelf = self;
+    [self.buildQueue addOperationWithBlock:^{
+        NSArray *viewModels = [NodeCellViewModelBuilder viewModelsForNodes:nodesToBuild nodesAreFavorites:nodesAreFavorites];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf didBuildViewModels:viewModels];
+        });
+    }];
+}
+
+- (void)invalidateViewModelForNode:(AlfrescoNode *)node
+{
+    if (node.identifier)
+    {
+        [self.viewModelsByIdentifier removeObjectForKey:node.identifier];
+    }
+}
+
+- (void)invalidateAllViewModels
+{
+    [self.viewModelsByIdentifier removeAllObjects];
+}
+
+#pragma mark - Notification Methods
+
+- (void)didAddNodeToFavorites:(NSNotification *)notification
+{
+    AlfrescoNode *node = (AlfrescoNode *)notification.object;
+    self.viewModelsByIdentifier[node.identifier].isFavorite = YES;
+}
+
+- (void)didRemoveNodeFromFavorites:(NSNotification *)notification
+{
+    AlfrescoNode *node = (AlfrescoNode *)notification.object;
+    self.viewModelsByIdentifier[node.identifier].isFavorite = self.nodesAreFavorites;
+}
+
+- (void)topLevelSyncNodesChanged:(NSNotification *)notification
+{
+    // Syncing a folder changes the state of everything below it, so resolve the whole listing again.
+    // The current view models stay in use until their replacements are built.
+    NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:self.viewModelsByIdentifier.count];
+    for (NodeCellViewModel *viewModel in self.viewModelsByIdentifier.allValues)
+    {
+        viewModel.isPlaceholder = YES;
+        [nodes addObject:viewModel.node];
+    }
+    [self prepareViewModelsForNodes:nodes];
+}
+
+#pragma mark - Private Methods
+
+/**
+ * Runs on the build queue. Everything read here is either thread safe or read through this thread's realm.
+ */
++ (NSArray *)viewModelsForNodes:(NSArray *)nodes nodesAreFavorites:(BOOL)nodesAreFavorites
+{
+    NSMutableArray *viewModels = [NSMutableArray arrayWithCapacity:nodes.count];
+    
+    @autoreleasepool
+    {
+        RLMRealm *realm = [[RealmManager sharedManager] realmForCurrentThread];
+        [realm refresh];
+        RealmSyncCore *syncCore = [RealmSyncCore sharedSyncCore];
+        ThumbnailManager *thumbnailManager = [ThumbnailManager sharedManager];
+        
+        for (AlfrescoNode *node in nodes)
+        {
+            NodeCellViewModel *viewModel = [[NodeCellViewModel alloc] initWithNode:node];
+            viewModel.isFavorite = nodesAreFavorites;
+            
+            RealmSyncNodeInfo *nodeInfo = [syncCore syncNodeInfoForObject:node ifNotExistsCreateNew:NO inRealm:realm];
+            viewModel.isTopLevelSyncNode = nodeInfo.isTopLevelSyncNode;
+            viewModel.isSyncNode = nodeInfo.isTopLevelSyncNode || nodeInfo.parentNode != nil;
+            
+            if (node.isDocument)
+            {
+                viewModel.thumbnail = [thumbnailManager decodedThumbnailForDocument:(AlfrescoDocument *)node];
+            }
+            
+            [viewModels addObject:viewModel];
+        }
+    }
+    
+    return viewModels;
+}
+
+- (void)didBuildViewModels:(NSArray *)viewModels
+{
+    RealmSyncManager *syncManager = [RealmSyncManager sharedManager];
+    NSMutableArray *currentViewModels = [NSMutableArray arrayWithCapacity:viewModels.count];
+    NSMutableArray *nodesToRebuild = [NSMutableArray array];
+    
+    for (NodeCellViewModel *viewModel in viewModels)
+    {
+        AlfrescoNode *node = viewModel.node;
+        [self.identifiersBeingBuilt removeObject:node.identifier];
+        AlfrescoNode *nodeToRebuild = self.nodesToRebuildByIdentifier[node.identifier];
+        [self.nodesToRebuildByIdentifier removeObjectForKey:node.identifier];
+        
+        // The listing may have moved on while this was being built, in which case its current node is built instead
+        NodeCellViewModel *existingViewModel = self.viewModelsByIdentifier[node.identifier];
+        if (existingViewModel && ![existingViewModel isCurrentForNode:node])
+        {
+            [nodesToRebuild addObject:existingViewModel.node];
+            continue;
+        }
+        
+        // Shown until its replacement is built, as when the sync state of the listing changes
+        viewModel.isPlaceholder = (nodeToRebuild != nil);
+        if (nodeToRebuild)
+        {
+            [nodesToRebuild addObject:nodeToRebuild];
+        }
+        viewModel.nodeStatus = [syncManager syncStatusForNodeWithId:node.identifier];
+        if (existingViewModel)
+        {
+            viewModel.isFavorite = existingViewModel.isFavorite;
+            viewModel.hasRequestedThumbnail = existingViewModel.hasRequestedThumbnail;
+            viewModel.thumbnail = viewModel.thumbnail ?: existingViewModel.thumbnail;
+        }
+        self.viewModelsByIdentifier[node.identifier] = viewModel;
+        [currentViewModels addObject:viewModel];
+        
+        if (!self.nodesAreFavorites)
+        {
+            [self resolveFavoriteStatusForViewModel:viewModel];
+        }
+    }
+    
+    if (currentViewModels.count > 0 && self.viewModelsUpdatedBlock)
+    {
+        self.viewModelsUpdatedBlock(currentViewModels);
+    }
+    
+    if (nodesToRebuild.count > 0)
+    {
+        [self prepareViewModelsForNodes:nodesToRebuild];
+    }
+}
+
+- (void)resolveFavoriteStatusForViewModel:(NodeCellViewModel *)viewModel
+{
+    // Known locally once the favourites have been listed, in which case the view model goes out with the rest
+    BOOL isFavorite = NO;
+    if ([[FavouriteManager sharedManager] cachedFavoriteStatusOfNode:viewModel.node isFavorite:&isFavorite])
+    {
+        viewModel.isFavorite = isFavorite;
+        return;
+    }
+    
+    __weak typeof(self) weakSelf = self;
+    [[FavouriteManager sharedManager] isNodeFavorite:viewModel.node session:self.session completionBlock:^(BOOL isFavorite, NSError *error) {
+        if (!error && isFavorite != viewModel.isFavorite)
+        {
+            viewModel.isFavorite = isFavorite;
+            if (weakSelf.viewModelsUpdatedBlock)
+            {
+                weakSelf.viewModelsUpdatedBlock(@[viewModel]);
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Mutable array of AlfrescoNodes that keeps a map from node identifier to index, so a node can be located without scanning the collection.
+ * Identifiers are matched without their version label. Appending keeps the map current; other structural changes rebuild it on the next lookup.
+ */
+@interface NodeCollection : NSMutableArray
+
+- (NSUInteger)indexOfNodeWithIdentifier:(NSString *)identifier;
+
+@end
+
+/**
+ * The minimal set of collection view updates turning one list of nodes into another.
+ * Deleted and reloaded index paths refer to the old list, inserted index paths to the new one, as expected by performBatchUpdates:.
+ */
+@interface NodeCollectionChanges : NSObject
+
+@property (nonatomic, assign, readonly) NSUInteger previousCount;
+@property (nonatomic, strong, readonly) NSArray<NSIndexPath *> *deletedIndexPaths;
+@property (nonatomic, strong, readonly) NSArray<NSIndexPath *> *insertedIndexPaths;
+@property (nonatomic, strong, readonly) NSArray<NSIndexPath *> *reloadedIndexPaths;
+/// Pairs of @[fromIndexPath, toIndexPath]
+@property (nonatomic, strong, readonly) NSArray<NSArray<NSIndexPath *> *> *movedIndexPaths;
+@property (nonatomic, assign, readonly) BOOL hasChanges;
+
++ (NodeCollectionChanges *)changesFromNodes:(NSArray *)oldNodes toNodes:(NSArray *)newNodes;
+/*
+ * As above, for any objects with an identifier, using the block to tell whether an item matched by identifier needs reloading.
+ */
++ (NodeCollectionChanges *)changesFromNodes:(NSArray *)oldNodes toNodes:(NSArray *)newNodes differenceBlock:(BOOL (^)(id oldNode, id newNode))differenceBlock;
++ (NodeCollectionChanges *)changesAppendingNodeCount:(NSUInteger)count toNodeCount:(NSUInteger)previousCount;
+
+@end
@@ -0,0 +1,412 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "NodeCollection.h"
+
+static NSString *NodeCollectionKeyForIdentifier(NSString *identifier)
+{
+    NSRange versionRange = [identifier rangeOfString:@";"];
+    return (versionRange.location == NSNotFound) ? identifier : [identifier substringToIndex:versionRange.location];
+}
+
+static NSString *NodeCollectionKeyForNode(id node)
+{
+    return [node respondsToSelector:@selector(identifier)] ? NodeCollectionKeyForIdentifier([(AlfrescoNode *)node identifier]) : nil;
+}
+
+@interface NodeCollection ()
+@property (nonatomic, strong) NSMutableArray *nodes;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *indexesByIdentifier;
+@property (nonatomic, assign) BOOL isIndexStale;
+@end
+
+@implementation NodeCollection
+
+- (instancetype)init
+{
+    return [self initWithCapacity:0];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)numItems
+{
+    self = [super init];
+    if (self)
+    {
+        self.nodes = [NSMutableArray arrayWithCapacity:numItems];
+        self.indexesByIdentifier = [NSMutableDictionary dictionaryWithCapacity:numItems];
+    }
+    return self;
+}
+
+- (instancetype)initWithObjects:(const id [])objects count:(NSUInteger)count
+{
+    self = [self initWithCapacity:count];
+    if (self)
+    {
+        for (NSUInteger index = 0; index < count; index++)
+        {
+            [self addObject:objects[index]];
+        }
+    }
+    return self;
+}
+
+#pragma mark - NSArray Primitives
+
+- (NSUInteger)count
+{
+    return self.nodes.count;
+}
+
+- (id)objectAtIndex:(NSUInteger)index
+{
+    return [self.nodes objectAtIndex:index];
+}
+
+#pragma mark - NSMutableArray Primitives
+
+- (void)addObject:(id)anObject
+{
+    [self.nodes addObject:anObject];
+    
+    if (!self.isIndexStale)
+    {
+        NSString *key = NodeCollectionKeyForNode(anObject);
+        // Keep the first occurrence, like indexOfObject:
+        if (key && !self.indexesByIdentifier[key])
+        {
+            self.indexesByIdentifier[key] = @(self.nodes.count - 1);
+        }
+    }
+}
+
+- (void)insertObject:(id)anObject atIndex:(NSUInteger)index
+{
+    if (index == self.nodes.count)
+    {
+        [self addObject:anObject];
+    }
+    else
+    {
+        [self.nodes insertObject:anObject atIndex:index];
+        self.isIndexStale = YES;
+    }
+}
+
+- (void)removeLastObject
+{
+    id lastObject = self.nodes.lastObject;
+    [self.nodes removeLastObject];
+    
+    if (!self.isIndexStale)
+    {
+        NSString *key = NodeCollectionKeyForNode(lastObject);
+        if (key && [self.indexesByIdentifier[key] unsignedIntegerValue] == self.nodes.count)
+        {
+            [self.indexesByIdentifier removeObjectForKey:key];
+        }
+    }
+}
+
+- (void)removeObjectAtIndex:(NSUInteger)index
+{
+    if (index + 1 == self.nodes.count)
+    {
+        [self removeLastObject];
+    }
+    else
+    {
+        [self.nodes removeObjectAtIndex:index];
+        self.isIndexStale = YES;
+    }
+}
+
+- (void)replaceObjectAtIndex:(NSUInteger)index withObject:(id)anObject
+{
+    NSString *previousKey = NodeCollectionKeyForNode(self.nodes[index]);
+    [self.nodes replaceObjectAtIndex:index withObject:anObject];
+    
+    NSString *key = NodeCollectionKeyForNode(anObject);
+    if (!(key && [key isEqualToString:previousKey]))
+    {
+        self.isIndexStale = YES;
+    }
+}
+
+- (void)removeAllObjects
+{
+    [self.nodes removeAllObjects];
+    [self.indexesByIdentifier removeAllObjects];
+    self.isIndexStale = NO;
+}
+
+#pragma mark - Lookups
+
+- (NSUInteger)indexOfNodeWithIdentifier:(NSString *)identifier
+{
+    NSString *key = NodeCollectionKeyForIdentifier(identifier);
+    if (!key)
+    {
+        return NSNotFound;
+    }
+    
+    if (self.isIndexStale)
+    {
+        [self rebuildIndex];
+    }
+    
+    NSNumber *index = self.indexesByIdentifier[key];
+    return index ? index.unsignedIntegerValue : NSNotFound;
+}
+
+- (NSUInteger)indexOfObject:(id)anObject
+{
+    NSString *key = NodeCollectionKeyForNode(anObject);
+    if (key)
+    {
+        NSUInteger index = [self indexOfNodeWithIdentifier:key];
+        if (index != NSNotFound && [self.nodes[index] isEqual:anObject])
+        {
+            return index;
+        }
+    }
+    return [self.nodes indexOfObject:anObject];
+}
+
+- (BOOL)containsObject:(id)anObject
+{
+    return [self indexOfObject:anObject] != NSNotFound;
+}
+
+- (void)rebuildIndex
+{
+    [self.indexesByIdentifier removeAllObjects];
+    [self.nodes enumerateObjectsUsingBlock:^(id node, NSUInteger index, BOOL *stop) {
+        NSString *key = NodeCollectionKeyForNode(node);
+        if (key && !self.indexesByIdentifier[key])
+        {
+            self.indexesByIdentifier[key] = @(index);
+        }
+    }];
+    self.isIndexStale = NO;
+}
+
+@end
+
+@interface NodeCollectionChanges ()
+@property (nonatomic, assign, readwrite) NSUInteger previousCount;
+@property (nonatomic, strong, readwrite) NSArray<NSIndexPath *> *deletedIndexPaths;
+@property (nonatomic, strong, readwrite) NSArray<NSIndexPath *> *insertedIndexPaths;
+@property (nonatomic, strong, readwrite) NSArray<NSIndexPath *> *reloadedIndexPaths;
+@property (nonatomic, strong, readwrite) NSArray<NSArray<NSIndexPath *> *> *movedIndexPaths;
+@end
+
+@implementation NodeCollectionChanges
+
++ (NodeCollectionChanges *)changesAppendingNodeCount:(NSUInteger)count toNodeCount:(NSUInteger)previousCount
+{
+    NSMutableArray *insertedIndexPaths = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger index = previousCount; index < previousCount + count; index++)
+    {
+        [insertedIndexPaths addObject:[NSIndexPath indexPathForItem:index inSection:0]];
+    }
+    
+    NodeCollectionChanges *changes = [NodeCollectionChanges new];
+    changes.previousCount = previousCount;
+    changes.deletedIndexPaths = @[];
+    changes.insertedIndexPaths = insertedIndexPaths;
+    changes.reloadedIndexPaths = @[];
+    changes.movedIndexPaths = @[];
+    return changes;
+}
+
++ (NodeCollectionChanges *)changesFromNodes:(NSArray *)oldNodes toNodes:(NSArray *)newNodes
+{
+    return [self changesFromNodes:oldNodes toNodes:newNodes differenceBlock:^BOOL(AlfrescoNode *oldNode, AlfrescoNode *newNode) {
+        return [self node:oldNode differsFromNode:newNode];
+    }];
+}
+
++ (NodeCollectionChanges *)changesFromNodes:(NSArray *)oldNodes toNodes:(NSArray *)newNodes differenceBlock:(BOOL (^)(id oldNode, id newNode))differenceBlock
+{
+    NSUInteger oldCount = oldNodes.count;
+    NSUInteger newCount = newNodes.count;
+    
+    NSMutableDictionary<NSString *, NSNumber *> *oldIndexesByKey = [NSMutableDictionary dictionaryWithCapacity:oldCount];
+    [oldNodes enumerateObjectsUsingBlock:^(id node, NSUInteger index, BOOL *stop) {
+        NSString *key = NodeCollectionKeyForNode(node);
+        if (key && !oldIndexesByKey[key])
+        {
+            oldIndexesByKey[key] = @(index);
+        }
+    }];
+    
+    // Match every new node to its old position, if it had one
+    NSMutableArray *deletedIndexPaths = [NSMutableArray array];
+    NSMutableArray *insertedIndexPaths = [NSMutableArray array];
+    NSMutableArray *reloadedIndexPaths = [NSMutableArray array];
+    NSMutableArray *movedIndexPaths = [NSMutableArray array];
+    
+    NSMutableIndexSet *matchedOldIndexes = [NSMutableIndexSet indexSet];
+    NSUInteger *oldIndexForNewIndex = calloc(MAX(newCount, 1), sizeof(NSUInteger));
+    for (NSUInteger newIndex = 0; newIndex < newCount; newIndex++)
+    {
+        NSString *key = NodeCollectionKeyForNode(newNodes[newIndex]);
+        NSNumber *oldIndex = key ? oldIndexesByKey[key] : nil;
+        if (oldIndex && ![matchedOldIndexes containsIndex:oldIndex.unsignedIntegerValue])
+        {
+            oldIndexForNewIndex[newIndex] = oldIndex.unsignedIntegerValue;
+            [matchedOldIndexes addIndex:oldIndex.unsignedIntegerValue];
+        }
+        else
+        {
+            oldIndexForNewIndex[newIndex] = NSNotFound;
+        }
+    }
+    
+    for (NSUInteger oldIndex = 0; oldIndex < oldCount; oldIndex++)
+    {
+        if (![matchedOldIndexes containsIndex:oldIndex])
+        {
+            [deletedIndexPaths addObject:[NSIndexPath indexPathForItem:oldIndex inSection:0]];
+        }
+    }
+    
+    // Nodes that keep their relative order stay put; the longest increasing run of old indexes is the largest such set
+    NSIndexSet *stationaryNewIndexes = [self longestIncreasingSubsequenceOfIndexes:oldIndexForNewIndex count:newCount];
+    
+    for (NSUInteger newIndex = 0; newIndex < newCount; newIndex++)
+    {
+        NSUInteger oldIndex = oldIndexForNewIndex[newIndex];
+        NSIndexPath *newIndexPath = [NSIndexPath indexPathForItem:newIndex inSection:0];
+        if (oldIndex == NSNotFound)
+        {
+            [insertedIndexPaths addObject:newIndexPath];
+            continue;
+        }
+        
+        NSIndexPath *oldIndexPath = [NSIndexPath indexPathForItem:oldIndex inSection:0];
+        BOOL hasChanged = (oldNodes[oldIndex] != newNodes[newIndex]) && differenceBlock(oldNodes[oldIndex], newNodes[newIndex]);
+        BOOL hasMoved = ![stationaryNewIndexes containsIndex:newIndex];
+        
+        if (hasMoved && hasChanged)
+        {
+            // A moved cell is not reconfigured, so replace it instead
+            [deletedIndexPaths addObject:oldIndexPath];
+            [insertedIndexPaths addObject:newIndexPath];
+        }
+        else if (hasMoved)
+        {
+            [movedIndexPaths addObject:@[oldIndexPath, newIndexPath]];
+        }
+        else if (hasChanged)
+        {
+            [reloadedIndexPaths addObject:oldIndexPath];
+        }
+    }
+    free(oldIndexForNewIndex);
+    
+    NodeCollectionChanges *changes = [NodeCollectionChanges new];
+    changes.previousCount = oldCount;
+    changes.deletedIndexPaths = deletedIndexPaths;
+    changes.insertedIndexPaths = insertedIndexPaths;
+    changes.reloadedIndexPaths = reloadedIndexPaths;
+    changes.movedIndexPaths = movedIndexPaths;
+    return changes;
+}
+
+- (BOOL)hasChanges
+{
+    return (self.deletedIndexPaths.count + self.insertedIndexPaths.count + self.reloadedIndexPaths.count + self.movedIndexPaths.count) > 0;
+}
+
+#pragma mark - Private Methods
+
++ (BOOL)node:(AlfrescoNode *)oldNode differsFromNode:(AlfrescoNode *)newNode
+{
+    if (oldNode == newNode)
+    {
+        return NO;
+    }
+    
+    BOOL sameIdentifier = [oldNode.identifier isEqualToString:newNode.identifier];
+    BOOL sameName = (oldNode.name == newNode.name) || [oldNode.name isEqualToString:newNode.name];
+    BOOL sameModificationDate = (oldNode.modifiedAt == newNode.modifiedAt) || [oldNode.modifiedAt isEqualToDate:newNode.modifiedAt];
+    return !(sameIdentifier && sameName && sameModificationDate);
+}
+
+/**
+ * Returns the positions, within the given values, of a longest strictly increasing subsequence, skipping NSNotFound entries.
+ * Patience sorting, O(n log n).
+ */
++ (NSIndexSet *)longestIncreasingSubsequenceOfIndexes:(NSUInteger *)values count:(NSUInteger)count
+{
+    NSMutableIndexSet *result = [NSMutableIndexSet indexSet];
+    if (count == 0)
+    {
+        return result;
+    }
+    
+    NSUInteger *tailPositions = malloc(count * sizeof(NSUInteger));
+    NSUInteger *predecessors = malloc(count * sizeof(NSUInteger));
+    NSUInteger length = 0;
+    
+    for (NSUInteger position = 0; position < count; position++)
+    {
+        NSUInteger value = values[position];
+        if (value == NSNotFound)
+        {
+            continue;
+        }
+        
+        NSUInteger low = 0;
+        NSUInteger high = length;
+        while (low < high)
+        {
+            NSUInteger middle = (low + high) / 2;
+            if (values[tailPositions[middle]] < value)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        
+        predecessors[position] = (low > 0) ? tailPositions[low - 1] : NSNotFound;
+        tailPositions[low] = position;
+        if (low == length)
+        {
+            length++;
+        }
+    }
+    
+    NSUInteger position = (length > 0) ? tailPositions[length - 1] : NSNotFound;
+    while (position != NSNotFound)
+    {
+        [result addIndex:position];
+        position = predecessors[position];
+    }
+    
+    free(tailPositions);
+    free(predecessors);
+    return result;
+}
+
+@end
@@ -20,6 +20,7 @@
 #import "AlfrescoNode+Sync.h"
 #import "AlfrescoNode+Networking.h"
 #import "FileFolderCollectionViewCell.h"
+#import "NodeCellViewModelBuilder.h"
 
 @interface RepositoryCollectionViewDataSource ()
 
@@ -27,11 +28,14 @@
 @property (nonatomic, strong) NSMutableArray *dataSourceCollection;
 @property (nonatomic, strong) AlfrescoDocumentFolderService *documentService;
 @property (nonatomic, strong) NSMutableDictionary *nodesPermissions;
+@property (nonatomic, strong) NodeCellViewModelBuilder *viewModelBuilder;
+@property (nonatomic, weak) UICollectionView *boundCollectionView;
 
 - (void)setupWithParentNode:(AlfrescoNode *)node session:(id<AlfrescoSession>)session delegate:(id<RepositoryCollectionViewDataSourceDelegate>)delegate;
 
 - (void)retrieveContentsOfParentNode;
 - (void)retrievePermissionsForNode:(AlfrescoNode *)node;
+- (void)retrievePermissionsForNodes:(NSArray *)nodes;
 - (void)retrieveAndSetPermissionsOfCurrentFolder;
 - (void)reloadCollectionViewWithPagingResult:(AlfrescoPagingResult *)pagingResult error:(NSError *)error;
 
@@ -21,6 +21,7 @@
 #import "CollectionViewProtocols.h"
 
 @class RepositoryCollectionViewDataSource;
+@class NodeCollectionChanges;
 
 @protocol RepositoryCollectionViewDataSourceDelegate <NSObject>
 
@@ -29,6 +30,7 @@
 - (id<CollectionViewCellAccessoryViewDelegate>)cellAccessoryViewDelegate;
 
 - (void)dataSourceUpdated;
+- (void)dataSource:(RepositoryCollectionViewDataSource *)dataSource updatedWithChanges:(NodeCollectionChanges *)changes;
 - (void)requestFailedWithError:(NSError *)error stringFormat:(NSString *)stringFormat;
 
 - (void)didDeleteItems:(NSArray *)items atIndexPaths:(NSArray *)indexPathsOfDeletedItems;
@@ -68,6 +70,7 @@
 - (void)retrieveNextItems:(AlfrescoListingContext *)moreListingContext;
 - (AlfrescoPermissions *)permissionsForNode:(AlfrescoNode *)node;
 - (NSArray *)nodeIdentifiersOfCurrentCollection;
+- (NSIndexPath *)indexPathForNodeWithIdentifier:(NSString *)identifier;
 - (void)addAlfrescoNodes:(NSArray *)alfrescoNodes;
 - (void)reloadDataSource;
 - (AlfrescoFolder *)parentFolder;
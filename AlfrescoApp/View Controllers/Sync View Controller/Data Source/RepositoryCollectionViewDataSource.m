@@ -21,9 +21,10 @@
 #import "BaseCollectionViewFlowLayout.h"
 #import "SearchCollectionSectionHeader.h"
 #import "ThumbnailManager.h"
-#import "FavouriteManager.h"
 #import "RealmSyncManager.h"
 #import "AccountManager.h"
+#import "NodePermissionsPrefetcher.h"
+#import "NodeCollection.h"
 
 @implementation RepositoryCollectionViewDataSource
 
@@ -38,6 +39,12 @@
     
     self.defaultListingContext = [[AlfrescoListingContext alloc] initWithMaxItems:kMaxItemsPerListingRetrieve skipCount:0];
     self.shouldAllowLayoutChange = YES;
+    self.viewModelBuilder = [[NodeCellViewModelBuilder alloc] initWithSession:nil];
+    
+    __weak typeof(self) weakSelf = self;
+    self.viewModelBuilder.viewModelsUpdatedBlock = ^(NSArray<NodeCellViewModel *> *viewModels) {
+        [weakSelf updateVisibleCellsWithViewModels:viewModels];
+    };
     
     return self;
 }
@@ -76,12 +83,27 @@
     [self registerNotifications];
 }
 
+- (void)setDataSourceCollection:(NSMutableArray *)dataSourceCollection
+{
+    if (dataSourceCollection && ![dataSourceCollection isKindOfClass:[NodeCollection class]])
+    {
+        dataSourceCollection = [[NodeCollection alloc] initWithArray:dataSourceCollection];
+    }
+    _dataSourceCollection = dataSourceCollection;
+}
+
+- (NodeCollection *)nodeCollection
+{
+    return (NodeCollection *)self.dataSourceCollection;
+}
+
 - (void)setSession:(id<AlfrescoSession>)session
 {
     if(session)
     {
         _session = session;
         self.documentService = [[AlfrescoDocumentFolderService alloc] initWithSession:_session];
+        self.viewModelBuilder.session = _session;
     }
 }
 
@@ -101,9 +123,20 @@
 {
     if (pagingResult)
     {
+        NSArray *previousNodes = [self.dataSourceCollection copy];
+        [self.viewModelBuilder prepareViewModelsForNodes:pagingResult.objects];
         self.dataSourceCollection = [pagingResult.objects mutableCopy];
         self.moreItemsAvailable = pagingResult.hasMoreItems;
-        [self.delegate dataSourceUpdated];
+        
+        // A first load is cheaper as a plain reload; a refresh only animates what actually changed
+        if (previousNodes.count > 0 && [self.delegate respondsToSelector:@selector(dataSource:updatedWithChanges:)])
+        {
+            [self.delegate dataSource:self updatedWithChanges:[NodeCollectionChanges changesFromNodes:previousNodes toNodes:self.dataSourceCollection]];
+        }
+        else
+        {
+            [self.delegate dataSourceUpdated];
+        }
     }
     else
     {
@@ -115,15 +148,19 @@
 {
     if (pagingResult)
     {
-        NSMutableArray *arrayOfIndexPaths = [NSMutableArray new];
-        for(NSInteger initialIndex = self.dataSourceCollection.count; initialIndex < self.dataSourceCollection.count + pagingResult.objects.count; initialIndex ++)
-        {
-            [arrayOfIndexPaths addObject:[NSIndexPath indexPathForItem:initialIndex inSection:0]];
-        }
+        [self.viewModelBuilder prepareViewModelsForNodes:pagingResult.objects];
+        NodeCollectionChanges *changes = [NodeCollectionChanges changesAppendingNodeCount:pagingResult.objects.count toNodeCount:self.dataSourceCollection.count];
         [self.dataSourceCollection addObjectsFromArray:pagingResult.objects];
         
         self.moreItemsAvailable = pagingResult.hasMoreItems;
-        [self.delegate dataSourceUpdated];
+        if ([self.delegate respondsToSelector:@selector(dataSource:updatedWithChanges:)])
+        {
+            [self.delegate dataSource:self updatedWithChanges:changes];
+        }
+        else
+        {
+            [self.delegate dataSourceUpdated];
+        }
     }
     else
     {
@@ -134,13 +171,23 @@
 #pragma mark - Permissions methods
 - (void)retrievePermissionsForNode:(AlfrescoNode *)node
 {
-    [node retrieveNodePermissionsWithSession:self.session withCompletionBlock:^(AlfrescoPermissions *permissions, NSError *error) {
-        if (permissions)
-        {
-            [self.nodesPermissions setValue:permissions forKey:[[RealmSyncCore sharedSyncCore] syncIdentifierForNode:node]];
-            [[RealmManager sharedManager] savePermissions:permissions forNode:node];
-        }
-    }];
+    if (node)
+    {
+        [self retrievePermissionsForNodes:@[node]];
+    }
+}
+
+- (void)retrievePermissionsForNodes:(NSArray *)nodes
+{
+    if (nodes.count == 0)
+    {
+        return;
+    }
+    
+    // Each node's actions are available as soon as its own permissions arrive, not once the whole page has them
+    [[NodePermissionsPrefetcher sharedPrefetcher] prefetchPermissionsForNodes:nodes session:self.session permissionsBlock:^(NSString *syncIdentifier, AlfrescoPermissions *permissions) {
+        self.nodesPermissions[syncIdentifier] = permissions;
+    } completionBlock:nil];
 }
 
 - (void)retrieveAndSetPermissionsOfCurrentFolder
@@ -177,64 +224,16 @@
         FileFolderCollectionViewCell *nodeCell = [collectionView dequeueReusableCellWithReuseIdentifier:[FileFolderCollectionViewCell cellIdentifier] forIndexPath:indexPath];
         if(indexPath.item < self.dataSourceCollection.count)
         {
-            AlfrescoNode *node = self.dataSourceCollection[indexPath.item];
-            RealmSyncManager *syncManager = [RealmSyncManager sharedManager];
-            
-            SyncNodeStatus *nodeStatus = [syncManager syncStatusForNodeWithId:node.identifier];
-            [nodeCell updateCellInfoWithNode:node nodeStatus:nodeStatus];
-            [nodeCell registerForNotifications];
-            
-            [self updateFavoriteStatusIconForNodeCell:nodeCell node:node];
+            self.boundCollectionView = collectionView;
             
+            // Everything the cell shows has been resolved when the page arrived; binding does no lookups
+            AlfrescoNode *node = self.dataSourceCollection[indexPath.item];
+            NodeCellViewModel *viewModel = [self.viewModelBuilder viewModelForNode:node];
             BaseCollectionViewFlowLayout *currentLayout = [self.delegate currentSelectedLayout];
-            
-            if (node.isFolder)
-            {
-                if(currentLayout.shouldShowSmallThumbnail)
-                {
-                    [nodeCell.image setImage:smallImageForType(@"folder") withFade:NO];
-                }
-                else
-                {
-                    [nodeCell.image setImage:largeImageForType(@"folder") withFade:NO];
-                }
-            }
-            else if (node.isDocument)
-            {
-                AlfrescoDocument *document = (AlfrescoDocument *)node;
-                ThumbnailManager *thumbnailManager = [ThumbnailManager sharedManager];
-                UIImage *thumbnail = [thumbnailManager thumbnailForDocument:document renditionType:kRenditionImageDocLib];
-                
-                if (thumbnail)
-                {
-                    [nodeCell.image setImage:thumbnail withFade:NO];
-                }
-                else
-                {
-                    if(currentLayout.shouldShowSmallThumbnail)
-                    {
-                        [nodeCell.image setImage:smallImageForType([document.name pathExtension]) withFade:NO];
-                    }
-                    else
-                    {
-                        [nodeCell.image setImage:largeImageForType([document.name pathExtension]) withFade:NO];
-                    }
-                    [thumbnailManager retrieveImageForDocument:document renditionType:kRenditionImageDocLib session:self.session completionBlock:^(UIImage *image, NSError *error) {
-                        if (image)
-                        {
-                            // MOBILE-2991, check the tableView and indexPath objects are still valid as there is a chance
-                            // by the time completion block is called the table view could have been unloaded.
-                            if (collectionView && indexPath)
-                            {
-                                FileFolderCollectionViewCell *updateCell = (FileFolderCollectionViewCell *)[collectionView cellForItemAtIndexPath:indexPath];
-                                [updateCell.image setImage:image withFade:YES];
-                            }
-                        }
-                    }];
-                }
-            }
-            
+            [nodeCell updateCellWithViewModel:viewModel smallThumbnail:currentLayout.shouldShowSmallThumbnail];
             nodeCell.accessoryViewDelegate = [self.delegate cellAccessoryViewDelegate];
+            
+            [self retrieveThumbnailForViewModelIfNeeded:viewModel];
         }
         return nodeCell;
     }
@@ -339,13 +338,10 @@
                                                                label:analyticsLabel
                                                                value:@1];
             
-            NSArray *collectionViewNodeIdentifiers = nil;
-            NSIndexPath *indexPathForNode = nil;
             // remove nodeToDelete from collection view
-            collectionViewNodeIdentifiers = [weakSelf.dataSourceCollection valueForKeyPath:@"identifier"];
+            NSIndexPath *indexPathForNode = [weakSelf indexPathForNodeWithIdentifier:nodeToDelete.identifier];
             [weakSelf.dataSourceCollection removeObject:nodeToDelete];
             
-            indexPathForNode = [self indexPathForNodeWithIdentifier:nodeToDelete.identifier inNodeIdentifiers:collectionViewNodeIdentifiers];
             if (indexPathForNode != nil)
             {
                 [weakSelf.delegate didDeleteItems:[NSArray arrayWithObject:nodeToDelete] atIndexPaths:[NSArray arrayWithObject:indexPathForNode]];
@@ -419,12 +415,13 @@
     };
     
     NSMutableArray *newNodeIndexPaths = [NSMutableArray arrayWithCapacity:alfrescoNodes.count];
+    NSMutableArray *nodesWithoutPermissions = [NSMutableArray array];
     for (AlfrescoNode *node in alfrescoNodes)
     {
         AlfrescoPermissions *nodePermissions = self.nodesPermissions[[[RealmSyncCore sharedSyncCore] syncIdentifierForNode:node]];
         if(!nodePermissions)
         {
-            [self retrievePermissionsForNode:node];
+            [nodesWithoutPermissions addObject:node];
         }
         // add to the collectionView data source at the correct index
         NSUInteger newIndex = [self.dataSourceCollection indexOfObject:node inSortedRange:NSMakeRange(0, self.dataSourceCollection.count) options:NSBinarySearchingInsertionIndex usingComparator:comparator];
@@ -433,6 +430,7 @@
         NSIndexPath *indexPath = [NSIndexPath indexPathForRow:newIndex inSection:0];
         [newNodeIndexPaths addObject:indexPath];
     }
+    [self retrievePermissionsForNodes:nodesWithoutPermissions];
     
     [self.delegate didAddNodes:alfrescoNodes atIndexPath:newNodeIndexPaths];
 }
@@ -478,6 +476,12 @@
 
 #pragma mark - Private methods
 
+- (NSIndexPath *)indexPathForNodeWithIdentifier:(NSString *)identifier
+{
+    NSUInteger index = [self.nodeCollection indexOfNodeWithIdentifier:identifier];
+    return (index != NSNotFound) ? [NSIndexPath indexPathForItem:index inSection:0] : nil;
+}
+
 - (NSIndexPath *)indexPathForNodeWithIdentifier:(NSString *)identifier inNodeIdentifiers:(NSArray *)collectionViewNodeIdentifiers
 {
     NSIndexPath *indexPath = nil;
@@ -539,10 +543,7 @@
         [self.documentService retrieveChildrenInFolder:(AlfrescoFolder *)self.parentNode listingContext:self.defaultListingContext completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
             if (!error)
             {
-                for (AlfrescoNode *node in pagingResult.objects)
-                {
-                    [weakSelf retrievePermissionsForNode:node];
-                }
+                [weakSelf retrievePermissionsForNodes:pagingResult.objects];
                 
                 if (!self.parentFolderPermissions)
                 {
@@ -573,10 +574,7 @@
     [self.documentService retrieveChildrenInFolder:folder listingContext:listingContext completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
         if (!error)
         {
-            for (AlfrescoNode *node in pagingResult.objects)
-            {
-                [self retrievePermissionsForNode:node];
-            }
+            [self retrievePermissionsForNodes:pagingResult.objects];
         }
         if (completionBlock != NULL)
         {
@@ -585,14 +583,53 @@
     }];
 }
 
-- (void)updateFavoriteStatusIconForNodeCell:(FileFolderCollectionViewCell *)nodeCell node:(AlfrescoNode *)node
+- (void)updateVisibleCellsWithViewModels:(NSArray<NodeCellViewModel *> *)viewModels
 {
-    BOOL isSyncOn = [node isNodeInSyncList];
-    BOOL isTopLevelNode = [node isTopLevelSyncNode];
+    UICollectionView *collectionView = self.boundCollectionView;
+    if (collectionView.dataSource != self)
+    {
+        return;
+    }
+    
+    BOOL smallThumbnail = [self.delegate currentSelectedLayout].shouldShowSmallThumbnail;
+    for (NodeCellViewModel *viewModel in viewModels)
+    {
+        NSIndexPath *indexPath = [self indexPathForNodeWithIdentifier:viewModel.node.identifier];
+        FileFolderCollectionViewCell *cell = indexPath ? (FileFolderCollectionViewCell *)[collectionView cellForItemAtIndexPath:indexPath] : nil;
+        if ([cell isKindOfClass:[FileFolderCollectionViewCell class]])
+        {
+            [cell updateCellWithViewModel:viewModel smallThumbnail:smallThumbnail];
+            [self retrieveThumbnailForViewModelIfNeeded:viewModel];
+        }
+    }
+}
 
-    [nodeCell updateStatusIconsIsFavoriteNode:NO isSyncNode:isSyncOn isTopLevelSyncNode:isTopLevelNode animate:NO];
-    [[FavouriteManager sharedManager] isNodeFavorite:node session:self.session completionBlock:^(BOOL isFavorite, NSError *error) {
-        [nodeCell updateStatusIconsIsFavoriteNode:isFavorite isSyncNode:isSyncOn isTopLevelSyncNode:isTopLevelNode animate:NO];
+- (void)retrieveThumbnailForViewModelIfNeeded:(NodeCellViewModel *)viewModel
+{
+    if (viewModel.isPlaceholder || viewModel.thumbnail || viewModel.hasRequestedThumbnail || !viewModel.node.isDocument)
+    {
+        return;
+    }
+    
+    viewModel.hasRequestedThumbnail = YES;
+    __weak typeof(self) weakSelf = self;
+    [[ThumbnailManager sharedManager] retrieveImageForDocument:(AlfrescoDocument *)viewModel.node renditionType:kRenditionImageDocLib session:self.session completionBlock:^(UIImage *image, NSError *error) {
+        if (image)
+        {
+            viewModel.thumbnail = image;
+            
+            // MOBILE-2991, the collection view may have been unloaded by the time the completion block is called
+            UICollectionView *collectionView = weakSelf.boundCollectionView;
+            NSIndexPath *indexPath = [weakSelf indexPathForNodeWithIdentifier:viewModel.node.identifier];
+            if (collectionView && indexPath)
+            {
+                FileFolderCollectionViewCell *updateCell = (FileFolderCollectionViewCell *)[collectionView cellForItemAtIndexPath:indexPath];
+                if ([updateCell isKindOfClass:[FileFolderCollectionViewCell class]] && updateCell.node == viewModel.node)
+                {
+                    [updateCell.image setImage:image withFade:YES];
+                }
+            }
+        }
     }];
 }
 
@@ -608,10 +645,10 @@
         AlfrescoDocument *existingDocument = (AlfrescoDocument *)existingDocumentObject;
         AlfrescoDocument *updatedDocument = (AlfrescoDocument *)updatedDocumentObject;
         
-        NSArray *allIdentifiers = [self.dataSourceCollection valueForKey:@"identifier"];
-        if ([allIdentifiers containsObject:existingDocument.identifier])
+        NSUInteger index = [self.nodeCollection indexOfNodeWithIdentifier:existingDocument.identifier];
+        if (index != NSNotFound)
         {
-            NSUInteger index = [allIdentifiers indexOfObject:existingDocument.identifier];
+            [self.viewModelBuilder invalidateViewModelForNode:existingDocument];
             [self.dataSourceCollection replaceObjectAtIndex:index withObject:updatedDocument];
             NSIndexPath *indexPathOfDocument = [NSIndexPath indexPathForRow:index inSection:0];
             
@@ -659,10 +696,11 @@
     NSString *nodeIdentifierUpdated = notification.object;
     AlfrescoDocument *updatedDocument = notification.userInfo[kAlfrescoDocumentUpdatedFromDocumentParameterKey];
     
-    NSIndexPath *indexPath = [self indexPathForNodeWithIdentifier:nodeIdentifierUpdated inNodeIdentifiers:[self.dataSourceCollection valueForKey:@"identifier"]];
+    NSIndexPath *indexPath = [self indexPathForNodeWithIdentifier:nodeIdentifierUpdated];
     
     if (indexPath)
     {
+        [self.viewModelBuilder invalidateViewModelForNode:self.dataSourceCollection[indexPath.row]];
         [self.dataSourceCollection replaceObjectAtIndex:indexPath.row withObject:updatedDocument];
         [self.delegate reloadItemsAtIndexPaths:@[indexPath] reselectItems:NO];
     }
@@ -676,6 +714,7 @@
     
     if (indexPath)
     {
+        [self.viewModelBuilder invalidateViewModelForNode:self.dataSourceCollection[indexPath.row]];
         [self.dataSourceCollection replaceObjectAtIndex:indexPath.row withObject:editedDocument];
         [self.delegate reloadItemsAtIndexPaths:@[indexPath] reselectItems:NO];
     }
@@ -18,9 +18,13 @@
 
 #import "RepositoryCollectionViewDataSource.h"
 
+@class SearchQueryEngine;
+
 @interface SearchCollectionViewDataSource : RepositoryCollectionViewDataSource
 
 - (instancetype)initWithSearchString:(NSString *)searchString searchOptions:(AlfrescoKeywordSearchOptions *)options emptyMessage:(NSString *)emptyMessage session:(id<AlfrescoSession>)session delegate:(id<RepositoryCollectionViewDataSourceDelegate>)delegate listingContext:(AlfrescoListingContext *)listingContext;
+// Sharing an engine between successive searches lets a new search cancel the previous one and reuse its cached results
+- (instancetype)initWithSearchString:(NSString *)searchString searchOptions:(AlfrescoKeywordSearchOptions *)options searchEngine:(SearchQueryEngine *)searchEngine emptyMessage:(NSString *)emptyMessage session:(id<AlfrescoSession>)session delegate:(id<RepositoryCollectionViewDataSourceDelegate>)delegate listingContext:(AlfrescoListingContext *)listingContext;
 - (instancetype)initWithSearchStatement:(NSString *)searchStatement session:(id<AlfrescoSession>)session delegate:(id<RepositoryCollectionViewDataSourceDelegate>)delegate listingContext:(AlfrescoListingContext *)listingContext;
 
 @end
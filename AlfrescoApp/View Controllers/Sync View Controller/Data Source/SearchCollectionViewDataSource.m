@@ -18,6 +18,15 @@
 
 #import "SearchCollectionViewDataSource.h"
 #import "RepositoryCollectionViewDataSource+Internal.h"
+#import "LocalSearchIndex.h"
+#import "RealmSyncCore.h"
+#import "RealmManager.h"
+#import "DownloadManager.h"
+#import "AccountManager.h"
+#import "ConnectivityManager.h"
+#import "SearchQueryEngine.h"
+
+static NSUInteger const kMaximumOfflineSearchResults = 100;
 
 @interface SearchCollectionViewDataSource ()
 
@@ -25,6 +34,7 @@
 @property (nonatomic, strong) AlfrescoKeywordSearchOptions *searchOptions;
 @property (nonatomic, strong) NSString *searchStatement;
 @property (nonatomic, strong) NSString *searchString;
+@property (nonatomic, strong) SearchQueryEngine *searchEngine;
 
 @end
 
@@ -53,6 +63,11 @@
 }
 
 - (instancetype)initWithSearchString:(NSString *)searchString searchOptions:(AlfrescoKeywordSearchOptions *)options emptyMessage:(NSString *)emptyMessage session:(id<AlfrescoSession>)session delegate:(id<RepositoryCollectionViewDataSourceDelegate>)delegate listingContext:(AlfrescoListingContext *)listingContext
+{
+    return [self initWithSearchString:searchString searchOptions:options searchEngine:nil emptyMessage:emptyMessage session:session delegate:delegate listingContext:listingContext];
+}
+
+- (instancetype)initWithSearchString:(NSString *)searchString searchOptions:(AlfrescoKeywordSearchOptions *)options searchEngine:(SearchQueryEngine *)searchEngine emptyMessage:(NSString *)emptyMessage session:(id<AlfrescoSession>)session delegate:(id<RepositoryCollectionViewDataSourceDelegate>)delegate listingContext:(AlfrescoListingContext *)listingContext
 {
     self = [super init];
     if(!self)
@@ -61,6 +76,7 @@
     }
     
     self.emptyMessage = emptyMessage;
+    self.searchEngine = searchEngine ?: [[SearchQueryEngine alloc] initWithSession:session];
     self.session = session;
     self.delegate = delegate;
     self.searchString = searchString;
@@ -80,6 +96,10 @@
 {
     if(session)
     {
+        if (self.session && self.session != session)
+        {
+            [self.searchEngine updateSession:session];
+        }
         [super setSession:session];
         self.searchService = [[AlfrescoSearchService alloc] initWithSession:self.session];
         self.shouldAllowMultiselect = YES;
@@ -95,13 +115,13 @@
     void (^completionBlock)(AlfrescoPagingResult *, NSError *) = ^void(AlfrescoPagingResult *pagingResult, NSError *error){
         if(pagingResult)
         {
-            if (self.dataSourceCollection == nil)
+            if (weakSelf.dataSourceCollection == nil)
             {
-                self.dataSourceCollection = [NSMutableArray array];
+                weakSelf.dataSourceCollection = [NSMutableArray array];
             }
-            [self.dataSourceCollection addObjectsFromArray:pagingResult.objects];
+            [weakSelf.dataSourceCollection addObjectsFromArray:pagingResult.objects];
             
-            self.moreItemsAvailable = pagingResult.hasMoreItems;
+            weakSelf.moreItemsAvailable = pagingResult.hasMoreItems;
             [weakSelf.delegate dataSourceUpdated];
         }
         else
@@ -117,13 +137,21 @@
         }
     };
     
-    if (self.searchStatement)
+    if (self.searchString && ![[ConnectivityManager sharedManager] hasInternetConnection])
+    {
+        [self searchLocalContent];
+    }
+    else if (self.searchStatement)
     {
         [self.searchService searchWithStatement:self.searchStatement language:AlfrescoSearchLanguageCMIS listingContext:moreListingContext completionBlock:completionBlock];
     }
+    else if (self.searchString && moreListingContext.skipCount == 0)
+    {
+        [self.searchEngine searchFor:self.searchString type:SearchViewControllerDataSourceTypeSearchFiles options:self.searchOptions listingContext:moreListingContext debounce:NO completionBlock:completionBlock];
+    }
     else if (self.searchString)
     {
-        [self.searchService searchWithKeywords:self.searchString options:self.searchOptions listingContext:moreListingContext completionBlock:completionBlock];
+        [self.searchEngine retrieveResultsWithListingContext:moreListingContext completionBlock:completionBlock];
     }
 }
 
@@ -133,6 +161,45 @@
     [self retrieveNextItems:self.defaultListingContext];
 }
 
+- (void)searchLocalContent
+{
+    // Offline, only synced and downloaded content can be found, so search the on-device index instead
+    NSString *accountIdentifier = [AccountManager sharedManager].selectedAccount.accountIdentifier;
+    NSArray *scopes = accountIdentifier ? @[kLocalSearchIndexDownloadsScope, accountIdentifier] : @[kLocalSearchIndexDownloadsScope];
+    
+    __weak typeof(self) weakSelf = self;
+    [[LocalSearchIndex sharedIndex] searchWithQuery:self.searchString inScopes:scopes limit:kMaximumOfflineSearchResults completionBlock:^(NSArray<LocalSearchIndexEntry *> *entries) {
+        RLMRealm *realm = [[RealmManager sharedManager] realmForCurrentThread];
+        NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:entries.count];
+        for (LocalSearchIndexEntry *entry in entries)
+        {
+            AlfrescoNode *node = nil;
+            if (entry.source == LocalSearchIndexSourceSynced)
+            {
+                node = [[RealmSyncCore sharedSyncCore] syncNodeInfoForId:entry.identifier inRealm:realm].alfrescoNode;
+            }
+            else
+            {
+                node = [[DownloadManager sharedManager] infoForDocument:entry.identifier];
+            }
+            
+            // Entries without stored node metadata can't be shown in the listing
+            if (node)
+            {
+                [nodes addObject:node];
+            }
+        }
+        
+        if (weakSelf.dataSourceCollection == nil)
+        {
+            weakSelf.dataSourceCollection = [NSMutableArray array];
+        }
+        [weakSelf.dataSourceCollection addObjectsFromArray:nodes];
+        weakSelf.moreItemsAvailable = NO;
+        [weakSelf.delegate dataSourceUpdated];
+    }];
+}
+
 - (NSString*)getSearchType
 {
     return (self.searchOptions) ? self.searchOptions.typeName : [super getSearchType];
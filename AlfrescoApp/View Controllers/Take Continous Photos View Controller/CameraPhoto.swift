@@ -17,11 +17,15 @@
 ******************************************************************************/
 
 import Foundation
+import ImageIO
 import Photos
 import UIKit
 
 class CameraPhoto: NSObject {
-    var capturePhoto: AVCapturePhoto
+    let filePath: String
+    let sizeBytes: Int
+    let metadata: [String: Any]
+    var thumbnail: UIImage?
     var selected: Bool = true
     var orientationImage: UIImage.Orientation?
     var name: String
@@ -29,35 +33,57 @@ class CameraPhoto: NSObject {
     var alfrescoDocument: AlfrescoDocument?
     var retryUploading: Bool
     var uploaded: Bool
+    private let spool: CapturePhotoSpool
     
-    init(capture: AVCapturePhoto, and orientation: UIInterfaceOrientation) {
-        self.capturePhoto = capture
+    static let thumbnailMaxPixelSize = 300
+    
+    init?(capture: AVCapturePhoto, and orientation: UIInterfaceOrientation, spool: CapturePhotoSpool = CapturePhotoSpool.shared) {
+        guard let imageData = capture.fileDataRepresentation() else {
+            AlfrescoLog.logError("Error while generating image from photo capture data.")
+            return nil
+        }
+        self.spool = spool
+        self.filePath = spool.spool(imageData)
+        self.sizeBytes = imageData.count
+        self.metadata = capture.metadata
         self.selected = true
         self.orientationImage = orientation.imageOrientation()
         self.name = String(capture.timestamp.value)
         self.orientationMetadata = orientation.imagePropertyOrientation()
         retryUploading = false
         uploaded = false
+        super.init()
+        self.thumbnail = makeThumbnail(from: imageData)
+    }
+    
+    deinit {
+        spool.remove(atPath: filePath)
     }
     
     func getSizeMB() -> Double {
-        guard let imageData = capturePhoto.fileDataRepresentation() else {
-            AlfrescoLog.logError("Error while generating image from photo capture data.")
-            return 0.0
-        }
-        return Double(imageData.count / 1048576)
+        return Double(sizeBytes) / 1048576
     }
     
-    func getImage() -> UIImage? {
-        guard let imageData = capturePhoto.fileDataRepresentation() else {
-            AlfrescoLog.logError("Error while generating image from photo capture data.")
-            return nil
+    func writeContent(toFilePath filePath: String, addingGPS: Bool) -> Bool {
+        guard let imageData = spool.data(atPath: self.filePath) else {
+            AlfrescoLog.logError("Error while reading spooled photo capture data.")
+            return false
         }
-        guard let uiImage = UIImage(data: imageData) else {
-            AlfrescoLog.logError("Unable to generate UIImage from image data.");
+        var metadata = Utility.metadata(byAddingOrientation: orientationMetadata, toMetadata: self.metadata)
+        if addingGPS {
+            metadata = Utility.metadataByAddingGPS(toMetadata: metadata)
+        }
+        return Utility.writeImageData(imageData, metadata: metadata, toFilePath: filePath)
+    }
+    
+    private func makeThumbnail(from imageData: Data) -> UIImage? {
+        guard let imageSource = CGImageSourceCreateWithData(imageData as CFData, nil) else {
+            AlfrescoLog.logError("Unable to create image source from photo capture data.")
             return nil
         }
-        guard let cgImage = uiImage.cgImage else {
+        let options: [CFString: Any] = [kCGImageSourceCreateThumbnailFromImageAlways: true,
+                                        kCGImageSourceThumbnailMaxPixelSize: CameraPhoto.thumbnailMaxPixelSize]
+        guard let cgImage = CGImageSourceCreateThumbnailAtIndex(imageSource, 0, options as CFDictionary) else {
             AlfrescoLog.logError("Error generating CGImage")
             return nil
         }
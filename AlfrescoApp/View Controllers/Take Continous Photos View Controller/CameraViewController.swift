@@ -198,16 +198,16 @@ import CoreMotion
                 return
             }
             
+            var orientation = sSelf.orientationLast
             if sSelf.cameraController.currentCameraPosition == .front {
                 if sSelf.orientationLast == .landscapeRight {
-                    sSelf.cameraPhotos.append(CameraPhoto(capture: photo, and: .landscapeLeft))
+                    orientation = .landscapeLeft
                 } else if sSelf.orientationLast == .landscapeLeft {
-                    sSelf.cameraPhotos.append(CameraPhoto(capture: photo, and: .landscapeRight))
-                } else {
-                    sSelf.cameraPhotos.append(CameraPhoto(capture: photo, and: sSelf.orientationLast))
+                    orientation = .landscapeRight
                 }
-            } else {
-                sSelf.cameraPhotos.append(CameraPhoto(capture: photo, and: sSelf.orientationLast))
+            }
+            if let cameraPhoto = CameraPhoto(capture: photo, and: orientation) {
+                sSelf.cameraPhotos.append(cameraPhoto)
             }
         }
     }
@@ -0,0 +1,73 @@
+/*******************************************************************************
+* Copyright (C) 2005-2020 Alfresco Software Limited.
+*
+* This file is part of the Alfresco Mobile iOS App.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+******************************************************************************/
+
+import Foundation
+
+/// Keeps captured photos on disk instead of in memory. Every capture gets a file of its own, which lives until
+/// the photo holding it removes it.
+class CapturePhotoSpool: NSObject {
+    
+    static let shared = CapturePhotoSpool()
+    
+    let directoryPath: String
+    private let queue = DispatchQueue(label: "com.alfresco.app.capturephotospool")
+    
+    //MARK: Init
+    
+    override init() {
+        let temporaryDirectory = AlfrescoFileManager.shared()?.temporaryDirectory() ?? NSTemporaryDirectory()
+        self.directoryPath = (temporaryDirectory as NSString).appendingPathComponent("CapturedPhotos")
+        super.init()
+        
+        // Anything left over belongs to a previous session that did not finish cleanly
+        try? FileManager.default.removeItem(atPath: directoryPath)
+        do {
+            try FileManager.default.createDirectory(atPath: directoryPath, withIntermediateDirectories: true, attributes: [.protectionKey: FileProtectionType.completeUnlessOpen])
+        } catch {
+            AlfrescoLog.logError("Unable to create capture spool directory: " + error.localizedDescription)
+        }
+    }
+    
+    //MARK: Spooling
+    
+    /// Writes the data to a new uniquely named file in the background and returns its path.
+    func spool(_ data: Data) -> String {
+        let filePath = (directoryPath as NSString).appendingPathComponent(UUID().uuidString + ".jpg")
+        queue.async {
+            do {
+                try data.write(to: URL(fileURLWithPath: filePath), options: [.atomic, .completeFileProtectionUnlessOpen])
+            } catch {
+                AlfrescoLog.logError("Unable to spool captured photo: " + error.localizedDescription)
+            }
+        }
+        return filePath
+    }
+    
+    /// Reads spooled data back, waiting for any pending write of the same file.
+    func data(atPath filePath: String) -> Data? {
+        return queue.sync {
+            return try? Data(contentsOf: URL(fileURLWithPath: filePath), options: .alwaysMapped)
+        }
+    }
+    
+    func remove(atPath filePath: String) {
+        queue.async {
+            try? FileManager.default.removeItem(atPath: filePath)
+        }
+    }
+}
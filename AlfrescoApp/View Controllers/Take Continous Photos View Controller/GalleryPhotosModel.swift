@@ -24,10 +24,15 @@ protocol GalleryPhotosDelegate: class {
     func finishUploadPhotos()
     func retryMode()
     func uploading(photo: CameraPhoto, with progress: Float)
+    func uploading(totalProgress: Float)
     func successUploading(photo: CameraPhoto)
     func errorUploading(photo: CameraPhoto, error: NSError?)
 }
 
+extension GalleryPhotosDelegate {
+    func uploading(photo: CameraPhoto, with progress: Float) {}
+}
+
 @objc class GalleryPhotosModel: NSObject {
 
     var okText = NSLocalizedString("OK", comment: "OK")
@@ -63,7 +68,7 @@ protocol GalleryPhotosDelegate: class {
     var documentServices: AlfrescoDocumentFolderService
     var uploadToFolder: AlfrescoFolder
     var imagesName: String
-    var indexUploadingPhotos: Int = -1
+    var uploadQueue: BatchUploadQueue?
     
     @objc var cameraPhotos: [CameraPhoto] = []
     var documents: [AlfrescoDocument] = []
@@ -85,99 +90,43 @@ protocol GalleryPhotosDelegate: class {
     //MARK: Upload
 
     func uploadPhotosWithContentStream() {
-        indexUploadingPhotos = indexUploadingPhotos + 1
-    
-        if indexUploadingPhotos == self.cameraPhotos.count {
-            documents.append(contentsOf: alfrescoDocuments())
-            if retryUploadingPhotos().count == 0 {
-                delegate?.finishUploadPhotos()
-            } else {
-                resetForRetryModeUpload()
-                delegate?.retryMode()
-            }
-            return
-        }
-        
-        let photo = cameraPhotos[indexUploadingPhotos]
+        let addingGPS = LocationManager.shared()?.usersLocationAuthorisation() == true
+        var items: [BatchUploadItem] = []
         
-        if photo.selected {
+        for photo in cameraPhotos where photo.selected {
             let index = indexOf(cameraPhotoSelected: photo)
             photo.name = defaultNameWithDate(photo: photo, index: index)
             
-            upload(photo) { [weak self] (completed) in
-                guard let sSelf = self else { return }
-                if !completed {
-                    photo.retryUploading = true
-                }
-                sSelf.uploadPhotosWithContentStream()
+            let item = BatchUploadItem(documentName: photo.name + ".jpg", mimeType: "image/jpeg", filePath: spoolFilePath(for: photo))
+            item.context = photo
+            item.removeFileAfterUpload = true
+            item.contentPreparationBlock = { (filePath) -> Bool in
+                return photo.writeContent(toFilePath: filePath, addingGPS: addingGPS)
             }
-        } else {
-            self.uploadPhotosWithContentStream()
-        }
-    }
-    
-    func upload(_ photo: CameraPhoto, finishUpload: @escaping((Bool) -> Void)) {
-        
-        guard let image = photo.getImage() else {
-            return
+            items.append(item)
         }
         
-        let documentName = photo.name + ".jpg"
-        let mimetype = "image/jpeg"
-        
-        var metadata = Utility.metadata(byAddingOrientation: photo.orientationMetadata, toMetadata: photo.capturePhoto.metadata)
-        if LocationManager.shared()?.usersLocationAuthorisation() == true {
-            metadata = Utility.metadataByAddingGPS(toMetadata: metadata)
-        }
-        
-        let contentData = Utility.data(from: image, metadata: metadata, mimetype: mimetype)
-        
-        let contentFile = AlfrescoContentFile.init(data: contentData, mimeType: mimetype)
-        let pathToTempFile = contentFile?.fileUrl.path
-        
-        let readStream = AlfrescoFileManager.shared()?.inputStream(withFilePath: pathToTempFile)
-        let contentStream = AlfrescoContentStream.init(stream: readStream, mimeType: mimetype, length: contentFile?.length ?? 0)
-        
-        self.documentServices.createDocument(withName: documentName, inParentFolder: self.uploadToFolder, contentStream: contentStream, properties: nil, aspects: nil, completionBlock: { [weak self] (document, error) in
-            
-            guard let sSelf = self else { return }
-            
-            if let document = document {
-                
-                RealmSyncManager.shared()?.didUploadNode(document, fromPath: pathToTempFile, to: sSelf.uploadToFolder)
-                
-                photo.uploaded = true
-                photo.alfrescoDocument = document
-                
-                sSelf.delegate?.successUploading(photo: photo)
-                
-                finishUpload(true)
-                
-            } else if let error = error {
-                AlfrescoLog.logError(error.localizedDescription)
-                sSelf.delegate?.errorUploading(photo: photo, error: error as NSError)
-                sSelf.errorUpload = error as NSError
-                finishUpload(false)
-            } else {
-                sSelf.delegate?.errorUploading(photo: photo, error: nil)
-                finishUpload(false)
-            }
-        }) { [weak self] (bytesTransferred, bytesTotal)  in
-            guard let sSelf = self else { return }
-            let progress = (bytesTotal == 0) ? Float(1.0) : Float(bytesTransferred) / Float(bytesTotal)
-            sSelf.delegate?.uploading(photo: photo, with: progress)
-        }
+        let queue = BatchUploadQueue(documentFolderService: documentServices, uploadFolder: uploadToFolder)
+        queue.delegate = self
+        uploadQueue = queue
+        queue.uploadItems(items)
     }
     
     func resetForRetryModeUpload() {
         retryMode = true
-        indexUploadingPhotos = -1
         cameraPhotos = retryUploadingPhotos()
         for camera in cameraPhotos {
             camera.retryUploading = false
         }
     }
     
+    //MARK: Spooling
+    
+    func spoolFilePath(for photo: CameraPhoto) -> String {
+        let temporaryDirectory = AlfrescoFileManager.shared()?.temporaryDirectory() ?? NSTemporaryDirectory()
+        return (temporaryDirectory as NSString).appendingPathComponent(photo.name + ".jpg")
+    }
+    
     //MARK: Utils
     
     func defaultNameWithDate(photo: CameraPhoto, index: Int) -> String {
@@ -303,3 +252,49 @@ protocol GalleryPhotosDelegate: class {
         return true
     }
 }
+
+//MARK: - BatchUploadQueue Delegate
+
+extension GalleryPhotosModel: BatchUploadQueueDelegate {
+    
+    func batchUploadQueue(_ queue: BatchUploadQueue, item: BatchUploadItem, didUpdateProgress progress: Float) {
+        guard let photo = item.context as? CameraPhoto else { return }
+        delegate?.uploading(photo: photo, with: progress)
+    }
+    
+    func batchUploadQueue(_ queue: BatchUploadQueue, didUpdateTotalProgress progress: Float) {
+        delegate?.uploading(totalProgress: progress)
+    }
+    
+    func batchUploadQueue(_ queue: BatchUploadQueue, didUpload item: BatchUploadItem) {
+        guard let photo = item.context as? CameraPhoto, let document = item.document else { return }
+        
+        RealmSyncManager.shared()?.didUploadNode(document, fromPath: item.filePath, to: uploadToFolder)
+        
+        photo.uploaded = true
+        photo.alfrescoDocument = document
+        delegate?.successUploading(photo: photo)
+    }
+    
+    func batchUploadQueue(_ queue: BatchUploadQueue, didFailToUpload item: BatchUploadItem) {
+        guard let photo = item.context as? CameraPhoto else { return }
+        
+        photo.retryUploading = true
+        if let error = item.error as NSError? {
+            AlfrescoLog.logError(error.localizedDescription)
+            errorUpload = error
+        }
+        delegate?.errorUploading(photo: photo, error: item.error as NSError?)
+    }
+    
+    func batchUploadQueue(_ queue: BatchUploadQueue, didFinishUploadingItems items: [Any]) {
+        uploadQueue = nil
+        documents.append(contentsOf: alfrescoDocuments())
+        if retryUploadingPhotos().count == 0 {
+            delegate?.finishUploadPhotos()
+        } else {
+            resetForRetryModeUpload()
+            delegate?.retryMode()
+        }
+    }
+}
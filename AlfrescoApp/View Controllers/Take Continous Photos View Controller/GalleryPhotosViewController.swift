@@ -175,7 +175,7 @@ import AVFoundation
     func uploadPhotos() {
         userInteraction(enable: false)
         mbprogressHUD = MBProgressHUD.showAdded(to: view, animated: true)
-        mbprogressHUD.mode = .indeterminate
+        mbprogressHUD.mode = .determinate
         mbprogressHUD.label.text = model.photosRemainingToUploadText()
         model.uploadPhotosWithContentStream()
     }
@@ -213,8 +213,8 @@ extension GalleryPhotosViewController: CameraDelegate {
 
 extension GalleryPhotosViewController: GalleryPhotosDelegate {
 
-    func uploading(photo: CameraPhoto, with progress: Float) {
-        mbprogressHUD.progress = progress
+    func uploading(totalProgress: Float) {
+        mbprogressHUD.progress = totalProgress
     }
     
     func errorUploading(photo: CameraPhoto, error: NSError?) {
@@ -223,7 +223,6 @@ extension GalleryPhotosViewController: GalleryPhotosDelegate {
     
     func successUploading(photo: CameraPhoto) {
         mbprogressHUD.label.text = model.photosRemainingToUploadText()
-        mbprogressHUD.progress = 1.0
     }
     
     func finishUploadPhotos() {
@@ -266,7 +265,7 @@ extension GalleryPhotosViewController: UICollectionViewDataSource, UICollectionV
     func collectionView(_ collectionView: UICollectionView, cellForItemAt indexPath: IndexPath) -> UICollectionViewCell {
         let cell = collectionView.dequeueReusableCell(withReuseIdentifier: "photoCell",
                                                       for: indexPath) as! PhotoCollectionViewCell
-        cell.photo.image = model.cameraPhotos[indexPath.row].getImage()
+        cell.photo.image = model.cameraPhotos[indexPath.row].thumbnail
         cell.selectedView.isHidden = !model.cameraPhotos[indexPath.row].selected
         return cell
     }
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+/**
+ * The text of a file being edited, held as a piece table over the text the file was opened with.
+ *
+ * Edits are recorded as pieces, so whether the text changed, and from where, is known without reading the file again.
+ * Saving rewrites the file from the first modified character only. The file is mapped rather than read, and its encoding
+ * is detected from a prefix. Not thread safe: use a document from one thread at a time.
+ */
+@interface TextFileDocument : NSObject
+
+@property (nonatomic, assign, readonly) NSStringEncoding encoding;
+@property (nonatomic, assign, readonly) NSUInteger length;
+/// The current text, including any edits
+@property (nonatomic, strong, readonly) NSString *text;
+/// Whether the text differs from the text opened or last saved
+@property (nonatomic, assign, readonly, getter=isModified) BOOL modified;
+/// The index of the first character edited since opening or saving, or NSNotFound
+@property (nonatomic, assign, readonly) NSUInteger firstModifiedIndex;
+/// The number of bytes written by the last save
+@property (nonatomic, assign, readonly) unsigned long long bytesWrittenByLastSave;
+
+/*
+ * Detects the encoding of the data from its byte order mark or its first bytes, falling back to Windows Latin 1 if they are not UTF-8.
+ */
++ (NSStringEncoding)encodingOfData:(NSData *)data byteOrderMarkLength:(NSUInteger *)byteOrderMarkLength;
+
+- (instancetype)initWithContentsOfFile:(NSString *)filePath error:(NSError **)error;
+
+- (void)replaceCharactersInRange:(NSRange)range withString:(NSString *)string;
+
+/*
+ * Brings the document in line with text edited elsewhere, such as in a text view, replacing only the part that differs.
+ */
+- (void)synchroniseWithText:(NSString *)text;
+
+/*
+ * Saves the text to a file holding the text as it was opened or last saved, rewriting it from the first modified character.
+ * Any other file is rewritten entirely. If an edit can't be represented in the file's encoding, the file is rewritten as UTF-8.
+ */
+- (BOOL)saveToFile:(NSString *)filePath error:(NSError **)error;
+
+@end
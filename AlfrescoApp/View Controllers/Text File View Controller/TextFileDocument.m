@@ -0,0 +1,433 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "TextFileDocument.h"
+
+static NSUInteger const kEncodingDetectionPrefixLength = 64 * 1024;
+static NSUInteger const kSaveChunkLength = 256 * 1024;
+static NSUInteger const kComparisonChunkLength = 4096;
+
+typedef NS_ENUM(NSUInteger, TextFileDocumentPieceSource)
+{
+    TextFileDocumentPieceSourceOriginal = 0,
+    TextFileDocumentPieceSourceAdded
+};
+
+@interface TextFileDocumentPiece : NSObject
+@property (nonatomic, assign) TextFileDocumentPieceSource source;
+@property (nonatomic, assign) NSRange range;
+@end
+
+@implementation TextFileDocumentPiece
+
++ (instancetype)pieceWithSource:(TextFileDocumentPieceSource)source range:(NSRange)range
+{
+    TextFileDocumentPiece *piece = [self new];
+    piece.source = source;
+    piece.range = range;
+    return piece;
+}
+
+@end
+
+@interface TextFileDocument ()
+@property (nonatomic, assign, readwrite) NSStringEncoding encoding;
+@property (nonatomic, assign, readwrite) NSUInteger length;
+@property (nonatomic, assign, readwrite) NSUInteger firstModifiedIndex;
+@property (nonatomic, assign, readwrite) unsigned long long bytesWrittenByLastSave;
+@property (nonatomic, assign) NSUInteger byteOrderMarkLength;
+// The text as opened or last saved, and the number of bytes it takes in the file
+@property (nonatomic, strong) NSString *originalText;
+@property (nonatomic, assign) unsigned long long originalFileLength;
+// Every character inserted, appended in the order typed
+@property (nonatomic, strong) NSMutableString *addedText;
+@property (nonatomic, strong) NSMutableArray<TextFileDocumentPiece *> *pieces;
+@end
+
+@implementation TextFileDocument
+
++ (NSStringEncoding)encodingOfData:(NSData *)data byteOrderMarkLength:(NSUInteger *)byteOrderMarkLength
+{
+    const uint8_t *bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSStringEncoding encoding = NSUTF8StringEncoding;
+    NSUInteger markLength = 0;
+    
+    if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+    {
+        markLength = 3;
+    }
+    else if (length >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE)
+    {
+        encoding = NSUTF16LittleEndianStringEncoding;
+        markLength = 2;
+    }
+    else if (length >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF)
+    {
+        encoding = NSUTF16BigEndianStringEncoding;
+        markLength = 2;
+    }
+    else
+    {
+        // The prefix may end part way through a character, so allow for up to three of its bytes being cut off
+        NSUInteger prefixLength = MIN(length, kEncodingDetectionPrefixLength);
+        NSUInteger trimmableLength = (prefixLength < length) ? 3 : 0;
+        BOOL isUTF8 = NO;
+        for (NSUInteger trimmedLength = 0; trimmedLength <= trimmableLength && !isUTF8; trimmedLength++)
+        {
+            isUTF8 = [[NSString alloc] initWithBytesNoCopy:(void *)bytes length:prefixLength - trimmedLength encoding:NSUTF8StringEncoding freeWhenDone:NO] != nil;
+        }
+        
+        if (!isUTF8)
+        {
+            encoding = NSWindowsCP1252StringEncoding;
+        }
+    }
+    
+    if (byteOrderMarkLength)
+    {
+        *byteOrderMarkLength = markLength;
+    }
+    return encoding;
+}
+
+- (instancetype)initWithContentsOfFile:(NSString *)filePath error:(NSError **)error
+{
+    NSData *data = [NSData dataWithContentsOfFile:filePath options:NSDataReadingMappedIfSafe error:error];
+    if (!data)
+    {
+        return nil;
+    }
+    
+    NSUInteger byteOrderMarkLength = 0;
+    NSStringEncoding encoding = [TextFileDocument encodingOfData:data byteOrderMarkLength:&byteOrderMarkLength];
+    const uint8_t *textBytes = (const uint8_t *)data.bytes + byteOrderMarkLength;
+    NSUInteger textLength = data.length - byteOrderMarkLength;
+    
+    NSString *text = [[NSString alloc] initWithBytes:textBytes length:textLength encoding:encoding];
+    if (!text)
+    {
+        // Only the prefix was checked; Latin 1 can decode any bytes at all
+        encoding = NSISOLatin1StringEncoding;
+        text = [[NSString alloc] initWithBytes:textBytes length:textLength encoding:encoding];
+    }
+    
+    self = [super init];
+    if (self)
+    {
+        self.encoding = encoding;
+        self.byteOrderMarkLength = byteOrderMarkLength;
+        self.originalFileLength = data.length;
+        [self resetWithOriginalText:text];
+    }
+    return self;
+}
+
+#pragma mark - Public Methods
+
+- (NSString *)text
+{
+    if (self.firstModifiedIndex == NSNotFound)
+    {
+        return self.originalText;
+    }
+    
+    NSMutableString *text = [NSMutableString stringWithCapacity:self.length];
+    for (TextFileDocumentPiece *piece in self.pieces)
+    {
+        [text appendString:[[self sourceOfPiece:piece] substringWithRange:piece.range]];
+    }
+    return text;
+}
+
+- (BOOL)isModified
+{
+    if (self.firstModifiedIndex == NSNotFound)
+    {
+        return NO;
+    }
+    if (self.length != self.originalText.length)
+    {
+        return YES;
+    }
+    
+    // Edits may have put back what was there, so compare what follows the first of them
+    NSRange modifiedRange = NSMakeRange(self.firstModifiedIndex, self.length - self.firstModifiedIndex);
+    return ![[self.text substringWithRange:modifiedRange] isEqualToString:[self.originalText substringWithRange:modifiedRange]];
+}
+
+- (void)replaceCharactersInRange:(NSRange)range withString:(NSString *)string
+{
+    if (NSMaxRange(range) > self.length)
+    {
+        AlfrescoLogError(@"Edit of range %@ is beyond the end of the text", NSStringFromRange(range));
+        return;
+    }
+    if (range.length == 0 && string.length == 0)
+    {
+        return;
+    }
+    
+    NSUInteger pieceIndex = [self splitPiecesAtIndex:range.location];
+    NSUInteger endPieceIndex = [self splitPiecesAtIndex:NSMaxRange(range)];
+    [self.pieces removeObjectsInRange:NSMakeRange(pieceIndex, endPieceIndex - pieceIndex)];
+    
+    if (string.length > 0)
+    {
+        // Typing appends to the previous piece rather than adding a piece per keystroke
+        TextFileDocumentPiece *previousPiece = (pieceIndex > 0) ? self.pieces[pieceIndex - 1] : nil;
+        if (previousPiece.source == TextFileDocumentPieceSourceAdded && NSMaxRange(previousPiece.range) == self.addedText.length)
+        {
+            previousPiece.range = NSMakeRange(previousPiece.range.location, previousPiece.range.length + string.length);
+        }
+        else
+        {
+            TextFileDocumentPiece *piece = [TextFileDocumentPiece pieceWithSource:TextFileDocumentPieceSourceAdded range:NSMakeRange(self.addedText.length, string.length)];
+            [self.pieces insertObject:piece atIndex:pieceIndex];
+        }
+        [self.addedText appendString:string];
+    }
+    
+    self.length = self.length - range.length + string.length;
+    self.firstModifiedIndex = MIN(self.firstModifiedIndex, range.location);
+}
+
+- (void)synchroniseWithText:(NSString *)text
+{
+    NSString *currentText = self.text;
+    if ([currentText isEqualToString:text])
+    {
+        return;
+    }
+    
+    NSUInteger prefixLength = [self lengthOfCommonPrefixOfString:currentText andString:text];
+    NSUInteger maximumSuffixLength = MIN(currentText.length, text.length) - prefixLength;
+    NSUInteger suffixLength = [self lengthOfCommonSuffixOfString:currentText andString:text maximumLength:maximumSuffixLength];
+    
+    NSRange replacedRange = NSMakeRange(prefixLength, currentText.length - prefixLength - suffixLength);
+    NSString *replacement = [text substringWithRange:NSMakeRange(prefixLength, text.length - prefixLength - suffixLength)];
+    [self replaceCharactersInRange:replacedRange withString:replacement];
+}
+
+- (BOOL)saveToFile:(NSString *)filePath error:(NSError **)error
+{
+    NSString *text = self.text;
+    NSStringEncoding encoding = self.encoding;
+    NSUInteger byteOrderMarkLength = self.byteOrderMarkLength;
+    
+    // Only a file still holding the original text can be rewritten from part way through
+    NSDictionary *attributes = [[AlfrescoFileManager sharedManager] attributesOfItemAtPath:filePath error:nil];
+    BOOL holdsOriginalText = attributes && [attributes[kAlfrescoFileSize] unsignedLongLongValue] == self.originalFileLength;
+    NSUInteger firstModifiedIndex = holdsOriginalText ? MIN(self.firstModifiedIndex, text.length) : 0;
+    
+    // Start on a whole character; a surrogate pair or composed sequence may straddle the first edit
+    if (firstModifiedIndex < self.originalText.length)
+    {
+        firstModifiedIndex = [self.originalText rangeOfComposedCharacterSequenceAtIndex:firstModifiedIndex].location;
+    }
+    
+    if (![[text substringFromIndex:firstModifiedIndex] canBeConvertedToEncoding:encoding])
+    {
+        AlfrescoLogDebug(@"Edits can't be represented in the file's encoding, saving as UTF-8");
+        encoding = NSUTF8StringEncoding;
+        byteOrderMarkLength = 0;
+        firstModifiedIndex = 0;
+    }
+    
+    NSData *byteOrderMark = nil;
+    unsigned long long byteOffset = 0;
+    if (firstModifiedIndex > self.originalText.length / 2)
+    {
+        // Counting the bytes of whichever side of the edit is shorter
+        byteOffset = self.originalFileLength - [[self.originalText substringFromIndex:firstModifiedIndex] lengthOfBytesUsingEncoding:encoding];
+    }
+    else if (firstModifiedIndex > 0)
+    {
+        byteOffset = byteOrderMarkLength + [[self.originalText substringToIndex:firstModifiedIndex] lengthOfBytesUsingEncoding:encoding];
+    }
+    else if (byteOrderMarkLength > 0)
+    {
+        byteOrderMark = [self byteOrderMarkForEncoding:encoding];
+    }
+    
+    if (![[AlfrescoFileManager sharedManager] fileExistsAtPath:filePath])
+    {
+        [[NSFileManager defaultManager] createFileAtPath:filePath contents:nil attributes:nil];
+    }
+    
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForUpdatingAtPath:filePath];
+    if (!fileHandle)
+    {
+        if (error)
+        {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteUnknownError userInfo:@{NSFilePathErrorKey : filePath}];
+        }
+        return NO;
+    }
+    
+    unsigned long long bytesWritten = 0;
+    @try
+    {
+        [fileHandle truncateFileAtOffset:byteOffset];
+        if (byteOrderMark)
+        {
+            [fileHandle writeData:byteOrderMark];
+            bytesWritten += byteOrderMark.length;
+        }
+        
+        // Encoded a chunk at a time, so a large file never needs a second copy in memory
+        NSUInteger index = firstModifiedIndex;
+        while (index < text.length)
+        {
+            NSRange chunkRange = [text rangeOfComposedCharacterSequencesForRange:NSMakeRange(index, MIN(kSaveChunkLength, text.length - index))];
+            NSData *chunk = [[text substringWithRange:chunkRange] dataUsingEncoding:encoding];
+            [fileHandle writeData:chunk];
+            bytesWritten += chunk.length;
+            index = NSMaxRange(chunkRange);
+        }
+        [fileHandle closeFile];
+    }
+    @catch (NSException *exception)
+    {
+        AlfrescoLogError(@"Unable to save text to %@: %@", filePath, exception.reason);
+        if (error)
+        {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteUnknownError userInfo:@{NSFilePathErrorKey : filePath, NSLocalizedFailureReasonErrorKey : exception.reason ?: @""}];
+        }
+        return NO;
+    }
+    
+    self.bytesWrittenByLastSave = bytesWritten;
+    self.encoding = encoding;
+    self.byteOrderMarkLength = byteOrderMarkLength;
+    self.originalFileLength = byteOffset + bytesWritten;
+    [self resetWithOriginalText:text];
+    return YES;
+}
+
+#pragma mark - Private Methods
+
+- (void)resetWithOriginalText:(NSString *)text
+{
+    self.originalText = text;
+    self.length = text.length;
+    self.addedText = [NSMutableString string];
+    self.pieces = [NSMutableArray array];
+    if (text.length > 0)
+    {
+        [self.pieces addObject:[TextFileDocumentPiece pieceWithSource:TextFileDocumentPieceSourceOriginal range:NSMakeRange(0, text.length)]];
+    }
+    self.firstModifiedIndex = NSNotFound;
+}
+
+- (NSString *)sourceOfPiece:(TextFileDocumentPiece *)piece
+{
+    return (piece.source == TextFileDocumentPieceSourceOriginal) ? self.originalText : self.addedText;
+}
+
+// Splits the piece containing the index so that a piece starts there, returning that piece's index
+- (NSUInteger)splitPiecesAtIndex:(NSUInteger)index
+{
+    NSUInteger pieceStart = 0;
+    for (NSUInteger pieceIndex = 0; pieceIndex < self.pieces.count; pieceIndex++)
+    {
+        TextFileDocumentPiece *piece = self.pieces[pieceIndex];
+        if (index == pieceStart)
+        {
+            return pieceIndex;
+        }
+        if (index < pieceStart + piece.range.length)
+        {
+            NSUInteger splitLength = index - pieceStart;
+            TextFileDocumentPiece *secondPiece = [TextFileDocumentPiece pieceWithSource:piece.source range:NSMakeRange(piece.range.location + splitLength, piece.range.length - splitLength)];
+            piece.range = NSMakeRange(piece.range.location, splitLength);
+            [self.pieces insertObject:secondPiece atIndex:pieceIndex + 1];
+            return pieceIndex + 1;
+        }
+        pieceStart += piece.range.length;
+    }
+    return self.pieces.count;
+}
+
+- (NSUInteger)lengthOfCommonPrefixOfString:(NSString *)firstString andString:(NSString *)secondString
+{
+    unichar firstBuffer[kComparisonChunkLength];
+    unichar secondBuffer[kComparisonChunkLength];
+    NSUInteger maximumLength = MIN(firstString.length, secondString.length);
+    NSUInteger prefixLength = 0;
+    
+    while (prefixLength < maximumLength)
+    {
+        NSRange chunkRange = NSMakeRange(prefixLength, MIN(kComparisonChunkLength, maximumLength - prefixLength));
+        [firstString getCharacters:firstBuffer range:chunkRange];
+        [secondString getCharacters:secondBuffer range:chunkRange];
+        for (NSUInteger offset = 0; offset < chunkRange.length; offset++)
+        {
+            if (firstBuffer[offset] != secondBuffer[offset])
+            {
+                return prefixLength + offset;
+            }
+        }
+        prefixLength += chunkRange.length;
+    }
+    return prefixLength;
+}
+
+- (NSUInteger)lengthOfCommonSuffixOfString:(NSString *)firstString andString:(NSString *)secondString maximumLength:(NSUInteger)maximumLength
+{
+    unichar firstBuffer[kComparisonChunkLength];
+    unichar secondBuffer[kComparisonChunkLength];
+    NSUInteger suffixLength = 0;
+    
+    while (suffixLength < maximumLength)
+    {
+        NSUInteger chunkLength = MIN(kComparisonChunkLength, maximumLength - suffixLength);
+        [firstString getCharacters:firstBuffer range:NSMakeRange(firstString.length - suffixLength - chunkLength, chunkLength)];
+        [secondString getCharacters:secondBuffer range:NSMakeRange(secondString.length - suffixLength - chunkLength, chunkLength)];
+        for (NSUInteger offset = chunkLength; offset > 0; offset--)
+        {
+            if (firstBuffer[offset - 1] != secondBuffer[offset - 1])
+            {
+                return suffixLength + (chunkLength - offset);
+            }
+        }
+        suffixLength += chunkLength;
+    }
+    return suffixLength;
+}
+
+- (NSData *)byteOrderMarkForEncoding:(NSStringEncoding)encoding
+{
+    static const uint8_t utf8Mark[] = {0xEF, 0xBB, 0xBF};
+    static const uint8_t utf16LittleEndianMark[] = {0xFF, 0xFE};
+    static const uint8_t utf16BigEndianMark[] = {0xFE, 0xFF};
+    
+    switch (encoding)
+    {
+        case NSUTF8StringEncoding:
+            return [NSData dataWithBytes:utf8Mark length:sizeof(utf8Mark)];
+        case NSUTF16LittleEndianStringEncoding:
+            return [NSData dataWithBytes:utf16LittleEndianMark length:sizeof(utf16LittleEndianMark)];
+        case NSUTF16BigEndianStringEncoding:
+            return [NSData dataWithBytes:utf16BigEndianMark length:sizeof(utf16BigEndianMark)];
+        default:
+            return nil;
+    }
+}
+
+@end
@@ -23,6 +23,7 @@
 #import "RealmSyncManager.h"
 #import "ConnectivityManager.h"
 #import "AccountManager.h"
+#import "TextFileDocument.h"
 
 static NSString * const kTextFileMimeType = @"text/plain";
 
@@ -36,6 +37,7 @@ static NSString * const kTextFileMimeType = @"text/plain";
 @property (nonatomic, weak) id<UploadFormViewControllerDelegate> uploadFormViewControllerDelegate;
 @property (nonatomic, weak) UITextView *textView;
 @property (nonatomic, strong) NSString *temporaryFilePath;
+@property (nonatomic, strong) TextFileDocument *textDocument;
 @property (nonatomic, strong) UIBarButtonItem *cancelButton;
 @property (nonatomic, strong) UIBarButtonItem *nextButton;
 
@@ -111,15 +113,29 @@ static NSString * const kTextFileMimeType = @"text/plain";
     
     if (self.documentContentPath)
     {
-        NSError *error = nil;
-        NSString *fileContent = [[NSString alloc] initWithContentsOfFile:self.documentContentPath usedEncoding:NULL error:&error];
-        if (!error)
-        {
-            self.textView.text = fileContent;
-        }
+        // Large files take a while to open and copy, so keep that off the main thread and editing off until it's done
+        self.textView.editable = NO;
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            NSError *error = nil;
+            TextFileDocument *textDocument = [[TextFileDocument alloc] initWithContentsOfFile:self.documentContentPath error:&error];
+            if (!textDocument)
+            {
+                AlfrescoLogError(@"Unable to open file at path: %@ - %@", self.documentContentPath, error.localizedDescription);
+            }
+            [self createTemporaryFile];
+            
+            dispatch_async(dispatch_get_main_queue(), ^{
+                self.textDocument = textDocument;
+                self.textView.text = textDocument.text;
+                self.textView.editable = YES;
+                [self.textView becomeFirstResponder];
+            });
+        });
+    }
+    else
+    {
+        [self createTemporaryFile];
     }
-    
-    [self createTemporaryFile];
     
     [self setAccessibilityIdentifiers];
 }
@@ -165,6 +181,10 @@ static NSString * const kTextFileMimeType = @"text/plain";
         NSString *temporaryFilePath  = [self.documentContentPath stringByReplacingOccurrencesOfString:self.documentContentPath.lastPathComponent withString:self.editingDocument.name];
         
         NSError *temporaryFileError = nil;
+        if ([[AlfrescoFileManager sharedManager] fileExistsAtPath:temporaryFilePath])
+        {
+            [[AlfrescoFileManager sharedManager] removeItemAtPath:temporaryFilePath error:nil];
+        }
         [[AlfrescoFileManager sharedManager] copyItemAtPath:self.documentContentPath toPath:temporaryFilePath error:&temporaryFileError];
         
         if (temporaryFileError)
@@ -222,11 +242,10 @@ static NSString * const kTextFileMimeType = @"text/plain";
         //we check to see if we are in editing mode
         if((self.editingDocument) && (self.documentContentPath))
         {
-            NSError *error = nil;
-            NSString *fileContent = [[NSString alloc] initWithContentsOfFile:self.documentContentPath usedEncoding:NULL error:&error];
-            if(error == nil)
+            if (self.textDocument)
             {
-                shouldShowAlertView = !(self.textView.text.length == fileContent.length);
+                [self.textDocument synchroniseWithText:self.textView.text];
+                shouldShowAlertView = self.textDocument.isModified;
             }
         }
         else
@@ -267,78 +286,14 @@ static NSString * const kTextFileMimeType = @"text/plain";
 
 - (void)nextButtonPressed:(id)sender
 {
-    NSString *text = self.textView.text;
-    NSData *textData = [text dataUsingEncoding:NSUTF8StringEncoding];
-    AlfrescoContentFile *contentFile = [[AlfrescoContentFile alloc] initWithData:textData mimeType:kTextFileMimeType];
-    
     if (self.editingDocument)
     {
-        [text writeToFile:self.temporaryFilePath atomically:YES encoding:NSUTF8StringEncoding error:nil];
-        
-        RealmSyncManager *syncManager = [RealmSyncManager sharedManager];
-        BOOL isSyncDocument = [self.editingDocument isNodeInSyncList];
-        if (isSyncDocument)
-        {
-            NSString *syncContentPath = [[RealmSyncCore sharedSyncCore] contentPathForNode:self.editingDocument forAccountIdentifier:[AccountManager sharedManager].selectedAccount.accountIdentifier];;
-            [text writeToFile:syncContentPath atomically:YES encoding:NSUTF8StringEncoding error:nil];
-            
-            [syncManager retrySyncForDocument:self.editingDocument completionBlock:^{
-                RLMRealm *realm = [[RealmManager sharedManager] realmForCurrentThread];
-                AlfrescoDocument *document = (AlfrescoDocument *)([[RealmSyncCore sharedSyncCore] syncNodeInfoForObject:self.editingDocument ifNotExistsCreateNew:NO inRealm:realm].alfrescoNode);
-                [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoDocumentEditedNotification object:document];
-            }];
-            [self dismissViewControllerAnimated:YES completion:nil];
-        }
-        else
-        {
-            MBProgressHUD *progressHUD = [[MBProgressHUD alloc] initWithView:self.view];
-            progressHUD.mode = MBProgressHUDModeDeterminate;
-            [progressHUD showAnimated:YES];
-            
-            [self.documentFolderService updateContentOfDocument:self.editingDocument contentFile:contentFile completionBlock:^(AlfrescoDocument *document, NSError *error) {
-                [progressHUD hideAnimated:YES];
-                if (document)
-                {
-                    [self updateSourceFileFromTemporaryFile];
-                    [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoDocumentEditedNotification object:document];
-                    [self dismissViewControllerAnimated:YES completion:nil];
-                }
-                else
-                {
-                    void (^saveBlock)(void) = ^(){
-                        [[DownloadManager sharedManager] saveDocument:self.editingDocument contentPath:self.temporaryFilePath showOverrideAlert:false completionBlock:^(NSString *filePath) {
-                            [self dismissViewControllerAnimated:YES completion:^{
-                                displayInformationMessage([NSString stringWithFormat:NSLocalizedString(@"download.success-as.message", @"Download succeeded"), filePath.lastPathComponent]);
-                                [Notifier notifyWithAlfrescoError:error];
-                            }];
-                        }];
-                    };
-                    
-                    UIAlertController *alertController = [UIAlertController alertControllerWithTitle:NSLocalizedString(@"document.edit.failed.title", @"Edit Document Save Failed Title")
-                                                                                             message:NSLocalizedString(@"document.edit.savefailed.message", @"Edit Document Save Failed Message")
-                                                                                      preferredStyle:UIAlertControllerStyleAlert];
-                    UIAlertAction *cancelAction = [UIAlertAction actionWithTitle:NSLocalizedString(@"Cancel", @"Cancel")
-                                                                           style:UIAlertActionStyleCancel
-                                                                         handler:^(UIAlertAction * _Nonnull action) {
-                        [Notifier notifyWithAlfrescoError:error];
-                    }];
-                    [alertController addAction:cancelAction];
-                    UIAlertAction *saveAction = [UIAlertAction actionWithTitle:NSLocalizedString(@"document.edit.button.save", @"Save to Local Files")
-                                                                         style:UIAlertActionStyleDefault
-                                                                       handler:^(UIAlertAction * _Nonnull action) {
-                                                                           saveBlock();
-                                                                       }];
-                    [alertController addAction:saveAction];
-                    [self presentViewController:alertController animated:YES completion:nil];
-                }
-            } progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
-                // Update progress HUD
-                progressHUD.progress = (bytesTotal != 0) ? (float)bytesTransferred / (float)bytesTotal : 0;
-            }];
-        }
+        [self saveEditedDocument];
     }
     else
     {
+        NSData *textData = [self.textView.text dataUsingEncoding:NSUTF8StringEncoding];
+        AlfrescoContentFile *contentFile = [[AlfrescoContentFile alloc] initWithData:textData mimeType:kTextFileMimeType];
         UploadFormViewController *uploadFormController = [[UploadFormViewController alloc] initWithSession:self.session
                                                                                          uploadContentFile:contentFile
                                                                                                   inFolder:self.uploadDestinationFolder
@@ -348,6 +303,107 @@ static NSString * const kTextFileMimeType = @"text/plain";
     }
 }
 
+- (void)saveEditedDocument
+{
+    // Only what changed since the file was opened is written, in the file's own encoding
+    [self.textDocument synchroniseWithText:self.textView.text];
+    TextFileDocument *textDocument = self.textDocument;
+    NSString *text = textDocument ? nil : self.textView.text;
+    NSString *temporaryFilePath = self.temporaryFilePath;
+    BOOL isSyncDocument = [self.editingDocument isNodeInSyncList];
+    NSString *syncContentPath = isSyncDocument ? [[RealmSyncCore sharedSyncCore] contentPathForNode:self.editingDocument forAccountIdentifier:[AccountManager sharedManager].selectedAccount.accountIdentifier] : nil;
+    
+    // Cancelling now would dismiss the controller while the file is still being written
+    self.textView.editable = NO;
+    self.cancelButton.enabled = NO;
+    self.nextButton.enabled = NO;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSError *saveError = nil;
+        BOOL saved = textDocument ? [textDocument saveToFile:temporaryFilePath error:&saveError] : [text writeToFile:temporaryFilePath atomically:YES encoding:NSUTF8StringEncoding error:&saveError];
+        NSData *contentData = saved ? [NSData dataWithContentsOfFile:temporaryFilePath options:NSDataReadingMappedIfSafe error:&saveError] : nil;
+        if (contentData && syncContentPath)
+        {
+            [contentData writeToFile:syncContentPath options:NSDataWritingAtomic error:&saveError];
+        }
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            self.textView.editable = YES;
+            self.cancelButton.enabled = YES;
+            self.nextButton.enabled = YES;
+            if (contentData)
+            {
+                AlfrescoContentFile *contentFile = [[AlfrescoContentFile alloc] initWithData:contentData mimeType:kTextFileMimeType];
+                [self uploadEditedContentFile:contentFile isSyncDocument:isSyncDocument];
+            }
+            else
+            {
+                AlfrescoLogError(@"Unable to save file at path: %@ - %@", temporaryFilePath, saveError.localizedDescription);
+                [Notifier notifyWithAlfrescoError:saveError];
+            }
+        });
+    });
+}
+
+- (void)uploadEditedContentFile:(AlfrescoContentFile *)contentFile isSyncDocument:(BOOL)isSyncDocument
+{
+    if (isSyncDocument)
+    {
+        [[RealmSyncManager sharedManager] retrySyncForDocument:self.editingDocument completionBlock:^{
+            RLMRealm *realm = [[RealmManager sharedManager] realmForCurrentThread];
+            AlfrescoDocument *document = (AlfrescoDocument *)([[RealmSyncCore sharedSyncCore] syncNodeInfoForObject:self.editingDocument ifNotExistsCreateNew:NO inRealm:realm].alfrescoNode);
+            [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoDocumentEditedNotification object:document];
+        }];
+        [self dismissViewControllerAnimated:YES completion:nil];
+    }
+    else
+    {
+        MBProgressHUD *progressHUD = [[MBProgressHUD alloc] initWithView:self.view];
+        progressHUD.mode = MBProgressHUDModeDeterminate;
+        [progressHUD showAnimated:YES];
+        
+        [self.documentFolderService updateContentOfDocument:self.editingDocument contentFile:contentFile completionBlock:^(AlfrescoDocument *document, NSError *error) {
+            [progressHUD hideAnimated:YES];
+            if (document)
+            {
+                [self updateSourceFileFromTemporaryFile];
+                [[NSNotificationCenter defaultCenter] postNotificationName:kAlfrescoDocumentEditedNotification object:document];
+                [self dismissViewControllerAnimated:YES completion:nil];
+            }
+            else
+            {
+                void (^saveBlock)(void) = ^(){
+                    [[DownloadManager sharedManager] saveDocument:self.editingDocument contentPath:self.temporaryFilePath showOverrideAlert:false completionBlock:^(NSString *filePath) {
+                        [self dismissViewControllerAnimated:YES completion:^{
+                            displayInformationMessage([NSString stringWithFormat:NSLocalizedString(@"download.success-as.message", @"Download succeeded"), filePath.lastPathComponent]);
+                            [Notifier notifyWithAlfrescoError:error];
+                        }];
+                    }];
+                };
+                
+                UIAlertController *alertController = [UIAlertController alertControllerWithTitle:NSLocalizedString(@"document.edit.failed.title", @"Edit Document Save Failed Title")
+                                                                                         message:NSLocalizedString(@"document.edit.savefailed.message", @"Edit Document Save Failed Message")
+                                                                                  preferredStyle:UIAlertControllerStyleAlert];
+                UIAlertAction *cancelAction = [UIAlertAction actionWithTitle:NSLocalizedString(@"Cancel", @"Cancel")
+                                                                       style:UIAlertActionStyleCancel
+                                                                     handler:^(UIAlertAction * _Nonnull action) {
+                    [Notifier notifyWithAlfrescoError:error];
+                }];
+                [alertController addAction:cancelAction];
+                UIAlertAction *saveAction = [UIAlertAction actionWithTitle:NSLocalizedString(@"document.edit.button.save", @"Save to Local Files")
+                                                                     style:UIAlertActionStyleDefault
+                                                                   handler:^(UIAlertAction * _Nonnull action) {
+                                                                       saveBlock();
+                                                                   }];
+                [alertController addAction:saveAction];
+                [self presentViewController:alertController animated:YES completion:nil];
+            }
+        } progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+            // Update progress HUD
+            progressHUD.progress = (bytesTotal != 0) ? (float)bytesTransferred / (float)bytesTotal : 0;
+        }];
+    }
+}
+
 #pragma mark - Keyboard Managment
 
 - (void)keyboardWasShown:(NSNotification *)notification
@@ -411,6 +467,8 @@ static NSString * const kTextFileMimeType = @"text/plain";
         }];
     }
     
+    [self.textDocument replaceCharactersInRange:range withString:text];
+    
     return YES;
 }
 
@@ -39,6 +39,7 @@
     if (self)
     {
         self.document = document;
+        self.displaysRelativeDates = YES;
         [self createAlfrescoServicesWithSession:session];
     }
     return self;
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+@class TaskGroupItem;
+@class NodeCollectionChanges;
+
+typedef NS_ENUM(NSUInteger, TaskDataCoordinatorFilter)
+{
+    TaskDataCoordinatorFilterMyTasks = 0,
+    TaskDataCoordinatorFilterTasksIStarted
+};
+
+/// The changes to the tasks of the current filter, or nil if its feed failed
+typedef void (^TaskDataCoordinatorCompletionBlock)(NodeCollectionChanges *changes, NSError *error);
+
+/**
+ * The requests the coordinator makes, as provided by AlfrescoWorkflowService.
+ */
+@protocol TaskDataCoordinatorService <NSObject>
+- (AlfrescoRequest *)retrieveTasksWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock;
+- (AlfrescoRequest *)retrieveProcessesWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock;
+@end
+
+/**
+ * Loads the "My Tasks" and "Tasks I Started" feeds of an account into their task groups, and keeps the last results on disk
+ * so both can be shown straight away and switched between without a request.
+ *
+ * Refreshing fetches both feeds at the same time and reports once, when both have finished. Refreshed tasks replace the
+ * loaded ones in place, matched by identifier, so the table gets one set of row changes rather than a reload.
+ * Must be used from the main thread; files are written on a private queue.
+ */
+@interface TaskDataCoordinator : NSObject
+
+@property (nonatomic, strong, readonly) NSString *filePath;
+@property (nonatomic, assign) TaskDataCoordinatorFilter filter;
+/// The task group of the current filter
+@property (nonatomic, strong, readonly) TaskGroupItem *taskGroupItem;
+/// Whether the tasks of the current filter have been refreshed or read from disk
+@property (nonatomic, assign, readonly) BOOL hasLoadedTasks;
+@property (nonatomic, assign, readonly, getter=isRefreshing) BOOL refreshing;
+
++ (NSString *)filePathForAccountIdentifier:(NSString *)accountIdentifier networkIdentifier:(NSString *)networkIdentifier;
++ (void)removeStoresForAccountIdentifier:(NSString *)accountIdentifier;
++ (void)removeAllStores;
+
+/*
+ * The listing context sets the page size. A nil path keeps the results in memory only.
+ */
+- (instancetype)initWithService:(id<TaskDataCoordinatorService>)service
+                        myTasks:(TaskGroupItem *)myTasks
+                  tasksIStarted:(TaskGroupItem *)tasksIStarted
+                 listingContext:(AlfrescoListingContext *)listingContext
+                       filePath:(NSString *)filePath;
+
+- (TaskGroupItem *)taskGroupItemForFilter:(TaskDataCoordinatorFilter)filter;
+
+/*
+ * Fetches both feeds concurrently, as many tasks of each as are loaded. The completion block is called once both have
+ * finished. A refresh requested while one is running is made once that one finishes; every caller waiting for it shares
+ * it, and is given the same changes object.
+ */
+- (void)refreshWithCompletionBlock:(TaskDataCoordinatorCompletionBlock)completionBlock;
+
+/*
+ * Fetches the next page of the current filter, merging it into the tasks already loaded.
+ */
+- (void)loadMoreWithCompletionBlock:(TaskDataCoordinatorCompletionBlock)completionBlock;
+
+@end
@@ -0,0 +1,330 @@
+/*******************************************************************************
+ * Copyright (C) 2005-2020 Alfresco Software Limited.
+ * 
+ * This file is part of the Alfresco Mobile iOS App.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *  
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#import "TaskDataCoordinator.h"
+#import "AccountArchiveFolder.h"
+#import "TaskGroupItem.h"
+#import "NodeCollection.h"
+
+static NSInteger const kTaskDataCoordinatorVersion = 1;
+
+static NSString * const kTaskDataCoordinatorVersionKey = @"version";
+static NSString * const kTaskDataCoordinatorFiltersKey = @"filters";
+static NSString * const kTaskDataCoordinatorTasksKey = @"tasks";
+static NSString * const kTaskDataCoordinatorHasMoreItemsKey = @"hasMoreItems";
+static NSString * const kTaskDataCoordinatorRepositoryStoreName = @"repository";
+
+/*
+ * Whether a task or process matched by identifier shows differently. Processes have the same properties as tasks, as far as the cells are concerned.
+ */
+static BOOL TaskDataCoordinatorItemsDiffer(AlfrescoWorkflowTask *oldItem, AlfrescoWorkflowTask *newItem)
+{
+    BOOL sameSummary = (oldItem.summary == newItem.summary) || [oldItem.summary isEqualToString:newItem.summary];
+    BOOL sameName = (oldItem.name == newItem.name) || [oldItem.name isEqualToString:newItem.name];
+    BOOL samePriority = (oldItem.priority == newItem.priority) || [oldItem.priority isEqualToNumber:newItem.priority];
+    BOOL sameDueDate = (oldItem.dueAt == newItem.dueAt) || [oldItem.dueAt isEqualToDate:newItem.dueAt];
+    return !(sameSummary && sameName && samePriority && sameDueDate);
+}
+
+@interface AlfrescoWorkflowService (TaskDataCoordinator) <TaskDataCoordinatorService>
+@end
+
+@implementation AlfrescoWorkflowService (TaskDataCoordinator)
+@end
+
+@interface TaskDataCoordinator ()
+
+@property (nonatomic, strong, readwrite) NSString *filePath;
+@property (nonatomic, assign, readwrite, getter=isRefreshing) BOOL refreshing;
+@property (nonatomic, strong) id<TaskDataCoordinatorService> service;
+@property (nonatomic, strong) AlfrescoListingContext *listingContext;
+// Indexed by filter
+@property (nonatomic, strong) NSArray<TaskGroupItem *> *taskGroupItems;
+@property (nonatomic, strong) NSMutableIndexSet *loadedFilters;
+// Callers waiting for the next refresh, which is the pending one while a refresh is running
+@property (nonatomic, strong) NSMutableArray<TaskDataCoordinatorCompletionBlock> *refreshCompletionBlocks;
+@property (nonatomic, assign) BOOL refreshPending;
+
+@end
+
+@implementation TaskDataCoordinator
+
++ (AccountArchiveFolder *)archiveFolder
+{
+    static dispatch_once_t predicate = 0;
+    __strong static id sharedObject = nil;
+    dispatch_once(&predicate, ^{
+        sharedObject = [[AccountArchiveFolder alloc] initWithFolderPath:[[AlfrescoFileManager sharedManager] tasksFolderPath] archiveDescription:@"tasks"];
+    });
+    return sharedObject;
+}
+
++ (NSString *)filePathForAccountIdentifier:(NSString *)accountIdentifier networkIdentifier:(NSString *)networkIdentifier
+{
+    return [[self archiveFolder] filePathForAccountIdentifier:accountIdentifier archiveName:networkIdentifier ?: kTaskDataCoordinatorRepositoryStoreName];
+}
+
++ (void)removeStoresForAccountIdentifier:(NSString *)accountIdentifier
+{
+    [[self archiveFolder] removeArchivesForAccountIdentifier:accountIdentifier];
+}
+
++ (void)removeAllStores
+{
+    [[self archiveFolder] removeAllArchives];
+}
+
+- (instancetype)initWithService:(id<TaskDataCoordinatorService>)service
+                        myTasks:(TaskGroupItem *)myTasks
+                  tasksIStarted:(TaskGroupItem *)tasksIStarted
+                 listingContext:(AlfrescoListingContext *)listingContext
+                       filePath:(NSString *)filePath
+{
+    self = [super init];
+    if (self)
+    {
+        self.service = service;
+        self.taskGroupItems = @[myTasks, tasksIStarted];
+        self.listingContext = listingContext ?: [[AlfrescoListingContext alloc] init];
+        self.filePath = filePath;
+        self.filter = TaskDataCoordinatorFilterMyTasks;
+        self.loadedFilters = [NSMutableIndexSet indexSet];
+        self.refreshCompletionBlocks = [NSMutableArray array];
+        
+        // Read synchronously, as the point is to have something to show the moment the tasks are opened
+        if (filePath)
+        {
+            [self loadTasks];
+        }
+    }
+    return self;
+}
+
+#pragma mark - Public Functions
+
+- (TaskGroupItem *)taskGroupItemForFilter:(TaskDataCoordinatorFilter)filter
+{
+    return self.taskGroupItems[filter];
+}
+
+- (TaskGroupItem *)taskGroupItem
+{
+    return [self taskGroupItemForFilter:self.filter];
+}
+
+- (BOOL)hasLoadedTasks
+{
+    return [self.loadedFilters containsIndex:self.filter];
+}
+
+- (void)refreshWithCompletionBlock:(TaskDataCoordinatorCompletionBlock)completionBlock
+{
+    if (completionBlock)
+    {
+        [self.refreshCompletionBlocks addObject:[completionBlock copy]];
+    }
+    
+    // The running refresh may have read the feeds before whatever prompted this one, so another follows it
+    if (self.isRefreshing)
+    {
+        self.refreshPending = YES;
+        return;
+    }
+    [self startRefresh];
+}
+
+- (void)loadMoreWithCompletionBlock:(TaskDataCoordinatorCompletionBlock)completionBlock
+{
+    TaskDataCoordinatorFilter filter = self.filter;
+    TaskGroupItem *taskGroupItem = self.taskGroupItem;
+    int skipCount = self.listingContext.skipCount + (int)taskGroupItem.numberOfTasksBeforeFiltering;
+    
+    [self retrieveFeedForFilter:filter maxItems:self.listingContext.maxItems skipCount:skipCount completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+        NSArray *previousTasks = [self.taskGroupItem.tasksAfterFiltering copy];
+        
+        // A refresh finishing in the meantime replaces the tasks, and the page may no longer follow them
+        BOOL pageFollowsTasks = (skipCount == self.listingContext.skipCount + (int)taskGroupItem.numberOfTasksBeforeFiltering);
+        if (pagingResult && pageFollowsTasks)
+        {
+            [taskGroupItem addAndApplyFilteringToTasks:pagingResult.objects];
+            taskGroupItem.hasMoreItems = pagingResult.hasMoreItems && pagingResult.objects.count;
+            [self saveTasks];
+        }
+        
+        if (completionBlock)
+        {
+            completionBlock(pagingResult ? [self changesFromTasks:previousTasks] : nil, error);
+        }
+    }];
+}
+
+#pragma mark - Private Functions
+
+- (void)startRefresh
+{
+    NSArray *completionBlocks = [self.refreshCompletionBlocks copy];
+    [self.refreshCompletionBlocks removeAllObjects];
+    self.refreshPending = NO;
+    self.refreshing = YES;
+    
+    NSMutableDictionary<NSNumber *, AlfrescoPagingResult *> *pagingResults = [NSMutableDictionary dictionary];
+    NSMutableDictionary<NSNumber *, NSError *> *errors = [NSMutableDictionary dictionary];
+    dispatch_group_t feedsGroup = dispatch_group_create();
+    
+    for (NSNumber *filter in @[@(TaskDataCoordinatorFilterMyTasks), @(TaskDataCoordinatorFilterTasksIStarted)])
+    {
+        // As many as are loaded, so that tasks further down the list don't disappear
+        TaskGroupItem *taskGroupItem = [self taskGroupItemForFilter:filter.unsignedIntegerValue];
+        int maxItems = MAX(self.listingContext.maxItems, (int)taskGroupItem.numberOfTasksBeforeFiltering);
+        
+        dispatch_group_enter(feedsGroup);
+        [self retrieveFeedForFilter:filter.unsignedIntegerValue maxItems:maxItems skipCount:self.listingContext.skipCount completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
+            if (pagingResult)
+            {
+                pagingResults[filter] = pagingResult;
+            }
+            else if (error)
+            {
+                errors[filter] = error;
+            }
+            dispatch_group_leave(feedsGroup);
+        }];
+    }
+    
+    dispatch_group_notify(feedsGroup, dispatch_get_main_queue(), ^{
+        NSArray *previousTasks = [self.taskGroupItem.tasksAfterFiltering copy];
+        [pagingResults enumerateKeysAndObjectsUsingBlock:^(NSNumber *filter, AlfrescoPagingResult *pagingResult, BOOL *stop) {
+            TaskGroupItem *taskGroupItem = [self taskGroupItemForFilter:filter.unsignedIntegerValue];
+            [taskGroupItem clearAllTasks];
+            [taskGroupItem addAndApplyFilteringToTasks:pagingResult.objects];
+            //There're some cases in older versions of Alfresco when the server sends an incorrect hasMoreItems value. In order to prevent an infinite loop of fetching new pages, we test if the current pagingResults contains any objects. See https://issues.alfresco.com/jira/browse/MNT-13567
+            taskGroupItem.hasMoreItems = pagingResult.hasMoreItems && pagingResult.objects.count;
+            [self.loadedFilters addIndex:filter.unsignedIntegerValue];
+        }];
+        
+        if (pagingResults.count > 0)
+        {
+            [self saveTasks];
+        }
+        NodeCollectionChanges *changes = pagingResults[@(self.filter)] ? [self changesFromTasks:previousTasks] : nil;
+        
+        if (self.refreshPending)
+        {
+            [self startRefresh];
+        }
+        else
+        {
+            self.refreshing = NO;
+        }
+        
+        for (TaskDataCoordinatorCompletionBlock refreshCompletionBlock in completionBlocks)
+        {
+            refreshCompletionBlock(changes, errors[@(self.filter)]);
+        }
+    });
+}
+
+- (AlfrescoRequest *)retrieveFeedForFilter:(TaskDataCoordinatorFilter)filter maxItems:(int)maxItems skipCount:(int)skipCount completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+{
+    AlfrescoListingContext *listingContext = self.listingContext;
+    
+    if (filter == TaskDataCoordinatorFilterMyTasks)
+    {
+        AlfrescoListingContext *tasksListingContext = [[AlfrescoListingContext alloc] initWithMaxItems:maxItems
+                                                                                             skipCount:skipCount
+                                                                                          sortProperty:listingContext.sortProperty
+                                                                                         sortAscending:listingContext.sortAscending
+                                                                                         listingFilter:listingContext.listingFilter];
+        return [self.service retrieveTasksWithListingContext:tasksListingContext completionBlock:completionBlock];
+    }
+    
+    // create a new listing context so we can filter the processes
+    AlfrescoListingFilter *listingFilter = [[AlfrescoListingFilter alloc] initWithFilter:kAlfrescoFilterByWorkflowStatus value:kAlfrescoFilterValueWorkflowStatusActive];
+    AlfrescoListingContext *processesListingContext = [[AlfrescoListingContext alloc] initWithMaxItems:maxItems
+                                                                                             skipCount:skipCount
+                                                                                          sortProperty:listingContext.sortProperty
+                                                                                         sortAscending:listingContext.sortAscending
+                                                                                         listingFilter:listingFilter];
+    return [self.service retrieveProcessesWithListingContext:processesListingContext completionBlock:completionBlock];
+}
+
+- (NodeCollectionChanges *)changesFromTasks:(NSArray *)previousTasks
+{
+    return [NodeCollectionChanges changesFromNodes:previousTasks toNodes:self.taskGroupItem.tasksAfterFiltering differenceBlock:^BOOL(id oldTask, id newTask) {
+        return TaskDataCoordinatorItemsDiffer(oldTask, newTask);
+    }];
+}
+
+#pragma mark - Persistence
+
+- (void)loadTasks
+{
+    NSData *data = [[AlfrescoFileManager sharedManager] dataWithContentsOfURL:[NSURL fileURLWithPath:self.filePath]];
+    if (!data)
+    {
+        return;
+    }
+    
+    NSDictionary *archive = nil;
+    @try
+    {
+        NSSet *classes = [NSSet setWithObjects:[NSDictionary class], [NSArray class], [NSNumber class], [NSString class], [NSDate class], [AlfrescoWorkflowTask class], [AlfrescoWorkflowProcess class], nil];
+        archive = [NSKeyedUnarchiver unarchivedObjectOfClasses:classes fromData:data error:nil];
+    }
+    @catch (NSException *exception)
+    {
+        AlfrescoLogError(@"Unable to read the stored tasks: %@", exception.reason);
+    }
+    
+    if (![archive isKindOfClass:[NSDictionary class]] || [archive[kTaskDataCoordinatorVersionKey] integerValue] != kTaskDataCoordinatorVersion)
+    {
+        return;
+    }
+    
+    NSArray *storedFilters = archive[kTaskDataCoordinatorFiltersKey];
+    [storedFilters enumerateObjectsUsingBlock:^(NSDictionary *storedFilter, NSUInteger filter, BOOL *stop) {
+        if (filter < self.taskGroupItems.count)
+        {
+            TaskGroupItem *taskGroupItem = [self taskGroupItemForFilter:filter];
+            [taskGroupItem clearAllTasks];
+            [taskGroupItem addAndApplyFilteringToTasks:storedFilter[kTaskDataCoordinatorTasksKey]];
+            taskGroupItem.hasMoreItems = [storedFilter[kTaskDataCoordinatorHasMoreItemsKey] boolValue];
+            [self.loadedFilters addIndex:filter];
+        }
+    }];
+}
+
+- (void)saveTasks
+{
+    if (!self.filePath)
+    {
+        return;
+    }
+    
+    NSMutableArray *storedFilters = [NSMutableArray arrayWithCapacity:self.taskGroupItems.count];
+    for (TaskGroupItem *taskGroupItem in self.taskGroupItems)
+    {
+        [storedFilters addObject:@{kTaskDataCoordinatorTasksKey : [taskGroupItem.tasksBeforeFiltering copy],
+                                   kTaskDataCoordinatorHasMoreItemsKey : @(taskGroupItem.hasMoreItems)}];
+    }
+    NSDictionary *archive = @{kTaskDataCoordinatorVersionKey : @(kTaskDataCoordinatorVersion),
+                              kTaskDataCoordinatorFiltersKey : storedFilters};
+    [[[self class] archiveFolder] saveArchiveWithRootObject:archive toFilePath:self.filePath];
+}
+
+@end
@@ -37,25 +37,30 @@
 - (void)addAndApplyFilteringToTasks:(NSArray *)tasks;
 {
     [self.tasksBeforeFiltering addObjectsFromArray:tasks];
-
-    NSArray *filteredTasks = [self.tasksBeforeFiltering filteredArrayUsingPredicate:self.filteringPredicate];
-    
-    // Primary sort: priority
-    NSSortDescriptor *prioritySortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"priority" ascending:YES];
-    
-    // Seconday sort: due date
-    NSSortDescriptor *dueDateSortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"dueAt" ascending:NO comparator:^NSComparisonResult(NSDate *obj1, NSDate *obj2) {
-        // Note reversed logic here along with "ascending:NO" to get nil dates sorted to the bottom
-        return [obj2 compare:obj1];
-    }];
     
-    self.tasksAfterFiltering = [[filteredTasks sortedArrayUsingDescriptors:@[prioritySortDescriptor, dueDateSortDescriptor]] mutableCopy];
+    // Only the new page is filtered and sorted; it is then merged into the tasks already sorted
+    NSArray *filteredTasks = [tasks filteredArrayUsingPredicate:self.filteringPredicate];
+    NSArray *sortedTasks = [filteredTasks sortedArrayWithOptions:NSSortStable usingComparator:[TaskGroupItem taskComparator]];
+    [self mergeSortedTasks:sortedTasks];
 }
 
 - (void)removeTasks:(NSArray *)tasks
 {
-    [self.tasksBeforeFiltering removeObjectsInArray:tasks];
-    [self.tasksAfterFiltering removeObjectsInArray:tasks];
+    // Tasks are matched by identifier, so a refreshed copy of a task removes it too
+    NSMutableSet *identifiers = [NSMutableSet setWithCapacity:tasks.count];
+    for (AlfrescoWorkflowTask *task in tasks)
+    {
+        if (task.identifier)
+        {
+            [identifiers addObject:task.identifier];
+        }
+    }
+    
+    BOOL (^isRemovedTask)(AlfrescoWorkflowTask *, NSUInteger, BOOL *) = ^BOOL(AlfrescoWorkflowTask *task, NSUInteger index, BOOL *stop) {
+        return [identifiers containsObject:task.identifier];
+    };
+    [self.tasksBeforeFiltering removeObjectsAtIndexes:[self.tasksBeforeFiltering indexesOfObjectsPassingTest:isRemovedTask]];
+    [self.tasksAfterFiltering removeObjectsAtIndexes:[self.tasksAfterFiltering indexesOfObjectsPassingTest:isRemovedTask]];
 }
 
 - (BOOL)hasDisplayableTasks
@@ -79,4 +84,84 @@
     [self.tasksAfterFiltering removeAllObjects];
 }
 
+#pragma mark - Private Functions
+
++ (NSComparator)taskComparator
+{
+    static NSComparator comparator = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        comparator = ^NSComparisonResult(AlfrescoWorkflowTask *task1, AlfrescoWorkflowTask *task2) {
+            // Primary sort: priority
+            if (task1.priority != task2.priority)
+            {
+                if (!task1.priority || !task2.priority)
+                {
+                    return task1.priority ? NSOrderedDescending : NSOrderedAscending;
+                }
+                NSComparisonResult priorityResult = [task1.priority compare:task2.priority];
+                if (priorityResult != NSOrderedSame)
+                {
+                    return priorityResult;
+                }
+            }
+            
+            // Secondary sort: due date, earliest first, with nil dates sorted to the bottom
+            if (task1.dueAt && task2.dueAt)
+            {
+                return [task1.dueAt compare:task2.dueAt];
+            }
+            if (task1.dueAt || task2.dueAt)
+            {
+                return task1.dueAt ? NSOrderedAscending : NSOrderedDescending;
+            }
+            return NSOrderedSame;
+        };
+    });
+    return comparator;
+}
+
+- (void)mergeSortedTasks:(NSArray *)sortedTasks
+{
+    if (sortedTasks.count == 0)
+    {
+        return;
+    }
+    
+    NSComparator comparator = [TaskGroupItem taskComparator];
+    NSMutableArray *existingTasks = self.tasksAfterFiltering;
+    
+    // Pages usually arrive in order, in which case the new tasks simply follow the existing ones
+    if (existingTasks.count == 0 || comparator(existingTasks.lastObject, sortedTasks.firstObject) != NSOrderedDescending)
+    {
+        [existingTasks addObjectsFromArray:sortedTasks];
+        return;
+    }
+    
+    // Tasks already listed stay ahead of new tasks that sort the same, as they would in a stable sort of all the tasks
+    NSUInteger mergeStartIndex = [existingTasks indexOfObject:sortedTasks.firstObject
+                                                inSortedRange:NSMakeRange(0, existingTasks.count)
+                                                      options:NSBinarySearchingInsertionIndex | NSBinarySearchingLastEqual
+                                              usingComparator:comparator];
+    
+    NSMutableArray *mergedTasks = [NSMutableArray arrayWithCapacity:existingTasks.count - mergeStartIndex + sortedTasks.count];
+    NSUInteger existingIndex = mergeStartIndex;
+    NSUInteger newIndex = 0;
+    while (existingIndex < existingTasks.count && newIndex < sortedTasks.count)
+    {
+        if (comparator(existingTasks[existingIndex], sortedTasks[newIndex]) != NSOrderedDescending)
+        {
+            [mergedTasks addObject:existingTasks[existingIndex++]];
+        }
+        else
+        {
+            [mergedTasks addObject:sortedTasks[newIndex++]];
+        }
+    }
+    [mergedTasks addObjectsFromArray:[existingTasks subarrayWithRange:NSMakeRange(existingIndex, existingTasks.count - existingIndex)]];
+    [mergedTasks addObjectsFromArray:[sortedTasks subarrayWithRange:NSMakeRange(newIndex, sortedTasks.count - newIndex)]];
+    
+    [existingTasks replaceObjectsInRange:NSMakeRange(mergeStartIndex, existingTasks.count - mergeStartIndex) withObjectsFromArray:mergedTasks];
+}
+
 @end
@@ -21,6 +21,8 @@
 #import "AccountManager.h"
 #import "TasksCell.h"
 #import "TaskGroupItem.h"
+#import "TaskDataCoordinator.h"
+#import "NodeCollection.h"
 #import "TaskDetailsViewController.h"
 #import "UniversalDevice.h"
 #import "TaskTypeViewController.h"
@@ -42,14 +44,14 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
 
 @interface TaskViewController () <UIActionSheetDelegate>
 
-@property (nonatomic, strong) AlfrescoWorkflowService *workflowService;
+@property (nonatomic, strong) TaskDataCoordinator *taskDataCoordinator;
+// The changes or error of the last refresh shown; every caller sharing a refresh is given the same one
+@property (nonatomic, strong) id lastRefreshResult;
 @property (nonatomic, strong) NSDateFormatter *dateFormatter;
 @property (nonatomic, strong) NSPredicate *supportedTasksPredicate;
 @property (nonatomic, strong) NSPredicate *adhocProcessTypePredicate;
 @property (nonatomic, strong) NSPredicate *inviteProcessTypePredicate;
 @property (nonatomic, assign, getter=isDisplayingMyTasks) BOOL displayingMyTasks;
-@property (nonatomic, strong) TaskGroupItem *myTasks;
-@property (nonatomic, strong) TaskGroupItem *tasksIStarted;
 @property (nonatomic, weak) UIBarButtonItem *filterButton;
 
 @end
@@ -70,12 +72,12 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
         self.dateFormatter = [[NSDateFormatter alloc] init];
         [self.dateFormatter setDateFormat:kDateFormat];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(taskListDidChange:) name:kAlfrescoWorkflowTaskListDidChangeNotification object:nil];
-        [self createWorkflowServicesWithSession:session];
         
         if (listingContext)
         {
             self.defaultListingContext = listingContext;
         }
+        [self createWorkflowServicesWithSession:session];
     }
     return self;
 }
@@ -107,11 +109,9 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
     
     if (self.session)
     {
-        [self showHUD];
-        [self loadDataWithListingContext:nil forceRefresh:YES completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-            [self hideHUD];
-            [self reloadTableViewWithPagingResult:pagingResult error:error];
-        }];
+        // Tasks stored from last time are shown while they are refreshed
+        [self showTasksOfCurrentFilter];
+        [self reloadDataForAllTaskFilters];
     }
 }
 
@@ -145,18 +145,12 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
     if (self.session)
     {
         [self createWorkflowServicesWithSession:session];
-        [self.myTasks clearAllTasks];
-        [self.tasksIStarted clearAllTasks];
         
         if ([self shouldRefresh])
         {
             self.displayingMyTasks = YES;
-            
-            [self loadDataWithListingContext:nil forceRefresh:YES completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-                [self hideHUD];
-                [self hidePullToRefreshView];
-                [self reloadTableViewWithPagingResult:pagingResult error:error];
-            }];
+            [self showTasksOfCurrentFilter];
+            [self reloadDataForAllTaskFilters];
         }
     }
 }
@@ -168,46 +162,44 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
 
 - (void)reloadDataForAllTaskFilters
 {
-    // reload tasks and workflows following completion
-    __weak typeof(self) weakSelf = self;
-
-    [self showHUD];
-    [self loadTasksWithListingContext:self.defaultListingContext completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-        [weakSelf hideHUD];
-        if (pagingResult)
+    // Both feeds are fetched together and the table updated once, when both have finished
+    TaskDataCoordinator *taskDataCoordinator = self.taskDataCoordinator;
+    BOOL showsHUD = !taskDataCoordinator.isRefreshing && !taskDataCoordinator.hasLoadedTasks;
+    
+    if (showsHUD)
+    {
+        [self showHUD];
+    }
+    [taskDataCoordinator refreshWithCompletionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+        if (showsHUD)
         {
-            [weakSelf.myTasks clearAllTasks];
-            [weakSelf.myTasks addAndApplyFilteringToTasks:pagingResult.objects];
-            
-            // currently being displayed, refresh the tableview.
-            if (weakSelf.isDisplayingMyTasks)
-            {
-                weakSelf.tableViewData = [weakSelf.myTasks.tasksAfterFiltering mutableCopy];
-                [weakSelf.tableView reloadData];
-            }
+            [self hideHUD];
         }
-    }];
-    
-    [self loadWorkflowProcessesWithListingContext:self.defaultListingContext completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-        [weakSelf hideHUD];
-        if (pagingResult)
+        [self hidePullToRefreshView];
+        
+        // A refresh for a previous session no longer applies, and a refresh shared with another caller is shown once
+        id refreshResult = changes ?: error;
+        if (taskDataCoordinator != self.taskDataCoordinator || !refreshResult || refreshResult == self.lastRefreshResult)
         {
-            [weakSelf.tasksIStarted clearAllTasks];
-            [weakSelf.tasksIStarted addAndApplyFilteringToTasks:pagingResult.objects];
-            
-            // currently being displayed, refresh the tableview.
-            if (!weakSelf.isDisplayingMyTasks)
-            {
-                weakSelf.tableViewData = [weakSelf.tasksIStarted.tasksAfterFiltering mutableCopy];
-                [weakSelf.tableView reloadData];
-            }
+            return;
+        }
+        self.lastRefreshResult = refreshResult;
+        
+        if (changes)
+        {
+            [self updateTableViewWithChanges:changes];
+        }
+        else
+        {
+            displayErrorMessage([ErrorDescriptions descriptionForError:error]);
+            [Notifier notifyWithAlfrescoError:error];
         }
     }];
 }
 
 - (void)createWorkflowServicesWithSession:(id<AlfrescoSession>)session
 {
-    self.workflowService = [[AlfrescoWorkflowService alloc] initWithSession:session];
+    AlfrescoWorkflowService *workflowService = [[AlfrescoWorkflowService alloc] initWithSession:session];
 
     if (!self.supportedTasksPredicate)
     {
@@ -245,75 +237,75 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
     NSPredicate *initiatorSubpredicate = [NSPredicate predicateWithFormat:kInitiatorWorkflowsPredicateFormat, self.session.personIdentifier];
     NSPredicate *tasksIStartedPredicate = [NSCompoundPredicate andPredicateWithSubpredicates:@[self.supportedTasksPredicate, initiatorSubpredicate]];
 
-    self.myTasks = [[TaskGroupItem alloc] initWithTitle:NSLocalizedString(@"tasks.title.mytasks", @"My Tasks Title") filteringPredicate:self.supportedTasksPredicate];
-    self.tasksIStarted = [[TaskGroupItem alloc] initWithTitle:NSLocalizedString(@"tasks.title.taskistarted", @"Tasks I Started Title") filteringPredicate:tasksIStartedPredicate];
+    TaskGroupItem *myTasks = [[TaskGroupItem alloc] initWithTitle:NSLocalizedString(@"tasks.title.mytasks", @"My Tasks Title") filteringPredicate:self.supportedTasksPredicate];
+    TaskGroupItem *tasksIStarted = [[TaskGroupItem alloc] initWithTitle:NSLocalizedString(@"tasks.title.taskistarted", @"Tasks I Started Title") filteringPredicate:tasksIStartedPredicate];
+    
+    UserAccount *selectedAccount = [AccountManager sharedManager].selectedAccount;
+    NSString *filePath = selectedAccount ? [TaskDataCoordinator filePathForAccountIdentifier:selectedAccount.accountIdentifier networkIdentifier:selectedAccount.selectedNetworkId] : nil;
+    self.taskDataCoordinator = [[TaskDataCoordinator alloc] initWithService:workflowService myTasks:myTasks tasksIStarted:tasksIStarted listingContext:self.defaultListingContext filePath:filePath];
+    self.taskDataCoordinator.filter = self.isDisplayingMyTasks ? TaskDataCoordinatorFilterMyTasks : TaskDataCoordinatorFilterTasksIStarted;
+}
+
+- (void)setDisplayingMyTasks:(BOOL)displayingMyTasks
+{
+    _displayingMyTasks = displayingMyTasks;
+    self.taskDataCoordinator.filter = displayingMyTasks ? TaskDataCoordinatorFilterMyTasks : TaskDataCoordinatorFilterTasksIStarted;
 }
 
 - (TaskGroupItem *)taskGroupItem
 {
-    return self.isDisplayingMyTasks ? self.myTasks : self.tasksIStarted;
+    return self.taskDataCoordinator.taskGroupItem;
+}
+
+- (void)showTasksOfCurrentFilter
+{
+    TaskGroupItem *taskGroupItem = [self taskGroupItem];
+    self.title = taskGroupItem.title;
+    self.tableViewData = [taskGroupItem.tasksAfterFiltering mutableCopy];
+    [self.tableView reloadData];
 }
 
-- (void)loadDataWithListingContext:(AlfrescoListingContext *)listingContext forceRefresh:(BOOL)forceRefresh completionBlock:(AlfrescoPagingResultCompletionBlock)completionBlock
+- (void)switchToTasksOfFilterDisplayingMyTasks:(BOOL)displayingMyTasks
 {
-    TaskGroupItem *groupToSwitchTo = [self taskGroupItem];
-    self.title = groupToSwitchTo.title;
+    self.displayingMyTasks = displayingMyTasks;
+    [self showTasksOfCurrentFilter];
     
-    if (groupToSwitchTo.hasDisplayableTasks == NO || forceRefresh || groupToSwitchTo.hasMoreItems)
-    {
-        AlfrescoPagingResultCompletionBlock myCompletionBlock = ^(AlfrescoPagingResult *pagingResult, NSError *error) {
-            [self hideHUD];
-            if (completionBlock)
-            {
-                completionBlock(pagingResult, error);
-            }
-        };
-        
-        if (forceRefresh)
-        {
-            listingContext = nil;
-            [groupToSwitchTo clearAllTasks];
-        }
-        
-        [self showHUD];
-        
-        if (self.isDisplayingMyTasks)
-        {
-            [self loadTasksWithListingContext:listingContext completionBlock:myCompletionBlock];
-        }
-        else
-        {
-            [self loadWorkflowProcessesWithListingContext:listingContext completionBlock:myCompletionBlock];
-        }
-    }
-    else
+    // Both filters are loaded together, so after the first load there is nothing to wait for
+    if (!self.taskDataCoordinator.hasLoadedTasks)
     {
-        self.tableViewData = [groupToSwitchTo.tasksAfterFiltering mutableCopy];
-        [self.tableView reloadData];
+        [self reloadDataForAllTaskFilters];
     }
+    [self trackScreenName];
 }
 
-- (void)loadWorkflowProcessesWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(void (^)(AlfrescoPagingResult *pagingResult, NSError *error))completionBlock
+- (void)updateTableViewWithChanges:(NodeCollectionChanges *)changes
 {
-    if (!listingContext)
+    NSArray *tasks = [self taskGroupItem].tasksAfterFiltering;
+    if ([self.tableViewData isEqualToArray:tasks])
     {
-        listingContext = self.defaultListingContext;
+        return;
     }
     
-    // create a new listing context so we can filter the processes
-    AlfrescoListingFilter *filter = [[AlfrescoListingFilter alloc] initWithFilter:kAlfrescoFilterByWorkflowStatus value:kAlfrescoFilterValueWorkflowStatusActive];
-    AlfrescoListingContext *filteredListingContext = [[AlfrescoListingContext alloc] initWithMaxItems:listingContext.maxItems
-                                                                                            skipCount:listingContext.skipCount
-                                                                                         sortProperty:listingContext.sortProperty
-                                                                                        sortAscending:listingContext.sortAscending
-                                                                                        listingFilter:filter];
+    // Row changes are only valid against what the table currently shows, otherwise fall back to a full reload
+    BOOL canApplyChanges = self.tableView.window && (self.tableViewData.count == changes.previousCount) && ([self.tableView numberOfRowsInSection:0] == changes.previousCount);
+    self.title = [self taskGroupItem].title;
+    self.tableViewData = [tasks mutableCopy];
     
-    [self.workflowService retrieveProcessesWithListingContext:filteredListingContext completionBlock:completionBlock];
-}
-
-- (void)loadTasksWithListingContext:(AlfrescoListingContext *)listingContext completionBlock:(void (^)(AlfrescoPagingResult *pagingResult, NSError *error))completionBlock
-{
-    [self.workflowService retrieveTasksWithListingContext:(listingContext ?: self.defaultListingContext) completionBlock:completionBlock];
+    if (!canApplyChanges)
+    {
+        [self.tableView reloadData];
+        return;
+    }
+    
+    [self.tableView beginUpdates];
+    [self.tableView deleteRowsAtIndexPaths:changes.deletedIndexPaths withRowAnimation:UITableViewRowAnimationAutomatic];
+    [self.tableView insertRowsAtIndexPaths:changes.insertedIndexPaths withRowAnimation:UITableViewRowAnimationAutomatic];
+    [self.tableView reloadRowsAtIndexPaths:changes.reloadedIndexPaths withRowAnimation:UITableViewRowAnimationNone];
+    for (NSArray *move in changes.movedIndexPaths)
+    {
+        [self.tableView moveRowAtIndexPath:move.firstObject toIndexPath:move.lastObject];
+    }
+    [self.tableView endUpdates];
 }
 
 - (void)displayTaskFilter:(id)sender event:(UIEvent *)event
@@ -322,20 +314,12 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
 
     // "My Tasks" filter
     [alertController addAction:[UIAlertAction actionWithTitle:NSLocalizedString(@"tasks.title.mytasks", @"My Tasks Title") style:UIAlertActionStyleDefault handler:^(UIAlertAction *action) {
-        self.displayingMyTasks = YES;
-        [self loadDataWithListingContext:nil forceRefresh:NO completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-            [self reloadTableViewWithPagingResult:pagingResult error:error];
-        }];
-        [self trackScreenName];
+        [self switchToTasksOfFilterDisplayingMyTasks:YES];
     }]];
 
     // "Tasks I Started" filter
     [alertController addAction:[UIAlertAction actionWithTitle:NSLocalizedString(@"tasks.title.taskistarted", @"Tasks I Started Title") style:UIAlertActionStyleDefault handler:^(UIAlertAction *action) {
-        self.displayingMyTasks = NO;
-        [self loadDataWithListingContext:nil forceRefresh:NO completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-            [self reloadTableViewWithPagingResult:pagingResult error:error];
-        }];
-        [self trackScreenName];
+        [self switchToTasksOfFilterDisplayingMyTasks:NO];
     }]];
     
     // Cancel
@@ -352,49 +336,6 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
     [[AnalyticsManager sharedManager] trackScreenWithName:self.isDisplayingMyTasks ? kAnalyticsViewTaskListingTasksAssignedToMe : kAnalyticsViewTaskListingTasksIVeStarted];
 }
 
-#pragma mark - Overridden Functions
-
-- (void)reloadTableViewWithPagingResult:(AlfrescoPagingResult *)pagingResult error:(NSError *)error
-{
-    if (pagingResult)
-    {
-        if (self.isDisplayingMyTasks)
-        {
-            [self.myTasks clearAllTasks];
-            [self.myTasks addAndApplyFilteringToTasks:pagingResult.objects];
-            //There're some cases in older versions of Alfresco when the server sends an incorrect hasMoreItems value. In order to prevent an infinite loop of fetching new pages, we test if the current pagingResults contains any objects. See https://issues.alfresco.com/jira/browse/MNT-13567
-            self.myTasks.hasMoreItems = pagingResult.hasMoreItems && pagingResult.objects.count;
-            self.tableViewData = [self.myTasks.tasksAfterFiltering mutableCopy];
-        }
-        else
-        {
-            [self.tasksIStarted clearAllTasks];
-            [self.tasksIStarted addAndApplyFilteringToTasks:pagingResult.objects];
-            self.tasksIStarted.hasMoreItems = pagingResult.hasMoreItems && pagingResult.objects.count;
-            self.tableViewData = [self.tasksIStarted.tasksAfterFiltering mutableCopy];
-        }
-        
-        [self.tableView reloadData];
-    }
-    else
-    {
-         displayErrorMessage([ErrorDescriptions descriptionForError:error]);
-         [Notifier notifyWithAlfrescoError:error];
-    }
-}
-
-- (void)addMoreToTableViewWithPagingResult:(AlfrescoPagingResult *)pagingResult error:(NSError *)error
-{
-    if (pagingResult)
-    {
-        TaskGroupItem *currentGroupedItem = [self taskGroupItem];
-        [currentGroupedItem addAndApplyFilteringToTasks:pagingResult.objects];
-        currentGroupedItem.hasMoreItems = pagingResult.hasMoreItems && pagingResult.objects.count;
-        self.tableViewData = [currentGroupedItem.tasksAfterFiltering mutableCopy];
-        [self.tableView reloadData];
-    }
-}
-
 #pragma mark - Table view data source
 
 - (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section
@@ -459,12 +400,11 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
             [spinner startAnimating];
             self.tableView.tableFooterView = spinner;
             
-            int maxItems = self.defaultListingContext.maxItems;
-            int skipCount = self.defaultListingContext.skipCount + (int)[currentTaskGroup numberOfTasksBeforeFiltering];
-            AlfrescoListingContext *moreListingContext = [[AlfrescoListingContext alloc] initWithMaxItems:maxItems skipCount:skipCount];
-
-            [self loadDataWithListingContext:moreListingContext forceRefresh:NO completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-                [self addMoreToTableViewWithPagingResult:pagingResult error:error];
+            [self.taskDataCoordinator loadMoreWithCompletionBlock:^(NodeCollectionChanges *changes, NSError *error) {
+                if (changes)
+                {
+                    [self updateTableViewWithChanges:changes];
+                }
                 self.tableView.tableFooterView = nil;
             }];
         }
@@ -522,10 +462,7 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
     [self showLoadingTextInRefreshControl:refreshControl];
     if (self.session)
     {
-        [self loadDataWithListingContext:nil forceRefresh:YES completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-            [self reloadTableViewWithPagingResult:pagingResult error:error];
-            [self hidePullToRefreshView];
-        }];
+        [self reloadDataForAllTaskFilters];
     }
     else
     {
@@ -534,9 +471,7 @@ static NSString * const kTaskCellIdentifier = @"TaskCell";
         [[LoginManager sharedManager] attemptLoginToAccount:selectedAccount networkId:selectedAccount.selectedNetworkId completionBlock:^(BOOL successful, id<AlfrescoSession> alfrescoSession, NSError *error) {
             if (successful)
             {
-                [self loadDataWithListingContext:nil forceRefresh:YES completionBlock:^(AlfrescoPagingResult *pagingResult, NSError *error) {
-                    [self reloadTableViewWithPagingResult:pagingResult error:error];
-                }];
+                [self reloadDataForAllTaskFilters];
             }
         }];
     }
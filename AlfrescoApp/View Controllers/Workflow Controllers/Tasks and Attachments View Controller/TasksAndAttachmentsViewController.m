@@ -277,6 +277,7 @@ typedef NS_ENUM(NSUInteger, TableSections)
                 AlfrescoWorkflowTask *currentTask = self.tasks[indexPath.row];
                 
                 AvatarConfiguration *configuration = [AvatarConfiguration defaultConfigurationWithIdentifier:currentTask.assigneeIdentifier session:self.session];
+                processTasksCell.avatarImageView.image = configuration.placeholderImage;
                 [[AvatarManager sharedManager] retrieveAvatarWithConfiguration:configuration completionBlock:^(UIImage *avatarImage, NSError *avatarError) {
                     [processTasksCell.avatarImageView setImage:avatarImage withFade:YES];
                 }];
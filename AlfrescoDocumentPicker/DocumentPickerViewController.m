@@ -20,6 +20,7 @@
 #import "UserAccount.h"
 #import "UserAccountWrapper.h"
 #import "KeychainUtils.h"
+#import "AccountStore.h"
 #import "AppConfiguration.h"
 #import "SharedConstants.h"
 #import "CustomFolderService.h"
@@ -36,8 +37,6 @@
 #import "TouchIDManager.h"
 #import "Utility.h"
 
-static NSString * const kAccountsListIdentifier = @"AccountListNew";
-
 @interface DocumentPickerViewController () <AKUserAccountListViewControllerDelegate,
                                             AKAlfrescoNodePickingListViewControllerDelegate,
                                             AKScopePickingViewControllerDelegate,
@@ -65,7 +64,7 @@ static NSString * const kAccountsListIdentifier = @"AccountListNew";
     self.navigationController.navigationBar.translucent = NO;
     
     NSError *keychainError = nil;
-    NSArray *savedAccounts = [KeychainUtils savedAccountsForListIdentifier:kAccountsListIdentifier error:&keychainError];
+    NSArray *savedAccounts = [[AccountStore sharedStore] accountsWithError:&keychainError];
     
     if (keychainError)
     {
@@ -340,7 +339,8 @@ static NSString * const kAccountsListIdentifier = @"AccountListNew";
                 if (successful)
                 {
                     NSError *accountSavingError = nil;
-                    NSArray *accountList = [KeychainUtils savedAccountsForListIdentifier:kAccountsListIdentifier error:&accountSavingError];
+                    AccountStore *accountStore = [AccountStore sharedStore];
+                    NSArray *accountList = [accountStore accountsWithError:&accountSavingError];
                     NSPredicate *predicate = [NSPredicate predicateWithFormat:@"accountIdentifier == %@", account.identifier];
                     NSArray *accountArray = [accountList filteredArrayUsingPredicate:predicate];
                     UserAccount *keychainAccount = accountArray.firstObject;
@@ -359,7 +359,9 @@ static NSString * const kAccountsListIdentifier = @"AccountListNew";
                         keychainAccount.samlData = samlData;
                     }
                     
-                    [KeychainUtils updateSavedAccount:keychainAccount forListIdentifier:kAccountsListIdentifier error:&accountSavingError];
+                    // Written straight away, as the extension can be terminated at any time
+                    [accountStore saveAccounts:accountList];
+                    [accountStore flushWithError:&accountSavingError];
                     if (accountSavingError)
                     {
                         AlfrescoLogError(@"Error accessing shared keychain. Error: %@", accountSavingError.localizedDescription);
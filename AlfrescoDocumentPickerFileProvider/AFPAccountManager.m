@@ -18,6 +18,7 @@
 
 #import "AFPAccountManager.h"
 #import "KeychainUtils.h"
+#import "AccountStore.h"
 #import "UserAccountWrapper.h"
 #import "FileMetadata.h"
 #import <FileProvider/FileProvider.h>
@@ -73,13 +74,7 @@
 
 - (UserAccountWrapper *)userAccountForAccountIdentifier:(NSString *)accountIdentifier networkIdentifier:(NSString *)networkIdentifier
 {
-    NSError *keychainError = nil;
-    NSArray *accounts = [KeychainUtils savedAccountsForListIdentifier:kAccountsListIdentifier error:&keychainError];
-    
-    if (keychainError)
-    {
-        AlfrescoLogError(@"Error retreiving accounts. Error: %@", keychainError.localizedDescription);
-    }
+    NSArray *accounts = [AFPAccountManager getAccountsFromKeychain];
     
     // Get the account for the file
     NSPredicate *predicate = [NSPredicate predicateWithFormat:@"accountIdentifier == %@", accountIdentifier];
@@ -159,9 +154,9 @@
 
 + (NSArray *)getAccountsFromKeychain
 {
+    // Decoded again only when the app changed the account list since the last call
     NSError *keychainError = nil;
-    NSArray *accounts = [KeychainUtils savedAccountsForListIdentifier:kAccountsListIdentifier
-                                                                error:&keychainError];
+    NSArray *accounts = [[AccountStore sharedStore] accountsWithError:&keychainError];
     
     if (keychainError)
     {